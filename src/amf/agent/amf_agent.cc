@@ -33,6 +33,7 @@
 #include "amf/saf/saAmf.h"
 #include "ava.h"
 #include "amf_agent.h"
+#include "amf/common/amf_fotrace.h"
 
 #include <string>
 
@@ -371,6 +372,7 @@ SaAisErrorT AmfAgent::Finalize(SaAmfHandleT hdl) {
   ava_fill_finalize_msg(&msg, cb->ava_dest, hdl, cb->comp_name);
   rc = static_cast<SaAisErrorT>(ava_mds_send(cb, &msg, 0));
   if (NCSCC_RC_SUCCESS == rc) {
+    ava_hcshm_finalize(hdl);
     ncshm_give_hdl(hdl);
     ava_hdl_rec_del(cb, hdl_db, &hdl_rec);
   } else {
@@ -813,6 +815,7 @@ SaAisErrorT AmfAgent::HealthcheckStart(SaAmfHandleT hdl,
     osafassert(AVSV_AVND_AMF_API_RESP_MSG == msg_rsp->type);
     osafassert(AVSV_AMF_HC_START == msg_rsp->info.api_resp_info.type);
     rc = msg_rsp->info.api_resp_info.rc;
+    if (SA_AIS_OK == rc) ava_hcshm_start(hdl, comp_name, hc_key, inv);
   } else if (NCSCC_RC_FAILURE == rc)
     rc = SA_AIS_ERR_TRY_AGAIN;
   else if (NCSCC_RC_REQ_TIMOUT == rc)
@@ -897,6 +900,7 @@ SaAisErrorT AmfAgent::HealthcheckStop(SaAmfHandleT hdl,
     osafassert(AVSV_AVND_AMF_API_RESP_MSG == msg_rsp->type);
     osafassert(AVSV_AMF_HC_STOP == msg_rsp->info.api_resp_info.type);
     rc = msg_rsp->info.api_resp_info.rc;
+    if (SA_AIS_OK == rc) ava_hcshm_stop(hdl, comp_name, hc_key);
   } else if (NCSCC_RC_FAILURE == rc)
     rc = SA_AIS_ERR_TRY_AGAIN;
   else if (NCSCC_RC_REQ_TIMOUT == rc)
@@ -977,6 +981,9 @@ SaAisErrorT AmfAgent::HealthcheckConfirm(SaAmfHandleT hdl,
     goto done;
   }
 
+  /* confirmed in the shared memory if amfnd checks the healthcheck there */
+  if (ava_hcshm_confirm(cb, hdl, comp_name, hc_key, hc_result)) goto done;
+
   /* populate & send the healthcheck confirm message */
   ava_fill_hc_confirm_msg(&msg, cb->ava_dest, hdl, *comp_name, cb->comp_name,
                           *hc_key, hc_result);
@@ -2047,6 +2054,15 @@ SaAisErrorT AmfAgent::Response(SaAmfHandleT hdl, SaInvocationT inv,
     goto done;
   }
 
+  if (rec->cbk_info->type == AVSV_AMF_CSI_SET ||
+      rec->cbk_info->type == AVSV_AMF_CSI_REM)
+    AMF_FOTRACE(AMF_FOTRACE_AVA_RSP, "inv=%llu err=%u", inv, error);
+
+  /* a healthcheck callback queued by the agent itself, the response is
+   * written to the shared memory slot of the healthcheck and only a failed
+   * healthcheck is sent to amfnd */
+  if (ava_hcshm_response(inv, error)) goto resp_sent;
+
   /* populate & send the 'AMF response' message */
   ava_fill_response_msg(&msg, cb->ava_dest, hdl, inv, error, cb->comp_name);
 
@@ -2078,6 +2094,10 @@ SaAisErrorT AmfAgent::Response(SaAmfHandleT hdl, SaInvocationT inv,
     }
   }
 
+  if (rec->cbk_info->type == AVSV_AMF_HC && SA_AIS_OK == error)
+    ava_hcshm_cbk_done(cb, rec->cbk_info);
+
+resp_sent:
   /* if we are done with this rec, free it */
   if ((rec->cbk_info->type != AVSV_AMF_PG_TRACK) &&
       !m_AVA_HDL_IS_CBK_REC_IN_DISPATCH(rec)) {
@@ -43,6 +43,7 @@
 #include "amf/agent/ava_hdl.h"
 #include "amf/agent/ava_mds.h"
 #include "amf/agent/ava_cb.h"
+#include "amf/agent/ava_hcshm.h"
 #include "base/osaf_extended_name.h"
 
 #include "base/logtrace.h"
@@ -0,0 +1,453 @@
+/*      -*- OpenSAF  -*-
+ *
+ * (C) Copyright 2017 The OpenSAF Foundation
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. This file and program are licensed
+ * under the GNU Lesser General Public License Version 2.1, February 1999.
+ * The complete license can be accessed from the following location:
+ * http://opensource.org/licenses/lgpl-license.php
+ * See the Copying file included with the OpenSAF distribution for full
+ * licensing terms.
+ *
+ */
+
+/*****************************************************************************
+
+  DESCRIPTION:
+
+  This file contains the AvA side of the shared memory healthcheck
+  heartbeats, see amf/common/amf_hcshm.h.
+
+  Each healthcheck started through this agent is kept here. The agent
+  attaches to the slot amfnd allocated for it, at the first confirm of a
+  component invoked healthcheck or at the first response to the callback of
+  an AMF invoked healthcheck. Once amfnd has set the slot active:
+
+  - an OK confirm only updates the beat of the slot.
+
+  - the callbacks of an AMF invoked healthcheck are queued by a timer in
+    the agent, with a local invocation, and the response is written to the
+    beat of the slot. A failed response is sent to amfnd as well. The next
+    callback is queued a period after the previous one, or when the
+    previous one is responded to if that is later.
+
+  Everything else, and all healthchecks that have no active slot, use the
+  messages to amfnd as before.
+
+******************************************************************************
+*/
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <cstring>
+#include <map>
+#include <string>
+#include "amf/agent/ava.h"
+#include "amf/common/amf_defs.h"
+#include "amf/common/amf_hcshm.h"
+#include "base/ncssysf_tmr.h"
+
+namespace {
+
+/* interval at which an AMF invoked healthcheck waits for amfnd to set its
+ * slot active, and for the response to the previous callback (in 10 ms) */
+const uint32_t kPollTicks = 10;
+/* number of failed attempts to find the slot before using the messages */
+const int kAttachTries = 3;
+
+struct Entry {
+  SaAmfHandleT hdl;
+  std::string comp;
+  SaAmfHealthcheckKeyT key;
+  SaAmfHealthcheckInvocationT inv_type;
+  const AMF_HCSHM_SLOT *slot; /* the attached slot, 0 if none */
+  AMF_HCSHM_BEAT *beat;       /* beat of the attached slot */
+  uint32_t gen;               /* generation of the attached slot */
+  int tries;
+  tmr_t tmr;             /* callback timer of AMF invoked hc */
+  bool tmr_active;
+  SaInvocationT pending; /* local invocation not responded yet */
+  uint32_t seq;
+};
+
+pthread_once_t once = PTHREAD_ONCE_INIT;
+pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+const AMF_HCSHM *hcshm;
+AMF_HCSHM_BEATS *beats;
+std::map<uint32_t, Entry> entries;
+uint32_t next_id;
+
+/* the slots are mapped read only, only the beats are written */
+void map_shm() {
+  int fd = shm_open(AMF_HCSHM_NAME, O_RDONLY, 0);
+  if (fd < 0) return;
+  void *addr = mmap(nullptr, sizeof(AMF_HCSHM), PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (addr == MAP_FAILED) return;
+
+  const AMF_HCSHM *shm = static_cast<const AMF_HCSHM *>(addr);
+  if (__atomic_load_n(&shm->hdr.magic, __ATOMIC_ACQUIRE) != AMF_HCSHM_MAGIC ||
+      shm->hdr.version != AMF_HCSHM_VERSION ||
+      shm->hdr.num_slots != AMF_HCSHM_SLOTS ||
+      shm->hdr.slot_size != sizeof(AMF_HCSHM_SLOT) ||
+      shm->hdr.beat_size != sizeof(AMF_HCSHM_BEAT)) {
+    munmap(addr, sizeof(AMF_HCSHM));
+    return;
+  }
+
+  fd = shm_open(AMF_HCSHM_BEAT_NAME, O_RDWR, 0);
+  void *beat_addr = MAP_FAILED;
+  if (fd >= 0) {
+    beat_addr = mmap(nullptr, sizeof(AMF_HCSHM_BEATS), PROT_READ | PROT_WRITE,
+                     MAP_SHARED, fd, 0);
+    close(fd);
+  }
+  if (beat_addr == MAP_FAILED) {
+    munmap(addr, sizeof(AMF_HCSHM));
+    return;
+  }
+
+  hcshm = shm;
+  beats = static_cast<AMF_HCSHM_BEATS *>(beat_addr);
+  TRACE("Shared memory healthchecks available");
+}
+
+Entry *find(SaAmfHandleT hdl, const char *comp,
+            const SaAmfHealthcheckKeyT *key, uint32_t *id) {
+  for (auto &it : entries) {
+    Entry &e = it.second;
+    if (e.hdl == hdl && e.comp == comp && e.key.keyLen == key->keyLen &&
+        memcmp(e.key.key, key->key, key->keyLen) == 0) {
+      if (id) *id = it.first;
+      return &e;
+    }
+  }
+  return nullptr;
+}
+
+bool attached(const Entry *e) {
+  return e->slot != nullptr &&
+         __atomic_load_n(&e->slot->gen, __ATOMIC_ACQUIRE) == e->gen;
+}
+
+bool active(const Entry *e) {
+  return attached(e) &&
+         __atomic_load_n(&e->slot->active, __ATOMIC_ACQUIRE) == e->gen;
+}
+
+/* find the slot amfnd allocated for the healthcheck and attach to it */
+bool attach(AVA_CB *cb, Entry *e) {
+  if (attached(e)) return true;
+
+  e->slot = nullptr;
+  e->beat = nullptr;
+  if (hcshm == nullptr || e->tries >= kAttachTries) return false;
+
+  uint32_t hash = amf_hcshm_hash(e->comp.c_str());
+  for (uint32_t i = 0; i < AMF_HCSHM_SLOTS; i++) {
+    const AMF_HCSHM_SLOT *slot = &hcshm->slot[i];
+    uint32_t gen = __atomic_load_n(&slot->gen, __ATOMIC_ACQUIRE);
+
+    if (!(gen & 1) || slot->dest != cb->ava_dest || slot->hdl != e->hdl ||
+        slot->comp_hash != hash || slot->inv_type != e->inv_type ||
+        slot->key_len != e->key.keyLen ||
+        memcmp(slot->key, e->key.key, e->key.keyLen) != 0)
+      continue;
+
+    /* the slot was not reallocated while it was compared */
+    if (__atomic_load_n(&slot->gen, __ATOMIC_ACQUIRE) != gen) continue;
+
+    e->slot = slot;
+    e->beat = &beats->beat[i];
+    e->gen = gen;
+    __atomic_store_n(&e->beat->attached, gen, __ATOMIC_RELEASE);
+    TRACE("'%s' HC '%s' attached to slot %u", e->comp.c_str(), e->key.key, i);
+    return true;
+  }
+
+  e->tries++;
+  return false;
+}
+
+void tmr_exp(void *arg);
+
+void tmr_start(uint32_t id, Entry *e, uint32_t ticks) {
+  if (ticks == 0) ticks = 1;
+  if (e->tmr == TMR_T_NULL)
+    e->tmr = ncs_tmr_alloc(const_cast<char *>(__FILE__), __LINE__);
+  if (e->tmr_active) m_NCS_TMR_STOP(e->tmr);
+  e->tmr = ncs_tmr_start(e->tmr, ticks, tmr_exp,
+                         reinterpret_cast<void *>(static_cast<uintptr_t>(id)),
+                         const_cast<char *>(__FILE__), __LINE__);
+  e->tmr_active = true;
+}
+
+void erase(std::map<uint32_t, Entry>::iterator it) {
+  Entry &e = it->second;
+  if (e.tmr != TMR_T_NULL) {
+    if (e.tmr_active) m_NCS_TMR_STOP(e.tmr);
+    m_NCS_TMR_DESTROY(e.tmr);
+  }
+  entries.erase(it);
+}
+
+/* queue the callback of an AMF invoked hc, as if it came from amfnd */
+void invoke(AVA_CB *cb, Entry *e) {
+  AVSV_AMF_CBK_INFO *cbk_info = static_cast<AVSV_AMF_CBK_INFO *>(
+      calloc(1, sizeof(AVSV_AMF_CBK_INFO)));
+  if (cbk_info == nullptr) return;
+
+  SaInvocationT inv = AMF_HCSHM_INV(e->slot - hcshm->slot, ++e->seq);
+  cbk_info->hdl = e->hdl;
+  cbk_info->inv = inv;
+  cbk_info->type = AVSV_AMF_HC;
+  osaf_extended_name_alloc(e->comp.c_str(), &cbk_info->param.hc.comp_name);
+  cbk_info->param.hc.hc_key = e->key;
+
+  AVA_HDL_REC *hdl_rec = static_cast<AVA_HDL_REC *>(
+      ncshm_take_hdl(NCS_SERVICE_ID_AVA, e->hdl));
+  if (hdl_rec == nullptr) {
+    avsv_amf_cbk_free(cbk_info);
+    return;
+  }
+
+  __atomic_store_n(&e->beat->invoke_time, amf_hcshm_now(), __ATOMIC_RELAXED);
+  __atomic_store_n(&e->beat->invoked, e->beat->invoked + 1, __ATOMIC_RELEASE);
+  e->pending = inv;
+  if (ava_hdl_cbk_param_add(cb, hdl_rec, cbk_info) != NCSCC_RC_SUCCESS) {
+    /* amfnd reports the hc as timed out */
+    TRACE_2("Healthcheck callback param add failed");
+  }
+  ncshm_give_hdl(e->hdl);
+}
+
+void tmr_exp(void *arg) {
+  uint32_t id = static_cast<uint32_t>(reinterpret_cast<uintptr_t>(arg));
+  AVA_CB *cb =
+      static_cast<AVA_CB *>(ncshm_take_hdl(NCS_SERVICE_ID_AVA, gl_ava_hdl));
+  if (cb == nullptr) return;
+
+  m_NCS_LOCK(&cb->lock, NCS_LOCK_WRITE);
+  pthread_mutex_lock(&mutex);
+
+  auto it = entries.find(id);
+  if (it != entries.end()) {
+    Entry *e = &it->second;
+    e->tmr_active = false;
+    if (!attached(e)) {
+      /* amfnd freed the slot, the hc is gone or uses the messages */
+      e->slot = nullptr;
+      e->beat = nullptr;
+    } else if (!active(e) || e->pending != 0) {
+      tmr_start(id, e, kPollTicks);
+    } else {
+      invoke(cb, e);
+      tmr_start(id, e, e->slot->period / AVSV_NANOSEC_TO_LEAPTM);
+    }
+  }
+
+  pthread_mutex_unlock(&mutex);
+  m_NCS_UNLOCK(&cb->lock, NCS_LOCK_WRITE);
+  ncshm_give_hdl(gl_ava_hdl);
+}
+
+}  // namespace
+
+/****************************************************************************
+  Name          : ava_hcshm_start
+
+  Description   : This routine keeps a started healthcheck so that it can
+                  use the shared memory slot amfnd allocates for it.
+
+  Arguments     : hdl       - AMF handle
+                  comp_name - ptr to the comp name
+                  hc_key    - ptr to the healthcheck key
+                  inv       - healthcheck invocation type
+
+  Return Values : None.
+
+  Notes         : None.
+******************************************************************************/
+void ava_hcshm_start(SaAmfHandleT hdl, const SaNameT *comp_name,
+                     const SaAmfHealthcheckKeyT *hc_key,
+                     SaAmfHealthcheckInvocationT inv) {
+  pthread_once(&once, map_shm);
+  if (hcshm == nullptr) return;
+
+  const char *comp = osaf_extended_name_borrow(comp_name);
+  pthread_mutex_lock(&mutex);
+  if (find(hdl, comp, hc_key, nullptr) == nullptr) {
+    Entry &e = entries[++next_id];
+    e.hdl = hdl;
+    e.comp = comp;
+    e.key = *hc_key;
+    e.inv_type = inv;
+    e.slot = nullptr;
+    e.beat = nullptr;
+    e.gen = 0;
+    e.tries = 0;
+    e.tmr = TMR_T_NULL;
+    e.tmr_active = false;
+    e.pending = 0;
+    e.seq = 0;
+  }
+  pthread_mutex_unlock(&mutex);
+}
+
+/****************************************************************************
+  Name          : ava_hcshm_stop
+
+  Description   : This routine forgets a stopped healthcheck.
+
+  Arguments     : hdl       - AMF handle
+                  comp_name - ptr to the comp name
+                  hc_key    - ptr to the healthcheck key
+
+  Return Values : None.
+
+  Notes         : None.
+******************************************************************************/
+void ava_hcshm_stop(SaAmfHandleT hdl, const SaNameT *comp_name,
+                    const SaAmfHealthcheckKeyT *hc_key) {
+  uint32_t id;
+
+  pthread_mutex_lock(&mutex);
+  if (find(hdl, osaf_extended_name_borrow(comp_name), hc_key, &id))
+    erase(entries.find(id));
+  pthread_mutex_unlock(&mutex);
+}
+
+/****************************************************************************
+  Name          : ava_hcshm_finalize
+
+  Description   : This routine forgets the healthchecks of a finalized
+                  handle.
+
+  Arguments     : hdl - AMF handle
+
+  Return Values : None.
+
+  Notes         : None.
+******************************************************************************/
+void ava_hcshm_finalize(SaAmfHandleT hdl) {
+  pthread_mutex_lock(&mutex);
+  for (auto it = entries.begin(); it != entries.end();) {
+    if (it->second.hdl == hdl)
+      erase(it++);
+    else
+      ++it;
+  }
+  pthread_mutex_unlock(&mutex);
+}
+
+/****************************************************************************
+  Name          : ava_hcshm_confirm
+
+  Description   : This routine confirms a component invoked healthcheck in
+                  its shared memory slot.
+
+  Arguments     : cb        - ptr to the AvA control block
+                  hdl       - AMF handle
+                  comp_name - ptr to the comp name
+                  hc_key    - ptr to the healthcheck key
+                  hc_result - healthcheck result
+
+  Return Values : true if amfnd checks the slot and no confirm message is
+                  to be sent.
+
+  Notes         : A failed healthcheck is always sent as a message. The
+                  slot is also updated when the message is sent, amfnd sets
+                  the slot active when it gets an OK confirm message after
+                  the agent has attached.
+******************************************************************************/
+bool ava_hcshm_confirm(AVA_CB *cb, SaAmfHandleT hdl, const SaNameT *comp_name,
+                       const SaAmfHealthcheckKeyT *hc_key,
+                       SaAisErrorT hc_result) {
+  bool local = false;
+
+  if (hcshm == nullptr || hc_result != SA_AIS_OK) return false;
+
+  pthread_mutex_lock(&mutex);
+  Entry *e = find(hdl, osaf_extended_name_borrow(comp_name), hc_key, nullptr);
+  if (e != nullptr && e->inv_type == SA_AMF_HEALTHCHECK_COMPONENT_INVOKED &&
+      attach(cb, e)) {
+    __atomic_store_n(&e->beat->beat_time, amf_hcshm_now(), __ATOMIC_RELEASE);
+    __atomic_store_n(&e->beat->beat, e->beat->beat + 1, __ATOMIC_RELAXED);
+    local = active(e);
+  }
+  pthread_mutex_unlock(&mutex);
+
+  return local;
+}
+
+/****************************************************************************
+  Name          : ava_hcshm_cbk_done
+
+  Description   : This routine is called when the component has responded
+                  OK to an AMF invoked healthcheck callback from amfnd. It
+                  attaches to the slot of the healthcheck and starts the
+                  timer that queues the callbacks once amfnd has set the
+                  slot active.
+
+  Arguments     : cb       - ptr to the AvA control block
+                  cbk_info - ptr to the healthcheck callback
+
+  Return Values : None.
+
+  Notes         : amfnd sets the slot active when the period of this
+                  callback expires.
+******************************************************************************/
+void ava_hcshm_cbk_done(AVA_CB *cb, const AVSV_AMF_CBK_INFO *cbk_info) {
+  uint32_t id;
+
+  if (hcshm == nullptr) return;
+
+  pthread_mutex_lock(&mutex);
+  Entry *e = find(cbk_info->hdl,
+                  osaf_extended_name_borrow(&cbk_info->param.hc.comp_name),
+                  &cbk_info->param.hc.hc_key, &id);
+  if (e != nullptr && e->inv_type == SA_AMF_HEALTHCHECK_AMF_INVOKED &&
+      !e->tmr_active && attach(cb, e))
+    tmr_start(id, e, e->slot->period / AVSV_NANOSEC_TO_LEAPTM);
+  pthread_mutex_unlock(&mutex);
+}
+
+/****************************************************************************
+  Name          : ava_hcshm_response
+
+  Description   : This routine writes the response to a healthcheck callback
+                  queued by the agent to the beat of its slot.
+
+  Arguments     : inv   - local invocation of the callback
+                  error - response of the component
+
+  Return Values : true if the response is not to be sent to amfnd.
+
+  Notes         : A failed response is also sent to amfnd, for the failed
+                  healthcheck to be reported at once. The result written to
+                  the slot makes amfnd report it at its next check if the
+                  message is lost.
+******************************************************************************/
+bool ava_hcshm_response(SaInvocationT inv, SaAisErrorT error) {
+  if (!(inv & AMF_HCSHM_INV_FLAG)) return false;
+
+  pthread_mutex_lock(&mutex);
+  for (auto &it : entries) {
+    Entry *e = &it.second;
+    if (e->pending != inv) continue;
+    e->pending = 0;
+    if (attached(e)) {
+      if (error != SA_AIS_OK)
+        __atomic_store_n(&e->beat->result, error, __ATOMIC_RELAXED);
+      __atomic_store_n(&e->beat->responded, e->beat->responded + 1,
+                       __ATOMIC_RELEASE);
+    }
+    break;
+  }
+  pthread_mutex_unlock(&mutex);
+  return error == SA_AIS_OK;
+}
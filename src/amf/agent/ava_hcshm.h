@@ -0,0 +1,41 @@
+/*      -*- OpenSAF  -*-
+ *
+ * (C) Copyright 2017 The OpenSAF Foundation
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. This file and program are licensed
+ * under the GNU Lesser General Public License Version 2.1, February 1999.
+ * The complete license can be accessed from the following location:
+ * http://opensource.org/licenses/lgpl-license.php
+ * See the Copying file included with the OpenSAF distribution for full
+ * licensing terms.
+ *
+ */
+
+/*****************************************************************************
+
+  DESCRIPTION:
+
+  AvA side of the shared memory healthcheck heartbeats, see
+  amf/common/amf_hcshm.h. The functions are called with the cb lock held.
+
+******************************************************************************
+*/
+
+#ifndef AMF_AGENT_AVA_HCSHM_H_
+#define AMF_AGENT_AVA_HCSHM_H_
+
+void ava_hcshm_start(SaAmfHandleT hdl, const SaNameT *comp_name,
+                     const SaAmfHealthcheckKeyT *hc_key,
+                     SaAmfHealthcheckInvocationT inv);
+void ava_hcshm_stop(SaAmfHandleT hdl, const SaNameT *comp_name,
+                    const SaAmfHealthcheckKeyT *hc_key);
+void ava_hcshm_finalize(SaAmfHandleT hdl);
+bool ava_hcshm_confirm(AVA_CB *cb, SaAmfHandleT hdl, const SaNameT *comp_name,
+                       const SaAmfHealthcheckKeyT *hc_key,
+                       SaAisErrorT hc_result);
+void ava_hcshm_cbk_done(AVA_CB *cb, const AVSV_AMF_CBK_INFO *cbk_info);
+bool ava_hcshm_response(SaInvocationT inv, SaAisErrorT error);
+
+#endif  // AMF_AGENT_AVA_HCSHM_H_
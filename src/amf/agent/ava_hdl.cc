@@ -33,6 +33,7 @@
 */
 
 #include "ava.h"
+#include "amf/common/amf_fotrace.h"
 
 static uint32_t ava_hdl_cbk_dispatch_one(AVA_CB **, AVA_HDL_REC **);
 static uint32_t ava_hdl_cbk_dispatch_all(AVA_CB **, AVA_HDL_REC **);
@@ -668,6 +669,9 @@ uint32_t ava_hdl_cbk_rec_prc(AVSV_AMF_CBK_INFO *info,
         TRACE(
             "Invoking component's saAmfCSISetCallback: InvocationId = %llx, component name = %s",
             info->inv, osaf_extended_name_borrow(&csi_set->comp_name));
+        AMF_FOTRACE(AMF_FOTRACE_AVA_CBK, "inv=%llu comp=%s csi=%s ha=%u",
+                    info->inv, osaf_extended_name_borrow(&csi_set->comp_name),
+                    amf_fotrace_name(&csi_set->csi_desc.csiName), csi_set->ha);
         reg_cbk->saAmfCSISetCallback(info->inv, &csi_set->comp_name,
                                      csi_set->ha, csi_set->csi_desc);
       }
@@ -686,6 +690,9 @@ uint32_t ava_hdl_cbk_rec_prc(AVSV_AMF_CBK_INFO *info,
             "CSIName = %s",
             info->inv, osaf_extended_name_borrow(&csi_rem->comp_name),
             osaf_extended_name_borrow(&csi_rem->csi_name));
+        AMF_FOTRACE(AMF_FOTRACE_AVA_CBK, "inv=%llu comp=%s csi=%s",
+                    info->inv, osaf_extended_name_borrow(&csi_rem->comp_name),
+                    amf_fotrace_name(&csi_rem->csi_name));
         reg_cbk->saAmfCSIRemoveCallback(info->inv, &csi_rem->comp_name,
                                         &csi_rem->csi_name, csi_rem->csi_flags);
       }
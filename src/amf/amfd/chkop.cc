@@ -39,7 +39,9 @@
  * Module Inclusion Control...
  */
 
+#include <cinttypes>
 #include "base/logtrace.h"
+#include "base/ncssysf_mem.h"
 #include "amf/amfd/amfd.h"
 #include "nid/agent/nid_api.h"
 
@@ -58,8 +60,10 @@ static uint32_t avsv_mbcsv_open_ckpt(AVD_CL_CB *cb);
 static uint32_t avsv_get_mbcsv_sel_obj(AVD_CL_CB *cb);
 static uint32_t avsv_mbcsv_close_ckpt(AVD_CL_CB *cb);
 static uint32_t avsv_mbcsv_finalize(AVD_CL_CB *cb);
-static uint32_t avsv_validate_reo_type_in_csync(AVD_CL_CB *cb,
-                                                uint32_t reo_type);
+static bool avsv_ckpt_batchable(AVD_CL_CB *cb, uint32_t action,
+                                uint32_t reo_type, uint32_t send_type);
+static uint32_t avsv_ckpt_batch_add(AVD_CL_CB *cb, MBCSV_REO_HDL reo_hdl,
+                                    uint32_t reo_type, bool *replaced);
 
 extern "C" const AVSV_ENCODE_CKPT_DATA_FUNC_PTR
     avd_enc_ckpt_data_func_list[AVSV_CKPT_MSG_MAX];
@@ -681,6 +685,9 @@ uint32_t avsv_set_ckpt_role(AVD_CL_CB *cb, uint32_t role) {
   NCS_MBCSV_ARG mbcsv_arg;
   uint32_t rc = NCSCC_RC_SUCCESS;
 
+  /* Updates made in the old role go first */
+  avsv_send_ckpt_batch(cb);
+
   memset(&mbcsv_arg, '\0', sizeof(NCS_MBCSV_ARG));
 
   mbcsv_arg.i_op = NCS_MBCSV_OP_CHG_ROLE;
@@ -802,6 +809,9 @@ uint32_t avsv_mbcsv_dispatch(AVD_CL_CB *cb, uint32_t flag) {
   NCS_MBCSV_ARG mbcsv_arg;
   uint32_t rc;
 
+  /* Warm sync compares update counts, so send the waiting updates first */
+  avsv_send_ckpt_batch(cb);
+
   memset(&mbcsv_arg, '\0', sizeof(NCS_MBCSV_ARG));
 
   mbcsv_arg.i_op = NCS_MBCSV_OP_DISPATCH;
@@ -837,6 +847,7 @@ uint32_t avsv_send_ckpt_data(AVD_CL_CB *cb, uint32_t action,
                              MBCSV_REO_HDL reo_hdl, uint32_t reo_type,
                              uint32_t send_type) {
   NCS_MBCSV_ARG mbcsv_arg;
+  bool batched = false;
 
   /*
    * Validate HA state. If my HA state is Standby then don't send
@@ -845,6 +856,19 @@ uint32_t avsv_send_ckpt_data(AVD_CL_CB *cb, uint32_t action,
    */
   if (SA_AMF_HA_STANDBY == cb->avail_state_avd) return NCSCC_RC_SUCCESS;
 
+  /*
+   * Updates of independent fields are batched. An update replacing one
+   * already in the batch is not counted, the standby decodes it only once.
+   */
+  if (avsv_ckpt_batchable(cb, action, reo_type, send_type)) {
+    bool replaced = false;
+    if (avsv_ckpt_batch_add(cb, reo_hdl, reo_type, &replaced) ==
+        NCSCC_RC_SUCCESS) {
+      if (replaced) return NCSCC_RC_SUCCESS;
+      batched = true;
+    }
+  }
+
   /*
    * Get mbcsv_handle and checkpoint handle from CB.
    */
@@ -1046,6 +1070,17 @@ uint32_t avsv_send_ckpt_data(AVD_CL_CB *cb, uint32_t action,
       return NCSCC_RC_SUCCESS;
   }
 
+  if (batched) {
+    if (cb->ckpt_batch.entries.size() >= AVSV_CKPT_BATCH_MAX)
+      return avsv_send_ckpt_batch(cb);
+    return NCSCC_RC_SUCCESS;
+  }
+
+  /*
+   * Updates batched so far go before this one, e.g. before the sync commit.
+   */
+  if (NCSCC_RC_SUCCESS != avsv_send_ckpt_batch(cb)) return NCSCC_RC_FAILURE;
+
   /*
    * Now send this update.
    */
@@ -1057,6 +1092,159 @@ uint32_t avsv_send_ckpt_data(AVD_CL_CB *cb, uint32_t action,
   return NCSCC_RC_SUCCESS;
 }
 
+/****************************************************************************\
+ * Function: avsv_ckpt_batchable
+ *
+ * Purpose:  Check if an async update can wait in the batch. Updates of
+ *           independent fields can, if the standby decodes batches. The
+ *           standby only needs the last value of such a field.
+ *
+ * Input: cb        - AVD control block pointer.
+ *        action    - Action to be perform (add, remove or update)
+ *        reo_type  - Redudant object type.
+ *        send_type - Send type to be used.
+ *
+ * Returns: true if the update can be batched.
+ *
+ * NOTES:
+ *
+ *
+\**************************************************************************/
+static bool avsv_ckpt_batchable(AVD_CL_CB *cb, uint32_t action,
+                                uint32_t reo_type, uint32_t send_type) {
+  if ((cb->avd_peer_ver < AVD_MBCSV_SUB_PART_VERSION_9) ||
+      (action != NCS_MBCSV_ACT_UPDATE) ||
+      (send_type != NCS_MBCSV_SND_USR_ASYNC))
+    return false;
+
+  switch (reo_type) {
+    case AVSV_CKPT_SU_RESTART_COUNT:
+    case AVSV_CKPT_SI_DEP_STATE:
+    case AVSV_CKPT_NG_ADMIN_STATE:
+      return true;
+    default:
+      return (reo_type >= AVSV_CKPT_AVND_ADMIN_STATE) &&
+             (reo_type <= AVSV_CKPT_COMP_RESTART_COUNT);
+  }
+}
+
+/****************************************************************************\
+ * Function: avsv_ckpt_batch_add
+ *
+ * Purpose:  Encode an async update and add it last to the batch. An update
+ *           of the same field of the same object already in the batch is
+ *           removed.
+ *
+ * Input: cb        - AVD control block pointer.
+ *        reo_hdl   - Redudant object handle.
+ *        reo_type  - Redudant object type.
+ *
+ * Output: replaced - true if an update in the batch was removed.
+ *
+ * Returns: NCSCC_RC_SUCCESS/NCSCC_RC_FAILURE.
+ *
+ * NOTES: The update is encoded now since the object may be deleted before
+ *        the batch is sent.
+ *
+ *
+\**************************************************************************/
+static uint32_t avsv_ckpt_batch_add(AVD_CL_CB *cb, MBCSV_REO_HDL reo_hdl,
+                                    uint32_t reo_type, bool *replaced) {
+  AVSV_CKPT_BATCH *batch = &cb->ckpt_batch;
+  NCS_MBCSV_CB_ENC enc = {};
+
+  enc.io_msg_type = NCS_MBCSV_MSG_ASYNC_UPDATE;
+  enc.io_action = NCS_MBCSV_ACT_UPDATE;
+  enc.io_reo_type = reo_type;
+  enc.io_reo_hdl = reo_hdl;
+  enc.i_peer_version = cb->avd_peer_ver;
+
+  if (ncs_enc_init_space(&enc.io_uba) != NCSCC_RC_SUCCESS) {
+    LOG_ER("%s: ncs_enc_init_space failed", __FUNCTION__);
+    return NCSCC_RC_FAILURE;
+  }
+  if (avd_enc_ckpt_data_func_list[reo_type](cb, &enc) != NCSCC_RC_SUCCESS) {
+    LOG_ER("%s: encode of type %u failed", __FUNCTION__, reo_type);
+    m_MMGR_FREE_BUFR_LIST(enc.io_uba.start);
+    return NCSCC_RC_FAILURE;
+  }
+
+  AVSV_CKPT_BATCH_ENTRY entry;
+  entry.reo_type = reo_type;
+  entry.reo_hdl = reo_hdl;
+  entry.data.resize(enc.io_uba.ttl);
+  ncs_dec_init_space(&enc.io_uba, enc.io_uba.start);
+  if (!entry.data.empty())
+    ncs_decode_n_octets_from_uba(&enc.io_uba, entry.data.data(),
+                                 entry.data.size());
+  m_MMGR_FREE_BUFR_LIST(enc.io_uba.ub);
+
+  std::pair<uint32_t, MBCSV_REO_HDL> key(reo_type, reo_hdl);
+  auto it = batch->index.find(key);
+  *replaced = (it != batch->index.end());
+  if (*replaced) {
+    batch->entries.erase(it->second);
+    batch->updts_saved++;
+  }
+  batch->index[key] =
+      batch->entries.insert(batch->entries.end(), std::move(entry));
+  batch->updts_batched++;
+
+  return NCSCC_RC_SUCCESS;
+}
+
+/****************************************************************************\
+ * Function: avsv_send_ckpt_batch
+ *
+ * Purpose:  Send the async updates waiting in the batch to the standby in
+ *           one message.
+ *
+ * Input: cb        - AVD control block pointer.
+ *
+ * Returns: NCSCC_RC_SUCCESS/NCSCC_RC_FAILURE.
+ *
+ * NOTES: Called before any other checkpoint message is sent and at the end
+ *        of each round of event processing, so the standby gets the updates
+ *        in the same order relative to other messages as if they had been
+ *        sent one by one.
+ *
+ *
+\**************************************************************************/
+uint32_t avsv_send_ckpt_batch(AVD_CL_CB *cb) {
+  AVSV_CKPT_BATCH *batch = &cb->ckpt_batch;
+  NCS_MBCSV_ARG mbcsv_arg = {};
+  uint32_t rc = NCSCC_RC_SUCCESS;
+
+  if (batch->entries.empty()) return NCSCC_RC_SUCCESS;
+
+  TRACE_ENTER2("%zu updates", batch->entries.size());
+
+  if (SA_AMF_HA_STANDBY != cb->avail_state_avd) {
+    mbcsv_arg.i_op = NCS_MBCSV_OP_SEND_CKPT;
+    mbcsv_arg.i_mbcsv_hdl = cb->mbcsv_hdl;
+    mbcsv_arg.info.send_ckpt.i_action = NCS_MBCSV_ACT_UPDATE;
+    mbcsv_arg.info.send_ckpt.i_ckpt_hdl = cb->ckpt_hdl;
+    mbcsv_arg.info.send_ckpt.i_reo_hdl = NCS_PTR_TO_UNS64_CAST(batch);
+    mbcsv_arg.info.send_ckpt.i_reo_type = AVSV_CKPT_AVD_BATCH;
+    mbcsv_arg.info.send_ckpt.i_send_type = NCS_MBCSV_SND_USR_ASYNC;
+
+    if (NCSCC_RC_SUCCESS != ncs_mbcsv_svc(&mbcsv_arg)) {
+      LOG_ER("%s: ncs_mbcsv_svc NCS_MBCSV_OP_SEND_CKPT failed", __FUNCTION__);
+      rc = NCSCC_RC_FAILURE;
+    } else {
+      batch->batches_sent++;
+    }
+  }
+
+  batch->entries.clear();
+  batch->index.clear();
+
+  TRACE_LEAVE2("batches sent:%" PRIu64 ", updates batched:%" PRIu64
+               ", saved:%" PRIu64,
+               batch->batches_sent, batch->updts_batched, batch->updts_saved);
+  return rc;
+}
+
 /****************************************************************************\
  * Function: avsv_mbcsv_close_ckpt
  *
@@ -1307,8 +1495,7 @@ uint32_t avsv_send_data_req(AVD_CL_CB *cb) {
  *
  *
 \**************************************************************************/
-static uint32_t avsv_validate_reo_type_in_csync(AVD_CL_CB *cb,
-                                                uint32_t reo_type) {
+uint32_t avsv_validate_reo_type_in_csync(AVD_CL_CB *cb, uint32_t reo_type) {
   uint32_t status = NCSCC_RC_FAILURE;
 
   switch (reo_type) {
@@ -1412,6 +1599,11 @@ static uint32_t avsv_validate_reo_type_in_csync(AVD_CL_CB *cb,
       if (cb->synced_reo_type >= AVSV_CKPT_AVD_COMP_CS_TYPE_CONFIG)
         status = NCSCC_RC_SUCCESS;
       break;
+
+    /* The updates in a batch are validated one by one when decoded */
+    case AVSV_CKPT_AVD_BATCH:
+      status = NCSCC_RC_SUCCESS;
+      break;
     default:
       LOG_WA("%s: unknown type %u", __FUNCTION__, reo_type);
   }
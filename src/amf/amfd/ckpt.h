@@ -34,10 +34,16 @@
 #ifndef AMF_AMFD_CKPT_H_
 #define AMF_AMFD_CKPT_H_
 
+#include <list>
+#include <map>
+#include <utility>
+#include <vector>
+
 // current version
-#define AVD_MBCSV_SUB_PART_VERSION 8
+#define AVD_MBCSV_SUB_PART_VERSION 9
 
 // supported versions
+#define AVD_MBCSV_SUB_PART_VERSION_9 9
 #define AVD_MBCSV_SUB_PART_VERSION_8 8
 #define AVD_MBCSV_SUB_PART_VERSION_7 7
 #define AVD_MBCSV_SUB_PART_VERSION_6 6
@@ -110,6 +116,31 @@ typedef struct avsv_async_updt_cnt {
   uint32_t ng_updt;
 } AVSV_ASYNC_UPDT_CNT;
 
+/* Max number of updates sent in one AVSV_CKPT_AVD_BATCH message */
+#define AVSV_CKPT_BATCH_MAX 256
+
+/*
+ * Async updates of independent fields waiting to be sent to the standby in
+ * one AVSV_CKPT_AVD_BATCH message. The updates are kept in the order they
+ * were made, an update of a field that is already waiting replaces it and
+ * is moved last. The batch is sent before any other checkpoint message.
+ */
+typedef struct avsv_ckpt_batch_entry {
+  uint32_t reo_type;
+  MBCSV_REO_HDL reo_hdl;
+  std::vector<uint8_t> data; /* The update as encoded for the standby */
+} AVSV_CKPT_BATCH_ENTRY;
+
+typedef struct avsv_ckpt_batch {
+  std::list<AVSV_CKPT_BATCH_ENTRY> entries;
+  std::map<std::pair<uint32_t, MBCSV_REO_HDL>,
+           std::list<AVSV_CKPT_BATCH_ENTRY>::iterator>
+      index;
+  uint64_t updts_batched; /* Updates added to a batch */
+  uint64_t updts_saved;   /* Updates replaced before they were sent */
+  uint64_t batches_sent;
+} AVSV_CKPT_BATCH;
+
 /*
  * Prototype for the AVSV checkpoint encode function pointer.
  */
@@ -146,9 +177,12 @@ uint32_t avsv_mbcsv_dispatch(struct cl_cb_tag *cb, uint32_t flag);
 uint32_t avsv_send_ckpt_data(struct cl_cb_tag *cb, uint32_t action,
                              MBCSV_REO_HDL reo_hdl, uint32_t reo_type,
                              uint32_t send_type);
+uint32_t avsv_send_ckpt_batch(struct cl_cb_tag *cb);
 uint32_t avsv_mbcsv_obj_set(struct cl_cb_tag *cb, uint32_t obj, uint32_t val);
 uint32_t avsv_send_data_req(struct cl_cb_tag *cb);
 uint32_t avsv_dequeue_async_update_msgs(struct cl_cb_tag *cb, bool pr_or_fr);
+uint32_t avsv_validate_reo_type_in_csync(struct cl_cb_tag *cb,
+                                         uint32_t reo_type);
 
 /* Function Definations of avd_ckpt_enc.c */
 uint32_t avd_enc_cold_sync_rsp(struct cl_cb_tag *cb, NCS_MBCSV_CB_ENC *enc);
@@ -120,6 +120,7 @@ static uint32_t dec_cs_comp_cs_type_config(AVD_CL_CB *cb, NCS_MBCSV_CB_DEC *dec,
                                            uint32_t num_of_obj);
 static uint32_t dec_avd_to_avd_job_queue_status(AVD_CL_CB *cb,
                                                 NCS_MBCSV_CB_DEC *dec);
+static uint32_t dec_batch(AVD_CL_CB *cb, NCS_MBCSV_CB_DEC *dec);
 
 /*
  * Function list for decoding the async data.
@@ -160,7 +161,7 @@ const AVSV_DECODE_CKPT_DATA_FUNC_PTR avd_dec_data_func_list[] = {
     dec_comp_curr_num_csi_stby, dec_comp_oper_state, dec_comp_readiness_state,
     dec_comp_pres_state, dec_comp_restart_count, nullptr, /* AVSV_SYNC_COMMIT */
     dec_su_restart_count, dec_si_dep_state, dec_ng_admin_state,
-    dec_avd_to_avd_job_queue_status
+    dec_avd_to_avd_job_queue_status, dec_batch
 
 };
 
@@ -2952,3 +2953,67 @@ static uint32_t dec_avd_to_avd_job_queue_status(AVD_CL_CB *cb,
   TRACE_LEAVE();
   return NCSCC_RC_SUCCESS;
 }
+
+/**
+ * @brief   decodes a batch of async updates. The updates are decoded in the
+ *          order they were encoded, each by the function of its reo type, as
+ *          if they had been received one by one. Updates of types not cold
+ *          synced yet are skipped.
+ *
+ * @param   ptr to AVD_CL_CB
+ * @param   ptr to decode structure NCS_MBCSV_CB_DEC.
+ *
+ * @return NCSCC_RC_SUCCESS/NCSCC_RC_FAILURE
+ */
+static uint32_t dec_batch(AVD_CL_CB *cb, NCS_MBCSV_CB_DEC *dec) {
+  uint32_t num_updts = 0;
+  uint32_t status = NCSCC_RC_SUCCESS;
+
+  TRACE_ENTER();
+  osaf_decode_uint32(&dec->i_uba, &num_updts);
+  for (uint32_t i = 0; i < num_updts; i++) {
+    uint32_t reo_type;
+    uint32_t length;
+    osaf_decode_uint32(&dec->i_uba, &reo_type);
+    osaf_decode_uint32(&dec->i_uba, &length);
+
+    if ((reo_type >= AVSV_CKPT_MSG_MAX) || (reo_type == AVSV_CKPT_AVD_BATCH) ||
+        (avd_dec_data_func_list[reo_type] == nullptr)) {
+      LOG_ER("%s: invalid type %u", __FUNCTION__, reo_type);
+      ncs_dec_skip_space(&dec->i_uba, length);
+      status = NCSCC_RC_FAILURE;
+      continue;
+    }
+
+    /*
+     * During cold sync an update is dropped if the cold sync response
+     * for its type is yet to come, as it is when received alone.
+     */
+    if ((cb->stby_sync_state != AVD_STBY_IN_SYNC) &&
+        (avsv_validate_reo_type_in_csync(cb, reo_type) != NCSCC_RC_SUCCESS)) {
+      TRACE("type %u not synced yet, dropped", reo_type);
+      ncs_dec_skip_space(&dec->i_uba, length);
+      continue;
+    }
+
+    NCS_MBCSV_CB_DEC updt = *dec;
+    updt.i_reo_type = reo_type;
+    int32_t start = updt.i_uba.ttl;
+    if (avd_dec_data_func_list[reo_type](cb, &updt) != NCSCC_RC_SUCCESS)
+      status = NCSCC_RC_FAILURE;
+    dec->i_uba = updt.i_uba;
+
+    // Skip what the decode function left, e.g. if it failed half way
+    int32_t used = dec->i_uba.ttl - start;
+    if (used > static_cast<int32_t>(length)) {
+      LOG_ER("%s: type %u used %d of %u bytes", __FUNCTION__, reo_type, used,
+             length);
+      TRACE_LEAVE();
+      return NCSCC_RC_FAILURE;
+    }
+    if (used < static_cast<int32_t>(length))
+      ncs_dec_skip_space(&dec->i_uba, length - used);
+  }
+  TRACE_LEAVE2("%u updates", num_updts);
+  return status;
+}
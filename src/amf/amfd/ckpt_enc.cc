@@ -120,6 +120,7 @@ static uint32_t enc_cs_comp_cs_type_config(AVD_CL_CB *cb, NCS_MBCSV_CB_ENC *enc,
                                            uint32_t *num_of_obj);
 static uint32_t enc_avd_to_avd_job_queue_status(AVD_CL_CB *cb,
                                                 NCS_MBCSV_CB_ENC *enc);
+static uint32_t enc_batch(AVD_CL_CB *cb, NCS_MBCSV_CB_ENC *enc);
 
 static uint32_t enc_su_oper_list(AVD_CL_CB *cb, AVD_SG *sg,
                                  NCS_MBCSV_CB_ENC *enc);
@@ -163,7 +164,7 @@ const AVSV_ENCODE_CKPT_DATA_FUNC_PTR avd_enc_ckpt_data_func_list[] = {
     enc_comp_curr_num_csi_stby, enc_comp_oper_state, enc_comp_readiness_state,
     enc_comp_pres_state, enc_comp_restart_count, nullptr, /* AVSV_SYNC_COMMIT */
     enc_su_restart_count, enc_si_dep_state, enc_ng_admin_state,
-    enc_avd_to_avd_job_queue_status};
+    enc_avd_to_avd_job_queue_status, enc_batch};
 
 /*
  * Function list for encoding the cold sync response data
@@ -2411,3 +2412,28 @@ static uint32_t enc_avd_to_avd_job_queue_status(AVD_CL_CB *cb,
   TRACE_LEAVE();
   return NCSCC_RC_SUCCESS;
 }
+
+/**
+ * @brief   encodes the async updates waiting in a batch, each one as its
+ *          reo type, length and the update as encoded by its own function.
+ *
+ * @param   ptr to AVD_CL_CB
+ * @param   ptr to encode structure NCS_MBCSV_CB_ENC.
+ *
+ * @return NCSCC_RC_SUCCESS
+ */
+static uint32_t enc_batch(AVD_CL_CB *cb, NCS_MBCSV_CB_ENC *enc) {
+  TRACE_ENTER();
+  osafassert(NCS_MBCSV_ACT_UPDATE == enc->io_action);
+  AVSV_CKPT_BATCH *batch = reinterpret_cast<AVSV_CKPT_BATCH *>(enc->io_reo_hdl);
+  osaf_encode_uint32(&enc->io_uba, batch->entries.size());
+  for (auto &entry : batch->entries) {
+    osaf_encode_uint32(&enc->io_uba, entry.reo_type);
+    osaf_encode_uint32(&enc->io_uba, entry.data.size());
+    if (!entry.data.empty())
+      ncs_encode_n_octets_in_uba(&enc->io_uba, entry.data.data(),
+                                 entry.data.size());
+  }
+  TRACE_LEAVE2("%zu updates", batch->entries.size());
+  return NCSCC_RC_SUCCESS;
+}
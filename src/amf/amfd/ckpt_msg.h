@@ -113,6 +113,7 @@ typedef enum avsv_ckpt_msg_reo_type {
   AVSV_CKPT_SI_DEP_STATE,
   AVSV_CKPT_NG_ADMIN_STATE,
   AVSV_CKPT_AVD_IMM_JOB_QUEUE_STATUS,
+  AVSV_CKPT_AVD_BATCH,
   AVSV_CKPT_MSG_MAX
 } AVSV_CKPT_MSG_REO_TYPE;
 
@@ -37,12 +37,13 @@
 #include "amf/amfd/util.h"
 #include "amf/amfd/comp.h"
 #include "amf/amfd/imm.h"
+#include "amf/amfd/imm_cache.h"
 #include "amf/amfd/node.h"
 #include "amf/amfd/csi.h"
 #include "amf/amfd/proc.h"
 #include "amf/amfd/ckpt_msg.h"
 
-AmfDb<std::string, AVD_COMP> *comp_db = nullptr;
+AmfHashDb<std::string, AVD_COMP> *comp_db = nullptr;
 
 void avd_comp_db_add(AVD_COMP *comp) {
   const std::string comp_name(Amf::to_string(&comp->comp_info.name));
@@ -730,6 +731,32 @@ done:
   return comp;
 }
 
+SaImmAttrNameT comp_config_attributes[] = {
+    const_cast<SaImmAttrNameT>("saAmfCompType"),
+    const_cast<SaImmAttrNameT>("saAmfCompCmdEnv"),
+    const_cast<SaImmAttrNameT>("saAmfCompInstantiateCmdArgv"),
+    const_cast<SaImmAttrNameT>("saAmfCompInstantiateTimeout"),
+    const_cast<SaImmAttrNameT>("saAmfCompInstantiationLevel"),
+    const_cast<SaImmAttrNameT>("saAmfCompNumMaxInstantiateWithoutDelay"),
+    const_cast<SaImmAttrNameT>("saAmfCompNumMaxInstantiateWithDelay"),
+    const_cast<SaImmAttrNameT>("saAmfCompDelayBetweenInstantiateAttempts"),
+    const_cast<SaImmAttrNameT>("saAmfCompTerminateCmdArgv"),
+    const_cast<SaImmAttrNameT>("saAmfCompTerminateTimeout"),
+    const_cast<SaImmAttrNameT>("saAmfCompCleanupCmdArgv"),
+    const_cast<SaImmAttrNameT>("saAmfCompCleanupTimeout"),
+    const_cast<SaImmAttrNameT>("saAmfCompAmStartCmdArgv"),
+    const_cast<SaImmAttrNameT>("saAmfCompAmStartTimeout"),
+    const_cast<SaImmAttrNameT>("saAmfCompNumMaxAmStartAttempts"),
+    const_cast<SaImmAttrNameT>("saAmfCompAmStopCmdArgv"),
+    const_cast<SaImmAttrNameT>("saAmfCompAmStopTimeout"),
+    const_cast<SaImmAttrNameT>("saAmfCompNumMaxAmStopAttempts"),
+    const_cast<SaImmAttrNameT>("saAmfCompCSISetCallbackTimeout"),
+    const_cast<SaImmAttrNameT>("saAmfCompCSIRmvCallbackTimeout"),
+    const_cast<SaImmAttrNameT>("saAmfCompQuiescingCompleteTimeout"),
+    const_cast<SaImmAttrNameT>("saAmfCompRecoveryOnError"),
+    const_cast<SaImmAttrNameT>("saAmfCompDisableRestart"),
+    nullptr};
+
 /**
  * Get configuration for all SaAmfComp objects from IMM and
  * create AVD internal objects.
@@ -739,57 +766,22 @@ done:
  */
 SaAisErrorT avd_comp_config_get(const std::string &su_name, AVD_SU *su) {
   SaAisErrorT rc, error = SA_AIS_ERR_FAILED_OPERATION;
-  SaImmSearchHandleT searchHandle;
-  SaImmSearchParametersT_2 searchParam;
+  ImmConfigSearch search;
   SaNameT comp_name;
   const SaImmAttrValuesT_2 **attributes;
   const char *className = "SaAmfComp";
   AVD_COMP *comp;
   unsigned int num_of_comp_in_su = 0;
-  SaImmAttrNameT configAttributes[] = {
-      const_cast<SaImmAttrNameT>("saAmfCompType"),
-      const_cast<SaImmAttrNameT>("saAmfCompCmdEnv"),
-      const_cast<SaImmAttrNameT>("saAmfCompInstantiateCmdArgv"),
-      const_cast<SaImmAttrNameT>("saAmfCompInstantiateTimeout"),
-      const_cast<SaImmAttrNameT>("saAmfCompInstantiationLevel"),
-      const_cast<SaImmAttrNameT>("saAmfCompNumMaxInstantiateWithoutDelay"),
-      const_cast<SaImmAttrNameT>("saAmfCompNumMaxInstantiateWithDelay"),
-      const_cast<SaImmAttrNameT>("saAmfCompDelayBetweenInstantiateAttempts"),
-      const_cast<SaImmAttrNameT>("saAmfCompTerminateCmdArgv"),
-      const_cast<SaImmAttrNameT>("saAmfCompTerminateTimeout"),
-      const_cast<SaImmAttrNameT>("saAmfCompCleanupCmdArgv"),
-      const_cast<SaImmAttrNameT>("saAmfCompCleanupTimeout"),
-      const_cast<SaImmAttrNameT>("saAmfCompAmStartCmdArgv"),
-      const_cast<SaImmAttrNameT>("saAmfCompAmStartTimeout"),
-      const_cast<SaImmAttrNameT>("saAmfCompNumMaxAmStartAttempts"),
-      const_cast<SaImmAttrNameT>("saAmfCompAmStopCmdArgv"),
-      const_cast<SaImmAttrNameT>("saAmfCompAmStopTimeout"),
-      const_cast<SaImmAttrNameT>("saAmfCompNumMaxAmStopAttempts"),
-      const_cast<SaImmAttrNameT>("saAmfCompCSISetCallbackTimeout"),
-      const_cast<SaImmAttrNameT>("saAmfCompCSIRmvCallbackTimeout"),
-      const_cast<SaImmAttrNameT>("saAmfCompQuiescingCompleteTimeout"),
-      const_cast<SaImmAttrNameT>("saAmfCompRecoveryOnError"),
-      const_cast<SaImmAttrNameT>("saAmfCompDisableRestart"),
-      nullptr};
 
   TRACE_ENTER();
 
-  searchParam.searchOneAttr.attrName =
-      const_cast<SaImmAttrNameT>("SaImmAttrClassName");
-  searchParam.searchOneAttr.attrValueType = SA_IMM_ATTR_SASTRINGT;
-  searchParam.searchOneAttr.attrValue = &className;
-
-  if ((rc = immutil_saImmOmSearchInitialize_o2(
-           avd_cb->immOmHandle, su_name.c_str(), SA_IMM_SUBTREE,
-           SA_IMM_SEARCH_ONE_ATTR | SA_IMM_SEARCH_GET_SOME_ATTR, &searchParam,
-           configAttributes, &searchHandle)) != SA_AIS_OK) {
+  if ((rc = search.initialize(su_name, className, comp_config_attributes)) !=
+      SA_AIS_OK) {
     LOG_ER("%s: saImmOmSearchInitialize_2 failed: %u", __FUNCTION__, rc);
     goto done1;
   }
 
-  while ((rc = immutil_saImmOmSearchNext_2(
-              searchHandle, &comp_name, (SaImmAttrValuesT_2 ***)&attributes)) ==
-         SA_AIS_OK) {
+  while ((rc = search.next(&comp_name, &attributes)) == SA_AIS_OK) {
     if (!is_config_valid(Amf::to_string(&comp_name), attributes, nullptr))
       goto done2;
 
@@ -815,7 +807,7 @@ SaAisErrorT avd_comp_config_get(const std::string &su_name, AVD_SU *su) {
   error = SA_AIS_OK;
 
 done2:
-  (void)immutil_saImmOmSearchFinalize(searchHandle);
+  search.finalize();
 done1:
   TRACE_LEAVE2("%u", error);
   return error;
@@ -1823,7 +1815,7 @@ AVD_COMP *avd_comp_get_or_create(const std::string &dn) {
 }
 
 void avd_comp_constructor(void) {
-  comp_db = new AmfDb<std::string, AVD_COMP>;
+  comp_db = new AmfHashDb<std::string, AVD_COMP>;
   avd_class_impl_set("SaAmfComp", comp_rt_attr_cb, comp_admin_op_cb,
                      comp_ccb_completed_cb, comp_ccb_apply_cb);
 }
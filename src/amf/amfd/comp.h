@@ -174,7 +174,7 @@ class AVD_COMP {
   void operator=(const AVD_COMP &);
 };
 
-extern AmfDb<std::string, AVD_COMP> *comp_db;
+extern AmfHashDb<std::string, AVD_COMP> *comp_db;
 
 /* AMF Class SaAmfCompType */
 class AVD_COMP_TYPE {
@@ -261,6 +261,7 @@ extern AVD_COMP *avd_comp_new(const std::string &dn);
 extern void avd_comp_delete(AVD_COMP *comp);
 extern void avd_su_remove_comp(AVD_COMP *comp);
 extern SaAisErrorT avd_comp_config_get(const std::string &su_name, AVD_SU *su);
+extern SaImmAttrNameT comp_config_attributes[];
 extern void avd_comp_constructor(void);
 
 extern SaAisErrorT avd_comptype_config_get(void);
@@ -281,6 +282,7 @@ extern void avd_compcstype_delete(AVD_COMPCS_TYPE **cst);
 extern void avd_compcstype_db_add(AVD_COMPCS_TYPE *cst);
 extern SaAisErrorT avd_compcstype_config_get(const std::string &comp_name,
                                              AVD_COMP *comp);
+extern SaImmAttrNameT compcstype_config_attributes[];
 extern AVD_COMPCS_TYPE *avd_compcstype_create(
     const std::string &dn, const SaImmAttrValuesT_2 **attributes);
 extern AVD_COMPCS_TYPE *avd_compcstype_get(const std::string &dn);
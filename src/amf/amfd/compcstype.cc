@@ -29,6 +29,7 @@
 #include "amf/amfd/csi.h"
 #include "amf/amfd/proc.h"
 #include "amf/amfd/ckpt_msg.h"
+#include "amf/amfd/imm_cache.h"
 
 AmfDb<std::string, AVD_COMPCS_TYPE> *compcstype_db = nullptr;
 ;
@@ -272,6 +273,10 @@ done:
   return compcstype;
 }
 
+SaImmAttrNameT compcstype_config_attributes[] = {
+    const_cast<SaImmAttrNameT>("saAmfCompNumMaxActiveCSIs"),
+    const_cast<SaImmAttrNameT>("saAmfCompNumMaxStandbyCSIs"), nullptr};
+
 /**
  * Get configuration for all AMF CompCsType objects from IMM and
  * create AVD internal objects.
@@ -283,35 +288,21 @@ done:
  */
 SaAisErrorT avd_compcstype_config_get(const std::string &name, AVD_COMP *comp) {
   SaAisErrorT error;
-  SaImmSearchHandleT searchHandle;
-  SaImmSearchParametersT_2 searchParam;
+  ImmConfigSearch search;
   SaNameT dn;
   const SaImmAttrValuesT_2 **attributes;
   const char *className = "SaAmfCompCsType";
   AVD_COMPCS_TYPE *compcstype;
-  SaImmAttrNameT attributeNames[] = {
-      const_cast<SaImmAttrNameT>("saAmfCompNumMaxActiveCSIs"),
-      const_cast<SaImmAttrNameT>("saAmfCompNumMaxStandbyCSIs"), nullptr};
   TRACE_ENTER();
 
-  searchParam.searchOneAttr.attrName =
-      const_cast<SaImmAttrNameT>("SaImmAttrClassName");
-  searchParam.searchOneAttr.attrValueType = SA_IMM_ATTR_SASTRINGT;
-  searchParam.searchOneAttr.attrValue = &className;
-
-  error = immutil_saImmOmSearchInitialize_o2(
-      avd_cb->immOmHandle, name.c_str(), SA_IMM_SUBTREE,
-      SA_IMM_SEARCH_ONE_ATTR | SA_IMM_SEARCH_GET_SOME_ATTR, &searchParam,
-      attributeNames, &searchHandle);
+  error = search.initialize(name, className, compcstype_config_attributes);
 
   if (SA_AIS_OK != error) {
     LOG_ER("saImmOmSearchInitialize_2 failed: %u", error);
     goto done1;
   }
 
-  while ((error = immutil_saImmOmSearchNext_2(
-              searchHandle, &dn, (SaImmAttrValuesT_2 ***)&attributes)) ==
-         SA_AIS_OK) {
+  while ((error = search.next(&dn, &attributes)) == SA_AIS_OK) {
     if (!is_config_valid(Amf::to_string(&dn), nullptr)) {
       error = SA_AIS_ERR_FAILED_OPERATION;
       goto done2;
@@ -328,7 +319,7 @@ SaAisErrorT avd_compcstype_config_get(const std::string &name, AVD_COMP *comp) {
   error = SA_AIS_OK;
 
 done2:
-  (void)immutil_saImmOmSearchFinalize(searchHandle);
+  search.finalize();
 done1:
   TRACE_LEAVE2("%u", error);
   return error;
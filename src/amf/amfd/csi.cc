@@ -24,8 +24,9 @@
 #include "amf/amfd/csi.h"
 #include "amf/amfd/imm.h"
 #include "amf/amfd/proc.h"
+#include "amf/amfd/imm_cache.h"
 
-AmfDb<std::string, AVD_CSI> *csi_db = nullptr;
+AmfHashDb<std::string, AVD_CSI> *csi_db = nullptr;
 
 //
 AVD_COMP *AVD_CSI::find_assigned_comp(
@@ -473,30 +474,19 @@ done:
  */
 SaAisErrorT avd_csi_config_get(const std::string &si_name, AVD_SI *si) {
   SaAisErrorT error = SA_AIS_ERR_FAILED_OPERATION;
-  SaImmSearchHandleT searchHandle;
-  SaImmSearchParametersT_2 searchParam;
+  ImmConfigSearch search;
   SaNameT temp_csi_name;
 
   const SaImmAttrValuesT_2 **attributes;
   const char *className = "SaAmfCSI";
   AVD_CSI *csi;
 
-  searchParam.searchOneAttr.attrName =
-      const_cast<SaImmAttrNameT>("SaImmAttrClassName");
-  searchParam.searchOneAttr.attrValueType = SA_IMM_ATTR_SASTRINGT;
-  searchParam.searchOneAttr.attrValue = &className;
-
-  if (immutil_saImmOmSearchInitialize_o2(
-          avd_cb->immOmHandle, si_name.c_str(), SA_IMM_SUBTREE,
-          SA_IMM_SEARCH_ONE_ATTR | SA_IMM_SEARCH_GET_ALL_ATTR, &searchParam,
-          nullptr, &searchHandle) != SA_AIS_OK) {
+  if (search.initialize(si_name, className, nullptr) != SA_AIS_OK) {
     LOG_ER("saImmOmSearchInitialize_2 failed");
     goto done1;
   }
 
-  while (immutil_saImmOmSearchNext_2(searchHandle, &temp_csi_name,
-                                     (SaImmAttrValuesT_2 ***)&attributes) ==
-         SA_AIS_OK) {
+  while (search.next(&temp_csi_name, &attributes) == SA_AIS_OK) {
     const std::string csi_name(Amf::to_string(&temp_csi_name));
     if (!is_config_valid(csi_name, attributes, nullptr)) goto done2;
 
@@ -515,7 +505,7 @@ SaAisErrorT avd_csi_config_get(const std::string &si_name, AVD_SI *si) {
   error = SA_AIS_OK;
 
 done2:
-  (void)immutil_saImmOmSearchFinalize(searchHandle);
+  search.finalize();
 done1:
 
   return error;
@@ -1483,7 +1473,7 @@ void avd_csi_add_csiattr(AVD_CSI *csi, AVD_CSI_ATTR *csiattr) {
 }
 
 void avd_csi_constructor(void) {
-  csi_db = new AmfDb<std::string, AVD_CSI>;
+  csi_db = new AmfHashDb<std::string, AVD_CSI>;
   avd_class_impl_set("SaAmfCSI", nullptr, nullptr, csi_ccb_completed_cb,
                      csi_ccb_apply_cb);
 }
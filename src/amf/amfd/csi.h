@@ -105,7 +105,7 @@ class AVD_CSI {
   void operator=(const AVD_CSI &);
 };
 
-extern AmfDb<std::string, AVD_CSI> *csi_db;
+extern AmfHashDb<std::string, AVD_CSI> *csi_db;
 
 class AVD_CS_TYPE {
  public:
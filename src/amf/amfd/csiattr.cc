@@ -22,6 +22,7 @@
 #include "amf/common/amf_util.h"
 #include "amf/amfd/csi.h"
 #include "amf/amfd/imm.h"
+#include "amf/amfd/imm_cache.h"
 
 /*****************************************************************************
  * Function: csiattr_dn_to_csiattr_name
@@ -229,30 +230,19 @@ static int is_config_valid(const std::string &dn,
  */
 SaAisErrorT avd_csiattr_config_get(const std::string &csi_name, AVD_CSI *csi) {
   SaAisErrorT error;
-  SaImmSearchHandleT searchHandle;
-  SaImmSearchParametersT_2 searchParam;
+  ImmConfigSearch search;
   SaNameT csiattr_name;
   const SaImmAttrValuesT_2 **attributes;
   const char *className = "SaAmfCSIAttribute";
   AVD_CSI_ATTR *csiattr;
 
   TRACE_ENTER();
-  searchParam.searchOneAttr.attrName =
-      const_cast<SaImmAttrNameT>("SaImmAttrClassName");
-  searchParam.searchOneAttr.attrValueType = SA_IMM_ATTR_SASTRINGT;
-  searchParam.searchOneAttr.attrValue = &className;
-
-  if ((error = immutil_saImmOmSearchInitialize_o2(
-           avd_cb->immOmHandle, csi_name.c_str(), SA_IMM_SUBTREE,
-           SA_IMM_SEARCH_ONE_ATTR | SA_IMM_SEARCH_GET_ALL_ATTR, &searchParam,
-           nullptr, &searchHandle)) != SA_AIS_OK) {
+  if ((error = search.initialize(csi_name, className, nullptr)) != SA_AIS_OK) {
     LOG_ER("saImmOmSearchInitialize failed: %u", error);
     goto done1;
   }
 
-  while ((error = immutil_saImmOmSearchNext_2(
-              searchHandle, &csiattr_name,
-              (SaImmAttrValuesT_2 ***)&attributes)) == SA_AIS_OK) {
+  while ((error = search.next(&csiattr_name, &attributes)) == SA_AIS_OK) {
     if ((csiattr = csiattr_create(Amf::to_string(&csiattr_name), attributes)) !=
         nullptr)
       avd_csi_add_csiattr(csi, csiattr);
@@ -260,7 +250,7 @@ SaAisErrorT avd_csiattr_config_get(const std::string &csi_name, AVD_CSI *csi) {
 
   error = SA_AIS_OK;
 
-  (void)immutil_saImmOmSearchFinalize(searchHandle);
+  search.finalize();
 
 done1:
   TRACE_LEAVE2("%u", error);
@@ -25,6 +25,7 @@
 #include "amf/amfd/comp.h"
 #include "amf/amfd/imm.h"
 #include "amf/amfd/csi.h"
+#include "amf/amfd/imm_cache.h"
 
 AmfDb<std::string, AVD_CTCS_TYPE> *ctcstype_db = nullptr;
 static void find_ct_name_from_association(const std::string& haystack, std::string& dn, const char *needle);
@@ -126,8 +127,7 @@ static AVD_CTCS_TYPE *ctcstype_create(const std::string &dn,
 SaAisErrorT avd_ctcstype_config_get(const std::string &comp_type_dn,
                                     AVD_COMP_TYPE *comp_type) {
   SaAisErrorT error = SA_AIS_ERR_FAILED_OPERATION;
-  SaImmSearchHandleT searchHandle;
-  SaImmSearchParametersT_2 searchParam;
+  ImmConfigSearch search;
   SaNameT dn;
   const SaImmAttrValuesT_2 **attributes;
   const char *className = "SaAmfCtCsType";
@@ -135,22 +135,12 @@ SaAisErrorT avd_ctcstype_config_get(const std::string &comp_type_dn,
 
   TRACE_ENTER();
 
-  searchParam.searchOneAttr.attrName =
-      const_cast<SaImmAttrNameT>("SaImmAttrClassName");
-  searchParam.searchOneAttr.attrValueType = SA_IMM_ATTR_SASTRINGT;
-  searchParam.searchOneAttr.attrValue = &className;
-
-  if (immutil_saImmOmSearchInitialize_o2(
-          avd_cb->immOmHandle, comp_type_dn.c_str(), SA_IMM_SUBTREE,
-          SA_IMM_SEARCH_ONE_ATTR | SA_IMM_SEARCH_GET_ALL_ATTR, &searchParam,
-          nullptr, &searchHandle) != SA_AIS_OK) {
+  if (search.initialize(comp_type_dn, className, nullptr) != SA_AIS_OK) {
     LOG_ER("saImmOmSearchInitialize_2 failed: %u", error);
     goto done1;
   }
 
-  while (immutil_saImmOmSearchNext_2(searchHandle, &dn,
-                                     (SaImmAttrValuesT_2 ***)&attributes) ==
-         SA_AIS_OK) {
+  while (search.next(&dn, &attributes) == SA_AIS_OK) {
     if (!is_config_valid(Amf::to_string(&dn), attributes, nullptr)) goto done2;
 
     if ((ctcstype = ctcstype_db->find(Amf::to_string(&dn))) == nullptr) {
@@ -165,7 +155,7 @@ SaAisErrorT avd_ctcstype_config_get(const std::string &comp_type_dn,
   error = SA_AIS_OK;
 
 done2:
-  (void)immutil_saImmOmSearchFinalize(searchHandle);
+  search.finalize();
 done1:
   TRACE_LEAVE2("%u", error);
   return error;
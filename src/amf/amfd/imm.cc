@@ -50,6 +50,7 @@
 #include "amf/amfd/csi.h"
 #include "amf/amfd/si_dep.h"
 #include "amf/amfd/config.h"
+#include "amf/amfd/imm_cache.h"
 #include "base/osaf_utility.h"
 
 #include "base/osaf_time.h"
@@ -1631,11 +1632,58 @@ SaAisErrorT avd_imm_default_OK_completed_cb(CcbUtilOperationData_t *opdata) {
   }
 }
 
+/**
+ * Read a part of the configuration and add the time it took to timing.
+ */
+static SaAisErrorT config_get_timed(const char *name,
+                                    SaAisErrorT (*config_get)(void),
+                                    std::string *timing) {
+  struct timespec start, end, elapsed;
+  SaAisErrorT rc;
+
+  osaf_clock_gettime(CLOCK_MONOTONIC, &start);
+  rc = config_get();
+  osaf_clock_gettime(CLOCK_MONOTONIC, &end);
+  osaf_timespec_subtract(&end, &start, &elapsed);
+
+  if (!timing->empty()) *timing += ", ";
+  *timing += std::string(name) + " " +
+             std::to_string(osaf_timespec_to_millis(&elapsed)) + " ms";
+  return rc;
+}
+
+static SaAisErrorT configuration_get(void) {
+  return configuration->get_config();
+}
+
 unsigned int avd_imm_config_get(void) {
   uint32_t rc = NCSCC_RC_FAILURE;
+  ImmConfigCache cache;
+  std::string timing;
+  struct timespec start, end, elapsed;
 
   TRACE_ENTER();
 
+  osaf_clock_gettime(CLOCK_MONOTONIC, &start);
+
+  /*
+  ** The classes below are read with one search per parent object when the
+  ** model is parsed. Read each of them with one search instead, the
+  ** largest classes first since they are read concurrently.
+  */
+  cache.add("SaAmfComp", comp_config_attributes);
+  cache.add("SaAmfCompCsType", compcstype_config_attributes);
+  cache.add("SaAmfSU", su_config_attributes);
+  cache.add("SaAmfCSI", nullptr);
+  cache.add("SaAmfCSIAttribute", nullptr);
+  cache.add("SaAmfSI", si_config_attributes);
+  cache.add("SaAmfSIRankedSU", nullptr);
+  cache.add("SaAmfSG", sg_config_attributes);
+  cache.add("SaAmfCtCsType", nullptr);
+  cache.add("SaAmfSutCompType", nullptr);
+  cache.add("SaAmfSvcTypeCSTypes", nullptr);
+  cache.read();
+
   /*
   ** Get types first since instances are dependent of them.
   **
@@ -1650,37 +1698,67 @@ unsigned int avd_imm_config_get(void) {
   */
 
   /* SaAmfCSType needed by validation of SaAmfCtCsType */
-  if (avd_cstype_config_get() != SA_AIS_OK) goto done;
+  if (config_get_timed("SaAmfCSType", avd_cstype_config_get, &timing) !=
+      SA_AIS_OK)
+    goto done;
 
   /* SaAmfCompType indirectly needed by SaAmfSUType */
-  if (avd_comptype_config_get() != SA_AIS_OK) goto done;
+  if (config_get_timed("SaAmfCompType", avd_comptype_config_get, &timing) !=
+      SA_AIS_OK)
+    goto done;
 
   /* SaAmfSUType needed by SaAmfSGType */
-  if (avd_sutype_config_get() != SA_AIS_OK) goto done;
+  if (config_get_timed("SaAmfSUType", avd_sutype_config_get, &timing) !=
+      SA_AIS_OK)
+    goto done;
 
   /* SaAmfSGType needed by SaAmfAppType */
-  if (avd_sgtype_config_get() != SA_AIS_OK) goto done;
+  if (config_get_timed("SaAmfSGType", avd_sgtype_config_get, &timing) !=
+      SA_AIS_OK)
+    goto done;
 
-  if (avd_apptype_config_get() != SA_AIS_OK) goto done;
+  if (config_get_timed("SaAmfAppType", avd_apptype_config_get, &timing) !=
+      SA_AIS_OK)
+    goto done;
 
-  if (avd_svctype_config_get() != SA_AIS_OK) goto done;
+  if (config_get_timed("SaAmfSvcType", avd_svctype_config_get, &timing) !=
+      SA_AIS_OK)
+    goto done;
 
-  if (avd_compglobalattrs_config_get() != SA_AIS_OK) goto done;
+  if (config_get_timed("SaAmfCompGlobalAttributes",
+                       avd_compglobalattrs_config_get,
+                       &timing) != SA_AIS_OK)
+    goto done;
 
-  if (avd_cluster_config_get() != SA_AIS_OK) goto done;
+  if (config_get_timed("SaAmfCluster", avd_cluster_config_get, &timing) !=
+      SA_AIS_OK)
+    goto done;
 
-  if (avd_node_config_get() != SA_AIS_OK) goto done;
+  if (config_get_timed("SaAmfNode", avd_node_config_get, &timing) !=
+      SA_AIS_OK)
+    goto done;
 
-  if (avd_ng_config_get() != SA_AIS_OK) goto done;
+  if (config_get_timed("SaAmfNodeGroup", avd_ng_config_get, &timing) !=
+      SA_AIS_OK)
+    goto done;
 
-  if (avd_app_config_get() != SA_AIS_OK) goto done;
+  /* SaAmfApplication and the SGs, SUs, SIs etc. below them */
+  if (config_get_timed("SaAmfApplication", avd_app_config_get, &timing) !=
+      SA_AIS_OK)
+    goto done;
 
-  if (avd_sidep_config_get() != SA_AIS_OK) goto done;
+  if (config_get_timed("SaAmfSIDependency", avd_sidep_config_get, &timing) !=
+      SA_AIS_OK)
+    goto done;
 
   /* retrieve hydra configuration from IMM */
-  if (hydra_config_get() != SA_AIS_OK) goto done;
+  if (config_get_timed("scAbsenceAllowed", hydra_config_get, &timing) !=
+      SA_AIS_OK)
+    goto done;
 
-  if (configuration->get_config() != SA_AIS_OK) goto done;
+  if (config_get_timed("OpenSafAmfConfig", configuration_get, &timing) !=
+      SA_AIS_OK)
+    goto done;
 
   // SGs needs to adjust configuration once all instances have been added
   {
@@ -1693,10 +1771,18 @@ unsigned int avd_imm_config_get(void) {
   rc = NCSCC_RC_SUCCESS;
 
 done:
-  if (rc == NCSCC_RC_SUCCESS)
+  osaf_clock_gettime(CLOCK_MONOTONIC, &end);
+  osaf_timespec_subtract(&end, &start, &elapsed);
+
+  if (rc == NCSCC_RC_SUCCESS) {
     TRACE("AMF Configuration successfully read from IMM");
-  else
+    LOG_NO("AMF configuration read in %" PRIu64 " ms: %s",
+           osaf_timespec_to_millis(&elapsed), timing.c_str());
+    LOG_NO("AMF configuration classes read up front: %s",
+           cache.timing().c_str());
+  } else {
     LOG_WA("Failed to read configuration.");
+  }
 
   TRACE_LEAVE2("%u", rc);
   return rc;
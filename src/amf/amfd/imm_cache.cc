@@ -0,0 +1,418 @@
+/*      -*- OpenSAF  -*-
+ *
+ * (C) Copyright 2017 The OpenSAF Foundation
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. This file and program are licensed
+ * under the GNU Lesser General Public License Version 2.1, February 1999.
+ * The complete license can be accessed from the following location:
+ * http://opensource.org/licenses/lgpl-license.php
+ * See the Copying file included with the OpenSAF distribution for full
+ * licensing terms.
+ *
+ */
+
+#include "amf/amfd/imm_cache.h"
+#include <string.h>
+#include "base/logtrace.h"
+#include "base/osaf_extended_name.h"
+#include "base/osaf_time.h"
+#include "osaf/immutil/immutil.h"
+#include "amf/amfd/cb.h"
+
+/* Max number of threads reading classes */
+#define IMM_CACHE_READERS 4
+
+static thread_local const ImmConfigCache *current_cache = nullptr;
+static const ImmConfigCache::ObjectList no_objects;
+
+static size_t align(size_t size) {
+  return (size + 7) & ~static_cast<size_t>(7);
+}
+
+static size_t value_size(SaImmValueTypeT type) {
+  switch (type) {
+    case SA_IMM_ATTR_SAINT32T:
+      return sizeof(SaInt32T);
+    case SA_IMM_ATTR_SAUINT32T:
+      return sizeof(SaUint32T);
+    case SA_IMM_ATTR_SAINT64T:
+      return sizeof(SaInt64T);
+    case SA_IMM_ATTR_SAUINT64T:
+      return sizeof(SaUint64T);
+    case SA_IMM_ATTR_SATIMET:
+      return sizeof(SaTimeT);
+    case SA_IMM_ATTR_SANAMET:
+      return sizeof(SaNameT);
+    case SA_IMM_ATTR_SAFLOATT:
+      return sizeof(SaFloatT);
+    case SA_IMM_ATTR_SADOUBLET:
+      return sizeof(SaDoubleT);
+    case SA_IMM_ATTR_SASTRINGT:
+      return sizeof(SaStringT);
+    case SA_IMM_ATTR_SAANYT:
+      return sizeof(SaAnyT);
+  }
+  return 0;
+}
+
+// Size of the data a value points to
+static size_t value_data_size(SaImmValueTypeT type, const void *value) {
+  switch (type) {
+    case SA_IMM_ATTR_SASTRINGT: {
+      const char *str = *static_cast<const SaStringT *>(value);
+      return str != nullptr ? strlen(str) + 1 : 0;
+    }
+    case SA_IMM_ATTR_SANAMET:
+      return osaf_extended_name_length(static_cast<const SaNameT *>(value)) + 1;
+    case SA_IMM_ATTR_SAANYT:
+      return static_cast<const SaAnyT *>(value)->bufferSize;
+    default:
+      return 0;
+  }
+}
+
+static void copy_value(SaImmValueTypeT type, const void *value, void *copy,
+                       char *data) {
+  switch (type) {
+    case SA_IMM_ATTR_SASTRINGT: {
+      const char *str = *static_cast<const SaStringT *>(value);
+      if (str != nullptr) strcpy(data, str);
+      *static_cast<SaStringT *>(copy) = str != nullptr ? data : nullptr;
+      break;
+    }
+    case SA_IMM_ATTR_SANAMET: {
+      const SaNameT *name = static_cast<const SaNameT *>(value);
+      strcpy(data, osaf_extended_name_borrow(name));
+      osaf_extended_name_lend(data, static_cast<SaNameT *>(copy));
+      break;
+    }
+    case SA_IMM_ATTR_SAANYT: {
+      const SaAnyT *any = static_cast<const SaAnyT *>(value);
+      SaAnyT *any_copy = static_cast<SaAnyT *>(copy);
+      memcpy(data, any->bufferAddr, any->bufferSize);
+      any_copy->bufferSize = any->bufferSize;
+      any_copy->bufferAddr = reinterpret_cast<SaUint8T *>(data);
+      break;
+    }
+    default:
+      memcpy(copy, value, value_size(type));
+      break;
+  }
+}
+
+/**
+ * Copy the attributes of a search result into one buffer of the object.
+ */
+void ImmConfigCache::copyAttributes(const SaImmAttrValuesT_2 **attributes,
+                                    Object *object) {
+  const SaImmAttrValuesT_2 *attr;
+  size_t size = 0;
+  unsigned int i, j;
+
+  for (i = 0; (attr = attributes[i]) != nullptr; i++) {
+    size_t vsize = align(value_size(attr->attrValueType));
+
+    size += align(sizeof(SaImmAttrValuesT_2)) +
+            align(strlen(attr->attrName) + 1) +
+            align(attr->attrValuesNumber * sizeof(SaImmAttrValueT));
+    for (j = 0; j < attr->attrValuesNumber; j++)
+      size += vsize +
+              align(value_data_size(attr->attrValueType, attr->attrValues[j]));
+  }
+
+  object->data.resize(size);
+  object->attributes.reserve(i + 1);
+  char *p = object->data.data();
+
+  for (i = 0; (attr = attributes[i]) != nullptr; i++) {
+    size_t vsize = align(value_size(attr->attrValueType));
+    SaImmAttrValuesT_2 *copy = reinterpret_cast<SaImmAttrValuesT_2 *>(p);
+
+    p += align(sizeof(SaImmAttrValuesT_2));
+    strcpy(p, attr->attrName);
+    copy->attrName = p;
+    p += align(strlen(attr->attrName) + 1);
+    copy->attrValueType = attr->attrValueType;
+    copy->attrValuesNumber = attr->attrValuesNumber;
+    copy->attrValues = nullptr;
+    if (attr->attrValuesNumber > 0)
+      copy->attrValues = reinterpret_cast<SaImmAttrValueT *>(p);
+    p += align(attr->attrValuesNumber * sizeof(SaImmAttrValueT));
+
+    for (j = 0; j < attr->attrValuesNumber; j++) {
+      copy->attrValues[j] = p;
+      p += vsize;
+      copy_value(attr->attrValueType, attr->attrValues[j], copy->attrValues[j],
+                 p);
+      p += align(value_data_size(attr->attrValueType, attr->attrValues[j]));
+    }
+    object->attributes.push_back(copy);
+  }
+  object->attributes.push_back(nullptr);
+}
+
+/**
+ * The DN without its first RDN, a comma escaped with '\' is part of the RDN.
+ */
+std::string ImmConfigCache::parentDn(const std::string &dn) {
+  for (size_t i = 0; i < dn.size(); i++) {
+    if (dn[i] == '\\')
+      i++;
+    else if (dn[i] == ',')
+      return dn.substr(i + 1);
+  }
+  return "";
+}
+
+static bool same_attributes(const SaImmAttrNameT *names1,
+                            const SaImmAttrNameT *names2) {
+  if (names1 == nullptr || names2 == nullptr) return names1 == names2;
+
+  for (; *names1 != nullptr && *names2 != nullptr; names1++, names2++) {
+    if (strcmp(*names1, *names2) != 0) return false;
+  }
+  return *names1 == *names2;
+}
+
+static SaAisErrorT search_initialize(SaImmHandleT handle, const char *root,
+                                     const char *className,
+                                     SaImmAttrNameT *attributeNames,
+                                     SaImmSearchHandleT *searchHandle) {
+  SaImmSearchParametersT_2 searchParam;
+
+  searchParam.searchOneAttr.attrName =
+      const_cast<SaImmAttrNameT>("SaImmAttrClassName");
+  searchParam.searchOneAttr.attrValueType = SA_IMM_ATTR_SASTRINGT;
+  searchParam.searchOneAttr.attrValue = &className;
+
+  return immutil_saImmOmSearchInitialize_o2(
+      handle, root, SA_IMM_SUBTREE,
+      SA_IMM_SEARCH_ONE_ATTR | (attributeNames != nullptr
+                                    ? SA_IMM_SEARCH_GET_SOME_ATTR
+                                    : SA_IMM_SEARCH_GET_ALL_ATTR),
+      &searchParam, attributeNames, searchHandle);
+}
+
+ImmConfigCache::ImmConfigCache() : next_(0) {
+  pthread_mutex_init(&mutex_, nullptr);
+}
+
+ImmConfigCache::~ImmConfigCache() {
+  if (current_cache == this) current_cache = nullptr;
+  pthread_mutex_destroy(&mutex_);
+}
+
+/**
+ * Add a class to read.
+ *
+ * @param className
+ * @param attributeNames the attributes to read, nullptr for all attributes
+ */
+void ImmConfigCache::add(const char *className,
+                         SaImmAttrNameT *attributeNames) {
+  classes_.emplace_back();
+  Class &cls = classes_.back();
+  cls.name = className;
+  cls.attributeNames = attributeNames;
+  cls.read = false;
+  cls.millis = 0;
+}
+
+ImmConfigCache::Class *ImmConfigCache::next() {
+  Class *cls = nullptr;
+
+  pthread_mutex_lock(&mutex_);
+  if (next_ < classes_.size()) cls = &classes_[next_++];
+  pthread_mutex_unlock(&mutex_);
+  return cls;
+}
+
+SaAisErrorT ImmConfigCache::readClass(SaImmHandleT handle, Class *cls) {
+  SaImmSearchHandleT searchHandle;
+  SaNameT dn;
+  const SaImmAttrValuesT_2 **attributes;
+  SaAisErrorT rc;
+
+  rc = search_initialize(handle, nullptr, cls->name.c_str(),
+                         cls->attributeNames, &searchHandle);
+  if (rc != SA_AIS_OK) return rc;
+
+  while ((rc = immutil_saImmOmSearchNext_2(
+              searchHandle, &dn, (SaImmAttrValuesT_2 ***)&attributes)) ==
+         SA_AIS_OK) {
+    cls->objects.emplace_back();
+    Object &object = cls->objects.back();
+    object.dn = osaf_extended_name_borrow(&dn);
+    copyAttributes(attributes, &object);
+    cls->byParent[parentDn(object.dn)].push_back(&object);
+  }
+
+  (void)immutil_saImmOmSearchFinalize(searchHandle);
+  return rc == SA_AIS_ERR_NOT_EXIST ? SA_AIS_OK : rc;
+}
+
+void *ImmConfigCache::reader(void *arg) {
+  ImmConfigCache *cache = static_cast<ImmConfigCache *>(arg);
+  SaVersionT version = {'A', 2, 15};
+  SaImmHandleT handle;
+  SaAisErrorT rc;
+  Class *cls;
+
+  if ((rc = immutil_saImmOmInitialize(&handle, nullptr, &version)) !=
+      SA_AIS_OK) {
+    LOG_WA("saImmOmInitialize failed %u", rc);
+    return nullptr;
+  }
+
+  while ((cls = cache->next()) != nullptr) {
+    struct timespec start, end, elapsed;
+
+    osaf_clock_gettime(CLOCK_MONOTONIC, &start);
+    rc = readClass(handle, cls);
+    osaf_clock_gettime(CLOCK_MONOTONIC, &end);
+    osaf_timespec_subtract(&end, &start, &elapsed);
+
+    if (rc != SA_AIS_OK) {
+      // The objects are searched for per parent instead
+      LOG_WA("Failed to read %s objects: %u", cls->name.c_str(), rc);
+      cls->objects.clear();
+      cls->byParent.clear();
+      continue;
+    }
+    cls->read = true;
+    cls->millis = osaf_timespec_to_millis(&elapsed);
+    TRACE("%zu %s objects read in %" PRIu64 " ms", cls->objects.size(),
+          cls->name.c_str(), cls->millis);
+  }
+
+  (void)immutil_saImmOmFinalize(handle);
+  return nullptr;
+}
+
+/**
+ * Read the added classes, up to IMM_CACHE_READERS classes concurrently, and
+ * make the cache current for the calling thread. A class that could not be
+ * read is left out of the cache.
+ */
+void ImmConfigCache::read() {
+  pthread_t threads[IMM_CACHE_READERS];
+  size_t num_threads = 0;
+
+  TRACE_ENTER();
+
+  while (num_threads < IMM_CACHE_READERS &&
+         num_threads < classes_.size()) {
+    if (pthread_create(&threads[num_threads], nullptr, reader, this) != 0) {
+      LOG_WA("pthread_create failed: %s", strerror(errno));
+      break;
+    }
+    num_threads++;
+  }
+
+  if (num_threads == 0) reader(this);
+
+  for (size_t i = 0; i < num_threads; i++) pthread_join(threads[i], nullptr);
+
+  current_cache = this;
+  TRACE_LEAVE();
+}
+
+/**
+ * Find the cached objects of a class below a parent.
+ *
+ * @return the objects, nullptr if the class is not cached with the
+ *         attributes asked for
+ */
+const ImmConfigCache::ObjectList *ImmConfigCache::find(
+    const char *className, SaImmAttrNameT *attributeNames,
+    const std::string &parent) const {
+  for (const auto &cls : classes_) {
+    if (!cls.read || cls.name != className ||
+        !same_attributes(cls.attributeNames, attributeNames))
+      continue;
+
+    const auto it = cls.byParent.find(parent);
+    return it != cls.byParent.end() ? &it->second : &no_objects;
+  }
+  return nullptr;
+}
+
+/**
+ * The number of objects and the time it took to read them, per class.
+ */
+std::string ImmConfigCache::timing() const {
+  std::string result;
+
+  for (const auto &cls : classes_) {
+    if (!cls.read) continue;
+    if (!result.empty()) result += ", ";
+    result += cls.name + " " + std::to_string(cls.objects.size()) + " in " +
+              std::to_string(cls.millis) + " ms";
+  }
+  return result;
+}
+
+/**
+ * The cache of the model being read by the calling thread, if any.
+ */
+const ImmConfigCache *ImmConfigCache::current() { return current_cache; }
+
+ImmConfigSearch::ImmConfigSearch()
+    : searchHandle_(0), searching_(false), objects_(nullptr), index_(0) {}
+
+ImmConfigSearch::~ImmConfigSearch() { finalize(); }
+
+/**
+ * Start a search for the objects of a class below a parent, with the same
+ * scope and options as the IMM searches reading the AMF model.
+ *
+ * @param parent DN of the parent, the empty string for all objects
+ * @param className
+ * @param attributeNames the attributes to get, nullptr for all attributes
+ */
+SaAisErrorT ImmConfigSearch::initialize(const std::string &parent,
+                                        const char *className,
+                                        SaImmAttrNameT *attributeNames) {
+  const ImmConfigCache *cache = ImmConfigCache::current();
+  SaAisErrorT rc;
+
+  if (cache != nullptr &&
+      (objects_ = cache->find(className, attributeNames, parent)) != nullptr) {
+    index_ = 0;
+    return SA_AIS_OK;
+  }
+
+  rc = search_initialize(avd_cb->immOmHandle,
+                         parent.empty() ? nullptr : parent.c_str(), className,
+                         attributeNames, &searchHandle_);
+  searching_ = rc == SA_AIS_OK;
+  return rc;
+}
+
+/**
+ * Get the next object, SA_AIS_ERR_NOT_EXIST when there are no more. The DN
+ * and attributes stay valid until the next call.
+ */
+SaAisErrorT ImmConfigSearch::next(SaNameT *dn,
+                                  const SaImmAttrValuesT_2 ***attributes) {
+  if (searching_)
+    return immutil_saImmOmSearchNext_2(
+        searchHandle_, dn, const_cast<SaImmAttrValuesT_2 ***>(attributes));
+
+  if (objects_ == nullptr || index_ == objects_->size())
+    return SA_AIS_ERR_NOT_EXIST;
+
+  const ImmConfigCache::Object *object = (*objects_)[index_++];
+  osaf_extended_name_lend(object->dn.c_str(), dn);
+  *attributes = const_cast<const SaImmAttrValuesT_2 **>(
+      object->attributes.data());
+  return SA_AIS_OK;
+}
+
+void ImmConfigSearch::finalize() {
+  if (searching_) (void)immutil_saImmOmSearchFinalize(searchHandle_);
+  searching_ = false;
+  objects_ = nullptr;
+}
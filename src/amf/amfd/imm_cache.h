@@ -0,0 +1,107 @@
+/*      -*- OpenSAF  -*-
+ *
+ * (C) Copyright 2017 The OpenSAF Foundation
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. This file and program are licensed
+ * under the GNU Lesser General Public License Version 2.1, February 1999.
+ * The complete license can be accessed from the following location:
+ * http://opensource.org/licenses/lgpl-license.php
+ * See the Copying file included with the OpenSAF distribution for full
+ * licensing terms.
+ *
+ */
+
+/*****************************************************************************
+
+  DESCRIPTION:
+
+  The AMF model is read top down, most classes with one IMM search per
+  parent object, e.g. one search for the components of each SU. On a large
+  model that is thousands of searches. ImmConfigCache reads such classes
+  with one search each, the classes concurrently on an IMM handle of their
+  own, and keeps the objects by parent DN while the model is read.
+  ImmConfigSearch is used instead of an IMM search for the objects of a
+  class below a parent, it returns the cached objects if the class has been
+  read and searches IMM otherwise.
+
+  The cached classes must have their objects directly below the parent
+  searched for, which is the case for the classes read per parent object in
+  the AMF model.
+
+******************************************************************************
+*/
+
+#ifndef AMF_AMFD_IMM_CACHE_H_
+#define AMF_AMFD_IMM_CACHE_H_
+
+#include <pthread.h>
+#include <deque>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "imm/saf/saImmOm.h"
+
+class ImmConfigCache {
+ public:
+  // An object copied from a search result
+  struct Object {
+    std::string dn;
+    std::vector<const SaImmAttrValuesT_2 *> attributes;
+    std::vector<char> data;
+  };
+  typedef std::vector<const Object *> ObjectList;
+
+  ImmConfigCache();
+  ~ImmConfigCache();
+  void add(const char *className, SaImmAttrNameT *attributeNames);
+  void read();
+  const ObjectList *find(const char *className, SaImmAttrNameT *attributeNames,
+                         const std::string &parent) const;
+  std::string timing() const;
+  static const ImmConfigCache *current();
+  static void copyAttributes(const SaImmAttrValuesT_2 **attributes,
+                             Object *object);
+  static std::string parentDn(const std::string &dn);
+
+ private:
+  struct Class {
+    std::string name;
+    SaImmAttrNameT *attributeNames;
+    bool read;
+    uint64_t millis;
+    std::deque<Object> objects;
+    std::unordered_map<std::string, ObjectList> byParent;
+  };
+
+  static void *reader(void *arg);
+  static SaAisErrorT readClass(SaImmHandleT handle, Class *cls);
+  Class *next();
+
+  std::deque<Class> classes_;
+  size_t next_;
+  pthread_mutex_t mutex_;
+  ImmConfigCache(const ImmConfigCache &) = delete;
+  ImmConfigCache &operator=(const ImmConfigCache &) = delete;
+};
+
+class ImmConfigSearch {
+ public:
+  ImmConfigSearch();
+  ~ImmConfigSearch();
+  SaAisErrorT initialize(const std::string &parent, const char *className,
+                         SaImmAttrNameT *attributeNames);
+  SaAisErrorT next(SaNameT *dn, const SaImmAttrValuesT_2 ***attributes);
+  void finalize();
+
+ private:
+  SaImmSearchHandleT searchHandle_;
+  bool searching_;
+  const ImmConfigCache::ObjectList *objects_;
+  size_t index_;
+  ImmConfigSearch(const ImmConfigSearch &) = delete;
+  ImmConfigSearch &operator=(const ImmConfigSearch &) = delete;
+};
+
+#endif  // AMF_AMFD_IMM_CACHE_H_
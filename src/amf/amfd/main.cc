@@ -646,6 +646,9 @@ static void main_loop(void) {
       nfds = FD_IMM;
     }
 
+    /* send the async updates batched while processing the last events */
+    avsv_send_ckpt_batch(cb);
+
     int pollretval = poll(fds, nfds, polltmo);
 
     if (pollretval == -1) {
@@ -75,6 +75,8 @@ class AVD_CSI;
 uint32_t avd_d2n_msg_dequeue(struct cl_cb_tag *cb);
 uint32_t avd_d2n_msg_snd(struct cl_cb_tag *cb, AVD_AVND *nd_node,
                          AVD_DND_MSG *snd_msg);
+bool avd_d2n_susi_msg_batch(struct cl_cb_tag *cb, AVD_AVND *nd_node,
+                            AVD_DND_MSG *susi_msg);
 uint32_t avd_n2d_msg_rcv(AVD_DND_MSG *rcv_msg, NODE_ID node_id,
                          uint16_t msg_fmt_ver);
 uint32_t avd_mds_cpy(MDS_CALLBACK_COPY_INFO *cpy_info);
@@ -34,6 +34,7 @@
   avd_mds_dec - decodes AvND to AVD messages.
   avd_mds_dec_flat - decodes flat AvND to AVD messages. Dummy not required.
   avd_d2n_msg_snd - transmits message to node director.
+  avd_d2n_susi_msg_batch - adds a SU SI operation to a queued message.
   avd_d2n_msg_bcast - broadcasts message to all node director.
   avd_n2d_msg_rcv - Procresses messages from AvND.
 
@@ -44,7 +45,24 @@
  * Module Inclusion Control...
  */
 
+#include <map>
 #include "amf/amfd/amfd.h"
+#include "amf/common/amf_fotrace.h"
+
+/* Max number of SU SI operations carried in one SU SI assign message */
+#define AVD_SUSI_MSG_BATCH_MAX 64
+
+/*
+ * A SU SI assign message that is the last one queued for a node, further
+ * SU SI operations for the node can be added to it until the queue is sent.
+ */
+typedef struct {
+  AVD_DND_MSG *msg;
+  AVSV_D2N_INFO_SU_SI_ASSIGN_MSG_INFO **tail;
+  uint32_t num_ops;
+} AVD_SUSI_MSG_BATCH;
+
+static std::map<SaClmNodeIdT, AVD_SUSI_MSG_BATCH> susi_msg_batches;
 
 /****************************************************************************
   Name          : avd_mds_enc
@@ -222,6 +240,8 @@ uint32_t avd_d2n_msg_dequeue(AVD_CL_CB *cb) {
    * De-queue messages from the Queue and then do the MDS send.
    */
 
+  susi_msg_batches.clear();
+
   while (!cb->nd_msg_queue_list.empty()) {
     queue_elem = cb->nd_msg_queue_list.front();
     cb->nd_msg_queue_list.pop();
@@ -278,9 +298,73 @@ uint32_t avd_d2n_msg_snd(AVD_CL_CB *cb, AVD_AVND *nd_node,
 
   avd_d2n_msg_enqueue(cb, &snd_mds);
 
+  /* Only the last message queued for the node may take further
+   * operations, the messages must reach the node in the order sent. */
+  if (snd_msg->msg_type == AVSV_D2N_INFO_SU_SI_ASSIGN_MSG) {
+    AVD_SUSI_MSG_BATCH &batch = susi_msg_batches[nd_node->node_info.nodeId];
+    batch.msg = snd_msg;
+    batch.tail = &snd_msg->msg_info.d2n_su_si_assign.next;
+    batch.num_ops = 1;
+  } else {
+    susi_msg_batches.erase(nd_node->node_info.nodeId);
+  }
+
   return NCSCC_RC_SUCCESS;
 }
 
+/****************************************************************************
+  Name          : avd_d2n_susi_msg_batch
+
+  Description   : This routine adds the SU SI operation of a SU SI assign
+                  message to the SU SI assign message last queued for the
+                  node, if that is the last message queued for the node and
+                  the node director supports it. The operations are then
+                  sent with one message, under its message id, and are
+                  processed by the node director in the order added.
+
+  Arguments     : cb       :  The control block of AvD
+                  nd_node  :  Node director node to which the message is sent
+                  susi_msg :  The SU SI assign message, with no message id
+                              set.
+
+  Return Values : true if the operation was added, susi_msg is then freed.
+                  false if susi_msg is to be sent as a message of its own.
+
+  Notes         : None.
+******************************************************************************/
+bool avd_d2n_susi_msg_batch(AVD_CL_CB *cb, AVD_AVND *nd_node,
+                            AVD_DND_MSG *susi_msg) {
+  auto batch = susi_msg_batches.find(nd_node->node_info.nodeId);
+  if (batch == susi_msg_batches.end() ||
+      batch->second.num_ops >= AVD_SUSI_MSG_BATCH_MAX)
+    return false;
+
+  auto ver = nds_mds_ver_db.find(nd_node->node_info.nodeId);
+  if (ver == nds_mds_ver_db.end() || ver->second < AVSV_AVD_AVND_MSG_FMT_VER_8)
+    return false;
+
+  AVSV_D2N_INFO_SU_SI_ASSIGN_MSG_INFO *op =
+      new AVSV_D2N_INFO_SU_SI_ASSIGN_MSG_INFO();
+  *op = susi_msg->msg_info.d2n_su_si_assign;
+  op->msg_id = batch->second.msg->msg_info.d2n_su_si_assign.msg_id;
+  op->next = nullptr;
+  *batch->second.tail = op;
+  batch->second.tail = &op->next;
+  batch->second.num_ops++;
+
+  /* the contents are now owned by the queued message */
+  delete susi_msg;
+
+  AMF_FOTRACE(AMF_FOTRACE_D_SEND, "corr=%x:%u su=%s si=%s act=%u ha=%u",
+              nd_node->node_info.nodeId, op->msg_id,
+              amf_fotrace_name(&op->su_name), amf_fotrace_name(&op->si_name),
+              op->msg_act, op->ha_state);
+
+  TRACE("Added to msg %u to %x, %u operations", op->msg_id,
+        nd_node->node_info.nodeId, batch->second.num_ops);
+  return true;
+}
+
 /****************************************************************************
   Name          : avd_d2n_msg_bcast
 
@@ -37,6 +37,7 @@
 #include "amf/amfd/amfd.h"
 #include "amf/amfd/imm.h"
 #include "amf/amfd/cluster.h"
+#include "amf/common/amf_fotrace.h"
 
 /**
  * This function does a sanity check w.r.t the message received and returns the
@@ -1217,6 +1218,8 @@ done:
  */
 void avd_node_failover(AVD_AVND *node) {
   TRACE_ENTER2("'%s'", node->name.c_str());
+  AMF_FOTRACE(AMF_FOTRACE_D_DETECT, "node=%x name=%s", node->node_info.nodeId,
+              node->name.c_str());
   avd_node_mark_absent(node);
   avd_pg_node_csi_del_all(avd_cb, node);
   avd_node_down_mw_susi_failover(avd_cb, node);
@@ -31,6 +31,7 @@
 #include "amf/amfd/proc.h"
 #include "amf/amfd/si_dep.h"
 #include "amf/amfd/csi.h"
+#include "amf/amfd/imm_cache.h"
 #include <algorithm>
 
 AmfDb<std::string, AVD_SG> *sg_db = nullptr;
@@ -426,6 +427,26 @@ static AVD_SG *sg_create(const std::string &sg_name,
   return sg;
 }
 
+SaImmAttrNameT sg_config_attributes[] = {
+    const_cast<SaImmAttrNameT>("saAmfSGType"),
+    const_cast<SaImmAttrNameT>("saAmfSGSuHostNodeGroup"),
+    const_cast<SaImmAttrNameT>("saAmfSGAutoRepair"),
+    const_cast<SaImmAttrNameT>("saAmfSGAutoAdjust"),
+    const_cast<SaImmAttrNameT>("saAmfSGNumPrefActiveSUs"),
+    const_cast<SaImmAttrNameT>("saAmfSGNumPrefStandbySUs"),
+    const_cast<SaImmAttrNameT>("saAmfSGNumPrefInserviceSUs"),
+    const_cast<SaImmAttrNameT>("saAmfSGNumPrefAssignedSUs"),
+    const_cast<SaImmAttrNameT>("saAmfSGMaxActiveSIsperSU"),
+    const_cast<SaImmAttrNameT>("saAmfSGMaxStandbySIsperSU"),
+    const_cast<SaImmAttrNameT>("saAmfSGAutoAdjustProb"),
+    const_cast<SaImmAttrNameT>("saAmfSGCompRestartProb"),
+    const_cast<SaImmAttrNameT>("saAmfSGCompRestartMax"),
+    const_cast<SaImmAttrNameT>("saAmfSGSuRestartProb"),
+    const_cast<SaImmAttrNameT>("saAmfSGSuRestartMax"),
+    const_cast<SaImmAttrNameT>("saAmfSGAdminState"),
+    const_cast<SaImmAttrNameT>("osafAmfSGFsmState"),
+    nullptr};
+
 /**
  * Get configuration for all AMF SG objects from IMM and
  * create AVD internal objects.
@@ -436,51 +457,21 @@ static AVD_SG *sg_create(const std::string &sg_name,
 SaAisErrorT avd_sg_config_get(const std::string &app_dn, AVD_APP *app) {
   AVD_SG *sg;
   SaAisErrorT error, rc;
-  SaImmSearchHandleT searchHandle;
-  SaImmSearchParametersT_2 searchParam;
+  ImmConfigSearch search;
   SaNameT dn;
   const SaImmAttrValuesT_2 **attributes;
   const char *className = "SaAmfSG";
-  SaImmAttrNameT configAttributes[] = {
-      const_cast<SaImmAttrNameT>("saAmfSGType"),
-      const_cast<SaImmAttrNameT>("saAmfSGSuHostNodeGroup"),
-      const_cast<SaImmAttrNameT>("saAmfSGAutoRepair"),
-      const_cast<SaImmAttrNameT>("saAmfSGAutoAdjust"),
-      const_cast<SaImmAttrNameT>("saAmfSGNumPrefActiveSUs"),
-      const_cast<SaImmAttrNameT>("saAmfSGNumPrefStandbySUs"),
-      const_cast<SaImmAttrNameT>("saAmfSGNumPrefInserviceSUs"),
-      const_cast<SaImmAttrNameT>("saAmfSGNumPrefAssignedSUs"),
-      const_cast<SaImmAttrNameT>("saAmfSGMaxActiveSIsperSU"),
-      const_cast<SaImmAttrNameT>("saAmfSGMaxStandbySIsperSU"),
-      const_cast<SaImmAttrNameT>("saAmfSGAutoAdjustProb"),
-      const_cast<SaImmAttrNameT>("saAmfSGCompRestartProb"),
-      const_cast<SaImmAttrNameT>("saAmfSGCompRestartMax"),
-      const_cast<SaImmAttrNameT>("saAmfSGSuRestartProb"),
-      const_cast<SaImmAttrNameT>("saAmfSGSuRestartMax"),
-      const_cast<SaImmAttrNameT>("saAmfSGAdminState"),
-      const_cast<SaImmAttrNameT>("osafAmfSGFsmState"),
-      nullptr};
 
   TRACE_ENTER();
 
-  searchParam.searchOneAttr.attrName =
-      const_cast<SaImmAttrNameT>("SaImmAttrClassName");
-  searchParam.searchOneAttr.attrValueType = SA_IMM_ATTR_SASTRINGT;
-  searchParam.searchOneAttr.attrValue = &className;
-
-  error = immutil_saImmOmSearchInitialize_o2(
-      avd_cb->immOmHandle, app_dn.c_str(), SA_IMM_SUBTREE,
-      SA_IMM_SEARCH_ONE_ATTR | SA_IMM_SEARCH_GET_SOME_ATTR, &searchParam,
-      configAttributes, &searchHandle);
+  error = search.initialize(app_dn, className, sg_config_attributes);
 
   if (SA_AIS_OK != error) {
     LOG_ER("%s: saImmOmSearchInitialize_2 failed: %u", __FUNCTION__, error);
     goto done1;
   }
 
-  while ((rc = immutil_saImmOmSearchNext_2(
-              searchHandle, &dn, (SaImmAttrValuesT_2 ***)&attributes)) ==
-         SA_AIS_OK) {
+  while ((rc = search.next(&dn, &attributes)) == SA_AIS_OK) {
     if (!is_config_valid(Amf::to_string(&dn), attributes, nullptr)) {
       error = SA_AIS_ERR_FAILED_OPERATION;
       goto done2;
@@ -503,7 +494,7 @@ SaAisErrorT avd_sg_config_get(const std::string &app_dn, AVD_APP *app) {
   error = SA_AIS_OK;
 
 done2:
-  (void)immutil_saImmOmSearchFinalize(searchHandle);
+  search.finalize();
 done1:
   TRACE_LEAVE2("%u", error);
   return error;
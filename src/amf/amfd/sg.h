@@ -624,6 +624,7 @@ extern void avd_sg_delete(AVD_SG *sg);
 extern void avd_sg_db_add(AVD_SG *sg);
 extern void avd_sg_db_remove(AVD_SG *sg);
 extern SaAisErrorT avd_sg_config_get(const std::string &app_dn, AVD_APP *app);
+extern SaImmAttrNameT sg_config_attributes[];
 extern void avd_sg_add_su(AVD_SU *su);
 extern void avd_sg_remove_su(AVD_SU *su);
 extern void avd_sg_constructor(void);
@@ -1330,13 +1330,12 @@ uint32_t avd_sg_nway_si_assign(AVD_CL_CB *cb, AVD_SG *sg) {
 
     /* we've an unassigned si.. find su for active assignment */
     /* first, scan based on su rank for this si */
-    for (const auto &value : *sirankedsu_db) {
-      AVD_SUS_PER_SI_RANK *su_rank_rec = value.second;
+    for (auto it =
+             sirankedsu_db->lower_bound(std::make_pair(curr_si->name, 0u));
+         it != sirankedsu_db->cend() && it->first.first == curr_si->name;
+         ++it) {
+      AVD_SUS_PER_SI_RANK *su_rank_rec = it->second;
       {
-        if (su_rank_rec->indx.si_name.compare(curr_si->name) != 0) {
-          continue;
-        }
-
         /* get the su & si */
         curr_su = su_db->find(su_rank_rec->su_name);
         AVD_SI *si = avd_si_get(su_rank_rec->indx.si_name);
@@ -1454,11 +1453,12 @@ uint32_t avd_sg_nway_si_assign(AVD_CL_CB *cb, AVD_SG *sg) {
     /* we've a not-so-fully-assigned si.. find sus for standby assignment */
 
     /* first, scan based on su rank for this si */
-    for (const auto &value : *sirankedsu_db) {
-      AVD_SUS_PER_SI_RANK *su_rank_rec = value.second;
+    for (auto it =
+             sirankedsu_db->lower_bound(std::make_pair(curr_si->name, 0u));
+         it != sirankedsu_db->cend() && it->first.first == curr_si->name;
+         ++it) {
+      AVD_SUS_PER_SI_RANK *su_rank_rec = it->second;
       {
-        if (su_rank_rec->indx.si_name.compare(curr_si->name) != 0) continue;
-
         /* get the su & si */
         curr_su = su_db->find(su_rank_rec->su_name);
         AVD_SI *si = avd_si_get(su_rank_rec->indx.si_name);
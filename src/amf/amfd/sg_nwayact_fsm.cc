@@ -89,11 +89,10 @@ AVD_SU *avd_sg_nacvred_su_chose_asgn(AVD_CL_CB *cb, AVD_SG *sg) {
     /* identify a in-service SU which is not assigned to this SI and can
      * take more assignments so that the SI can be assigned.
      */
-    for (const auto &value : *sirankedsu_db) {
-      AVD_SUS_PER_SI_RANK *su_rank_rec = value.second;
+    for (auto it = sirankedsu_db->lower_bound(std::make_pair(i_si->name, 0u));
+         it != sirankedsu_db->cend() && it->first.first == i_si->name; ++it) {
+      AVD_SUS_PER_SI_RANK *su_rank_rec = it->second;
       {
-        if (su_rank_rec->indx.si_name.compare(i_si->name) != 0) continue;
-
         /* get the su & si */
         i_su = su_db->find(su_rank_rec->su_name);
         AVD_SI *si = avd_si_get(su_rank_rec->indx.si_name);
@@ -40,6 +40,7 @@
 #include "amf/amfd/clm.h"
 #include "amf/amfd/si_dep.h"
 #include "amf/amfd/cluster.h"
+#include "amf/common/amf_fotrace.h"
 
 /**
  * @brief       While creating compcsi relationship in SUSI, AMF may assign
@@ -1170,6 +1171,16 @@ void avd_su_si_assign_evh(AVD_CL_CB *cb, AVD_EVT *evt) {
       n2d_msg->msg_info.n2d_su_si_assign.error,
       n2d_msg->msg_info.n2d_su_si_assign.single_csi);
 
+  AMF_FOTRACE(
+      AMF_FOTRACE_D_RSP, "rsp=%x:%u su=%s si=%s act=%u ha=%u err=%u",
+      n2d_msg->msg_info.n2d_su_si_assign.node_id,
+      n2d_msg->msg_info.n2d_su_si_assign.msg_id,
+      amf_fotrace_name(&n2d_msg->msg_info.n2d_su_si_assign.su_name),
+      amf_fotrace_name(&n2d_msg->msg_info.n2d_su_si_assign.si_name),
+      n2d_msg->msg_info.n2d_su_si_assign.msg_act,
+      n2d_msg->msg_info.n2d_su_si_assign.ha_state,
+      n2d_msg->msg_info.n2d_su_si_assign.error);
+
   if ((node = avd_msg_sanity_chk(
            evt, n2d_msg->msg_info.n2d_su_si_assign.node_id,
            AVSV_N2D_INFO_SU_SI_ASSIGN_MSG,
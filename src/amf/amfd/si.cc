@@ -26,6 +26,7 @@
 #include "amf/amfd/csi.h"
 #include "amf/amfd/proc.h"
 #include "amf/amfd/si_dep.h"
+#include "amf/amfd/imm_cache.h"
 
 AmfDb<std::string, AVD_SI> *si_db = nullptr;
 
@@ -646,6 +647,18 @@ done:
   return si;
 }
 
+SaImmAttrNameT si_config_attributes[] = {
+    const_cast<SaImmAttrNameT>("saAmfSvcType"),
+    const_cast<SaImmAttrNameT>("saAmfSIProtectedbySG"),
+    const_cast<SaImmAttrNameT>("saAmfSIRank"),
+    const_cast<SaImmAttrNameT>("saAmfSIActiveWeight"),
+    const_cast<SaImmAttrNameT>("saAmfSIStandbyWeight"),
+    const_cast<SaImmAttrNameT>("saAmfSIPrefActiveAssignments"),
+    const_cast<SaImmAttrNameT>("saAmfSIPrefStandbyAssignments"),
+    const_cast<SaImmAttrNameT>("saAmfSIAdminState"),
+    const_cast<SaImmAttrNameT>("saAmfUnassignedAlarmStatus"),
+    nullptr};
+
 /**
  * Get configuration for all AMF SI objects from IMM and create
  * AVD internal objects.
@@ -657,42 +670,21 @@ done:
  */
 SaAisErrorT avd_si_config_get(AVD_APP *app) {
   SaAisErrorT error = SA_AIS_ERR_FAILED_OPERATION, rc;
-  SaImmSearchHandleT searchHandle;
-  SaImmSearchParametersT_2 searchParam;
+  ImmConfigSearch search;
   SaNameT si_name;
   const SaImmAttrValuesT_2 **attributes;
   const char *className = "SaAmfSI";
   AVD_SI *si;
-  SaImmAttrNameT configAttributes[] = {
-      const_cast<SaImmAttrNameT>("saAmfSvcType"),
-      const_cast<SaImmAttrNameT>("saAmfSIProtectedbySG"),
-      const_cast<SaImmAttrNameT>("saAmfSIRank"),
-      const_cast<SaImmAttrNameT>("saAmfSIActiveWeight"),
-      const_cast<SaImmAttrNameT>("saAmfSIStandbyWeight"),
-      const_cast<SaImmAttrNameT>("saAmfSIPrefActiveAssignments"),
-      const_cast<SaImmAttrNameT>("saAmfSIPrefStandbyAssignments"),
-      const_cast<SaImmAttrNameT>("saAmfSIAdminState"),
-      const_cast<SaImmAttrNameT>("saAmfUnassignedAlarmStatus"),
-      nullptr};
 
   TRACE_ENTER();
 
-  searchParam.searchOneAttr.attrName =
-      const_cast<SaImmAttrNameT>("SaImmAttrClassName");
-  searchParam.searchOneAttr.attrValueType = SA_IMM_ATTR_SASTRINGT;
-  searchParam.searchOneAttr.attrValue = &className;
-
-  if ((rc = immutil_saImmOmSearchInitialize_o2(
-           avd_cb->immOmHandle, app->name.c_str(), SA_IMM_SUBTREE,
-           SA_IMM_SEARCH_ONE_ATTR | SA_IMM_SEARCH_GET_SOME_ATTR, &searchParam,
-           configAttributes, &searchHandle)) != SA_AIS_OK) {
+  if ((rc = search.initialize(app->name, className, si_config_attributes)) !=
+      SA_AIS_OK) {
     LOG_ER("%s: saImmOmSearchInitialize_2 failed: %u", __FUNCTION__, rc);
     goto done1;
   }
 
-  while ((rc = immutil_saImmOmSearchNext_2(
-              searchHandle, &si_name, (SaImmAttrValuesT_2 ***)&attributes)) ==
-         SA_AIS_OK) {
+  while ((rc = search.next(&si_name, &attributes)) == SA_AIS_OK) {
     const std::string si_str(Amf::to_string(&si_name));
     if (!is_config_valid(si_str, attributes, nullptr)) goto done2;
 
@@ -709,7 +701,7 @@ SaAisErrorT avd_si_config_get(AVD_APP *app) {
   error = SA_AIS_OK;
 
 done2:
-  (void)immutil_saImmOmSearchFinalize(searchHandle);
+  search.finalize();
 done1:
   TRACE_LEAVE2("%u", error);
   return error;
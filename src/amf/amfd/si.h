@@ -167,6 +167,7 @@ extern void avd_si_delete(AVD_SI *si);
 extern void avd_si_db_add(AVD_SI *si);
 extern AVD_SI *avd_si_get(const std::string &si_name);
 extern SaAisErrorT avd_si_config_get(AVD_APP *app);
+extern SaImmAttrNameT si_config_attributes[];
 extern void avd_si_constructor(void);
 
 #endif  // AMF_AMFD_SI_H_
@@ -433,7 +433,6 @@ AVD_SU_SI_REL *avd_susi_create(AVD_CL_CB *cb, AVD_SI *si, AVD_SU *su,
                                AVSV_SUSI_ACT default_act,
                                AVD_SU_SI_STATE default_fsm) {
   AVD_SU_SI_REL *su_si, *p_su_si, *i_su_si;
-  AVD_SU *curr_su = 0;
   AVD_SUS_PER_SI_RANK *su_rank_rec = 0, *i_su_rank_rec = 0;
   uint32_t rank1, rank2;
 
@@ -454,15 +453,10 @@ AVD_SU_SI_REL *avd_susi_create(AVD_CL_CB *cb, AVD_SI *si, AVD_SU *su,
    */
 
   /* determine if the su is ranked per si */
-  for (const auto &value : *sirankedsu_db) {
-    su_rank_rec = value.second;
-    if (su_rank_rec->indx.si_name.compare(si->name) != 0) continue;
-    curr_su = su_db->find(su_rank_rec->su_name);
-    if (curr_su == su) break;
-  }
+  su_rank_rec = avd_sirankedsu_find_su(si->name, su->name);
 
   /* set the ranking flag */
-  su_si->is_per_si = (curr_su == su) ? true : false;
+  su_si->is_per_si = (su_rank_rec != nullptr) ? true : false;
 
   /* determine the insert position */
   for (p_su_si = nullptr, i_su_si = si->list_of_sisu; i_su_si;
@@ -470,15 +464,10 @@ AVD_SU_SI_REL *avd_susi_create(AVD_CL_CB *cb, AVD_SI *si, AVD_SU *su,
     if (i_su_si->is_per_si == true) {
       if (false == su_si->is_per_si) continue;
 
-      /* determine the su_rank rec for this rec */
-      for (const auto &value : *sirankedsu_db) {
-        i_su_rank_rec = value.second;
-        if (i_su_rank_rec->indx.si_name.compare(si->name) != 0) continue;
-        curr_su = su_db->find(i_su_rank_rec->su_name);
-        if (curr_su == i_su_si->su) break;
-      }
-
-      osafassert(i_su_rank_rec);
+      /* determine the su_rank rec for this rec, it can have been removed
+       * since the rec was added */
+      i_su_rank_rec = avd_sirankedsu_find_su(si->name, i_su_si->su->name);
+      if (i_su_rank_rec == nullptr) continue;
 
       rank1 = su_rank_rec->indx.su_rank;
       rank2 = i_su_rank_rec->indx.su_rank;
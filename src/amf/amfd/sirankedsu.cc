@@ -34,6 +34,7 @@
 #include "osaf/immutil/immutil.h"
 #include "amf/amfd/imm.h"
 #include "amf/amfd/csi.h"
+#include "amf/amfd/imm_cache.h"
 #include "base/logtrace.h"
 #include <algorithm>
 #include <string>
@@ -117,6 +118,29 @@ static AVD_SUS_PER_SI_RANK *avd_sirankedsu_find(
   return ranked_su_per_si;
 }
 
+/*****************************************************************************
+ * Function: avd_sirankedsu_find_su
+ *
+ * Purpose:  This function will find the AVD_SUS_PER_SI_RANK structure of an
+ * SU in the ranked SUs of an SI. Only the entries of the SI are walked.
+ *
+ * Input: si_name - name of the SI
+ *        su_name - name of the SU
+ *
+ * Returns: The pointer to AVD_SUS_PER_SI_RANK structure, nullptr if the SU
+ * is not ranked for the SI.
+ *
+ **************************************************************************/
+
+AVD_SUS_PER_SI_RANK *avd_sirankedsu_find_su(const std::string &si_name,
+                                            const std::string &su_name) {
+  for (auto it = sirankedsu_db->lower_bound(std::make_pair(si_name, 0u));
+       it != sirankedsu_db->cend() && it->first.first == si_name; ++it) {
+    if (it->second->su_name == su_name) return it->second;
+  }
+  return nullptr;
+}
+
 /*****************************************************************************
  * Function: avd_sirankedsu_delete
  *
@@ -437,8 +461,7 @@ static SaAisErrorT sirankedsu_ccb_completed_cb(CcbUtilOperationData_t *opdata) {
 
 SaAisErrorT avd_sirankedsu_config_get(const std::string &si_name, AVD_SI *si) {
   SaAisErrorT error = SA_AIS_ERR_FAILED_OPERATION;
-  SaImmSearchHandleT searchHandle;
-  SaImmSearchParametersT_2 searchParam;
+  ImmConfigSearch search;
   const SaImmAttrValuesT_2 **attributes;
   const char *className = "SaAmfSIRankedSU";
   AVD_SUS_PER_SI_RANK_INDX indx;
@@ -447,22 +470,12 @@ SaAisErrorT avd_sirankedsu_config_get(const std::string &si_name, AVD_SI *si) {
 
   TRACE_ENTER();
 
-  searchParam.searchOneAttr.attrName =
-      const_cast<SaImmAttrNameT>("SaImmAttrClassName");
-  searchParam.searchOneAttr.attrValueType = SA_IMM_ATTR_SASTRINGT;
-  searchParam.searchOneAttr.attrValue = &className;
-
-  if (immutil_saImmOmSearchInitialize_o2(
-          avd_cb->immOmHandle, si_name.c_str(), SA_IMM_SUBTREE,
-          SA_IMM_SEARCH_ONE_ATTR | SA_IMM_SEARCH_GET_ALL_ATTR, &searchParam,
-          nullptr, &searchHandle) != SA_AIS_OK) {
+  if (search.initialize(si_name, className, nullptr) != SA_AIS_OK) {
     LOG_ER("No objects found (1)");
     goto done1;
   }
 
-  while (immutil_saImmOmSearchNext_2(searchHandle, &dn,
-                                     (SaImmAttrValuesT_2 ***)&attributes) ==
-         SA_AIS_OK) {
+  while (search.next(&dn, &attributes) == SA_AIS_OK) {
     LOG_NO("'%s'", osaf_extended_name_borrow(&dn));
 
     indx.si_name = si_name;
@@ -486,7 +499,7 @@ SaAisErrorT avd_sirankedsu_config_get(const std::string &si_name, AVD_SI *si) {
   error = SA_AIS_OK;
 
 done2:
-  (void)immutil_saImmOmSearchFinalize(searchHandle);
+  search.finalize();
 done1:
   TRACE_LEAVE2("%u", error);
   return error;
@@ -30,6 +30,7 @@
 #include "amf/amfd/proc.h"
 #include "amf/amfd/csi.h"
 #include "amf/amfd/cluster.h"
+#include "amf/amfd/imm_cache.h"
 #include "config.h"
 #include <algorithm>
 
@@ -692,45 +693,35 @@ done:
   TRACE_LEAVE();
 }
 
+SaImmAttrNameT su_config_attributes[] = {
+    const_cast<SaImmAttrNameT>("saAmfSUType"),
+    const_cast<SaImmAttrNameT>("saAmfSURank"),
+    const_cast<SaImmAttrNameT>("saAmfSUHostedByNode"),
+    const_cast<SaImmAttrNameT>("saAmfSUHostNodeOrNodeGroup"),
+    const_cast<SaImmAttrNameT>("saAmfSUFailover"),
+    const_cast<SaImmAttrNameT>("saAmfSUMaintenanceCampaign"),
+    const_cast<SaImmAttrNameT>("saAmfSUAdminState"),
+    nullptr};
+
 SaAisErrorT avd_su_config_get(const std::string &sg_name, AVD_SG *sg) {
   SaAisErrorT error, rc;
-  SaImmSearchHandleT searchHandle;
-  SaImmSearchParametersT_2 searchParam;
+  ImmConfigSearch search;
   SaNameT tmp_su_name;
   std::string su_name;
   const SaImmAttrValuesT_2 **attributes;
   const char *className = "SaAmfSU";
   AVD_SU *su;
-  SaImmAttrNameT configAttributes[] = {
-      const_cast<SaImmAttrNameT>("saAmfSUType"),
-      const_cast<SaImmAttrNameT>("saAmfSURank"),
-      const_cast<SaImmAttrNameT>("saAmfSUHostedByNode"),
-      const_cast<SaImmAttrNameT>("saAmfSUHostNodeOrNodeGroup"),
-      const_cast<SaImmAttrNameT>("saAmfSUFailover"),
-      const_cast<SaImmAttrNameT>("saAmfSUMaintenanceCampaign"),
-      const_cast<SaImmAttrNameT>("saAmfSUAdminState"),
-      nullptr};
 
   TRACE_ENTER();
 
-  searchParam.searchOneAttr.attrName =
-      const_cast<SaImmAttrNameT>("SaImmAttrClassName");
-  searchParam.searchOneAttr.attrValueType = SA_IMM_ATTR_SASTRINGT;
-  searchParam.searchOneAttr.attrValue = &className;
-
-  error = immutil_saImmOmSearchInitialize_o2(
-      avd_cb->immOmHandle, sg_name.c_str(), SA_IMM_SUBTREE,
-      SA_IMM_SEARCH_ONE_ATTR | SA_IMM_SEARCH_GET_SOME_ATTR, &searchParam,
-      configAttributes, &searchHandle);
+  error = search.initialize(sg_name, className, su_config_attributes);
 
   if (SA_AIS_OK != error) {
     LOG_ER("%s: saImmOmSearchInitialize_2 failed: %u", __FUNCTION__, error);
     goto done1;
   }
 
-  while ((rc = immutil_saImmOmSearchNext_2(
-              searchHandle, &tmp_su_name,
-              (SaImmAttrValuesT_2 ***)&attributes)) == SA_AIS_OK) {
+  while ((rc = search.next(&tmp_su_name, &attributes)) == SA_AIS_OK) {
     su_name = Amf::to_string(&tmp_su_name);
     if (!is_config_valid(su_name, attributes, nullptr)) {
       error = SA_AIS_ERR_FAILED_OPERATION;
@@ -754,7 +745,7 @@ SaAisErrorT avd_su_config_get(const std::string &sg_name, AVD_SG *sg) {
   error = SA_AIS_OK;
 
 done2:
-  (void)immutil_saImmOmSearchFinalize(searchHandle);
+  search.finalize();
 done1:
   TRACE_LEAVE2("%u", error);
   return error;
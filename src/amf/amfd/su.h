@@ -176,6 +176,7 @@ extern AmfDb<std::string, AVD_SU> *su_db;
  * @return SaAisErrorT
  */
 extern SaAisErrorT avd_su_config_get(const std::string &sg_name, AVD_SG *sg);
+extern SaImmAttrNameT su_config_attributes[];
 
 /**
  * Class constructor, must be called before any other function
@@ -155,6 +155,8 @@ uint32_t avd_susi_delete(AVD_CL_CB *cb, AVD_SU_SI_REL *susi, bool ckpt);
 extern SaAisErrorT avd_sirankedsu_config_get(const std::string &si_name,
                                              AVD_SI *si);
 extern void avd_sirankedsu_constructor(void);
+extern AVD_SUS_PER_SI_RANK *avd_sirankedsu_find_su(const std::string &si_name,
+                                                   const std::string &su_name);
 extern void avd_susi_ha_state_set(AVD_SU_SI_REL *susi, SaAmfHAStateT ha_state);
 uint32_t avd_gen_su_ha_state_changed_ntf(AVD_CL_CB *avd_cb,
                                          struct avd_su_si_rel_tag *susi);
@@ -22,6 +22,7 @@
 #include "amf/amfd/util.h"
 #include "amf/amfd/sutcomptype.h"
 #include "amf/amfd/imm.h"
+#include "amf/amfd/imm_cache.h"
 
 AmfDb<std::string, AVD_SUTCOMP_TYPE> *sutcomptype_db = nullptr;
 
@@ -70,32 +71,21 @@ SaAisErrorT avd_sutcomptype_config_get(const std::string &sutype_name,
                                        AVD_SUTYPE *sut) {
   AVD_SUTCOMP_TYPE *sutcomptype;
   SaAisErrorT error;
-  SaImmSearchHandleT searchHandle;
-  SaImmSearchParametersT_2 searchParam;
+  ImmConfigSearch search;
   SaNameT dn;
   const SaImmAttrValuesT_2 **attributes;
   const char *className = "SaAmfSutCompType";
 
   TRACE_ENTER();
 
-  searchParam.searchOneAttr.attrName =
-      const_cast<SaImmAttrNameT>("SaImmAttrClassName");
-  searchParam.searchOneAttr.attrValueType = SA_IMM_ATTR_SASTRINGT;
-  searchParam.searchOneAttr.attrValue = &className;
-
-  error = immutil_saImmOmSearchInitialize_o2(
-      avd_cb->immOmHandle, sutype_name.c_str(), SA_IMM_SUBTREE,
-      SA_IMM_SEARCH_ONE_ATTR | SA_IMM_SEARCH_GET_ALL_ATTR, &searchParam,
-      nullptr, &searchHandle);
+  error = search.initialize(sutype_name, className, nullptr);
 
   if (SA_AIS_OK != error) {
     LOG_ER("saImmOmSearchInitialize_2 failed: %u", error);
     goto done1;
   }
 
-  while (immutil_saImmOmSearchNext_2(searchHandle, &dn,
-                                     (SaImmAttrValuesT_2 ***)&attributes) ==
-         SA_AIS_OK) {
+  while (search.next(&dn, &attributes) == SA_AIS_OK) {
     if (!is_config_valid(Amf::to_string(&dn), attributes, nullptr)) goto done2;
     if ((sutcomptype = sutcomptype_db->find(Amf::to_string(&dn))) == nullptr) {
       if ((sutcomptype = sutcomptype_create(Amf::to_string(&dn), attributes)) ==
@@ -111,7 +101,7 @@ SaAisErrorT avd_sutcomptype_config_get(const std::string &sutype_name,
   error = SA_AIS_OK;
 
 done2:
-  (void)immutil_saImmOmSearchFinalize(searchHandle);
+  search.finalize();
 done1:
   TRACE_LEAVE2("%u", error);
   return error;
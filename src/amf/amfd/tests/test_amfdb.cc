@@ -16,6 +16,12 @@
  */
 
 #include "gtest/gtest.h"
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "amf/amfd/cb.h"
+#include "amf/amfd/susi.h"
 #include "amf/common/amf_db_template.h"
 
 class TEST_APP {};
@@ -42,3 +48,226 @@ TEST_F(AmfDbTest, InsertWorks) {
   rc = db_.insert(str, app);
   EXPECT_EQ(1U, rc);
 }
+
+TEST_F(AmfDbTest, LowerBoundWalksKeyPrefix) {
+  AmfDb<std::pair<std::string, uint32_t>, TEST_APP> db;
+  TEST_APP app1, app2, app3, app4;
+  db.insert(std::make_pair(std::string("si1"), 2u), &app2);
+  db.insert(std::make_pair(std::string("si1"), 1u), &app1);
+  db.insert(std::make_pair(std::string("si0"), 1u), &app3);
+  db.insert(std::make_pair(std::string("si2"), 0u), &app4);
+
+  std::vector<TEST_APP *> found;
+  for (auto it = db.lower_bound(std::make_pair(std::string("si1"), 0u));
+       it != db.cend() && it->first.first == "si1"; ++it)
+    found.push_back(it->second);
+  ASSERT_EQ(2U, found.size());
+  EXPECT_EQ(&app1, found[0]);
+  EXPECT_EQ(&app2, found[1]);
+}
+
+TEST(AmfHashDbTest, InsertFindErase) {
+  AmfHashDb<std::string, TEST_APP> db;
+  TEST_APP *app1 = new TEST_APP;
+  TEST_APP *app2 = new TEST_APP;
+
+  EXPECT_EQ(db.begin(), db.end());
+  EXPECT_EQ(1U, db.insert("app1", app1));
+  EXPECT_EQ(1U, db.insert("app2", app2));
+  EXPECT_EQ(2U, db.insert("app1", app2));
+  EXPECT_EQ(2U, db.size());
+  EXPECT_EQ(app1, db.find("app1"));
+  EXPECT_EQ(app2, db.find("app2"));
+  EXPECT_TRUE(db.find("app3") == nullptr);
+
+  db.erase("app1");
+  EXPECT_TRUE(db.find("app1") == nullptr);
+  EXPECT_EQ(1U, db.size());
+  delete app1;
+
+  db.deleteAll();
+  EXPECT_EQ(0U, db.size());
+}
+
+// The ranked SU walks of the N-Way FSMs and avd_susi_create(), and the
+// component and CSI lookups, on a model of 500 SGs of 8 SUs and 4 SIs, each
+// SI ranking the SUs of its SG. The walks are compared with the scan of the
+// whole sirankedsu_db that they replaced. Run with
+//   bin/testamfd --gtest_also_run_disabled_tests --gtest_filter='*Bench*'
+class AmfDbBench : public ::testing::Test {
+ protected:
+  static constexpr int kSgs = 500;
+  static constexpr int kSusPerSg = 8;
+  static constexpr int kSisPerSg = 4;
+  static constexpr int kCompsPerSu = 4;
+  static constexpr int kCsisPerSi = 2;
+
+  typedef AmfDb<std::pair<std::string, uint32_t>, AVD_SUS_PER_SI_RANK>
+      SiRankedSuDb;
+
+  void SetUp() override {
+    saved_su_db_ = su_db;
+    saved_sirankedsu_db_ = sirankedsu_db;
+    su_db = new AmfDb<std::string, AVD_SU>;
+    sirankedsu_db = new SiRankedSuDb;
+
+    char name[128];
+    for (int sg = 0; sg < kSgs; sg++) {
+      for (int su = 0; su < kSusPerSg; su++) {
+        snprintf(name, sizeof(name), "safSu=SU%d,safSg=SG%d,safApp=App1",
+                 su, sg);
+        su_names_.push_back(name);
+        su_db->insert(name, new AVD_SU(name));
+        for (int comp = 0; comp < kCompsPerSu; comp++) {
+          snprintf(name, sizeof(name),
+                   "safComp=Comp%d,safSu=SU%d,safSg=SG%d,safApp=App1", comp,
+                   su, sg);
+          comp_names_.push_back(name);
+        }
+      }
+      for (int si = 0; si < kSisPerSg; si++) {
+        snprintf(name, sizeof(name), "safSi=SI%d_%d,safApp=App1", sg, si);
+        si_names_.push_back(name);
+        for (int csi = 0; csi < kCsisPerSi; csi++) {
+          snprintf(name, sizeof(name), "safCsi=CSI%d,safSi=SI%d_%d,safApp=App1",
+                   csi, sg, si);
+          csi_names_.push_back(name);
+        }
+        for (int su = 0; su < kSusPerSg; su++) {
+          AVD_SUS_PER_SI_RANK *rec = new AVD_SUS_PER_SI_RANK();
+          rec->indx.si_name = si_names_.back();
+          rec->indx.su_rank = su + 1;
+          rec->su_name = su_names_[sg * kSusPerSg + su];
+          sirankedsu_db->insert(
+              std::make_pair(rec->indx.si_name, rec->indx.su_rank), rec);
+        }
+      }
+    }
+  }
+
+  void TearDown() override {
+    su_db->deleteAll();
+    delete su_db;
+    sirankedsu_db->deleteAll();
+    delete sirankedsu_db;
+    su_db = saved_su_db_;
+    sirankedsu_db = saved_sirankedsu_db_;
+  }
+
+  // The SUs ranked for an SI, as avd_sg_nway_si_assign() walked them
+  static int ScanRankedSus(const std::string &si_name) {
+    int found = 0;
+    for (const auto &value : *sirankedsu_db) {
+      AVD_SUS_PER_SI_RANK *su_rank_rec = value.second;
+      if (su_rank_rec->indx.si_name.compare(si_name) != 0) continue;
+      if (su_db->find(su_rank_rec->su_name) != nullptr) found++;
+    }
+    return found;
+  }
+
+  static int WalkRankedSus(const std::string &si_name) {
+    int found = 0;
+    for (auto it = sirankedsu_db->lower_bound(std::make_pair(si_name, 0u));
+         it != sirankedsu_db->cend() && it->first.first == si_name; ++it) {
+      if (su_db->find(it->second->su_name) != nullptr) found++;
+    }
+    return found;
+  }
+
+  // The rank record of an SU, as avd_susi_create() looked it up
+  static AVD_SUS_PER_SI_RANK *ScanRankOfSu(const std::string &si_name,
+                                           AVD_SU *su) {
+    for (const auto &value : *sirankedsu_db) {
+      AVD_SUS_PER_SI_RANK *su_rank_rec = value.second;
+      if (su_rank_rec->indx.si_name.compare(si_name) != 0) continue;
+      if (su_db->find(su_rank_rec->su_name) == su) return su_rank_rec;
+    }
+    return nullptr;
+  }
+
+  // Finds every name in a database of type Db, as comp_db and csi_db are
+  // looked up by the names in the SU-SI assignments
+  template <template <typename, typename> class Db>
+  static double LookupNs(const std::vector<std::string> &names, int rounds) {
+    Db<std::string, TEST_APP> db;
+    std::vector<TEST_APP> objs(names.size());
+    for (size_t i = 0; i < names.size(); i++) db.insert(names[i], &objs[i]);
+    int found = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int round = 0; round < rounds; round++) {
+      for (const std::string &name : names) {
+        if (db.find(name) != nullptr) found++;
+      }
+    }
+    double ns = Elapsed(start) * 1e3 / (rounds * names.size());
+    EXPECT_EQ(static_cast<size_t>(rounds) * names.size(),
+              static_cast<size_t>(found));
+    return ns;
+  }
+
+  static double Elapsed(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::micro>(
+               std::chrono::steady_clock::now() - start)
+        .count();
+  }
+
+  std::vector<std::string> su_names_;
+  std::vector<std::string> si_names_;
+  std::vector<std::string> comp_names_;
+  std::vector<std::string> csi_names_;
+  AmfDb<std::string, AVD_SU> *saved_su_db_;
+  SiRankedSuDb *saved_sirankedsu_db_;
+};
+
+TEST_F(AmfDbBench, DISABLED_RankedSuWalks) {
+  int scanned = 0, walked = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (const std::string &si_name : si_names_) {
+    scanned += ScanRankedSus(si_name);
+  }
+  double scan_us = Elapsed(start) / si_names_.size();
+  start = std::chrono::steady_clock::now();
+  for (const std::string &si_name : si_names_) {
+    walked += WalkRankedSus(si_name);
+  }
+  double walk_us = Elapsed(start) / si_names_.size();
+  EXPECT_EQ(scanned, walked);
+  EXPECT_EQ(static_cast<int>(si_names_.size()) * kSusPerSg, walked);
+
+  // the lowest ranked SU of each SI is found last
+  std::vector<AVD_SU *> sus;
+  for (size_t i = 0; i < si_names_.size(); i++) {
+    sus.push_back(su_db->find(su_names_[i / kSisPerSg * kSusPerSg +
+                                        kSusPerSg - 1]));
+  }
+  start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < si_names_.size(); i++) {
+    ASSERT_TRUE(ScanRankOfSu(si_names_[i], sus[i]) != nullptr);
+  }
+  double scan_find_us = Elapsed(start) / si_names_.size();
+  start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < si_names_.size(); i++) {
+    ASSERT_TRUE(avd_sirankedsu_find_su(si_names_[i], sus[i]->name) !=
+                nullptr);
+  }
+  double find_us = Elapsed(start) / si_names_.size();
+
+  printf("%zu SUs, %zu SIs, %zu ranked SUs\n", su_names_.size(),
+         si_names_.size(), static_cast<size_t>(sirankedsu_db->size()));
+  printf("ranked SUs of an SI: scan %.2f us, prefix walk %.2f us\n", scan_us,
+         walk_us);
+  printf("rank of an SU: scan %.2f us, avd_sirankedsu_find_su %.2f us\n",
+         scan_find_us, find_us);
+}
+
+TEST_F(AmfDbBench, DISABLED_CompAndCsiLookups) {
+  const int kRounds = 50;
+  printf("%zu components: AmfDb %.0f ns, AmfHashDb %.0f ns per find\n",
+         comp_names_.size(),
+         LookupNs<AmfDb>(comp_names_, kRounds),
+         LookupNs<AmfHashDb>(comp_names_, kRounds));
+  printf("%zu CSIs: AmfDb %.0f ns, AmfHashDb %.0f ns per find\n",
+         csi_names_.size(),
+         LookupNs<AmfDb>(csi_names_, kRounds),
+         LookupNs<AmfHashDb>(csi_names_, kRounds));
+}
@@ -28,6 +28,12 @@ static AVD_CL_CB _control_block;
 // Global reference to the control block
 AVD_CL_CB *avd_cb = &_control_block;
 
+extern "C" const AVSV_ENCODE_CKPT_DATA_FUNC_PTR
+    avd_enc_ckpt_data_func_list[AVSV_CKPT_MSG_MAX];
+
+extern "C" const AVSV_DECODE_CKPT_DATA_FUNC_PTR
+    avd_dec_data_func_list[AVSV_CKPT_MSG_MAX];
+
 // The fixture for testing encode decode for mbcsv
 class CkptEncDecTest : public ::testing::Test {
  protected:
@@ -74,7 +80,7 @@ TEST_F(CkptEncDecTest, testEncDecAvdApp) {
   // retrieve saAmfApplicationCurrNumSGs encoded from the USR buf
   int32_t size = enc.io_uba.ttl;
   char *tmpData = new char[size];
-  char *buf = sysf_data_at_start(enc.io_uba.ub, size, tmpData);
+  char *buf = sysf_data_at_start(enc.io_uba.start, size, tmpData);
   uint32_t offset = sizeof(SaNameT) + sizeof(uint32_t);
   uint32_t *fld = reinterpret_cast<uint32_t *>(&buf[offset]);
 
@@ -89,6 +95,7 @@ TEST_F(CkptEncDecTest, testEncDecAvdApp) {
 
   delete[] tmpData;
 
+  ncs_dec_init_space(&enc.io_uba, enc.io_uba.start);
   decode_app(&enc.io_uba, &app);
 
   ASSERT_EQ(app.name, "AppName");
@@ -122,7 +129,7 @@ TEST_F(CkptEncDecTest, testEncDecAvdComp) {
   // retrieve AVD_COMP encoded data from the USR buf
   int32_t size = enc.io_uba.ttl;
   char *tmpData = new char[size];
-  char *buf = sysf_data_at_start(enc.io_uba.ub, size, tmpData);
+  char *buf = sysf_data_at_start(enc.io_uba.start, size, tmpData);
   uint32_t offset = sizeof(SaNameT);
   uint32_t *fld = reinterpret_cast<uint32_t *>(&buf[offset]);
 
@@ -145,6 +152,7 @@ TEST_F(CkptEncDecTest, testEncDecAvdComp) {
 
   delete[] tmpData;
 
+  ncs_dec_init_space(&enc.io_uba, enc.io_uba.start);
   decode_comp(&enc.io_uba, &comp);
 
   ASSERT_EQ(Amf::to_string(&comp.comp_info.name), "CompName");
@@ -189,6 +197,7 @@ TEST_F(CkptEncDecTest, testEncDecAvdSiAss) {
   enc.i_peer_version = AVD_MBCSV_SUB_PART_VERSION_4;
 
   encode_siass(&enc.io_uba, &susi, enc.i_peer_version);
+  ncs_dec_init_space(&enc.io_uba, enc.io_uba.start);
   decode_siass(&enc.io_uba, &susi_ckpt, enc.i_peer_version);
 
   ASSERT_EQ(Amf::to_string(&susi_ckpt.su_name), su_name);
@@ -223,7 +232,7 @@ TEST_F(CkptEncDecTest, testEncDecAvdCb) {
   int32_t size = enc.io_uba.ttl;
   char *tmpData = new char[size];
 
-  char *buf = sysf_data_at_start(enc.io_uba.ub, size, tmpData);
+  char *buf = sysf_data_at_start(enc.io_uba.start, size, tmpData);
   uint32_t offset = 0;
   uint32_t *fld = reinterpret_cast<uint32_t *>(&buf[offset]);
 
@@ -252,6 +261,7 @@ TEST_F(CkptEncDecTest, testEncDecAvdCb) {
   cb.cluster_init_time = 0x0;
   cb.nodes_exit_cnt = 0x0;
 
+  ncs_dec_init_space(&enc.io_uba, enc.io_uba.start);
   decode_cb(&enc.io_uba, &cb, enc.i_peer_version);
 
   ASSERT_EQ(cb.init_state, AVD_APP_STATE);
@@ -289,6 +299,7 @@ TEST_F(CkptEncDecTest, testEncDecAvdSiTrans) {
   enc.i_peer_version = AVD_MBCSV_SUB_PART_VERSION_4;
 
   encode_si_trans(&enc.io_uba, static_cast<AVD_SG *>(&sg), enc.i_peer_version);
+  ncs_dec_init_space(&enc.io_uba, enc.io_uba.start);
   decode_si_trans(&enc.io_uba, &msg, enc.i_peer_version);
 
   ASSERT_EQ(Amf::to_string(&msg.sg_name), sg_name);
@@ -339,6 +350,7 @@ TEST_F(CkptEncDecTest, testEncDecAvdNodeConfig) {
   enc.i_peer_version = AVD_MBCSV_SUB_PART_VERSION_4;
 
   encode_node_config(&enc.io_uba, &avnd, enc.i_peer_version);
+  ncs_dec_init_space(&enc.io_uba, enc.io_uba.start);
   decode_node_config(&enc.io_uba, &avnd, enc.i_peer_version);
 
   // convert decoded address to string
@@ -363,3 +375,152 @@ TEST_F(CkptEncDecTest, testEncDecAvdNodeConfig) {
   ASSERT_EQ(avnd.rcv_msg_id, static_cast<uint32_t>(0xA));
   ASSERT_EQ(avnd.snd_msg_id, static_cast<uint32_t>(0xB));
 }
+
+TEST_F(CkptEncDecTest, testEncDecAvdBatch) {
+  int rc = 0;
+  AVSV_CKPT_BATCH batch;
+  uint32_t sizes[] = {5, 7};
+
+  // two job queue status updates with an unknown update in between
+  for (uint32_t i = 0; i < 3; i++) {
+    AVSV_CKPT_BATCH_ENTRY entry;
+    entry.reo_type = AVSV_CKPT_AVD_IMM_JOB_QUEUE_STATUS;
+    entry.reo_hdl = 0;
+    if (i == 1) {
+      entry.reo_type = AVSV_CKPT_MSG_MAX + 1;
+      entry.data.assign(3, 0xff);
+    } else {
+      entry.data.assign(4, 0);
+      entry.data[3] = sizes[i / 2];
+    }
+    batch.entries.push_back(entry);
+  }
+
+  rc = ncs_enc_init_space(&enc.io_uba);
+  ASSERT_TRUE(rc == NCSCC_RC_SUCCESS);
+
+  enc.io_msg_type = NCS_MBCSV_MSG_ASYNC_UPDATE;
+  enc.io_action = NCS_MBCSV_ACT_UPDATE;
+  enc.io_reo_hdl = (MBCSV_REO_HDL)&batch;
+  enc.io_reo_type = AVSV_CKPT_AVD_BATCH;
+  enc.i_peer_version = AVD_MBCSV_SUB_PART_VERSION_9;
+
+  rc = avd_enc_ckpt_data_func_list[AVSV_CKPT_AVD_BATCH](avd_cb, &enc);
+  ASSERT_TRUE(rc == NCSCC_RC_SUCCESS);
+  ASSERT_EQ(enc.io_uba.ttl, 4 + 3 * 8 + 4 + 3 + 4);
+
+  dec.i_msg_type = NCS_MBCSV_MSG_ASYNC_UPDATE;
+  dec.i_action = NCS_MBCSV_ACT_UPDATE;
+  dec.i_reo_type = AVSV_CKPT_AVD_BATCH;
+  ncs_dec_init_space(&dec.i_uba, enc.io_uba.start);
+
+  // the unknown update is skipped, the one after it is still decoded
+  rc = avd_dec_data_func_list[AVSV_CKPT_AVD_BATCH](avd_cb, &dec);
+  ASSERT_TRUE(rc == NCSCC_RC_FAILURE);
+  ASSERT_EQ(dec.i_uba.ttl, dec.i_uba.max);
+}
+
+TEST_F(CkptEncDecTest, testCkptBatchCoalesce) {
+  SG_2N sg;
+  AVD_AVND avnd;
+  AVSV_CKPT_BATCH *batch = &avd_cb->ckpt_batch;
+
+  sg.name = "sg_name";
+  avnd.name = "node_name";
+  avd_cb->avail_state_avd = SA_AMF_HA_ACTIVE;
+  avd_cb->avd_peer_ver = AVD_MBCSV_SUB_PART_VERSION_9;
+  avd_cb->async_updt_cnt = {};
+
+  sg.sg_fsm_state = AVD_SG_FSM_SG_REALIGN;
+  m_AVSV_SEND_CKPT_UPDT_ASYNC_UPDT(avd_cb, &sg, AVSV_CKPT_SG_FSM_STATE);
+  m_AVSV_SEND_CKPT_UPDT_ASYNC_UPDT(avd_cb, &avnd, AVSV_CKPT_AVND_NODE_STATE);
+  sg.sg_fsm_state = AVD_SG_FSM_STABLE;
+  m_AVSV_SEND_CKPT_UPDT_ASYNC_UPDT(avd_cb, &sg, AVSV_CKPT_SG_FSM_STATE);
+
+  // the second SG update replaces the first one and is last in the batch
+  ASSERT_EQ(batch->entries.size(), static_cast<size_t>(2));
+  ASSERT_EQ(batch->updts_batched, static_cast<uint64_t>(3));
+  ASSERT_EQ(batch->updts_saved, static_cast<uint64_t>(1));
+  ASSERT_EQ(batch->entries.front().reo_type,
+            static_cast<uint32_t>(AVSV_CKPT_AVND_NODE_STATE));
+  ASSERT_EQ(batch->entries.back().reo_type,
+            static_cast<uint32_t>(AVSV_CKPT_SG_FSM_STATE));
+  ASSERT_EQ(batch->entries.back().data.back(),
+            static_cast<uint8_t>(AVD_SG_FSM_STABLE));
+
+  // the standby decodes one update of each, so each is counted once
+  ASSERT_EQ(avd_cb->async_updt_cnt.sg_updt, static_cast<uint32_t>(1));
+  ASSERT_EQ(avd_cb->async_updt_cnt.node_updt, static_cast<uint32_t>(1));
+
+  batch->entries.clear();
+  batch->index.clear();
+}
+
+TEST_F(CkptEncDecTest, testDecAvdBatchInColdSync) {
+  int rc = 0;
+  AVSV_CKPT_BATCH batch;
+  AVD_SU su("su_name");
+  AVD_CL_CB cb;
+  MBCSV_REO_HDL hdls[] = {(MBCSV_REO_HDL)&su, (MBCSV_REO_HDL)&cb};
+  AVD_CL_CB *cbs[] = {avd_cb, &cb};
+  uint32_t types[] = {AVSV_CKPT_SU_OPER_STATE, AVSV_CKPT_AVD_CB_CONFIG};
+
+  su.saAmfSUOperState = SA_AMF_OPERATIONAL_ENABLED;
+  cb.nodes_exit_cnt = 3;
+  for (uint32_t i = 0; i < 2; i++) {
+    AVSV_CKPT_BATCH_ENTRY entry;
+    entry.reo_type = types[i];
+    entry.reo_hdl = hdls[i];
+
+    NCS_MBCSV_CB_ENC updt{};
+    updt.io_msg_type = NCS_MBCSV_MSG_ASYNC_UPDATE;
+    updt.io_action = NCS_MBCSV_ACT_UPDATE;
+    updt.io_reo_hdl = hdls[i];
+    updt.io_reo_type = types[i];
+    updt.i_peer_version = AVD_MBCSV_SUB_PART_VERSION_9;
+    rc = ncs_enc_init_space(&updt.io_uba);
+    ASSERT_TRUE(rc == NCSCC_RC_SUCCESS);
+    rc = avd_enc_ckpt_data_func_list[types[i]](cbs[i], &updt);
+    ASSERT_TRUE(rc == NCSCC_RC_SUCCESS);
+    entry.data.resize(updt.io_uba.ttl);
+    ncs_decode_n_octets_from_uba(&updt.io_uba, entry.data.data(),
+                                 entry.data.size());
+    m_MMGR_FREE_BUFR_LIST(updt.io_uba.ub);
+    batch.entries.push_back(entry);
+  }
+
+  rc = ncs_enc_init_space(&enc.io_uba);
+  ASSERT_TRUE(rc == NCSCC_RC_SUCCESS);
+  enc.io_msg_type = NCS_MBCSV_MSG_ASYNC_UPDATE;
+  enc.io_action = NCS_MBCSV_ACT_UPDATE;
+  enc.io_reo_hdl = (MBCSV_REO_HDL)&batch;
+  enc.io_reo_type = AVSV_CKPT_AVD_BATCH;
+  enc.i_peer_version = AVD_MBCSV_SUB_PART_VERSION_9;
+  rc = avd_enc_ckpt_data_func_list[AVSV_CKPT_AVD_BATCH](avd_cb, &enc);
+  ASSERT_TRUE(rc == NCSCC_RC_SUCCESS);
+
+  // only the CB is cold synced, the SU update must not create the SU
+  su_db = new AmfDb<std::string, AVD_SU>;
+  avd_cb->stby_sync_state = AVD_STBY_OUT_OF_SYNC;
+  avd_cb->synced_reo_type = AVSV_CKPT_AVD_CB_CONFIG;
+  avd_cb->async_updt_cnt = {};
+  avd_cb->nodes_exit_cnt = 0;
+
+  dec.i_msg_type = NCS_MBCSV_MSG_ASYNC_UPDATE;
+  dec.i_action = NCS_MBCSV_ACT_UPDATE;
+  dec.i_reo_type = AVSV_CKPT_AVD_BATCH;
+  dec.i_peer_version = AVD_MBCSV_SUB_PART_VERSION_9;
+  ncs_dec_init_space(&dec.i_uba, enc.io_uba.start);
+  rc = avd_dec_data_func_list[AVSV_CKPT_AVD_BATCH](avd_cb, &dec);
+  ASSERT_TRUE(rc == NCSCC_RC_SUCCESS);
+  ASSERT_EQ(dec.i_uba.ttl, dec.i_uba.max);
+
+  ASSERT_EQ(su_db->find("su_name"), nullptr);
+  ASSERT_EQ(avd_cb->async_updt_cnt.su_updt, static_cast<uint32_t>(0));
+  ASSERT_EQ(avd_cb->async_updt_cnt.cb_updt, static_cast<uint32_t>(1));
+  ASSERT_EQ(avd_cb->nodes_exit_cnt, static_cast<uint32_t>(3));
+
+  delete su_db;
+  su_db = nullptr;
+  avd_cb->async_updt_cnt = {};
+}
@@ -0,0 +1,134 @@
+/*      -*- OpenSAF  -*-
+ *
+ * (C) Copyright 2017 The OpenSAF Foundation
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. This file and program are licensed
+ * under the GNU Lesser General Public License Version 2.1, February 1999.
+ * The complete license can be accessed from the following location:
+ * http://opensource.org/licenses/lgpl-license.php
+ * See the Copying file included with the OpenSAF distribution for full
+ * licensing terms.
+ *
+ */
+
+#include <cstring>
+#include <string>
+#include "amf/amfd/imm_cache.h"
+#include "base/osaf_extended_name.h"
+#include "gtest/gtest.h"
+
+TEST(ImmConfigCacheTest, ParentDn) {
+  EXPECT_EQ(ImmConfigCache::parentDn("safComp=c,safSu=s,safSg=g,safApp=a"),
+            "safSu=s,safSg=g,safApp=a");
+  EXPECT_EQ(ImmConfigCache::parentDn("safApp=a"), "");
+  EXPECT_EQ(ImmConfigCache::parentDn(""), "");
+}
+
+TEST(ImmConfigCacheTest, ParentDnWithEscapedCommas) {
+  // Association objects have a DN as the value of their RDN
+  EXPECT_EQ(ImmConfigCache::parentDn(
+                "safSISU=safSu=s\\,safSg=g\\,safApp=a,safSi=i,safApp=a"),
+            "safSi=i,safApp=a");
+  EXPECT_EQ(ImmConfigCache::parentDn("safRdn=a\\,b\\,"), "");
+  // An escaped '\' does not escape the comma after it
+  EXPECT_EQ(ImmConfigCache::parentDn("safRdn=a\\\\,safApp=a"), "safApp=a");
+}
+
+// The copy of a search result must not refer to the memory of the search,
+// which is freed by the next search
+TEST(ImmConfigCacheTest, CopyAttributes) {
+  char name_attr[] = "saAmfCompType";
+  char string_attr[] = "saAmfCompCmdEnv";
+  char uint_attr[] = "saAmfCompNumMaxInstantiateWithoutDelay";
+  char any_attr[] = "saAmfCompData";
+  char empty_attr[] = "saAmfCompCsType";
+
+  SaNameT name;
+  osaf_extended_name_lend("safVersion=1,safCompType=c", &name);
+  SaImmAttrValueT name_values[] = {&name};
+  char env1[] = "A=1";
+  char env2[] = "B=2";
+  SaStringT strings[] = {env1, env2, nullptr};
+  SaImmAttrValueT string_values[] = {&strings[0], &strings[1], &strings[2]};
+  SaUint32T number = 7;
+  SaImmAttrValueT uint_values[] = {&number};
+  SaUint8T bytes[] = {1, 2, 3};
+  SaAnyT any = {sizeof(bytes), bytes};
+  SaImmAttrValueT any_values[] = {&any};
+
+  SaImmAttrValuesT_2 attrs[] = {
+      {name_attr, SA_IMM_ATTR_SANAMET, 1, name_values},
+      {string_attr, SA_IMM_ATTR_SASTRINGT, 3, string_values},
+      {uint_attr, SA_IMM_ATTR_SAUINT32T, 1, uint_values},
+      {any_attr, SA_IMM_ATTR_SAANYT, 1, any_values},
+      {empty_attr, SA_IMM_ATTR_SANAMET, 0, nullptr}};
+  const SaImmAttrValuesT_2 *attributes[] = {&attrs[0], &attrs[1], &attrs[2],
+                                            &attrs[3], &attrs[4], nullptr};
+
+  ImmConfigCache::Object object;
+  ImmConfigCache::copyAttributes(attributes, &object);
+
+  // Overwrite the search result
+  std::string dn = "safVersion=1,safCompType=c";
+  osaf_extended_name_lend("safVersion=2,safCompType=x", &name);
+  strcpy(env1, "X=9");
+  strcpy(name_attr, "saAmfXXXXType");
+  number = 0;
+  bytes[0] = 0;
+
+  ASSERT_EQ(object.attributes.size(), 6u);
+  EXPECT_EQ(object.attributes[5], nullptr);
+  const char *begin = object.data.data();
+  const char *end = begin + object.data.size();
+  for (size_t i = 0; i < 5; i++) {
+    const SaImmAttrValuesT_2 *attr = object.attributes[i];
+    EXPECT_GE(reinterpret_cast<const char *>(attr), begin);
+    EXPECT_LT(reinterpret_cast<const char *>(attr), end);
+    EXPECT_EQ(attr->attrValueType, attrs[i].attrValueType);
+    ASSERT_EQ(attr->attrValuesNumber, attrs[i].attrValuesNumber);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(attr->attrValues) % 8, 0u);
+    for (unsigned int j = 0; j < attr->attrValuesNumber; j++) {
+      const char *value = static_cast<const char *>(attr->attrValues[j]);
+      EXPECT_GE(value, begin);
+      EXPECT_LT(value, end);
+      EXPECT_EQ(reinterpret_cast<uintptr_t>(value) % 8, 0u);
+    }
+  }
+
+  const SaImmAttrValuesT_2 *attr = object.attributes[0];
+  EXPECT_STREQ(attr->attrName, "saAmfCompType");
+  EXPECT_EQ(osaf_extended_name_borrow(
+                static_cast<const SaNameT *>(attr->attrValues[0])),
+            dn);
+
+  attr = object.attributes[1];
+  EXPECT_STREQ(attr->attrName, "saAmfCompCmdEnv");
+  EXPECT_STREQ(*static_cast<SaStringT *>(attr->attrValues[0]), "A=1");
+  EXPECT_STREQ(*static_cast<SaStringT *>(attr->attrValues[1]), "B=2");
+  EXPECT_EQ(*static_cast<SaStringT *>(attr->attrValues[2]), nullptr);
+
+  attr = object.attributes[2];
+  EXPECT_EQ(*static_cast<SaUint32T *>(attr->attrValues[0]), 7u);
+
+  attr = object.attributes[3];
+  const SaAnyT *any_copy = static_cast<const SaAnyT *>(attr->attrValues[0]);
+  ASSERT_EQ(any_copy->bufferSize, sizeof(bytes));
+  EXPECT_NE(any_copy->bufferAddr, bytes);
+  EXPECT_EQ(any_copy->bufferAddr[0], 1);
+  EXPECT_EQ(any_copy->bufferAddr[2], 3);
+
+  attr = object.attributes[4];
+  EXPECT_STREQ(attr->attrName, "saAmfCompCsType");
+  EXPECT_EQ(attr->attrValues, nullptr);
+}
+
+TEST(ImmConfigCacheTest, CopyNoAttributes) {
+  const SaImmAttrValuesT_2 *attributes[] = {nullptr};
+  ImmConfigCache::Object object;
+  ImmConfigCache::copyAttributes(attributes, &object);
+  ASSERT_EQ(object.attributes.size(), 1u);
+  EXPECT_EQ(object.attributes[0], nullptr);
+  EXPECT_TRUE(object.data.empty());
+}
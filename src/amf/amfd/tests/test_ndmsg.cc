@@ -0,0 +1,179 @@
+/*      -*- OpenSAF  -*-
+ *
+ * (C) Copyright 2017 The OpenSAF Foundation
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. This file and program are licensed
+ * under the GNU Lesser General Public License Version 2.1, February 1999.
+ * The complete license can be accessed from the following location:
+ * http://opensource.org/licenses/lgpl-license.php
+ * See the Copying file included with the OpenSAF distribution for full
+ * licensing terms.
+ *
+ */
+
+#include <string>
+#include "amf/amfd/cb.h"
+#include "amf/amfd/msg.h"
+#include "amf/amfd/node.h"
+#include "amf/amfd/util.h"
+#include "amf/common/amf_d2nedu.h"
+#include "base/ncssysf_mem.h"
+#include "base/osaf_extended_name.h"
+#include "gtest/gtest.h"
+
+static const SaClmNodeIdT kNodeId = 0x2020f;
+
+// The fixture for testing the SU SI operations batched in one d2n message
+class NdMsgTest : public ::testing::Test {
+ protected:
+  virtual void SetUp() {
+    EDU_ERR err = EDU_NORMAL;
+    m_NCS_EDU_HDL_INIT(&avd_cb->mds_edu_hdl);
+    ASSERT_EQ(m_NCS_EDU_COMPILE_EDP(&avd_cb->mds_edu_hdl, avsv_edp_dnd_msg,
+                                    &err),
+              NCSCC_RC_SUCCESS);
+    node_.node_info.nodeId = kNodeId;
+    node_.adest = 0x1234;
+  }
+
+  virtual void TearDown() {
+    // Drop the queued messages without sending them
+    while (!avd_cb->nd_msg_queue_list.empty()) {
+      AVSV_ND_MSG_QUEUE *elem = avd_cb->nd_msg_queue_list.front();
+      avd_cb->nd_msg_queue_list.pop();
+      d2n_msg_free(
+          static_cast<AVD_DND_MSG *>(elem->snd_msg.info.svc_send.i_msg));
+      delete elem;
+    }
+    nds_mds_ver_db.erase(kNodeId);
+    m_NCS_EDU_HDL_FLUSH(&avd_cb->mds_edu_hdl);
+  }
+
+  // A SU SI assign message as avd_snd_susi_msg() builds it
+  static AVD_DND_MSG *SusiMsg(uint32_t msg_id, const std::string &su,
+                              const std::string &si, SaAmfHAStateT ha_state) {
+    AVD_DND_MSG *msg = new AVD_DND_MSG();
+    msg->msg_type = AVSV_D2N_INFO_SU_SI_ASSIGN_MSG;
+    AVSV_D2N_INFO_SU_SI_ASSIGN_MSG_INFO *info =
+        &msg->msg_info.d2n_su_si_assign;
+    info->msg_id = msg_id;
+    info->node_id = kNodeId;
+    info->msg_act = AVSV_SUSI_ACT_MOD;
+    osaf_extended_name_alloc(su.c_str(), &info->su_name);
+    osaf_extended_name_alloc(si.c_str(), &info->si_name);
+    info->ha_state = ha_state;
+    info->si_rank = 1;
+    return msg;
+  }
+
+  // The message queued for the node, as it would be sent
+  static AVD_DND_MSG *Queued() {
+    if (avd_cb->nd_msg_queue_list.size() != 1) return nullptr;
+    return static_cast<AVD_DND_MSG *>(
+        avd_cb->nd_msg_queue_list.front()->snd_msg.info.svc_send.i_msg);
+  }
+
+  // Encodes and decodes a message the way MDS does between AMFD and AMFND
+  static AVD_DND_MSG *EncDec(AVD_DND_MSG *msg, MDS_CLIENT_MSG_FORMAT_VER ver) {
+    NCS_UBAID uba{};
+    if (ncs_enc_init_space(&uba) != NCSCC_RC_SUCCESS) return nullptr;
+
+    MDS_CALLBACK_ENC_INFO enc{};
+    enc.io_uba = &uba;
+    enc.i_msg = msg;
+    enc.i_rem_svc_pvt_ver = ver;
+    enc.o_msg_fmt_ver = ver;
+    if (avd_mds_enc(&enc) != NCSCC_RC_SUCCESS) {
+      m_MMGR_FREE_BUFR_LIST(uba.start);
+      return nullptr;
+    }
+
+    ncs_dec_init_space(&uba, uba.start);
+    MDS_CALLBACK_DEC_INFO dec{};
+    dec.io_uba = &uba;
+    dec.i_msg_fmt_ver = ver;
+    uint32_t rc = avd_mds_dec(&dec);
+    m_MMGR_FREE_BUFR_LIST(uba.ub);
+    if (rc != NCSCC_RC_SUCCESS) return nullptr;
+    return static_cast<AVD_DND_MSG *>(dec.o_msg);
+  }
+
+  static std::string Name(const SaNameT &name) {
+    return osaf_extended_name_borrow(&name);
+  }
+
+  AVD_AVND node_;
+};
+
+TEST_F(NdMsgTest, testBatchNeedsVersion8) {
+  nds_mds_ver_db[kNodeId] = AVSV_AVD_AVND_MSG_FMT_VER_7;
+  ASSERT_EQ(avd_d2n_msg_snd(avd_cb, &node_,
+                            SusiMsg(10, "safSu=1", "safSi=1", SA_AMF_HA_ACTIVE)),
+            NCSCC_RC_SUCCESS);
+
+  AVD_DND_MSG *msg = SusiMsg(0, "safSu=2", "safSi=2", SA_AMF_HA_STANDBY);
+  EXPECT_FALSE(avd_d2n_susi_msg_batch(avd_cb, &node_, msg));
+  d2n_msg_free(msg);
+
+  nds_mds_ver_db[kNodeId] = AVSV_AVD_AVND_MSG_FMT_VER_8;
+  msg = SusiMsg(0, "safSu=2", "safSi=2", SA_AMF_HA_STANDBY);
+  EXPECT_TRUE(avd_d2n_susi_msg_batch(avd_cb, &node_, msg));
+  ASSERT_NE(Queued(), nullptr);
+  EXPECT_NE(Queued()->msg_info.d2n_su_si_assign.next, nullptr);
+}
+
+TEST_F(NdMsgTest, testEncDecBatchedSusiMsg) {
+  nds_mds_ver_db[kNodeId] = AVSV_AVD_AVND_MSG_FMT_VER_8;
+  ASSERT_EQ(avd_d2n_msg_snd(avd_cb, &node_,
+                            SusiMsg(10, "safSu=1", "safSi=1", SA_AMF_HA_ACTIVE)),
+            NCSCC_RC_SUCCESS);
+  ASSERT_TRUE(avd_d2n_susi_msg_batch(
+      avd_cb, &node_, SusiMsg(0, "safSu=2", "safSi=2", SA_AMF_HA_STANDBY)));
+  ASSERT_TRUE(avd_d2n_susi_msg_batch(
+      avd_cb, &node_, SusiMsg(0, "safSu=3", "safSi=3", SA_AMF_HA_QUIESCED)));
+
+  AVD_DND_MSG *msg = EncDec(Queued(), AVSV_AVD_AVND_MSG_FMT_VER_8);
+  ASSERT_NE(msg, nullptr);
+  ASSERT_EQ(msg->msg_type, AVSV_D2N_INFO_SU_SI_ASSIGN_MSG);
+  const AVSV_D2N_INFO_SU_SI_ASSIGN_MSG_INFO *op =
+      &msg->msg_info.d2n_su_si_assign;
+  EXPECT_EQ(op->msg_id, 10u);
+  EXPECT_EQ(Name(op->su_name), "safSu=1");
+  EXPECT_EQ(op->ha_state, SA_AMF_HA_ACTIVE);
+
+  // The further operations follow in the order added. They share the
+  // msg_id and node_id of the first, those are not encoded again.
+  op = op->next;
+  ASSERT_NE(op, nullptr);
+  EXPECT_EQ(op->msg_id, 0u);
+  EXPECT_EQ(op->msg_act, AVSV_SUSI_ACT_MOD);
+  EXPECT_EQ(Name(op->su_name), "safSu=2");
+  EXPECT_EQ(Name(op->si_name), "safSi=2");
+  EXPECT_EQ(op->ha_state, SA_AMF_HA_STANDBY);
+  EXPECT_EQ(op->si_rank, 1u);
+  op = op->next;
+  ASSERT_NE(op, nullptr);
+  EXPECT_EQ(Name(op->su_name), "safSu=3");
+  EXPECT_EQ(op->ha_state, SA_AMF_HA_QUIESCED);
+  EXPECT_EQ(op->next, nullptr);
+  avsv_dnd_msg_free(msg);
+}
+
+TEST_F(NdMsgTest, testEncDecSusiMsgVersion7) {
+  // An older node director gets the first operation only
+  nds_mds_ver_db[kNodeId] = AVSV_AVD_AVND_MSG_FMT_VER_8;
+  ASSERT_EQ(avd_d2n_msg_snd(avd_cb, &node_,
+                            SusiMsg(11, "safSu=1", "safSi=1", SA_AMF_HA_ACTIVE)),
+            NCSCC_RC_SUCCESS);
+  ASSERT_TRUE(avd_d2n_susi_msg_batch(
+      avd_cb, &node_, SusiMsg(0, "safSu=2", "safSi=2", SA_AMF_HA_STANDBY)));
+
+  AVD_DND_MSG *msg = EncDec(Queued(), AVSV_AVD_AVND_MSG_FMT_VER_7);
+  ASSERT_NE(msg, nullptr);
+  EXPECT_EQ(msg->msg_info.d2n_su_si_assign.msg_id, 11u);
+  EXPECT_EQ(Name(msg->msg_info.d2n_su_si_assign.si_name), "safSi=1");
+  EXPECT_EQ(msg->msg_info.d2n_su_si_assign.next, nullptr);
+  avsv_dnd_msg_free(msg);
+}
@@ -34,6 +34,7 @@
 #include "osaf/immutil/immutil.h"
 #include "base/logtrace.h"
 #include "amf/amfd/amfd.h"
+#include "amf/common/amf_fotrace.h"
 
 SaNameT _amfSvcUsrName;
 const SaNameT *amfSvcUsrName = &_amfSvcUsrName;
@@ -960,8 +961,23 @@ uint32_t avd_snd_susi_msg(AVD_CL_CB *cb, AVD_SU *su, AVD_SU_SI_REL *susi,
   /* if ((actn == AVSV_SUSI_ACT_ASGN) || ((actn == AVSV_SUSI_ACT_MOD) &&
      ((susi_msg->msg_info.d2n_su_si_assign.ha_state == SA_AMF_HA_ACTIVE) ||
      (susi_msg->msg_info.d2n_su_si_assign.ha_state == SA_AMF_HA_STANDBY))) */
+
+  /* Send it with the SU SI message already queued for the node, if any */
+  if (avd_d2n_susi_msg_batch(cb, avnd, susi_msg)) {
+    TRACE_LEAVE();
+    return NCSCC_RC_SUCCESS;
+  }
+
   susi_msg->msg_info.d2n_su_si_assign.msg_id = ++(avnd->snd_msg_id);
 
+  AMF_FOTRACE(AMF_FOTRACE_D_SEND, "corr=%x:%u su=%s si=%s act=%u ha=%u",
+              avnd->node_info.nodeId,
+              susi_msg->msg_info.d2n_su_si_assign.msg_id,
+              amf_fotrace_name(&susi_msg->msg_info.d2n_su_si_assign.su_name),
+              amf_fotrace_name(&susi_msg->msg_info.d2n_su_si_assign.si_name),
+              susi_msg->msg_info.d2n_su_si_assign.msg_act,
+              susi_msg->msg_info.d2n_su_si_assign.ha_state);
+
   /* send the SU SI message */
   TRACE("Sending %u to %x", AVSV_D2N_INFO_SU_SI_ASSIGN_MSG,
         avnd->node_info.nodeId);
@@ -1359,6 +1375,11 @@ int amfd_file_dump(const char *filename) {
   fprintf(f, "  compcstype_updt:%d\n", avd_cb->async_updt_cnt.compcstype_updt);
   fprintf(f, "  si_trans_updt:%d\n", avd_cb->async_updt_cnt.si_trans_updt);
   fprintf(f, "  ng_updt:%d\n", avd_cb->async_updt_cnt.ng_updt);
+  fprintf(f, "  batches_sent:%" PRIu64 "\n",
+          avd_cb->ckpt_batch.batches_sent);
+  fprintf(f, "  updts_batched:%" PRIu64 "\n",
+          avd_cb->ckpt_batch.updts_batched);
+  fprintf(f, "  updts_saved:%" PRIu64 "\n", avd_cb->ckpt_batch.updts_saved);
 
   fprintf(f, "nodes:\n");
   for (const auto &value : *node_id_db) {
@@ -1641,11 +1662,11 @@ static void free_d2n_su_msg_info(AVSV_DND_MSG *su_msg) {
 }
 
 /*****************************************************************************
- * Function: free_d2n_susi_msg_info
+ * Function: free_d2n_susi_info
  *
- * Purpose:  This function frees the d2n SU SI message contents.
+ * Purpose:  This function frees the contents of a d2n SU SI operation.
  *
- * Input: susi_msg - Pointer to the SUSI message contents to be freed.
+ * Input: susi_info - Pointer to the SU SI operation contents to be freed.
  *
  * Returns: none
  *
@@ -1655,16 +1676,15 @@ static void free_d2n_su_msg_info(AVSV_DND_MSG *su_msg) {
  *
  **************************************************************************/
 
-static void free_d2n_susi_msg_info(AVSV_DND_MSG *susi_msg) {
-  TRACE_ENTER();
+static void free_d2n_susi_info(AVSV_D2N_INFO_SU_SI_ASSIGN_MSG_INFO *susi_info) {
   AVSV_SUSI_ASGN *compcsi_info;
 
-  osaf_extended_name_free(&susi_msg->msg_info.d2n_su_si_assign.si_name);
-  osaf_extended_name_free(&susi_msg->msg_info.d2n_su_si_assign.su_name);
+  osaf_extended_name_free(&susi_info->si_name);
+  osaf_extended_name_free(&susi_info->su_name);
 
-  while (susi_msg->msg_info.d2n_su_si_assign.list != nullptr) {
-    compcsi_info = susi_msg->msg_info.d2n_su_si_assign.list;
-    susi_msg->msg_info.d2n_su_si_assign.list = compcsi_info->next;
+  while (susi_info->list != nullptr) {
+    compcsi_info = susi_info->list;
+    susi_info->list = compcsi_info->next;
     if (compcsi_info->attrs.list != nullptr) {
       for (uint16_t i = 0; i < compcsi_info->attrs.number; i++) {
         osaf_extended_name_free(&compcsi_info->attrs.list[i].name);
@@ -1680,6 +1700,35 @@ static void free_d2n_susi_msg_info(AVSV_DND_MSG *susi_msg) {
     osaf_extended_name_free(&compcsi_info->csi_name);
     delete compcsi_info;
   }
+}
+
+/*****************************************************************************
+ * Function: free_d2n_susi_msg_info
+ *
+ * Purpose:  This function frees the d2n SU SI message contents.
+ *
+ * Input: susi_msg - Pointer to the SUSI message contents to be freed.
+ *
+ * Returns: none
+ *
+ * NOTES: It also frees the further SU SI operations carried in the
+ * message.
+ *
+ *
+ **************************************************************************/
+
+static void free_d2n_susi_msg_info(AVSV_DND_MSG *susi_msg) {
+  TRACE_ENTER();
+  AVSV_D2N_INFO_SU_SI_ASSIGN_MSG_INFO *susi_info;
+
+  free_d2n_susi_info(&susi_msg->msg_info.d2n_su_si_assign);
+
+  while (susi_msg->msg_info.d2n_su_si_assign.next != nullptr) {
+    susi_info = susi_msg->msg_info.d2n_su_si_assign.next;
+    susi_msg->msg_info.d2n_su_si_assign.next = susi_info->next;
+    free_d2n_susi_info(susi_info);
+    delete susi_info;
+  }
   TRACE_LEAVE();
 }
 
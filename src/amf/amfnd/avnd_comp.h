@@ -256,6 +256,12 @@ typedef struct avnd_hc_rec_tag {
   uint32_t opq_hdl; /* hdl returned by hdl-mngr (used during tmr expiry) */
   AVND_COMP_HC_STATUS status; /* indicates status of hc rec */
 
+  /* shared memory heartbeat (see hcshm.cc) */
+  uint32_t shm_slot;  /* slot index + 1, 0 if the hc has no slot */
+  bool shm_active;    /* checked in the shared memory, not by tmr & cbk */
+  uint64_t shm_since; /* time the shared memory check started */
+  uint64_t shm_tick;  /* tick of the next check */
+
   struct avnd_comp_tag *comp; /* back ptr to the comp */
   struct avnd_hc_rec_tag *next;
   std::string comp_name; /* For checkpoiting */
@@ -960,6 +966,12 @@ extern void avnd_comp_cmplete_all_csi_rec(struct avnd_cb_tag *, AVND_COMP *);
 extern uint32_t avnd_comp_hc_rec_start(struct avnd_cb_tag *, AVND_COMP *,
                                        AVND_COMP_HC_REC *);
 extern uint32_t avnd_comp_hc_cmd_start(struct avnd_cb_tag *, AVND_COMP *);
+extern void avnd_hcshm_init(struct avnd_cb_tag *);
+extern void avnd_hcshm_slot_alloc(struct avnd_cb_tag *, AVND_COMP_HC_REC *);
+extern void avnd_hcshm_slot_free(struct avnd_cb_tag *, AVND_COMP_HC_REC *);
+extern bool avnd_hcshm_activate(struct avnd_cb_tag *, AVND_COMP_HC_REC *);
+extern bool avnd_hcshm_resp(struct avnd_cb_tag *, MDS_DEST,
+                            const AVSV_AMF_RESP_PARAM *);
 extern void avnd_comp_hc_cmd_restart(AVND_COMP *);
 extern void avnd_comp_hc_cmd_stop(struct avnd_cb_tag *, AVND_COMP *);
 extern uint32_t avnd_comp_unreg_prc(struct avnd_cb_tag *, AVND_COMP *,
@@ -113,6 +113,7 @@ typedef enum avnd_evt_type {
   AVND_EVT_TMR_QSCING_CMPL,
   AVND_EVT_IR,
   AVND_EVT_AMFA_MDS_VER_INFO,
+  AVND_EVT_TMR_HC_SHM,
 
   AVND_EVT_MAX
 } AVND_EVT_TYPE;
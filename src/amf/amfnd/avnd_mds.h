@@ -32,10 +32,10 @@
 #define AMF_AMFND_AVND_MDS_H_
 
 /* In Service upgrade support */
-#define AVND_MDS_SUB_PART_VERSION 7
+#define AVND_MDS_SUB_PART_VERSION 8
 
 #define AVND_AVD_SUBPART_VER_MIN 1
-#define AVND_AVD_SUBPART_VER_MAX 7
+#define AVND_AVD_SUBPART_VER_MAX 8
 
 #define AVND_AVND_SUBPART_VER_MIN 1
 #define AVND_AVND_SUBPART_VER_MAX 1
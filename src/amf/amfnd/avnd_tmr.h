@@ -48,6 +48,7 @@ typedef enum avnd_tmr_type {
   AVND_TMR_HB_DURATION,
   AVND_TMR_SC_ABSENCE,       /* SC absence timer */
   AVND_TMR_QSCING_CMPL_RESP, /* Qscing complete timer */
+  AVND_TMR_HC_SHM,           /* shared memory health check timer */
   AVND_TMR_MAX
 } AVND_TMR_TYPE;
 
@@ -33,12 +33,20 @@
 ******************************************************************************
 */
 #include "amf/amfnd/avnd.h"
+#include "amf/common/amf_fotrace.h"
 
 /*** static function declarations */
 
 AVND_COMP_CBK *avnd_comp_cbq_rec_add(AVND_CB *, AVND_COMP *,
                                      AVSV_AMF_CBK_INFO *, MDS_DEST *, SaTimeT);
 
+/* The CSI of a CSI set or remove callback for the failover trace */
+static const char *cbk_fotrace_csi(const AVSV_AMF_CBK_INFO *info) {
+  if (info->type == AVSV_AMF_CSI_SET)
+    return amf_fotrace_name(&info->param.csi_set.csi_desc.csiName);
+  return amf_fotrace_name(&info->param.csi_rem.csi_name);
+}
+
 /****************************************************************************
   Name          : avnd_evt_ava_csi_quiescing_compl
 
@@ -350,11 +358,24 @@ uint32_t avnd_evt_ava_resp_evh(AVND_CB *cb, AVND_EVT *evt) {
   }
   /* if (!cbk_rec && comp->pxied_list.n_nodes != 0)  */
   if (!cbk_rec) {
+    /* a failed healthcheck invoked by the agent, see hcshm.cc */
+    if (avnd_hcshm_resp(cb, evt->info.ava.mds_dest, resp)) {
+      TRACE_LEAVE2("HC response comp=%s, inv=%llx", comp->name.c_str(),
+                   resp->inv);
+      return rc;
+    }
     TRACE_LEAVE2("Empty comp callback record comp=%s, callback type=%llx",
                  comp->name.c_str(), resp->inv);
     return rc;
   }
 
+  if (cbk_rec->cbk_info->type == AVSV_AMF_CSI_SET ||
+      cbk_rec->cbk_info->type == AVSV_AMF_CSI_REM)
+    AMF_FOTRACE(AMF_FOTRACE_ND_CBK_RSP,
+                "node=%x inv=%llu comp=%s csi=%s err=%u", cb->node_info.nodeId,
+                resp->inv, comp->name.c_str(),
+                cbk_fotrace_csi(cbk_rec->cbk_info), resp->err);
+
   switch (cbk_rec->cbk_info->type) {
     case AVSV_AMF_HC: {
       AVND_COMP_HC_REC tmp_hc_rec;
@@ -788,6 +809,16 @@ uint32_t avnd_comp_cbq_rec_send(AVND_CB *cb, AVND_COMP *comp,
   uint32_t rc = avsv_amf_cbk_copy(&msg.info.ava->info.cbk_info, rec->cbk_info);
   if (NCSCC_RC_SUCCESS != rc) goto done;
 
+  if (rec->cbk_info->type == AVSV_AMF_CSI_SET ||
+      rec->cbk_info->type == AVSV_AMF_CSI_REM)
+    AMF_FOTRACE(AMF_FOTRACE_ND_CBK,
+                "node=%x inv=%llu comp=%s csi=%s type=%u ha=%u",
+                cb->node_info.nodeId, rec->cbk_info->inv, comp->name.c_str(),
+                cbk_fotrace_csi(rec->cbk_info), rec->cbk_info->type,
+                rec->cbk_info->type == AVSV_AMF_CSI_SET
+                    ? rec->cbk_info->param.csi_set.ha
+                    : 0);
+
   /* Check wether we need to send this to local AvA or another AvND.
      Since proxy can be at another AvND, so we need to send to that AvND */
   if (((cb->node_info.nodeId != m_NCS_NODE_ID_FROM_MDS_DEST(rec->dest)) ||
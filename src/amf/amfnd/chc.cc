@@ -119,6 +119,7 @@ uint32_t avnd_evt_ava_hc_start_evh(AVND_CB *cb, AVND_EVT *evt) {
   if ((SA_AIS_OK == amf_rc) && (NCSCC_RC_SUCCESS == rc)) {
     if ((0 !=
          (rec = avnd_comp_hc_rec_add(cb, comp, hc_start, &api_info->dest)))) {
+      if (!msg_from_avnd) avnd_hcshm_slot_alloc(cb, rec);
       rc = avnd_comp_hc_rec_process(cb, comp, rec, AVND_COMP_HC_START,
                                     static_cast<SaAisErrorT>(0));
     } else
@@ -619,6 +620,9 @@ void avnd_comp_hc_rec_del(AVND_CB *cb, AVND_COMP *comp, AVND_COMP_HC_REC *rec) {
       m_AVND_TMR_COMP_HC_STOP(cb, *rec);
     }
 
+    /* free the shared memory slot */
+    avnd_hcshm_slot_free(cb, rec);
+
     /* unlink from the comp-hc list */
     m_AVND_COMPDB_REC_HC_REM(*comp, *rec);
     delete rec;
@@ -725,6 +729,9 @@ uint32_t avnd_comp_hc_rec_start(AVND_CB *cb, AVND_COMP *comp,
 
   /* Invoke the hc callbk for AMF initiated healthcheck */
   if (m_AVND_COMP_HC_REC_IS_AMF_INITIATED(rec)) {
+    /* the agent invokes it if it has attached to the shared memory slot */
+    if (avnd_hcshm_activate(cb, rec)) return rc;
+
     rc = avnd_comp_cbk_send(cb, comp, AVSV_AMF_HC, rec, 0);
 
     if (NCSCC_RC_SUCCESS == rc) rec->status = AVND_COMP_HC_STATUS_WAIT_FOR_RESP;
@@ -926,9 +933,12 @@ uint32_t avnd_comp_hc_rec_confirm(AVND_CB *cb, AVND_COMP *comp,
   osafassert(m_AVND_COMP_HC_REC_IS_COMP_INITIATED(rec));
 
   if (SA_AIS_OK == res) {
-    /* restart the periodic timer */
-    m_AVND_TMR_COMP_HC_STOP(cb, *rec);
-    m_AVND_TMR_COMP_HC_START(cb, *rec, rc);
+    /* restart the periodic timer, unless the agent has attached to the
+     * shared memory slot and confirms there from now on */
+    if (!avnd_hcshm_activate(cb, rec)) {
+      m_AVND_TMR_COMP_HC_STOP(cb, *rec);
+      m_AVND_TMR_COMP_HC_START(cb, *rec, rc);
+    }
   } else {
     /* process comp failure */
     err_info.src = AVND_ERR_SRC_HC;
@@ -39,6 +39,7 @@
 
 #include "base/logtrace.h"
 #include "amf/amfnd/avnd.h"
+#include "amf/common/amf_fotrace.h"
 
 /* macro to push the AvD msg parameters (to the end of the list) */
 #define m_AVND_DIQ_REC_PUSH(cb, rec)         \
@@ -945,6 +946,14 @@ uint32_t avnd_di_susi_resp_send(AVND_CB *cb, AVND_SU *su, AVND_SU_SI_REC *si) {
   } else {
     // We are in normal cluster, send msg to director
     msg.info.avd->msg_info.n2d_su_si_assign.msg_id = ++(cb->snd_msg_id);
+    AMF_FOTRACE(
+        AMF_FOTRACE_ND_RSP, "rsp=%x:%u su=%s si=%s act=%u ha=%u err=%u",
+        cb->node_info.nodeId, msg.info.avd->msg_info.n2d_su_si_assign.msg_id,
+        su->name.c_str(),
+        amf_fotrace_name(&msg.info.avd->msg_info.n2d_su_si_assign.si_name),
+        msg.info.avd->msg_info.n2d_su_si_assign.msg_act,
+        msg.info.avd->msg_info.n2d_su_si_assign.ha_state,
+        msg.info.avd->msg_info.n2d_su_si_assign.error);
     /* send the msg to AvD */
     rc = avnd_di_msg_send(cb, &msg);
     if (NCSCC_RC_SUCCESS == rc) msg.info.avd = 0;
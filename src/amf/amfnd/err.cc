@@ -57,6 +57,7 @@
 */
 
 #include "amf/amfnd/avnd.h"
+#include "amf/common/amf_fotrace.h"
 
 /* static function declarations */
 
@@ -455,6 +456,9 @@ uint32_t avnd_err_process(AVND_CB *cb, AVND_COMP *comp,
 
   LOG_NO("'%s' faulted due to '%s' : Recovery is '%s'", comp->name.c_str(),
          g_comp_err[err_info->src], g_comp_rcvr[esc_rcvr - 1]);
+  AMF_FOTRACE(AMF_FOTRACE_ND_DETECT, "node=%x comp=%s su=%s src=%s rcvr=%s",
+              cb->node_info.nodeId, comp->name.c_str(), comp->su->name.c_str(),
+              g_comp_err[err_info->src], g_comp_rcvr[esc_rcvr - 1]);
 
   if (((comp->su->is_ncs == true) && (esc_rcvr != SA_AMF_COMPONENT_RESTART)) ||
       esc_rcvr == SA_AMF_NODE_FAILFAST) {
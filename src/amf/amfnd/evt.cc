@@ -126,6 +126,7 @@ AVND_EVT *avnd_evt_create(AVND_CB *cb, AVND_EVT_TYPE type,
     case AVND_EVT_TMR_HB_DURATION:
     case AVND_EVT_TMR_SC_ABSENCE:
     case AVND_EVT_TMR_QSCING_CMPL:
+    case AVND_EVT_TMR_HC_SHM:
       evt->priority = NCS_IPC_PRIORITY_HIGH; /* bump up the priority */
       evt->info.tmr.opq_hdl = *(uint32_t *)info;
       break;
@@ -275,6 +276,7 @@ void avnd_evt_destroy(AVND_EVT *evt) {
     case AVND_EVT_TMR_HB_DURATION:
     case AVND_EVT_TMR_SC_ABSENCE:
     case AVND_EVT_TMR_QSCING_CMPL:
+    case AVND_EVT_TMR_HC_SHM:
       break;
 
     /* mds event types */
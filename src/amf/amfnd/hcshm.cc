@@ -0,0 +1,373 @@
+/*      -*- OpenSAF  -*-
+ *
+ * (C) Copyright 2017 The OpenSAF Foundation
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. This file and program are licensed
+ * under the GNU Lesser General Public License Version 2.1, February 1999.
+ * The complete license can be accessed from the following location:
+ * http://opensource.org/licenses/lgpl-license.php
+ * See the Copying file included with the OpenSAF distribution for full
+ * licensing terms.
+ *
+ */
+
+/*****************************************************************************
+
+  DESCRIPTION:
+
+  This file contains the amfnd side of the shared memory healthcheck
+  heartbeats, see amf_hcshm.h.
+
+  A healthcheck started by a process on this node gets a slot in the shared
+  memory. Once the agent has attached to the slot, the healthcheck is
+  checked in the shared memory instead of with its own timer and callback
+  messages. The checks are kept in an HcWheel, the AVND_TMR_HC_SHM timer is
+  started for the next due check. Each check either reports the same
+  component error as the timer and callback based healthcheck would have
+  done, or schedules the next check.
+
+******************************************************************************
+*/
+
+#include "amf/amfnd/avnd.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+#include "amf/amfnd/hcwheel.h"
+#include "amf/common/amf_hcshm.h"
+
+namespace {
+
+AMF_HCSHM *hcshm;
+AMF_HCSHM_BEATS *beats;
+uint32_t next_slot;
+std::vector<uint32_t> slot_hdl(AMF_HCSHM_SLOTS); /* hdl of the hc record */
+HcWheel wheel;
+AVND_TMR wheel_tmr;
+uint64_t wheel_tmr_due; /* time the wheel timer expires */
+
+AMF_HCSHM_SLOT *slot_of(const AVND_COMP_HC_REC *rec) {
+  return &hcshm->slot[rec->shm_slot - 1];
+}
+
+AMF_HCSHM_BEAT *beat_of(const AVND_COMP_HC_REC *rec) {
+  return &beats->beat[rec->shm_slot - 1];
+}
+
+/* (re)start the wheel timer for the next due check unless it expires
+ * before that already */
+void wheel_tmr_start(AVND_CB *cb, uint64_t now) {
+  uint64_t timeout = wheel.NextTimeout(now);
+  if (timeout == 0) return;
+  if (m_AVND_TMR_IS_ACTIVE(wheel_tmr) && wheel_tmr_due <= now + timeout)
+    return;
+
+  wheel_tmr_due = now + timeout;
+  avnd_start_tmr(cb, &wheel_tmr, AVND_TMR_HC_SHM, timeout, 0);
+}
+
+void schedule(AVND_CB *cb, AVND_COMP_HC_REC *rec, uint64_t deadline) {
+  uint64_t now = amf_hcshm_now();
+  rec->shm_tick = wheel.Schedule(rec->opq_hdl, deadline, now);
+  wheel_tmr_start(cb, now);
+}
+
+void deactivate(AVND_COMP_HC_REC *rec) {
+  rec->shm_active = false;
+  __atomic_store_n(&slot_of(rec)->active, 0, __ATOMIC_RELEASE);
+}
+
+void check(AVND_CB *cb, const HcWheel::Entry &entry, uint64_t now) {
+  AVND_COMP_HC_REC *rec = static_cast<AVND_COMP_HC_REC *>(
+      ncshm_take_hdl(NCS_SERVICE_ID_AVND, entry.id));
+  if (rec == nullptr) return;
+  ncshm_give_hdl(entry.id);
+
+  /* the hc has been rescheduled or stopped being checked since */
+  if (!rec->shm_active || rec->shm_tick != entry.tick) return;
+
+  AVND_COMP *comp = rec->comp;
+  AVND_ERR_INFO err_info;
+  uint64_t next;
+
+  /* same as at hc timer expiry */
+  if (!m_AVND_COMP_PRES_STATE_IS_INSTANTIATED(comp)) {
+    TRACE_1("'%s' not instantiated, not checking HC", comp->name.c_str());
+    deactivate(rec);
+    return;
+  }
+
+  switch (hcshm_check(*slot_of(rec), *beat_of(rec), rec->shm_since, now,
+                      &next)) {
+    case HcCheck::kOk:
+      schedule(cb, rec, next);
+      return;
+    case HcCheck::kTimeout:
+      if (rec->inv == SA_AMF_HEALTHCHECK_COMPONENT_INVOKED)
+        err_info.src = AVND_ERR_SRC_HC;
+      else
+        err_info.src = AVND_ERR_SRC_CBK_HC_TIMEOUT;
+      break;
+    case HcCheck::kFailed:
+      err_info.src = AVND_ERR_SRC_CBK_HC_FAILED;
+      break;
+  }
+
+  /* like the timer based hc, the failed hc is not checked any more */
+  deactivate(rec);
+  err_info.rec_rcvr.raw = rec->rec_rcvr.raw;
+  avnd_err_process(cb, comp, &err_info);
+}
+
+/* create and map one of the shared memories */
+void *shm_create(const char *name, size_t size, mode_t mode) {
+  shm_unlink(name);
+  int fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, mode);
+  if (fd < 0) {
+    LOG_WA("shm_open of %s failed: %s", name, strerror(errno));
+    return nullptr;
+  }
+
+  /* not restricted by the umask, the components may run as another user */
+  void *addr = MAP_FAILED;
+  if (fchmod(fd, mode) == 0 && ftruncate(fd, size) == 0)
+    addr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (addr == MAP_FAILED) {
+    LOG_WA("Setting up %s failed: %s", name, strerror(errno));
+    close(fd);
+    shm_unlink(name);
+    return nullptr;
+  }
+  close(fd);
+  return addr;
+}
+
+}  // namespace
+
+/****************************************************************************
+  Name          : avnd_hcshm_init
+
+  Description   : This routine creates the shared memories for the
+                  healthcheck heartbeats if AVND_HC_SHM is set to 1.
+
+  Arguments     : cb - ptr to the AvND control block
+
+  Return Values : None.
+
+  Notes         : Shared memories left by a previous amfnd are removed, the
+                  agents attached to them will not find their healthchecks
+                  in the new ones and use the messages.
+******************************************************************************/
+void avnd_hcshm_init(AVND_CB *cb) {
+  const char *val = getenv("AVND_HC_SHM");
+  if (val == nullptr || strcmp(val, "1") != 0) return;
+
+  /* the slots are read only to the agents */
+  beats = static_cast<AMF_HCSHM_BEATS *>(
+      shm_create(AMF_HCSHM_BEAT_NAME, sizeof(AMF_HCSHM_BEATS), 0660));
+  if (beats == nullptr) return;
+  hcshm = static_cast<AMF_HCSHM *>(
+      shm_create(AMF_HCSHM_NAME, sizeof(AMF_HCSHM), 0640));
+  if (hcshm == nullptr) {
+    munmap(beats, sizeof(AMF_HCSHM_BEATS));
+    shm_unlink(AMF_HCSHM_BEAT_NAME);
+    beats = nullptr;
+    return;
+  }
+
+  hcshm->hdr.version = AMF_HCSHM_VERSION;
+  hcshm->hdr.num_slots = AMF_HCSHM_SLOTS;
+  hcshm->hdr.slot_size = sizeof(AMF_HCSHM_SLOT);
+  hcshm->hdr.beat_size = sizeof(AMF_HCSHM_BEAT);
+  __atomic_store_n(&hcshm->hdr.magic, AMF_HCSHM_MAGIC, __ATOMIC_RELEASE);
+
+  wheel_tmr.type = AVND_TMR_HC_SHM;
+  LOG_NO("Shared memory healthchecks enabled, %u slots", AMF_HCSHM_SLOTS);
+}
+
+/****************************************************************************
+  Name          : avnd_hcshm_slot_alloc
+
+  Description   : This routine allocates a shared memory slot for a
+                  healthcheck started by a process on this node.
+
+  Arguments     : cb  - ptr to the AvND control block
+                  rec - ptr to the healthcheck record
+
+  Return Values : None.
+
+  Notes         : The slots are allocated round robin so that a freed slot
+                  is not reused before the agent has noticed that its
+                  generation changed. Without a free slot the healthcheck
+                  uses the messages.
+******************************************************************************/
+void avnd_hcshm_slot_alloc(AVND_CB *cb, AVND_COMP_HC_REC *rec) {
+  if (hcshm == nullptr ||
+      m_NCS_NODE_ID_FROM_MDS_DEST(rec->dest) != cb->node_info.nodeId)
+    return;
+
+  for (uint32_t i = 0; i < AMF_HCSHM_SLOTS; i++) {
+    uint32_t index = next_slot++ % AMF_HCSHM_SLOTS;
+    AMF_HCSHM_SLOT *slot = &hcshm->slot[index];
+    uint32_t gen = slot->gen;
+
+    if (gen & 1) continue;
+
+    slot->active = 0;
+    slot->dest = rec->dest;
+    slot->hdl = rec->req_hdl;
+    slot->period = rec->period;
+    slot->max_dur = rec->max_dur;
+    slot->comp_hash = amf_hcshm_hash(rec->comp->name.c_str());
+    slot->inv_type = rec->inv;
+    slot->key_len = rec->key.keyLen;
+    memcpy(slot->key, rec->key.key, sizeof(slot->key));
+    memset(&beats->beat[index], 0, sizeof(beats->beat[index]));
+    beats->beat[index].result = SA_AIS_OK;
+    __atomic_store_n(&slot->gen, gen + 1, __ATOMIC_RELEASE);
+
+    rec->shm_slot = index + 1;
+    slot_hdl[index] = rec->opq_hdl;
+    TRACE("'%s' HC slot %u", rec->comp->name.c_str(), index);
+    return;
+  }
+  TRACE("No free HC slot for '%s'", rec->comp->name.c_str());
+}
+
+/****************************************************************************
+  Name          : avnd_hcshm_slot_free
+
+  Description   : This routine frees the shared memory slot of a healthcheck.
+
+  Arguments     : cb  - ptr to the AvND control block
+                  rec - ptr to the healthcheck record
+
+  Return Values : None.
+
+  Notes         : The check in the timing wheel is dropped when it is due.
+******************************************************************************/
+void avnd_hcshm_slot_free(AVND_CB *cb, AVND_COMP_HC_REC *rec) {
+  if (rec->shm_slot == 0) return;
+
+  AMF_HCSHM_SLOT *slot = slot_of(rec);
+  slot->active = 0;
+  __atomic_store_n(&slot->gen, slot->gen + 1, __ATOMIC_RELEASE);
+  slot_hdl[rec->shm_slot - 1] = 0;
+  rec->shm_slot = 0;
+  rec->shm_active = false;
+}
+
+/****************************************************************************
+  Name          : avnd_hcshm_activate
+
+  Description   : This routine starts to check a healthcheck in the shared
+                  memory if the agent has attached to its slot. It is called
+                  instead of sending the next healthcheck callback or
+                  restarting the healthcheck timer.
+
+  Arguments     : cb  - ptr to the AvND control block
+                  rec - ptr to the healthcheck record
+
+  Return Values : true if the healthcheck is checked in the shared memory.
+
+  Notes         : None.
+******************************************************************************/
+bool avnd_hcshm_activate(AVND_CB *cb, AVND_COMP_HC_REC *rec) {
+  if (rec->shm_slot == 0) return false;
+
+  AMF_HCSHM_SLOT *slot = slot_of(rec);
+  if (__atomic_load_n(&beat_of(rec)->attached, __ATOMIC_ACQUIRE) != slot->gen)
+    return false;
+
+  if (!rec->shm_active)
+    TRACE("'%s' HC '%s' checked in shared memory", rec->comp->name.c_str(),
+          rec->key.key);
+
+  m_AVND_TMR_COMP_HC_STOP(cb, *rec);
+  rec->shm_active = true;
+  rec->shm_since = amf_hcshm_now();
+  __atomic_store_n(&slot->active, slot->gen, __ATOMIC_RELEASE);
+
+  if (rec->inv == SA_AMF_HEALTHCHECK_COMPONENT_INVOKED)
+    schedule(cb, rec, rec->shm_since + rec->period);
+  else
+    schedule(cb, rec, rec->shm_since + rec->period + rec->max_dur);
+  return true;
+}
+
+/****************************************************************************
+  Name          : avnd_hcshm_resp
+
+  Description   : This routine processes the response to a healthcheck
+                  callback that the agent invoked itself. Only a failed
+                  healthcheck is sent by the agent.
+
+  Arguments     : cb   - ptr to the AvND control block
+                  dest - mds dest of the sender
+                  resp - ptr to the response
+
+  Return Values : true if the response is to a callback invoked by the agent.
+
+  Notes         : The response is ignored unless it is from the process that
+                  started the healthcheck.
+******************************************************************************/
+bool avnd_hcshm_resp(AVND_CB *cb, MDS_DEST dest,
+                     const AVSV_AMF_RESP_PARAM *resp) {
+  if (!(resp->inv & AMF_HCSHM_INV_FLAG)) return false;
+
+  uint32_t index = AMF_HCSHM_INV_SLOT(resp->inv);
+  if (hcshm == nullptr || index >= AMF_HCSHM_SLOTS || slot_hdl[index] == 0)
+    return true;
+
+  AVND_COMP_HC_REC *rec = static_cast<AVND_COMP_HC_REC *>(
+      ncshm_take_hdl(NCS_SERVICE_ID_AVND, slot_hdl[index]));
+  if (rec == nullptr) return true;
+  ncshm_give_hdl(slot_hdl[index]);
+
+  /* already reported from the slot */
+  if (!rec->shm_active || resp->err == SA_AIS_OK) return true;
+
+  if (dest != rec->dest) {
+    LOG_WA("HC response for '%s' from %" PRIx64 " ignored",
+           rec->comp->name.c_str(), dest);
+    return true;
+  }
+
+  TRACE("'%s' HC '%s' failed: %u", rec->comp->name.c_str(), rec->key.key,
+        resp->err);
+  deactivate(rec);
+
+  AVND_ERR_INFO err_info;
+  err_info.src = AVND_ERR_SRC_CBK_HC_FAILED;
+  err_info.rec_rcvr.raw = rec->rec_rcvr.raw;
+  avnd_err_process(cb, rec->comp, &err_info);
+  return true;
+}
+
+/****************************************************************************
+  Name          : avnd_evt_tmr_hc_shm_evh
+
+  Description   : This routine processes the shared memory healthcheck timer
+                  expiry, it does the checks that are due.
+
+  Arguments     : cb  - ptr to the AvND control block
+                  evt - ptr to the AvND event
+
+  Return Values : NCSCC_RC_SUCCESS/NCSCC_RC_FAILURE
+
+  Notes         : None.
+******************************************************************************/
+uint32_t avnd_evt_tmr_hc_shm_evh(AVND_CB *cb, AVND_EVT *evt) {
+  uint64_t now = amf_hcshm_now();
+  TRACE_ENTER2("%zu checks", wheel.size());
+
+  for (const auto &entry : wheel.Expire(now)) check(cb, entry, now);
+  wheel_tmr_start(cb, now);
+
+  TRACE_LEAVE();
+  return NCSCC_RC_SUCCESS;
+}
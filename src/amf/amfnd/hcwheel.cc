@@ -0,0 +1,107 @@
+/*      -*- OpenSAF  -*-
+ *
+ * (C) Copyright 2017 The OpenSAF Foundation
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. This file and program are licensed
+ * under the GNU Lesser General Public License Version 2.1, February 1999.
+ * The complete license can be accessed from the following location:
+ * http://opensource.org/licenses/lgpl-license.php
+ * See the Copying file included with the OpenSAF distribution for full
+ * licensing terms.
+ *
+ */
+
+#include "amf/amfnd/hcwheel.h"
+#include <algorithm>
+
+uint64_t HcWheel::Schedule(uint32_t id, uint64_t deadline, uint64_t now) {
+  uint64_t tick = deadline / kTick + 1;
+
+  if (count_ == 0) tick_ = now / kTick;
+  if (tick <= tick_) tick = tick_ + 1;
+
+  buckets_[tick % kSize].push_back({id, tick});
+  count_++;
+  return tick;
+}
+
+std::vector<HcWheel::Entry> HcWheel::Expire(uint64_t now) {
+  uint64_t now_tick = now / kTick;
+  std::vector<Entry> due;
+
+  if (now_tick <= tick_) return due;
+
+  // after a long stop, a full turn of the wheel finds all the due checks
+  if (now_tick - tick_ > kSize) tick_ = now_tick - kSize;
+
+  while (tick_ < now_tick && count_ > due.size()) {
+    std::vector<Entry> &bucket = buckets_[++tick_ % kSize];
+    for (size_t i = 0; i < bucket.size();) {
+      if (bucket[i].tick <= tick_) {
+        due.push_back(bucket[i]);
+        bucket[i] = bucket.back();
+        bucket.pop_back();
+      } else {
+        i++;
+      }
+    }
+  }
+  tick_ = now_tick;
+  count_ -= due.size();
+
+  std::stable_sort(due.begin(), due.end(), [](const Entry &a, const Entry &b) {
+    return a.tick < b.tick;
+  });
+  return due;
+}
+
+uint64_t HcWheel::NextTimeout(uint64_t now) const {
+  if (count_ == 0) return 0;
+
+  uint64_t next = UINT64_MAX;
+  for (const auto &bucket : buckets_)
+    for (const auto &entry : bucket) next = std::min(next, entry.tick);
+
+  // whole ticks, the ncs timers would otherwise expire before the tick
+  uint64_t due = next * kTick;
+  if (due <= now) return kTick;
+  return (due - now + kTick - 1) / kTick * kTick;
+}
+
+HcCheck hcshm_check(const AMF_HCSHM_SLOT &slot, const AMF_HCSHM_BEAT &beat,
+                    uint64_t since, uint64_t now, uint64_t *next) {
+  if (slot.inv_type == SA_AMF_HEALTHCHECK_COMPONENT_INVOKED) {
+    uint64_t last = __atomic_load_n(&beat.beat_time, __ATOMIC_ACQUIRE);
+    if (last < since) last = since;
+    if (now - last < slot.period) {
+      *next = last + slot.period;
+      return HcCheck::kOk;
+    }
+    return HcCheck::kTimeout;
+  }
+
+  uint32_t responded = __atomic_load_n(&beat.responded, __ATOMIC_ACQUIRE);
+  uint32_t invoked = __atomic_load_n(&beat.invoked, __ATOMIC_ACQUIRE);
+  uint64_t last = __atomic_load_n(&beat.invoke_time, __ATOMIC_RELAXED);
+
+  if (__atomic_load_n(&beat.result, __ATOMIC_RELAXED) != SA_AIS_OK)
+    return HcCheck::kFailed;
+
+  if (invoked != responded) {
+    if (now - last < slot.max_dur) {
+      *next = last + slot.max_dur;
+      return HcCheck::kOk;
+    }
+    return HcCheck::kTimeout;
+  }
+
+  // the agent must invoke the next callback within the period
+  if (last < since) last = since;
+  if (now - last < slot.period + slot.max_dur) {
+    *next = last + slot.period + slot.max_dur;
+    return HcCheck::kOk;
+  }
+  return HcCheck::kTimeout;
+}
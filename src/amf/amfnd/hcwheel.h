@@ -0,0 +1,66 @@
+/*      -*- OpenSAF  -*-
+ *
+ * (C) Copyright 2017 The OpenSAF Foundation
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. This file and program are licensed
+ * under the GNU Lesser General Public License Version 2.1, February 1999.
+ * The complete license can be accessed from the following location:
+ * http://opensource.org/licenses/lgpl-license.php
+ * See the Copying file included with the OpenSAF distribution for full
+ * licensing terms.
+ *
+ */
+
+#ifndef AMF_AMFND_HCWHEEL_H_
+#define AMF_AMFND_HCWHEEL_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "amf/common/amf_hcshm.h"
+
+// Timing wheel of the checks of the shared memory healthchecks, see
+// hcshm.cc. The times are amf_hcshm_now() nanoseconds, a check is due in
+// the first tick after its deadline.
+class HcWheel {
+ public:
+  // The resolution of the ncs timers
+  static constexpr uint64_t kTick = 10 * 1000 * 1000;
+  static constexpr size_t kSize = 512;
+
+  struct Entry {
+    uint32_t id;    // hdl of the healthcheck record
+    uint64_t tick;  // tick of the check
+  };
+
+  HcWheel() : buckets_(kSize) {}
+
+  // Schedules a check of id, returns its tick. A deadline that has passed
+  // is checked in the next tick.
+  uint64_t Schedule(uint32_t id, uint64_t deadline, uint64_t now);
+
+  // Removes and returns the checks due at now, earliest first
+  std::vector<Entry> Expire(uint64_t now);
+
+  // Time from now to the next due check, 0 without checks
+  uint64_t NextTimeout(uint64_t now) const;
+
+  size_t size() const { return count_; }
+
+ private:
+  std::vector<std::vector<Entry>> buckets_;
+  uint64_t tick_{0};  // last tick expired
+  size_t count_{0};
+};
+
+// The outcome of a check of a healthcheck slot
+enum class HcCheck { kOk, kTimeout, kFailed };
+
+// Checks a healthcheck that has been checked in the shared memory since
+// "since". With kOk, *next is set to the deadline of the next check.
+HcCheck hcshm_check(const AMF_HCSHM_SLOT &slot, const AMF_HCSHM_BEAT &beat,
+                    uint64_t since, uint64_t now, uint64_t *next);
+
+#endif  // AMF_AMFND_HCWHEEL_H_
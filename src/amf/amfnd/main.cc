@@ -124,7 +124,8 @@ extern const AVND_EVT_HDLR g_avnd_func_list[AVND_EVT_MAX] = {
     avnd_evt_pid_exit_evh,        /* AVND_EVT_PID_EXIT */
     avnd_evt_tmr_qscing_cmpl_evh, /* AVND_EVT_TMR_QSCING_CMPL */
     avnd_evt_ir_evh,              /* AVND_EVT_IR */
-    avnd_amfa_mds_info_evh        /* AVND_EVT_AMFA_MDS_VER_INFO*/
+    avnd_amfa_mds_info_evh,       /* AVND_EVT_AMFA_MDS_VER_INFO*/
+    avnd_evt_tmr_hc_shm_evh       /* AVND_EVT_TMR_HC_SHM */
 };
 
 extern struct ImmutilWrapperProfile immutilWrapperProfile;
@@ -311,6 +312,8 @@ AVND_CB *avnd_cb_create() {
     }
   }
 
+  avnd_hcshm_init(cb);
+
   /* initialize the PID monitor lock */
   m_NCS_LOCK_INIT(&cb->mon_lock);
 
@@ -23,6 +23,12 @@
   This module deals with the creation, accessing and deletion of the passive
   monitoring records and lists on the AVND.
 
+  A monitored process is watched through a pidfd in an epoll set, the
+  monitoring thread wakes up as soon as the process exits. Processes that
+  can not be opened as a pidfd, e.g. on kernels older than 5.3, are checked
+  with kill() every AVND_PM_MONITORING_RATE milli secs as before. See
+  pidmon.h.
+
 ..............................................................................
 
   FUNCTIONS INCLUDED in this file:
@@ -34,6 +40,8 @@
 #include "avnd_mon.h"
 
 #include <sched.h>
+#include "amf/amfnd/pidmon.h"
+#include "base/osaf_time.h"
 /*****************************************************************************
  * structure for holding PID monitoring node                                 *
  *****************************************************************************/
@@ -41,15 +49,22 @@ typedef struct avnd_mon_req_tag {
   NCS_DB_LINK_LIST_NODE mon_dll_node; /* key is pid */
   SaUint64T pid;                      /* pid that is being monitored (index) */
   AVND_COMP_PM_REC *pm_rec;           /* ptr to comp pm rec */
+  PidWatch watch;                     /* pidfd or polling of the pid */
 } AVND_MON_REQ;
 
 /* Passive Monitoring time interval in milli secs */
 #define AVND_PM_MONITORING_INTERVAL 1000
 
+/* Max number of pidfd events handled per wake up */
+#define AVND_PM_MAX_EVENTS 64
+
 NCSCONTEXT gl_avnd_mon_task_hdl = 0;
 static uint32_t avnd_send_pid_exit_evt(AVND_CB *cb, AVND_COMP_PM_REC *pm_rec);
 static void avnd_mon_pids(AVND_CB *cb);
 
+/* pidfds of the monitored PIDs */
+static PidMonitor *avnd_pid_monitor;
+
 uint32_t gl_avnd_hdl;
 
 /****************************************************************************
@@ -70,6 +85,8 @@ void avnd_pid_mon_list_init(AVND_CB *cb) {
   pid_mon_list->order = NCS_DBLIST_ANY_ORDER;
   pid_mon_list->cmp_cookie = avsv_dblist_uns64_cmp;
   pid_mon_list->free_cookie = avnd_mon_req_free;
+
+  avnd_pid_monitor = new PidMonitor();
 }
 
 /****************************************************************************
@@ -101,6 +118,7 @@ AVND_MON_REQ *avnd_mon_req_add(AVND_CB *cb, AVND_COMP_PM_REC *pm_rec) {
     mon_req = new AVND_MON_REQ();
 
     mon_req->pid = pm_rec->pid;
+    mon_req->watch.pid = pm_rec->pid;
 
     /* update the record key */
     mon_req->mon_dll_node.key = (uint8_t *)&mon_req->pid;
@@ -110,6 +128,11 @@ AVND_MON_REQ *avnd_mon_req_add(AVND_CB *cb, AVND_COMP_PM_REC *pm_rec) {
       m_NCS_UNLOCK(&cb->mon_lock, NCS_LOCK_WRITE);
       goto done;
     }
+    avnd_pid_monitor->Watch(&mon_req->watch);
+  } else if (mon_req->watch.exited) {
+    /* the PID has been reused by a new process */
+    mon_req->watch.exited = false;
+    avnd_pid_monitor->Watch(&mon_req->watch);
   }
 
   /* update the params */
@@ -193,7 +216,10 @@ uint32_t avnd_mon_req_del(AVND_CB *cb, SaUint64T pid) {
 uint32_t avnd_mon_req_free(NCS_DB_LINK_LIST_NODE *node) {
   AVND_MON_REQ *mon_req = (AVND_MON_REQ *)node;
 
-  if (mon_req) delete mon_req;
+  if (mon_req) {
+    PidMonitor::Unwatch(&mon_req->watch);
+    delete mon_req;
+  }
 
   return NCSCC_RC_SUCCESS;
 }
@@ -283,8 +309,9 @@ uint32_t avnd_send_pid_exit_evt(AVND_CB *cb, AVND_COMP_PM_REC *pm_rec) {
   Name          : avnd_mon_pids
 
   Description   : This routine traverses through the list of PIDs to be
-                  monitored & checks their existence in the system/node. Sends
-                  an event to AVND thread if PID doesn't exists.
+                  monitored & checks the existence of those without a pidfd
+                  in the system/node. Sends an event to AVND thread if PID
+                  doesn't exists.
 
   Arguments     : cb - ptr to AVND control block
 
@@ -312,19 +339,51 @@ void avnd_mon_pids(AVND_CB *cb) {
       continue;
     }
 
-    switch (kill(mon_rec->pid, 0)) {
-      case 0:
-        break;
+    if (!PidMonitor::Poll(mon_rec->watch)) continue;
 
-      case EPERM:
-        LOG_ER("PM not able send signal to PID: %lld", mon_rec->pid);
-        break;
+    /* process died */
+    if (avnd_send_pid_exit_evt(cb, mon_rec->pm_rec) == NCSCC_RC_SUCCESS)
+      mon_rec->watch.exited = true;
+  }
 
-      case ESRCH: /* process died */
-      default:
-        avnd_send_pid_exit_evt(cb, mon_rec->pm_rec);
-        break;
-    }
+  m_NCS_UNLOCK(&cb->mon_lock, NCS_LOCK_WRITE);
+}
+
+/****************************************************************************
+  Name          : avnd_mon_exited
+
+  Description   : This routine sends an event to AVND thread for each
+                  monitored process whose pidfd became readable, i.e. the
+                  process exited.
+
+  Arguments     : cb - ptr to AVND control block
+                  events - the events returned by epoll_wait
+                  num_events - number of events
+
+  Return Values :
+
+  Notes         : A record deleted, or reopened for a new process, after the
+                  events were returned does not match the event and is
+                  skipped.
+******************************************************************************/
+static void avnd_mon_exited(AVND_CB *cb, const struct epoll_event *events,
+                            int num_events) {
+  AVND_MON_REQ *mon_rec;
+
+  m_NCS_LOCK(&cb->mon_lock, NCS_LOCK_WRITE);
+
+  for (int i = 0; i < num_events; i++) {
+    SaUint64T pid = PidMonitor::EventPid(events[i]);
+
+    mon_rec = (AVND_MON_REQ *)ncs_db_link_list_find(&cb->pid_mon_list,
+                                                    (uint8_t *)&pid);
+    if (mon_rec == nullptr || mon_rec->pm_rec == nullptr ||
+        !PidMonitor::Exited(&mon_rec->watch, events[i]))
+      continue;
+
+    /* the PID is polled if the send fails */
+    if (avnd_send_pid_exit_evt(cb, mon_rec->pm_rec) == NCSCC_RC_SUCCESS)
+      mon_rec->watch.exited = true;
   }
 
   m_NCS_UNLOCK(&cb->mon_lock, NCS_LOCK_WRITE);
@@ -351,9 +410,32 @@ void avnd_mon_process(void *arg) {
   else
     mon_rate = AVND_PM_MONITORING_INTERVAL;
 
+  if (!avnd_pid_monitor->pidfd_supported()) {
+    while (1) {
+      avnd_mon_pids(avnd_cb);
+      m_NCS_TASK_SLEEP(mon_rate);
+    }
+  }
+
+  struct epoll_event events[AVND_PM_MAX_EVENTS];
+  struct timespec next_poll;
+  osaf_set_millis_timeout(mon_rate, &next_poll);
+
   while (1) {
-    avnd_mon_pids(avnd_cb);
-    m_NCS_TASK_SLEEP(mon_rate);
+    int num_events =
+        avnd_pid_monitor->Wait(events, AVND_PM_MAX_EVENTS, mon_rate);
+    if (num_events > 0) {
+      avnd_mon_exited(avnd_cb, events, num_events);
+    } else if (num_events == -1 && errno != EINTR) {
+      LOG_ER("epoll_wait failed: %s", strerror(errno));
+      m_NCS_TASK_SLEEP(mon_rate);
+    }
+
+    /* PIDs without a pidfd are still polled at the monitoring rate */
+    if (osaf_is_timeout(&next_poll)) {
+      avnd_mon_pids(avnd_cb);
+      osaf_set_millis_timeout(mon_rate, &next_poll);
+    }
   }
 }
 
@@ -0,0 +1,115 @@
+/*      -*- OpenSAF  -*-
+ *
+ * (C) Copyright 2017 The OpenSAF Foundation
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. This file and program are licensed
+ * under the GNU Lesser General Public License Version 2.1, February 1999.
+ * The complete license can be accessed from the following location:
+ * http://opensource.org/licenses/lgpl-license.php
+ * See the Copying file included with the OpenSAF distribution for full
+ * licensing terms.
+ *
+ */
+
+#include "amf/amfnd/pidmon.h"
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include "base/logtrace.h"
+
+PidMonitor::PidMonitor() {
+  epfd_ = epoll_create1(EPOLL_CLOEXEC);
+  if (epfd_ == -1) {
+    LOG_WA("epoll_create1 failed: %s, PIDs will be polled", strerror(errno));
+    pidfd_supported_ = false;
+  }
+}
+
+PidMonitor::~PidMonitor() {
+  if (epfd_ != -1) close(epfd_);
+}
+
+int PidMonitor::OpenPidfd(pid_t pid) {
+#ifdef __NR_pidfd_open
+  return syscall(__NR_pidfd_open, pid, 0);
+#else
+  errno = ENOSYS;
+  return -1;
+#endif
+}
+
+void PidMonitor::Watch(PidWatch *watch) {
+  struct epoll_event event;
+
+  Unwatch(watch);
+  if (!pidfd_supported_) return;
+
+  int fd = OpenPidfd(watch->pid);
+  if (fd == -1) {
+    if (errno == ENOSYS) {
+      LOG_NO("pidfd not supported, PIDs will be polled");
+      pidfd_supported_ = false;
+    } else {
+      TRACE_1("pidfd_open failed for PID: %d: %s, polled", watch->pid,
+              strerror(errno));
+    }
+    return;
+  }
+
+  watch->gen = ++gen_;
+  event.events = EPOLLIN;
+  event.data.u64 = (static_cast<uint64_t>(watch->gen) << 32) |
+                   static_cast<uint32_t>(watch->pid);
+  if (epoll_ctl(epfd_, EPOLL_CTL_ADD, fd, &event) == -1) {
+    LOG_WA("epoll_ctl failed for PID: %d: %s, polled", watch->pid,
+           strerror(errno));
+    close(fd);
+    return;
+  }
+  watch->pidfd = fd;
+}
+
+void PidMonitor::Unwatch(PidWatch *watch) {
+  if (watch->pidfd == -1) return;
+  close(watch->pidfd);
+  watch->pidfd = -1;
+}
+
+int PidMonitor::Wait(struct epoll_event *events, int max_events,
+                     int timeout_ms) {
+  if (epfd_ == -1) {
+    errno = ENOSYS;
+    return -1;
+  }
+  return epoll_wait(epfd_, events, max_events, timeout_ms);
+}
+
+pid_t PidMonitor::EventPid(const struct epoll_event &event) {
+  return static_cast<uint32_t>(event.data.u64);
+}
+
+bool PidMonitor::Exited(PidWatch *watch, const struct epoll_event &event) {
+  uint32_t gen = event.data.u64 >> 32;
+
+  if (watch->pidfd == -1 || watch->gen != gen ||
+      watch->pid != EventPid(event))
+    return false;
+  Unwatch(watch);
+  return true;
+}
+
+bool PidMonitor::Poll(const PidWatch &watch) {
+  if (watch.pidfd != -1 || watch.exited) return false;
+
+  if (kill(watch.pid, 0) == 0) return false;
+
+  if (errno == EPERM) {
+    LOG_ER("PM not able send signal to PID: %d", watch.pid);
+    return false;
+  }
+  return true;
+}
@@ -0,0 +1,77 @@
+/*      -*- OpenSAF  -*-
+ *
+ * (C) Copyright 2017 The OpenSAF Foundation
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. This file and program are licensed
+ * under the GNU Lesser General Public License Version 2.1, February 1999.
+ * The complete license can be accessed from the following location:
+ * http://opensource.org/licenses/lgpl-license.php
+ * See the Copying file included with the OpenSAF distribution for full
+ * licensing terms.
+ *
+ */
+
+#ifndef AMF_AMFND_PIDMON_H_
+#define AMF_AMFND_PIDMON_H_
+
+#include <sys/epoll.h>
+#include <sys/types.h>
+#include <cstdint>
+
+// The monitoring state of one passively monitored PID, see mon.cc
+struct PidWatch {
+  pid_t pid{0};
+  int pidfd{-1};        // pidfd in the epoll set, -1 if polled
+  uint32_t gen{0};      // tells a reopened pidfd of the same pid apart
+  bool exited{false};   // exit event sent to the AvND thread
+};
+
+// Detects the exit of monitored processes. A PID is watched through a
+// pidfd in an epoll set when the kernel allows it, otherwise it is left to
+// be checked with kill() by Poll(). The caller serializes the calls.
+class PidMonitor {
+ public:
+  PidMonitor();
+  virtual ~PidMonitor();
+
+  // Opens a pidfd for watch->pid, a watch that already has one is
+  // reopened. The PID is polled if the pidfd can not be opened.
+  void Watch(PidWatch *watch);
+
+  // Stops watching the pidfd, closing it removes it from the epoll set
+  static void Unwatch(PidWatch *watch);
+
+  // Waits up to timeout_ms for exited processes, returns the number of
+  // events, 0 on timeout or -1 on error. Returns -1 with errno ENOSYS
+  // without an epoll set.
+  int Wait(struct epoll_event *events, int max_events, int timeout_ms);
+
+  // The PID of an event returned by Wait()
+  static pid_t EventPid(const struct epoll_event &event);
+
+  // True if event tells that the process of watch exited. An event of a
+  // pidfd that was closed, or reopened for a reused PID, is ignored. The
+  // pidfd stays readable, so it is closed and a later failure to report the
+  // exit is left to Poll().
+  static bool Exited(PidWatch *watch, const struct epoll_event &event);
+
+  // True if the process of a polled watch is gone. EPERM means that the
+  // process exists. False for a watch with a pidfd or an exit that has been
+  // reported.
+  static bool Poll(const PidWatch &watch);
+
+  bool pidfd_supported() const { return pidfd_supported_; }
+
+ protected:
+  // pidfd_open(2), overridden by the tests
+  virtual int OpenPidfd(pid_t pid);
+
+ private:
+  int epfd_{-1};
+  bool pidfd_supported_{true};
+  uint32_t gen_{0};
+};
+
+#endif  // AMF_AMFND_PIDMON_H_
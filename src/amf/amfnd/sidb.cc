@@ -1019,6 +1019,8 @@ AVND_SU_SIQ_REC *avnd_su_siq_rec_add(AVND_CB *cb, AVND_SU *su,
 
   /* memory transferred to the siq-rec.. nullify it in param */
   param->list = 0;
+  /* further operations in the message are not part of this one */
+  siq->info.next = nullptr;
 
   TRACE_LEAVE();
   return siq;
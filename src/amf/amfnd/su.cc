@@ -34,6 +34,7 @@
 
 #include "base/logtrace.h"
 #include "amf/amfnd/avnd.h"
+#include "amf/common/amf_fotrace.h"
 #include "osaf/immutil/immutil.h"
 
 static uint32_t avnd_avd_su_update_on_fover(AVND_CB *cb,
@@ -349,22 +350,25 @@ done:
 }
 
 /****************************************************************************
-  Name          : avnd_evt_avd_info_su_si_assign_msg
+  Name          : avnd_su_si_assign_prc
 
-  Description   : This routine processes the SU-SI assignment message from
-                  AvD. It buffers the message if already some assignment is on.
-                  Else it initiates SI addition, deletion or removal.
+  Description   : This routine processes one SU-SI operation of a SU-SI
+                  assignment message from AvD. It buffers the operation if
+                  already some assignment is on. Else it initiates SI
+                  addition, deletion or removal.
 
-  Arguments     : cb  - ptr to the AvND control block
-                  evt - ptr to the AvND event
+  Arguments     : cb          - ptr to the AvND control block
+                  msg_fmt_ver - format version of the message
+                  info        - ptr to the SU-SI operation
+                  msg_id_rcvd - set when the message id has been taken
 
   Return Values : NCSCC_RC_SUCCESS/NCSCC_RC_FAILURE
 
   Notes         : None.
 ******************************************************************************/
-uint32_t avnd_evt_avd_info_su_si_assign_evh(AVND_CB *cb, AVND_EVT *evt) {
-  AVSV_D2N_INFO_SU_SI_ASSIGN_MSG_INFO *info =
-      &evt->info.avd->msg_info.d2n_su_si_assign;
+static uint32_t avnd_su_si_assign_prc(AVND_CB *cb, uint16_t msg_fmt_ver,
+                                      AVND_SU_SI_PARAM *info,
+                                      bool *msg_id_rcvd) {
   AVND_SU_SIQ_REC *siq = 0;
   AVND_SU *su = 0;
   uint32_t rc = NCSCC_RC_SUCCESS;
@@ -397,14 +401,17 @@ uint32_t avnd_evt_avd_info_su_si_assign_evh(AVND_CB *cb, AVND_EVT *evt) {
     }
   }
 
-  avnd_msgid_assert(info->msg_id);
-  cb->rcv_msg_id = info->msg_id;
+  if (*msg_id_rcvd == false) {
+    avnd_msgid_assert(info->msg_id);
+    cb->rcv_msg_id = info->msg_id;
+    *msg_id_rcvd = true;
+  }
 
   if (info->msg_act == AVSV_SUSI_ACT_ASGN) {
     /* SI rank and CSI capability (originally from SaAmfCtCsType)
      * was introduced in version 5 of the node director supported protocol.
      * If the protocol is older, take action */
-    if (evt->msg_fmt_ver < 5) {
+    if (msg_fmt_ver < 5) {
       AVSV_SUSI_ASGN *csi;
 
       /* indicate that capability is invalid for later use when
@@ -466,6 +473,44 @@ done:
   return rc;
 }
 
+/****************************************************************************
+  Name          : avnd_evt_avd_info_su_si_assign_msg
+
+  Description   : This routine processes the SU-SI assignment message from
+                  AvD. From version 8 the message may carry several SU-SI
+                  operations for this node, they are processed in order as
+                  if each was received in a message of its own.
+
+  Arguments     : cb  - ptr to the AvND control block
+                  evt - ptr to the AvND event
+
+  Return Values : NCSCC_RC_SUCCESS/NCSCC_RC_FAILURE
+
+  Notes         : None.
+******************************************************************************/
+uint32_t avnd_evt_avd_info_su_si_assign_evh(AVND_CB *cb, AVND_EVT *evt) {
+  AVSV_D2N_INFO_SU_SI_ASSIGN_MSG_INFO *info =
+      &evt->info.avd->msg_info.d2n_su_si_assign;
+  bool msg_id_rcvd = false;
+  uint32_t rc = NCSCC_RC_SUCCESS;
+
+  TRACE_ENTER2("%u", info->msg_id);
+
+  for (AVND_SU_SI_PARAM *op = info; op != nullptr; op = op->next) {
+    op->msg_id = info->msg_id;
+    op->node_id = info->node_id;
+    AMF_FOTRACE(AMF_FOTRACE_ND_RCV, "corr=%x:%u su=%s si=%s act=%u ha=%u",
+                op->node_id, op->msg_id, amf_fotrace_name(&op->su_name),
+                amf_fotrace_name(&op->si_name), op->msg_act, op->ha_state);
+    if (avnd_su_si_assign_prc(cb, evt->msg_fmt_ver, op, &msg_id_rcvd) !=
+        NCSCC_RC_SUCCESS)
+      rc = NCSCC_RC_FAILURE;
+  }
+
+  TRACE_LEAVE2("%u", rc);
+  return rc;
+}
+
 /****************************************************************************
   Name          : avnd_evt_tmr_su_err_esc
 
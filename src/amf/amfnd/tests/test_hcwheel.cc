@@ -0,0 +1,198 @@
+/*      -*- OpenSAF  -*-
+ *
+ * (C) Copyright 2017 The OpenSAF Foundation
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. This file and program are licensed
+ * under the GNU Lesser General Public License Version 2.1, February 1999.
+ * The complete license can be accessed from the following location:
+ * http://opensource.org/licenses/lgpl-license.php
+ * See the Copying file included with the OpenSAF distribution for full
+ * licensing terms.
+ *
+ */
+
+#include <vector>
+#include "amf/amfnd/hcwheel.h"
+#include "gtest/gtest.h"
+
+namespace {
+
+const uint64_t kTick = HcWheel::kTick;
+const uint64_t kMs = 1000 * 1000;
+// an arbitrary start time, not on a tick
+const uint64_t kStart = 1000 * kTick + 3 * kMs;
+
+std::vector<uint32_t> Ids(const std::vector<HcWheel::Entry> &entries) {
+  std::vector<uint32_t> ids;
+  for (const auto &entry : entries) ids.push_back(entry.id);
+  return ids;
+}
+
+TEST(HcWheelTest, CheckIsDueInTheTickAfterTheDeadline) {
+  HcWheel wheel;
+  uint64_t deadline = kStart + 25 * kMs;
+  uint64_t tick = wheel.Schedule(1, deadline, kStart);
+
+  EXPECT_EQ(tick, deadline / kTick + 1);
+  EXPECT_EQ(wheel.size(), 1u);
+  EXPECT_TRUE(wheel.Expire(deadline).empty());
+  EXPECT_TRUE(wheel.Expire(tick * kTick - 1).empty());
+
+  std::vector<HcWheel::Entry> due = wheel.Expire(tick * kTick);
+  ASSERT_EQ(due.size(), 1u);
+  EXPECT_EQ(due[0].id, 1u);
+  EXPECT_EQ(due[0].tick, tick);
+  EXPECT_EQ(wheel.size(), 0u);
+}
+
+TEST(HcWheelTest, PassedDeadlineIsDueInTheNextTick) {
+  HcWheel wheel;
+  EXPECT_EQ(wheel.Schedule(1, kStart - kTick, kStart), kStart / kTick + 1);
+  EXPECT_EQ(Ids(wheel.Expire(kStart + kTick)), std::vector<uint32_t>({1}));
+}
+
+TEST(HcWheelTest, ExpiresEarliestFirst) {
+  HcWheel wheel;
+  wheel.Schedule(1, kStart + 50 * kMs, kStart);
+  wheel.Schedule(2, kStart + 20 * kMs, kStart);
+  wheel.Schedule(3, kStart + 300 * kMs, kStart);
+  wheel.Schedule(4, kStart + 40 * kMs, kStart);
+
+  EXPECT_EQ(Ids(wheel.Expire(kStart + 60 * kMs)),
+            std::vector<uint32_t>({2, 4, 1}));
+  EXPECT_EQ(wheel.size(), 1u);
+  EXPECT_EQ(Ids(wheel.Expire(kStart + 310 * kMs)),
+            std::vector<uint32_t>({3}));
+}
+
+TEST(HcWheelTest, ChecksMoreThanATurnAhead) {
+  HcWheel wheel;
+  uint64_t turn = HcWheel::kSize * kTick;
+  wheel.Schedule(1, kStart + turn + 5 * kTick, kStart);
+
+  // the bucket of the check is passed once before it is due
+  EXPECT_TRUE(wheel.Expire(kStart + 10 * kTick).empty());
+  EXPECT_TRUE(wheel.Expire(kStart + turn).empty());
+  EXPECT_EQ(Ids(wheel.Expire(kStart + turn + 7 * kTick)),
+            std::vector<uint32_t>({1}));
+}
+
+TEST(HcWheelTest, LongStopExpiresAllDueChecks) {
+  HcWheel wheel;
+  wheel.Schedule(1, kStart + 30 * kMs, kStart);
+  wheel.Schedule(2, kStart + 2 * kTick * HcWheel::kSize, kStart);
+  wheel.Schedule(3, kStart + 10 * kMs, kStart);
+
+  EXPECT_EQ(Ids(wheel.Expire(kStart + 5 * kTick * HcWheel::kSize)),
+            std::vector<uint32_t>({3, 1, 2}));
+  EXPECT_EQ(wheel.size(), 0u);
+}
+
+TEST(HcWheelTest, NextTimeoutIsInWholeTicks) {
+  HcWheel wheel;
+  EXPECT_EQ(wheel.NextTimeout(kStart), 0u);
+
+  uint64_t tick = wheel.Schedule(1, kStart + 95 * kMs, kStart);
+  wheel.Schedule(2, kStart + 500 * kMs, kStart);
+  uint64_t timeout = wheel.NextTimeout(kStart);
+
+  EXPECT_EQ(timeout % kTick, 0u);
+  EXPECT_GE(kStart + timeout, tick * kTick);
+  EXPECT_LT(kStart + timeout, tick * kTick + kTick);
+  // a check already due is done in the next tick
+  EXPECT_EQ(wheel.NextTimeout(tick * kTick + kMs), kTick);
+}
+
+const uint64_t kPeriod = 100 * kMs;
+const uint64_t kMaxDur = 30 * kMs;
+
+class HcCheckTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    slot_ = AMF_HCSHM_SLOT();
+    slot_.period = kPeriod;
+    slot_.max_dur = kMaxDur;
+    beat_ = AMF_HCSHM_BEAT();
+    beat_.result = SA_AIS_OK;
+  }
+
+  HcCheck Check(uint64_t now) {
+    next_ = 0;
+    return hcshm_check(slot_, beat_, kStart, now, &next_);
+  }
+
+  AMF_HCSHM_SLOT slot_;
+  AMF_HCSHM_BEAT beat_;
+  uint64_t next_;
+};
+
+TEST_F(HcCheckTest, ComponentInvokedBeatWithinPeriod) {
+  slot_.inv_type = SA_AMF_HEALTHCHECK_COMPONENT_INVOKED;
+
+  // no beat yet, the period counts from the start of the checks
+  EXPECT_EQ(Check(kStart + 50 * kMs), HcCheck::kOk);
+  EXPECT_EQ(next_, kStart + kPeriod);
+
+  beat_.beat = 1;
+  beat_.beat_time = kStart + 80 * kMs;
+  EXPECT_EQ(Check(kStart + kPeriod), HcCheck::kOk);
+  EXPECT_EQ(next_, beat_.beat_time + kPeriod);
+}
+
+TEST_F(HcCheckTest, ComponentInvokedTimeout) {
+  slot_.inv_type = SA_AMF_HEALTHCHECK_COMPONENT_INVOKED;
+  EXPECT_EQ(Check(kStart + kPeriod), HcCheck::kTimeout);
+
+  // a beat from before the checks started does not count
+  beat_.beat_time = kStart - kMs;
+  EXPECT_EQ(Check(kStart + kPeriod), HcCheck::kTimeout);
+
+  beat_.beat_time = kStart + 10 * kMs;
+  EXPECT_EQ(Check(kStart + 10 * kMs + kPeriod), HcCheck::kTimeout);
+}
+
+TEST_F(HcCheckTest, AmfInvokedResponded) {
+  slot_.inv_type = SA_AMF_HEALTHCHECK_AMF_INVOKED;
+  beat_.invoked = beat_.responded = 3;
+  beat_.invoke_time = kStart + 20 * kMs;
+
+  EXPECT_EQ(Check(kStart + 50 * kMs), HcCheck::kOk);
+  EXPECT_EQ(next_, beat_.invoke_time + kPeriod + kMaxDur);
+}
+
+TEST_F(HcCheckTest, AmfInvokedPendingWithinMaxDuration) {
+  slot_.inv_type = SA_AMF_HEALTHCHECK_AMF_INVOKED;
+  beat_.invoked = 4;
+  beat_.responded = 3;
+  beat_.invoke_time = kStart + 20 * kMs;
+
+  EXPECT_EQ(Check(beat_.invoke_time + kMaxDur - 1), HcCheck::kOk);
+  EXPECT_EQ(next_, beat_.invoke_time + kMaxDur);
+}
+
+TEST_F(HcCheckTest, AmfInvokedTimeout) {
+  slot_.inv_type = SA_AMF_HEALTHCHECK_AMF_INVOKED;
+
+  // no response within the max duration
+  beat_.invoked = 1;
+  beat_.invoke_time = kStart + 20 * kMs;
+  EXPECT_EQ(Check(beat_.invoke_time + kMaxDur), HcCheck::kTimeout);
+
+  // no callback invoked within the period
+  beat_.responded = 1;
+  EXPECT_EQ(Check(beat_.invoke_time + kPeriod + kMaxDur), HcCheck::kTimeout);
+}
+
+TEST_F(HcCheckTest, AmfInvokedFailedResult) {
+  slot_.inv_type = SA_AMF_HEALTHCHECK_AMF_INVOKED;
+  beat_.invoked = beat_.responded = 1;
+  beat_.invoke_time = kStart + 20 * kMs;
+  beat_.result = SA_AIS_ERR_FAILED_OPERATION;
+
+  // reported at once, even though the period has not expired
+  EXPECT_EQ(Check(kStart + 30 * kMs), HcCheck::kFailed);
+}
+
+}  // namespace
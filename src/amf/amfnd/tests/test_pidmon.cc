@@ -0,0 +1,309 @@
+/*      -*- OpenSAF  -*-
+ *
+ * (C) Copyright 2017 The OpenSAF Foundation
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. This file and program are licensed
+ * under the GNU Lesser General Public License Version 2.1, February 1999.
+ * The complete license can be accessed from the following location:
+ * http://opensource.org/licenses/lgpl-license.php
+ * See the Copying file included with the OpenSAF distribution for full
+ * licensing terms.
+ *
+ */
+
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <ctime>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "amf/amfnd/pidmon.h"
+#include "gtest/gtest.h"
+
+namespace {
+
+// A monitor on a kernel without pidfd_open
+class PolledPidMonitor : public PidMonitor {
+ protected:
+  int OpenPidfd(pid_t) override {
+    errno = ENOSYS;
+    return -1;
+  }
+};
+
+// Starts a child that waits to be killed
+pid_t StartChild() {
+  pid_t pid = fork();
+  if (pid == 0) {
+    for (;;) pause();
+  }
+  return pid;
+}
+
+void KillChild(pid_t pid) {
+  kill(pid, SIGKILL);
+  waitpid(pid, nullptr, 0);
+}
+
+class PidMonitorTest : public ::testing::Test {
+ protected:
+  void SetUp() override { ASSERT_TRUE(monitor_.pidfd_supported()); }
+
+  // Waits for the events of exited processes
+  std::vector<struct epoll_event> Wait(int timeout_ms) {
+    std::vector<struct epoll_event> events(16);
+    int n = monitor_.Wait(events.data(), events.size(), timeout_ms);
+    events.resize(std::max(n, 0));
+    return events;
+  }
+
+  PidMonitor monitor_;
+};
+
+TEST_F(PidMonitorTest, DetectsAKilledProcessThroughItsPidfd) {
+  PidWatch watch;
+  watch.pid = StartChild();
+  monitor_.Watch(&watch);
+  ASSERT_NE(watch.pidfd, -1);
+
+  EXPECT_TRUE(Wait(0).empty());
+  // a watched PID is left to the pidfd
+  EXPECT_FALSE(PidMonitor::Poll(watch));
+
+  kill(watch.pid, SIGKILL);
+  std::vector<struct epoll_event> events = Wait(5000);
+  ASSERT_EQ(events.size(), 1u);
+  EXPECT_EQ(PidMonitor::EventPid(events[0]), watch.pid);
+  EXPECT_TRUE(PidMonitor::Exited(&watch, events[0]));
+  EXPECT_EQ(watch.pidfd, -1);
+  EXPECT_TRUE(Wait(0).empty());
+  waitpid(watch.pid, nullptr, 0);
+}
+
+TEST_F(PidMonitorTest, PollsWhenPidfdOpenIsNotSupported) {
+  PolledPidMonitor monitor;
+  PidWatch watch;
+  watch.pid = StartChild();
+  monitor.Watch(&watch);
+  EXPECT_EQ(watch.pidfd, -1);
+  EXPECT_FALSE(monitor.pidfd_supported());
+
+  EXPECT_FALSE(PidMonitor::Poll(watch));
+  KillChild(watch.pid);
+  EXPECT_TRUE(PidMonitor::Poll(watch));
+}
+
+TEST_F(PidMonitorTest, PollsAProcessThatExitedBeforeItWasWatched) {
+  PidWatch watch;
+  watch.pid = StartChild();
+  KillChild(watch.pid);
+
+  monitor_.Watch(&watch);
+  EXPECT_EQ(watch.pidfd, -1);
+  EXPECT_TRUE(monitor_.pidfd_supported());
+  EXPECT_TRUE(PidMonitor::Poll(watch));
+}
+
+TEST_F(PidMonitorTest, IgnoresTheEventOfAReopenedPidfd) {
+  PidWatch watch;
+  watch.pid = StartChild();
+  monitor_.Watch(&watch);
+  kill(watch.pid, SIGKILL);
+  std::vector<struct epoll_event> stale = Wait(5000);
+  ASSERT_EQ(stale.size(), 1u);
+
+  // the record is reopened for the same PID before the event is handled,
+  // the zombie of the child can still be opened
+  watch.exited = false;
+  monitor_.Watch(&watch);
+  ASSERT_NE(watch.pidfd, -1);
+  EXPECT_FALSE(PidMonitor::Exited(&watch, stale[0]));
+  EXPECT_NE(watch.pidfd, -1);
+
+  std::vector<struct epoll_event> events = Wait(5000);
+  ASSERT_EQ(events.size(), 1u);
+  EXPECT_TRUE(PidMonitor::Exited(&watch, events[0]));
+  waitpid(watch.pid, nullptr, 0);
+}
+
+TEST_F(PidMonitorTest, ReportsAnExitOnce) {
+  PidWatch watch;
+  watch.pid = StartChild();
+  monitor_.Watch(&watch);
+  kill(watch.pid, SIGKILL);
+  std::vector<struct epoll_event> events = Wait(5000);
+  ASSERT_EQ(events.size(), 1u);
+  EXPECT_TRUE(PidMonitor::Exited(&watch, events[0]));
+  EXPECT_FALSE(PidMonitor::Exited(&watch, events[0]));
+  waitpid(watch.pid, nullptr, 0);
+
+  // the exit event was sent, as mon.cc marks it
+  watch.exited = true;
+  EXPECT_FALSE(PidMonitor::Poll(watch));
+
+  // a send that failed is retried by polling until it succeeds
+  watch.exited = false;
+  EXPECT_TRUE(PidMonitor::Poll(watch));
+  EXPECT_TRUE(PidMonitor::Poll(watch));
+}
+
+TEST_F(PidMonitorTest, ProcessOfAnotherUserIsNotDead) {
+  // kill() of init fails with EPERM for an unprivileged process
+  pid_t pid = fork();
+  if (pid == 0) {
+    if (getuid() == 0 && setuid(65534) == -1) _exit(2);
+    if (kill(1, 0) == 0 || errno != EPERM) _exit(2);
+    PidWatch watch;
+    watch.pid = 1;
+    _exit(PidMonitor::Poll(watch) ? 1 : 0);
+  }
+  int status;
+  ASSERT_EQ(waitpid(pid, &status, 0), pid);
+  ASSERT_TRUE(WIFEXITED(status));
+  EXPECT_NE(WEXITSTATUS(status), 2) << "no EPERM from kill()";
+  EXPECT_EQ(WEXITSTATUS(status), 0);
+}
+
+// Detection latency and idle CPU of the monitoring thread of AMFND, see
+// avnd_mon_process() in mon.cc, with 4000 monitored processes. Run with
+//   bin/testamfnd --gtest_also_run_disabled_tests --gtest_filter='*Bench*'
+class PidMonitorBench : public ::testing::Test {
+ protected:
+  static constexpr int kChildren = 4000;
+  static constexpr int kRateMs = 1000;
+  static constexpr int kKills = 5;
+
+  using Clock = std::chrono::steady_clock;
+
+  void SetUp() override {
+    getrlimit(RLIMIT_NOFILE, &saved_limit_);
+    struct rlimit limit = saved_limit_;
+    limit.rlim_cur = std::min<rlim_t>(2 * kChildren, limit.rlim_max);
+    setrlimit(RLIMIT_NOFILE, &limit);
+
+    for (int i = 0; i < kChildren; i++) {
+      pid_t pid = StartChild();
+      ASSERT_GT(pid, 0);
+      children_.push_back(pid);
+    }
+  }
+
+  void TearDown() override {
+    for (pid_t pid : children_) KillChild(pid);
+    setrlimit(RLIMIT_NOFILE, &saved_limit_);
+  }
+
+  static double ThreadCpuMs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return ts.tv_sec * 1e3 + ts.tv_nsec / 1e6;
+  }
+
+  // Runs the loop of avnd_mon_process() until the deadline, recording the
+  // time each process is detected dead
+  void Monitor(PidMonitor *monitor, Clock::time_point until) {
+    struct epoll_event events[64];
+    Clock::time_point next_poll = Clock::now();
+
+    while (Clock::now() < until) {
+      if (monitor->pidfd_supported()) {
+        int n = monitor->Wait(events, 64, kRateMs);
+        for (int i = 0; i < n; i++) {
+          PidWatch &watch = watches_[index_[PidMonitor::EventPid(events[i])]];
+          if (PidMonitor::Exited(&watch, events[i])) Detected(&watch);
+        }
+      } else {
+        std::this_thread::sleep_for(next_poll - Clock::now());
+      }
+      if (Clock::now() >= next_poll) {
+        for (PidWatch &watch : watches_) {
+          if (PidMonitor::Poll(watch)) Detected(&watch);
+        }
+        next_poll += std::chrono::milliseconds(kRateMs);
+      }
+    }
+  }
+
+  void Detected(PidWatch *watch) {
+    watch->exited = true;
+    std::lock_guard<std::mutex> lock(mutex_);
+    detected_[watch->pid] = Clock::now();
+  }
+
+  void Run(PidMonitor *monitor, const char *name) {
+    watches_.assign(children_.size(), PidWatch());
+    for (size_t i = 0; i < children_.size(); i++) {
+      watches_[i].pid = children_[i];
+      index_[children_[i]] = i;
+      monitor->Watch(&watches_[i]);
+    }
+
+    // idle, nothing exits
+    double cpu = ThreadCpuMs();
+    Monitor(monitor, Clock::now() + std::chrono::seconds(3));
+    double idle_ms = (ThreadCpuMs() - cpu) / 3;
+
+    // kill a few, out of step with the monitoring rate
+    std::map<pid_t, Clock::time_point> killed;
+    std::thread killer([&] {
+      for (int i = 0; i < kKills; i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(730));
+        pid_t pid = children_[i * 797];
+        std::lock_guard<std::mutex> lock(mutex_);
+        killed[pid] = Clock::now();
+        KillChild(pid);
+      }
+    });
+    Monitor(monitor, Clock::now() +
+                         std::chrono::milliseconds(730 * kKills + 2 * kRateMs));
+    killer.join();
+
+    double sum_us = 0, max_us = 0;
+    for (const auto &kill : killed) {
+      ASSERT_EQ(detected_.count(kill.first), 1u);
+      double us = std::chrono::duration<double, std::micro>(
+                      detected_[kill.first] - kill.second)
+                      .count();
+      sum_us += us;
+      max_us = std::max(max_us, us);
+    }
+    printf("%s, %d processes, %d ms rate: idle %.2f ms CPU/s, detection "
+           "avg %.0f us, max %.0f us\n",
+           name, kChildren, kRateMs, idle_ms, sum_us / kKills, max_us);
+
+    for (PidWatch &watch : watches_) PidMonitor::Unwatch(&watch);
+    for (const auto &kill : killed) {
+      children_.erase(
+          std::find(children_.begin(), children_.end(), kill.first));
+    }
+  }
+
+  std::vector<pid_t> children_;
+  std::vector<PidWatch> watches_;
+  std::map<pid_t, size_t> index_;
+  std::map<pid_t, Clock::time_point> detected_;
+  std::mutex mutex_;
+  struct rlimit saved_limit_;
+};
+
+TEST_F(PidMonitorBench, DISABLED_Pidfd) {
+  PidMonitor monitor;
+  ASSERT_TRUE(monitor.pidfd_supported());
+  Run(&monitor, "pidfd + epoll");
+}
+
+TEST_F(PidMonitorBench, DISABLED_KillPolling) {
+  PolledPidMonitor monitor;
+  Run(&monitor, "kill() polling");
+}
+
+}  // namespace
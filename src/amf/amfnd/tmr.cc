@@ -38,6 +38,7 @@ static const char *tmr_type[] = {"out of range",
                                  "HB tmr",
                                  "SC absence timer",
                                  "Qscing Complete",
+                                 "shared memory health check timer",
                                  "AVND_TMR_MAX"};
 
 /*****************************************************************************
@@ -149,6 +150,8 @@ void avnd_tmr_exp(void *uarg) {
     /* determine the event type */
     if (AVND_TMR_QSCING_CMPL_RESP == tmr->type) {
       type = AVND_EVT_TMR_QSCING_CMPL;
+    } else if (AVND_TMR_HC_SHM == tmr->type) {
+      type = AVND_EVT_TMR_HC_SHM;
     } else {
       type = static_cast<AVND_EVT_TYPE>((tmr->type - AVND_TMR_HC) +
                                         AVND_EVT_TMR_HC);
@@ -52,6 +52,7 @@ extern "C" {
 #define AVSV_AVD_AVND_MSG_FMT_VER_5 5
 #define AVSV_AVD_AVND_MSG_FMT_VER_6 6
 #define AVSV_AVD_AVND_MSG_FMT_VER_7 7
+#define AVSV_AVD_AVND_MSG_FMT_VER_8 8
 
 /* Internode/External Components Validation result */
 typedef enum {
@@ -569,6 +570,10 @@ typedef struct avsv_d2n_info_su_si_assign_msg_info_tag {
   uint32_t num_assigns;
   AVSV_SUSI_ASGN *list;
   uint32_t si_rank;
+  /* From version 8, further SU-SI operations for the same node sent in
+   * this message. They are processed in list order after this one and
+   * share its msg_id and node_id. */
+  struct avsv_d2n_info_su_si_assign_msg_info_tag *next;
 } AVSV_D2N_INFO_SU_SI_ASSIGN_MSG_INFO;
 
 typedef struct avsv_d2n_pg_track_act_rsp_msg_info_tag {
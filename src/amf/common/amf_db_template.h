@@ -20,6 +20,7 @@
 #include "base/osaf_extended_name.h"
 #include <map>
 #include <string>
+#include <unordered_map>
 #include "osaf/saf/saAis.h"
 #include "base/ncsgl_defs.h"
 
@@ -88,6 +89,11 @@ class AmfDb {
   const_iterator cbegin() const { return db.cbegin(); }
   const_iterator cend() const { return db.cend(); }
 
+  // first entry not less than key, to walk the entries of a key prefix
+  const_iterator lower_bound(const Key &key) const {
+    return db.lower_bound(key);
+  }
+
  private:
   AmfDbMap db;
 };
@@ -144,4 +150,46 @@ T *AmfDb<Key, T>::findNext(const Key &key) {
   }
 }
 
+// AmfDb indexed by a hash table, for the databases that are looked up by
+// name a lot and never need to be iterated in name order (no findNext).
+template <typename Key, typename T>
+class AmfHashDb {
+ public:
+  unsigned int insert(const Key &key, T *obj) {
+    osafassert(obj);
+    if (db.insert(std::make_pair(key, obj)).second)
+      return 1;  // NCSCC_RC_SUCCESS
+    else
+      return 2;  // Duplicate (NCSCC_RC_FAILURE)
+  }
+  void erase(const Key &key) { db.erase(key); }
+  void deleteAll() {
+    for (const auto &it : db) delete it.second;
+    db.clear();
+  }
+  T *find(const Key &key) {
+    typename AmfDbMap::iterator it = db.find(key);
+    return (it == db.end()) ? nullptr : it->second;
+  }
+
+  typedef std::unordered_map<Key, T *> AmfDbMap;
+  typedef typename AmfDbMap::const_iterator const_iterator;
+  typedef typename AmfDbMap::iterator iterator;
+
+  const_iterator begin() const { return db.begin(); }
+  const_iterator end() const { return db.end(); }
+  typename AmfDbMap::size_type size() const { return db.size(); }
+
+  iterator erase(const iterator &it) { return db.erase(it); }
+
+  iterator begin() { return db.begin(); }
+  iterator end() { return db.end(); }
+
+  const_iterator cbegin() const { return db.cbegin(); }
+  const_iterator cend() const { return db.cend(); }
+
+ private:
+  AmfDbMap db;
+};
+
 #endif  // AMF_COMMON_AMF_DB_TEMPLATE_H_
@@ -0,0 +1,75 @@
+/*      -*- OpenSAF  -*-
+ *
+ * (C) Copyright 2017 The OpenSAF Foundation
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. This file and program are licensed
+ * under the GNU Lesser General Public License Version 2.1, February 1999.
+ * The complete license can be accessed from the following location:
+ * http://opensource.org/licenses/lgpl-license.php
+ * See the Copying file included with the OpenSAF distribution for full
+ * licensing terms.
+ *
+ */
+
+/*****************************************************************************
+
+  DESCRIPTION:
+
+  Failover trace of the SI assignment phases. When the environment variable
+  OSAF_AMF_FAILOVER_TRACE is set to 1 in amfd, amfnd or an AMF application,
+  each phase of an SI assignment is logged to syslog as one line:
+
+    amf-fotrace phase=<phase> ts=<sec>.<usec> <key>=<value> ...
+
+  The time stamp is CLOCK_REALTIME so that the lines from different nodes
+  can be merged. The phases are correlated with the ids already carried in
+  the messages, "corr=<node id>:<msg id>" for the SU-SI message from amfd
+  and its response from amfnd, and "inv=<invocation>" for the callback from
+  amfnd to the component and its response. The amf-failover-trace tool
+  collects the lines and reports the latency of each phase.
+
+******************************************************************************
+*/
+
+#ifndef AMF_COMMON_AMF_FOTRACE_H_
+#define AMF_COMMON_AMF_FOTRACE_H_
+
+#include <stdbool.h>
+#include "osaf/saf/saAis.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Phases of an SI assignment */
+#define AMF_FOTRACE_ND_DETECT "nd_detect" /* amfnd detected a comp error */
+#define AMF_FOTRACE_D_DETECT "d_detect"   /* amfd detected a node leaving */
+#define AMF_FOTRACE_D_SEND "d_send"       /* amfd sent the SU-SI message */
+#define AMF_FOTRACE_ND_RCV "nd_rcv"       /* amfnd received the SU-SI op */
+#define AMF_FOTRACE_ND_CBK "nd_cbk"       /* amfnd sent the CSI callback */
+#define AMF_FOTRACE_AVA_CBK "ava_cbk"     /* agent invoked the CSI callback */
+#define AMF_FOTRACE_AVA_RSP "ava_rsp"     /* component responded */
+#define AMF_FOTRACE_ND_CBK_RSP "nd_cbk_rsp" /* amfnd got the response */
+#define AMF_FOTRACE_ND_RSP "nd_rsp"       /* amfnd sent the SU-SI response */
+#define AMF_FOTRACE_D_RSP "d_rsp"         /* amfd received the response */
+
+extern bool amf_fotrace_enabled(void);
+extern const char *amf_fotrace_name(const SaNameT *name);
+extern void amf_fotrace(const char *phase, const char *format, ...)
+    __attribute__((format(printf, 2, 3)));
+
+/* Log a phase only when the failover trace is enabled */
+#define AMF_FOTRACE(phase, ...)                         \
+  do {                                                  \
+    if (amf_fotrace_enabled()) {                        \
+      amf_fotrace(phase, __VA_ARGS__);                  \
+    }                                                   \
+  } while (0)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // AMF_COMMON_AMF_FOTRACE_H_
@@ -0,0 +1,147 @@
+/*      -*- OpenSAF  -*-
+ *
+ * (C) Copyright 2017 The OpenSAF Foundation
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. This file and program are licensed
+ * under the GNU Lesser General Public License Version 2.1, February 1999.
+ * The complete license can be accessed from the following location:
+ * http://opensource.org/licenses/lgpl-license.php
+ * See the Copying file included with the OpenSAF distribution for full
+ * licensing terms.
+ *
+ */
+
+/*****************************************************************************
+
+  DESCRIPTION:
+
+  Shared memory healthcheck heartbeats between the AMF agent and amfnd.
+
+  When AVND_HC_SHM is set to 1 in amfnd.conf, amfnd creates the shared
+  memory AMF_HCSHM_NAME with one slot per healthcheck started by a process
+  on the node, and AMF_HCSHM_BEAT_NAME with one beat per slot. The slots
+  are written by amfnd only, the agents map them read only so that a
+  process cannot change the healthchecks of another. The agent in the
+  process that started a healthcheck attaches to its slot, one with the
+  mds dest of the process, by writing the generation of the slot to the
+  beat of the slot. From then on:
+
+  - a component invoked healthcheck is confirmed by the agent updating
+    beat and beat_time instead of sending a confirm message to amfnd.
+
+  - an AMF invoked healthcheck is invoked by the agent itself every period,
+    the agent updates invoked and invoke_time when it queues the callback
+    and responded, and result for a failed healthcheck, when the component
+    responds. The invocation of the callback has AMF_HCSHM_INV_FLAG and the
+    slot index set, so that a failed response can still be sent to amfnd.
+    amfnd only takes such a response from the mds dest of the slot.
+
+  amfnd checks the slots of all healthchecks from one timing wheel instead
+  of one timer and one callback message per healthcheck and period. It
+  starts to check a slot, and sets active to the generation of the slot,
+  at the time it would otherwise have sent the next callback or restarted
+  the timer, so that the agent and amfnd never both drive the healthcheck.
+  A failed confirm or response is still sent to amfnd as a message, for the
+  component error to be reported without delay. Agents that do not
+  attach, e.g. of an older release or in a process not allowed to open the
+  shared memory, keep using the messages.
+
+  The time stamps are CLOCK_MONOTONIC in nanoseconds. Each field is written
+  by one side only and accessed with the __atomic builtins.
+
+******************************************************************************
+*/
+
+#ifndef AMF_COMMON_AMF_HCSHM_H_
+#define AMF_COMMON_AMF_HCSHM_H_
+
+#include <stdint.h>
+#include <time.h>
+#include "amf/saf/saAmf.h"
+#include "base/osaf_time.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define AMF_HCSHM_NAME "/opensaf_amf_hc"           /* read only to agents */
+#define AMF_HCSHM_BEAT_NAME "/opensaf_amf_hc_beat" /* written by agents */
+#define AMF_HCSHM_MAGIC 0x41484353                 /* "AHCS" */
+#define AMF_HCSHM_VERSION 2
+#define AMF_HCSHM_SLOTS 1024
+
+/* invocation of a healthcheck callback invoked by the agent, amfnd uses its
+ * 32 bit handles as invocations */
+#define AMF_HCSHM_INV_FLAG 0x8000000000000000ULL
+#define AMF_HCSHM_INV(slot, seq) \
+  (AMF_HCSHM_INV_FLAG | ((uint64_t)(slot) << 32) | (uint32_t)(seq))
+#define AMF_HCSHM_INV_SLOT(inv) \
+  ((uint32_t)(((inv) & ~AMF_HCSHM_INV_FLAG) >> 32))
+
+typedef struct amf_hcshm_hdr {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t num_slots;
+  uint32_t slot_size;
+  uint32_t beat_size;
+} AMF_HCSHM_HDR;
+
+/* written by amfnd */
+typedef struct amf_hcshm_slot {
+  uint32_t gen;       /* odd while in use, bumped at alloc and free */
+  uint32_t active;    /* gen while amfnd checks the slot */
+  uint64_t dest;      /* mds dest of the process that started the hc */
+  uint64_t hdl;       /* AMF handle */
+  uint64_t period;    /* healthcheck period */
+  uint64_t max_dur;   /* healthcheck max duration */
+  uint32_t comp_hash; /* amf_hcshm_hash() of the comp name */
+  uint32_t inv_type;  /* SaAmfHealthcheckInvocationT */
+  uint16_t key_len;
+  uint8_t key[SA_AMF_HEALTHCHECK_KEY_MAX];
+  uint8_t pad[6];
+} AMF_HCSHM_SLOT;
+
+/* written by the agent attached to the slot of the same index */
+typedef struct amf_hcshm_beat {
+  uint32_t attached;    /* gen the agent attached to */
+  uint32_t result;      /* SaAisErrorT of a failed AMF invoked hc */
+  uint64_t beat;        /* number of component invoked confirms */
+  uint64_t beat_time;   /* time of the last confirm */
+  uint32_t invoked;     /* number of AMF invoked callbacks queued */
+  uint32_t responded;   /* number of responses to them */
+  uint64_t invoke_time; /* time of the last callback */
+} AMF_HCSHM_BEAT;
+
+typedef struct amf_hcshm {
+  AMF_HCSHM_HDR hdr;
+  uint8_t pad[64 - sizeof(AMF_HCSHM_HDR)];
+  AMF_HCSHM_SLOT slot[AMF_HCSHM_SLOTS];
+} AMF_HCSHM;
+
+typedef struct amf_hcshm_beats {
+  AMF_HCSHM_BEAT beat[AMF_HCSHM_SLOTS];
+} AMF_HCSHM_BEATS;
+
+/* FNV-1a hash of a comp name, to tell the slots of proxied comps apart */
+static inline uint32_t amf_hcshm_hash(const char *name) {
+  uint32_t hash = 2166136261u;
+  while (*name) {
+    hash ^= (uint8_t)*name++;
+    hash *= 16777619u;
+  }
+  return hash;
+}
+
+static inline uint64_t amf_hcshm_now(void) {
+  struct timespec ts;
+  osaf_clock_gettime(CLOCK_MONOTONIC, &ts);
+  return osaf_timespec_to_nanos(&ts);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // AMF_COMMON_AMF_HCSHM_H_
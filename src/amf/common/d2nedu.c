@@ -60,6 +60,7 @@ uint32_t avsv_edp_dnd_msg(EDU_HDL *hdl, EDU_TKN *edu_tkn, NCSCONTEXT ptr,
 	uint16_t ver3 = AVSV_AVD_AVND_MSG_FMT_VER_3;
 	uint16_t ver5 = AVSV_AVD_AVND_MSG_FMT_VER_5;
 	uint16_t ver6 = AVSV_AVD_AVND_MSG_FMT_VER_6;
+	uint16_t ver8 = AVSV_AVD_AVND_MSG_FMT_VER_8;
 
 	EDU_INST_SET avsv_dnd_msg_rules[] = {
 	    {EDU_START, avsv_edp_dnd_msg, 0, 0, 0, sizeof(AVSV_DND_MSG), 0,
@@ -292,10 +293,17 @@ uint32_t avsv_edp_dnd_msg(EDU_HDL *hdl, EDU_TKN *edu_tkn, NCSCONTEXT ptr,
 	    {EDU_EXEC, ncs_edp_uns32, 0, 0, 0,
 	     (long)&((AVSV_DND_MSG *)0)->msg_info.d2n_su_si_assign.num_assigns,
 	     0, NULL},
-	    {EDU_EXEC, avsv_edp_susi_asgn, EDQ_POINTER, 0, EDU_EXIT,
+	    {EDU_EXEC, avsv_edp_susi_asgn, EDQ_POINTER, 0, 0,
 	     (long)&((AVSV_DND_MSG *)0)->msg_info.d2n_su_si_assign.list, 0,
 	     NULL},
 
+	    /* Include further SU-SI operations in version 8 and higher */
+	    {EDU_VER_GE, NULL, 0, 0, EDU_EXIT, 0, 0,
+	     (EDU_EXEC_RTINE)((uint16_t *)(&(ver8)))},
+	    {EDU_EXEC, avsv_edp_su_si_assign_info, EDQ_POINTER, 0, EDU_EXIT,
+	     (long)&((AVSV_DND_MSG *)0)->msg_info.d2n_su_si_assign.next, 0,
+	     NULL},
+
 	    /* AVSV_D2N_PG_TRACK_ACT_RSP_MSG_INFO */
 	    {EDU_EXEC, ncs_edp_uns32, 0, 0, 0,
 	     (long)&((AVSV_DND_MSG *)0)
@@ -610,23 +618,23 @@ int avsv_dnd_msg_test_type_fnc(NCSCONTEXT arg)
 	       LCL_JMP_OFFSET_AVSV_D2N_REG_SU_MSG = 52,
 	       LCL_JMP_OFFSET_AVSV_D2N_REG_COMP_MSG = 57,
 	       LCL_JMP_OFFSET_AVSV_D2N_INFO_SU_SI_ASSIGN_MSG = 62,
-	       LCL_JMP_OFFSET_AVSV_D2N_PG_TRACK_ACT_RSP_MSG = 74,
-	       LCL_JMP_OFFSET_AVSV_D2N_PG_UPD_MSG = 81,
-	       LCL_JMP_OFFSET_AVSV_D2N_OPERATION_REQUEST_MSG = 85,
-	       LCL_JMP_OFFSET_AVSV_D2N_PRESENCE_SU_MSG = 88,
-	       LCL_JMP_OFFSET_AVSV_D2N_DATA_VERIFY_MSG = 92,
-	       LCL_JMP_OFFSET_AVSV_D2N_DATA_ACK_MSG = 97,
-	       LCL_JMP_OFFSET_AVSV_D2N_SHUTDOWN_APP_SU_MSG = 99,
-	       LCL_JMP_OFFSET_AVSV_D2N_SET_LEDS_MSG = 101,
-	       LCL_JMP_OFFSET_AVSV_N2D_COMP_VALID_MSG = 103,
-	       LCL_JMP_OFFSET_AVSV_D2N_COMP_VALID_RESP_MSG = 111,
-	       LCL_JMP_OFFSET_AVSV_D2N_ROLE_CHANGE_MSG = 115,
-	       LCL_JMP_OFFSET_AVSV_D2N_ADMIN_OP_REQ_MSG = 118,
-	       LCL_JMP_OFFSET_AVSV_D2N_HEARTBEAT_MSG = 122,
-	       LCL_JMP_OFFSET_AVSV_D2N_REBOOT_MSG = 123,
-	       LCL_JMP_OFFSET_AVSV_N2D_ND_SISU_STATE_INFO_MSG = 125,
-	       LCL_JMP_OFFSET_AVSV_N2D_ND_CSICOMP_STATE_INFO_MSG = 131,
-	       LCL_JMP_OFFSET_AVSV_D2N_COMPCSI_ASSIGN_MSG = 137 };
+	       LCL_JMP_OFFSET_AVSV_D2N_PG_TRACK_ACT_RSP_MSG = 76,
+	       LCL_JMP_OFFSET_AVSV_D2N_PG_UPD_MSG = 83,
+	       LCL_JMP_OFFSET_AVSV_D2N_OPERATION_REQUEST_MSG = 87,
+	       LCL_JMP_OFFSET_AVSV_D2N_PRESENCE_SU_MSG = 90,
+	       LCL_JMP_OFFSET_AVSV_D2N_DATA_VERIFY_MSG = 94,
+	       LCL_JMP_OFFSET_AVSV_D2N_DATA_ACK_MSG = 99,
+	       LCL_JMP_OFFSET_AVSV_D2N_SHUTDOWN_APP_SU_MSG = 101,
+	       LCL_JMP_OFFSET_AVSV_D2N_SET_LEDS_MSG = 103,
+	       LCL_JMP_OFFSET_AVSV_N2D_COMP_VALID_MSG = 105,
+	       LCL_JMP_OFFSET_AVSV_D2N_COMP_VALID_RESP_MSG = 113,
+	       LCL_JMP_OFFSET_AVSV_D2N_ROLE_CHANGE_MSG = 117,
+	       LCL_JMP_OFFSET_AVSV_D2N_ADMIN_OP_REQ_MSG = 120,
+	       LCL_JMP_OFFSET_AVSV_D2N_HEARTBEAT_MSG = 124,
+	       LCL_JMP_OFFSET_AVSV_D2N_REBOOT_MSG = 125,
+	       LCL_JMP_OFFSET_AVSV_N2D_ND_SISU_STATE_INFO_MSG = 127,
+	       LCL_JMP_OFFSET_AVSV_N2D_ND_CSICOMP_STATE_INFO_MSG = 133,
+	       LCL_JMP_OFFSET_AVSV_D2N_COMPCSI_ASSIGN_MSG = 139 };
 	AVSV_DND_MSG_TYPE type;
 
 	if (arg == NULL)
@@ -1040,6 +1048,82 @@ uint32_t avsv_edp_susi_asgn(EDU_HDL *hdl, EDU_TKN *edu_tkn, NCSCONTEXT ptr,
 				 ptr_data_len, buf_env, op, o_err);
 	return rc;
 }
+
+/*****************************************************************************
+
+  PROCEDURE NAME:   avsv_edp_su_si_assign_info
+
+  DESCRIPTION:      EDU program handler for the further SU-SI operations,
+		    "AVSV_D2N_INFO_SU_SI_ASSIGN_MSG_INFO" data, carried in a
+		    SU-SI assign message. This function is invoked by EDU for
+		    performing encode/decode operation on them.
+
+  RETURNS:          NCSCC_RC_SUCCESS/NCSCC_RC_FAILURE
+
+*****************************************************************************/
+uint32_t avsv_edp_su_si_assign_info(EDU_HDL *hdl, EDU_TKN *edu_tkn,
+				    NCSCONTEXT ptr, uint32_t *ptr_data_len,
+				    EDU_BUF_ENV *buf_env, EDP_OP_TYPE op,
+				    EDU_ERR *o_err)
+{
+	uint32_t rc = NCSCC_RC_SUCCESS;
+	AVSV_D2N_INFO_SU_SI_ASSIGN_MSG_INFO *struct_ptr = NULL, **d_ptr = NULL;
+
+	EDU_INST_SET avsv_su_si_assign_info_rules[] = {
+	    {EDU_START, avsv_edp_su_si_assign_info, EDQ_LNKLIST, 0, 0,
+	     sizeof(AVSV_D2N_INFO_SU_SI_ASSIGN_MSG_INFO), 0, NULL},
+
+	    {EDU_EXEC, ncs_edp_int, 0, 0, 0,
+	     (long)&((AVSV_D2N_INFO_SU_SI_ASSIGN_MSG_INFO *)0)->msg_act, 0,
+	     NULL},
+	    {EDU_EXEC, ncs_edp_sanamet, 0, 0, 0,
+	     (long)&((AVSV_D2N_INFO_SU_SI_ASSIGN_MSG_INFO *)0)->su_name, 0,
+	     NULL},
+	    {EDU_EXEC, ncs_edp_sanamet, 0, 0, 0,
+	     (long)&((AVSV_D2N_INFO_SU_SI_ASSIGN_MSG_INFO *)0)->si_name, 0,
+	     NULL},
+	    {EDU_EXEC, ncs_edp_uns32, 0, 0, 0,
+	     (long)&((AVSV_D2N_INFO_SU_SI_ASSIGN_MSG_INFO *)0)->si_rank, 0,
+	     NULL},
+	    {EDU_EXEC, m_NCS_EDP_SAAMFHASTATET, 0, 0, 0,
+	     (long)&((AVSV_D2N_INFO_SU_SI_ASSIGN_MSG_INFO *)0)->ha_state, 0,
+	     NULL},
+	    {EDU_EXEC, ncs_edp_ncs_bool, 0, 0, 0,
+	     (long)&((AVSV_D2N_INFO_SU_SI_ASSIGN_MSG_INFO *)0)->single_csi, 0,
+	     NULL},
+	    {EDU_EXEC, ncs_edp_uns32, 0, 0, 0,
+	     (long)&((AVSV_D2N_INFO_SU_SI_ASSIGN_MSG_INFO *)0)->num_assigns, 0,
+	     NULL},
+	    {EDU_EXEC, avsv_edp_susi_asgn, EDQ_POINTER, 0, 0,
+	     (long)&((AVSV_D2N_INFO_SU_SI_ASSIGN_MSG_INFO *)0)->list, 0, NULL},
+
+	    {EDU_TEST_LL_PTR, avsv_edp_su_si_assign_info, 0, 0, 0,
+	     (long)&((AVSV_D2N_INFO_SU_SI_ASSIGN_MSG_INFO *)0)->next, 0, NULL},
+	    {EDU_END, 0, 0, 0, 0, 0, 0, NULL},
+	};
+
+	if (op == EDP_OP_TYPE_ENC) {
+		struct_ptr = (AVSV_D2N_INFO_SU_SI_ASSIGN_MSG_INFO *)ptr;
+	} else if (op == EDP_OP_TYPE_DEC) {
+		d_ptr = (AVSV_D2N_INFO_SU_SI_ASSIGN_MSG_INFO **)ptr;
+		if (*d_ptr == NULL) {
+			*d_ptr =
+			    malloc(sizeof(AVSV_D2N_INFO_SU_SI_ASSIGN_MSG_INFO));
+			if (*d_ptr == NULL) {
+				*o_err = EDU_ERR_MEM_FAIL;
+				return NCSCC_RC_FAILURE;
+			}
+		}
+		memset(*d_ptr, '\0',
+		       sizeof(AVSV_D2N_INFO_SU_SI_ASSIGN_MSG_INFO));
+		struct_ptr = *d_ptr;
+	} else {
+		struct_ptr = ptr;
+	}
+	rc = m_NCS_EDU_RUN_RULES(hdl, edu_tkn, avsv_su_si_assign_info_rules,
+				 struct_ptr, ptr_data_len, buf_env, op, o_err);
+	return rc;
+}
 /*****************************************************************************
 
   PROCEDURE NAME:   avsv_edp_sisu_state_info_msg
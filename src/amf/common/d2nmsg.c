@@ -99,11 +99,12 @@ static uint32_t cpy_d2n_su_msg(AVSV_DND_MSG *d_su_msg, AVSV_DND_MSG *s_su_msg)
 }
 
 /*****************************************************************************
- * Function: free_d2n_susi_msg_info
+ * Function: free_d2n_susi_info
  *
- * Purpose:  This function frees the d2n SU SI message contents.
+ * Purpose:  This function frees the component CSI list of a d2n SU SI
+ * operation.
  *
- * Input: susi_msg - Pointer to the SUSI message contents to be freed.
+ * Input: susi_info - Pointer to the SU SI operation.
  *
  * Returns: none
  *
@@ -113,14 +114,14 @@ static uint32_t cpy_d2n_su_msg(AVSV_DND_MSG *d_su_msg, AVSV_DND_MSG *s_su_msg)
  *
  **************************************************************************/
 
-static void free_d2n_susi_msg_info(AVSV_DND_MSG *susi_msg)
+static void free_d2n_susi_info(AVSV_D2N_INFO_SU_SI_ASSIGN_MSG_INFO *susi_info)
 {
 	AVSV_SUSI_ASGN *compcsi_info;
 	uint16_t i;
 
-	while (susi_msg->msg_info.d2n_su_si_assign.list != NULL) {
-		compcsi_info = susi_msg->msg_info.d2n_su_si_assign.list;
-		susi_msg->msg_info.d2n_su_si_assign.list = compcsi_info->next;
+	while (susi_info->list != NULL) {
+		compcsi_info = susi_info->list;
+		susi_info->list = compcsi_info->next;
 		if (compcsi_info->attrs.list != NULL) {
 			for (i = 0; i < compcsi_info->attrs.number; i++) {
 				osaf_extended_name_free(
@@ -141,43 +142,75 @@ static void free_d2n_susi_msg_info(AVSV_DND_MSG *susi_msg)
 }
 
 /*****************************************************************************
- * Function: cpy_d2n_susi_msg
+ * Function: free_d2n_susi_msg_info
  *
- * Purpose:  This function makes a copy of the d2n SU SI message contents.
+ * Purpose:  This function frees the d2n SU SI message contents.
  *
- * Input: d_susi_msg - Pointer to the SU SI message to be copied to.
- *        s_susi_msg - Pointer to the SU SI message to be copied.
+ * Input: susi_msg - Pointer to the SUSI message contents to be freed.
+ *
+ * Returns: none
+ *
+ * NOTES: It also frees the further SU SI operations carried in the
+ * message.
+ *
+ *
+ **************************************************************************/
+
+static void free_d2n_susi_msg_info(AVSV_DND_MSG *susi_msg)
+{
+	AVSV_D2N_INFO_SU_SI_ASSIGN_MSG_INFO *susi_info;
+
+	free_d2n_susi_info(&susi_msg->msg_info.d2n_su_si_assign);
+
+	while (susi_msg->msg_info.d2n_su_si_assign.next != NULL) {
+		susi_info = susi_msg->msg_info.d2n_su_si_assign.next;
+		susi_msg->msg_info.d2n_su_si_assign.next = susi_info->next;
+		free_d2n_susi_info(susi_info);
+		osaf_extended_name_free(&susi_info->si_name);
+		osaf_extended_name_free(&susi_info->su_name);
+		free(susi_info);
+	}
+}
+
+/*****************************************************************************
+ * Function: cpy_d2n_susi_info
+ *
+ * Purpose:  This function makes a copy of a d2n SU SI operation.
+ *
+ * Input: d_susi_info - Pointer to the SU SI operation to be copied to.
+ *        s_susi_info - Pointer to the SU SI operation to be copied.
  *
  * Returns: NCSCC_RC_SUCCESS/NCSCC_RC_FAILURE
  *
  * NOTES: It also allocates and copies the array of attributes, which are
- *sperately allocated and pointed to by AVSV_SUSI_ASGN structure.
+ *sperately allocated and pointed to by AVSV_SUSI_ASGN structure. The
+ *further SU SI operations are not copied.
  *
  **************************************************************************/
 
-static uint32_t cpy_d2n_susi_msg(AVSV_DND_MSG *d_susi_msg,
-				 AVSV_DND_MSG *s_susi_msg)
+static uint32_t
+cpy_d2n_susi_info(AVSV_D2N_INFO_SU_SI_ASSIGN_MSG_INFO *d_susi_info,
+		  AVSV_D2N_INFO_SU_SI_ASSIGN_MSG_INFO *s_susi_info)
 {
 	AVSV_SUSI_ASGN *s_compcsi_info, *d_compcsi_info;
 	uint16_t i;
 
 	osaf_extended_name_alloc(
-	    osaf_extended_name_borrow(
-		&s_susi_msg->msg_info.d2n_su_si_assign.si_name),
-	    &d_susi_msg->msg_info.d2n_su_si_assign.si_name);
+	    osaf_extended_name_borrow(&s_susi_info->si_name),
+	    &d_susi_info->si_name);
 	osaf_extended_name_alloc(
-	    osaf_extended_name_borrow(
-		&s_susi_msg->msg_info.d2n_su_si_assign.su_name),
-	    &d_susi_msg->msg_info.d2n_su_si_assign.su_name);
+	    osaf_extended_name_borrow(&s_susi_info->su_name),
+	    &d_susi_info->su_name);
 
-	d_susi_msg->msg_info.d2n_su_si_assign.list = NULL;
+	d_susi_info->list = NULL;
+	d_susi_info->next = NULL;
 
-	s_compcsi_info = s_susi_msg->msg_info.d2n_su_si_assign.list;
+	s_compcsi_info = s_susi_info->list;
 
 	while (s_compcsi_info != NULL) {
 		d_compcsi_info = malloc(sizeof(AVSV_SUSI_ASGN));
 		if (d_compcsi_info == NULL) {
-			free_d2n_susi_msg_info(d_susi_msg);
+			free_d2n_susi_info(d_susi_info);
 			return NCSCC_RC_FAILURE;
 		}
 
@@ -198,7 +231,7 @@ static uint32_t cpy_d2n_susi_msg(AVSV_DND_MSG *d_susi_msg,
 			    malloc(s_compcsi_info->attrs.number *
 				   sizeof(*d_compcsi_info->attrs.list));
 			if (d_compcsi_info->attrs.list == NULL) {
-				free_d2n_susi_msg_info(d_susi_msg);
+				free_d2n_susi_info(d_susi_info);
 				free(d_compcsi_info);
 				return NCSCC_RC_FAILURE;
 			}
@@ -224,9 +257,8 @@ static uint32_t cpy_d2n_susi_msg(AVSV_DND_MSG *d_susi_msg,
 				}
 			}
 		}
-		d_compcsi_info->next =
-		    d_susi_msg->msg_info.d2n_su_si_assign.list;
-		d_susi_msg->msg_info.d2n_su_si_assign.list = d_compcsi_info;
+		d_compcsi_info->next = d_susi_info->list;
+		d_susi_info->list = d_compcsi_info;
 
 		/* now go to the next su info in source */
 		s_compcsi_info = s_compcsi_info->next;
@@ -235,6 +267,56 @@ static uint32_t cpy_d2n_susi_msg(AVSV_DND_MSG *d_susi_msg,
 	return NCSCC_RC_SUCCESS;
 }
 
+/*****************************************************************************
+ * Function: cpy_d2n_susi_msg
+ *
+ * Purpose:  This function makes a copy of the d2n SU SI message contents.
+ *
+ * Input: d_susi_msg - Pointer to the SU SI message to be copied to.
+ *        s_susi_msg - Pointer to the SU SI message to be copied.
+ *
+ * Returns: NCSCC_RC_SUCCESS/NCSCC_RC_FAILURE
+ *
+ * NOTES: It also copies the further SU SI operations carried in the
+ *message, in the same order.
+ *
+ **************************************************************************/
+
+static uint32_t cpy_d2n_susi_msg(AVSV_DND_MSG *d_susi_msg,
+				 AVSV_DND_MSG *s_susi_msg)
+{
+	AVSV_D2N_INFO_SU_SI_ASSIGN_MSG_INFO *s_susi_info, *d_susi_info;
+	AVSV_D2N_INFO_SU_SI_ASSIGN_MSG_INFO **tail;
+
+	if (cpy_d2n_susi_info(&d_susi_msg->msg_info.d2n_su_si_assign,
+			      &s_susi_msg->msg_info.d2n_su_si_assign) !=
+	    NCSCC_RC_SUCCESS)
+		return NCSCC_RC_FAILURE;
+
+	tail = &d_susi_msg->msg_info.d2n_su_si_assign.next;
+	for (s_susi_info = s_susi_msg->msg_info.d2n_su_si_assign.next;
+	     s_susi_info != NULL; s_susi_info = s_susi_info->next) {
+		d_susi_info = malloc(sizeof(*d_susi_info));
+		if (d_susi_info == NULL) {
+			free_d2n_susi_msg_info(d_susi_msg);
+			return NCSCC_RC_FAILURE;
+		}
+		memcpy(d_susi_info, s_susi_info, sizeof(*d_susi_info));
+		if (cpy_d2n_susi_info(d_susi_info, s_susi_info) !=
+		    NCSCC_RC_SUCCESS) {
+			osaf_extended_name_free(&d_susi_info->si_name);
+			osaf_extended_name_free(&d_susi_info->su_name);
+			free(d_susi_info);
+			free_d2n_susi_msg_info(d_susi_msg);
+			return NCSCC_RC_FAILURE;
+		}
+		*tail = d_susi_info;
+		tail = &d_susi_info->next;
+	}
+
+	return NCSCC_RC_SUCCESS;
+}
+
 /*****************************************************************************
  * Function: free_d2n_pg_msg_info
  *
@@ -0,0 +1,72 @@
+/*      -*- OpenSAF  -*-
+ *
+ * (C) Copyright 2017 The OpenSAF Foundation
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. This file and program are licensed
+ * under the GNU Lesser General Public License Version 2.1, February 1999.
+ * The complete license can be accessed from the following location:
+ * http://opensource.org/licenses/lgpl-license.php
+ * See the Copying file included with the OpenSAF distribution for full
+ * licensing terms.
+ *
+ */
+
+/*****************************************************************************
+
+  DESCRIPTION:
+
+  This file contains the failover trace of the SI assignment phases, see
+  amf_fotrace.h.
+
+******************************************************************************
+*/
+
+#include "amf/common/amf_fotrace.h"
+#include <pthread.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <syslog.h>
+#include <time.h>
+#include "base/osaf_extended_name.h"
+
+static pthread_once_t fotrace_once = PTHREAD_ONCE_INIT;
+static bool fotrace_on;
+
+static void fotrace_init(void)
+{
+	const char *value = getenv("OSAF_AMF_FAILOVER_TRACE");
+
+	fotrace_on = value != NULL && strcmp(value, "1") == 0;
+}
+
+bool amf_fotrace_enabled(void)
+{
+	pthread_once(&fotrace_once, fotrace_init);
+	return fotrace_on;
+}
+
+/* The name as logged, "-" if it is empty */
+const char *amf_fotrace_name(const SaNameT *name)
+{
+	if (osaf_extended_name_length(name) == 0)
+		return "-";
+	return osaf_extended_name_borrow(name);
+}
+
+void amf_fotrace(const char *phase, const char *format, ...)
+{
+	struct timespec ts;
+	char buf[512];
+	va_list ap;
+
+	clock_gettime(CLOCK_REALTIME, &ts);
+	va_start(ap, format);
+	vsnprintf(buf, sizeof(buf), format, ap);
+	va_end(ap);
+	syslog(LOG_NOTICE, "amf-fotrace phase=%s ts=%ld.%06ld %s", phase,
+	       (long)ts.tv_sec, ts.tv_nsec / 1000, buf);
+}
@@ -63,6 +63,42 @@ static uint32_t ncs_edu_get_size_of_var_len_data(EDU_PROG_HANDLER edp,
 static int edu_chk_ver_ge(EDU_MSG_VERSION *local_version,
 			  EDU_MSG_VERSION *to_version, int skip_cnt_if_ne);
 
+/* Compiled EDP rules, see edu_cprog_build() */
+
+/* Maximum octets of a run of builtin instructions */
+#define EDU_CPROG_RUN_MAX 256
+
+typedef enum {
+	EDU_CINST_RULE,	 /* interpreted by ncs_edu_exec_rule() */
+	EDU_CINST_FIXED, /* builtin, or array of builtins */
+	EDU_CINST_CHARS	 /* array of char, encoded as a string */
+} EDU_CINST_KIND;
+
+typedef struct edu_cinst {
+	EDU_CINST_KIND kind;
+	uint32_t offset; /* of the field in the data structure */
+	uint32_t count;	 /* number of elements */
+	uint8_t size;	 /* size of an element in the data structure */
+	uint8_t octets;	 /* size of an encoded element */
+	uint16_t run;	 /* instructions encoded together from this one */
+	uint32_t run_octets;
+} EDU_CINST;
+
+typedef struct edu_cprog {
+	int instr_count;
+	EDU_CINST *inst;
+	EDU_INST_SET rules[]; /* the rules it was compiled from */
+} EDU_CPROG;
+
+static EDU_CPROG *edu_cprog_build(EDU_INST_SET *prog, int instr_count);
+static EDU_CPROG *edu_cprog_get(EDU_HDL *edu_hdl, EDU_INST_SET *prog,
+				int instr_count);
+static int edu_cprog_enc(const EDU_CPROG *cprog, int *cur_inst_indx,
+			 NCSCONTEXT ptr, uint32_t *ptr_data_len, NCS_UBAID *uba,
+			 EDU_ERR *o_err);
+static int edu_cprog_dec(const EDU_CPROG *cprog, int *cur_inst_indx,
+			 NCSCONTEXT ptr, NCS_UBAID *uba, EDU_ERR *o_err);
+
 /*****************************************************************************
 
   PROCEDURE NAME:   ncs_edu_hdl_init
@@ -1710,6 +1746,366 @@ EDU_LABEL ncs_edu_run_test_ll_rule(EDU_INST_SET *rule, NCSCONTEXT ptr,
 	return EDU_FAIL;
 }
 
+/*****************************************************************************
+
+  Compiled EDP rules
+
+  EDCOMPILE also compiles the rules of an EDP, into an EDU_CPROG that is
+  kept in the EDU_HDL_NODE of the EDP. The EDU_EXEC instructions on builtin
+  EDPs, and arrays of them, are resolved to the offset and the size of the
+  field, and consecutive ones are encoded/decoded with one reserve/flatten
+  of the USRBUF, instead of running the EDP of the builtin for each field.
+  All other instructions, and the control flow between them, are still
+  interpreted by ncs_edu_run_rules_for_enc/dec(), so the encoded octets are
+  the same as when the rules are only interpreted.
+
+  The compiled rules are used for encode/decode into NCS_UBAID when the
+  rules passed to ncs_edu_run_rules() are the ones that were compiled, as
+  some EDPs select their rules at run time, e.g. by peer version.
+
+*****************************************************************************/
+
+/*****************************************************************************
+
+  PROCEDURE NAME:   edu_builtin_fmat
+
+  DESCRIPTION:      Gets the size of a builtin data type in the data
+		    structure, and encoded, for the builtin EDPs with a fixed
+		    size encoding.
+
+  RETURNS:          true    - If EDP is a fixed size builtin
+		    false   - otherwise
+
+*****************************************************************************/
+static bool edu_builtin_fmat(EDU_PROG_HANDLER edp, uint8_t *o_size,
+			     uint8_t *o_octets)
+{
+	if (edp == ncs_edp_ncs_bool) {
+		/* Encoded as 4 octets for backward compatibility */
+		*o_size = sizeof(bool);
+		*o_octets = 4;
+	} else if ((edp == ncs_edp_uns8) || (edp == ncs_edp_int8) ||
+		   (edp == ncs_edp_char)) {
+		*o_size = *o_octets = 1;
+	} else if ((edp == ncs_edp_uns16) || (edp == ncs_edp_int16) ||
+		   (edp == ncs_edp_short)) {
+		*o_size = *o_octets = 2;
+	} else if ((edp == ncs_edp_uns32) || (edp == ncs_edp_int32) ||
+		   (edp == ncs_edp_int)) {
+		*o_size = *o_octets = 4;
+	} else if ((edp == ncs_edp_uns64) || (edp == ncs_edp_int64)) {
+		*o_size = *o_octets = 8;
+	} else {
+		return false;
+	}
+
+	return true;
+}
+
+/*****************************************************************************
+
+  PROCEDURE NAME:   edu_cprog_build
+
+  DESCRIPTION:      Compiles the EDP rules, invoked at EDCOMPILE time.
+
+  RETURNS:          EDU_CPROG *, or NULL if no instruction could be compiled
+
+*****************************************************************************/
+static EDU_CPROG *edu_cprog_build(EDU_INST_SET *prog, int instr_count)
+{
+	EDU_CPROG *cprog;
+	int i, num_compiled = 0;
+
+	cprog = calloc(1, sizeof(EDU_CPROG) +
+			      instr_count * sizeof(EDU_INST_SET) +
+			      instr_count * sizeof(EDU_CINST));
+	if (cprog == NULL)
+		return NULL;
+	cprog->instr_count = instr_count;
+	cprog->inst = (EDU_CINST *)&cprog->rules[instr_count];
+	memcpy(cprog->rules, prog, instr_count * sizeof(EDU_INST_SET));
+
+	for (i = 0; i < instr_count; i++) {
+		EDU_CINST *ci = &cprog->inst[i];
+		EDU_INST_SET *rule = &prog[i];
+		uint32_t count = 1;
+
+		if (rule->instr != EDU_EXEC)
+			continue;
+		if (rule->fld2 == EDQ_ARRAY) {
+			if ((rule->fld6 <= 0) || (rule->fld6 > UINT16_MAX))
+				continue;
+			count = rule->fld6;
+			if (rule->fld1 == ncs_edp_char) {
+				ci->kind = EDU_CINST_CHARS;
+				ci->offset = rule->fld5;
+				ci->count = count;
+				num_compiled++;
+				continue;
+			}
+		} else if (rule->fld2 != 0) {
+			continue;
+		}
+		if (!edu_builtin_fmat(rule->fld1, &ci->size, &ci->octets))
+			continue;
+		if (count * ci->octets > EDU_CPROG_RUN_MAX)
+			continue;
+		ci->kind = EDU_CINST_FIXED;
+		ci->offset = rule->fld5;
+		ci->count = count;
+		num_compiled++;
+	}
+
+	if (num_compiled == 0) {
+		free(cprog);
+		return NULL;
+	}
+
+	/* A run continues with the next instruction when the label of the
+	   instruction is EDU_NEXT. Entering the rules at any instruction of
+	   a run, after an EDU_TEST, runs the rest of it. */
+	for (i = instr_count - 1; i >= 0; i--) {
+		EDU_CINST *ci = &cprog->inst[i];
+		EDU_CINST *next = &cprog->inst[i + 1];
+
+		if (ci->kind != EDU_CINST_FIXED)
+			continue;
+		ci->run = 1;
+		ci->run_octets = ci->count * ci->octets;
+		if ((i + 1 < instr_count) &&
+		    ((prog[i].nxt_lbl == 0) || (prog[i].nxt_lbl == EDU_NEXT)) &&
+		    (next->kind == EDU_CINST_FIXED) && (next->run < UINT16_MAX) &&
+		    (ci->run_octets + next->run_octets <= EDU_CPROG_RUN_MAX)) {
+			ci->run += next->run;
+			ci->run_octets += next->run_octets;
+		}
+	}
+
+	return cprog;
+}
+
+/*****************************************************************************
+
+  PROCEDURE NAME:   edu_cprog_get
+
+  DESCRIPTION:      Gets the compiled rules of the EDP, if these are the
+		    rules it was compiled from.
+
+  RETURNS:          EDU_CPROG *, or NULL if the rules are to be interpreted
+
+*****************************************************************************/
+static EDU_CPROG *edu_cprog_get(EDU_HDL *edu_hdl, EDU_INST_SET *prog,
+				int instr_count)
+{
+	EDU_HDL_NODE *hdl_node;
+	EDU_CPROG *cprog;
+	int i;
+
+	if (edu_hdl->interpret_only)
+		return NULL;
+
+	if ((hdl_node = (EDU_HDL_NODE *)ncs_patricia_tree_get(
+		 &edu_hdl->tree, (uint8_t *)&prog[0].fld1)) == NULL)
+		return NULL;
+
+	cprog = hdl_node->cprog;
+	if ((cprog == NULL) || (cprog->instr_count != instr_count))
+		return NULL;
+
+	/* Compared field by field, the padding of "prog" is undefined */
+	for (i = 0; i < instr_count; i++) {
+		const EDU_INST_SET *a = &cprog->rules[i], *b = &prog[i];
+
+		if ((a->instr != b->instr) || (a->fld1 != b->fld1) ||
+		    (a->fld2 != b->fld2) || (a->fld3 != b->fld3) ||
+		    (a->nxt_lbl != b->nxt_lbl) || (a->fld5 != b->fld5) ||
+		    (a->fld6 != b->fld6) || (a->fld7 != b->fld7))
+			return NULL;
+	}
+
+	return cprog;
+}
+
+/*****************************************************************************
+
+  PROCEDURE NAME:   edu_cinst_enc
+
+  DESCRIPTION:      Encodes the field of a compiled builtin instruction into
+		    reserved space.
+
+  RETURNS:          uint8_t *, past the encoded octets
+
+*****************************************************************************/
+static uint8_t *edu_cinst_enc(const EDU_CINST *ci, NCSCONTEXT ptr,
+			      uint8_t *p8)
+{
+	const uint8_t *src = (const uint8_t *)ptr + ci->offset;
+	uint32_t i;
+
+	for (i = 0; i < ci->count; i++, src += ci->size) {
+		switch (ci->octets) {
+		case 1:
+			ncs_encode_8bit(&p8, *src);
+			break;
+		case 2:
+			ncs_encode_16bit(&p8, *(const uint16_t *)src);
+			break;
+		case 4:
+			if (ci->size == 4)
+				ncs_encode_32bit(&p8, *(const uint32_t *)src);
+			else
+				ncs_encode_32bit(&p8, *(const bool *)src);
+			break;
+		default:
+			ncs_encode_64bit(&p8, *(const uint64_t *)src);
+			break;
+		}
+	}
+
+	return p8;
+}
+
+/*****************************************************************************
+
+  PROCEDURE NAME:   edu_cinst_dec
+
+  DESCRIPTION:      Decodes the field of a compiled builtin instruction from
+		    flattened space.
+
+  RETURNS:          uint8_t *, past the decoded octets
+
+*****************************************************************************/
+static uint8_t *edu_cinst_dec(const EDU_CINST *ci, NCSCONTEXT ptr,
+			      uint8_t *p8)
+{
+	uint8_t *dst = (uint8_t *)ptr + ci->offset;
+	uint32_t i;
+
+	for (i = 0; i < ci->count; i++, dst += ci->size) {
+		switch (ci->octets) {
+		case 1:
+			*dst = ncs_decode_8bit(&p8);
+			break;
+		case 2:
+			*(uint16_t *)dst = ncs_decode_16bit(&p8);
+			break;
+		case 4:
+			if (ci->size == 4)
+				*(uint32_t *)dst = ncs_decode_32bit(&p8);
+			else
+				*(bool *)dst = (bool)ncs_decode_32bit(&p8);
+			break;
+		default:
+			*(uint64_t *)dst = ncs_decode_64bit(&p8);
+			break;
+		}
+	}
+
+	return p8;
+}
+
+/*****************************************************************************
+
+  PROCEDURE NAME:   edu_cprog_enc
+
+  DESCRIPTION:      Encodes a compiled instruction, and the rest of its run.
+		    "*cur_inst_indx" is left at the last instruction encoded,
+		    for its label to be followed.
+
+  RETURNS:          EDU_NEXT/EDU_FAIL
+
+*****************************************************************************/
+static int edu_cprog_enc(const EDU_CPROG *cprog, int *cur_inst_indx,
+			 NCSCONTEXT ptr, uint32_t *ptr_data_len, NCS_UBAID *uba,
+			 EDU_ERR *o_err)
+{
+	const EDU_CINST *ci = &cprog->inst[*cur_inst_indx];
+	uint8_t *p8;
+	int i;
+
+	if (ci->kind == EDU_CINST_CHARS) {
+		uint8_t *str = (uint8_t *)ptr + ci->offset;
+		uint16_t str_len = strlen((char *)str);
+
+		if ((p8 = ncs_enc_reserve_space(uba, 2)) == NULL)
+			goto mem_fail;
+		ncs_encode_16bit(&p8, str_len);
+		ncs_enc_claim_space(uba, 2);
+		if ((str_len != 0) &&
+		    (ncs_encode_n_octets_in_uba(uba, str, str_len) !=
+		     NCSCC_RC_SUCCESS))
+			goto mem_fail;
+	} else {
+		if ((p8 = ncs_enc_reserve_space(uba, ci->run_octets)) == NULL)
+			goto mem_fail;
+		for (i = 0; i < ci->run; i++)
+			p8 = edu_cinst_enc(&ci[i], ptr, p8);
+		ncs_enc_claim_space(uba, ci->run_octets);
+		*cur_inst_indx += ci->run - 1;
+	}
+	*ptr_data_len = 0;
+	return EDU_NEXT;
+
+mem_fail:
+	m_LEAP_DBG_SINK_VOID;
+	*o_err = EDU_ERR_MEM_FAIL;
+	return EDU_FAIL;
+}
+
+/*****************************************************************************
+
+  PROCEDURE NAME:   edu_cprog_dec
+
+  DESCRIPTION:      Decodes a compiled instruction, and the rest of its run.
+		    "*cur_inst_indx" is left at the last instruction decoded,
+		    for its label to be followed.
+
+  RETURNS:          EDU_NEXT/EDU_FAIL
+
+*****************************************************************************/
+static int edu_cprog_dec(const EDU_CPROG *cprog, int *cur_inst_indx,
+			 NCSCONTEXT ptr, NCS_UBAID *uba, EDU_ERR *o_err)
+{
+	const EDU_CINST *ci = &cprog->inst[*cur_inst_indx];
+	uint8_t space[EDU_CPROG_RUN_MAX];
+	uint8_t *p8;
+	int i;
+
+	if (ci->kind == EDU_CINST_CHARS) {
+		uint8_t *str = (uint8_t *)ptr + ci->offset;
+		uint16_t str_len;
+
+		if ((p8 = ncs_dec_flatten_space(uba, space, 2)) == NULL)
+			goto parse_fail;
+		str_len = ncs_decode_16bit(&p8);
+		ncs_dec_skip_space(uba, 2);
+		if (str_len > ci->count)
+			goto parse_fail;
+		if (str_len != 0) {
+			if ((p8 = ncs_dec_flatten_space(uba, str, str_len)) ==
+			    NULL)
+				goto parse_fail;
+			if (p8 != str)
+				memcpy(str, p8, str_len);
+			ncs_dec_skip_space(uba, str_len);
+		}
+	} else {
+		if ((p8 = ncs_dec_flatten_space(uba, space, ci->run_octets)) ==
+		    NULL)
+			goto parse_fail;
+		for (i = 0; i < ci->run; i++)
+			p8 = edu_cinst_dec(&ci[i], ptr, p8);
+		ncs_dec_skip_space(uba, ci->run_octets);
+		*cur_inst_indx += ci->run - 1;
+	}
+	return EDU_NEXT;
+
+parse_fail:
+	m_LEAP_DBG_SINK_VOID;
+	*o_err = EDU_ERR_UBUF_PARSE_FAIL;
+	return EDU_FAIL;
+}
+
 /*****************************************************************************
 
   PROCEDURE NAME:   ncs_edu_run_rules_for_enc
@@ -1736,6 +2132,7 @@ EDU_LABEL ncs_edu_run_rules_for_enc(EDU_HDL *edu_hdl, EDU_TKN *edu_tkn,
 	EDU_HDL_NODE *lcl_hdl_node = NULL;
 	bool is_select_on = false;
 	uint8_t select_index = 0;
+	EDU_CPROG *cprog = NULL;
 
 	if ((prog[0].fld2 & EDQ_LNKLIST) == EDQ_LNKLIST) {
 		/* This is a linked list. So, increment the counter for the
@@ -1765,6 +2162,8 @@ EDU_LABEL ncs_edu_run_rules_for_enc(EDU_HDL *edu_hdl, EDU_TKN *edu_tkn,
 			is_select_on = true;
 		}
 	}
+	if (!is_select_on && buf_env->is_ubaid)
+		cprog = edu_cprog_get(edu_hdl, prog, instr_count);
 
 	cur_inst_indx = 1; /* 0th rule is always for EDU_START, which need not
 			      be executed now. */
@@ -1909,9 +2308,16 @@ EDU_LABEL ncs_edu_run_rules_for_enc(EDU_HDL *edu_hdl, EDU_TKN *edu_tkn,
 				return EDU_EXIT;
 			}
 		}
-		rc_lbl = m_NCS_EDU_EXEC_RULE(
-		    edu_hdl, NULL, hdl_node, &prog[cur_inst_indx], lclptr,
-		    ptr_data_len, buf_env, EDP_OP_TYPE_ENC, o_err);
+		if ((cprog != NULL) &&
+		    (cprog->inst[cur_inst_indx].kind != EDU_CINST_RULE))
+			rc_lbl = edu_cprog_enc(cprog, &cur_inst_indx, lclptr,
+					       ptr_data_len, buf_env->info.uba,
+					       o_err);
+		else
+			rc_lbl = m_NCS_EDU_EXEC_RULE(
+			    edu_hdl, NULL, hdl_node, &prog[cur_inst_indx],
+			    lclptr, ptr_data_len, buf_env, EDP_OP_TYPE_ENC,
+			    o_err);
 		if ((rc_lbl == 0) || (rc_lbl == EDU_NEXT)) {
 			/* This is typically EDU_NEXT statement. */
 			if (is_select_on) {
@@ -2059,6 +2465,7 @@ EDU_LABEL ncs_edu_run_rules_for_dec(EDU_HDL *edu_hdl, EDU_TKN *edu_tkn,
 	NCSCONTEXT lclptr = ptr;
 	bool is_select_on = false;
 	uint8_t select_index = 0;
+	EDU_CPROG *cprog = NULL;
 
 	if ((edu_tkn != NULL) && (edu_tkn->var_cnt != 0)) {
 		if ((edu_tkn->parent_edp == prog[0].fld1) &&
@@ -2067,6 +2474,8 @@ EDU_LABEL ncs_edu_run_rules_for_dec(EDU_HDL *edu_hdl, EDU_TKN *edu_tkn,
 			is_select_on = true;
 		}
 	}
+	if (!is_select_on && buf_env->is_ubaid)
+		cprog = edu_cprog_get(edu_hdl, prog, instr_count);
 
 	cur_inst_indx = 1; /* 0th rule is always for EDU_START, which need not
 			      be executed now. */
@@ -2090,9 +2499,15 @@ EDU_LABEL ncs_edu_run_rules_for_dec(EDU_HDL *edu_hdl, EDU_TKN *edu_tkn,
 				return EDU_EXIT;
 			}
 		}
-		rc_lbl = m_NCS_EDU_EXEC_RULE(
-		    edu_hdl, NULL, hdl_node, &prog[cur_inst_indx], lclptr,
-		    ptr_data_len, buf_env, EDP_OP_TYPE_DEC, o_err);
+		if ((cprog != NULL) &&
+		    (cprog->inst[cur_inst_indx].kind != EDU_CINST_RULE))
+			rc_lbl = edu_cprog_dec(cprog, &cur_inst_indx, lclptr,
+					       buf_env->info.uba, o_err);
+		else
+			rc_lbl = m_NCS_EDU_EXEC_RULE(
+			    edu_hdl, NULL, hdl_node, &prog[cur_inst_indx],
+			    lclptr, ptr_data_len, buf_env, EDP_OP_TYPE_DEC,
+			    o_err);
 		if ((rc_lbl == 0) || (rc_lbl == EDU_NEXT)) {
 
 			/* This is typically EDU_NEXT statement. */
@@ -2793,6 +3208,9 @@ uint32_t ncs_edu_run_rules_for_compile(EDU_HDL *edu_hdl, EDU_HDL_NODE *hdl_node,
 		return m_LEAP_DBG_SINK(NCSCC_RC_FAILURE);
 	}
 
+	if (hdl_node->cprog == NULL)
+		hdl_node->cprog = edu_cprog_build(prog, instr_count);
+
 	hdl_node->edcompile_pass = true;
 
 	return NCSCC_RC_SUCCESS;
@@ -3881,6 +4299,8 @@ static void edu_hdl_node_del(EDU_HDL *edu_hdl, EDU_HDL_NODE *node)
 	/* Free the node contents now. */
 	ncs_edu_free_test_instr_rec_list(node->test_instr_store);
 	node->test_instr_store = NULL;
+	free(node->cprog);
+	node->cprog = NULL;
 
 	/* Free the node. */
 	free(node);
@@ -105,7 +105,8 @@
 
 int32_t ncs_enc_init_space(NCS_UBAID *uba)
 {
-	if ((uba->start = m_MMGR_ALLOC_BUFR(sizeof(USRBUF))) == BNULL)
+	/* start small, reserving space chains larger USRBUFs as needed */
+	if ((uba->start = m_MMGR_ALLOC_POOLBUFR_SIZE(0, 0, 0)) == BNULL)
 		return NCSCC_RC_FAILURE;
 
 	uba->ub = uba->start;
@@ -141,7 +142,8 @@ int32_t ncs_enc_init_space(NCS_UBAID *uba)
 
 int32_t ncs_enc_init_space_pp(NCS_UBAID *uba, uint8_t pool_id, uint8_t priority)
 {
-	if ((uba->start = m_MMGR_ALLOC_POOLBUFR(pool_id, priority)) == BNULL)
+	if ((uba->start = m_MMGR_ALLOC_POOLBUFR_SIZE(pool_id, priority, 0)) ==
+	    BNULL)
 		return m_LEAP_DBG_SINK(NCSCC_RC_FAILURE);
 
 	uba->ub = uba->start;
@@ -150,7 +150,8 @@ typedef enum {
    - EDCOMPILE status of EDP
 */
 typedef struct edu_hdl_tag {
-  bool is_inited; /* Is the tree initialised */
+  bool is_inited;      /* Is the tree initialised */
+  bool interpret_only; /* Don't use the compiled EDPs(for testing) */
   NCS_PATRICIA_TREE tree;
   EDU_MSG_VERSION to_version;
 } EDU_HDL;
@@ -271,6 +272,8 @@ typedef struct edu_hdl_node_tag {
 
   EDP_TEST_INSTR_REC *test_instr_store; /* Internal only */
 
+  struct edu_cprog *cprog; /* Internal only, compiled EDP rules */
+
 } EDU_HDL_NODE;
 
 /************* EDU EXTERNAL API (to Service Users) *************/
@@ -98,6 +98,13 @@ extern "C" {
 #define m_MMGR_ALLOC_POOLBUFR(i, pr) \
   (sysf_alloc_pkt(i, pr, 0, __LINE__, __FILE__))
 
+/** Macro to allocate a USRBUF from a particular pool with a payload area
+ ** of the smallest size class that fits "n" octets, used when the USRBUF is
+ ** expected to stay small. m_MMGR_RESERVE_AT_END chains larger USRBUFs
+ ** when more space is needed.
+ **/
+#define m_MMGR_ALLOC_POOLBUFR_SIZE(i, pr, n) (sysf_alloc_pkt_size(i, pr, n))
+
 /** Macro to allocate a USRBUF (packet buffer)...
  ** The USRBUF should be empty and properly initialized. You may elect
  ** to reserve a few octets at the beginning to optimize pre-pend operations.
@@ -173,7 +180,7 @@ void sysf_stub_free(void *data, uint8_t pool_id);
  **
  ** This macro must return an unsigned int.
  **/
-#define m_MMGR_TAILROOM(p) (PAYLOAD_BUF_SIZE - (p)->start - (p)->count)
+#define m_MMGR_TAILROOM(p) ((p)->payload->Size - (p)->start - (p)->count)
 
 /** Macro to fetch the count of payload data in a given USRBUF (chain)...
  **
@@ -519,6 +526,8 @@ void sysf_free_pkt(USRBUF *pb);
 
 USRBUF *sysf_alloc_pkt(unsigned char pool_id, unsigned char priority, int num,
                        unsigned int line, char *file);
+USRBUF *sysf_alloc_pkt_size(unsigned char pool_id, unsigned char priority,
+                            unsigned int size);
 
 char *sysf_reserve_at_end(USRBUF **ppb, unsigned int size);
 char *sysf_reserve_at_end_amap(USRBUF **ppb, unsigned int *io_size, bool total);
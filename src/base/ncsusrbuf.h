@@ -101,11 +101,14 @@ typedef void *USRDATA_EXTENT;
  * data. It also maintains a ref-count of how many USRBUFs are pointing to
  * it, which assists in the zero-copy paradigm and informs the memory free
  * routine if we really want to give the memory back to the owning pool.
+ * Only the first Size octets of Data are allocated, the pools that allocate
+ * from the heap use the size classes in sysf_mem.c.
  */
 
 typedef struct usrdata {
   USRDATA_EXTENT ue;           /* UserData Extensions                  */
   uint32_t RefCnt;             /* # of USRBUFs pointing to this block. */
+  uint32_t Size;               /* size of the payload area             */
   char Data[PAYLOAD_BUF_SIZE]; /* payload area ie. The Data  . */
 
 } USRDATA;
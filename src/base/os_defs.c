@@ -46,6 +46,7 @@
 #include <unistd.h>
 #include <limits.h>
 #include <pthread.h>
+#include <spawn.h>
 
 #include "base/sysf_exc_scr.h"
 #include "base/ncssysf_tsk.h"
@@ -983,52 +984,147 @@ void ncs_os_udef_free(void *ptr, uint8_t pool_id)
 	free(ptr);
 }
 
+/* posix_spawn can close the inherited file descriptors from glibc 2.34 */
+#if defined(__GLIBC__) && __GLIBC_PREREQ(2, 34)
+#define OS_PROCESS_SPAWN_CLOSEFROM 1
+#endif
+
+#ifdef OS_PROCESS_SPAWN_CLOSEFROM
 /***************************************************************************
  *
- * ncs_os_process_execute_timed
+ * os_process_spawn_env
  *
- * Description: To execute a module in a new process with time-out.
+ * Description: Build the environment of a new process, the environment of
+ *              this process with the requested variables set.
  *
- * Synopsis:
+ * Returns:
+ *   A NULL terminated array of "name=value" strings, the strings not taken
+ *   from environ are allocated after the array, or NULL on failure. Free
+ *   the array with free().
  *
- * Call Arguments:
- *   req - Request parameters.
+ **************************************************************************/
+static char **os_process_spawn_env(NCS_OS_ENVIRON_SET_NODE *node, int count)
+{
+	size_t num = 0;
+	size_t size = 0;
+	char **envp;
+	char *str;
+	int i;
+
+	while (environ[num] != NULL)
+		num++;
+	for (i = 0; i < count; i++)
+		size += strlen(node[i].name) + strlen(node[i].value) + 2;
+
+	envp = malloc((num + count + 1) * sizeof(char *) + size);
+	if (envp == NULL)
+		return NULL;
+	memcpy(envp, environ, num * sizeof(char *));
+	envp[num] = NULL;
+	str = (char *)(envp + num + count + 1);
+
+	/* same as setenv() for each variable, in order */
+	for (i = 0; i < count; i++) {
+		size_t len = strlen(node[i].name);
+		size_t j;
+
+		for (j = 0; envp[j] != NULL; j++) {
+			if (strncmp(envp[j], node[i].name, len) == 0 &&
+			    envp[j][len] == '=')
+				break;
+		}
+		if (envp[j] != NULL && node[i].overwrite == 0)
+			continue;
+
+		sprintf(str, "%s=%s", node[i].name, node[i].value);
+		if (envp[j] == NULL)
+			envp[j + 1] = NULL;
+		envp[j] = str;
+		str += strlen(str) + 1;
+	}
+
+	return envp;
+}
+
+/***************************************************************************
  *
- * Returns:
- *   Success or failure
+ * os_process_spawn
  *
- * Notes:
+ * Description: Start a process executing a module with posix_spawn. The
+ *              child is set up as by os_process_fork, but posix_spawn does
+ *              not copy the page tables of this process, which is costly
+ *              for a large multi-threaded process starting many commands.
+ *
+ * Returns:
+ *   The pid of the new process, or -1 with errno set on failure.
  *
  **************************************************************************/
-uint32_t ncs_os_process_execute_timed(NCS_OS_PROC_EXECUTE_TIMED_INFO *req)
+static pid_t os_process_spawn(NCS_OS_PROC_EXECUTE_TIMED_INFO *req,
+			      NCS_OS_ENVIRON_SET_NODE *node, int count)
 {
-	int count;
-	int pid;
-	NCS_OS_ENVIRON_SET_NODE *node = NULL;
+	posix_spawn_file_actions_t actions;
+	posix_spawnattr_t attr;
+	struct sched_param param = {.sched_priority = 0};
+	char **envp;
+	pid_t pid = -1;
+	int rc;
 
-	if ((req->i_script == NULL) || (req->i_cb == NULL))
-		return NCSCC_RC_FAILURE;
+	if ((envp = os_process_spawn_env(node, count)) == NULL)
+		return -1;
 
-	if (req->i_set_env_args == NULL)
-		count = 0;
-	else {
-		count = req->i_set_env_args->num_args;
-		node = req->i_set_env_args->env_arg;
+	posix_spawn_file_actions_init(&actions);
+	posix_spawnattr_init(&attr);
+
+	/*
+	 ** Make sure spawned processes have default scheduling class
+	 ** independent of the callers scheduling class.
+	 */
+	posix_spawnattr_setschedpolicy(&attr, SCHED_OTHER);
+	posix_spawnattr_setschedparam(&attr, &param);
+	posix_spawnattr_setflags(&attr, POSIX_SPAWN_SETSCHEDULER);
+
+	/* By default we close all inherited file descriptors in the child
+	 * and redirect standard files to /dev/null */
+	if (getenv("OPENSAF_KEEP_FD_OPEN_AFTER_FORK") == NULL) {
+		posix_spawn_file_actions_addopen(&actions, STDIN_FILENO,
+						 "/dev/null", O_RDONLY, 0);
+		posix_spawn_file_actions_addopen(&actions, STDOUT_FILENO,
+						 "/dev/null", O_WRONLY, 0);
+		posix_spawn_file_actions_addopen(&actions, STDERR_FILENO,
+						 "/dev/null", O_WRONLY, 0);
+		posix_spawn_file_actions_addclosefrom_np(&actions,
+							 STDERR_FILENO + 1);
 	}
 
-	m_NCS_LOCK(&module_cb.tree_lock, NCS_LOCK_WRITE);
+	rc = posix_spawnp(&pid, req->i_script, &actions, &attr, req->i_argv,
+			  envp);
 
-	if (module_cb.init != true) {
-		/* this will initializes the execute module control block */
-		if (start_exec_mod_cb() != NCSCC_RC_SUCCESS) {
-			m_NCS_UNLOCK(&module_cb.tree_lock, NCS_LOCK_WRITE);
-			syslog(LOG_ERR, "%s: start_exec_mod_cb failed",
-			       __FUNCTION__);
-			return NCSCC_RC_FAILURE;
-		}
+	posix_spawnattr_destroy(&attr);
+	posix_spawn_file_actions_destroy(&actions);
+	free(envp);
+
+	if (rc != 0) {
+		errno = rc;
+		return -1;
 	}
+	return pid;
+}
+#endif
 
-	osaf_mutex_lock_ordie(&s_cloexec_mutex);
+/***************************************************************************
+ *
+ * os_process_fork
+ *
+ * Description: Start a process executing a module with fork and execvp.
+ *
+ * Returns:
+ *   The pid of the new process, or -1 with errno set on failure.
+ *
+ **************************************************************************/
+static pid_t os_process_fork(NCS_OS_PROC_EXECUTE_TIMED_INFO *req,
+			     NCS_OS_ENVIRON_SET_NODE *node, int count)
+{
+	pid_t pid;
 
 	if ((pid = fork()) == 0) {
 		/* child part */
@@ -1080,13 +1176,77 @@ uint32_t ncs_os_process_execute_timed(NCS_OS_PROC_EXECUTE_TIMED_INFO *req)
 			       __FUNCTION__, req->i_script, strerror(errno));
 			exit(128);
 		}
-	} else if (pid > 0) {
+	}
+
+	return pid;
+}
+
+/***************************************************************************
+ *
+ * ncs_os_process_execute_timed
+ *
+ * Description: To execute a module in a new process with time-out.
+ *
+ * Synopsis:
+ *
+ * Call Arguments:
+ *   req - Request parameters.
+ *
+ * Returns:
+ *   Success or failure
+ *
+ * Notes:
+ *   The process is started with posix_spawn when available. If that fails,
+ *   e.g. the module cannot be executed, it is started with fork instead so
+ *   that the failure is reported through the callback as before.
+ *
+ **************************************************************************/
+uint32_t ncs_os_process_execute_timed(NCS_OS_PROC_EXECUTE_TIMED_INFO *req)
+{
+	int count;
+	pid_t pid = -1;
+	NCS_OS_ENVIRON_SET_NODE *node = NULL;
+
+	if ((req->i_script == NULL) || (req->i_cb == NULL))
+		return NCSCC_RC_FAILURE;
+
+	if (req->i_set_env_args == NULL)
+		count = 0;
+	else {
+		count = req->i_set_env_args->num_args;
+		node = req->i_set_env_args->env_arg;
+	}
+
+	m_NCS_LOCK(&module_cb.tree_lock, NCS_LOCK_WRITE);
+
+	if (module_cb.init != true) {
+		/* this will initializes the execute module control block */
+		if (start_exec_mod_cb() != NCSCC_RC_SUCCESS) {
+			m_NCS_UNLOCK(&module_cb.tree_lock, NCS_LOCK_WRITE);
+			syslog(LOG_ERR, "%s: start_exec_mod_cb failed",
+			       __FUNCTION__);
+			return NCSCC_RC_FAILURE;
+		}
+	}
+
+	osaf_mutex_lock_ordie(&s_cloexec_mutex);
+
+#ifdef OS_PROCESS_SPAWN_CLOSEFROM
+	pid = os_process_spawn(req, node, count);
+	if (pid == -1)
+		TRACE("%s: posix_spawn '%s' failed - %s", __FUNCTION__,
+		      req->i_script, strerror(errno));
+#endif
+	if (pid == -1)
+		pid = os_process_fork(req, node, count);
+
+	osaf_mutex_unlock_ordie(&s_cloexec_mutex);
+
+	if (pid > 0) {
 		/*
 		 * Parent - Add new pid in the tree,
 		 * start a timer, Wait for a signal from child.
 		 */
-		osaf_mutex_unlock_ordie(&s_cloexec_mutex);
-
 		if (NCSCC_RC_SUCCESS != add_new_req_pid_in_list(req, pid)) {
 			m_NCS_UNLOCK(&module_cb.tree_lock, NCS_LOCK_WRITE);
 			syslog(LOG_ERR, "%s: failed to add PID", __FUNCTION__);
@@ -1096,7 +1256,6 @@ uint32_t ncs_os_process_execute_timed(NCS_OS_PROC_EXECUTE_TIMED_INFO *req)
 		/* fork ERROR */
 		syslog(LOG_ERR, "%s: fork failed - %s", __FUNCTION__,
 		       strerror(errno));
-		osaf_mutex_unlock_ordie(&s_cloexec_mutex);
 		m_NCS_UNLOCK(&module_cb.tree_lock, NCS_LOCK_WRITE);
 		return NCSCC_RC_FAILURE;
 	}
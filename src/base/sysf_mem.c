@@ -45,6 +45,8 @@ value of a USRBUF and stores it in a given variable
 @@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@
 */
 
+#include <pthread.h>
+#include <stddef.h>
 #include "base/ncsgl_defs.h"
 #include "base/ncs_osprm.h"
 #include "base/ncs_svd.h"
@@ -413,6 +415,195 @@ NCSUB_POOL *ncsmmgr_ub_getpool(uint8_t pool_id)
 	return answer;
 }
 
+/***************************************************************************
+
+ USRDATA size classes
+
+ The USRDATAs of the pools that allocate from the heap have a payload area
+ of one of the sizes in ub_class_size, instead of always PAYLOAD_BUF_SIZE.
+ An encoding starts in the smallest class and sysf_reserve_at_end chains a
+ USRBUF of the next larger class each time the last one is full, so that a
+ small message costs a small allocation and a large one still ends up in
+ PAYLOAD_BUF_SIZE payloads.
+
+ Freed USRDATAs are kept on a free list per thread and class. When a list
+ is empty it is refilled from a global list, and when it is full half of it
+ is moved to the global list, which frees what does not fit.
+
+ ***************************************************************************/
+
+#define UB_NUM_CLASSES 3
+
+static const uint32_t ub_class_size[UB_NUM_CLASSES] = {256, 2048,
+						       PAYLOAD_BUF_SIZE};
+/* max # of free USRDATAs per thread and class, the global lists hold
+ * UB_GLOBAL_FACTOR times that */
+static const uint32_t ub_cache_max[UB_NUM_CLASSES] = {128, 32, 16};
+#define UB_GLOBAL_FACTOR 8
+
+typedef struct ub_cache {
+	USRDATA *head[UB_NUM_CLASSES];
+	uint32_t count[UB_NUM_CLASSES];
+} UB_CACHE;
+
+static __thread UB_CACHE ub_thread_cache;
+static __thread bool ub_thread_cache_reg;
+static UB_CACHE ub_global_cache;
+static pthread_mutex_t ub_global_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_key_t ub_cache_key;
+static pthread_once_t ub_cache_once = PTHREAD_ONCE_INIT;
+
+/* the link of a free USRDATA is kept in its payload area */
+static USRDATA **ub_next(USRDATA *ud) { return (USRDATA **)(void *)ud->Data; }
+
+static bool ub_pool_is_heap(const NCSUB_POOL *pool)
+{
+	return (pool->mem_alloc == sysf_leap_alloc ||
+		pool->mem_alloc == sysf_heap_alloc) &&
+	       (pool->mem_free == sysf_leap_free ||
+		pool->mem_free == sysf_heap_free);
+}
+
+static int ub_class_of(uint32_t size)
+{
+	int c;
+
+	for (c = 0; c < UB_NUM_CLASSES - 1; c++) {
+		if (size <= ub_class_size[c])
+			break;
+	}
+	return c;
+}
+
+/* move the n first USRDATAs of list c of 'from' to 'to' */
+static void ub_cache_move(UB_CACHE *from, UB_CACHE *to, int c, uint32_t n)
+{
+	while (n-- > 0 && from->head[c] != NULL) {
+		USRDATA *ud = from->head[c];
+
+		from->head[c] = *ub_next(ud);
+		from->count[c]--;
+		*ub_next(ud) = to->head[c];
+		to->head[c] = ud;
+		to->count[c]++;
+	}
+}
+
+/* give the USRDATAs of list c of a thread to the global list, free the ones
+ * that do not fit */
+static void ub_cache_flush(UB_CACHE *cache, int c, uint32_t n)
+{
+	uint32_t room;
+
+	pthread_mutex_lock(&ub_global_lock);
+	room = ub_cache_max[c] * UB_GLOBAL_FACTOR - ub_global_cache.count[c];
+	ub_cache_move(cache, &ub_global_cache, c, n < room ? n : room);
+	pthread_mutex_unlock(&ub_global_lock);
+
+	while (n-- > room && cache->head[c] != NULL) {
+		USRDATA *ud = cache->head[c];
+
+		cache->head[c] = *ub_next(ud);
+		cache->count[c]--;
+		free(ud);
+	}
+}
+
+static void ub_cache_exit(void *arg)
+{
+	UB_CACHE *cache = (UB_CACHE *)arg;
+	int c;
+
+	for (c = 0; c < UB_NUM_CLASSES; c++)
+		ub_cache_flush(cache, c, cache->count[c]);
+	/* USRDATAs freed by later destructors register the cache again */
+	ub_thread_cache_reg = false;
+}
+
+static void ub_cache_key_create(void)
+{
+	pthread_key_create(&ub_cache_key, ub_cache_exit);
+}
+
+static UB_CACHE *ub_cache_get(void)
+{
+	if (!ub_thread_cache_reg) {
+		/* to give the free USRDATAs back when the thread exits */
+		pthread_once(&ub_cache_once, ub_cache_key_create);
+		pthread_setspecific(ub_cache_key, &ub_thread_cache);
+		ub_thread_cache_reg = true;
+	}
+	return &ub_thread_cache;
+}
+
+/***************************************************************************
+ *  ub_data_alloc
+ *
+ * Allocate a USRDATA with at least 'size' octets of payload area from a
+ * pool. Pools that do not allocate from the heap always get the full
+ * PAYLOAD_BUF_SIZE.
+ ****************************************************************************/
+static USRDATA *ub_data_alloc(NCSUB_POOL *pool, uint8_t priority,
+			      uint32_t size)
+{
+	USRDATA *ud;
+	UB_CACHE *cache;
+	int c;
+
+	if (!ub_pool_is_heap(pool)) {
+		ud = (USRDATA *)pool->mem_alloc(sizeof(USRDATA), pool->pool_id,
+						priority);
+		if (ud != NULL)
+			ud->Size = PAYLOAD_BUF_SIZE;
+		goto done;
+	}
+
+	c = ub_class_of(size);
+	cache = ub_cache_get();
+	if (cache->head[c] == NULL) {
+		pthread_mutex_lock(&ub_global_lock);
+		ub_cache_move(&ub_global_cache, cache, c, ub_cache_max[c] / 2);
+		pthread_mutex_unlock(&ub_global_lock);
+	}
+
+	if ((ud = cache->head[c]) != NULL) {
+		cache->head[c] = *ub_next(ud);
+		cache->count[c]--;
+	} else {
+		ud = (USRDATA *)malloc(offsetof(USRDATA, Data) +
+				       ub_class_size[c]);
+		if (ud == NULL)
+			goto done;
+		ud->Size = ub_class_size[c];
+	}
+
+done:
+	if (ud != NULL)
+		ud->RefCnt = 1;
+	return ud;
+}
+
+/***************************************************************************
+ *  ub_data_free
+ ****************************************************************************/
+static void ub_data_free(NCSUB_POOL *pool, USRDATA *ud)
+{
+	UB_CACHE *cache;
+	int c;
+
+	if (!ub_pool_is_heap(pool)) {
+		pool->mem_free(ud, pool->pool_id);
+		return;
+	}
+
+	c = ub_class_of(ud->Size);
+	cache = ub_cache_get();
+	*ub_next(ud) = cache->head[c];
+	cache->head[c] = ud;
+	if (++cache->count[c] > ub_cache_max[c])
+		ub_cache_flush(cache, c, ub_cache_max[c] / 2);
+}
+
 /***********************************************************************/
 
 /***************************************************************************
@@ -421,6 +612,18 @@ NCSUB_POOL *ncsmmgr_ub_getpool(uint8_t pool_id)
 USRBUF *sysf_alloc_pkt(unsigned char pool_id, unsigned char priority, int num,
 		       unsigned int line, char *file)
 {
+	return sysf_alloc_pkt_size(pool_id, priority, PAYLOAD_BUF_SIZE);
+}
+
+/***************************************************************************
+ *  sysf_alloc_pkt_size
+ *
+ * Allocate a USRBUF with room for at least 'size' octets of data, besides
+ * the header and trailer reserve of the pool, PAYLOAD_BUF_SIZE at most.
+ ****************************************************************************/
+USRBUF *sysf_alloc_pkt_size(unsigned char pool_id, unsigned char priority,
+			    unsigned int size)
+{
 
 	USRBUF *ub;
 	USRDATA *ud;
@@ -435,11 +638,15 @@ USRBUF *sysf_alloc_pkt(unsigned char pool_id, unsigned char priority, int num,
 
 		if (pool_id >= UB_MAX_POOLS) {
 			m_PMGR_UNLK(&gl_ub_pool_mgr.lock);
+			m_NCS_MEM_FREE(ub, NCS_MEM_REGION_IO_DATA_HDR,
+				       NCS_SERVICE_ID_OS_SVCS, 2);
 			m_LEAP_DBG_SINK_VOID;
 			return NULL;
 		}
-		ud = (USRDATA *)gl_ub_pool_mgr.pools[pool_id].mem_alloc(
-		    sizeof(USRDATA), pool_id, priority);
+		ud = ub_data_alloc(&gl_ub_pool_mgr.pools[pool_id], priority,
+				   gl_ub_pool_mgr.pools[pool_id].hdr_reserve +
+				       size +
+				       gl_ub_pool_mgr.pools[pool_id].trlr_reserve);
 
 		if (ud == (USRDATA *)NULL) {
 			m_NCS_MEM_FREE(ub, NCS_MEM_REGION_IO_DATA_HDR,
@@ -447,8 +654,6 @@ USRBUF *sysf_alloc_pkt(unsigned char pool_id, unsigned char priority, int num,
 			ub = (USRBUF *)0;
 			m_PMGR_UNLK(&gl_ub_pool_mgr.lock);
 		} else {
-			/* Set up data fields... */
-			ud->RefCnt = 1;
 
 			/* Set up USRBUF fields... */
 			ub->payload = ud;
@@ -480,7 +685,7 @@ void sysf_free_pkt(USRBUF *ub)
 		if (--(ud->RefCnt) == 0) {
 			m_PMGR_LK(&gl_ub_pool_mgr.lock);
 
-			gl_ub_pool_mgr.pools[pool_id].mem_free(ud, pool_id);
+			ub_data_free(&gl_ub_pool_mgr.pools[pool_id], ud);
 			m_PMGR_UNLK(&gl_ub_pool_mgr.lock);
 		}
 	}
@@ -563,8 +768,9 @@ USRBUF *sysf_copy_pkt(USRBUF *dup_me)
 		 * its system policies.
 		 */
 
-		*ubp = (ub = (USRBUF *)m_MMGR_ALLOC_POOLBUFR(
-			    dup_me->pool_ops->pool_id, NCSMEM_HI_PRI));
+		*ubp = (ub = (USRBUF *)m_MMGR_ALLOC_POOLBUFR_SIZE(
+			    dup_me->pool_ops->pool_id, NCSMEM_HI_PRI,
+			    dup_me->start + dup_me->count));
 
 		if (ub == BNULL) {
 			m_MMGR_FREE_BUFR_LIST(ub_head);
@@ -579,8 +785,8 @@ USRBUF *sysf_copy_pkt(USRBUF *dup_me)
 		/* restore preserved payload ptr. and copy data into it */
 		ub->payload = payload;
 
-		memcpy(ub->payload->Data, dup_me->payload->Data,
-		       PAYLOAD_BUF_SIZE);
+		memcpy(ub->payload->Data + ub->start,
+		       dup_me->payload->Data + dup_me->start, ub->count);
 
 		/* setup link pointers */
 		ubp = &ub->link;
@@ -874,20 +1080,25 @@ char *sysf_reserve_at_end_amap(
 	/* Determine the minimum bytes that need to be reserved in the least */
 	min_rsrv = (int32_t)(total ? *io_size : 1);
 	space_left =
-	    sizeof(ub->payload->Data) - (ub_trlr_rsrv + ub->start + ub->count);
+	    ub->payload->Size - (ub_trlr_rsrv + ub->start + ub->count);
 
 	/* Partial reservation is ok */
 	if ((ub->payload->RefCnt > 1) || (space_left < min_rsrv)) {
-		/* Need to get one more! */
+		/* Need to get one more! At least of the next size class, the
+		 * chain grows geometrically. */
+		unsigned int size = ub->payload->Size + 1;
 
-		ub = (*ppb = (ub->link = m_MMGR_ALLOC_POOLBUFR(
-				  ub->pool_ops->pool_id, NCSMEM_HI_PRI)));
+		if (size < *io_size)
+			size = *io_size;
+
+		ub = (*ppb = (ub->link = m_MMGR_ALLOC_POOLBUFR_SIZE(
+				  ub->pool_ops->pool_id, NCSMEM_HI_PRI, size)));
 
 		if (ub == (USRBUF *)0) {
 			return NULL;
 		}
-		space_left = sizeof(ub->payload->Data) -
-			     (ub_trlr_rsrv + ub->start + ub->count);
+		space_left =
+		    ub->payload->Size - (ub_trlr_rsrv + ub->start + ub->count);
 	}
 
 	if (space_left < (int32_t)*io_size) {
@@ -956,8 +1167,8 @@ char *sysf_reserve_at_start(USRBUF **ppb, unsigned int size)
 
 	if ((ub->payload->RefCnt > 1) || (ub->start < size)) {
 		/* We must prepend a USRBUF to the one passed. */
-		ub =
-		    m_MMGR_ALLOC_POOLBUFR(ub->pool_ops->pool_id, NCSMEM_HI_PRI);
+		ub = m_MMGR_ALLOC_POOLBUFR_SIZE(ub->pool_ops->pool_id,
+						NCSMEM_HI_PRI, size);
 
 		if (ub == (USRBUF *)0) {
 			/* FAIL!!! */
@@ -985,8 +1196,10 @@ char *sysf_reserve_at_start(USRBUF **ppb, unsigned int size)
 		   (PAYLOAD_BUF_SIZE -
 		   gl_ub_pool_mgr.pools[ub->pool_ops->pool_id].trlr_reserve)
 		   -----------
+		   The payload area is of the size class fitting size.
+		   -----------
 		 */
-		ub->start = PAYLOAD_BUF_SIZE;
+		ub->start = ub->payload->Size;
 	}
 
 	ub->count += size; /* do the actual prepend. */
@@ -1267,19 +1480,18 @@ static char *sysf_reserve_in_mid(USRBUF *pb, unsigned int offset,
 
 	/* If payload has other users, need to allocate own copy */
 	if (pb->payload->RefCnt > 1) {
-		ud = (USRDATA *)pb->pool_ops->mem_alloc(
-		    sizeof(USRDATA), pb->pool_ops->pool_id, NCSMEM_HI_PRI);
+		ud = ub_data_alloc(pb->pool_ops, NCSMEM_HI_PRI,
+				   pb->payload->Size);
 
 		if (ud == (USRDATA *)NULL)
 			return (char *)0;
 
-		ud->RefCnt = 1;
-		memcpy(ud->Data, pb->payload->Data, sizeof(pb->payload->Data));
+		memcpy(ud->Data, pb->payload->Data, pb->payload->Size);
 		pb->payload->RefCnt--;
 		pb->payload = ud;
 	}
 
-	pload_size = sizeof(pb->payload->Data);
+	pload_size = pb->payload->Size;
 	post_data_len = pb->count - offset;
 
 	/*
@@ -1412,14 +1624,13 @@ char *sysf_write_in_mid(USRBUF *pb, unsigned int offset, unsigned int size,
 
 	/* If payload has other users, need to allocate own copy */
 	if (pb->payload->RefCnt > 1) {
-		ud = (USRDATA *)pb->pool_ops->mem_alloc(
-		    sizeof(USRDATA), pb->pool_ops->pool_id, NCSMEM_HI_PRI);
+		ud = ub_data_alloc(pb->pool_ops, NCSMEM_HI_PRI,
+				   pb->payload->Size);
 
 		if (ud == (USRDATA *)NULL)
 			return (char *)0;
 
-		ud->RefCnt = 1;
-		memcpy(ud->Data, pb->payload->Data, sizeof(pb->payload->Data));
+		memcpy(ud->Data, pb->payload->Data, pb->payload->Size);
 		pb->payload->RefCnt--;
 		pb->payload = ud;
 	}
@@ -1850,8 +2061,8 @@ USRBUF *sysf_copy_to_usrbuf(uint8_t *packet, unsigned int length)
 	src = packet;
 
 	/* Move the pdu into a buffer chain ... */
-	if ((first_uu_pdu = (uu_pdu = m_MMGR_ALLOC_BUFR(sizeof(USRBUF)))) ==
-	    BNULL) {
+	if ((first_uu_pdu = (uu_pdu = m_MMGR_ALLOC_POOLBUFR_SIZE(
+				 0, 0, length))) == BNULL) {
 		m_MMGR_FREE_BUFR_LIST(uu_pdu);
 		return BNULL;
 	}
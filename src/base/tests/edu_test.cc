@@ -0,0 +1,527 @@
+/*      -*- OpenSAF  -*-
+ *
+ * (C) Copyright 2017 The OpenSAF Foundation
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. This file and program are licensed
+ * under the GNU Lesser General Public License Version 2.1, February 1999.
+ * The complete license can be accessed from the following location:
+ * http://opensource.org/licenses/lgpl-license.php
+ * See the Copying file included with the OpenSAF distribution for full
+ * licensing terms.
+ *
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include "base/ncs_edu_pub.h"
+#include "base/ncs_svd.h"
+#include "base/ncssysf_mem.h"
+#include "gtest/gtest.h"
+extern "C" {
+#include "ckpt/common/cpsv.h"
+#include "msg/common/mqsv.h"
+#include "msg/common/mqsv_edu.h"
+FUNC_DECLARATION(CPSV_EVT);
+}
+
+// The same data is encoded and decoded with the compiled EDP rules and with
+// the rules only interpreted, the encoded octets and the decoded data must
+// be the same.
+
+namespace {
+
+struct Inner {
+  uint16_t a;
+  uint64_t b;
+  bool c;
+};
+
+struct Node {
+  uint32_t value;
+  char tag[8];
+  Node *next;
+};
+
+struct Msg {
+  uint8_t u8;
+  int8_t i8;
+  uint16_t u16;
+  int16_t i16;
+  uint32_t u32;
+  int32_t i32;
+  uint64_t u64;
+  int64_t i64;
+  bool flag;
+  char name[32];
+  uint32_t arr[5];
+  uint8_t bytes[10];
+  Inner inner;
+  Inner *opt;
+  uint32_t len;
+  uint8_t *data;
+  uint32_t type;
+  union {
+    uint32_t x;
+    uint64_t y;
+  } u;
+  uint16_t tail_a;
+  uint32_t tail_b;
+  Node *list;
+};
+
+template <typename T>
+T *DecPtr(NCSCONTEXT ptr, EDP_OP_TYPE op) {
+  if (op != EDP_OP_TYPE_DEC) return static_cast<T *>(ptr);
+  T **d_ptr = static_cast<T **>(ptr);
+  if (*d_ptr == nullptr) *d_ptr = static_cast<T *>(calloc(1, sizeof(T)));
+  return *d_ptr;
+}
+
+uint32_t EdpInner(EDU_HDL *edu_hdl, EDU_TKN *edu_tkn, NCSCONTEXT ptr,
+                  uint32_t *ptr_data_len, EDU_BUF_ENV *buf_env,
+                  EDP_OP_TYPE op, EDU_ERR *o_err) {
+  EDU_INST_SET rules[] = {
+      {EDU_START, EdpInner, 0, 0, 0, sizeof(Inner), 0, nullptr},
+      {EDU_EXEC, ncs_edp_uns16, 0, 0, 0, offsetof(Inner, a), 0, nullptr},
+      {EDU_EXEC, ncs_edp_uns64, 0, 0, 0, offsetof(Inner, b), 0, nullptr},
+      {EDU_EXEC, ncs_edp_ncs_bool, 0, 0, 0, offsetof(Inner, c), 0, nullptr},
+      {EDU_END, 0, 0, 0, 0, 0, 0, nullptr},
+  };
+  Inner *inner = DecPtr<Inner>(ptr, op);
+  if (inner == nullptr) return NCSCC_RC_FAILURE;
+  return m_NCS_EDU_RUN_RULES(edu_hdl, edu_tkn, rules, inner, ptr_data_len,
+                             buf_env, op, o_err);
+}
+
+uint32_t EdpNode(EDU_HDL *edu_hdl, EDU_TKN *edu_tkn, NCSCONTEXT ptr,
+                 uint32_t *ptr_data_len, EDU_BUF_ENV *buf_env, EDP_OP_TYPE op,
+                 EDU_ERR *o_err) {
+  EDU_INST_SET rules[] = {
+      {EDU_START, EdpNode, EDQ_LNKLIST, 0, 0, sizeof(Node), 0, nullptr},
+      {EDU_EXEC, ncs_edp_uns32, 0, 0, 0, offsetof(Node, value), 0, nullptr},
+      {EDU_EXEC, ncs_edp_char, EDQ_ARRAY, 0, 0, offsetof(Node, tag), 8,
+       nullptr},
+      {EDU_TEST_LL_PTR, EdpNode, 0, 0, 0, offsetof(Node, next), 0, nullptr},
+      {EDU_END, 0, 0, 0, 0, 0, 0, nullptr},
+  };
+  Node *node = DecPtr<Node>(ptr, op);
+  if (node == nullptr) return NCSCC_RC_FAILURE;
+  return m_NCS_EDU_RUN_RULES(edu_hdl, edu_tkn, rules, node, ptr_data_len,
+                             buf_env, op, o_err);
+}
+
+int TestType(NCSCONTEXT arg) {
+  return *static_cast<uint32_t *>(arg) == 1 ? 1 : 2;
+}
+
+uint32_t EdpMsg(EDU_HDL *edu_hdl, EDU_TKN *edu_tkn, NCSCONTEXT ptr,
+                uint32_t *ptr_data_len, EDU_BUF_ENV *buf_env, EDP_OP_TYPE op,
+                EDU_ERR *o_err) {
+  EDU_INST_SET rules[] = {
+      {EDU_START, EdpMsg, 0, 0, 0, sizeof(Msg), 0, nullptr},
+      {EDU_EXEC, ncs_edp_uns8, 0, 0, 0, offsetof(Msg, u8), 0, nullptr},
+      {EDU_EXEC, ncs_edp_int8, 0, 0, 0, offsetof(Msg, i8), 0, nullptr},
+      {EDU_EXEC, ncs_edp_uns16, 0, 0, 0, offsetof(Msg, u16), 0, nullptr},
+      {EDU_EXEC, ncs_edp_int16, 0, 0, 0, offsetof(Msg, i16), 0, nullptr},
+      {EDU_EXEC, ncs_edp_uns32, 0, 0, 0, offsetof(Msg, u32), 0, nullptr},
+      {EDU_EXEC, ncs_edp_int32, 0, 0, 0, offsetof(Msg, i32), 0, nullptr},
+      {EDU_EXEC, ncs_edp_uns64, 0, 0, 0, offsetof(Msg, u64), 0, nullptr},
+      {EDU_EXEC, ncs_edp_int64, 0, 0, 0, offsetof(Msg, i64), 0, nullptr},
+      {EDU_EXEC, ncs_edp_ncs_bool, 0, 0, 0, offsetof(Msg, flag), 0, nullptr},
+      {EDU_EXEC, ncs_edp_char, EDQ_ARRAY, 0, 0, offsetof(Msg, name), 32,
+       nullptr},
+      {EDU_EXEC, ncs_edp_uns32, EDQ_ARRAY, 0, 0, offsetof(Msg, arr), 5,
+       nullptr},
+      {EDU_EXEC, ncs_edp_uns8, EDQ_ARRAY, 0, 0, offsetof(Msg, bytes), 10,
+       nullptr},
+      {EDU_EXEC, EdpInner, 0, 0, 0, offsetof(Msg, inner), 0, nullptr},
+      {EDU_EXEC, EdpInner, EDQ_POINTER, 0, 0, offsetof(Msg, opt), 0, nullptr},
+      {EDU_EXEC, ncs_edp_uns32, 0, 0, 0, offsetof(Msg, len), 0, nullptr},
+      {EDU_EXEC, ncs_edp_uns8, EDQ_VAR_LEN_DATA, ncs_edp_uns32, 0,
+       offsetof(Msg, data), offsetof(Msg, len), nullptr},
+      {EDU_EXEC_EXT, nullptr, NCS_SERVICE_ID_COMMON, nullptr, 0, 0, 0,
+       nullptr},
+      {EDU_EXEC, ncs_edp_uns32, 0, 0, 0, offsetof(Msg, type), 0, nullptr},
+      {EDU_TEST, ncs_edp_uns32, 0, 0, 0, offsetof(Msg, type), 0, TestType},
+      // 20: jumps over the other member of the union
+      {EDU_EXEC, ncs_edp_uns32, 0, 0, 22, offsetof(Msg, u.x), 0, nullptr},
+      // 21: encoded together with the tail
+      {EDU_EXEC, ncs_edp_uns64, 0, 0, 0, offsetof(Msg, u.y), 0, nullptr},
+      {EDU_EXEC, ncs_edp_uns16, 0, 0, 0, offsetof(Msg, tail_a), 0, nullptr},
+      {EDU_EXEC, ncs_edp_uns32, 0, 0, 0, offsetof(Msg, tail_b), 0, nullptr},
+      {EDU_EXEC, EdpNode, EDQ_POINTER, 0, 0, offsetof(Msg, list), 0, nullptr},
+      {EDU_END, 0, 0, 0, 0, 0, 0, nullptr},
+  };
+  Msg *msg = DecPtr<Msg>(ptr, op);
+  if (msg == nullptr) return NCSCC_RC_FAILURE;
+  return m_NCS_EDU_RUN_RULES(edu_hdl, edu_tkn, rules, msg, ptr_data_len,
+                             buf_env, op, o_err);
+}
+
+void FreeMsg(Msg *msg) {
+  free(msg->opt);
+  free(msg->data);
+  for (Node *node = msg->list; node != nullptr;) {
+    Node *next = node->next;
+    free(node);
+    node = next;
+  }
+  free(msg);
+}
+
+void ExpectSame(const Msg &a, const Msg &b) {
+  EXPECT_EQ(a.u8, b.u8);
+  EXPECT_EQ(a.i8, b.i8);
+  EXPECT_EQ(a.u16, b.u16);
+  EXPECT_EQ(a.i16, b.i16);
+  EXPECT_EQ(a.u32, b.u32);
+  EXPECT_EQ(a.i32, b.i32);
+  EXPECT_EQ(a.u64, b.u64);
+  EXPECT_EQ(a.i64, b.i64);
+  EXPECT_EQ(a.flag, b.flag);
+  EXPECT_STREQ(a.name, b.name);
+  EXPECT_EQ(0, memcmp(a.arr, b.arr, sizeof(a.arr)));
+  EXPECT_EQ(0, memcmp(a.bytes, b.bytes, sizeof(a.bytes)));
+  EXPECT_EQ(a.inner.a, b.inner.a);
+  EXPECT_EQ(a.inner.b, b.inner.b);
+  EXPECT_EQ(a.inner.c, b.inner.c);
+  ASSERT_EQ(a.opt == nullptr, b.opt == nullptr);
+  if (a.opt != nullptr) {
+    EXPECT_EQ(a.opt->a, b.opt->a);
+    EXPECT_EQ(a.opt->b, b.opt->b);
+    EXPECT_EQ(a.opt->c, b.opt->c);
+  }
+  ASSERT_EQ(a.len, b.len);
+  if (a.len != 0) {
+    EXPECT_EQ(0, memcmp(a.data, b.data, a.len));
+  }
+  EXPECT_EQ(a.type, b.type);
+  if (a.type == 1) {
+    EXPECT_EQ(a.u.x, b.u.x);
+  } else {
+    EXPECT_EQ(a.u.y, b.u.y);
+  }
+  EXPECT_EQ(a.tail_a, b.tail_a);
+  EXPECT_EQ(a.tail_b, b.tail_b);
+  const Node *x = a.list, *y = b.list;
+  for (; x != nullptr && y != nullptr; x = x->next, y = y->next) {
+    EXPECT_EQ(x->value, y->value);
+    EXPECT_STREQ(x->tag, y->tag);
+  }
+  EXPECT_EQ(x, y);
+}
+
+class EduTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    ASSERT_EQ(NCSCC_RC_SUCCESS, ncs_edu_hdl_init(&hdl_));
+  }
+
+  void TearDown() override { ncs_edu_hdl_flush(&hdl_); }
+
+  // Fills in the message, with 'num_nodes' elements in the linked list
+  void Fill(uint32_t type, bool with_opt, uint32_t len, size_t num_nodes) {
+    memset(&msg_, 0, sizeof(msg_));
+    msg_.u8 = 0xf1;
+    msg_.i8 = -3;
+    msg_.u16 = 0xbeef;
+    msg_.i16 = -1234;
+    msg_.u32 = 0xdeadbeef;
+    msg_.i32 = -123456789;
+    msg_.u64 = 0x0123456789abcdefULL;
+    msg_.i64 = -1234567890123LL;
+    msg_.flag = true;
+    strcpy(msg_.name, "safComp=A,safSu=1");
+    for (uint32_t i = 0; i < 5; ++i) msg_.arr[i] = 0x01010101 * (i + 1);
+    for (uint8_t i = 0; i < 10; ++i) msg_.bytes[i] = 0xa0 + i;
+    inner_ = Inner{0x4242, 0xfeedfacecafef00dULL, true};
+    msg_.inner = Inner{0x1111, 0x2222333344445555ULL, false};
+    msg_.opt = with_opt ? &inner_ : nullptr;
+    data_.resize(len);
+    for (uint32_t i = 0; i < len; ++i) data_[i] = static_cast<uint8_t>(i * 13);
+    msg_.len = len;
+    msg_.data = len != 0 ? data_.data() : nullptr;
+    msg_.type = type;
+    if (type == 1)
+      msg_.u.x = 0x77665544;
+    else
+      msg_.u.y = 0x8877665544332211ULL;
+    msg_.tail_a = 0x5a5a;
+    msg_.tail_b = 0xc3c3c3c3;
+    nodes_.assign(num_nodes, Node{});
+    for (size_t i = 0; i < num_nodes; ++i) {
+      nodes_[i].value = 100 + i;
+      snprintf(nodes_[i].tag, sizeof(nodes_[i].tag), "n%zu", i);
+      nodes_[i].next = i + 1 < num_nodes ? &nodes_[i + 1] : nullptr;
+    }
+    msg_.list = num_nodes != 0 ? nodes_.data() : nullptr;
+  }
+
+  std::vector<uint8_t> Encode(bool interpret_only) {
+    NCS_UBAID uba;
+    EDU_ERR err = EDU_NORMAL;
+    hdl_.interpret_only = interpret_only;
+    EXPECT_EQ(NCSCC_RC_SUCCESS, ncs_enc_init_space(&uba));
+    EXPECT_EQ(NCSCC_RC_SUCCESS, m_NCS_EDU_EXEC(&hdl_, EdpMsg, &uba,
+                                               EDP_OP_TYPE_ENC, &msg_, &err));
+    std::vector<uint8_t> out(m_MMGR_LINK_DATA_LEN(uba.start));
+    sysf_copy_from_usrbuf(uba.start, out.data(), out.size());
+    m_MMGR_FREE_BUFR_LIST(uba.start);
+    return out;
+  }
+
+  // Decodes the octets, from USRBUFs of 'piece' octets each, for the
+  // compiled rules to flatten runs across USRBUFs
+  Msg *Decode(const std::vector<uint8_t> &in, size_t piece,
+              bool interpret_only) {
+    USRBUF *ub = nullptr;
+    for (size_t i = 0; i < in.size(); i += piece) {
+      uint8_t buf[256];
+      size_t n = std::min(piece, in.size() - i);
+      memcpy(buf, &in[i], n);
+      USRBUF *p = sysf_copy_to_usrbuf(buf, n);
+      if (ub == nullptr)
+        ub = p;
+      else
+        m_MMGR_APPEND_DATA(ub, p);
+    }
+    NCS_UBAID uba;
+    ncs_dec_init_space(&uba, ub);
+    Msg *msg = nullptr;
+    EDU_ERR err = EDU_NORMAL;
+    hdl_.interpret_only = interpret_only;
+    EXPECT_EQ(NCSCC_RC_SUCCESS, m_NCS_EDU_EXEC(&hdl_, EdpMsg, &uba,
+                                               EDP_OP_TYPE_DEC, &msg, &err));
+    m_MMGR_FREE_BUFR_LIST(uba.ub);
+    return msg;
+  }
+
+  void CheckBothWays() {
+    std::vector<uint8_t> interpreted = Encode(true);
+    std::vector<uint8_t> compiled = Encode(false);
+    EXPECT_EQ(interpreted, compiled);
+    for (size_t piece : {size_t{1}, size_t{7}, size_t{256}}) {
+      for (bool interpret_only : {true, false}) {
+        Msg *msg = Decode(compiled, piece, interpret_only);
+        ASSERT_NE(nullptr, msg);
+        ExpectSame(msg_, *msg);
+        FreeMsg(msg);
+      }
+    }
+  }
+
+  EDU_HDL hdl_;
+  Msg msg_;
+  Inner inner_;
+  std::vector<uint8_t> data_;
+  std::vector<Node> nodes_;
+};
+
+}  // namespace
+
+TEST_F(EduTest, AllFields) {
+  Fill(1, true, 40, 3);
+  CheckBothWays();
+}
+
+TEST_F(EduTest, OtherUnionMember) {
+  Fill(2, true, 40, 3);
+  CheckBothWays();
+}
+
+TEST_F(EduTest, NullPointersAndEmptyData) {
+  Fill(2, false, 0, 0);
+  msg_.name[0] = '\0';
+  CheckBothWays();
+}
+
+TEST_F(EduTest, LongList) {
+  Fill(1, false, 1000, 50);
+  CheckBothWays();
+}
+
+TEST_F(EduTest, SameAfterRecompile) {
+  Fill(1, true, 8, 1);
+  std::vector<uint8_t> first = Encode(false);
+  ncs_edu_hdl_flush(&hdl_);
+  ASSERT_EQ(NCSCC_RC_SUCCESS, ncs_edu_hdl_init(&hdl_));
+  EXPECT_EQ(first, Encode(false));
+}
+
+TEST_F(EduTest, TooLongStringIsRejected) {
+  Fill(1, false, 0, 0);
+  std::vector<uint8_t> octets = Encode(false);
+  // The u16 string length follows the scalars, bool is 4 octets
+  const size_t kNameLen = 1 + 1 + 2 + 2 + 4 + 4 + 8 + 8 + 4;
+  ASSERT_GT(octets.size(), kNameLen + 2);
+  octets[kNameLen] = 0;
+  octets[kNameLen + 1] = 33;
+  octets.resize(kNameLen + 2 + 33, 'x');
+  USRBUF *ub = sysf_copy_to_usrbuf(octets.data(), octets.size());
+  NCS_UBAID uba;
+  ncs_dec_init_space(&uba, ub);
+  Msg *msg = nullptr;
+  EDU_ERR err = EDU_NORMAL;
+  EXPECT_NE(NCSCC_RC_SUCCESS,
+            m_NCS_EDU_EXEC(&hdl_, EdpMsg, &uba, EDP_OP_TYPE_DEC, &msg, &err));
+  EXPECT_EQ(EDU_ERR_UBUF_PARSE_FAIL, err);
+  m_MMGR_FREE_BUFR_LIST(uba.ub);
+  free(msg);
+}
+
+namespace {
+
+void SetName(SaNameT *name, const char *value) {
+  name->length = strlen(value);
+  memcpy(name->value, value, name->length);
+}
+
+void FreeCheckpointWrite(void *msg) {
+  CPSV_EVT *evt = static_cast<CPSV_EVT *>(msg);
+  CPSV_CKPT_DATA *next;
+  for (CPSV_CKPT_DATA *section = evt->info.cpnd.info.ckpt_write.data;
+       section != nullptr; section = next) {
+    next = section->next;
+    free(section->sec_id.id);
+    free(section->data);
+    free(section);
+  }
+  free(evt);
+}
+
+// Encode and decode rate of messages of the services, through their own
+// EDPs, with the compiled programs and with the rules only interpreted.
+// Run with
+//   bin/libbase_test --gtest_also_run_disabled_tests --gtest_filter='*Bench*'
+class EduBench : public ::testing::Test {
+ protected:
+  static constexpr int kMessages = 200000;
+
+  void SetUp() override {
+    ASSERT_EQ(NCSCC_RC_SUCCESS, ncs_edu_hdl_init(&hdl_));
+  }
+
+  void TearDown() override { ncs_edu_hdl_flush(&hdl_); }
+
+  // Encodes the message of 'size' octets kMessages times, then decodes it
+  // as many times and frees each decoded message with 'free_msg'
+  void Run(const char *name, EDU_PROG_HANDLER edp, void *msg, size_t size,
+           void (*free_msg)(void *)) {
+    double enc_us[2], dec_us[2];
+    std::vector<uint8_t> octets[2];
+    for (bool interpret_only : {true, false}) {
+      hdl_.interpret_only = interpret_only;
+      auto start = std::chrono::steady_clock::now();
+      for (int i = 0; i < kMessages; ++i) {
+        NCS_UBAID uba;
+        EDU_ERR err = EDU_NORMAL;
+        ASSERT_EQ(NCSCC_RC_SUCCESS, ncs_enc_init_space(&uba));
+        ASSERT_EQ(NCSCC_RC_SUCCESS, m_NCS_EDU_EXEC(&hdl_, edp, &uba,
+                                                   EDP_OP_TYPE_ENC, msg,
+                                                   &err));
+        if (i == 0) {
+          octets[interpret_only].resize(m_MMGR_LINK_DATA_LEN(uba.start));
+          sysf_copy_from_usrbuf(uba.start, octets[interpret_only].data(),
+                                octets[interpret_only].size());
+        }
+        m_MMGR_FREE_BUFR_LIST(uba.start);
+      }
+      enc_us[interpret_only] = Elapsed(start);
+
+      const std::vector<uint8_t> &in = octets[interpret_only];
+      start = std::chrono::steady_clock::now();
+      for (int i = 0; i < kMessages; ++i) {
+        USRBUF *ub = sysf_copy_to_usrbuf(const_cast<uint8_t *>(in.data()),
+                                         in.size());
+        NCS_UBAID uba;
+        ncs_dec_init_space(&uba, ub);
+        // the EDPs of the services decode into an allocated message
+        void *out = calloc(1, size);
+        EDU_ERR err = EDU_NORMAL;
+        ASSERT_EQ(NCSCC_RC_SUCCESS, m_NCS_EDU_EXEC(&hdl_, edp, &uba,
+                                                   EDP_OP_TYPE_DEC, &out,
+                                                   &err));
+        m_MMGR_FREE_BUFR_LIST(uba.ub);
+        free_msg(out);
+      }
+      dec_us[interpret_only] = Elapsed(start);
+    }
+    EXPECT_EQ(octets[0], octets[1]);
+
+    printf("%s, %zu octets: interpreted encode %.2f us, decode %.2f us; "
+           "compiled encode %.2f us, decode %.2f us\n",
+           name, octets[0].size(), enc_us[1], dec_us[1], enc_us[0],
+           dec_us[0]);
+  }
+
+  // Time per message since start
+  static double Elapsed(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::micro>(
+               std::chrono::steady_clock::now() - start)
+               .count() /
+           kMessages;
+  }
+
+  EDU_HDL hdl_;
+};
+
+// A checkpoint write of CPA to CPND, with 4 sections of 64 octets
+TEST_F(EduBench, DISABLED_CpsvCheckpointWrite) {
+  const int kSections = 4;
+  std::vector<uint8_t> data(64, 0x5a);
+  char ids[kSections][16];
+  CPSV_CKPT_DATA sections[kSections];
+  memset(sections, 0, sizeof(sections));
+  for (int i = 0; i < kSections; ++i) {
+    snprintf(ids[i], sizeof(ids[i]), "section%d", i);
+    sections[i].sec_id.idLen = strlen(ids[i]);
+    sections[i].sec_id.id = reinterpret_cast<SaUint8T *>(ids[i]);
+    sections[i].data = data.data();
+    sections[i].dataSize = data.size();
+    sections[i].dataOffset = 64 * i;
+    sections[i].next = i + 1 < kSections ? &sections[i + 1] : nullptr;
+  }
+  CPSV_EVT evt;
+  memset(&evt, 0, sizeof(evt));
+  evt.type = CPSV_EVT_TYPE_CPND;
+  evt.info.cpnd.type = CPND_EVT_A2ND_CKPT_WRITE;
+  CPSV_CKPT_ACCESS &write = evt.info.cpnd.info.ckpt_write;
+  write.type = CPSV_CKPT_ACCESS_WRITE;
+  write.ckpt_id = 0x1234;
+  write.lcl_ckpt_id = 0x5678;
+  write.agent_mdest = 0x2010f00000001ULL;
+  write.num_of_elmts = kSections;
+  write.data = sections;
+
+  Run("CPSV checkpoint write", FUNC_NAME(CPSV_EVT), &evt, sizeof(evt),
+      FreeCheckpointWrite);
+}
+
+// A queue open of MQA to MQND
+TEST_F(EduBench, DISABLED_MqsvQueueOpen) {
+  MQSV_EVT evt;
+  memset(&evt, 0, sizeof(evt));
+  evt.type = MQSV_EVT_MQP_REQ;
+  evt.msg.mqp_req.type = MQP_EVT_OPEN_REQ;
+  evt.msg.mqp_req.agent_mds_dest = 0x2010f00000001ULL;
+  MQP_OPEN_REQ &open = evt.msg.mqp_req.info.openReq;
+  open.msgHandle = 0x1234;
+  SetName(&open.queueName, "safMq=queue1,safApp=app1");
+  open.creationAttributes.creationFlags = SA_MSG_QUEUE_PERSISTENT;
+  for (SaSizeT &size : open.creationAttributes.size) size = 4096;
+  open.creationAttributes.retentionTime = 1000000000;
+  open.openFlags = SA_MSG_QUEUE_CREATE;
+  open.timeout = 10000000000LL;
+
+  Run("MQSV queue open", mqsv_edp_mqsv_evt, &evt, sizeof(evt), free);
+}
+
+}  // namespace
@@ -0,0 +1,230 @@
+/*      -*- OpenSAF  -*-
+ *
+ * (C) Copyright 2017 The OpenSAF Foundation
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. This file and program are licensed
+ * under the GNU Lesser General Public License Version 2.1, February 1999.
+ * The complete license can be accessed from the following location:
+ * http://opensource.org/licenses/lgpl-license.php
+ * See the Copying file included with the OpenSAF distribution for full
+ * licensing terms.
+ *
+ */
+
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "base/ncs_osprm.h"
+#include "gtest/gtest.h"
+extern "C" {
+#include "base/ncssysf_def.h"
+}
+
+namespace {
+
+// Collects the results of the commands started by the fixture, which the
+// execute module reports from its own thread
+struct Results {
+  std::mutex mutex;
+  std::condition_variable done;
+  std::vector<NCS_OS_PROC_EXEC_STATUS> status;
+};
+
+Results results;
+
+uint32_t ExecuteCallback(NCS_OS_PROC_EXECUTE_TIMED_CB_INFO *info) {
+  std::lock_guard<std::mutex> lock(results.mutex);
+  results.status.push_back(info->exec_stat.value);
+  results.done.notify_all();
+  return NCSCC_RC_SUCCESS;
+}
+
+class OsProcessExecuteTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    // The execute module needs the timer service of LEAP
+    ASSERT_EQ(leap_env_init(), NCSCC_RC_SUCCESS);
+    Clear();
+  }
+
+  void TearDown() override { leap_env_destroy(); }
+
+  static void Clear() {
+    std::lock_guard<std::mutex> lock(results.mutex);
+    results.status.clear();
+  }
+
+  // Starts command with argv, with the environment variables in env
+  static uint32_t Execute(std::vector<const char *> argv,
+                          std::vector<NCS_OS_ENVIRON_SET_NODE> env = {},
+                          int64_t timeout_in_ms = 10000) {
+    argv.push_back(nullptr);
+    NCS_OS_ENVIRON_ARGS env_args;
+    env_args.num_args = env.size();
+    env_args.env_arg = env.data();
+    NCS_OS_PROC_EXECUTE_TIMED_INFO req;
+    memset(&req, 0, sizeof(req));
+    req.i_script = const_cast<char *>(argv[0]);
+    req.i_argc = argv.size() - 1;
+    req.i_argv = const_cast<char **>(argv.data());
+    req.i_set_env_args = &env_args;
+    req.i_timeout_in_ms = timeout_in_ms;
+    req.i_cb = ExecuteCallback;
+    return ncs_os_process_execute_timed(&req);
+  }
+
+  // Waits for the results of the first count commands
+  static std::vector<NCS_OS_PROC_EXEC_STATUS> Wait(size_t count) {
+    std::unique_lock<std::mutex> lock(results.mutex);
+    EXPECT_TRUE(results.done.wait_for(lock, std::chrono::seconds(30), [&] {
+      return results.status.size() >= count;
+    }));
+    return results.status;
+  }
+
+  // Runs a shell command and returns its result
+  static NCS_OS_PROC_EXEC_STATUS Shell(
+      const char *command, std::vector<NCS_OS_ENVIRON_SET_NODE> env = {}) {
+    Clear();
+    EXPECT_EQ(Execute({"/bin/sh", "-c", command}, env), NCSCC_RC_SUCCESS);
+    std::vector<NCS_OS_PROC_EXEC_STATUS> status = Wait(1);
+    return status.empty() ? NCS_OS_PROC_EXEC_FAIL : status[0];
+  }
+};
+
+TEST_F(OsProcessExecuteTest, ExitStatus) {
+  EXPECT_EQ(Shell("exit 0"), NCS_OS_PROC_EXIT_NORMAL);
+  EXPECT_EQ(Shell("exit 3"), NCS_OS_PROC_EXIT_WITH_CODE);
+  EXPECT_EQ(Shell("kill -TERM $$"), NCS_OS_PROC_EXIT_ON_SIGNAL);
+}
+
+TEST_F(OsProcessExecuteTest, CommandNotFound) {
+  ASSERT_EQ(Execute({"/nonexistent/command"}), NCSCC_RC_SUCCESS);
+  std::vector<NCS_OS_PROC_EXEC_STATUS> status = Wait(1);
+  ASSERT_EQ(status.size(), 1u);
+  EXPECT_EQ(status[0], NCS_OS_PROC_EXEC_FAIL);
+}
+
+TEST_F(OsProcessExecuteTest, Timeout) {
+  ASSERT_EQ(Execute({"/bin/sleep", "10"}, {}, 100), NCSCC_RC_SUCCESS);
+  std::vector<NCS_OS_PROC_EXEC_STATUS> status = Wait(1);
+  ASSERT_EQ(status.size(), 1u);
+  EXPECT_EQ(status[0], NCS_OS_PROC_EXIT_WAIT_TIMEOUT);
+}
+
+TEST_F(OsProcessExecuteTest, Environment) {
+  setenv("OS_PROCESS_EXECUTE_KEPT", "old", 1);
+  setenv("OS_PROCESS_EXECUTE_REPLACED", "old", 1);
+  char kept[] = "OS_PROCESS_EXECUTE_KEPT";
+  char replaced[] = "OS_PROCESS_EXECUTE_REPLACED";
+  char added[] = "OS_PROCESS_EXECUTE_ADDED";
+  char value[] = "new";
+  std::vector<NCS_OS_ENVIRON_SET_NODE> env = {
+      {kept, value, 0}, {replaced, value, 1}, {added, value, 0}};
+  EXPECT_EQ(Shell("test \"$OS_PROCESS_EXECUTE_KEPT\" = old && "
+                  "test \"$OS_PROCESS_EXECUTE_REPLACED\" = new && "
+                  "test \"$OS_PROCESS_EXECUTE_ADDED\" = new",
+                  env),
+            NCS_OS_PROC_EXIT_NORMAL);
+  unsetenv("OS_PROCESS_EXECUTE_KEPT");
+  unsetenv("OS_PROCESS_EXECUTE_REPLACED");
+  EXPECT_EQ(getenv("OS_PROCESS_EXECUTE_ADDED"), nullptr);
+}
+
+TEST_F(OsProcessExecuteTest, OnlyStandardFilesOnDevNull) {
+  int fd = dup2(STDOUT_FILENO, 50);
+  ASSERT_EQ(fd, 50);
+  EXPECT_EQ(Shell("for fd in 0 1 2; do "
+                  "test \"$(readlink /proc/$$/fd/$fd)\" = /dev/null || "
+                  "exit 1; done; test ! -e /proc/$$/fd/50"),
+            NCS_OS_PROC_EXIT_NORMAL);
+  close(fd);
+}
+
+// Launch rate of commands from a process of a given size, as AMFND starts
+// CLC-CLI commands. The launches are compared with the way commands were
+// started before posix_spawn was used: fork, close every possible file
+// descriptor and exec.
+class OsProcessExecuteBench : public OsProcessExecuteTest {
+ protected:
+  static constexpr int kLaunches = 200;
+
+  void SetUp() override {
+    OsProcessExecuteTest::SetUp();
+    getrlimit(RLIMIT_NOFILE, &saved_limit_);
+    struct rlimit limit = saved_limit_;
+    limit.rlim_cur = std::min<rlim_t>(20000, limit.rlim_max);
+    setrlimit(RLIMIT_NOFILE, &limit);
+  }
+
+  void TearDown() override {
+    setrlimit(RLIMIT_NOFILE, &saved_limit_);
+    OsProcessExecuteTest::TearDown();
+  }
+
+  static pid_t ForkExec() {
+    pid_t pid = fork();
+    if (pid == 0) {
+      struct sched_param param = {0};
+      sched_setscheduler(0, SCHED_OTHER, &param);
+      for (int i = sysconf(_SC_OPEN_MAX) - 1; i >= 0; --i) close(i);
+      execl("/bin/true", "/bin/true", nullptr);
+      _exit(128);
+    }
+    return pid;
+  }
+
+  void Run(size_t rss_mb) {
+    std::vector<char> rss(rss_mb << 20);
+    memset(rss.data(), 1, rss.size());
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<pid_t> pids;
+    for (int i = 0; i < kLaunches; i++) pids.push_back(ForkExec());
+    auto fork_time = std::chrono::steady_clock::now() - start;
+    for (pid_t pid : pids) waitpid(pid, nullptr, 0);
+
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < kLaunches; i++) {
+      ASSERT_EQ(Execute({"/bin/true"}), NCSCC_RC_SUCCESS);
+    }
+    auto execute_time = std::chrono::steady_clock::now() - start;
+    std::vector<NCS_OS_PROC_EXEC_STATUS> status = Wait(kLaunches);
+    ASSERT_EQ(status.size(), static_cast<size_t>(kLaunches));
+    for (NCS_OS_PROC_EXEC_STATUS s : status) {
+      EXPECT_EQ(s, NCS_OS_PROC_EXIT_NORMAL);
+    }
+
+    using std::chrono::milliseconds;
+    long fork_ms =
+        std::chrono::duration_cast<milliseconds>(fork_time).count();
+    long execute_ms =
+        std::chrono::duration_cast<milliseconds>(execute_time).count();
+    printf("%d launches, RSS %zu MB, fd limit %d: fork %ld ms (%ld/s), "
+           "ncs_os_process_execute_timed %ld ms (%ld/s)\n",
+           kLaunches, rss_mb, static_cast<int>(sysconf(_SC_OPEN_MAX)),
+           fork_ms, kLaunches * 1000L / std::max(fork_ms, 1L), execute_ms,
+           kLaunches * 1000L / std::max(execute_ms, 1L));
+  }
+
+  struct rlimit saved_limit_;
+};
+
+TEST_F(OsProcessExecuteBench, DISABLED_Rss64Mb) { Run(64); }
+
+TEST_F(OsProcessExecuteBench, DISABLED_Rss512Mb) { Run(512); }
+
+TEST_F(OsProcessExecuteBench, DISABLED_Rss2Gb) { Run(2048); }
+
+}  // namespace
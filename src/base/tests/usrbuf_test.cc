@@ -0,0 +1,251 @@
+/*      -*- OpenSAF  -*-
+ *
+ * (C) Copyright 2017 The OpenSAF Foundation
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. This file and program are licensed
+ * under the GNU Lesser General Public License Version 2.1, February 1999.
+ * The complete license can be accessed from the following location:
+ * http://opensource.org/licenses/lgpl-license.php
+ * See the Copying file included with the OpenSAF distribution for full
+ * licensing terms.
+ *
+ */
+
+#include <malloc.h>
+#include <unistd.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <random>
+#include <thread>
+#include <vector>
+#include "base/ncs_ubaid.h"
+#include "base/ncssysf_mem.h"
+#include "base/ncsusrbuf.h"
+#include "gtest/gtest.h"
+extern "C" {
+#include "base/usrbuf.h"
+}
+
+namespace {
+
+std::vector<uint8_t> Pattern(size_t size) {
+  std::vector<uint8_t> data(size);
+  for (size_t i = 0; i < size; ++i) data[i] = static_cast<uint8_t>(i * 7 + 3);
+  return data;
+}
+
+// Encode the data in pieces of 'piece' octets and decode it again
+void RoundTrip(uint8_t pool_id, size_t size, size_t piece) {
+  std::vector<uint8_t> data = Pattern(size);
+  NCS_UBAID uba;
+
+  ASSERT_EQ(NCSCC_RC_SUCCESS, ncs_enc_init_space_pp(&uba, pool_id, 0));
+  for (size_t i = 0; i < size; i += piece) {
+    size_t n = std::min(piece, size - i);
+    ASSERT_EQ(NCSCC_RC_SUCCESS,
+              ncs_encode_n_octets_in_uba(&uba, &data[i], n));
+  }
+  EXPECT_EQ(size, m_MMGR_LINK_DATA_LEN(uba.start));
+
+  for (USRBUF *ub = uba.start; ub != nullptr; ub = ub->link)
+    EXPECT_LE(ub->start + ub->count, ub->payload->Size);
+
+  std::vector<uint8_t> out(size);
+  NCS_UBAID dec;
+  ncs_dec_init_space(&dec, uba.start);
+  if (size > 0) {
+    ASSERT_EQ(NCSCC_RC_SUCCESS,
+              ncs_decode_n_octets_from_uba(&dec, out.data(), size));
+  }
+  EXPECT_EQ(data, out);
+  m_MMGR_FREE_BUFR_LIST(dec.ub);
+}
+
+}  // namespace
+
+TEST(UsrbufTest, SmallMessageUsesSmallPayload) {
+  NCS_UBAID uba;
+  ASSERT_EQ(NCSCC_RC_SUCCESS, ncs_enc_init_space(&uba));
+  EXPECT_LT(uba.start->payload->Size, PAYLOAD_BUF_SIZE);
+
+  uint8_t *p = ncs_enc_reserve_space(&uba, 40);
+  ASSERT_NE(nullptr, p);
+  ncs_enc_claim_space(&uba, 40);
+  EXPECT_EQ(nullptr, uba.start->link);
+  m_MMGR_FREE_BUFR_LIST(uba.start);
+}
+
+TEST(UsrbufTest, ChainGrowsToFullPayloads) {
+  NCS_UBAID uba;
+  ASSERT_EQ(NCSCC_RC_SUCCESS, ncs_enc_init_space(&uba));
+  for (int i = 0; i < 100; ++i) {
+    ASSERT_NE(nullptr, ncs_enc_reserve_space(&uba, 1000));
+    ncs_enc_claim_space(&uba, 1000);
+  }
+  EXPECT_EQ(100000U, m_MMGR_LINK_DATA_LEN(uba.start));
+
+  size_t num = 0;
+  for (USRBUF *ub = uba.start; ub != nullptr; ub = ub->link) ++num;
+  EXPECT_LT(num, 20U);
+  EXPECT_EQ(PAYLOAD_BUF_SIZE, uba.ub->payload->Size);
+  m_MMGR_FREE_BUFR_LIST(uba.start);
+}
+
+TEST(UsrbufTest, RoundTripDefaultPool) {
+  RoundTrip(NCSUB_LEAP_POOL, 0, 1);
+  RoundTrip(NCSUB_LEAP_POOL, 40, 40);
+  RoundTrip(NCSUB_LEAP_POOL, 3000, 7);
+  RoundTrip(NCSUB_LEAP_POOL, 70000, 5000);
+  RoundTrip(NCSUB_LEAP_POOL, 70000, 70000);
+}
+
+TEST(UsrbufTest, RoundTripMdsPool) {
+  RoundTrip(NCSUB_MDS_POOL, 40, 40);
+  RoundTrip(NCSUB_MDS_POOL, 3000, 7);
+  RoundTrip(NCSUB_MDS_POOL, 70000, 5000);
+}
+
+TEST(UsrbufTest, ReserveAtStartOfSmallBuffer) {
+  NCS_UBAID uba;
+  ASSERT_EQ(NCSCC_RC_SUCCESS, ncs_enc_init_space(&uba));
+  uint8_t body = 0x55;
+  ASSERT_EQ(NCSCC_RC_SUCCESS, ncs_encode_n_octets_in_uba(&uba, &body, 1));
+
+  char *hdr = m_MMGR_RESERVE_AT_START(&uba.start, 300, char *);
+  ASSERT_NE(nullptr, hdr);
+  memset(hdr, 0xaa, 300);
+  EXPECT_EQ(301U, m_MMGR_LINK_DATA_LEN(uba.start));
+
+  std::vector<uint8_t> out(301);
+  ASSERT_NE(nullptr, m_MMGR_DATA_AT_START(uba.start, 301,
+                                          reinterpret_cast<char *>(out.data())));
+  m_MMGR_FREE_BUFR_LIST(uba.start);
+}
+
+TEST(UsrbufTest, CopyToAndFromUsrbuf) {
+  std::vector<uint8_t> data = Pattern(20000);
+  USRBUF *ub = sysf_copy_to_usrbuf(data.data(), data.size());
+  ASSERT_NE(nullptr, ub);
+  USRBUF *copy = m_MMGR_COPY_BUFR(ub);
+  ASSERT_NE(nullptr, copy);
+  m_MMGR_FREE_BUFR_LIST(ub);
+
+  std::vector<uint8_t> out(data.size());
+  sysf_copy_from_usrbuf(copy, out.data(), out.size());
+  EXPECT_EQ(data, out);
+  m_MMGR_FREE_BUFR_LIST(copy);
+}
+
+TEST(UsrbufTest, FreeInOtherThread) {
+  std::vector<USRBUF *> bufs;
+  for (int i = 0; i < 1000; ++i) {
+    NCS_UBAID uba;
+    ASSERT_EQ(NCSCC_RC_SUCCESS, ncs_enc_init_space(&uba));
+    ASSERT_NE(nullptr, ncs_enc_reserve_space(&uba, 100 + i * 10));
+    ncs_enc_claim_space(&uba, 100 + i * 10);
+    bufs.push_back(uba.start);
+  }
+  std::thread t([&bufs]() {
+    for (USRBUF *ub : bufs) m_MMGR_FREE_BUFR_LIST(ub);
+  });
+  t.join();
+  RoundTrip(NCSUB_LEAP_POOL, 3000, 100);
+}
+
+namespace {
+
+// Allocation rate and memory of a mix of 40 B, 2 KiB and 8 KiB messages,
+// with a window of messages in flight as in the queues of a service. The
+// payloads of a pool that does not allocate from the heap are allocated as
+// before the size classes: a full PAYLOAD_BUF_SIZE payload from malloc for
+// every USRBUF. Run each case in its own process for the RSS, with
+//   bin/libbase_test --gtest_also_run_disabled_tests --gtest_filter=<case>
+class UsrbufBench : public ::testing::Test {
+ protected:
+  static constexpr int kMessages = 2000000;
+  static constexpr size_t kInFlight = 10000;
+
+  static void *FullAlloc(uint32_t b, uint8_t, uint8_t) { return malloc(b); }
+  static void FullFree(void *data, uint8_t) { free(data); }
+
+  static long RssKb() {
+    return sysconf(_SC_PAGESIZE) / 1024 * Statm(1);
+  }
+
+  static long Statm(int field) {
+    long value[2] = {0, 0};
+    FILE *f = fopen("/proc/self/statm", "r");
+    if (f != nullptr) {
+      if (fscanf(f, "%ld %ld", &value[0], &value[1]) != 2) value[1] = 0;
+      fclose(f);
+    }
+    return value[field];
+  }
+
+  void Run(uint8_t pool_id, const char *name) {
+    // 80% 40 B, 15% 2 KiB, 5% 8 KiB
+    std::mt19937 random(1);
+    std::vector<uint32_t> sizes(kMessages);
+    for (uint32_t &size : sizes) {
+      uint32_t r = random() % 100;
+      size = r < 80 ? 40 : r < 95 ? 2048 : 8192;
+    }
+    std::vector<uint8_t> data(8192, 0x5a);
+    std::deque<USRBUF *> in_flight;
+    long rss_kb = RssKb();
+    size_t heap = mallinfo2().uordblks;
+
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t size : sizes) {
+      NCS_UBAID uba;
+      ASSERT_EQ(NCSCC_RC_SUCCESS, ncs_enc_init_space_pp(&uba, pool_id, 0));
+      ASSERT_EQ(NCSCC_RC_SUCCESS,
+                ncs_encode_n_octets_in_uba(&uba, data.data(), size));
+      in_flight.push_back(uba.start);
+      if (in_flight.size() == kInFlight) {
+        m_MMGR_FREE_BUFR_LIST(in_flight.front());
+        in_flight.pop_front();
+      }
+    }
+    double secs = std::chrono::duration<double>(
+                      std::chrono::steady_clock::now() - start)
+                      .count();
+    heap = mallinfo2().uordblks - heap;
+    long rss_growth_kb = RssKb() - rss_kb;
+    for (USRBUF *ub : in_flight) m_MMGR_FREE_BUFR_LIST(ub);
+
+    printf("%s: %.0f messages/s, %zu in flight: heap %zu KiB, "
+           "RSS +%ld KiB\n",
+           name, kMessages / secs, kInFlight, heap / 1024,
+           rss_growth_kb);
+  }
+};
+
+TEST_F(UsrbufBench, DISABLED_SizeClasses) {
+  Run(NCSUB_LEAP_POOL, "size classes");
+}
+
+TEST_F(UsrbufBench, DISABLED_FullPayloads) {
+  NCSMMGR_UB_LM_ARG arg;
+  memset(&arg, 0, sizeof(arg));
+  arg.i_op = NCSMMGR_LM_OP_REGISTER;
+  arg.info.reg.i_pool_id = NCSUB_DMY2_POOL;
+  arg.info.reg.i_mem_alloc = FullAlloc;
+  arg.info.reg.i_mem_free = FullFree;
+  ASSERT_EQ(NCSCC_RC_SUCCESS, ncsmmgr_ub_lm(&arg));
+
+  Run(NCSUB_DMY2_POOL, "full payloads");
+
+  arg.i_op = NCSMMGR_LM_OP_DEREGISTER;
+  arg.info.dereg.i_pool_id = NCSUB_DMY2_POOL;
+  ncsmmgr_ub_lm(&arg);
+}
+
+}  // namespace
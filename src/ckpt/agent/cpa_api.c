@@ -1193,8 +1193,6 @@ SaAisErrorT saCkptCheckpointOpen(
 		}
 
 		if (add_flag == false) {
-			gc_node->open.info.open.o_addr =
-			    out_evt->info.cpa.info.openRsp.addr;
 			gc_node->ckpt_creat_attri =
 			    out_evt->info.cpa.info.openRsp.creation_attr;
 
@@ -4624,6 +4622,14 @@ SaAisErrorT saCkptCheckpointRead(SaCkptCheckpointHandleT checkpointHandle,
 		goto done;
 	}
 
+	if (is_local_read && cb->is_shm_read_enabled &&
+	    cpa_proc_replica_read(cb, gc_node, lc_node->ckpt_name, ioVector,
+				  numberOfElements,
+				  &cl_node->version) == NCSCC_RC_SUCCESS) {
+		m_NCS_UNLOCK(&cb->cb_lock, NCS_LOCK_WRITE);
+		goto fail1;
+	}
+
 	/* Populate the event & send it to CPND */
 	evt.type = CPSV_EVT_TYPE_CPND;
 	evt.info.cpnd.type = CPND_EVT_A2ND_CKPT_READ;
@@ -50,7 +50,8 @@ typedef struct cpa_glbl_ckpt_node {
   NCS_PATRICIA_NODE patnode;
   SaCkptCheckpointHandleT gbl_ckpt_hdl; /* globally aware handle */
   /*SaCkptCheckpointHandleT    lcl_ckpt_hdl; */
-  NCS_OS_POSIX_SHM_REQ_INFO open;
+  NCS_OS_POSIX_SHM_REQ_INFO open; /* Read-only mapping of the local replica */
+  bool is_replica_map_failed;
   SaCkptCheckpointCreationAttributesT ckpt_creat_attri;
   uint32_t ref_cnt; /* Client count */
   MDS_DEST active_mds_dest;
@@ -97,6 +98,8 @@ typedef struct cpa_cb {
   bool is_cpnd_up;
   bool is_cpnd_joined_clm;
   CPA_TMR cpnd_down_tmr;
+  /* Read collocated replicas from shared memory, OSAF_CKPT_SHM_READ */
+  bool is_shm_read_enabled;
 
   /* CPA data */
   NCS_PATRICIA_TREE client_tree; /* CPA_CLIENT_NODE - node */
@@ -119,7 +122,7 @@ typedef struct cpa_cb {
 
 } CPA_CB;
 
-uint32_t gl_cpa_hdl;
+extern uint32_t gl_cpa_hdl;
 
 typedef struct cpa_prcess_evt_sync {
   NCS_QELEM qelem;
@@ -127,6 +127,7 @@ static uint32_t cpa_create(NCS_LIB_CREATE *create_info)
 {
 	CPA_CB *cb = NULL;
 	uint32_t rc;
+	char *value;
 
 	/* validate create info */
 	if (create_info == NULL)
@@ -155,6 +156,10 @@ static uint32_t cpa_create(NCS_LIB_CREATE *create_info)
 	/* get the process id */
 	cb->process_id = getpid();
 
+	cb->is_shm_read_enabled = true;
+	if ((value = getenv("OSAF_CKPT_SHM_READ")) != NULL)
+		cb->is_shm_read_enabled = (atoi(value) != 0);
+
 	/* initialize the cpa cb lock */
 	if (m_NCS_LOCK_INIT(&cb->cb_lock) != NCSCC_RC_SUCCESS) {
 		TRACE_4("cpa create failed in LOCK_INIT ");
@@ -30,10 +30,18 @@
 
 #include "ckpt/agent/cpa.h"
 #include "base/osaf_poll.h"
+#include <sys/stat.h>
 
 static void cpa_process_callback_info(CPA_CB *cb, CPA_CLIENT_NODE *cl_node,
 				      CPA_CALLBACK_INFO *callback);
 
+/* Reads of the local replica that keep racing CPND updates go to CPND */
+#define CPA_REPLICA_READ_RETRIES 16
+
+/* Outcomes of a section lookup other than a slot */
+#define CPA_REPLICA_SEC_MISSING -1
+#define CPA_REPLICA_SEC_RETRY -2
+
 #define m_MMGR_FREE_CPSV_DEFAULT(p)                                            \
 	m_NCS_MEM_FREE(p, NCS_MEM_REGION_PERSISTENT, NCS_SERVICE_ID_OS_SVCS, 0)
 
@@ -1392,81 +1400,329 @@ void cpa_proc_free_read_data(CPSV_ND2A_DATA_ACCESS_RSP *rmt_read_rsp)
 }
 
 /****************************************************************************
-  Name          : cpa_proc_replica_read
-  Description   : reads replica from (shared memory )
-  Arguments     :  cb         ---   Control block of CPA
-		   ioVector   ---   ioVector of Data
-		   read_map   ---   read_map information received from ND
-		   erroneousVectorIndex ---   Vector Index
-		   gbl_ckpt_hdl  ----  Global Checkpoint Hdl
-		   numbeofOfElements --- Number of Elements
+  Name          : cpa_proc_replica_map
+  Description   : Maps the local replica of a collocated checkpoint read-only.
+		  The segment is created and written by CPND only, see the
+		  layout in cpsv_shm.h.
+  Arguments     : cb         ---   Control block of CPA
+		  gc_node    ---   Global checkpoint node
+		  ckpt_name  ---   Name of the checkpoint
   Return Values : NCSCC_RC_FAILURE/NCSCC_RC_SUCCESS
   Notes         : None
 ******************************************************************************/
-uint32_t cpa_proc_replica_read(CPA_CB *cb, SaUint32T numberOfElements,
-			       SaCkptCheckpointHandleT gbl_ckpt_hdl,
-			       SaCkptIOVectorElementT **ioVector,
-			       CPSV_ND2A_READ_MAP *read_map,
-			       SaUint32T **erroneousVectorIndex)
+static uint32_t cpa_proc_replica_map(CPA_CB *cb, CPA_GLOBAL_CKPT_NODE *gc_node,
+				     const char *ckpt_name)
 {
-	uint32_t iter = 0, rc = NCSCC_RC_SUCCESS;
-	NCS_OS_POSIX_SHM_REQ_INFO shm_info;
-	CPA_GLOBAL_CKPT_NODE *gc_node;
-	bool add_flag = false;
+	char rep_name[CPSV_MAX_REPLICA_NAME_LENGTH];
+	char shm_name[CPSV_MAX_REPLICA_NAME_LENGTH + 16];
+	struct stat st;
+	uint64_t size;
+	void *addr;
+	int fd;
+
+	cpsv_replica_name(rep_name, ckpt_name,
+			  m_NCS_NODE_ID_FROM_MDS_DEST(cb->cpnd_mds_dest),
+			  gc_node->gbl_ckpt_hdl);
+	/* Same prefix as ncs_os_posix_shm(), which can not open read-only */
+	snprintf(shm_name, sizeof(shm_name), "/opensaf_%s", rep_name);
+	size = m_CPSV_REPLICA_SIZE(gc_node->ckpt_creat_attri.maxSections,
+				   gc_node->ckpt_creat_attri.maxSectionSize);
+
+	fd = shm_open(shm_name, O_RDONLY, 0);
+	if (fd < 0) {
+		TRACE_4("cpa shm_open of %s failed: %s", shm_name,
+			strerror(errno));
+		return NCSCC_RC_FAILURE;
+	}
+	if (fstat(fd, &st) != 0 || (uint64_t)st.st_size < size) {
+		TRACE_4("cpa replica %s smaller than expected", shm_name);
+		close(fd);
+		return NCSCC_RC_FAILURE;
+	}
+	addr = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+	if (addr == MAP_FAILED) {
+		TRACE_4("cpa mmap of %s failed: %s", shm_name,
+			strerror(errno));
+		return NCSCC_RC_FAILURE;
+	}
+	if (((const CPSV_CKPT_HDR *)addr)->ckpt_id != gc_node->gbl_ckpt_hdl) {
+		TRACE_4("cpa replica %s belongs to another checkpoint",
+			shm_name);
+		munmap(addr, size);
+		return NCSCC_RC_FAILURE;
+	}
 
-	TRACE_ENTER();
-	memset(&shm_info, '\0', sizeof(NCS_OS_POSIX_SHM_REQ_INFO));
+	gc_node->open.info.open.o_addr = addr;
+	gc_node->open.info.open.i_size = size;
+	return NCSCC_RC_SUCCESS;
+}
 
-	cpa_gbl_ckpt_node_find_add(&cb->gbl_ckpt_tree, &gbl_ckpt_hdl, &gc_node,
-				   &add_flag);
+/****************************************************************************
+  Name          : cpa_proc_replica_unmap
+  Description   : Unmaps the local replica mapped by cpa_proc_replica_read
+  Arguments     : gc_node    ---   Global checkpoint node
+  Return Values : None
+  Notes         : None
+******************************************************************************/
+void cpa_proc_replica_unmap(CPA_GLOBAL_CKPT_NODE *gc_node)
+{
+	if (gc_node->open.info.open.o_addr == NULL)
+		return;
 
-	for (; iter < numberOfElements; iter++) {
-		if (read_map[iter].offset_index == -1) {
-			if (*erroneousVectorIndex != NULL)
-				(*erroneousVectorIndex)[0] = iter;
-			TRACE_LEAVE();
+	munmap(gc_node->open.info.open.o_addr, gc_node->open.info.open.i_size);
+	gc_node->open.info.open.o_addr = NULL;
+}
+
+static void cpa_proc_replica_buf_free(void *buf, SaVersionT *version)
+{
+	if (buf == NULL)
+		return;
+	if (m_CPA_VER_IS_ABOVE_B_1_1(version))
+		m_MMGR_FREE_CPA_DEFAULT(buf);
+	else
+		free(buf);
+}
+
+/****************************************************************************
+  Name          : cpa_proc_replica_sec_find
+  Description   : Looks a section up in the section index of the mapped
+		  replica, see cpsv_shm.h.
+  Arguments     : gc_node    ---   Global checkpoint node
+		  dir_hdr    ---   Section directory of the replica
+		  id         ---   Id of the section
+		  seq        ---   Set to the seq of the slot it was found in
+  Return Values : The slot of the section, CPA_REPLICA_SEC_MISSING if the
+		  section does not exist, CPA_REPLICA_SEC_RETRY if CPND
+		  changed the index or the slot meanwhile.
+  Notes         : The caller checks seq again after reading the section.
+******************************************************************************/
+static int32_t cpa_proc_replica_sec_find(CPA_GLOBAL_CKPT_NODE *gc_node,
+					 const CPSV_SECT_DIR_HDR *dir_hdr,
+					 const SaCkptSectionIdT *id,
+					 uint32_t *seq)
+{
+	const uint32_t max_secs = gc_node->ckpt_creat_attri.maxSections;
+	const char *base = gc_node->open.info.open.o_addr;
+	const CPSV_SECT_SLOT *slots = (const CPSV_SECT_SLOT *)(dir_hdr + 1);
+	const uint32_t *idx =
+	    (const uint32_t *)(base + m_CPSV_SECT_IDX_OFFSET(max_secs));
+	const uint64_t n = m_CPSV_SECT_IDX_SIZE(max_secs);
+	const CPSV_SECT_HDR *sec_hdr;
+	uint32_t idx_seq, entry;
+	uint64_t i, probe;
+
+	idx_seq = __atomic_load_n(&dir_hdr->idx_seq, __ATOMIC_ACQUIRE);
+	if (idx_seq & 1)
+		return CPA_REPLICA_SEC_RETRY;
+
+	i = cpsv_sect_id_hash(id->id, id->idLen) % n;
+	for (probe = 0; probe < n; probe++, i = (i + 1) % n) {
+		entry = __atomic_load_n(&idx[i], __ATOMIC_RELAXED);
+		if (entry == 0)
+			break;
+		if (entry > max_secs)
+			return CPA_REPLICA_SEC_RETRY;
+
+		*seq = __atomic_load_n(&slots[entry - 1].seq, __ATOMIC_ACQUIRE);
+		if (*seq & 1)
+			return CPA_REPLICA_SEC_RETRY;
+		sec_hdr = (const CPSV_SECT_HDR *)(base +
+						  m_CPSV_SECT_HDR_OFFSET(
+						      entry - 1, max_secs));
+		if (slots[entry - 1].in_use && sec_hdr->idLen == id->idLen &&
+		    (id->idLen == 0 ||
+		     memcmp(sec_hdr->id, id->id, id->idLen) == 0))
+			return entry - 1;
+	}
+
+	/* Only a lookup that CPND did not race tells the section is missing */
+	__atomic_thread_fence(__ATOMIC_ACQUIRE);
+	if (__atomic_load_n(&dir_hdr->idx_seq, __ATOMIC_RELAXED) != idx_seq)
+		return CPA_REPLICA_SEC_RETRY;
+	return CPA_REPLICA_SEC_MISSING;
+}
+
+/****************************************************************************
+  Name          : cpa_proc_replica_sec_read
+  Description   : Reads one section from the mapped replica. The section is
+		  looked up and copied under the seqlock of its slot, and
+		  the copy is retried if CPND updated the section meanwhile.
+  Arguments     : gc_node    ---   Global checkpoint node
+		  dir_hdr    ---   Section directory of the replica
+		  io         ---   Element to read, dataBuffer is allocated
+				   if it is NULL
+		  version    ---   Version of the client
+		  allocated  ---   Set if dataBuffer was allocated
+  Return Values : NCSCC_RC_FAILURE/NCSCC_RC_SUCCESS
+  Notes         : Only fails for cases CPND must decide on, such as a
+		  missing section, and for readers that keep racing CPND.
+******************************************************************************/
+static uint32_t cpa_proc_replica_sec_read(CPA_GLOBAL_CKPT_NODE *gc_node,
+					  const CPSV_SECT_DIR_HDR *dir_hdr,
+					  SaCkptIOVectorElementT *io,
+					  SaVersionT *version, bool *allocated)
+{
+	const SaCkptCheckpointCreationAttributesT *attr =
+	    &gc_node->ckpt_creat_attri;
+	const char *base = gc_node->open.info.open.o_addr;
+	const CPSV_SECT_SLOT *slots = (const CPSV_SECT_SLOT *)(dir_hdr + 1);
+	const uint64_t n_exts = (uint64_t)attr->maxSections
+				<< dir_hdr->max_order;
+	const CPSV_SECT_HDR *sec_hdr;
+	void *buf = io->dataBuffer;
+	SaSizeT buf_size = 0, read_size = 0;
+	SaSizeT data_size = (io->dataBuffer == NULL) ? 0 : io->dataSize;
+	uint64_t ext;
+	uint32_t retry, seq, order;
+	int32_t i;
+
+	*allocated = false;
+	if (io->sectionId.idLen > MAX_SIZE)
+		return NCSCC_RC_FAILURE;
+
+	for (retry = 0; retry < CPA_REPLICA_READ_RETRIES; retry++) {
+		i = cpa_proc_replica_sec_find(gc_node, dir_hdr, &io->sectionId,
+					      &seq);
+		if (i == CPA_REPLICA_SEC_MISSING)
+			break;
+		if (i == CPA_REPLICA_SEC_RETRY)
+			continue;
+
+		sec_hdr = (const CPSV_SECT_HDR *)(base +
+						  m_CPSV_SECT_HDR_OFFSET(
+						      i, attr->maxSections));
+		if (io->dataOffset > sec_hdr->sec_size)
+			break;
+		/* Same sizes as cpnd_ckpt_read_replica() */
+		if (data_size == 0 ||
+		    io->dataOffset + data_size >= sec_hdr->sec_size)
+			read_size = sec_hdr->sec_size - io->dataOffset;
+		else
+			read_size = data_size;
+		/* The slot may be torn, it is checked after the copy */
+		ext = slots[i].ext;
+		order = slots[i].order;
+		if (order > dir_hdr->max_order ||
+		    ext + (1ULL << order) > n_exts ||
+		    io->dataOffset + read_size > dir_hdr->ext_size << order)
+			continue;
+
+		if (read_size != 0 && io->dataBuffer == NULL &&
+		    buf_size < read_size) {
+			cpa_proc_replica_buf_free(buf, version);
+			if (m_CPA_VER_IS_ABOVE_B_1_1(version))
+				buf = m_MMGR_ALLOC_CPA_DEFAULT(read_size);
+			else
+				buf = malloc(read_size);
+			if (buf == NULL) {
+				TRACE_4("cpa data buff allocation failed");
+				return NCSCC_RC_FAILURE;
+			}
+			buf_size = read_size;
+		}
+		memcpy(buf,
+		       base +
+			   m_CPSV_SECT_DATA_OFFSET(ext, dir_hdr->ext_size,
+						   attr->maxSections) +
+			   io->dataOffset,
+		       read_size);
+
+		__atomic_thread_fence(__ATOMIC_ACQUIRE);
+		if (__atomic_load_n(&slots[i].seq, __ATOMIC_RELAXED) != seq)
+			continue;
+
+		if (io->dataBuffer == NULL && buf != NULL) {
+			io->dataBuffer = buf;
+			*allocated = true;
+		}
+		io->readSize = read_size;
+		return NCSCC_RC_SUCCESS;
+	}
+
+	if (buf != io->dataBuffer)
+		cpa_proc_replica_buf_free(buf, version);
+	return NCSCC_RC_FAILURE;
+}
+
+/****************************************************************************
+  Name          : cpa_proc_replica_read
+  Description   : Reads the sections of a collocated checkpoint directly
+		  from its local replica, without a round trip to CPND.
+  Arguments     : cb         ---   Control block of CPA
+		  gc_node    ---   Global checkpoint node
+		  ckpt_name  ---   Name of the checkpoint
+		  ioVector   ---   ioVector of Data
+		  numberOfElements --- Number of Elements
+		  version    ---   Version of the client
+  Return Values : NCSCC_RC_SUCCESS if all elements were read.
+		  NCSCC_RC_FAILURE if the read must be sent to CPND, with
+		  ioVector as it was passed.
+  Notes         : Called with the cb lock held, which keeps the mapping.
+******************************************************************************/
+uint32_t cpa_proc_replica_read(CPA_CB *cb, CPA_GLOBAL_CKPT_NODE *gc_node,
+			       const char *ckpt_name,
+			       SaCkptIOVectorElementT *ioVector,
+			       SaUint32T numberOfElements, SaVersionT *version)
+{
+	const SaCkptCheckpointCreationAttributesT *attr =
+	    &gc_node->ckpt_creat_attri;
+	const CPSV_SECT_DIR_HDR *dir_hdr;
+	uint64_t ext_size;
+	uint32_t max_order;
+	bool *allocated;
+	uint32_t iter;
+
+	if (!gc_node->is_active_exists || gc_node->is_restart)
+		return NCSCC_RC_FAILURE;
+
+	if (gc_node->open.info.open.o_addr == NULL) {
+		if (gc_node->is_replica_map_failed)
+			return NCSCC_RC_FAILURE;
+		if (cpa_proc_replica_map(cb, gc_node, ckpt_name) !=
+		    NCSCC_RC_SUCCESS) {
+			gc_node->is_replica_map_failed = true;
 			return NCSCC_RC_FAILURE;
 		}
+	}
 
-		(*ioVector)[iter].readSize = read_map[iter].read_size;
+	/* The directory is not valid while a restarted CPND rebuilds it */
+	dir_hdr = (const CPSV_SECT_DIR_HDR
+		       *)((const char *)gc_node->open.info.open.o_addr +
+			  m_CPSV_SECT_DIR_OFFSET);
+	cpsv_sect_geometry(attr->maxSectionSize, &ext_size, &max_order);
+	if (!__atomic_load_n(&dir_hdr->ready, __ATOMIC_ACQUIRE) ||
+	    dir_hdr->magic != CPSV_SECT_DIR_MAGIC ||
+	    dir_hdr->n_slots != attr->maxSections ||
+	    dir_hdr->ext_size != ext_size || dir_hdr->max_order != max_order ||
+	    dir_hdr->idx_size != m_CPSV_SECT_IDX_SIZE(attr->maxSections))
+		return NCSCC_RC_FAILURE;
+
+	allocated = calloc(numberOfElements, sizeof(bool));
+	if (allocated == NULL)
+		return NCSCC_RC_FAILURE;
 
-		if (read_map[iter].read_size == 0) {
+	for (iter = 0; iter < numberOfElements; iter++) {
+		if (cpa_proc_replica_sec_read(gc_node, dir_hdr, &ioVector[iter],
+					      version, &allocated[iter]) ==
+		    NCSCC_RC_SUCCESS)
 			continue;
-		} else {
-			if ((*ioVector)[iter].dataBuffer == NULL) {
-				(*ioVector)[iter].dataBuffer =
-				    m_MMGR_ALLOC_CPA_DEFAULT(
-					read_map[iter].read_size);
-				if ((*ioVector)[iter].dataBuffer == NULL) {
-					TRACE_4(
-					    "cpa data buff alloc failed in proc replica read");
-					TRACE_LEAVE();
-					return NCSCC_RC_FAILURE;
-				}
-				memset((*ioVector)[iter].dataBuffer, '\0',
-				       read_map[iter].read_size);
+
+		/* Undo what was read, the whole read goes to CPND */
+		TRACE_2("cpa local read of element %u falls back to cpnd",
+			iter);
+		while (iter-- > 0) {
+			if (allocated[iter]) {
+				cpa_proc_replica_buf_free(
+				    ioVector[iter].dataBuffer, version);
+				ioVector[iter].dataBuffer = NULL;
 			}
-			shm_info.type = NCS_OS_POSIX_SHM_REQ_READ;
-			shm_info.info.read.i_addr =
-			    (void *)((char *)gc_node->open.info.open.o_addr +
-				     sizeof(CPSV_CKPT_HDR) +
-				     ((read_map[iter].offset_index + 1) *
-				      sizeof(CPSV_SECT_HDR)) +
-				     (read_map[iter].offset_index *
-				      gc_node->ckpt_creat_attri
-					  .maxSectionSize));
-			shm_info.info.read.i_to_buff =
-			    (*ioVector)[iter].dataBuffer;
-			shm_info.info.read.i_read_size =
-			    read_map[iter].read_size;
-			shm_info.info.read.i_offset =
-			    (*ioVector)[iter].dataOffset;
-
-			ncs_os_posix_shm(&shm_info);
 		}
+		free(allocated);
+		return NCSCC_RC_FAILURE;
 	}
-	TRACE_LEAVE();
-	return rc;
+	free(allocated);
+	return NCSCC_RC_SUCCESS;
 }
 
 /****************************************************************************
@@ -66,11 +66,12 @@ uint32_t cpa_proc_check_iovector(CPA_CB *cb, CPA_LOCAL_CKPT_NODE *lc_node,
                                  const SaCkptIOVectorElementT *iovector,
                                  uint32_t num_of_elmts, uint32_t *errflag);
 
-uint32_t cpa_proc_replica_read(CPA_CB *cb, SaUint32T numberOfElements,
-                               SaCkptCheckpointHandleT gbl_ckpt_hdl,
-                               SaCkptIOVectorElementT **ioVector,
-                               CPSV_ND2A_READ_MAP *read_map,
-                               SaUint32T **erroneousVectorIndex);
+uint32_t cpa_proc_replica_read(CPA_CB *cb, CPA_GLOBAL_CKPT_NODE *gc_node,
+                               const char *ckpt_name,
+                               SaCkptIOVectorElementT *ioVector,
+                               SaUint32T numberOfElements, SaVersionT *version);
+
+void cpa_proc_replica_unmap(CPA_GLOBAL_CKPT_NODE *gc_node);
 
 uint32_t cpa_proc_rmt_replica_read(SaUint32T numberOfElements,
                                    SaCkptIOVectorElementT *ioVector,
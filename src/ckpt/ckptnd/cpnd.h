@@ -48,6 +48,7 @@
 
 #include "cpnd_init.h"
 #include "cpnd_sec.h"
+#include "cpnd_ext.h"
 #include <sys/mman.h>
 #include <fcntl.h>
 #include <errno.h>
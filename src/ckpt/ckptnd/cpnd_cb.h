@@ -35,8 +35,8 @@ extern uint32_t gl_cpnd_cb_hdl;
 #define m_CPND_GIVEUP_CPND_CB ncshm_give_hdl(gl_cpnd_cb_hdl)
 
 #define CPND_MAX_REPLICAS 1000
-#define CPND_MAX_REPLICA_NAME_LENGTH 255
-#define CPND_REP_NAME_MAX_CKPT_NAME_LENGTH (CPND_MAX_REPLICA_NAME_LENGTH - 32)
+#define CPND_MAX_REPLICA_NAME_LENGTH CPSV_MAX_REPLICA_NAME_LENGTH
+#define CPND_REP_NAME_MAX_CKPT_NAME_LENGTH CPSV_REP_NAME_MAX_CKPT_NAME_LENGTH
 
 #define CPSV_GEN_SECTION_ID_SIZE 4
 #define CPSV_WAIT_TIME 1000
@@ -156,7 +156,13 @@ typedef struct cpnd_ckpt_replica_info_tag {
   SaUint32T n_secs;               /* Used for status */
   SaUint32T mem_used;             /* Used for status */
   NCS_OS_POSIX_SHM_REQ_INFO open; /* for shm open */
-  uint32_t *shm_sec_mapping;      /* for validity of sec */
+  uint32_t *shm_sec_mapping;      /* for validity of sec, 1 if slot free */
+  uint32_t *free_sec_ids;         /* Stack of free slots, lowest on top */
+  uint32_t n_free_sec_ids;
+  CPSV_SECT_SLOT *sect_dir;       /* Section directory in the replica shm */
+  void *ext_alloc;                /* Allocator of the section data blocks */
+  uint64_t ext_size;              /* Extent size of the section data */
+  uint32_t max_order;             /* Order of a maxSectionSize block */
   void *section_db;               /* used for C++ STL map */
   void *local_section_db;         /* used for C++ STL map */
 } CPND_CKPT_REPLICA_INFO;
@@ -175,6 +181,27 @@ typedef struct cpnd_all_repl_write_evt_node {
   /* struct cpnd_all_repl_write_evt_node *next;*/
 } CPSV_CPND_ALL_REPL_EVT_NODE;
 
+/* A section changed on the active replica and not yet sent to the other
+   replicas, see cpnd_repl.c */
+typedef struct cpnd_repl_pending {
+  SaCkptSectionIdT sec_id;
+  bool ovwrite;   /* Overwritten, the whole section is sent */
+  bool has_range; /* Written, [lo, hi) is sent */
+  SaOffsetT lo;
+  SaOffsetT hi;
+  struct cpnd_repl_pending *next;
+} CPND_REPL_PENDING;
+
+typedef struct cpnd_repl_stats {
+  SaUint64T writes;    /* Elements written by clients */
+  SaUint64T coalesced; /* Elements merged into a pending section */
+  SaUint64T batches;   /* Flush messages, counted once for all replicas */
+  SaUint64T elements;  /* Elements in the flush messages */
+  SaUint64T bytes;     /* Data bytes in the flush messages */
+  SaTimeT last_lag;    /* From the first pending write to the flush, ns */
+  SaTimeT max_lag;
+} CPND_REPL_STATS;
+
 /******************************************************************************
  The checkpoint node that goes into particia tree cpnd_ckpt_info of CPND_CB
  *****************************************************************************/
@@ -219,6 +246,14 @@ typedef struct cpnd_ckpt_node {
       cpa_sinfo; /* Used in unlink flow while sending response to CPA */
   bool cpa_sinfo_flag;
   CPND_TMR open_active_sync_tmr;
+
+  /* Coalesced replication of active replica writes, cpnd_repl.c */
+  CPND_REPL_PENDING *repl_pending;
+  uint32_t n_repl_pending;
+  SaSizeT repl_pending_bytes;
+  SaTimeT repl_pending_since;
+  CPND_TMR repl_flush_tmr;
+  CPND_REPL_STATS repl_stats;
 } CPND_CKPT_NODE;
 
 #define CPND_CKPT_NODE_NULL ((CPND_CKPT_NODE *)0)
@@ -343,6 +378,7 @@ typedef struct cpnd_cb_tag {
 
   bool scAbsenceAllowed;
   int shm_alloc_guaranteed;
+  uint32_t repl_coalesce_ms; /* OSAF_CKPT_REPL_COALESCE_MS, 0 disables */
 
   NCS_SEL_OBJ clm_updated_sel_obj; /* The CLM select object updated event */
 
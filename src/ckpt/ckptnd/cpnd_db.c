@@ -164,6 +164,7 @@ void cpnd_ckpt_node_destroy(CPND_CB *cb, CPND_CKPT_NODE *cp_node)
 		cpnd_tmr_stop(&cp_node->open_active_sync_tmr);
 	if (cp_node->ret_tmr.is_active)
 		cpnd_tmr_stop(&cp_node->ret_tmr);
+	cpnd_repl_discard(cp_node);
 
 	cpnd_ckpt_sec_map_destroy(&cp_node->replica_info);
 
@@ -438,6 +439,7 @@ CPND_CKPT_SECTION_INFO *cpnd_ckpt_sec_add(CPND_CB *cb, CPND_CKPT_NODE *cp_node,
 	pSecPtr = m_MMGR_ALLOC_CPND_CKPT_SECTION_INFO;
 	if (pSecPtr == NULL) {
 		LOG_ER("cpnd ckpt section info memory allocation failed");
+		cpnd_ckpt_put_lck_sec_id(cb, cp_node, lcl_sec_id);
 		return NULL;
 	}
 
@@ -519,6 +521,7 @@ section_add_fails:
 
 sec_id_allocate_fails:
 	m_MMGR_FREE_CPND_CPND_CKPT_SECTION_INFO(pSecPtr);
+	cpnd_ckpt_put_lck_sec_id(cb, cp_node, lcl_sec_id);
 	TRACE_LEAVE();
 	return NULL;
 }
@@ -653,6 +656,7 @@ void cpnd_ckpt_node_tree_cleanup(CPND_CB *cb)
 				      (NCS_PATRICIA_NODE *)&cp_node->patnode);
 		if (cp_node->ret_tmr.is_active)
 			cpnd_tmr_stop(&cp_node->ret_tmr);
+		cpnd_repl_discard(cp_node);
 
 		cpnd_ckpt_sec_map_destroy(&cp_node->replica_info);
 
@@ -2070,6 +2070,8 @@ static uint32_t cpnd_evt_proc_ckpt_active_set(CPND_CB *cb, CPND_EVT *evt,
 			evt->info.active_set.ckpt_id);
 		return NCSCC_RC_FAILURE;
 	}
+	/* Writes coalesced while this node was active go out first */
+	cpnd_repl_flush(cb, cp_node);
 	if (m_CPND_IS_LOCAL_NODE(&evt->info.active_set.mds_dest, &mds_dest) ==
 	    0) {
 		cp_node->is_active_exist = false;
@@ -2881,12 +2883,11 @@ static uint32_t cpnd_evt_proc_ckpt_sect_create(CPND_CB *cb, CPND_EVT *evt,
 
 								if (tmp_sec_info ==
 								    sec_info) {
-									cp_node
-									    ->replica_info
-									    .shm_sec_mapping
-										[sec_info
-										     ->lcl_sec_id] =
-									    1;
+									cpnd_ckpt_put_lck_sec_id(
+									    cb,
+									    cp_node,
+									    sec_info
+										->lcl_sec_id);
 									m_CPND_FREE_CKPT_SECTION(
 									    sec_info);
 								} else {
@@ -3061,7 +3062,7 @@ static uint32_t cpnd_evt_proc_ckpt_sect_delete(CPND_CB *cb, CPND_EVT *evt,
 			    SA_AIS_ERR_INVALID_PARAM;
 			goto agent_rsp;
 		}
-		cp_node->replica_info.shm_sec_mapping[sec_info->lcl_sec_id] = 1;
+		cpnd_ckpt_put_lck_sec_id(cb, cp_node, sec_info->lcl_sec_id);
 
 		/* Send the arrival callback */
 		memset(&ckpt_data, '\0', sizeof(CPSV_CKPT_DATA));
@@ -3393,7 +3394,7 @@ static uint32_t cpnd_evt_proc_nd2nd_ckpt_sect_delete(CPND_CB *cb, CPND_EVT *evt,
 		}
 	} else {
 		/* resetting lcl_sec_id mapping */
-		cp_node->replica_info.shm_sec_mapping[sec_info->lcl_sec_id] = 1;
+		cpnd_ckpt_put_lck_sec_id(cb, cp_node, sec_info->lcl_sec_id);
 	}
 
 	/* Send the arrival callback */
@@ -4574,7 +4575,8 @@ static uint32_t cpnd_evt_proc_timer_expiry(CPND_CB *cb, CPND_EVT *evt)
 
 	if ((evt->info.tmr_info.type == CPND_TMR_TYPE_RETENTION) ||
 	    (evt->info.tmr_info.type == CPND_TMR_TYPE_NON_COLLOC_RETENTION) ||
-	    (evt->info.tmr_info.type == CPND_TMR_OPEN_ACTIVE_SYNC)) {
+	    (evt->info.tmr_info.type == CPND_TMR_OPEN_ACTIVE_SYNC) ||
+	    (evt->info.tmr_info.type == CPND_TMR_TYPE_REPL_FLUSH)) {
 
 		if (cp_node == NULL) {
 			TRACE_4("cpnd ckpt replica destroy failed ckpt_id:%llx",
@@ -4656,6 +4658,9 @@ static uint32_t cpnd_evt_proc_timer_expiry(CPND_CB *cb, CPND_EVT *evt)
 	case CPND_ALL_REPL_RSP_EXPI:
 		rc = cpnd_all_repl_rsp_expiry(cb, &evt->info.tmr_info);
 		break;
+	case CPND_TMR_TYPE_REPL_FLUSH:
+		cpnd_repl_flush(cb, cp_node);
+		break;
 	case CPND_TMR_OPEN_ACTIVE_SYNC:
 		rc = cpnd_open_active_sync_expiry(cb, &evt->info.tmr_info);
 		if (rc != NCSCC_RC_SUCCESS) {
@@ -4907,8 +4912,7 @@ static uint32_t cpnd_evt_proc_ckpt_destroy(CPND_CB *cb, CPND_EVT *evt,
 			m_MMGR_FREE_CPND_DEFAULT(
 			    cp_node->replica_info.open.info.open.i_name);
 			/* freeing the sec_mapping memory */
-			m_MMGR_FREE_CPND_DEFAULT(
-			    cp_node->replica_info.shm_sec_mapping);
+			cpnd_ckpt_slot_map_free(&cp_node->replica_info);
 		}
 
 		TRACE_4("cpnd ckpt replica destroy success for ckpt_id:%llx",
@@ -0,0 +1,159 @@
+/*      -*- OpenSAF  -*-
+ *
+ * (C) Copyright 2017 The OpenSAF Foundation
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. This file and program are licensed
+ * under the GNU Lesser General Public License Version 2.1, February 1999.
+ * The complete license can be accessed from the following location:
+ * http://opensource.org/licenses/lgpl-license.php
+ * See the Copying file included with the OpenSAF distribution for full
+ * licensing terms.
+ *
+ */
+
+/*****************************************************************************
+ *   FILE NAME: cpnd_ext.cc
+ *
+ *   DESCRIPTION: Buddy allocator of the section data of a replica
+ *
+ ****************************************************************************/
+
+#include "ckpt/ckptnd/cpnd_ext.h"
+#include <set>
+#include <vector>
+
+namespace {
+
+// The free blocks of each order are kept sorted, so the lowest one is
+// used first and the used part of the data area stays dense. The chunks
+// from next_chunk_ on have never been used and are not in the free lists.
+class ExtentAllocator {
+ public:
+  ExtentAllocator(uint32_t n_chunks, uint32_t max_order)
+      : free_(max_order + 1), n_chunks_(n_chunks), max_order_(max_order) {}
+
+  bool Alloc(uint32_t order, uint64_t *ext);
+  void Free(uint64_t *ext, uint32_t *order);
+  bool Reserve(uint64_t ext, uint32_t order);
+  uint64_t used() const { return used_; }
+
+ private:
+  uint64_t Size(uint32_t order) const { return uint64_t(1) << order; }
+
+  std::vector<std::set<uint64_t>> free_;
+  uint64_t n_chunks_;
+  uint64_t next_chunk_{0};
+  uint64_t used_{0};
+  uint32_t max_order_;
+};
+
+bool ExtentAllocator::Alloc(uint32_t order, uint64_t *ext) {
+  uint32_t k = order;
+  uint64_t block;
+
+  if (order > max_order_) return false;
+
+  while (k <= max_order_ && free_[k].empty()) k++;
+  if (k <= max_order_) {
+    block = *free_[k].begin();
+    free_[k].erase(free_[k].begin());
+  } else if (next_chunk_ < n_chunks_) {
+    block = next_chunk_++ << max_order_;
+    k = max_order_;
+  } else {
+    return false;
+  }
+
+  // Split, keeping the lower half
+  while (k > order) {
+    k--;
+    free_[k].insert(block + Size(k));
+  }
+  used_ += Size(order);
+  *ext = block;
+  return true;
+}
+
+void ExtentAllocator::Free(uint64_t *ext, uint32_t *order) {
+  uint64_t block = *ext;
+  uint32_t k = *order;
+
+  used_ -= Size(k);
+  while (k < max_order_) {
+    auto buddy = free_[k].find(block ^ Size(k));
+    if (buddy == free_[k].end()) break;
+    free_[k].erase(buddy);
+    block &= ~Size(k);
+    k++;
+  }
+  free_[k].insert(block);
+  *ext = block;
+  *order = k;
+}
+
+bool ExtentAllocator::Reserve(uint64_t ext, uint32_t order) {
+  uint64_t chunk = ext >> max_order_;
+
+  if (order > max_order_ || (ext & (Size(order) - 1)) != 0 ||
+      chunk >= n_chunks_)
+    return false;
+
+  while (next_chunk_ <= chunk)
+    free_[max_order_].insert(next_chunk_++ << max_order_);
+
+  // Find the free block holding the extents, and split it down to them
+  for (uint32_t k = order; k <= max_order_; k++) {
+    uint64_t block = ext & ~(Size(k) - 1);
+    auto it = free_[k].find(block);
+    if (it == free_[k].end()) continue;
+
+    free_[k].erase(it);
+    while (k > order) {
+      k--;
+      if (ext >= block + Size(k)) {
+        free_[k].insert(block);
+        block += Size(k);
+      } else {
+        free_[k].insert(block + Size(k));
+      }
+    }
+    used_ += Size(order);
+    return true;
+  }
+  return false;
+}
+
+}  // namespace
+
+void *cpnd_ext_create(uint32_t n_chunks, uint32_t max_order) {
+  return new ExtentAllocator(n_chunks, max_order);
+}
+
+void cpnd_ext_destroy(void *ext_alloc) {
+  delete static_cast<ExtentAllocator *>(ext_alloc);
+}
+
+bool cpnd_ext_alloc(void *ext_alloc, uint32_t order, uint64_t *ext) {
+  return static_cast<ExtentAllocator *>(ext_alloc)->Alloc(order, ext);
+}
+
+void cpnd_ext_free(void *ext_alloc, uint64_t *ext, uint32_t *order) {
+  static_cast<ExtentAllocator *>(ext_alloc)->Free(ext, order);
+}
+
+bool cpnd_ext_reserve(void *ext_alloc, uint64_t ext, uint32_t order) {
+  return static_cast<ExtentAllocator *>(ext_alloc)->Reserve(ext, order);
+}
+
+uint64_t cpnd_ext_used(const void *ext_alloc) {
+  return static_cast<const ExtentAllocator *>(ext_alloc)->used();
+}
+
+uint32_t cpnd_ext_order(uint64_t size, uint64_t ext_size) {
+  uint32_t order = 0;
+
+  while ((ext_size << order) < size) order++;
+  return order;
+}
@@ -0,0 +1,55 @@
+/*      -*- OpenSAF  -*-
+ *
+ * (C) Copyright 2017 The OpenSAF Foundation
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. This file and program are licensed
+ * under the GNU Lesser General Public License Version 2.1, February 1999.
+ * The complete license can be accessed from the following location:
+ * http://opensource.org/licenses/lgpl-license.php
+ * See the Copying file included with the OpenSAF distribution for full
+ * licensing terms.
+ *
+ */
+#ifndef CKPT_CKPTND_CPND_EXT_H_
+#define CKPT_CKPTND_CPND_EXT_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Buddy allocator of the extents of the data area of a replica, see
+ * cpsv_shm.h. The area is n_chunks chunks of 2^max_order extents, a block
+ * of order k is 2^k extents aligned on 2^k extents within its chunk.
+ */
+void *cpnd_ext_create(uint32_t n_chunks, uint32_t max_order);
+
+void cpnd_ext_destroy(void *ext_alloc);
+
+/* Allocates a block of the order, returns false if there is none */
+bool cpnd_ext_alloc(void *ext_alloc, uint32_t order, uint64_t *ext);
+
+/* Frees a block. *ext and *order are set to the free block it merged
+   into, the pages of which are unused. */
+void cpnd_ext_free(void *ext_alloc, uint64_t *ext, uint32_t *order);
+
+/* Marks a block as allocated, returns false if it is not free */
+bool cpnd_ext_reserve(void *ext_alloc, uint64_t ext, uint32_t order);
+
+/* Extents in allocated blocks */
+uint64_t cpnd_ext_used(const void *ext_alloc);
+
+/* Order of the smallest block of size bytes or more, size must fit in a
+   block of the largest order */
+uint32_t cpnd_ext_order(uint64_t size, uint64_t ext_size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // CKPT_CKPTND_CPND_EXT_H_
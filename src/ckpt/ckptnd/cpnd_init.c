@@ -28,15 +28,25 @@
   cpnd_main_process ...........Process all the events posted to CPND.
 ******************************************************************************/
 
+#include <signal.h>
 #include "base/daemon.h"
 #include "ckpt/ckptnd/cpnd.h"
 #include "base/osaf_poll.h"
 #include "base/osaf_time.h"
 
-enum { FD_TERM, FD_MBX, FD_AMF, FD_CLM, FD_CLM_UPDATED, NUMBER_OF_FDS };
+enum {
+	FD_TERM,
+	FD_MBX,
+	FD_AMF,
+	FD_CLM,
+	FD_CLM_UPDATED,
+	FD_USR1,
+	NUMBER_OF_FDS
+};
 
 #define CPND_CLM_API_TIMEOUT 10000000000LL
 uint32_t gl_cpnd_cb_hdl = 0;
+static NCS_SEL_OBJ usr1_sel_obj;
 
 /* Static Function Declerations */
 static uint32_t cpnd_extract_create_info(int argc, char *argv[],
@@ -227,6 +237,10 @@ static uint32_t cpnd_lib_init(CPND_CREATE_INFO *info)
 		cb->shm_alloc_guaranteed = 2;
 	}
 
+	/* Get the write coalescing window of active replica checkpoints */
+	if ((ptr = getenv("OSAF_CKPT_REPL_COALESCE_MS")) != NULL)
+		cb->repl_coalesce_ms = atoi(ptr);
+
 	/* create a mail box */
 	if ((rc = m_NCS_IPC_CREATE(&cb->cpnd_mbx)) != NCSCC_RC_SUCCESS) {
 		LOG_ER("cpnd ipc create fail");
@@ -483,6 +497,18 @@ static bool cpnd_clear_mbx(NCSCONTEXT arg, NCSCONTEXT msg)
 	return true;
 }
 
+/**
+ * USR1 signal is used to dump the state of CPND to a file, see
+ * cpnd_file_dump(). Wake up the main thread to do it.
+ *
+ * @param sig
+ */
+static void sigusr1_handler(int sig)
+{
+	(void)sig;
+	ncs_sel_obj_ind(&usr1_sel_obj);
+}
+
 /****************************************************************************
  * Name          : cpnd_main_process
  *
@@ -530,6 +556,16 @@ void cpnd_main_process(CPND_CB *cb)
 
 	daemon_sigterm_install(&term_fd);
 
+	fds[FD_USR1].fd = -1;
+	fds[FD_USR1].events = POLLIN;
+	if (ncs_sel_obj_create(&usr1_sel_obj) != NCSCC_RC_SUCCESS) {
+		LOG_ER("cpnd ncs_sel_obj_create failed");
+	} else if (signal(SIGUSR1, sigusr1_handler) == SIG_ERR) {
+		LOG_ER("cpnd signal USR1 failed: %s", strerror(errno));
+	} else {
+		fds[FD_USR1].fd = m_GET_FD_FROM_SEL_OBJ(usr1_sel_obj);
+	}
+
 	fds[FD_TERM].fd = term_fd;
 	fds[FD_TERM].events = POLLIN;
 	fds[FD_AMF].fd = amf_sel_obj;
@@ -599,6 +635,17 @@ void cpnd_main_process(CPND_CB *cb)
 			ncs_sel_obj_rmv_ind(&cb->clm_updated_sel_obj, true,
 					    true);
 		}
+
+		/* dump the state on request */
+		if (fds[FD_USR1].revents & POLLIN) {
+			int rc;
+
+			ncs_sel_obj_rmv_ind(&usr1_sel_obj, true, true);
+			rc = cpnd_file_dump(cb, NULL);
+			if (rc != 0)
+				LOG_ER("cpnd state dump failed: %s",
+				       strerror(rc));
+		}
 	}
 	TRACE_LEAVE();
 	return;
@@ -95,7 +95,23 @@ void cpnd_ckpt_replica_delete(CPND_CB *cb, CPND_CKPT_NODE *ckpt_node);
 uint32_t cpnd_ckpt_replica_create(CPND_CB *cb, CPND_CKPT_NODE *cp_node);
 uint32_t cpnd_ckpt_remote_cpnd_add(CPND_CKPT_NODE *cp_node, MDS_DEST mds_info);
 uint32_t cpnd_ckpt_remote_cpnd_del(CPND_CKPT_NODE *cp_node, MDS_DEST mds_info);
+uint32_t cpnd_repl_coalesce(CPND_CB *cb, CPND_CKPT_NODE *cp_node,
+                            const CPSV_CKPT_ACCESS *write);
+uint32_t cpnd_repl_build(CPND_CKPT_NODE *cp_node, bool ovwrite,
+                         CPSV_CKPT_DATA **head, SaSizeT *bytes);
+void cpnd_repl_data_free(CPSV_CKPT_DATA *data);
+void cpnd_repl_flush(CPND_CB *cb, CPND_CKPT_NODE *cp_node);
+void cpnd_repl_discard(CPND_CKPT_NODE *cp_node);
+void cpnd_repl_dump(FILE *f, const CPND_CKPT_NODE *cp_node);
+uint32_t cpnd_ckpt_slot_map_init(CPND_CKPT_REPLICA_INFO *rep_info,
+                                 uint32_t max_secs, SaSizeT max_sec_size);
+void cpnd_ckpt_slot_map_rebuild(CPND_CKPT_REPLICA_INFO *rep_info,
+                                uint32_t max_secs);
+void cpnd_ckpt_slot_map_free(CPND_CKPT_REPLICA_INFO *rep_info);
 int32_t cpnd_ckpt_get_lck_sec_id(CPND_CKPT_NODE *cp_node);
+void cpnd_ckpt_put_lck_sec_id(CPND_CB *cb, CPND_CKPT_NODE *cp_node,
+                              uint32_t lcl_sec_id);
+char *cpnd_sect_data(CPND_CKPT_NODE *cp_node, uint32_t lcl_sec_id);
 uint32_t cpnd_ckpt_sec_write(CPND_CB *cb, CPND_CKPT_NODE *cp_node,
                              CPND_CKPT_SECTION_INFO *sec_info, const void *data,
                              uint64_t size, uint64_t offset, uint32_t type);
@@ -118,6 +134,7 @@ uint32_t cpnd_proc_update_remote(CPND_CB *cb, CPND_CKPT_NODE *cp_node,
 uint32_t cpnd_proc_rt_expiry(CPND_CB *cb, SaCkptCheckpointHandleT ckpt_id);
 uint32_t cpnd_proc_sec_expiry(CPND_CB *cb, CPND_TMR_INFO *tmr_info);
 void cpnd_cb_dump(void);
+int cpnd_file_dump(CPND_CB *cb, const char *filename);
 void cpnd_proc_cpd_down(CPND_CB *cb);
 void cpnd_proc_free_cpsv_ckpt_data(CPSV_CKPT_DATA *data);
 uint32_t cpnd_allrepl_write_evt_node_free(
@@ -214,6 +231,11 @@ void cpnd_allrepl_write_evt_node_tree_destroy(CPND_CB *cb);
 uint32_t cpnd_sec_hdr_update(CPND_CB *cb, CPND_CKPT_SECTION_INFO *pSecPtr,
                              CPND_CKPT_NODE *cp_node);
 uint32_t cpnd_ckpt_hdr_update(CPND_CB *cb, CPND_CKPT_NODE *cp_node);
+void cpnd_sect_dir_init(CPND_CKPT_NODE *cp_node);
+bool cpnd_sect_slot_begin(CPND_CKPT_NODE *cp_node, uint32_t lcl_sec_id);
+void cpnd_sect_slot_end(CPND_CKPT_NODE *cp_node, uint32_t lcl_sec_id,
+                        bool begun);
+void cpnd_sect_slot_release(CPND_CKPT_NODE *cp_node, uint32_t lcl_sec_id);
 void cpnd_ckpt_node_destroy(CPND_CB *cb, CPND_CKPT_NODE *cp_node);
 uint32_t cpnd_get_slot_sub_slot_id_from_mds_dest(MDS_DEST dest);
 uint32_t cpnd_get_slot_sub_slot_id_from_node_id(NCS_NODE_ID i_node_id);
@@ -54,6 +54,9 @@ static void cpnd_dump_ckpt_attri(CPND_CKPT_NODE *cp_node);
 static void cpnd_ckpt_sc_cpnd_mdest_del(CPND_CB *cb);
 static void cpnd_headless_ckpt_node_del(CPND_CB *cb);
 static SaUint32T cpnd_get_imm_attr(char **attribute_names);
+static void cpnd_sect_idx_insert(CPND_CKPT_NODE *cp_node, uint32_t lcl_sec_id);
+static void cpnd_sect_idx_remove(CPND_CKPT_NODE *cp_node, uint32_t lcl_sec_id);
+static void cpnd_sect_idx_rebuild(CPND_CKPT_NODE *cp_node);
 
 /****************************************************************************
  * Name          : cpnd_ckpt_client_add
@@ -403,9 +406,7 @@ uint32_t cpnd_ckpt_replica_destroy(CPND_CB *cb, CPND_CKPT_NODE *cp_node,
 		    cp_node->replica_info.open.info.open.i_name);
 
 		/* freeing the sec_mapping memory */
-		if (cp_node->replica_info.shm_sec_mapping)
-			m_MMGR_FREE_CPND_DEFAULT(
-			    cp_node->replica_info.shm_sec_mapping);
+		cpnd_ckpt_slot_map_free(&cp_node->replica_info);
 	}
 
 	if (!m_CPND_IS_COLLOCATED_ATTR_SET(
@@ -487,7 +488,6 @@ uint32_t cpnd_ckpt_replica_create(CPND_CB *cb, CPND_CKPT_NODE *cp_node)
 
 	uint32_t rc = NCSCC_RC_SUCCESS;
 	char *buf;
-	int32_t sec_cnt = 0;
 
 	TRACE_ENTER();
 	/* Check  maximum number of allowed replicas ,if exceeded Return Error
@@ -500,21 +500,18 @@ uint32_t cpnd_ckpt_replica_create(CPND_CB *cb, CPND_CKPT_NODE *cp_node)
 	}
 
 	buf = m_MMGR_ALLOC_CPND_DEFAULT(CPND_MAX_REPLICA_NAME_LENGTH);
-	memset(buf, '\0', CPND_MAX_REPLICA_NAME_LENGTH);
-	strncpy(buf, cp_node->ckpt_name, CPND_REP_NAME_MAX_CKPT_NAME_LENGTH);
-
-	sprintf(buf + strlen(buf) - 1, "_%u_%llu",
-		(uint32_t)m_NCS_NODE_ID_FROM_MDS_DEST(cb->cpnd_mdest_id),
-		cp_node->ckpt_id);
+	cpsv_replica_name(
+	    buf, cp_node->ckpt_name,
+	    (uint32_t)m_NCS_NODE_ID_FROM_MDS_DEST(cb->cpnd_mdest_id),
+	    cp_node->ckpt_id);
 	/* size of chkpt */
 	memset(&cp_node->replica_info.open, '\0',
 	       sizeof(cp_node->replica_info.open));
 
 	cp_node->replica_info.open.type = NCS_OS_POSIX_SHM_REQ_OPEN;
 	cp_node->replica_info.open.info.open.i_size =
-	    sizeof(CPSV_CKPT_HDR) +
-	    cp_node->create_attrib.maxSections *
-		(sizeof(CPSV_SECT_HDR) + cp_node->create_attrib.maxSectionSize);
+	    m_CPSV_REPLICA_SIZE(cp_node->create_attrib.maxSections,
+				cp_node->create_attrib.maxSectionSize);
 	cp_node->replica_info.open.ensures_space =
 	    cb->shm_alloc_guaranteed == 1;
 
@@ -546,12 +543,16 @@ again:
 	if (cp_node->replica_info.open.info.open.i_flags & O_CREAT)
 		cb->num_rep++;
 
-	cp_node->replica_info.shm_sec_mapping =
-	    (uint32_t *)m_MMGR_ALLOC_CPND_DEFAULT(
-		sizeof(uint32_t) * cp_node->create_attrib.maxSections);
+	if (cpnd_ckpt_slot_map_init(&cp_node->replica_info,
+				    cp_node->create_attrib.maxSections,
+				    cp_node->create_attrib.maxSectionSize) !=
+	    NCSCC_RC_SUCCESS) {
+		LOG_ER("cpnd section map alloc failed");
+		TRACE_LEAVE();
+		return NCSCC_RC_FAILURE;
+	}
 
-	for (; sec_cnt < cp_node->create_attrib.maxSections; sec_cnt++)
-		cp_node->replica_info.shm_sec_mapping[sec_cnt] = 1;
+	cpnd_sect_dir_init(cp_node);
 
 	TRACE_LEAVE();
 	return rc;
@@ -642,40 +643,305 @@ uint32_t cpnd_ckpt_remote_cpnd_del(CPND_CKPT_NODE *cp_node, MDS_DEST mds_info)
 }
 
 /****************************************************************************
- * Name          :  cpnd_ckpt_get_lck_sec_id
+ * Name          : cpnd_ckpt_slot_map_init
  *
- * Description   : Function to process the
- *                 from Applications.
+ * Description   : Allocates the section slot map of a replica, with all
+ *                 slots free, and the allocator of the blocks of section
+ *                 data. The free slots are also kept on a stack, so that
+ *                 getting and putting a slot is O(1) whatever the
+ *                 maxSections of the checkpoint.
  *
- * Arguments     : CPND_CKPT_NODE *cp_node  - CPND CKPT pointer
+ * Arguments     : CPND_CKPT_REPLICA_INFO *rep_info - Replica info, opened
+ *                 max_secs - maxSections of the checkpoint
+ *                 max_sec_size - maxSectionSize of the checkpoint
  *
  * Return Values : NCSCC_RC_SUCCESS/Error.
  *
  * Notes         : None.
  *****************************************************************************/
+uint32_t cpnd_ckpt_slot_map_init(CPND_CKPT_REPLICA_INFO *rep_info,
+				 uint32_t max_secs, SaSizeT max_sec_size)
+{
+	uint32_t i;
+
+	rep_info->shm_sec_mapping = (uint32_t *)m_MMGR_ALLOC_CPND_DEFAULT(
+	    sizeof(uint32_t) * max_secs);
+	rep_info->free_sec_ids = (uint32_t *)m_MMGR_ALLOC_CPND_DEFAULT(
+	    sizeof(uint32_t) * max_secs);
+	if (max_secs != 0 && (rep_info->shm_sec_mapping == NULL ||
+			      rep_info->free_sec_ids == NULL)) {
+		cpnd_ckpt_slot_map_free(rep_info);
+		return NCSCC_RC_FAILURE;
+	}
+
+	for (i = 0; i < max_secs; i++)
+		rep_info->shm_sec_mapping[i] = 1;
+	cpnd_ckpt_slot_map_rebuild(rep_info, max_secs);
+
+	cpsv_sect_geometry(max_sec_size, &rep_info->ext_size,
+			   &rep_info->max_order);
+	rep_info->ext_alloc = cpnd_ext_create(max_secs, rep_info->max_order);
+	rep_info->sect_dir =
+	    (CPSV_SECT_SLOT *)((char *)rep_info->open.info.open.o_addr +
+			       m_CPSV_SECT_DIR_OFFSET +
+			       sizeof(CPSV_SECT_DIR_HDR));
+	return NCSCC_RC_SUCCESS;
+}
+
+/****************************************************************************
+ * Name          : cpnd_ckpt_slot_map_rebuild
+ *
+ * Description   : Rebuilds the stack of free slots from shm_sec_mapping,
+ *                 lowest slot on top. Used after restoring the sections of
+ *                 a replica from shared memory.
+ *
+ * Arguments     : CPND_CKPT_REPLICA_INFO *rep_info - Replica info
+ *                 max_secs - maxSections of the checkpoint
+ *
+ * Return Values : None.
+ *
+ * Notes         : None.
+ *****************************************************************************/
+void cpnd_ckpt_slot_map_rebuild(CPND_CKPT_REPLICA_INFO *rep_info,
+				uint32_t max_secs)
+{
+	uint32_t i = max_secs;
+
+	rep_info->n_free_sec_ids = 0;
+	while (i-- > 0) {
+		if (rep_info->shm_sec_mapping[i] == 1)
+			rep_info->free_sec_ids[rep_info->n_free_sec_ids++] = i;
+	}
+}
+
+void cpnd_ckpt_slot_map_free(CPND_CKPT_REPLICA_INFO *rep_info)
+{
+	if (rep_info->shm_sec_mapping)
+		m_MMGR_FREE_CPND_DEFAULT(rep_info->shm_sec_mapping);
+	if (rep_info->free_sec_ids)
+		m_MMGR_FREE_CPND_DEFAULT(rep_info->free_sec_ids);
+	if (rep_info->ext_alloc)
+		cpnd_ext_destroy(rep_info->ext_alloc);
+	rep_info->shm_sec_mapping = NULL;
+	rep_info->free_sec_ids = NULL;
+	rep_info->n_free_sec_ids = 0;
+	rep_info->ext_alloc = NULL;
+	rep_info->sect_dir = NULL;
+}
+
+/****************************************************************************
+ * Name          : cpnd_sect_data
+ *
+ * Description   : Address of the data block of a section in the replica
+ *
+ * Arguments     : CPND_CKPT_NODE *cp_node - CPND CKPT pointer
+ *                 lcl_sec_id - Slot of the section
+ *
+ * Return Values : The address
+ *****************************************************************************/
+char *cpnd_sect_data(CPND_CKPT_NODE *cp_node, uint32_t lcl_sec_id)
+{
+	CPND_CKPT_REPLICA_INFO *rep_info = &cp_node->replica_info;
+
+	return (char *)rep_info->open.info.open.o_addr +
+	       m_CPSV_SECT_DATA_OFFSET(rep_info->sect_dir[lcl_sec_id].ext,
+				       rep_info->ext_size,
+				       cp_node->create_attrib.maxSections);
+}
+
+/****************************************************************************
+ * Name          : cpnd_sect_data_release
+ *
+ * Description   : Gives the whole pages of a free range of the section data
+ *                 area back to the shared memory file system, unless the
+ *                 replica memory is pre-allocated
+ *                 (OSAF_CKPT_SHM_ALLOC_GUARANTEE=1).
+ *
+ * Arguments     : CPND_CB *cb - CPND CB pointer
+ *                 CPND_CKPT_NODE *cp_node - CPND CKPT pointer
+ *                 start, end - Extents of the free range
+ *
+ * Return Values : None.
+ *****************************************************************************/
+static void cpnd_sect_data_release(CPND_CB *cb, CPND_CKPT_NODE *cp_node,
+				   uint64_t start, uint64_t end)
+{
+	CPND_CKPT_REPLICA_INFO *rep_info = &cp_node->replica_info;
+	uintptr_t page_size = (uintptr_t)sysconf(_SC_PAGESIZE);
+	uintptr_t base, first, last;
+
+	if (cb->shm_alloc_guaranteed == 1 || start >= end)
+		return;
+
+	base = (uintptr_t)rep_info->open.info.open.o_addr +
+	       m_CPSV_SECT_DATA_BASE(cp_node->create_attrib.maxSections);
+	first = base + start * rep_info->ext_size;
+	last = base + end * rep_info->ext_size;
+	first = (first + page_size - 1) & ~(page_size - 1);
+	last &= ~(page_size - 1);
+	if (first < last &&
+	    madvise((void *)first, last - first, MADV_REMOVE) != 0)
+		TRACE_4("cpnd madvise of section data failed: %s",
+			strerror(errno));
+}
+
+/****************************************************************************
+ * Name          : cpnd_sect_block_set
+ *
+ * Description   : Records the data block of a section in its slot
+ *****************************************************************************/
+static void cpnd_sect_block_set(CPND_CKPT_NODE *cp_node, uint32_t lcl_sec_id,
+				uint64_t ext, uint32_t order)
+{
+	bool begun = cpnd_sect_slot_begin(cp_node, lcl_sec_id);
+	CPSV_SECT_SLOT *slot = &cp_node->replica_info.sect_dir[lcl_sec_id];
+
+	slot->ext = ext;
+	slot->order = order;
+	cpnd_sect_slot_end(cp_node, lcl_sec_id, begun);
+}
+
+/****************************************************************************
+ * Name          :  cpnd_ckpt_get_lck_sec_id
+ *
+ * Description   : Takes a free section slot of the replica, with the
+ *                 smallest data block. Slots freed last are reused first,
+ *                 which keeps the used part of the replica segment dense.
+ *
+ * Arguments     : CPND_CKPT_NODE *cp_node  - CPND CKPT pointer
+ *
+ * Return Values : The slot, -1 if all slots are used.
+ *
+ * Notes         : A free slot always gets a block, the data area has room
+ *                 for a maxSectionSize block per slot.
+ *****************************************************************************/
 int32_t cpnd_ckpt_get_lck_sec_id(CPND_CKPT_NODE *cp_node)
 {
-	uint32_t i = 0;
+	CPND_CKPT_REPLICA_INFO *rep_info = &cp_node->replica_info;
+	uint64_t ext;
+	uint32_t i;
 
-	for (; i < cp_node->create_attrib.maxSections; i++)
-		if (cp_node->replica_info.shm_sec_mapping[i] == 1) {
-			cp_node->replica_info.shm_sec_mapping[i] = 0;
-			break;
-		}
-	if (i == cp_node->create_attrib.maxSections) {
+	if (rep_info->n_free_sec_ids == 0)
+		return -1;
+
+	if (!cpnd_ext_alloc(rep_info->ext_alloc, 0, &ext)) {
+		LOG_ER("cpnd no section data block left in %s",
+		       cp_node->ckpt_name);
 		return -1;
 	}
 
+	i = rep_info->free_sec_ids[--rep_info->n_free_sec_ids];
+	rep_info->shm_sec_mapping[i] = 0;
+	cpnd_sect_block_set(cp_node, i, ext, 0);
 	return i;
 }
 
+/****************************************************************************
+ * Name          : cpnd_ckpt_put_lck_sec_id
+ *
+ * Description   : Frees the slot of a deleted section and its data block.
+ *                 The whole pages of the free block the data block merges
+ *                 into are given back to the shared memory file system, so
+ *                 a checkpoint only holds memory for its live sections.
+ *
+ * Arguments     : CPND_CB *cb - CPND CB pointer
+ *                 CPND_CKPT_NODE *cp_node - CPND CKPT pointer
+ *                 lcl_sec_id - Slot of the deleted section
+ *
+ * Return Values : None.
+ *
+ * Notes         : Putting a slot that is already free is ignored.
+ *****************************************************************************/
+void cpnd_ckpt_put_lck_sec_id(CPND_CB *cb, CPND_CKPT_NODE *cp_node,
+			      uint32_t lcl_sec_id)
+{
+	CPND_CKPT_REPLICA_INFO *rep_info = &cp_node->replica_info;
+	CPSV_SECT_SLOT *slot;
+	uint64_t ext;
+	uint32_t order;
+
+	if (rep_info->shm_sec_mapping == NULL ||
+	    lcl_sec_id >= cp_node->create_attrib.maxSections ||
+	    rep_info->shm_sec_mapping[lcl_sec_id] == 1)
+		return;
+
+	rep_info->shm_sec_mapping[lcl_sec_id] = 1;
+	rep_info->free_sec_ids[rep_info->n_free_sec_ids++] = lcl_sec_id;
+
+	/* Readers of the slot retry before its block is reused */
+	cpnd_sect_slot_release(cp_node, lcl_sec_id);
+	slot = &rep_info->sect_dir[lcl_sec_id];
+	ext = slot->ext;
+	order = slot->order;
+	cpnd_ext_free(rep_info->ext_alloc, &ext, &order);
+	cpnd_sect_data_release(cb, cp_node, ext, ext + (1ULL << order));
+}
+
+/****************************************************************************
+ * Name          : cpnd_sect_resize
+ *
+ * Description   : Moves the data of a section to a block of the order,
+ *                 keeping its first keep bytes. The old block is freed
+ *                 first, so that the section can grow into it and the
+ *                 allocation can not fail. Called in the seqlock of the
+ *                 slot.
+ *
+ * Arguments     : CPND_CB *cb - CPND CB pointer
+ *                 CPND_CKPT_NODE *cp_node - CPND CKPT pointer
+ *                 lcl_sec_id - Slot of the section
+ *                 order - Order of the new block
+ *                 keep - Bytes of data to keep
+ *
+ * Return Values : NCSCC_RC_SUCCESS/Error.
+ *****************************************************************************/
+static uint32_t cpnd_sect_resize(CPND_CB *cb, CPND_CKPT_NODE *cp_node,
+				 uint32_t lcl_sec_id, uint32_t order,
+				 uint64_t keep)
+{
+	CPND_CKPT_REPLICA_INFO *rep_info = &cp_node->replica_info;
+	CPSV_SECT_SLOT *slot = &rep_info->sect_dir[lcl_sec_id];
+	uint64_t old_ext = slot->ext, free_ext = slot->ext, new_ext;
+	uint32_t old_order = slot->order, free_order = slot->order;
+	uint64_t free_end, new_end;
+	char *old_data = cpnd_sect_data(cp_node, lcl_sec_id);
+
+	cpnd_ext_free(rep_info->ext_alloc, &free_ext, &free_order);
+	if (!cpnd_ext_alloc(rep_info->ext_alloc, order, &new_ext)) {
+		LOG_ER("cpnd no section data block of order %u in %s", order,
+		       cp_node->ckpt_name);
+		osafassert(cpnd_ext_reserve(rep_info->ext_alloc, old_ext,
+					    old_order));
+		return NCSCC_RC_FAILURE;
+	}
+
+	slot->ext = new_ext;
+	slot->order = order;
+	if (keep != 0 && new_ext != old_ext)
+		memmove(cpnd_sect_data(cp_node, lcl_sec_id), old_data, keep);
+
+	/* The new block holds the only live data of the free block */
+	free_end = free_ext + (1ULL << free_order);
+	new_end = new_ext + (1ULL << order);
+	cpnd_sect_data_release(cb, cp_node, free_ext,
+			       new_ext < free_end ? new_ext : free_end);
+	cpnd_sect_data_release(cb, cp_node,
+			       new_end > free_ext ? new_end : free_ext,
+			       free_end);
+	return NCSCC_RC_SUCCESS;
+}
+
 /****************************************************************************
  * Name          : cpnd_ckpt_sec_write
  *
- * Description   : Function to process the
- *                 from Applications.
+ * Description   : Writes data of a section to the replica, moving the
+ *                 section to a block of its new size when it changes.
  *
  * Arguments     : CPND_CB *cb - CPND CB pointer
+ *                 CPND_CKPT_NODE *cp_node - CPND CKPT pointer
+ *                 sec_info - Section
+ *                 data, size, offset - Data to write
+ *                 type - 0 writes at offset, 1 (overwrite) and 3 (sync)
+ *                        replace the data
  *
  * Return Values : NCSCC_RC_SUCCESS/Error.
  *
@@ -686,28 +952,44 @@ uint32_t cpnd_ckpt_sec_write(CPND_CB *cb, CPND_CKPT_NODE *cp_node,
 			     uint64_t size, uint64_t offset, uint32_t type)
 { /* for sync type=2 */
 	uint32_t rc = NCSCC_RC_SUCCESS;
+	CPND_CKPT_REPLICA_INFO *rep_info = &cp_node->replica_info;
 	NCS_OS_POSIX_SHM_REQ_INFO write_req;
+	uint64_t new_size, keep;
+	uint32_t order;
+	bool begun;
 
 	TRACE_ENTER();
 	/* checking to write,whether it is possible to write or not */
 
-	if (type == 0) {
-		if (offset + size > cp_node->create_attrib.maxSectionSize) {
-			return NCSCC_RC_FAILURE;
-		}
-	} else if (type == 1) { /* Over write Case */
-		if (size > cp_node->create_attrib.maxSectionSize) {
-			return NCSCC_RC_FAILURE;
-		}
+	if (offset + size > cp_node->create_attrib.maxSectionSize ||
+	    offset + size < offset) {
+		return NCSCC_RC_FAILURE;
+	}
+
+	if (type == 1 || type == 3) {
+		new_size = offset + size;
+		keep = 0;
+	} else {
+		new_size = offset + size;
+		if (new_size < sec_info->sec_size)
+			new_size = sec_info->sec_size;
+		keep = sec_info->sec_size < offset ? sec_info->sec_size
+						   : offset;
+	}
+
+	begun = cpnd_sect_slot_begin(cp_node, sec_info->lcl_sec_id);
+
+	order = cpnd_ext_order(new_size, rep_info->ext_size);
+	if (order != rep_info->sect_dir[sec_info->lcl_sec_id].order &&
+	    cpnd_sect_resize(cb, cp_node, sec_info->lcl_sec_id, order,
+			     keep) != NCSCC_RC_SUCCESS) {
+		cpnd_sect_slot_end(cp_node, sec_info->lcl_sec_id, begun);
+		return NCSCC_RC_FAILURE;
 	}
 
 	write_req.type = NCS_OS_POSIX_SHM_REQ_WRITE;
 	write_req.info.write.i_addr =
-	    (void *)((char *)cp_node->replica_info.open.info.open.o_addr +
-		     sizeof(CPSV_CKPT_HDR) +
-		     ((sec_info->lcl_sec_id + 1) * sizeof(CPSV_SECT_HDR)) +
-		     (sec_info->lcl_sec_id *
-		      cp_node->create_attrib.maxSectionSize));
+	    cpnd_sect_data(cp_node, sec_info->lcl_sec_id);
 	write_req.info.write.i_from_buff = (uint8_t *)data;
 
 	/* if ( type == 0) Needs to be cleaned up later TBD
@@ -719,6 +1001,7 @@ uint32_t cpnd_ckpt_sec_write(CPND_CB *cb, CPND_CKPT_NODE *cp_node,
 	write_req.ensures_space = cb->shm_alloc_guaranteed != 0;
 	if (ncs_os_posix_shm(&write_req) == NCSCC_RC_FAILURE) {
 		LOG_ER("shm write failed for cpnd_ckpt_sec_write");
+		cpnd_sect_slot_end(cp_node, sec_info->lcl_sec_id, begun);
 		return NCSCC_RC_FAILURE;
 	}
 
@@ -749,6 +1032,7 @@ uint32_t cpnd_ckpt_sec_write(CPND_CB *cb, CPND_CKPT_NODE *cp_node,
 			rc = NCSCC_RC_FAILURE;
 		}
 	}
+	cpnd_sect_slot_end(cp_node, sec_info->lcl_sec_id, begun);
 	TRACE_LEAVE();
 	return rc;
 }
@@ -776,11 +1060,7 @@ uint32_t cpnd_ckpt_sec_read(CPND_CKPT_NODE *cp_node,
 	NCS_OS_POSIX_SHM_REQ_INFO read_req;
 	read_req.type = NCS_OS_POSIX_SHM_REQ_READ;
 	read_req.info.read.i_addr =
-	    (void *)((char *)cp_node->replica_info.open.info.open.o_addr +
-		     sizeof(CPSV_CKPT_HDR) +
-		     ((sec_info->lcl_sec_id + 1) * sizeof(CPSV_SECT_HDR)) +
-		     (sec_info->lcl_sec_id *
-		      cp_node->create_attrib.maxSectionSize));
+	    cpnd_sect_data(cp_node, sec_info->lcl_sec_id);
 	read_req.info.read.i_to_buff = data;
 	read_req.info.read.i_read_size = size;
 	read_req.info.read.i_offset = offset;
@@ -1524,7 +1804,11 @@ uint32_t cpnd_proc_update_remote(CPND_CB *cb, CPND_CKPT_NODE *cp_node,
 		      cp_node->create_attrib.creationFlags) == true)) {
 		/* send rsp to agent */
 		/* send to all other cpnd's using mds send */
-		if (cp_node->cpnd_dest_list != NULL) {
+		if (cp_node->cpnd_dest_list != NULL && cb->repl_coalesce_ms &&
+		    cpnd_repl_coalesce(cb, cp_node, &in_evt->info.ckpt_write) ==
+			NCSCC_RC_SUCCESS) {
+			/* Sent by cpnd_repl_flush() */
+		} else if (cp_node->cpnd_dest_list != NULL) {
 			CPSV_CPND_DEST_INFO *tmp = NULL;
 			tmp = cp_node->cpnd_dest_list;
 			send_evt.type = CPSV_EVT_TYPE_CPND;
@@ -1703,7 +1987,7 @@ uint32_t cpnd_proc_sec_expiry(CPND_CB *cb, CPND_TMR_INFO *tmr_info)
 	}
 
 	cpnd_ckpt_sec_del(cb, cp_node, &pSec_info->sec_id, true);
-	cp_node->replica_info.shm_sec_mapping[pSec_info->lcl_sec_id] = 1;
+	cpnd_ckpt_put_lck_sec_id(cb, cp_node, pSec_info->lcl_sec_id);
 
 	/* send out destory to all cpnd's maintaining this ckpt */
 	if (cp_node->cpnd_dest_list != NULL) {
@@ -2038,6 +2322,7 @@ uint32_t cpnd_sec_hdr_update(CPND_CB *cb, CPND_CKPT_SECTION_INFO *sec_info,
 	CPSV_SECT_HDR sec_hdr;
 	uint32_t rc = NCSCC_RC_SUCCESS;
 	NCS_OS_POSIX_SHM_REQ_INFO write_req;
+	bool begun;
 	memset(&write_req, '\0', sizeof(write_req));
 	memset(&sec_hdr, '\0', sizeof(CPSV_SECT_HDR));
 	sec_hdr.lcl_sec_id = sec_info->lcl_sec_id;
@@ -2048,28 +2333,293 @@ uint32_t cpnd_sec_hdr_update(CPND_CB *cb, CPND_CKPT_SECTION_INFO *sec_info,
 	sec_hdr.exp_tmr = sec_info->exp_tmr;
 	sec_hdr.lastUpdate = sec_info->lastUpdate;
 
-	if ((sec_info->lcl_sec_id *
-	     (sizeof(CPSV_SECT_HDR) + cp_node->create_attrib.maxSectionSize)) >
-	    UINTMAX_MAX) {
-		LOG_ER(
-		    "cpnd Section hdr update failed exceeded the update limits(UINT64_MAX)");
+	if (sec_info->lcl_sec_id >= cp_node->create_attrib.maxSections) {
+		LOG_ER("cpnd Section hdr update failed, invalid slot %u",
+		       sec_info->lcl_sec_id);
 		return NCSCC_RC_FAILURE;
 	}
 	write_req.type = NCS_OS_POSIX_SHM_REQ_WRITE;
 	write_req.info.write.i_addr =
-	    (void *)((char *)cp_node->replica_info.open.info.open.o_addr +
-		     sizeof(CPSV_CKPT_HDR));
+	    cp_node->replica_info.open.info.open.o_addr;
 	write_req.info.write.i_from_buff = (CPSV_SECT_HDR *)&sec_hdr;
-	write_req.info.write.i_offset =
-	    sec_info->lcl_sec_id *
-	    (sizeof(CPSV_SECT_HDR) + cp_node->create_attrib.maxSectionSize);
+	write_req.info.write.i_offset = m_CPSV_SECT_HDR_OFFSET(
+	    sec_info->lcl_sec_id, cp_node->create_attrib.maxSections);
 	write_req.info.write.i_write_size = sizeof(CPSV_SECT_HDR);
 	write_req.ensures_space = cb->shm_alloc_guaranteed != 0;
+
+	begun = cpnd_sect_slot_begin(cp_node, sec_info->lcl_sec_id);
 	rc = ncs_os_posix_shm(&write_req);
+	if ((rc == NCSCC_RC_SUCCESS) && cp_node->replica_info.sect_dir &&
+	    !cp_node->replica_info.sect_dir[sec_info->lcl_sec_id].in_use) {
+		cp_node->replica_info.sect_dir[sec_info->lcl_sec_id].in_use =
+		    1;
+		cpnd_sect_idx_insert(cp_node, sec_info->lcl_sec_id);
+	}
+	cpnd_sect_slot_end(cp_node, sec_info->lcl_sec_id, begun);
 
 	return rc;
 }
 
+/****************************************************************************
+ * Name          : cpnd_sect_dir_init
+ *
+ * Description   : Initializes the section directory of the replica (see
+ *                 cpsv_shm.h), marking the slots of the sections known by
+ *                 CPND as in use. Called when the replica is created and
+ *                 when it is restored after a CPND restart, after the
+ *                 blocks of the sections are set in their slots.
+ *
+ * Arguments     : CPND_CKPT_NODE *cp_node - Checkpoint node
+ *
+ * Return Values : None
+ *****************************************************************************/
+void cpnd_sect_dir_init(CPND_CKPT_NODE *cp_node)
+{
+	CPND_CKPT_REPLICA_INFO *rep_info = &cp_node->replica_info;
+	CPSV_SECT_DIR_HDR *dir_hdr;
+	CPSV_SECT_SLOT *slot;
+	CPND_CKPT_SECTION_INFO *sec_info;
+	uint32_t max_secs = cp_node->create_attrib.maxSections;
+	uint32_t i;
+
+	dir_hdr = (CPSV_SECT_DIR_HDR *)((char *)rep_info->open.info.open
+					    .o_addr +
+					m_CPSV_SECT_DIR_OFFSET);
+
+	/* Readers ignore the directory until it is ready again */
+	__atomic_store_n(&dir_hdr->ready, 0, __ATOMIC_SEQ_CST);
+	dir_hdr->magic = CPSV_SECT_DIR_MAGIC;
+	dir_hdr->n_slots = max_secs;
+	dir_hdr->ext_size = rep_info->ext_size;
+	dir_hdr->max_order = rep_info->max_order;
+	for (i = 0; i < max_secs; i++) {
+		slot = &rep_info->sect_dir[i];
+		/* A restarted CPND may have died in the middle of an update */
+		if (slot->seq & 1)
+			slot->seq++;
+		slot->in_use = 0;
+	}
+
+	sec_info = cpnd_ckpt_sec_get_first(rep_info);
+	while (sec_info) {
+		if (sec_info->lcl_sec_id < max_secs)
+			rep_info->sect_dir[sec_info->lcl_sec_id].in_use = 1;
+		sec_info = cpnd_ckpt_sec_get_next(rep_info, sec_info);
+	}
+	cpnd_sect_idx_rebuild(cp_node);
+	__atomic_store_n(&dir_hdr->ready, 1, __ATOMIC_RELEASE);
+}
+
+/****************************************************************************
+ * Name          : cpnd_sect_slot_begin / cpnd_sect_slot_end
+ *
+ * Description   : Brackets an update of the header or data of a section in
+ *                 the replica, making the seq of its slot odd meanwhile.
+ *                 Calls may nest, only the outermost pair changes seq:
+ *                 pass the value returned by begin to end.
+ *
+ * Arguments     : CPND_CKPT_NODE *cp_node - Checkpoint node
+ *                 lcl_sec_id - Slot of the section
+ *****************************************************************************/
+bool cpnd_sect_slot_begin(CPND_CKPT_NODE *cp_node, uint32_t lcl_sec_id)
+{
+	CPSV_SECT_SLOT *slot;
+
+	if (!cp_node->replica_info.sect_dir ||
+	    lcl_sec_id >= cp_node->create_attrib.maxSections)
+		return false;
+
+	slot = &cp_node->replica_info.sect_dir[lcl_sec_id];
+	if (slot->seq & 1)
+		return false;
+
+	__atomic_store_n(&slot->seq, slot->seq + 1, __ATOMIC_RELAXED);
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+	return true;
+}
+
+void cpnd_sect_slot_end(CPND_CKPT_NODE *cp_node, uint32_t lcl_sec_id,
+			bool begun)
+{
+	CPSV_SECT_SLOT *slot;
+
+	if (!begun)
+		return;
+
+	slot = &cp_node->replica_info.sect_dir[lcl_sec_id];
+	__atomic_store_n(&slot->seq, slot->seq + 1, __ATOMIC_RELEASE);
+}
+
+/****************************************************************************
+ * Name          : cpnd_sect_slot_release
+ *
+ * Description   : Marks the slot of a deleted section as free in the
+ *                 section directory of the replica.
+ *
+ * Arguments     : CPND_CKPT_NODE *cp_node - Checkpoint node
+ *                 lcl_sec_id - Slot of the section
+ *****************************************************************************/
+void cpnd_sect_slot_release(CPND_CKPT_NODE *cp_node, uint32_t lcl_sec_id)
+{
+	bool begun = cpnd_sect_slot_begin(cp_node, lcl_sec_id);
+
+	if (begun && cp_node->replica_info.sect_dir[lcl_sec_id].in_use) {
+		cpnd_sect_idx_remove(cp_node, lcl_sec_id);
+		cp_node->replica_info.sect_dir[lcl_sec_id].in_use = 0;
+	}
+	cpnd_sect_slot_end(cp_node, lcl_sec_id, begun);
+}
+
+/****************************************************************************
+ * Name          : cpnd_sect_idx_begin / cpnd_sect_idx_end
+ *
+ * Description   : Brackets a change of the section index of the replica,
+ *                 making idx_seq odd meanwhile, see cpsv_shm.h.
+ *****************************************************************************/
+static CPSV_SECT_DIR_HDR *cpnd_sect_idx_begin(CPND_CKPT_NODE *cp_node)
+{
+	CPSV_SECT_DIR_HDR *dir_hdr =
+	    (CPSV_SECT_DIR_HDR *)((char *)cp_node->replica_info.open.info.open
+				      .o_addr +
+				  m_CPSV_SECT_DIR_OFFSET);
+
+	__atomic_store_n(&dir_hdr->idx_seq, dir_hdr->idx_seq + 1,
+			 __ATOMIC_RELAXED);
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+	return dir_hdr;
+}
+
+static void cpnd_sect_idx_end(CPSV_SECT_DIR_HDR *dir_hdr)
+{
+	__atomic_store_n(&dir_hdr->idx_seq, dir_hdr->idx_seq + 1,
+			 __ATOMIC_RELEASE);
+}
+
+/****************************************************************************
+ * Name          : cpnd_sect_idx_home
+ *
+ * Description   : Entry of the section index where the lookup of the
+ *                 section in a slot starts. Uses the id in the section
+ *                 header of the slot, which is what CPA compares.
+ *****************************************************************************/
+static uint64_t cpnd_sect_idx_home(CPND_CKPT_NODE *cp_node,
+				   uint32_t lcl_sec_id)
+{
+	uint32_t max_secs = cp_node->create_attrib.maxSections;
+	const CPSV_SECT_HDR *sec_hdr =
+	    (const CPSV_SECT_HDR *)((char *)cp_node->replica_info.open.info
+					.open.o_addr +
+				    m_CPSV_SECT_HDR_OFFSET(lcl_sec_id,
+							   max_secs));
+	uint32_t len = sec_hdr->idLen < MAX_SIZE ? sec_hdr->idLen : MAX_SIZE;
+
+	return cpsv_sect_id_hash(sec_hdr->id, len) %
+	       m_CPSV_SECT_IDX_SIZE(max_secs);
+}
+
+static uint32_t *cpnd_sect_idx(CPND_CKPT_NODE *cp_node)
+{
+	return (uint32_t *)((char *)cp_node->replica_info.open.info.open
+				.o_addr +
+			    m_CPSV_SECT_IDX_OFFSET(
+				cp_node->create_attrib.maxSections));
+}
+
+/****************************************************************************
+ * Name          : cpnd_sect_idx_insert
+ *
+ * Description   : Adds the section of a slot to the section index, after
+ *                 its header is written.
+ *
+ * Arguments     : CPND_CKPT_NODE *cp_node - Checkpoint node
+ *                 lcl_sec_id - Slot of the section
+ *****************************************************************************/
+static void cpnd_sect_idx_insert(CPND_CKPT_NODE *cp_node, uint32_t lcl_sec_id)
+{
+	uint64_t n = m_CPSV_SECT_IDX_SIZE(cp_node->create_attrib.maxSections);
+	uint32_t *idx = cpnd_sect_idx(cp_node);
+	uint64_t i = cpnd_sect_idx_home(cp_node, lcl_sec_id);
+	CPSV_SECT_DIR_HDR *dir_hdr;
+
+	/* At most half of the entries are used */
+	while (idx[i] != 0)
+		i = (i + 1) % n;
+
+	dir_hdr = cpnd_sect_idx_begin(cp_node);
+	__atomic_store_n(&idx[i], lcl_sec_id + 1, __ATOMIC_RELAXED);
+	cpnd_sect_idx_end(dir_hdr);
+}
+
+/****************************************************************************
+ * Name          : cpnd_sect_idx_remove
+ *
+ * Description   : Removes the section of a slot from the section index,
+ *                 before its slot is freed. The entries after it that
+ *                 would not be found anymore are moved back.
+ *
+ * Arguments     : CPND_CKPT_NODE *cp_node - Checkpoint node
+ *                 lcl_sec_id - Slot of the section
+ *****************************************************************************/
+static void cpnd_sect_idx_remove(CPND_CKPT_NODE *cp_node, uint32_t lcl_sec_id)
+{
+	uint64_t n = m_CPSV_SECT_IDX_SIZE(cp_node->create_attrib.maxSections);
+	uint32_t *idx = cpnd_sect_idx(cp_node);
+	uint64_t i = cpnd_sect_idx_home(cp_node, lcl_sec_id), j, home, probe;
+	CPSV_SECT_DIR_HDR *dir_hdr;
+
+	for (probe = 0; idx[i] != lcl_sec_id + 1; probe++) {
+		if (idx[i] == 0 || probe == n) {
+			LOG_ER("cpnd section %u of %s is not in the index",
+			       lcl_sec_id, cp_node->ckpt_name);
+			return;
+		}
+		i = (i + 1) % n;
+	}
+
+	dir_hdr = cpnd_sect_idx_begin(cp_node);
+	for (j = (i + 1) % n; idx[j] != 0; j = (j + 1) % n) {
+		/* An entry stays if its home is cyclically in (i, j] */
+		home = cpnd_sect_idx_home(cp_node, idx[j] - 1);
+		if (i < j ? (i < home && home <= j) : (i < home || home <= j))
+			continue;
+		__atomic_store_n(&idx[i], idx[j], __ATOMIC_RELAXED);
+		i = j;
+	}
+	__atomic_store_n(&idx[i], 0, __ATOMIC_RELAXED);
+	cpnd_sect_idx_end(dir_hdr);
+}
+
+/****************************************************************************
+ * Name          : cpnd_sect_idx_rebuild
+ *
+ * Description   : Builds the section index from the slots in use
+ *
+ * Arguments     : CPND_CKPT_NODE *cp_node - Checkpoint node
+ *****************************************************************************/
+static void cpnd_sect_idx_rebuild(CPND_CKPT_NODE *cp_node)
+{
+	uint32_t max_secs = cp_node->create_attrib.maxSections;
+	CPSV_SECT_DIR_HDR *dir_hdr;
+	uint32_t i;
+
+	dir_hdr = (CPSV_SECT_DIR_HDR *)((char *)cp_node->replica_info.open
+					    .info.open.o_addr +
+					m_CPSV_SECT_DIR_OFFSET);
+	/* A restarted CPND may have died in the middle of a change */
+	if (dir_hdr->idx_seq & 1)
+		dir_hdr->idx_seq++;
+	dir_hdr->idx_size = m_CPSV_SECT_IDX_SIZE(max_secs);
+
+	cpnd_sect_idx_begin(cp_node);
+	memset(cpnd_sect_idx(cp_node), 0,
+	       m_CPSV_SECT_IDX_SIZE(max_secs) * sizeof(uint32_t));
+	cpnd_sect_idx_end(dir_hdr);
+	for (i = 0; i < max_secs; i++) {
+		if (cp_node->replica_info.sect_dir[i].in_use)
+			cpnd_sect_idx_insert(cp_node, i);
+	}
+}
+
 /****************************************************************************
  * Name          : cpnd_cb_dump
  *
@@ -2149,6 +2699,65 @@ void cpnd_cb_dump(void)
 		cpnd_client_node_getnext(cb, prev_cl_hdl, &cl_node);
 	}
 	TRACE("***** End of Client Details ***************");
+
+	(void)cpnd_file_dump(cb, NULL);
+}
+
+/****************************************************************************
+ * Name          : cpnd_file_dump
+ *
+ * Description   : Dumps the checkpoints of the node and their replication
+ *                 statistics to a file. Done on SIGUSR1, e.g.
+ *                 pkill -USR1 osafckptnd, and with cpnd_cb_dump().
+ *
+ * Arguments     : cb - CPND CB pointer
+ *                 filename - path to the file, or NULL for
+ *                 /tmp/ckptnd.state.<pid>
+ *
+ * Return Values : 0, or errno if the file could not be opened.
+ *
+ * Notes         : None.
+ *****************************************************************************/
+int cpnd_file_dump(CPND_CB *cb, const char *filename)
+{
+	CPND_CKPT_NODE *cp_node = NULL;
+	char path[128];
+	FILE *f;
+
+	if (filename == NULL) {
+		snprintf(path, sizeof(path), "/tmp/ckptnd.state.%d", getpid());
+		filename = path;
+	}
+
+	f = fopen(filename, "w");
+	if (f == NULL)
+		return errno;
+
+	LOG_NO("dumping state to file %s", filename);
+
+	fprintf(f, "checkpoints:\n");
+	cpnd_ckpt_node_getnext(cb, 0, &cp_node);
+	while (cp_node != NULL) {
+		fprintf(f, "  name: %s\n", cp_node->ckpt_name);
+		fprintf(f, "    ckpt_id: %llu\n", cp_node->ckpt_id);
+		fprintf(f, "    creation_flags: %u\n",
+			(uint32_t)cp_node->create_attrib.creationFlags);
+		fprintf(f, "    active_replica: %s\n",
+			(cp_node->is_active_exist &&
+			 m_CPND_IS_LOCAL_NODE(&cp_node->active_mds_dest,
+					      &cb->cpnd_mdest_id) == 0)
+			    ? "true"
+			    : "false");
+		fprintf(f, "    sections: %u\n", cp_node->replica_info.n_secs);
+		fprintf(f, "    mem_used: %u\n",
+			cp_node->replica_info.mem_used);
+		cpnd_repl_dump(f, cp_node);
+
+		cpnd_ckpt_node_getnext(cb, cp_node->ckpt_id, &cp_node);
+	}
+
+	fclose(f);
+	return 0;
 }
 
 /****************************************************************************
@@ -2937,9 +3546,7 @@ void cpnd_ckpt_replica_delete(CPND_CB *cb, CPND_CKPT_NODE *ckpt_node)
 		    ckpt_node->replica_info.open.info.open.i_name);
 
 		/* freeing the sec_mapping memory */
-		if (ckpt_node->replica_info.shm_sec_mapping)
-			m_MMGR_FREE_CPND_DEFAULT(
-			    ckpt_node->replica_info.shm_sec_mapping);
+		cpnd_ckpt_slot_map_free(&ckpt_node->replica_info);
 	}
 	TRACE_LEAVE();
 }
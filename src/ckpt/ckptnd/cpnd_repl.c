@@ -0,0 +1,388 @@
+/*      -*- OpenSAF  -*-
+ *
+ * (C) Copyright 2017 The OpenSAF Foundation
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. This file and program are licensed
+ * under the GNU Lesser General Public License Version 2.1, February 1999.
+ * The complete license can be accessed from the following location:
+ * http://opensource.org/licenses/lgpl-license.php
+ * See the Copying file included with the OpenSAF distribution for full
+ * licensing terms.
+ *
+ */
+
+/*****************************************************************************
+  FILE NAME: cpnd_repl.c
+
+  DESCRIPTION: Coalesced replication of active replica writes.
+
+  A write to an SA_CKPT_WR_ACTIVE_REPLICA(_WEAK) checkpoint is acknowledged
+  once the active replica is updated, and was then forwarded as is to every
+  other replica. With OSAF_CKPT_REPL_COALESCE_MS set, the active CPND only
+  records which byte range of which section changed, and sends the changed
+  ranges when the window expires. Writes to the same section within the
+  window become one element, carrying the data of the active replica at the
+  time of the flush. All elements go in one message per replica, overwrites
+  in a second one since they may shrink the section.
+
+  The pending list is flushed early when it grows beyond
+  CPND_REPL_MAX_PENDING sections or CPND_REPL_MAX_PENDING_BYTES, and
+  before the active replica moves to another node.
+
+******************************************************************************/
+
+#include "ckpt/ckptnd/cpnd.h"
+#include "base/osaf_time.h"
+
+#define CPND_REPL_MAX_PENDING 256
+#define CPND_REPL_MAX_PENDING_BYTES (1024 * 1024)
+
+static SaTimeT cpnd_repl_now(void)
+{
+	struct timespec ts;
+
+	osaf_clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (SaTimeT)osaf_timespec_to_nanos(&ts);
+}
+
+static void cpnd_repl_pending_free(CPND_REPL_PENDING *pend)
+{
+	if (pend->sec_id.id != NULL)
+		m_MMGR_FREE_CPND_DEFAULT(pend->sec_id.id);
+	m_MMGR_FREE_CPND_DEFAULT(pend);
+}
+
+static CPND_REPL_PENDING *cpnd_repl_pending_get(CPND_CKPT_NODE *cp_node,
+						const SaCkptSectionIdT *id)
+{
+	CPND_REPL_PENDING *pend;
+
+	for (pend = cp_node->repl_pending; pend != NULL; pend = pend->next) {
+		if (pend->sec_id.idLen == id->idLen &&
+		    (id->idLen == 0 ||
+		     memcmp(pend->sec_id.id, id->id, id->idLen) == 0))
+			return pend;
+	}
+
+	pend = m_MMGR_ALLOC_CPND_DEFAULT(sizeof(CPND_REPL_PENDING));
+	if (pend == NULL)
+		return NULL;
+	memset(pend, 0, sizeof(CPND_REPL_PENDING));
+	pend->sec_id.idLen = id->idLen;
+	if (id->idLen != 0) {
+		pend->sec_id.id = m_MMGR_ALLOC_CPND_DEFAULT(id->idLen);
+		if (pend->sec_id.id == NULL) {
+			m_MMGR_FREE_CPND_DEFAULT(pend);
+			return NULL;
+		}
+		memcpy(pend->sec_id.id, id->id, id->idLen);
+	}
+	pend->next = cp_node->repl_pending;
+	cp_node->repl_pending = pend;
+	cp_node->n_repl_pending++;
+	return pend;
+}
+
+/****************************************************************************
+ * Name          : cpnd_repl_coalesce
+ *
+ * Description   : Records a write applied to the active replica, to be
+ *                 sent to the other replicas by cpnd_repl_flush().
+ *
+ * Arguments     : CPND_CB *cb - CPND CB pointer
+ *                 CPND_CKPT_NODE *cp_node - Checkpoint node
+ *                 CPSV_CKPT_ACCESS *write - The write, already applied
+ *
+ * Return Values : NCSCC_RC_SUCCESS, or NCSCC_RC_FAILURE if the write could
+ *                 not be recorded and must be sent as is.
+ *
+ * Notes         : None.
+ *****************************************************************************/
+uint32_t cpnd_repl_coalesce(CPND_CB *cb, CPND_CKPT_NODE *cp_node,
+			    const CPSV_CKPT_ACCESS *write)
+{
+	CPND_REPL_PENDING *pend;
+	const CPSV_CKPT_DATA *data;
+	SaOffsetT lo, hi;
+	uint32_t i;
+
+	/* Earlier pending writes must not be overtaken by this one */
+	if (write->type != CPSV_CKPT_ACCESS_WRITE &&
+	    write->type != CPSV_CKPT_ACCESS_OVWRITE) {
+		cpnd_repl_flush(cb, cp_node);
+		return NCSCC_RC_FAILURE;
+	}
+
+	if (cp_node->repl_pending == NULL)
+		cp_node->repl_pending_since = cpnd_repl_now();
+
+	data = write->data;
+	for (i = 0; i < write->num_of_elmts && data != NULL;
+	     i++, data = data->next) {
+		cp_node->repl_stats.writes++;
+		pend = cpnd_repl_pending_get(cp_node, &data->sec_id);
+		if (pend == NULL) {
+			LOG_ER("cpnd repl pending alloc failed");
+			cpnd_repl_flush(cb, cp_node);
+			return NCSCC_RC_FAILURE;
+		}
+		if (pend->ovwrite || pend->has_range)
+			cp_node->repl_stats.coalesced++;
+
+		if (write->type == CPSV_CKPT_ACCESS_OVWRITE) {
+			pend->ovwrite = true;
+		} else if (!pend->ovwrite) {
+			lo = data->dataOffset;
+			hi = data->dataOffset + data->dataSize;
+			if (!pend->has_range) {
+				pend->lo = lo;
+				pend->hi = hi;
+				pend->has_range = true;
+			} else {
+				/* One range per section, the gap is resent */
+				if (lo < pend->lo)
+					pend->lo = lo;
+				if (hi > pend->hi)
+					pend->hi = hi;
+			}
+		}
+		cp_node->repl_pending_bytes += data->dataSize;
+	}
+
+	if (cp_node->n_repl_pending >= CPND_REPL_MAX_PENDING ||
+	    cp_node->repl_pending_bytes >= CPND_REPL_MAX_PENDING_BYTES) {
+		cpnd_repl_flush(cb, cp_node);
+	} else if (!cp_node->repl_flush_tmr.is_active) {
+		cp_node->repl_flush_tmr.type = CPND_TMR_TYPE_REPL_FLUSH;
+		cp_node->repl_flush_tmr.uarg = cb->cpnd_cb_hdl_id;
+		cp_node->repl_flush_tmr.ckpt_id = cp_node->ckpt_id;
+		cpnd_tmr_start(&cp_node->repl_flush_tmr,
+			       (cb->repl_coalesce_ms + 9) / 10);
+	}
+	return NCSCC_RC_SUCCESS;
+}
+
+/****************************************************************************
+ * Name          : cpnd_repl_build
+ *
+ * Description   : Builds the elements of one flush message from the pending
+ *                 list, with the current data of the active replica. The
+ *                 elements are in the order of the first write to their
+ *                 section.
+ *
+ * Arguments     : CPND_CKPT_NODE *cp_node - Checkpoint node
+ *                 bool ovwrite - Overwritten or written sections
+ *                 CPSV_CKPT_DATA **head - The elements
+ *                 SaSizeT *bytes - Incremented by their data bytes
+ *
+ * Return Values : Number of elements, *head is the list to free with
+ *                 cpnd_repl_data_free().
+ *****************************************************************************/
+uint32_t cpnd_repl_build(CPND_CKPT_NODE *cp_node, bool ovwrite,
+			 CPSV_CKPT_DATA **head, SaSizeT *bytes)
+{
+	CPND_REPL_PENDING *pend;
+	CPND_CKPT_SECTION_INFO *sec_info;
+	CPSV_CKPT_DATA *data;
+	SaOffsetT lo, hi;
+	uint32_t n = 0;
+
+	*head = NULL;
+	for (pend = cp_node->repl_pending; pend != NULL; pend = pend->next) {
+		if (pend->ovwrite != ovwrite)
+			continue;
+		/* A section deleted meanwhile was deleted on the replicas */
+		sec_info = cpnd_ckpt_sec_get(cp_node, &pend->sec_id);
+		if (sec_info == NULL)
+			continue;
+
+		if (ovwrite) {
+			lo = 0;
+			hi = sec_info->sec_size;
+		} else {
+			lo = pend->lo;
+			hi = pend->hi;
+			if (hi > sec_info->sec_size)
+				hi = sec_info->sec_size;
+			if (lo >= hi)
+				continue;
+		}
+
+		data = m_MMGR_ALLOC_CPND_DEFAULT(sizeof(CPSV_CKPT_DATA));
+		if (data == NULL)
+			break;
+		memset(data, 0, sizeof(CPSV_CKPT_DATA));
+		data->sec_id = pend->sec_id;
+		data->dataOffset = lo;
+		data->dataSize = hi - lo;
+		if (data->dataSize != 0) {
+			data->data = m_MMGR_ALLOC_CPND_DEFAULT(data->dataSize);
+			if (data->data == NULL) {
+				m_MMGR_FREE_CPND_DEFAULT(data);
+				break;
+			}
+			cpnd_ckpt_sec_read(cp_node, sec_info, data->data,
+					   data->dataSize, lo);
+		}
+		*bytes += data->dataSize;
+		data->next = *head;
+		*head = data;
+		n++;
+	}
+	return n;
+}
+
+void cpnd_repl_data_free(CPSV_CKPT_DATA *data)
+{
+	CPSV_CKPT_DATA *next;
+
+	for (; data != NULL; data = next) {
+		next = data->next;
+		if (data->data != NULL)
+			m_MMGR_FREE_CPND_DEFAULT(data->data);
+		m_MMGR_FREE_CPND_DEFAULT(data);
+	}
+}
+
+static void cpnd_repl_send(CPND_CB *cb, CPND_CKPT_NODE *cp_node,
+			   uint32_t type, CPSV_CKPT_DATA *data, uint32_t n)
+{
+	CPSV_CPND_DEST_INFO *dest;
+	CPSV_EVT send_evt;
+
+	memset(&send_evt, 0, sizeof(CPSV_EVT));
+	send_evt.type = CPSV_EVT_TYPE_CPND;
+	send_evt.info.cpnd.type =
+	    CPSV_EVT_ND2ND_CKPT_SECT_ACTIVE_DATA_ACCESS_REQ;
+	send_evt.info.cpnd.info.ckpt_nd2nd_data.type = type;
+	send_evt.info.cpnd.info.ckpt_nd2nd_data.ckpt_id = cp_node->ckpt_id;
+	send_evt.info.cpnd.info.ckpt_nd2nd_data.agent_mdest =
+	    cb->cpnd_mdest_id;
+	send_evt.info.cpnd.info.ckpt_nd2nd_data.num_of_elmts = n;
+	send_evt.info.cpnd.info.ckpt_nd2nd_data.data = data;
+
+	for (dest = cp_node->cpnd_dest_list; dest != NULL; dest = dest->next) {
+		if (cpnd_mds_msg_send(cb, NCSMDS_SVC_ID_CPND, dest->dest,
+				      &send_evt) != NCSCC_RC_SUCCESS)
+			TRACE_4("cpnd repl flush send failed ckpt_id:%llx,"
+				"dest:%" PRIu64,
+				cp_node->ckpt_id, dest->dest);
+	}
+	cp_node->repl_stats.batches++;
+	cp_node->repl_stats.elements += n;
+}
+
+/****************************************************************************
+ * Name          : cpnd_repl_flush
+ *
+ * Description   : Sends the pending writes of a checkpoint to the other
+ *                 replicas and updates the replication lag statistics.
+ *
+ * Arguments     : CPND_CB *cb - CPND CB pointer
+ *                 CPND_CKPT_NODE *cp_node - Checkpoint node
+ *
+ * Return Values : None.
+ *
+ * Notes         : Does nothing if no write is pending.
+ *****************************************************************************/
+void cpnd_repl_flush(CPND_CB *cb, CPND_CKPT_NODE *cp_node)
+{
+	CPSV_CKPT_DATA *data;
+	SaSizeT bytes = 0;
+	SaTimeT lag;
+	uint32_t n;
+
+	if (cp_node->repl_pending == NULL)
+		return;
+
+	TRACE_ENTER2("ckpt_id:%llx pending:%u", cp_node->ckpt_id,
+		     cp_node->n_repl_pending);
+	if (cp_node->repl_flush_tmr.is_active)
+		cpnd_tmr_stop(&cp_node->repl_flush_tmr);
+
+	if (cp_node->cpnd_dest_list != NULL &&
+	    cp_node->replica_info.open.info.open.o_addr != NULL) {
+		n = cpnd_repl_build(cp_node, false, &data, &bytes);
+		if (n != 0)
+			cpnd_repl_send(cb, cp_node, CPSV_CKPT_ACCESS_WRITE,
+				       data, n);
+		cpnd_repl_data_free(data);
+
+		n = cpnd_repl_build(cp_node, true, &data, &bytes);
+		if (n != 0)
+			cpnd_repl_send(cb, cp_node, CPSV_CKPT_ACCESS_OVWRITE,
+				       data, n);
+		cpnd_repl_data_free(data);
+	}
+
+	cp_node->repl_stats.bytes += bytes;
+	lag = cpnd_repl_now() - cp_node->repl_pending_since;
+	cp_node->repl_stats.last_lag = lag;
+	if (lag > cp_node->repl_stats.max_lag)
+		cp_node->repl_stats.max_lag = lag;
+
+	cpnd_repl_discard(cp_node);
+	TRACE_LEAVE();
+}
+
+/****************************************************************************
+ * Name          : cpnd_repl_discard
+ *
+ * Description   : Drops the pending writes of a checkpoint without sending
+ *                 them, e.g. when the replica is destroyed.
+ *
+ * Arguments     : CPND_CKPT_NODE *cp_node - Checkpoint node
+ *
+ * Return Values : None.
+ *****************************************************************************/
+void cpnd_repl_discard(CPND_CKPT_NODE *cp_node)
+{
+	CPND_REPL_PENDING *pend, *next;
+
+	if (cp_node->repl_flush_tmr.is_active ||
+	    cp_node->repl_flush_tmr.tmr_id != TMR_T_NULL)
+		cpnd_tmr_stop(&cp_node->repl_flush_tmr);
+
+	for (pend = cp_node->repl_pending; pend != NULL; pend = next) {
+		next = pend->next;
+		cpnd_repl_pending_free(pend);
+	}
+	cp_node->repl_pending = NULL;
+	cp_node->n_repl_pending = 0;
+	cp_node->repl_pending_bytes = 0;
+}
+
+/****************************************************************************
+ * Name          : cpnd_repl_dump
+ *
+ * Description   : Writes the replication statistics of a checkpoint to a
+ *                 state file, as part of cpnd_file_dump().
+ *
+ * Arguments     : FILE *f - The state file
+ *                 CPND_CKPT_NODE *cp_node - Checkpoint node
+ *
+ * Return Values : None.
+ *****************************************************************************/
+void cpnd_repl_dump(FILE *f, const CPND_CKPT_NODE *cp_node)
+{
+	const CPND_REPL_STATS *stats = &cp_node->repl_stats;
+
+	fprintf(f, "    repl_writes: %llu\n",
+		(unsigned long long)stats->writes);
+	fprintf(f, "    repl_coalesced: %llu\n",
+		(unsigned long long)stats->coalesced);
+	fprintf(f, "    repl_batches: %llu\n",
+		(unsigned long long)stats->batches);
+	fprintf(f, "    repl_elements: %llu\n",
+		(unsigned long long)stats->elements);
+	fprintf(f, "    repl_bytes: %llu\n", (unsigned long long)stats->bytes);
+	fprintf(f, "    repl_last_lag_us: %llu\n",
+		(unsigned long long)(stats->last_lag / 1000));
+	fprintf(f, "    repl_max_lag_us: %llu\n",
+		(unsigned long long)(stats->max_lag / 1000));
+	fprintf(f, "    repl_pending_sections: %u\n", cp_node->n_repl_pending);
+	fprintf(f, "    repl_pending_bytes: %llu\n",
+		(unsigned long long)cp_node->repl_pending_bytes);
+}
@@ -55,6 +55,13 @@
 #define m_CPND_CKPTHDR_UPDATE(ckpt_hdr, offset)                                \
 	memcpy(offset, &ckpt_hdr, sizeof(CKPT_HDR))
 
+/* Replicas written by earlier releases have maxSections SEC_HDR/SEC_DATA
+   pairs of fixed size after the CKPT_HDR, the sections in the first n_secs
+   of them */
+#define m_CPND_LEGACY_SECT_HDR_OFFSET(lcl_sec_id, max_sec_size)               \
+	(sizeof(CPSV_CKPT_HDR) +                                               \
+	 (uint64_t)(lcl_sec_id) * (sizeof(CPSV_SECT_HDR) + (max_sec_size)))
+
 static uint32_t cpnd_res_ckpt_sec_add(CPND_CKPT_SECTION_INFO *pSecPtr,
 				      CPND_CKPT_NODE *cp_node);
 static bool cpnd_find_exact_ckptinfo(CPND_CB *cb, CKPT_INFO *ckpt_info,
@@ -63,6 +70,10 @@ static bool cpnd_find_exact_ckptinfo(CPND_CB *cb, CKPT_INFO *ckpt_info,
 static void cpnd_clear_ckpt_info(CPND_CB *cb, CPND_CKPT_NODE *cp_node,
 				 uint32_t curr_offset, uint32_t prev_offset);
 static void cpnd_destroy_shm(NCS_OS_POSIX_SHM_REQ_OPEN_INFO *open_req);
+static int cpnd_res_legacy_open(const char *buf);
+static uint32_t cpnd_res_legacy_convert(int fd, char *addr,
+					const CKPT_INFO *cp_info,
+					const char *buf);
 static uint32_t cpnd_shm_extended_open(CPND_CB *cb, uint32_t flag);
 static uint32_t cpnd_extended_name_lend(SaConstStringT value, SaNameT *name);
 static SaConstStringT cpnd_extended_name_borrow(const SaNameT *name);
@@ -146,110 +157,258 @@ uint32_t cpnd_res_ckpt_sec_del(CPND_CKPT_NODE *cp_node)
 	return NCSCC_RC_SUCCESS;
 }
 
-/**************************************************************************************************************
- * Name           : cpnd_ckpt_replica_create_res
+/****************************************************************************
+ * Name           : cpnd_res_legacy_open
  *
- * Description    : To read the data from the checkpoint replica shared memory
- *and fill up the data structures
+ * Description    : Opens a replica segment written by an earlier release,
+ *                  with fixed size sections.
  *
- * Arguments      : NCS_OS_POSIX_SHM_REQ_INFO *open_req -  Shared Memory Request
- *Info pointer uint8_t* buf  - Name of the shared memory CPND_CKPT_NODE *cp_node
- *- CPND_CKPT_NODE pointer ref_cnt
+ * Arguments      : buf - Name of the replica segment
  *
- * Return Values  :
- * Notes          : None
- **************************************************************************************************************/
+ * Return Values  : File descriptor of the segment, -1 if the segment has
+ *                  the current layout or can not be opened.
+ ****************************************************************************/
+static int cpnd_res_legacy_open(const char *buf)
+{
+	char shm_name[PATH_MAX];
+	CPSV_SECT_DIR_HDR dir_hdr;
+	int fd;
+
+	snprintf(shm_name, sizeof(shm_name), "/opensaf_%s", buf);
+	fd = shm_open(shm_name, O_RDONLY, 0);
+	if (fd < 0)
+		return -1;
+
+	if (pread(fd, &dir_hdr, sizeof(dir_hdr), m_CPSV_SECT_DIR_OFFSET) ==
+		sizeof(dir_hdr) &&
+	    dir_hdr.magic == CPSV_SECT_DIR_MAGIC) {
+		close(fd);
+		return -1;
+	}
+	return fd;
+}
+
+/****************************************************************************
+ * Name           : cpnd_res_legacy_convert
+ *
+ * Description    : Copies the live sections of a replica written by an
+ *                  earlier release to a new segment with the current
+ *                  layout. The sections keep their slots, and get a block
+ *                  of their size.
+ *
+ * Arguments      : fd      - The legacy segment
+ *                  addr    - The new segment, empty
+ *                  cp_info - Checkpoint info of the replica
+ *                  buf     - Name of the replica segment
+ *
+ * Return Values  : NCSCC_RC_SUCCESS/NCSCC_RC_FAILURE
+ ****************************************************************************/
+static uint32_t cpnd_res_legacy_convert(int fd, char *addr,
+					const CKPT_INFO *cp_info,
+					const char *buf)
+{
+	uint32_t max_secs = cp_info->maxSections, n_slots, i, order;
+	SaSizeT max_sec_size = cp_info->maxSecSize;
+	CPSV_SECT_DIR_HDR *dir_hdr =
+	    (CPSV_SECT_DIR_HDR *)(addr + m_CPSV_SECT_DIR_OFFSET);
+	CPSV_SECT_SLOT *slots = (CPSV_SECT_SLOT *)(dir_hdr + 1);
+	uint64_t ext_size, ext;
+	uint32_t max_order, counter = 0;
+	CPSV_CKPT_HDR ckpt_hdr;
+	CPSV_SECT_HDR sect_hdr;
+	void *ext_alloc = NULL;
+	uint32_t rc = NCSCC_RC_FAILURE;
+
+	TRACE_ENTER2("%s", buf);
+
+	if (pread(fd, &ckpt_hdr, sizeof(ckpt_hdr), 0) != sizeof(ckpt_hdr)) {
+		LOG_ER("cpnd ckpt HDR read of legacy replica %s failed", buf);
+		goto done;
+	}
+	memcpy(addr, &ckpt_hdr, sizeof(ckpt_hdr));
+
+	n_slots = ckpt_hdr.n_secs < max_secs ? ckpt_hdr.n_secs : max_secs;
+
+	cpsv_sect_geometry(max_sec_size, &ext_size, &max_order);
+	ext_alloc = cpnd_ext_create(max_secs, max_order);
+
+	for (i = 0; i < n_slots; i++) {
+		if (pread(fd, &sect_hdr, sizeof(sect_hdr),
+			  m_CPND_LEGACY_SECT_HDR_OFFSET(i, max_sec_size)) !=
+		    sizeof(sect_hdr)) {
+			LOG_ER("cpnd sect HDR read of legacy replica %s failed",
+			       buf);
+			goto done;
+		}
+		if (sect_hdr.lcl_sec_id != i || sect_hdr.idLen > MAX_SIZE ||
+		    sect_hdr.sec_size > max_sec_size) {
+			LOG_NO("cpnd sect HDR of slot %u in %s is invalid", i,
+			       buf);
+			continue;
+		}
 
-/*
- |-----------|--------- |----------
- |--------|----------|-------------|----------|---------| | CKPT_HDR  | SEC_HDR
- | SEC_INFO  |SEC_HDR | SEC_INFO |.............|  SEC_HDR |SEC_INFO | |
- |          |           |        |          |             |          |         |
- |-----------|----------|-----------|--------|----------|------------
- |----------|---------|
-*/
+		order = cpnd_ext_order(sect_hdr.sec_size, ext_size);
+		if (!cpnd_ext_alloc(ext_alloc, order, &ext) ||
+		    pread(fd,
+			  addr + m_CPSV_SECT_DATA_OFFSET(ext, ext_size,
+							 max_secs),
+			  sect_hdr.sec_size,
+			  m_CPND_LEGACY_SECT_HDR_OFFSET(i, max_sec_size) +
+			      sizeof(sect_hdr)) != (ssize_t)sect_hdr.sec_size) {
+			LOG_ER(
+			    "cpnd section data copy of legacy replica %s failed",
+			    buf);
+			goto done;
+		}
+		memcpy(addr + m_CPSV_SECT_HDR_OFFSET(i, max_secs), &sect_hdr,
+		       sizeof(sect_hdr));
+		slots[i].ext = ext;
+		slots[i].order = order;
+		slots[i].in_use = 1;
+		counter++;
+	}
 
+	dir_hdr->n_slots = max_secs;
+	dir_hdr->ext_size = ext_size;
+	dir_hdr->max_order = max_order;
+	dir_hdr->magic = CPSV_SECT_DIR_MAGIC;
+	LOG_NO("cpnd converted replica %s with %u sections to extents", buf,
+	       counter);
+	rc = NCSCC_RC_SUCCESS;
+
+done:
+	if (ext_alloc != NULL)
+		cpnd_ext_destroy(ext_alloc);
+	TRACE_LEAVE2("Ret val %d", rc);
+	return rc;
+}
+
+/****************************************************************************
+ * Name           : cpnd_ckpt_replica_create_res
+ *
+ * Description    : To read the data from the checkpoint replica shared
+ *                  memory and fill up the data structures. A replica
+ *                  written by an earlier release is converted to the
+ *                  current layout first, see cpsv_shm.h.
+ *
+ * Arguments      : NCS_OS_POSIX_SHM_REQ_INFO *open_req - Shared Memory
+ *                  Request Info pointer
+ *                  buf - Name of the shared memory
+ *                  CPND_CKPT_NODE *cp_node - CPND_CKPT_NODE pointer
+ *                  ref_cnt, cp_info - Checkpoint info of the replica
+ *
+ * Return Values  : NCSCC_RC_SUCCESS/NCSCC_RC_FAILURE
+ * Notes          : None
+ ****************************************************************************/
 uint32_t cpnd_ckpt_replica_create_res(CPND_CB *cb,
 				      NCS_OS_POSIX_SHM_REQ_INFO *open_req,
 				      char *buf, CPND_CKPT_NODE **cp_node,
 				      uint32_t ref_cnt, CKPT_INFO *cp_info)
 {
-	/*   NCS_OS_POSIX_SHM_REQ_INFO read_req,shm_read; */
 	CPSV_CKPT_HDR ckpt_hdr;
 	CPSV_SECT_HDR sect_hdr;
 	uint32_t counter = 0, sec_cnt = 0, rc = NCSCC_RC_SUCCESS;
 	CPND_CKPT_SECTION_INFO *pSecPtr = NULL;
-	NCS_OS_POSIX_SHM_REQ_INFO read_req;
+	NCS_OS_POSIX_SHM_REQ_INFO read_req, unlink_req;
+	CPND_CKPT_REPLICA_INFO *rep_info = &(*cp_node)->replica_info;
+	CPSV_SECT_DIR_HDR *dir_hdr;
+	CPSV_SECT_SLOT *slot;
+	uint32_t max_secs;
+	int legacy_fd;
 
 	TRACE_ENTER();
 
 	memset(&ckpt_hdr, '\0', sizeof(CPSV_CKPT_HDR));
 	open_req->type = NCS_OS_POSIX_SHM_REQ_OPEN;
 	open_req->info.open.i_size =
-	    sizeof(CPSV_CKPT_HDR) +
-	    (cp_info->maxSections *
-	     ((sizeof(CPSV_SECT_HDR) + cp_info->maxSecSize)));
+	    m_CPSV_REPLICA_SIZE(cp_info->maxSections, cp_info->maxSecSize);
 	open_req->info.open.i_offset = 0;
 	open_req->info.open.i_name = buf;
 	open_req->info.open.i_map_flags = MAP_SHARED;
 	open_req->info.open.o_addr = NULL;
 	open_req->info.open.i_flags = O_RDWR;
 	open_req->ensures_space = cb->shm_alloc_guaranteed == 1;
+
+	/* A legacy segment is replaced by a new one of the same name, its
+	   content is kept while legacy_fd is open */
+	legacy_fd = cpnd_res_legacy_open(buf);
+	if (legacy_fd >= 0) {
+		memset(&unlink_req, '\0', sizeof(unlink_req));
+		unlink_req.type = NCS_OS_POSIX_SHM_REQ_UNLINK;
+		unlink_req.info.unlink.i_name = buf;
+		if (ncs_os_posix_shm(&unlink_req) != NCSCC_RC_SUCCESS) {
+			LOG_ER("cpnd unlink of legacy replica %s failed", buf);
+			close(legacy_fd);
+			return NCSCC_RC_FAILURE;
+		}
+		open_req->info.open.i_flags = O_RDWR | O_CREAT | O_EXCL;
+	}
+
 	rc = ncs_os_posix_shm(open_req);
 	if (rc != NCSCC_RC_SUCCESS) {
 		LOG_ER("cpnd shm open request failed %s", buf);
+		if (legacy_fd >= 0)
+			close(legacy_fd);
 		/*   assert(0); */
 		return rc;
 	}
 
+	if (legacy_fd >= 0) {
+		rc = cpnd_res_legacy_convert(
+		    legacy_fd, open_req->info.open.o_addr, cp_info, buf);
+		close(legacy_fd);
+		if (rc != NCSCC_RC_SUCCESS)
+			return rc;
+	}
+
 	m_CPND_CKPT_HDR_UPDATE(ckpt_hdr, (char *)open_req->info.open.o_addr, 0);
 	(*cp_node)->create_attrib = ckpt_hdr.create_attrib;
 	(*cp_node)->open_flags = ckpt_hdr.open_flags;
 	(*cp_node)->is_active_exist = ckpt_hdr.is_active_exist;
 	(*cp_node)->active_mds_dest = ckpt_hdr.active_mds_dest;
 	(*cp_node)->ckpt_lcl_ref_cnt = ref_cnt;
-	(*cp_node)->replica_info.n_secs = ckpt_hdr.n_secs;
+	rep_info->n_secs = ckpt_hdr.n_secs;
 	(*cp_node)->cpnd_rep_create = ckpt_hdr.cpnd_rep_create;
-	(*cp_node)->replica_info.open = *open_req;
+	rep_info->open = *open_req;
 
-	if ((*cp_node)->create_attrib.maxSections == 0)
+	max_secs = (*cp_node)->create_attrib.maxSections;
+	if (max_secs == 0)
 		return rc;
 
-	(*cp_node)->replica_info.shm_sec_mapping =
-	    (uint32_t *)m_MMGR_ALLOC_CPND_DEFAULT(
-		sizeof(uint32_t) * ((*cp_node)->create_attrib.maxSections));
-
-	if ((*cp_node)->replica_info.shm_sec_mapping == NULL) {
+	if (cpnd_ckpt_slot_map_init(rep_info, max_secs,
+				    (*cp_node)->create_attrib.maxSectionSize) !=
+	    NCSCC_RC_SUCCESS) {
 		LOG_ER("cpnd default memory alloc failed");
 		/*  assert(0); */
 		return NCSCC_RC_FAILURE;
 	}
 
-	/* The below for loop  indicates all are free */
-	for (; sec_cnt < (*cp_node)->create_attrib.maxSections; sec_cnt++)
-		(*cp_node)->replica_info.shm_sec_mapping[sec_cnt] = 1;
-	sec_cnt = 0;
+	dir_hdr = (CPSV_SECT_DIR_HDR *)((char *)open_req->info.open.o_addr +
+					m_CPSV_SECT_DIR_OFFSET);
+	if (dir_hdr->magic != CPSV_SECT_DIR_MAGIC ||
+	    dir_hdr->n_slots != max_secs ||
+	    dir_hdr->ext_size != rep_info->ext_size ||
+	    dir_hdr->max_order != rep_info->max_order) {
+		LOG_ER("cpnd section directory of %s does not match the ckpt",
+		       buf);
+		rc = NCSCC_RC_FAILURE;
+		goto end;
+	}
+
+	/* The section directory tells which slots hold live sections, and
+	   where their data is */
+	for (sec_cnt = 0; sec_cnt < max_secs; sec_cnt++) {
+		slot = &rep_info->sect_dir[sec_cnt];
+		if (!slot->in_use)
+			continue;
 
-	while (counter < ckpt_hdr.n_secs) {
 		memset(&read_req, '\0', sizeof(NCS_OS_POSIX_SHM_REQ_INFO));
 		memset(&sect_hdr, '\0', sizeof(CPSV_SECT_HDR));
 		read_req.type = NCS_OS_POSIX_SHM_REQ_READ;
-		read_req.info.read.i_addr =
-		    (void *)((char *)open_req->info.open.o_addr +
-			     sizeof(CPSV_CKPT_HDR));
+		read_req.info.read.i_addr = open_req->info.open.o_addr;
 		read_req.info.read.i_read_size = sizeof(CPSV_SECT_HDR);
-		if ((counter * (sizeof(CPSV_SECT_HDR) +
-				(*cp_node)->create_attrib.maxSectionSize)) >
-		    UINTMAX_MAX) {
-			LOG_ER(
-			    "cpnd Section read failed,exceeded the read limits(UINT64_MAX) ");
-			rc = NCSCC_RC_FAILURE;
-			goto end;
-		}
-
 		read_req.info.read.i_offset =
-		    counter * (sizeof(CPSV_SECT_HDR) +
-			       (*cp_node)->create_attrib.maxSectionSize);
+		    m_CPSV_SECT_HDR_OFFSET(sec_cnt, max_secs);
 		read_req.info.read.i_to_buff = (CPSV_SECT_HDR *)&sect_hdr;
 		rc = ncs_os_posix_shm(&read_req);
 		if (rc != NCSCC_RC_SUCCESS) {
@@ -258,13 +417,17 @@ uint32_t cpnd_ckpt_replica_create_res(CPND_CB *cb,
 			goto end;
 		}
 
-		/*  macro for reading the section header information  */
-		/*    offset = counter *
-		   (sizeof(CPSV_SECT_HDR)+(*cp_node)->create_attrib.maxSectionSize);
-		   m_CPND_SEC_HDR_UPDATE(sect_hdr,open_req->info.open.o_addr+sizeof(CPSV_CKPT_HDR),offset);
-		 */
-		(*cp_node)->replica_info.shm_sec_mapping[sec_cnt] = 0;
-		sec_cnt++;
+		if (sect_hdr.lcl_sec_id != sec_cnt ||
+		    sect_hdr.idLen > MAX_SIZE ||
+		    slot->order > rep_info->max_order ||
+		    sect_hdr.sec_size > (rep_info->ext_size << slot->order) ||
+		    !cpnd_ext_reserve(rep_info->ext_alloc, slot->ext,
+				      slot->order)) {
+			LOG_NO("cpnd sect HDR of slot %u in %s is invalid",
+			       sec_cnt, buf);
+			continue;
+		}
+		rep_info->shm_sec_mapping[sec_cnt] = 0;
 		counter++;
 		pSecPtr = m_MMGR_ALLOC_CPND_CKPT_SECTION_INFO;
 		if (pSecPtr == NULL) {
@@ -306,17 +469,22 @@ uint32_t cpnd_ckpt_replica_create_res(CPND_CB *cb,
 			goto end;
 		}
 
-		memset(&sect_hdr, '\0', sizeof(CPSV_SECT_HDR));
+		rep_info->mem_used += pSecPtr->sec_size;
+	}
 
-		(*cp_node)->replica_info.mem_used += pSecPtr->sec_size;
+	if (counter != ckpt_hdr.n_secs) {
+		LOG_NO("cpnd restored %u sections of %s, header says %u",
+		       counter, buf, ckpt_hdr.n_secs);
+		rep_info->n_secs = counter;
 	}
+	cpnd_ckpt_slot_map_rebuild(rep_info, max_secs);
+	cpnd_sect_dir_init(*cp_node);
+
 	TRACE_LEAVE2("Ret val %d", rc);
 	return rc;
 
 end:
-	if ((*cp_node)->replica_info.shm_sec_mapping != NULL)
-		m_MMGR_FREE_CPND_DEFAULT(
-		    (*cp_node)->replica_info.shm_sec_mapping);
+	cpnd_ckpt_slot_map_free(rep_info);
 	cpnd_res_ckpt_sec_del(*cp_node);
 	TRACE_LEAVE2("Ret val %d", rc);
 	return rc;
@@ -607,14 +775,10 @@ void *cpnd_restart_shm_create(NCS_OS_POSIX_SHM_REQ_INFO *cpnd_open_req,
 					/* size=cp_node->ckpt_name.length; */
 					buf = m_MMGR_ALLOC_CPND_DEFAULT(
 					    CPND_MAX_REPLICA_NAME_LENGTH);
-					memset(buf, '\0',
-					       CPND_MAX_REPLICA_NAME_LENGTH);
-					strncpy(
-					    buf, cp_node->ckpt_name,
-					    CPND_REP_NAME_MAX_CKPT_NAME_LENGTH);
-					sprintf(buf + strlen(buf) - 1,
-						"_%u_%llu", (uint32_t)nodeid,
-						cp_node->ckpt_id);
+					cpsv_replica_name(buf,
+							  cp_node->ckpt_name,
+							  (uint32_t)nodeid,
+							  cp_node->ckpt_id);
 					rc = cpnd_ckpt_replica_create_res(
 					    cb, &ckpt_rep_open, buf, &cp_node,
 					    0, &cp_info);
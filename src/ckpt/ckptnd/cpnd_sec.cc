@@ -211,6 +211,9 @@ CPND_CKPT_SECTION_INFO *cpnd_ckpt_sec_del(CPND_CB *cb, CPND_CKPT_NODE *cp_node,
         LOG_ER("cpnd ckpt hdr update failed");
       }
     }
+
+    // Hide the section from collocated readers of the replica
+    cpnd_sect_slot_release(cp_node, sectionInfo->lcl_sec_id);
   }
 
   TRACE_LEAVE();
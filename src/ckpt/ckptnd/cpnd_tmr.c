@@ -91,6 +91,10 @@ void cpnd_timer_expiry(NCSCONTEXT uarg)
 		evt->info.cpnd.info.tmr_info.agent_dest = tmr->agent_dest;
 		evt->info.cpnd.info.tmr_info.write_type = tmr->write_type;
 		break;
+	case CPND_TMR_TYPE_REPL_FLUSH:
+		evt->info.cpnd.info.tmr_info.type = CPND_TMR_TYPE_REPL_FLUSH;
+		evt->info.cpnd.info.tmr_info.ckpt_id = tmr->ckpt_id;
+		break;
 	case CPND_TMR_OPEN_ACTIVE_SYNC:
 		evt->info.cpnd.info.tmr_info.type = CPND_TMR_OPEN_ACTIVE_SYNC;
 		evt->info.cpnd.info.tmr_info.ckpt_id = tmr->ckpt_id;
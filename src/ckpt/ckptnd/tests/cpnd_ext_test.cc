@@ -0,0 +1,155 @@
+/*      -*- OpenSAF  -*-
+ *
+ * (C) Copyright 2017 The OpenSAF Foundation
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. This file and program are licensed
+ * under the GNU Lesser General Public License Version 2.1, February 1999.
+ * The complete license can be accessed from the following location:
+ * http://opensource.org/licenses/lgpl-license.php
+ * See the Copying file included with the OpenSAF distribution for full
+ * licensing terms.
+ *
+ */
+
+#include <cstdlib>
+#include <set>
+#include <vector>
+#include "ckpt/ckptnd/cpnd_ext.h"
+#include "gtest/gtest.h"
+
+namespace {
+
+class CpndExtTest : public ::testing::Test {
+ protected:
+  void TearDown() override {
+    if (ext_alloc_ != nullptr) cpnd_ext_destroy(ext_alloc_);
+  }
+
+  void Create(uint32_t n_chunks, uint32_t max_order) {
+    ext_alloc_ = cpnd_ext_create(n_chunks, max_order);
+  }
+
+  uint64_t Alloc(uint32_t order) {
+    uint64_t ext = UINT64_MAX;
+    EXPECT_TRUE(cpnd_ext_alloc(ext_alloc_, order, &ext)) << order;
+    return ext;
+  }
+
+  // Frees a block, returns the free block it merged into
+  std::pair<uint64_t, uint32_t> Free(uint64_t ext, uint32_t order) {
+    cpnd_ext_free(ext_alloc_, &ext, &order);
+    return {ext, order};
+  }
+
+  void *ext_alloc_{nullptr};
+};
+
+TEST_F(CpndExtTest, OrderOfSize) {
+  EXPECT_EQ(cpnd_ext_order(0, 64), 0u);
+  EXPECT_EQ(cpnd_ext_order(64, 64), 0u);
+  EXPECT_EQ(cpnd_ext_order(65, 64), 1u);
+  EXPECT_EQ(cpnd_ext_order(128, 64), 1u);
+  EXPECT_EQ(cpnd_ext_order(1000, 125), 3u);
+  EXPECT_EQ(cpnd_ext_order(1 << 20, 64), 14u);
+}
+
+TEST_F(CpndExtTest, SplitsTheLowestBlock) {
+  Create(2, 3);
+
+  EXPECT_EQ(Alloc(0), 0u);
+  EXPECT_EQ(Alloc(1), 2u);
+  EXPECT_EQ(Alloc(0), 1u);
+  EXPECT_EQ(Alloc(2), 4u);
+  // The first chunk is full
+  EXPECT_EQ(Alloc(0), 8u);
+  EXPECT_EQ(cpnd_ext_used(ext_alloc_), 9u);
+}
+
+TEST_F(CpndExtTest, FreeMergesBuddies) {
+  Create(1, 3);
+  uint64_t a = Alloc(0), b = Alloc(0), c = Alloc(1), d = Alloc(2);
+
+  // The buddy of a is in use
+  EXPECT_EQ(Free(a, 0), std::make_pair(a, 0u));
+  EXPECT_EQ(Free(c, 1), std::make_pair(c, 1u));
+  // b merges with a, then with c
+  EXPECT_EQ(Free(b, 0), std::make_pair(uint64_t(0), 2u));
+  EXPECT_EQ(Free(d, 2), std::make_pair(uint64_t(0), 3u));
+  EXPECT_EQ(cpnd_ext_used(ext_alloc_), 0u);
+  EXPECT_EQ(Alloc(3), 0u);
+}
+
+TEST_F(CpndExtTest, FailsWhenFull) {
+  uint64_t ext;
+  Create(2, 2);
+
+  EXPECT_FALSE(cpnd_ext_alloc(ext_alloc_, 3, &ext));
+  Alloc(2);
+  Alloc(1);
+  Alloc(1);
+  EXPECT_FALSE(cpnd_ext_alloc(ext_alloc_, 0, &ext));
+}
+
+TEST_F(CpndExtTest, ReserveSplitsTheFreeBlock) {
+  uint64_t ext;
+  Create(4, 3);
+
+  EXPECT_TRUE(cpnd_ext_reserve(ext_alloc_, 21, 0));
+  EXPECT_TRUE(cpnd_ext_reserve(ext_alloc_, 2, 1));
+  EXPECT_EQ(cpnd_ext_used(ext_alloc_), 3u);
+  // Used, misaligned or outside of the area
+  EXPECT_FALSE(cpnd_ext_reserve(ext_alloc_, 20, 1));
+  EXPECT_FALSE(cpnd_ext_reserve(ext_alloc_, 3, 0));
+  EXPECT_FALSE(cpnd_ext_reserve(ext_alloc_, 5, 1));
+  EXPECT_FALSE(cpnd_ext_reserve(ext_alloc_, 32, 0));
+  EXPECT_FALSE(cpnd_ext_reserve(ext_alloc_, 0, 4));
+
+  // The rest of the first three chunks is free, lowest first
+  EXPECT_EQ(Alloc(1), 0u);
+  EXPECT_EQ(Alloc(2), 4u);
+  EXPECT_EQ(Alloc(3), 8u);
+  EXPECT_EQ(Alloc(0), 20u);
+  EXPECT_EQ(Alloc(1), 22u);
+  EXPECT_EQ(Alloc(2), 16u);
+  EXPECT_EQ(Alloc(3), 24u);
+  EXPECT_FALSE(cpnd_ext_alloc(ext_alloc_, 0, &ext));
+
+  // The reserved blocks merge back when freed
+  EXPECT_EQ(Free(22, 1), std::make_pair(uint64_t(22), 1u));
+  EXPECT_EQ(Free(20, 0), std::make_pair(uint64_t(20), 0u));
+  EXPECT_EQ(Free(21, 0), std::make_pair(uint64_t(20), 2u));
+}
+
+// A section is moved by freeing its block before allocating the new one,
+// with fewer sections than chunks that always succeeds.
+TEST_F(CpndExtTest, ResizeNeverFails) {
+  const uint32_t kChunks = 16, kMaxOrder = 6;
+  std::vector<std::pair<uint64_t, uint32_t>> blocks;
+  Create(kChunks, kMaxOrder);
+  srand(1);
+
+  for (uint32_t i = 0; i < kChunks; i++) blocks.push_back({Alloc(0), 0});
+  for (int i = 0; i < 20000; i++) {
+    auto &block = blocks[rand() % kChunks];
+    uint32_t order = rand() % (kMaxOrder + 1);
+    Free(block.first, block.second);
+    block = {Alloc(order), order};
+    ASSERT_NE(block.first, UINT64_MAX);
+  }
+
+  // The blocks do not overlap and are aligned in the area
+  std::set<uint64_t> used;
+  uint64_t n_used = 0;
+  for (const auto &block : blocks) {
+    EXPECT_EQ(block.first % (uint64_t(1) << block.second), 0u);
+    for (uint64_t e = 0; e < (uint64_t(1) << block.second); e++)
+      EXPECT_TRUE(used.insert(block.first + e).second);
+    n_used += uint64_t(1) << block.second;
+  }
+  EXPECT_LT(*used.rbegin(), uint64_t(kChunks) << kMaxOrder);
+  EXPECT_EQ(cpnd_ext_used(ext_alloc_), n_used);
+}
+
+}  // namespace
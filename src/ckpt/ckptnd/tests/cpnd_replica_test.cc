@@ -0,0 +1,858 @@
+/*      -*- OpenSAF  -*-
+ *
+ * (C) Copyright 2017 The OpenSAF Foundation
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. This file and program are licensed
+ * under the GNU Lesser General Public License Version 2.1, February 1999.
+ * The complete license can be accessed from the following location:
+ * http://opensource.org/licenses/lgpl-license.php
+ * See the Copying file included with the OpenSAF distribution for full
+ * licensing terms.
+ *
+ */
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <string>
+#include <vector>
+#include <map>
+#include <random>
+#include "ckpt/ckptnd/cpnd.h"
+// cpnd and cpa both define CPSV_WAIT_TIME, which is not used here
+#undef CPSV_WAIT_TIME
+extern "C" {
+#include "ckpt/agent/cpa.h"
+}
+#include "gtest/gtest.h"
+
+namespace {
+
+const uint32_t kMaxSections = 8;
+const SaSizeT kMaxSectionSize = 1 << 20;
+const SaCkptCheckpointHandleT kCkptId = 42;
+
+// Replicas in /dev/shm, created and restored the way CPND does
+class CpndReplicaTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    memset(&cb_, 0, sizeof(cb_));
+    cb_.shm_alloc_guaranteed = 2;
+    ckpt_name_ = "safCkpt=cpnd_replica_test_" + std::to_string(getpid()) + "x";
+    char buf[CPSV_MAX_REPLICA_NAME_LENGTH];
+    cpsv_replica_name(buf, ckpt_name_.c_str(), 0, kCkptId);
+    replica_name_ = buf;
+  }
+
+  void TearDown() override {
+    for (CPND_CKPT_NODE *node : nodes_) Close(node);
+    shm_unlink(("/opensaf_" + replica_name_).c_str());
+  }
+
+  CPND_CKPT_NODE *NewNode() {
+    CPND_CKPT_NODE *node =
+        static_cast<CPND_CKPT_NODE *>(calloc(1, sizeof(*node)));
+    node->ckpt_name = ckpt_name_.c_str();
+    node->ckpt_id = kCkptId;
+    node->create_attrib.maxSections = max_sections_;
+    node->create_attrib.maxSectionSize = max_section_size_;
+    node->create_attrib.maxSectionIdSize = 16;
+    node->offset = -1;
+    cpnd_ckpt_sec_map_init(&node->replica_info);
+    nodes_.push_back(node);
+    return node;
+  }
+
+  CPND_CKPT_NODE *Create() {
+    CPND_CKPT_NODE *node = NewNode();
+    EXPECT_EQ(cpnd_ckpt_replica_create(&cb_, node), NCSCC_RC_SUCCESS);
+    return node;
+  }
+
+  // Restores the replica as CPND does after a restart
+  CPND_CKPT_NODE *Restore() {
+    CPND_CKPT_NODE *node = NewNode();
+    NCS_OS_POSIX_SHM_REQ_INFO open_req;
+    CKPT_INFO cp_info;
+    memset(&open_req, 0, sizeof(open_req));
+    memset(&cp_info, 0, sizeof(cp_info));
+    cp_info.maxSections = max_sections_;
+    cp_info.maxSecSize = max_section_size_;
+    char *buf = static_cast<char *>(malloc(CPSV_MAX_REPLICA_NAME_LENGTH));
+    strcpy(buf, replica_name_.c_str());
+    EXPECT_EQ(cpnd_ckpt_replica_create_res(&cb_, &open_req, buf, &node, 1,
+                                           &cp_info),
+              NCSCC_RC_SUCCESS);
+    return node;
+  }
+
+  // Drops the node like a CPND crash, the replica is kept
+  void Close(CPND_CKPT_NODE *node) {
+    NCS_OS_POSIX_SHM_REQ_OPEN_INFO *open = &node->replica_info.open.info.open;
+    cpnd_ckpt_delete_all_sect(node);
+    cpnd_ckpt_sec_map_destroy(&node->replica_info);
+    cpnd_ckpt_slot_map_free(&node->replica_info);
+    if (open->o_addr != nullptr) {
+      munmap(open->o_addr, open->i_size);
+      close(open->o_fd);
+      free(open->i_name);
+    }
+    free(node);
+  }
+
+  void Crash(CPND_CKPT_NODE *node) {
+    nodes_.erase(std::find(nodes_.begin(), nodes_.end(), node));
+    Close(node);
+  }
+
+  static SaCkptSectionIdT Id(const char *id) {
+    return {static_cast<SaUint16T>(strlen(id)),
+            reinterpret_cast<SaUint8T *>(const_cast<char *>(id))};
+  }
+
+  CPND_CKPT_SECTION_INFO *Add(CPND_CKPT_NODE *node, const char *id) {
+    SaCkptSectionIdT sec_id = Id(id);
+    CPND_CKPT_SECTION_INFO *sec = cpnd_ckpt_sec_add(&cb_, node, &sec_id, 0, 0);
+    EXPECT_NE(sec, nullptr) << id;
+    return sec;
+  }
+
+  void Delete(CPND_CKPT_NODE *node, const char *id) {
+    SaCkptSectionIdT sec_id = Id(id);
+    CPND_CKPT_SECTION_INFO *sec = cpnd_ckpt_sec_del(&cb_, node, &sec_id, true);
+    ASSERT_NE(sec, nullptr) << id;
+    cpnd_ckpt_put_lck_sec_id(&cb_, node, sec->lcl_sec_id);
+    m_CPND_FREE_CKPT_SECTION(sec);
+  }
+
+  uint32_t Write(CPND_CKPT_NODE *node, CPND_CKPT_SECTION_INFO *sec,
+                 const std::string &data, uint64_t offset, uint32_t type) {
+    return cpnd_ckpt_sec_write(&cb_, node, sec, data.data(), data.size(),
+                               offset, type);
+  }
+
+  std::string Read(CPND_CKPT_NODE *node, CPND_CKPT_SECTION_INFO *sec) {
+    std::string data(sec->sec_size, '\0');
+    EXPECT_EQ(cpnd_ckpt_sec_read(node, sec, &data[0], data.size(), 0),
+              NCSCC_RC_SUCCESS);
+    return data;
+  }
+
+  CPND_CKPT_SECTION_INFO *Get(CPND_CKPT_NODE *node, const char *id) {
+    SaCkptSectionIdT sec_id = Id(id);
+    return cpnd_ckpt_sec_get(node, &sec_id);
+  }
+
+  // Bytes of shared memory the replica holds
+  static uint64_t Allocated(CPND_CKPT_NODE *node) {
+    struct stat st;
+    EXPECT_EQ(fstat(node->replica_info.open.info.open.o_fd, &st), 0);
+    return uint64_t(st.st_blocks) * 512;
+  }
+
+  static std::string Pattern(char c, size_t size) {
+    std::string data(size, c);
+    for (size_t i = 0; i < size; i += 4096) data[i] = char(i / 4096);
+    return data;
+  }
+
+  CPND_CB cb_;
+  uint32_t max_sections_{kMaxSections};
+  SaSizeT max_section_size_{kMaxSectionSize};
+  std::string ckpt_name_;
+  std::string replica_name_;
+  std::vector<CPND_CKPT_NODE *> nodes_;
+};
+
+TEST_F(CpndReplicaTest, WriteMovesTheSectionToABlockOfItsSize) {
+  CPND_CKPT_NODE *node = Create();
+  CPND_CKPT_SECTION_INFO *a = Add(node, "a");
+  CPND_CKPT_SECTION_INFO *b = Add(node, "b");
+  CPSV_SECT_SLOT *dir = node->replica_info.sect_dir;
+
+  EXPECT_EQ(dir[a->lcl_sec_id].order, 0u);
+  ASSERT_EQ(Write(node, b, "bbbb", 0, CPSV_CKPT_ACCESS_WRITE),
+            NCSCC_RC_SUCCESS);
+
+  // Writes at an offset grow the section and keep the data before it
+  std::string head = Pattern('x', 100);
+  std::string tail = Pattern('y', 300000);
+  ASSERT_EQ(Write(node, a, head, 0, CPSV_CKPT_ACCESS_WRITE), NCSCC_RC_SUCCESS);
+  ASSERT_EQ(Write(node, a, tail, 50, CPSV_CKPT_ACCESS_WRITE),
+            NCSCC_RC_SUCCESS);
+  EXPECT_EQ(a->sec_size, 300050u);
+  EXPECT_EQ(Read(node, a), head.substr(0, 50) + tail);
+  EXPECT_GE(node->replica_info.ext_size << dir[a->lcl_sec_id].order,
+            300050u);
+  EXPECT_EQ(dir[a->lcl_sec_id].order,
+            cpnd_ext_order(300050, node->replica_info.ext_size));
+
+  // An overwrite shrinks it
+  ASSERT_EQ(Write(node, a, "small", 0, CPSV_CKPT_ACCESS_OVWRITE),
+            NCSCC_RC_SUCCESS);
+  EXPECT_EQ(dir[a->lcl_sec_id].order, 0u);
+  EXPECT_EQ(Read(node, a), "small");
+  EXPECT_EQ(Read(node, b), "bbbb");
+  EXPECT_EQ(node->replica_info.mem_used, 9u);
+
+  // Writes past maxSectionSize fail whatever the offset
+  EXPECT_EQ(Write(node, a, "z", kMaxSectionSize, CPSV_CKPT_ACCESS_WRITE),
+            NCSCC_RC_FAILURE);
+  EXPECT_EQ(Write(node, a, "z", UINT64_MAX, CPSV_CKPT_ACCESS_OVWRITE),
+            NCSCC_RC_FAILURE);
+  EXPECT_EQ(Read(node, a), "small");
+}
+
+TEST_F(CpndReplicaTest, AllSectionsCanHaveTheMaximumSize) {
+  CPND_CKPT_NODE *node = Create();
+  std::vector<CPND_CKPT_SECTION_INFO *> secs;
+  std::string big = Pattern('m', kMaxSectionSize);
+
+  for (uint32_t i = 0; i < kMaxSections; i++) {
+    std::string id = "s" + std::to_string(i);
+    secs.push_back(Add(node, id.c_str()));
+    ASSERT_EQ(Write(node, secs[i], id, 0, CPSV_CKPT_ACCESS_WRITE),
+              NCSCC_RC_SUCCESS);
+  }
+  SaCkptSectionIdT id = Id("one too many");
+  EXPECT_EQ(cpnd_ckpt_sec_add(&cb_, node, &id, 0, 0), nullptr);
+
+  for (uint32_t i = 0; i < kMaxSections; i++) {
+    big[1] = char('0' + i);
+    ASSERT_EQ(Write(node, secs[i], big, 0, CPSV_CKPT_ACCESS_OVWRITE),
+              NCSCC_RC_SUCCESS);
+  }
+  for (uint32_t i = 0; i < kMaxSections; i++) {
+    big[1] = char('0' + i);
+    EXPECT_TRUE(Read(node, secs[i]) == big) << i;
+  }
+}
+
+TEST_F(CpndReplicaTest, MemoryFollowsTheLiveData) {
+  CPND_CKPT_NODE *node = Create();
+  uint64_t empty = Allocated(node);
+  CPND_CKPT_SECTION_INFO *a = Add(node, "a");
+  CPND_CKPT_SECTION_INFO *b = Add(node, "b");
+
+  ASSERT_EQ(Write(node, a, Pattern('a', kMaxSectionSize), 0,
+                  CPSV_CKPT_ACCESS_WRITE),
+            NCSCC_RC_SUCCESS);
+  ASSERT_EQ(Write(node, b, Pattern('b', 4096), 0, CPSV_CKPT_ACCESS_WRITE),
+            NCSCC_RC_SUCCESS);
+  EXPECT_GE(Allocated(node), empty + kMaxSectionSize);
+
+  // The pages the section left are given back
+  ASSERT_EQ(Write(node, a, "a", 0, CPSV_CKPT_ACCESS_OVWRITE),
+            NCSCC_RC_SUCCESS);
+  EXPECT_LT(Allocated(node), empty + 4 * 4096 + 2 * 4096);
+
+  Delete(node, "b");
+  Delete(node, "a");
+  EXPECT_LE(Allocated(node), empty + 4096);
+  EXPECT_EQ(cpnd_ext_used(node->replica_info.ext_alloc), 0u);
+}
+
+TEST_F(CpndReplicaTest, SectionsAreRestoredAfterARestart) {
+  CPND_CKPT_NODE *node = Create();
+  std::string big = Pattern('b', 200000);
+  CPND_CKPT_SECTION_INFO *a = Add(node, "a");
+  CPND_CKPT_SECTION_INFO *b = Add(node, "b");
+  Add(node, "c");
+  ASSERT_EQ(Write(node, a, "aaaa", 0, CPSV_CKPT_ACCESS_WRITE),
+            NCSCC_RC_SUCCESS);
+  ASSERT_EQ(Write(node, b, big, 0, CPSV_CKPT_ACCESS_WRITE), NCSCC_RC_SUCCESS);
+  Delete(node, "c");
+  uint32_t b_slot = b->lcl_sec_id;
+  CPSV_SECT_SLOT b_block = node->replica_info.sect_dir[b_slot];
+  Crash(node);
+
+  node = Restore();
+  EXPECT_EQ(node->replica_info.n_secs, 2u);
+  EXPECT_EQ(node->replica_info.mem_used, 200004u);
+  EXPECT_EQ(Get(node, "c"), nullptr);
+  a = Get(node, "a");
+  b = Get(node, "b");
+  ASSERT_NE(a, nullptr);
+  ASSERT_NE(b, nullptr);
+  EXPECT_EQ(Read(node, a), "aaaa");
+  EXPECT_TRUE(Read(node, b) == big);
+  EXPECT_EQ(b->lcl_sec_id, b_slot);
+  EXPECT_EQ(node->replica_info.sect_dir[b_slot].ext, b_block.ext);
+  EXPECT_EQ(node->replica_info.sect_dir[b_slot].order, b_block.order);
+
+  // New sections get the free slots and blocks
+  CPND_CKPT_SECTION_INFO *d = Add(node, "d");
+  ASSERT_EQ(Write(node, d, Pattern('d', kMaxSectionSize), 0,
+                  CPSV_CKPT_ACCESS_WRITE),
+            NCSCC_RC_SUCCESS);
+  EXPECT_EQ(Read(node, a), "aaaa");
+  EXPECT_TRUE(Read(node, b) == big);
+}
+
+TEST_F(CpndReplicaTest, LegacyReplicaIsConverted) {
+  const uint64_t kSlotSize = sizeof(CPSV_SECT_HDR) + kMaxSectionSize;
+  std::string data[kMaxSections];
+  data[0] = Pattern('0', 5000);
+  data[1] = "one";
+  data[2] = "stale";
+
+  // The fixed size layout, the sections in the first n_secs slots
+  int fd = shm_open(("/opensaf_" + replica_name_).c_str(),
+                    O_RDWR | O_CREAT | O_EXCL, 0666);
+  ASSERT_GE(fd, 0);
+  ASSERT_EQ(ftruncate(fd, sizeof(CPSV_CKPT_HDR) + kMaxSections * kSlotSize),
+            0);
+
+  CPSV_CKPT_HDR ckpt_hdr;
+  memset(&ckpt_hdr, 0, sizeof(ckpt_hdr));
+  ckpt_hdr.ckpt_id = kCkptId;
+  ckpt_hdr.create_attrib.maxSections = kMaxSections;
+  ckpt_hdr.create_attrib.maxSectionSize = kMaxSectionSize;
+  ckpt_hdr.create_attrib.maxSectionIdSize = 16;
+  ckpt_hdr.n_secs = 2;
+  ASSERT_EQ(pwrite(fd, &ckpt_hdr, sizeof(ckpt_hdr), 0), sizeof(ckpt_hdr));
+  // Slot 2 is left by the section deleted last
+  for (uint32_t i : {0, 1, 2}) {
+    CPSV_SECT_HDR sect_hdr;
+    memset(&sect_hdr, 0, sizeof(sect_hdr));
+    sect_hdr.lcl_sec_id = i;
+    sect_hdr.idLen = 1;
+    sect_hdr.id[0] = '0' + i;
+    sect_hdr.sec_state = SA_CKPT_SECTION_VALID;
+    sect_hdr.sec_size = data[i].size();
+    uint64_t offset = sizeof(CPSV_CKPT_HDR) + i * kSlotSize;
+    ASSERT_EQ(pwrite(fd, &sect_hdr, sizeof(sect_hdr), offset),
+              sizeof(sect_hdr));
+    ASSERT_EQ(pwrite(fd, data[i].data(), data[i].size(),
+                     offset + sizeof(sect_hdr)),
+              ssize_t(data[i].size()));
+  }
+  close(fd);
+
+  CPND_CKPT_NODE *node = Restore();
+  const CPSV_SECT_DIR_HDR *dir_hdr = reinterpret_cast<CPSV_SECT_DIR_HDR *>(
+      static_cast<char *>(node->replica_info.open.info.open.o_addr) +
+      m_CPSV_SECT_DIR_OFFSET);
+  EXPECT_EQ(dir_hdr->magic, uint32_t(CPSV_SECT_DIR_MAGIC));
+  EXPECT_EQ(dir_hdr->ready, 1u);
+  EXPECT_EQ(node->create_attrib.maxSectionSize, kMaxSectionSize);
+  EXPECT_EQ(node->replica_info.n_secs, 2u);
+  EXPECT_EQ(Get(node, "2"), nullptr);
+  ASSERT_NE(Get(node, "0"), nullptr);
+  ASSERT_NE(Get(node, "1"), nullptr);
+  EXPECT_TRUE(Read(node, Get(node, "0")) == data[0]);
+  EXPECT_EQ(Read(node, Get(node, "1")), data[1]);
+  EXPECT_EQ(Get(node, "1")->lcl_sec_id, 1u);
+
+  // The converted segment is restored as such on the next restart
+  Crash(node);
+  node = Restore();
+  EXPECT_EQ(node->replica_info.n_secs, 2u);
+  EXPECT_EQ(Read(node, Get(node, "1")), data[1]);
+  CPND_CKPT_SECTION_INFO *s = Add(node, "new");
+  EXPECT_EQ(s->lcl_sec_id, 2u);
+  ASSERT_EQ(Write(node, s, "new", 0, CPSV_CKPT_ACCESS_WRITE),
+            NCSCC_RC_SUCCESS);
+  EXPECT_TRUE(Read(node, Get(node, "0")) == data[0]);
+}
+
+// A collocated CPA reads sections from the replica itself, it must read
+// what CPND would send it
+class CpaReplicaReadTest : public CpndReplicaTest {
+ protected:
+  void SetUp() override {
+    CpndReplicaTest::SetUp();
+    memset(&cpa_cb_, 0, sizeof(cpa_cb_));
+    memset(&gc_node_, 0, sizeof(gc_node_));
+    gc_node_.gbl_ckpt_hdl = kCkptId;
+    gc_node_.is_active_exists = true;
+  }
+
+  void TearDown() override {
+    cpa_proc_replica_unmap(&gc_node_);
+    CpndReplicaTest::TearDown();
+  }
+
+  // Whether CPA read the section itself, into data
+  bool DirectRead(const std::string &id, SaOffsetT offset, SaSizeT size,
+                  std::string *data) {
+    SaCkptIOVectorElementT io;
+    SaVersionT version = {'B', 2, 2};
+    std::string buf(size, '\0');
+    memset(&io, 0, sizeof(io));
+    io.sectionId = Id(id.c_str());
+    io.dataOffset = offset;
+    if (size != 0) {
+      io.dataBuffer = &buf[0];
+      io.dataSize = size;
+    }
+    if (cpa_proc_replica_read(&cpa_cb_, &gc_node_, ckpt_name_.c_str(), &io, 1,
+                              &version) != NCSCC_RC_SUCCESS)
+      return false;
+    if (size != 0) {
+      *data = buf.substr(0, io.readSize);
+    } else if (io.dataBuffer != nullptr) {
+      data->assign(static_cast<char *>(io.dataBuffer), io.readSize);
+      free(io.dataBuffer);
+    } else {
+      data->clear();
+    }
+    return true;
+  }
+
+  // Whether CPND read the section for CPA, into data
+  bool CpndRead(CPND_CKPT_NODE *node, const std::string &id,
+                SaOffsetT offset, SaSizeT size, std::string *data) {
+    CPSV_CKPT_DATA ckpt_data;
+    CPSV_CKPT_ACCESS access;
+    CPSV_EVT evt;
+    memset(&ckpt_data, 0, sizeof(ckpt_data));
+    memset(&access, 0, sizeof(access));
+    memset(&evt, 0, sizeof(evt));
+    ckpt_data.sec_id = Id(id.c_str());
+    ckpt_data.dataOffset = offset;
+    ckpt_data.dataSize = size;
+    access.type = CPSV_CKPT_ACCESS_READ;
+    access.num_of_elmts = 1;
+    access.data = &ckpt_data;
+
+    uint32_t rc = cpnd_ckpt_read_replica(&cb_, node, &access, &evt);
+    CPSV_ND2A_READ_DATA *read_data =
+        evt.info.cpa.info.sec_data_rsp.info.read_data;
+    bool found = rc == NCSCC_RC_SUCCESS && read_data[0].err == 0;
+    if (found && read_data[0].data != nullptr)
+      data->assign(static_cast<char *>(read_data[0].data),
+                   read_data[0].read_size);
+    else
+      data->clear();
+    free(read_data[0].data);
+    free(read_data);
+    return found;
+  }
+
+  // Reads all ids both ways, and checks the data against the model
+  void Check(CPND_CKPT_NODE *node, const std::vector<std::string> &ids,
+             const std::map<std::string, std::string> &model) {
+    gc_node_.ckpt_creat_attri = node->create_attrib;
+    for (const std::string &id : ids) {
+      auto it = model.find(id);
+      SaOffsetT offset = 0;
+      SaSizeT size = 0;
+      for (int i = 0; i < 2; i++) {
+        std::string direct, cpnd;
+        bool read = DirectRead(id, offset, size, &direct);
+        ASSERT_EQ(CpndRead(node, id, offset, size, &cpnd), read) << id;
+        ASSERT_EQ(read, it != model.end()) << id;
+        if (!read) break;
+        ASSERT_TRUE(direct == cpnd) << id;
+        std::string expected = it->second.substr(offset);
+        if (size != 0) expected.resize(std::min(expected.size(), size_t(size)));
+        ASSERT_TRUE(direct == expected) << id;
+        // Then a part of the section into a buffer
+        offset = it->second.size() / 3;
+        size = it->second.size() / 2 + 1;
+      }
+    }
+  }
+
+  CPA_CB cpa_cb_;
+  CPA_GLOBAL_CKPT_NODE gc_node_;
+};
+
+TEST_F(CpaReplicaReadTest, DirectReadMatchesCpnd) {
+  std::mt19937 rnd(1);
+  std::vector<std::string> ids;
+  std::map<std::string, std::string> model;
+  max_sections_ = 64;
+  for (uint32_t i = 0; i < 2 * max_sections_; i++)
+    ids.push_back("section" + std::to_string(i));
+  ids.push_back("");
+  CPND_CKPT_NODE *node = Create();
+
+  for (int step = 0; step < 3000; step++) {
+    const std::string &id = ids[rnd() % ids.size()];
+    auto it = model.find(id);
+    size_t size = rnd() % 10 ? rnd() % 5000 : rnd() % 300000;
+    std::string data = Pattern('a' + step % 26, size);
+
+    if (it == model.end()) {
+      if (model.size() == max_sections_) continue;
+      CPND_CKPT_SECTION_INFO *sec = Add(node, id.c_str());
+      ASSERT_EQ(Write(node, sec, data, 0, CPSV_CKPT_ACCESS_WRITE),
+                NCSCC_RC_SUCCESS);
+      model[id] = data;
+    } else if (rnd() % 4 == 0) {
+      Delete(node, id.c_str());
+      model.erase(it);
+    } else if (rnd() % 2) {
+      ASSERT_EQ(Write(node, Get(node, id.c_str()), data, 0,
+                      CPSV_CKPT_ACCESS_OVWRITE),
+                NCSCC_RC_SUCCESS);
+      it->second = data;
+    } else {
+      size_t offset = rnd() % (it->second.size() + 1);
+      data.resize(std::min<size_t>(size, kMaxSectionSize - offset));
+      ASSERT_EQ(Write(node, Get(node, id.c_str()), data, offset,
+                      CPSV_CKPT_ACCESS_WRITE),
+                NCSCC_RC_SUCCESS);
+      it->second.replace(offset, data.size(), data);
+    }
+    if (step % 100 == 0) Check(node, ids, model);
+  }
+  Check(node, ids, model);
+
+  // The index is rebuilt when CPND restarts
+  cpa_proc_replica_unmap(&gc_node_);
+  Crash(node);
+  node = Restore();
+  Check(node, ids, model);
+}
+
+TEST_F(CpaReplicaReadTest, NoDirectReadWhileCpndChangesTheDirectory) {
+  CPND_CKPT_NODE *node = Create();
+  std::string data;
+  ASSERT_EQ(Write(node, Add(node, "a"), "data", 0, CPSV_CKPT_ACCESS_WRITE),
+            NCSCC_RC_SUCCESS);
+  gc_node_.ckpt_creat_attri = node->create_attrib;
+  EXPECT_TRUE(DirectRead("a", 0, 0, &data));
+  EXPECT_EQ(data, "data");
+
+  CPSV_SECT_DIR_HDR *dir_hdr = reinterpret_cast<CPSV_SECT_DIR_HDR *>(
+      static_cast<char *>(node->replica_info.open.info.open.o_addr) +
+      m_CPSV_SECT_DIR_OFFSET);
+  dir_hdr->ready = 0;
+  EXPECT_FALSE(DirectRead("a", 0, 0, &data));
+  dir_hdr->ready = 1;
+  dir_hdr->idx_seq++;
+  EXPECT_FALSE(DirectRead("a", 0, 0, &data));
+  dir_hdr->idx_seq++;
+  EXPECT_FALSE(DirectRead("b", 0, 0, &data));
+  EXPECT_TRUE(DirectRead("a", 1, 2, &data));
+  EXPECT_EQ(data, "at");
+}
+
+// Writes to an active replica recorded for the other replicas, see
+// cpnd_repl.c. There are no other replicas, so a flush sends nothing.
+class CpndReplTest : public CpndReplicaTest {
+ protected:
+  static void SetUpTestCase() { ncs_leap_startup(); }
+
+  void SetUp() override {
+    CpndReplicaTest::SetUp();
+    // The window never expires in the test, the writes are flushed by it
+    cb_.repl_coalesce_ms = 3600 * 1000;
+  }
+
+  void TearDown() override {
+    for (CPND_CKPT_NODE *node : nodes_) cpnd_repl_discard(node);
+    CpndReplicaTest::TearDown();
+  }
+
+  // Writes a section of the active replica and records the write
+  uint32_t Replicate(CPND_CKPT_NODE *node, const char *id,
+                     const std::string &data, SaOffsetT offset,
+                     uint32_t type) {
+    EXPECT_EQ(Write(node, Get(node, id), data, offset, type),
+              NCSCC_RC_SUCCESS);
+    CPSV_CKPT_DATA ckpt_data;
+    CPSV_CKPT_ACCESS access;
+    memset(&ckpt_data, 0, sizeof(ckpt_data));
+    memset(&access, 0, sizeof(access));
+    ckpt_data.sec_id = Id(id);
+    ckpt_data.dataOffset = offset;
+    ckpt_data.dataSize = data.size();
+    access.type = type;
+    access.num_of_elmts = 1;
+    access.data = &ckpt_data;
+    return cpnd_repl_coalesce(&cb_, node, &access);
+  }
+
+  struct Element {
+    std::string id;
+    SaOffsetT offset;
+    std::string data;
+    bool operator==(const Element &e) const {
+      return id == e.id && offset == e.offset && data == e.data;
+    }
+  };
+
+  // The elements of the next flush message of the type
+  static std::vector<Element> Flushed(CPND_CKPT_NODE *node, bool ovwrite) {
+    CPSV_CKPT_DATA *head;
+    SaSizeT bytes = 0;
+    uint32_t n = cpnd_repl_build(node, ovwrite, &head, &bytes);
+    std::vector<Element> elements;
+    for (CPSV_CKPT_DATA *d = head; d != nullptr; d = d->next) {
+      elements.push_back(
+          {std::string(reinterpret_cast<char *>(d->sec_id.id),
+                       d->sec_id.idLen),
+           d->dataOffset,
+           std::string(static_cast<char *>(d->data), d->dataSize)});
+      bytes -= d->dataSize;
+    }
+    EXPECT_EQ(n, elements.size());
+    EXPECT_EQ(bytes, 0u);
+    cpnd_repl_data_free(head);
+    return elements;
+  }
+};
+
+TEST_F(CpndReplTest, WritesToASectionAreCoalescedInWriteOrder) {
+  CPND_CKPT_NODE *node = Create();
+  Add(node, "a");
+  Add(node, "b");
+  Add(node, "c");
+  ASSERT_EQ(Replicate(node, "b", "bbbb", 10, CPSV_CKPT_ACCESS_WRITE),
+            NCSCC_RC_SUCCESS);
+  ASSERT_EQ(Replicate(node, "a", "aaa", 0, CPSV_CKPT_ACCESS_WRITE),
+            NCSCC_RC_SUCCESS);
+  ASSERT_EQ(Replicate(node, "c", "cc", 0, CPSV_CKPT_ACCESS_OVWRITE),
+            NCSCC_RC_SUCCESS);
+  ASSERT_EQ(Replicate(node, "b", "xx", 2, CPSV_CKPT_ACCESS_WRITE),
+            NCSCC_RC_SUCCESS);
+  ASSERT_EQ(Replicate(node, "a", "y", 5, CPSV_CKPT_ACCESS_WRITE),
+            NCSCC_RC_SUCCESS);
+
+  EXPECT_EQ(node->n_repl_pending, 3u);
+  EXPECT_EQ(node->repl_stats.writes, 5u);
+  EXPECT_EQ(node->repl_stats.coalesced, 2u);
+  EXPECT_EQ(node->repl_pending_bytes, 12u);
+  EXPECT_TRUE(node->repl_flush_tmr.is_active);
+
+  // One range per section, with the data of the replica at the flush
+  std::string b = Read(node, Get(node, "b"));
+  std::string a = Read(node, Get(node, "a"));
+  EXPECT_EQ(Flushed(node, false),
+            std::vector<Element>({{"b", 2, b.substr(2)}, {"a", 0, a}}));
+  EXPECT_EQ(Flushed(node, true), std::vector<Element>({{"c", 0, "cc"}}));
+
+  cpnd_repl_flush(&cb_, node);
+  EXPECT_EQ(node->repl_pending, nullptr);
+  EXPECT_EQ(node->n_repl_pending, 0u);
+  EXPECT_EQ(node->repl_pending_bytes, 0u);
+  EXPECT_FALSE(node->repl_flush_tmr.is_active);
+  EXPECT_GT(node->repl_stats.last_lag, 0);
+  EXPECT_GE(node->repl_stats.max_lag, node->repl_stats.last_lag);
+  EXPECT_TRUE(Flushed(node, false).empty());
+}
+
+TEST_F(CpndReplTest, OverwriteSendsTheWholeSection) {
+  CPND_CKPT_NODE *node = Create();
+  Add(node, "a");
+  ASSERT_EQ(Replicate(node, "a", "aaaa", 0, CPSV_CKPT_ACCESS_WRITE),
+            NCSCC_RC_SUCCESS);
+  ASSERT_EQ(Replicate(node, "a", "bb", 0, CPSV_CKPT_ACCESS_OVWRITE),
+            NCSCC_RC_SUCCESS);
+  // A write after the overwrite is in the overwritten section
+  ASSERT_EQ(Replicate(node, "a", "c", 3, CPSV_CKPT_ACCESS_WRITE),
+            NCSCC_RC_SUCCESS);
+
+  EXPECT_EQ(node->n_repl_pending, 1u);
+  EXPECT_TRUE(Flushed(node, false).empty());
+  EXPECT_EQ(Flushed(node, true),
+            std::vector<Element>({{"a", 0, Read(node, Get(node, "a"))}}));
+}
+
+TEST_F(CpndReplTest, DeletedAndShrunkSectionsAreSkipped) {
+  CPND_CKPT_NODE *node = Create();
+  Add(node, "a");
+  Add(node, "b");
+  ASSERT_EQ(Replicate(node, "a", "aaaa", 0, CPSV_CKPT_ACCESS_WRITE),
+            NCSCC_RC_SUCCESS);
+  ASSERT_EQ(Replicate(node, "b", "bbbb", 0, CPSV_CKPT_ACCESS_WRITE),
+            NCSCC_RC_SUCCESS);
+  ASSERT_EQ(Replicate(node, "b", "b", 8, CPSV_CKPT_ACCESS_WRITE),
+            NCSCC_RC_SUCCESS);
+  Delete(node, "a");
+  // b is overwritten by another path, shorter than its pending range
+  ASSERT_EQ(Write(node, Get(node, "b"), "xy", 0, CPSV_CKPT_ACCESS_OVWRITE),
+            NCSCC_RC_SUCCESS);
+
+  EXPECT_EQ(Flushed(node, false), std::vector<Element>({{"b", 0, "xy"}}));
+}
+
+TEST_F(CpndReplTest, OtherAccessFlushesThePendingWrites) {
+  CPND_CKPT_NODE *node = Create();
+  Add(node, "a");
+  ASSERT_EQ(Replicate(node, "a", "aaaa", 0, CPSV_CKPT_ACCESS_WRITE),
+            NCSCC_RC_SUCCESS);
+
+  // A sync must not overtake the pending write, and is sent as is
+  CPSV_CKPT_ACCESS access;
+  memset(&access, 0, sizeof(access));
+  access.type = CPSV_CKPT_ACCESS_SYNC;
+  EXPECT_EQ(cpnd_repl_coalesce(&cb_, node, &access), NCSCC_RC_FAILURE);
+  EXPECT_EQ(node->n_repl_pending, 0u);
+  EXPECT_FALSE(node->repl_flush_tmr.is_active);
+}
+
+TEST_F(CpndReplTest, PendingBytesLimitFlushes) {
+  CPND_CKPT_NODE *node = Create();
+  Add(node, "a");
+  std::string data = Pattern('a', 256 * 1024);
+  for (int i = 0; i < 3; i++) {
+    ASSERT_EQ(Replicate(node, "a", data, 0, CPSV_CKPT_ACCESS_WRITE),
+              NCSCC_RC_SUCCESS);
+    EXPECT_EQ(node->n_repl_pending, 1u);
+  }
+  // The fourth write reaches 1 MB
+  ASSERT_EQ(Replicate(node, "a", data, 0, CPSV_CKPT_ACCESS_WRITE),
+            NCSCC_RC_SUCCESS);
+  EXPECT_EQ(node->n_repl_pending, 0u);
+  EXPECT_EQ(node->repl_pending_bytes, 0u);
+  EXPECT_EQ(node->repl_stats.coalesced, 3u);
+}
+
+TEST_F(CpndReplTest, StateFileHasTheReplicationStats) {
+  CPND_CKPT_NODE *node = Create();
+  Add(node, "a");
+  ASSERT_EQ(Replicate(node, "a", "aaaa", 0, CPSV_CKPT_ACCESS_WRITE),
+            NCSCC_RC_SUCCESS);
+  ASSERT_EQ(Replicate(node, "a", "bb", 6, CPSV_CKPT_ACCESS_WRITE),
+            NCSCC_RC_SUCCESS);
+  ASSERT_EQ(cpnd_ckpt_node_tree_init(&cb_), NCSCC_RC_SUCCESS);
+  ASSERT_EQ(cpnd_ckpt_node_add(&cb_, node), NCSCC_RC_SUCCESS);
+
+  std::string path = "/tmp/cpnd_repl_test." + std::to_string(getpid());
+  int rc = cpnd_file_dump(&cb_, path.c_str());
+  cpnd_ckpt_node_del(&cb_, node);
+  ncs_patricia_tree_destroy(&cb_.ckpt_info_db);
+  ASSERT_EQ(rc, 0);
+
+  std::string state;
+  FILE *f = fopen(path.c_str(), "r");
+  ASSERT_NE(f, nullptr);
+  char buf[256];
+  while (fgets(buf, sizeof(buf), f) != nullptr) state += buf;
+  fclose(f);
+  unlink(path.c_str());
+
+  EXPECT_NE(state.find("  name: " + ckpt_name_ + "\n"), std::string::npos);
+  EXPECT_NE(state.find("    repl_writes: 2\n"), std::string::npos);
+  EXPECT_NE(state.find("    repl_coalesced: 1\n"), std::string::npos);
+  EXPECT_NE(state.find("    repl_pending_sections: 1\n"), std::string::npos);
+  EXPECT_NE(state.find("    repl_pending_bytes: 6\n"), std::string::npos);
+  EXPECT_NE(state.find("    repl_max_lag_us: "), std::string::npos);
+}
+
+// Memory and latency of replicas with many small sections, in the
+// extent layout and in the fixed size layout of earlier releases. Run with
+//
+//   bin/testckptnd --gtest_also_run_disabled_tests --gtest_filter='*Bench*'
+class CpndReplicaBench : public CpndReplicaTest {
+ protected:
+  static const SaSizeT kBenchSectionSize = 64 * 1024;
+  static const size_t kDataSize = 256;
+
+  static double Now() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+  }
+
+  static double Usec(double start, uint32_t n) {
+    return (Now() - start) * 1e6 / n;
+  }
+
+  void Extents(uint32_t n) {
+    max_sections_ = n;
+    max_section_size_ = kBenchSectionSize;
+    std::vector<std::string> ids;
+    for (uint32_t i = 0; i < n; i++) ids.push_back("s" + std::to_string(i));
+    std::string data = Pattern('e', kDataSize);
+
+    double start = Now();
+    CPND_CKPT_NODE *node = Create();
+    double create = (Now() - start) * 1e3;
+
+    start = Now();
+    for (uint32_t i = 0; i < n; i++) {
+      CPND_CKPT_SECTION_INFO *sec = Add(node, ids[i].c_str());
+      ASSERT_EQ(Write(node, sec, data, 0, CPSV_CKPT_ACCESS_WRITE),
+                NCSCC_RC_SUCCESS);
+    }
+    double add = Usec(start, n);
+    uint64_t full = Allocated(node);
+
+    start = Now();
+    for (uint32_t i = n / 10; i < n; i++) Delete(node, ids[i].c_str());
+    double del = Usec(start, n - n / 10);
+    uint64_t tenth = Allocated(node);
+
+    Crash(node);
+    start = Now();
+    node = Restore();
+    double restore = (Now() - start) * 1e3;
+    ASSERT_EQ(node->replica_info.n_secs, n / 10);
+
+    printf("extents  %6u %10.1f %12.2f %10.2f %10.1f %10.1f %10.1f\n", n,
+           create, add, del, full / 1048576.0, tenth / 1048576.0, restore);
+  }
+
+  // Writes the sections at the fixed offsets of earlier releases, where a
+  // deleted section kept its pages
+  void FixedSize(uint32_t n) {
+    const uint64_t slot_size = sizeof(CPSV_SECT_HDR) + kBenchSectionSize;
+    const uint64_t size = sizeof(CPSV_CKPT_HDR) + n * slot_size;
+    std::string name = "/opensaf_" + replica_name_;
+    std::string data = Pattern('f', kDataSize);
+
+    double start = Now();
+    int fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0666);
+    ASSERT_GE(fd, 0);
+    ASSERT_EQ(ftruncate(fd, size), 0);
+    char *addr = static_cast<char *>(
+        mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0));
+    ASSERT_NE(addr, MAP_FAILED);
+    double create = (Now() - start) * 1e3;
+
+    start = Now();
+    for (uint32_t i = 0; i < n; i++) {
+      CPSV_SECT_HDR sect_hdr;
+      memset(&sect_hdr, 0, sizeof(sect_hdr));
+      sect_hdr.lcl_sec_id = i;
+      sect_hdr.sec_size = kDataSize;
+      char *hdr = addr + sizeof(CPSV_CKPT_HDR) + i * slot_size;
+      memcpy(hdr, &sect_hdr, sizeof(sect_hdr));
+      memcpy(hdr + sizeof(sect_hdr), data.data(), kDataSize);
+    }
+    double add = Usec(start, n);
+
+    struct stat st;
+    ASSERT_EQ(fstat(fd, &st), 0);
+    uint64_t full = uint64_t(st.st_blocks) * 512;
+    printf("fixed    %6u %10.1f %12.2f %10s %10.1f %10.1f %10s\n", n, create,
+           add, "-", full / 1048576.0, full / 1048576.0, "-");
+    munmap(addr, size);
+    close(fd);
+    shm_unlink(name.c_str());
+  }
+
+  static void Header() {
+    printf("%u B in sections of at most %u kB\n", unsigned(kDataSize),
+           unsigned(kBenchSectionSize / 1024));
+    printf("%-8s %6s %10s %12s %10s %10s %10s %10s\n", "layout", "secs",
+           "create ms", "add+wr us", "del us", "all MB", "10% MB",
+           "restore ms");
+  }
+};
+
+TEST_F(CpndReplicaBench, DISABLED_TenThousandSections) {
+  Header();
+  FixedSize(10000);
+  Extents(10000);
+}
+
+TEST_F(CpndReplicaBench, DISABLED_HundredThousandSections) {
+  Header();
+  FixedSize(100000);
+  Extents(100000);
+}
+
+}  // namespace
@@ -29,6 +29,7 @@
 */
 
 #include "ckpt/common/cpsv.h"
+#include "ckpt/common/cpsv_shm.h"
 #include "ckpt/agent/cpa_tmr.h"
 #include "base/osaf_extended_name.h"
 
@@ -3245,3 +3246,103 @@ uint32_t cpsv_nd2d_ckpt_info_update_decode(CPSV_ND2D_CKPT_INFO_UPD *update_info,
 	TRACE_LEAVE();
 	return NCSCC_RC_SUCCESS;
 }
+
+/****************************************************************************
+ * Name          : cpsv_replica_name
+ *
+ * Description   : Builds the name of the replica segment of a checkpoint.
+ *                 Used by CPND to create/open the replica and by a
+ *                 collocated CPA to map it for local reads.
+ *
+ * Arguments     : buf       - CPSV_MAX_REPLICA_NAME_LENGTH bytes
+ *                 ckpt_name - Checkpoint name
+ *                 node_id   - Node of the replica
+ *                 ckpt_id   - Global checkpoint id
+ *
+ * Return Values : None
+ *****************************************************************************/
+void cpsv_replica_name(char *buf, const char *ckpt_name, uint32_t node_id,
+		       SaCkptCheckpointHandleT ckpt_id)
+{
+	memset(buf, '\0', CPSV_MAX_REPLICA_NAME_LENGTH);
+	strncpy(buf, ckpt_name, CPSV_REP_NAME_MAX_CKPT_NAME_LENGTH);
+
+	/* The last character of the checkpoint name is overwritten, kept for
+	   compatibility with replicas created by earlier releases */
+	sprintf(buf + strlen(buf) - 1, "_%u_%llu", node_id, ckpt_id);
+}
+
+/****************************************************************************
+ * Name          : cpsv_sect_geometry
+ *
+ * Description   : Gives the extents of the data area of a replica, see
+ *                 cpsv_shm.h. A block of 2^max_order extents holds
+ *                 maxSectionSize bytes and is at most 1/64 bigger, and an
+ *                 extent is at least CPSV_SECT_MIN_EXT_SIZE bytes.
+ *
+ * Arguments     : max_sec_size - maxSectionSize of the checkpoint
+ *                 ext_size     - Bytes in an extent
+ *                 max_order    - Order of a block of maxSectionSize bytes
+ *
+ * Return Values : None
+ *****************************************************************************/
+void cpsv_sect_geometry(SaSizeT max_sec_size, uint64_t *ext_size,
+			uint32_t *max_order)
+{
+	uint32_t order = 0;
+
+	while (order < 63 &&
+	       (max_sec_size >> (order + 1)) >= CPSV_SECT_MIN_EXT_SIZE)
+		order++;
+
+	*max_order = order;
+	*ext_size = (max_sec_size + (1ULL << order) - 1) >> order;
+	if (*ext_size == 0)
+		*ext_size = 1;
+}
+
+/****************************************************************************
+ * Name          : cpsv_sect_id_hash
+ *
+ * Description   : Hash of a section id in the section index of a replica
+ *                 (FNV-1a), see cpsv_shm.h. CPND and CPA must agree on it.
+ *
+ * Arguments     : id, len - The section id
+ *
+ * Return Values : The hash
+ *****************************************************************************/
+uint32_t cpsv_sect_id_hash(const uint8_t *id, uint32_t len)
+{
+	uint32_t hash = 2166136261U;
+
+	while (len-- > 0) {
+		hash ^= *id++;
+		hash *= 16777619U;
+	}
+	return hash;
+}
+
+/****************************************************************************
+ * Name          : cpsv_replica_size
+ *
+ * Description   : Size of the replica segment of a checkpoint, with room
+ *                 for maxSections blocks of maxSectionSize bytes.
+ *
+ * Arguments     : max_secs     - maxSections of the checkpoint
+ *                 max_sec_size - maxSectionSize of the checkpoint
+ *
+ * Return Values : The size, UINT64_MAX if it does not fit in 64 bits
+ *****************************************************************************/
+uint64_t cpsv_replica_size(uint32_t max_secs, SaSizeT max_sec_size)
+{
+	uint64_t ext_size, block, base = m_CPSV_SECT_DATA_BASE(max_secs);
+	uint32_t max_order;
+
+	cpsv_sect_geometry(max_sec_size, &ext_size, &max_order);
+	if (ext_size > (UINT64_MAX >> max_order))
+		return UINT64_MAX;
+	block = ext_size << max_order;
+	if (max_secs != 0 && block > (UINT64_MAX - base) / max_secs)
+		return UINT64_MAX;
+	return base + block * max_secs;
+}
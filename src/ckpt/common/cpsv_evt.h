@@ -272,7 +272,8 @@ typedef enum cpndq_tmr_type {
   CPND_ALL_REPL_RSP_EXPI,
   CPND_TMR_OPEN_ACTIVE_SYNC,
   CPND_TMR_TYPE_NON_COLLOC_RETENTION,
-  CPND_TMR_TYPE_MAX = CPND_TMR_TYPE_NON_COLLOC_RETENTION,
+  CPND_TMR_TYPE_REPL_FLUSH,
+  CPND_TMR_TYPE_MAX = CPND_TMR_TYPE_REPL_FLUSH,
 } CPND_TMR_TYPE;
 typedef struct cpnd_tmr {
   CPND_TMR_TYPE type;
@@ -20,6 +20,10 @@
 
 #include "base/osaf_extended_name.h"
 
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 #define MAX_CLIENTS 1000
 #define MAX_CKPTS 2000
 #define MAX_SIZE 30
@@ -58,6 +62,99 @@ typedef struct cpsv_sect_hdr {
   SaTimeT lastUpdate;
 } CPSV_SECT_HDR;
 
+/*
+ * Layout of a checkpoint replica segment:
+ *
+ * | CKPT_HDR | SECT_DIR | SECT_IDX | SEC_HDR ... SEC_HDR | pad | DATA |
+ *
+ * The section directory is a CPSV_SECT_DIR_HDR followed by one
+ * CPSV_SECT_SLOT per section. It is followed by the section index and by
+ * one SEC_HDR per section, indexed by lcl_sec_id like the slots. The
+ * section index is a hash table of 2 * maxSections uint32_t entries with
+ * linear probing, from cpsv_sect_id_hash() of a section id to its
+ * lcl_sec_id + 1, 0 when the entry is empty. The data area starts page
+ * aligned and is made of extents of ext_size bytes. The data of a
+ * section is a block of 2^order extents starting at extent ext of its
+ * slot. CPND allocates the blocks with a buddy allocator and moves a
+ * section to a bigger or smaller block when its size changes, so a
+ * section only takes the pages of its data. The data area has room for
+ * maxSections blocks of maxSectionSize bytes, and as the segment is
+ * sparse a checkpoint with generous maxima only takes memory for the
+ * data written to it.
+ *
+ * CPND is the only writer of the segment. A collocated CPA maps it
+ * read-only and reads sections without a round trip to CPND: the seq of
+ * a slot is odd while CPND updates the header, block or data of the
+ * section in the slot, so a reader that sees seq odd or changed during
+ * its copy retries (seqlock). The idx_seq of the directory is odd while
+ * CPND changes the index, a reader that does not find a section retries
+ * if idx_seq is odd or changed during its lookup.
+ */
+#define CPSV_SECT_DIR_MAGIC 0x43505345 /* "CPSE" */
+
+/* Smallest extent, unless maxSectionSize is smaller */
+#define CPSV_SECT_MIN_EXT_SIZE 64
+#define CPSV_SECT_DATA_ALIGN 4096
+
+typedef struct cpsv_sect_dir_hdr {
+  uint32_t magic; /* CPSV_SECT_DIR_MAGIC, the segment has this layout */
+  uint32_t n_slots;
+  uint64_t ext_size;  /* Bytes in an extent */
+  uint32_t max_order; /* maxSectionSize fits in 2^max_order extents */
+  uint32_t ready;     /* Set while CPND maintains the slots */
+  uint32_t idx_seq;   /* Odd while the section index is being updated */
+  uint32_t idx_size;  /* Entries in the section index */
+} CPSV_SECT_DIR_HDR;
+
+typedef struct cpsv_sect_slot {
+  uint32_t seq;    /* Odd while the section is being updated */
+  uint32_t in_use; /* The slot holds a live section */
+  uint64_t ext;    /* First extent of the data of the section */
+  uint32_t order;  /* The data block has 2^order extents */
+  uint32_t reserved;
+} CPSV_SECT_SLOT;
+
+#define m_CPSV_SECT_DIR_OFFSET sizeof(CPSV_CKPT_HDR)
+
+#define m_CPSV_SECT_IDX_OFFSET(max_secs)                \
+  (m_CPSV_SECT_DIR_OFFSET + sizeof(CPSV_SECT_DIR_HDR) + \
+   (uint64_t)(max_secs) * sizeof(CPSV_SECT_SLOT))
+
+#define m_CPSV_SECT_IDX_SIZE(max_secs) ((uint64_t)(max_secs) * 2)
+
+#define m_CPSV_SECT_HDR_OFFSET(lcl_sec_id, max_secs)   \
+  (m_CPSV_SECT_IDX_OFFSET(max_secs) +                  \
+   m_CPSV_SECT_IDX_SIZE(max_secs) * sizeof(uint32_t) + \
+   (uint64_t)(lcl_sec_id) * sizeof(CPSV_SECT_HDR))
+
+#define m_CPSV_SECT_DATA_BASE(max_secs)                                \
+  ((m_CPSV_SECT_HDR_OFFSET(max_secs, max_secs) + CPSV_SECT_DATA_ALIGN - \
+    1) & ~(uint64_t)(CPSV_SECT_DATA_ALIGN - 1))
+
+#define m_CPSV_SECT_DATA_OFFSET(ext, ext_size, max_secs) \
+  (m_CPSV_SECT_DATA_BASE(max_secs) + (uint64_t)(ext) * (ext_size))
+
+#define m_CPSV_REPLICA_SIZE(max_secs, max_sec_size) \
+  cpsv_replica_size(max_secs, max_sec_size)
+
+/* Extent size and largest block order of the sections of a checkpoint */
+void cpsv_sect_geometry(SaSizeT max_sec_size, uint64_t *ext_size,
+                        uint32_t *max_order);
+
+/* Hash of a section id in the section index */
+uint32_t cpsv_sect_id_hash(const uint8_t *id, uint32_t len);
+
+/* Size of the replica segment, UINT64_MAX if it does not fit */
+uint64_t cpsv_replica_size(uint32_t max_secs, SaSizeT max_sec_size);
+
+#define CPSV_MAX_REPLICA_NAME_LENGTH 255
+#define CPSV_REP_NAME_MAX_CKPT_NAME_LENGTH (CPSV_MAX_REPLICA_NAME_LENGTH - 32)
+
+/* Name of the replica segment of a checkpoint on a node, as given to
+   ncs_os_posix_shm(). buf must hold CPSV_MAX_REPLICA_NAME_LENGTH bytes. */
+void cpsv_replica_name(char *buf, const char *ckpt_name, uint32_t node_id,
+                       SaCkptCheckpointHandleT ckpt_id);
+
 typedef struct ckpt_info {
   SaNameT ckpt_name;
   SaCkptCheckpointHandleT ckpt_id;
@@ -121,4 +218,8 @@ typedef enum cpnd_type_info {
   CPND_CKPT_INFO
 } CPND_TYPE_INFO;
 
+#ifdef __cplusplus
+}
+#endif
+
 #endif  // CKPT_COMMON_CPSV_SHM_H_
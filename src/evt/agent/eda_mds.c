@@ -15,6 +15,7 @@
  *
  */
 
+#include <stdlib.h>
 #include "base/logtrace.h"
 #include "base/osaf_poll.h"
 
@@ -555,172 +556,230 @@ static uint32_t eda_dec_chan_open_cbk_msg(NCS_UBAID *uba, EDSV_MSG *msg)
 	return total_bytes;
 }
 
+static uint32_t eda_dec_clm_status_cbk_msg(NCS_UBAID *uba, EDSV_MSG *msg)
+{
+	uint8_t *p8;
+	int32_t total_bytes = 0;
+	EDSV_EDA_CLM_STATUS_CBK_PARAM *param =
+	    &msg->info.cbk_info.param.clm_status_cbk;
+	uint8_t local_data[256];
+
+	if (uba == NULL) {
+		TRACE_4("uba is NULL");
+		return 0;
+	}
+
+	/* ClmNodeStatus */
+	p8 = ncs_dec_flatten_space(uba, local_data, 2);
+	param->node_status = ncs_decode_16bit(&p8);
+	ncs_dec_skip_space(uba, 2);
+	total_bytes += 2;
+	return total_bytes;
+}
+
+static uint32_t eda_eds_msg_proc(EDA_CB *eda_cb, EDSV_MSG *edsv_msg,
+				 MDS_SEND_PRIORITY_TYPE prio);
+
 /****************************************************************************
-  Name          : eda_dec_delv_evt_cbk_msg
+  Name          : eda_relay_msg_free
 
-  Description   : This routine decodes a deliver event callback message
+  Description   : This routine frees a relayed event message.
 
-  Arguments     : NCS_UBAID *msg,
-		  EDSV_MSG *msg
+  Arguments     : EDSV_MSG *msg
 
-  Return Values : uint32_t
+  Return Values : None
 
   Notes         : None.
 ******************************************************************************/
-static uint32_t eda_dec_delv_evt_cbk_msg(NCS_UBAID *uba, EDSV_MSG *msg)
+static void eda_relay_msg_free(EDSV_MSG *msg)
 {
-	uint8_t *p8;
-	uint32_t x;
-	uint32_t fake_value;
-	uint64_t num_patterns;
-	uint32_t total_bytes = 0;
-	SaEvtEventPatternT *pattern_ptr;
 	EDSV_EDA_EVT_DELIVER_CBK_PARAM *param =
 	    &msg->info.cbk_info.param.evt_deliver_cbk;
-	uint8_t local_data[1024];
 
-	if (uba == NULL) {
-		TRACE_4("uba is NULL");
-		return 0;
-	}
-
-	/* sub_id, chan_id, chan_open_id */
-	p8 = ncs_dec_flatten_space(uba, local_data, 12);
-	param->sub_id = ncs_decode_32bit(&p8);
-	param->chan_id = ncs_decode_32bit(&p8);
-	param->chan_open_id = ncs_decode_32bit(&p8);
-	ncs_dec_skip_space(uba, 12);
-	total_bytes += 12;
+	edsv_free_evt_pattern_array(param->pattern_array);
+	if (param->data)
+		m_MMGR_FREE_EDSV_EVENT_DATA(param->data);
+	free(param->targets);
+	eda_msg_destroy(msg);
+}
 
-	/* Decode the patterns.
-	 * Must allocate space for these.
-	 */
+/****************************************************************************
+  Name          : eda_relay_failed_send
 
-	/* patternsNumber */
-	p8 = ncs_dec_flatten_space(uba, local_data, 8);
-	num_patterns = ncs_decode_64bit(&p8);
-	ncs_dec_skip_space(uba, 8);
-	total_bytes += 8;
+  Description   : This routine sends an event back to the EDS, with the
+		  targets this relay agent failed to forward it to.
 
-	param->pattern_array = m_MMGR_ALLOC_EVENT_PATTERN_ARRAY;
-	if (!param->pattern_array) {
-		TRACE_4("malloc failed for pattern array");
-		return 0;
-	}
-	param->pattern_array->patternsNumber = num_patterns;
-	if (num_patterns) {
-		param->pattern_array->patterns =
-		    m_MMGR_ALLOC_EVENT_PATTERNS((uint32_t)num_patterns);
-		if (!param->pattern_array->patterns) {
-			TRACE_4("malloc failed for patternarray->patterns");
-			return 0;
-		}
-	} else {
-		param->pattern_array->patterns = NULL;
-	}
+  Arguments     : cb - ptr to the EDA CB
+		  msg - EDSV_EDS_DELIVER_EVENT_NODE message
+		  failed - the targets the forward failed to
+		  num_failed - the number of failed targets
+		  prio - MDS priority it was received with
 
-	pattern_ptr = param->pattern_array->patterns;
-	for (x = 0; x < param->pattern_array->patternsNumber; x++) {
-		/* patternSize */
-		p8 = ncs_dec_flatten_space(uba, local_data, 8);
-		pattern_ptr->patternSize = ncs_decode_64bit(&p8);
-		ncs_dec_skip_space(uba, 8);
-		total_bytes += 8;
+  Return Values : None
 
-		/* For zero length patterns, fake decode zero */
-		if (pattern_ptr->patternSize == 0) {
-			p8 = ncs_dec_flatten_space(uba, local_data, 4);
-			fake_value = ncs_decode_32bit(&p8);
-			TRACE("pattern size: %u", fake_value);
-			/* Do so the free routine is happy */
-			pattern_ptr->pattern = m_MMGR_ALLOC_EDSV_EVENT_DATA(0);
-			ncs_dec_skip_space(uba, 4);
-			total_bytes += 4;
-		} else {
-			/* pattern */
-			pattern_ptr->pattern = m_MMGR_ALLOC_EDSV_EVENT_DATA(
-			    (uint32_t)pattern_ptr->patternSize);
-			if (!pattern_ptr->pattern) {
-				TRACE_4("malloc failed for event data");
-				return 0;
-			}
-			ncs_decode_n_octets_from_uba(
-			    uba, pattern_ptr->pattern,
-			    (uint32_t)pattern_ptr->patternSize);
-			total_bytes += (uint32_t)pattern_ptr->patternSize;
-		}
-		pattern_ptr++;
-	}
+  Notes         : None.
+******************************************************************************/
+static void eda_relay_failed_send(EDA_CB *cb, EDSV_MSG *msg,
+				  EDSV_EVT_DELIVER_TARGET *failed,
+				  uint32_t num_failed,
+				  MDS_SEND_PRIORITY_TYPE prio)
+{
+	EDSV_MSG rsp;
+
+	memset(&rsp, 0, sizeof(rsp));
+	rsp.type = EDSV_EDA_API_MSG;
+	rsp.info.api_info.type = EDSV_EDA_RELAY_FAILED;
+	rsp.info.api_info.param.relay_failed =
+	    msg->info.cbk_info.param.evt_deliver_cbk;
+	rsp.info.api_info.param.relay_failed.num_targets = num_failed;
+	rsp.info.api_info.param.relay_failed.targets = failed;
+
+	if (eda_mds_msg_async_send(cb, &rsp, prio) != NCSCC_RC_SUCCESS)
+		TRACE_2("event lost for %u subscriptions, send to EDS failed",
+			num_failed);
+}
 
-	/* priority */
-	p8 = ncs_dec_flatten_space(uba, local_data, 1);
-	param->priority = ncs_decode_8bit(&p8);
-	ncs_dec_skip_space(uba, 1);
-	total_bytes += 1;
+/****************************************************************************
+  Name          : eda_relay_forward
 
-	/* publisher_name length */
-	p8 = ncs_dec_flatten_space(uba, local_data, 2);
-	param->publisher_name.length = ncs_decode_16bit(&p8);
-	ncs_dec_skip_space(uba, 2);
-	total_bytes += 2;
+  Description   : This routine forwards an event the EDS sent to this agent
+		  as the relay of the node to the other agents on the node
+		  it is to be delivered to. It is called before the EDA CB
+		  is locked, as the first send to an agent waits for MDS to
+		  discover it.
 
-	/* publisher_name */
-	ncs_decode_n_octets_from_uba(uba, param->publisher_name.value,
-				     (uint32_t)param->publisher_name.length);
-	total_bytes += (uint32_t)param->publisher_name.length;
+  Arguments     : cb - ptr to the EDA CB
+		  msg - EDSV_EDS_DELIVER_EVENT_NODE message
+		  prio - MDS priority it was received with
 
-	/* publish_time, eda_event_id */
-	p8 = ncs_dec_flatten_space(uba, local_data, 24);
-	param->publish_time = ncs_decode_64bit(&p8);
-	param->retention_time = ncs_decode_64bit(&p8);
-	param->eda_event_id = ncs_decode_32bit(&p8);
-	param->ret_evt_ch_oid = ncs_decode_32bit(&p8);
-	ncs_dec_skip_space(uba, 24);
-	total_bytes += 24;
+  Return Values : None
 
-	/* data_len */
-	p8 = ncs_dec_flatten_space(uba, local_data, 8);
-	param->data_len = ncs_decode_64bit(&p8);
-	ncs_dec_skip_space(uba, 8);
-	total_bytes += 8;
+  Notes         : The forwarded messages refer to the patterns and data of
+		  msg, which are encoded before the send returns. The
+		  targets the forward failed to are sent back to the EDS,
+		  which delivers to them directly.
+******************************************************************************/
+static void eda_relay_forward(EDA_CB *cb, EDSV_MSG *msg,
+			      MDS_SEND_PRIORITY_TYPE prio)
+{
+	EDSV_EDA_EVT_DELIVER_CBK_PARAM *param =
+	    &msg->info.cbk_info.param.evt_deliver_cbk;
+	EDSV_EVT_DELIVER_TARGET *t;
+	EDSV_EVT_DELIVER_TARGET *failed = NULL;
+	uint32_t num_failed = 0;
+	EDSV_MSG fwd;
+	NCSMDS_INFO mds_info;
+	uint32_t x;
 
-	/* data */
-	if ((uint32_t)param->data_len) {
-		param->data =
-		    m_MMGR_ALLOC_EDSV_EVENT_DATA((uint32_t)param->data_len);
-		if (!param->data) {
-			TRACE_4("malloc failedi for event data");
-			return 0;
+	for (x = 0; x < param->num_targets; x++) {
+		t = &param->targets[x];
+		if (t->dest == cb->eds_intf.eda_mds_dest)
+			continue;
+
+		fwd = *msg;
+		fwd.info.cbk_info.type = EDSV_EDS_DELIVER_EVENT;
+		fwd.info.cbk_info.eds_reg_id = t->reg_id;
+		fwd.info.cbk_info.param.evt_deliver_cbk.sub_id = t->sub_id;
+		fwd.info.cbk_info.param.evt_deliver_cbk.chan_id = t->chan_id;
+		fwd.info.cbk_info.param.evt_deliver_cbk.chan_open_id =
+		    t->chan_open_id;
+		fwd.info.cbk_info.param.evt_deliver_cbk.num_targets = 0;
+		fwd.info.cbk_info.param.evt_deliver_cbk.targets = NULL;
+
+		memset(&mds_info, '\0', sizeof(NCSMDS_INFO));
+		mds_info.i_mds_hdl = cb->eds_intf.mds_hdl;
+		mds_info.i_svc_id = NCSMDS_SVC_ID_EDA;
+		mds_info.i_op = MDS_SEND;
+		mds_info.info.svc_send.i_msg = (NCSCONTEXT)&fwd;
+		mds_info.info.svc_send.i_priority = prio;
+		mds_info.info.svc_send.i_to_svc = NCSMDS_SVC_ID_EDA;
+		mds_info.info.svc_send.i_sendtype = MDS_SENDTYPE_SND;
+		mds_info.info.svc_send.info.snd.i_to_dest = t->dest;
+
+		if (ncsmds_api(&mds_info) != NCSCC_RC_SUCCESS) {
+			TRACE_2("event relay to dest: %" PRIx64 " failed",
+				t->dest);
+			/* The targets are copied in order, ahead of x */
+			if (failed == NULL)
+				failed = calloc(param->num_targets,
+						sizeof(*failed));
+			if (failed != NULL)
+				failed[num_failed++] = *t;
 		}
-		ncs_decode_n_octets_from_uba(uba, param->data,
-					     (uint32_t)param->data_len);
-	} else
-		param->data = NULL;
-
-	total_bytes += (uint32_t)param->data_len;
+	}
 
-	return total_bytes;
+	if (num_failed != 0)
+		eda_relay_failed_send(cb, msg, failed, num_failed, prio);
+	free(failed);
 }
 
-static uint32_t eda_dec_clm_status_cbk_msg(NCS_UBAID *uba, EDSV_MSG *msg)
+/****************************************************************************
+  Name          : eda_relay_deliver_local
+
+  Description   : This routine delivers an event the EDS sent to this agent
+		  as the relay of the node to the subscriptions of this
+		  agent, as one deliver event callback message each.
+
+  Arguments     : cb - ptr to the EDA CB
+		  msg - EDSV_EDS_DELIVER_EVENT_NODE message, freed here
+		  prio - MDS priority it was received with
+
+  Return Values : None
+
+  Notes         : None.
+******************************************************************************/
+static void eda_relay_deliver_local(EDA_CB *cb, EDSV_MSG *msg,
+				    MDS_SEND_PRIORITY_TYPE prio)
 {
-	uint8_t *p8;
-	int32_t total_bytes = 0;
-	EDSV_EDA_CLM_STATUS_CBK_PARAM *param =
-	    &msg->info.cbk_info.param.clm_status_cbk;
-	uint8_t local_data[256];
+	EDSV_EDA_EVT_DELIVER_CBK_PARAM *param =
+	    &msg->info.cbk_info.param.evt_deliver_cbk;
+	EDSV_EDA_EVT_DELIVER_CBK_PARAM *copy_param;
+	EDSV_EVT_DELIVER_TARGET *t;
+	EDSV_MSG *copy;
+	SaAisErrorT error;
+	uint32_t x;
 
-	if (uba == NULL) {
-		TRACE_4("uba is NULL");
-		return 0;
+	for (x = 0; x < param->num_targets; x++) {
+		t = &param->targets[x];
+		if (t->dest != cb->eds_intf.eda_mds_dest)
+			continue;
+
+		if (NULL == (copy = m_MMGR_ALLOC_EDSV_MSG)) {
+			TRACE_4("malloc failed for relayed event");
+			break;
+		}
+		*copy = *msg;
+		copy->info.cbk_info.type = EDSV_EDS_DELIVER_EVENT;
+		copy->info.cbk_info.eds_reg_id = t->reg_id;
+		copy_param = &copy->info.cbk_info.param.evt_deliver_cbk;
+		copy_param->sub_id = t->sub_id;
+		copy_param->chan_id = t->chan_id;
+		copy_param->chan_open_id = t->chan_open_id;
+		copy_param->num_targets = 0;
+		copy_param->targets = NULL;
+		copy_param->data = NULL;
+		copy_param->pattern_array = edsv_copy_evt_pattern_array(
+		    param->pattern_array, &error);
+		if (copy_param->pattern_array == NULL) {
+			eda_msg_destroy(copy);
+			break;
+		}
+		if (param->data_len) {
+			copy_param->data = m_MMGR_ALLOC_EDSV_EVENT_DATA(
+			    (uint32_t)param->data_len);
+			if (copy_param->data == NULL) {
+				eda_relay_msg_free(copy);
+				break;
+			}
+			memcpy(copy_param->data, param->data,
+			       (size_t)param->data_len);
+		}
+
+		/* Takes over the copy */
+		eda_eds_msg_proc(cb, copy, prio);
 	}
 
-	/* ClmNodeStatus */
-	p8 = ncs_dec_flatten_space(uba, local_data, 2);
-	param->node_status = ncs_decode_16bit(&p8);
-	ncs_dec_skip_space(uba, 2);
-	total_bytes += 2;
-	return total_bytes;
+	eda_relay_msg_free(msg);
 }
 
 /****************************************************************************
@@ -915,6 +974,9 @@ static uint32_t eda_eds_msg_proc(EDA_CB *eda_cb, EDSV_MSG *edsv_msg,
 			}
 
 		} break;
+		case EDSV_EDS_DELIVER_EVENT_NODE:
+			eda_relay_deliver_local(eda_cb, edsv_msg, prio);
+			break;
 		case EDSV_EDS_CLMNODE_STATUS: {
 			EDSV_EDA_CLM_STATUS_CBK_PARAM *clm_status_param =
 			    &edsv_msg->info.cbk_info.param.clm_status_cbk;
@@ -1058,6 +1120,13 @@ static uint32_t eda_mds_rcv(struct ncsmds_callback_info *mds_cb_info)
 		return rc;
 	}
 
+	/** Pass an event on to the other agents on this node first
+	 **/
+	if (edsv_msg->type == EDSV_EDS_CBK_MSG &&
+	    edsv_msg->info.cbk_info.type == EDSV_EDS_DELIVER_EVENT_NODE)
+		eda_relay_forward(eda_cb, edsv_msg,
+				  mds_cb_info->info.receive.i_priority);
+
 	/** Lock EDA_CB
 	 **/
 	m_NCS_LOCK(&eda_cb->cb_lock, NCS_LOCK_WRITE);
@@ -1167,9 +1236,30 @@ static uint32_t eda_mds_enc(struct ncsmds_callback_info *info)
 		case EDSV_EDA_LIMIT_GET:
 			/* Nothing to encode in this request */
 			break;
+		case EDSV_EDA_RELAY_FAILED:
+			total_bytes += edsv_enc_delv_targets(
+			    uba, &msg->info.api_info.param.relay_failed);
+			total_bytes += edsv_enc_delv_evt_cbk_msg(
+			    uba, &msg->info.api_info.param.relay_failed);
+			break;
 		default:
 			break;
 		}
+	} else if (EDSV_EDS_CBK_MSG == msg->type &&
+		   EDSV_EDS_DELIVER_EVENT == msg->info.cbk_info.type) {
+		/** an event relayed to another agent on this node **/
+		p8 = ncs_enc_reserve_space(uba, 16);
+		if (!p8) {
+			TRACE_4("reserve space failed");
+		}
+		ncs_encode_32bit(&p8, msg->info.cbk_info.type);
+		ncs_encode_32bit(&p8, msg->info.cbk_info.eds_reg_id);
+		ncs_encode_64bit(&p8, msg->info.cbk_info.inv);
+		ncs_enc_claim_space(uba, 16);
+		total_bytes += 16;
+
+		total_bytes += edsv_enc_delv_evt_cbk_msg(
+		    uba, &msg->info.cbk_info.param.evt_deliver_cbk);
 	}
 
 	TRACE("Total bytes encoded in message: %u, msgtype: %u", total_bytes,
@@ -1383,7 +1473,14 @@ static uint32_t eda_mds_dec(struct ncsmds_callback_info *info)
 			total_bytes += eda_dec_chan_open_cbk_msg(uba, msg);
 			break;
 		case EDSV_EDS_DELIVER_EVENT:
-			total_bytes += eda_dec_delv_evt_cbk_msg(uba, msg);
+			total_bytes += edsv_dec_delv_evt_cbk_msg(
+			    uba, &msg->info.cbk_info.param.evt_deliver_cbk);
+			break;
+		case EDSV_EDS_DELIVER_EVENT_NODE:
+			total_bytes += edsv_dec_delv_targets(
+			    uba, &msg->info.cbk_info.param.evt_deliver_cbk);
+			total_bytes += edsv_dec_delv_evt_cbk_msg(
+			    uba, &msg->info.cbk_info.param.evt_deliver_cbk);
 			break;
 		case EDSV_EDS_CLMNODE_STATUS:
 			total_bytes += eda_dec_clm_status_cbk_msg(uba, msg);
@@ -37,7 +37,7 @@
  * semantics for communication with EDS
  */
 
-#define EDA_SVC_PVT_SUBPART_VERSION 1
+#define EDA_SVC_PVT_SUBPART_VERSION EDA_RELAY_SVC_PVT_VERSION
 #define EDA_WRT_EDS_SUBPART_VER_AT_MIN_MSG_FMT 1
 #define EDA_WRT_EDS_SUBPART_VER_AT_MAX_MSG_FMT 1
 #define EDA_WRT_EDS_SUBPART_VER_RANGE       \
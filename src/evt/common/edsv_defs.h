@@ -25,6 +25,10 @@
 
 #define EDA_POOL_ID 1
 
+/* MDS subpart version of an EDA that relays EDSV_EDS_DELIVER_EVENT_NODE
+   messages to the other agents on its node */
+#define EDA_RELAY_SVC_PVT_VERSION 2
+
 #define EDSV_RELEASE_CODE 'B'
 #define EDSV_MAJOR_VERSION 0x03
 #define EDSV_MINOR_VERSION 0x01
@@ -69,6 +69,7 @@ typedef enum edsv_api_msg_type {
   EDSV_EDA_UNSUBSCRIBE,
   EDSV_EDA_RETENTION_TIME_CLR,
   EDSV_EDA_LIMIT_GET,
+  EDSV_EDA_RELAY_FAILED, /* Event a relay EDA failed to forward */
   EDSV_API_MAX
 } EDSV_API_TYPE;
 
@@ -79,6 +80,7 @@ typedef enum edsv_cbk_msg_type {
   EDSV_EDS_CHAN_OPEN = EDSV_CBK_BASE_MSG,
   EDSV_EDS_DELIVER_EVENT,
   EDSV_EDS_CLMNODE_STATUS,
+  EDSV_EDS_DELIVER_EVENT_NODE, /* One copy per node, to a relay EDA */
   EDSV_EDS_CBK_MAX
 } EDSV_CBK_TYPE;
 
@@ -203,6 +205,35 @@ typedef struct edsv_eda_retention_time_clr_param_tag {
   uint32_t event_id;
 } EDSV_EDA_RETENTION_TIME_CLR_PARAM;
 
+/* A subscription an event is delivered to by the relay EDA of its node */
+typedef struct edsv_evt_deliver_target_tag {
+  MDS_DEST dest;
+  uint32_t reg_id;
+  SaEvtSubscriptionIdT sub_id;
+  uint32_t chan_id;
+  uint32_t chan_open_id;
+} EDSV_EVT_DELIVER_TARGET;
+
+typedef struct edsv_eda_evt_deliver_cb_param_tag {
+  SaEvtSubscriptionIdT sub_id;
+  uint32_t chan_id;
+  uint32_t chan_open_id;
+  SaEvtEventPatternArrayT *pattern_array;
+  uint8_t priority;
+  SaNameT publisher_name;
+  SaTimeT publish_time;
+  SaTimeT retention_time;
+  uint32_t eda_event_id;
+  uint32_t event_hdl; /* filled in at the EDA with eventHandle use 0 at EDS */
+  uint32_t ret_evt_ch_oid;
+  SaSizeT data_len;
+  uint8_t *data;
+  /* EDSV_EDS_DELIVER_EVENT_NODE only, sub_id, chan_id and chan_open_id
+     above are those of the first target */
+  uint32_t num_targets;
+  EDSV_EVT_DELIVER_TARGET *targets;
+} EDSV_EDA_EVT_DELIVER_CBK_PARAM;
+
 /* API param definition */
 typedef struct edsv_api_info_tag {
   EDSV_API_TYPE type; /* api type */
@@ -217,6 +248,8 @@ typedef struct edsv_api_info_tag {
     EDSV_EDA_SUBSCRIBE_PARAM subscribe;
     EDSV_EDA_UNSUBSCRIBE_PARAM unsubscribe;
     EDSV_EDA_RETENTION_TIME_CLR_PARAM rettimeclr;
+    /* The targets are those the relay failed to forward the event to */
+    EDSV_EDA_EVT_DELIVER_CBK_PARAM relay_failed;
   } param;
 } EDSV_API_INFO;
 
@@ -232,22 +265,6 @@ typedef struct edsv_eda_chan_open_cb_param_tag {
   SaAisErrorT error;
 } EDSV_EDA_CHAN_OPEN_CBK_PARAM;
 
-typedef struct edsv_eda_evt_deliver_cb_param_tag {
-  SaEvtSubscriptionIdT sub_id;
-  uint32_t chan_id;
-  uint32_t chan_open_id;
-  SaEvtEventPatternArrayT *pattern_array;
-  uint8_t priority;
-  SaNameT publisher_name;
-  SaTimeT publish_time;
-  SaTimeT retention_time;
-  uint32_t eda_event_id;
-  uint32_t event_hdl; /* filled in at the EDA with eventHandle use 0 at EDS */
-  uint32_t ret_evt_ch_oid;
-  SaSizeT data_len;
-  uint8_t *data;
-} EDSV_EDA_EVT_DELIVER_CBK_PARAM;
-
 typedef struct edsv_eda_clm_status_param_tag {
   uint16_t node_status;
 } EDSV_EDA_CLM_STATUS_CBK_PARAM;
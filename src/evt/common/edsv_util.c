@@ -26,6 +26,7 @@
  *  library and server.                                                       *
  *                                                                            *
  *****************************************************************************/
+#include <stdlib.h>
 #include "evt/agent/eda.h"
 #include "base/logtrace.h"
 
@@ -430,3 +431,396 @@ void eda_free_event_patterns(SaEvtEventPatternT *patterns,
 	}
 	TRACE_LEAVE();
 }
+
+/****************************************************************************
+  Name          : edsv_enc_delv_evt_cbk_msg
+
+  Description   : This routine encodes an event callback msg, for the EDS
+		  and for an EDA relaying an event on its node.
+
+  Arguments     : NCS_UBAID *msg,
+		  EDSV_EDA_EVT_DELIVER_CBK_PARAM *param
+
+  Return Values : uint32_t
+
+  Notes         : None.
+******************************************************************************/
+uint32_t edsv_enc_delv_evt_cbk_msg(NCS_UBAID *uba,
+				   EDSV_EDA_EVT_DELIVER_CBK_PARAM *param)
+{
+	uint8_t *p8;
+	uint32_t x;
+	uint32_t total_bytes = 0;
+	SaEvtEventPatternT *pattern_ptr;
+
+	if (uba == NULL) {
+		TRACE_4("uba is NULL");
+		return 0;
+	}
+
+	/* type, reg_id, sub_id, chan_id, chan_open_id */
+	p8 = ncs_enc_reserve_space(uba, 12);
+	if (!p8) {
+		TRACE_4("encode reserve space failed");
+	}
+	ncs_encode_32bit(&p8, param->sub_id);
+	ncs_encode_32bit(&p8, param->chan_id);
+	ncs_encode_32bit(&p8, param->chan_open_id);
+	ncs_enc_claim_space(uba, 12);
+	total_bytes += 12;
+
+	/* Encode the patterns */
+
+	/* patternsNumber */
+	p8 = ncs_enc_reserve_space(uba, 8);
+	if (!p8) {
+		TRACE_4("encode reserve space failed");
+	}
+	ncs_encode_64bit(&p8, param->pattern_array->patternsNumber);
+	ncs_enc_claim_space(uba, 8);
+	total_bytes += 8;
+
+	/* patterns */
+	pattern_ptr = param->pattern_array->patterns;
+	for (x = 0; x < param->pattern_array->patternsNumber; x++) {
+		/* Save room for the patternSize field (8 bytes) */
+		p8 = ncs_enc_reserve_space(uba, 8);
+		if (!p8) {
+			TRACE_4("encode reserve space failed");
+		}
+		ncs_encode_64bit(&p8, pattern_ptr->patternSize);
+		ncs_enc_claim_space(uba, 8);
+		total_bytes += 8;
+
+		/* For zero length patterns, fake encode zero */
+		if (pattern_ptr->patternSize == 0) {
+			p8 = ncs_enc_reserve_space(uba, 4);
+			if (!p8) {
+				TRACE_4("encode reserve space failed");
+			}
+			ncs_encode_32bit(&p8, 0);
+			ncs_enc_claim_space(uba, 4);
+			total_bytes += 4;
+		} else {
+			ncs_encode_n_octets_in_uba(
+			    uba, pattern_ptr->pattern,
+			    (uint32_t)pattern_ptr->patternSize);
+			total_bytes += (uint32_t)pattern_ptr->patternSize;
+		}
+		pattern_ptr++;
+	}
+
+	/* priority */
+	p8 = ncs_enc_reserve_space(uba, 1);
+	if (!p8) {
+		TRACE_4("encode reserve space failed");
+	}
+	ncs_encode_8bit(&p8, param->priority);
+	ncs_enc_claim_space(uba, 1);
+	total_bytes += 1;
+
+	/* publisher name length */
+	p8 = ncs_enc_reserve_space(uba, 2);
+	if (!p8) {
+		TRACE_4("encode reserve space failed");
+	}
+	ncs_encode_16bit(&p8, param->publisher_name.length);
+	ncs_enc_claim_space(uba, 2);
+	total_bytes += 2;
+
+	/* publisher name */
+	ncs_encode_n_octets_in_uba(uba, param->publisher_name.value,
+				   (uint32_t)param->publisher_name.length);
+	total_bytes += (uint32_t)param->publisher_name.length;
+
+	/* publish_time,  eda_event_id */
+	p8 = ncs_enc_reserve_space(uba, 24);
+	if (!p8) {
+		TRACE_4("encode reserve space failed");
+	}
+	ncs_encode_64bit(&p8, param->publish_time);
+	ncs_encode_64bit(&p8, param->retention_time);
+	ncs_encode_32bit(&p8, (uint32_t)param->eda_event_id);
+	/* event_hdl is skipped purposely */
+	ncs_encode_32bit(&p8, (uint32_t)param->ret_evt_ch_oid);
+	ncs_enc_claim_space(uba, 24);
+	total_bytes += 24;
+
+	/* Encode the data */
+
+	/* data_len */
+	p8 = ncs_enc_reserve_space(uba, 8);
+	if (!p8) {
+		TRACE_4("encode reserve space failed");
+	}
+	ncs_encode_64bit(&p8, param->data_len);
+	ncs_enc_claim_space(uba, 8);
+	total_bytes += 8;
+
+	/* data */
+	ncs_encode_n_octets_in_uba(uba, param->data, (uint32_t)param->data_len);
+	total_bytes += (uint32_t)param->data_len;
+
+	return total_bytes;
+}
+
+/****************************************************************************
+  Name          : edsv_dec_delv_evt_cbk_msg
+
+  Description   : This routine decodes a deliver event callback msg, for an
+		  EDA and for the EDS getting back an event a relay EDA
+		  failed to forward.
+
+  Arguments     : NCS_UBAID *msg,
+		  EDSV_EDA_EVT_DELIVER_CBK_PARAM *param
+
+  Return Values : uint32_t
+
+  Notes         : None.
+******************************************************************************/
+uint32_t edsv_dec_delv_evt_cbk_msg(NCS_UBAID *uba,
+				   EDSV_EDA_EVT_DELIVER_CBK_PARAM *param)
+{
+	uint8_t *p8;
+	uint32_t x;
+	uint32_t fake_value;
+	uint64_t num_patterns;
+	uint32_t total_bytes = 0;
+	SaEvtEventPatternT *pattern_ptr;
+	uint8_t local_data[1024];
+
+	if (uba == NULL) {
+		TRACE_4("uba is NULL");
+		return 0;
+	}
+
+	/* sub_id, chan_id, chan_open_id */
+	p8 = ncs_dec_flatten_space(uba, local_data, 12);
+	param->sub_id = ncs_decode_32bit(&p8);
+	param->chan_id = ncs_decode_32bit(&p8);
+	param->chan_open_id = ncs_decode_32bit(&p8);
+	ncs_dec_skip_space(uba, 12);
+	total_bytes += 12;
+
+	/* Decode the patterns.
+	 * Must allocate space for these.
+	 */
+
+	/* patternsNumber */
+	p8 = ncs_dec_flatten_space(uba, local_data, 8);
+	num_patterns = ncs_decode_64bit(&p8);
+	ncs_dec_skip_space(uba, 8);
+	total_bytes += 8;
+
+	param->pattern_array = m_MMGR_ALLOC_EVENT_PATTERN_ARRAY;
+	if (!param->pattern_array) {
+		TRACE_4("malloc failed for pattern array");
+		return 0;
+	}
+	param->pattern_array->patternsNumber = num_patterns;
+	if (num_patterns) {
+		param->pattern_array->patterns =
+		    m_MMGR_ALLOC_EVENT_PATTERNS((uint32_t)num_patterns);
+		if (!param->pattern_array->patterns) {
+			TRACE_4("malloc failed for patternarray->patterns");
+			return 0;
+		}
+	} else {
+		param->pattern_array->patterns = NULL;
+	}
+
+	pattern_ptr = param->pattern_array->patterns;
+	for (x = 0; x < param->pattern_array->patternsNumber; x++) {
+		/* patternSize */
+		p8 = ncs_dec_flatten_space(uba, local_data, 8);
+		pattern_ptr->patternSize = ncs_decode_64bit(&p8);
+		ncs_dec_skip_space(uba, 8);
+		total_bytes += 8;
+
+		/* For zero length patterns, fake decode zero */
+		if (pattern_ptr->patternSize == 0) {
+			p8 = ncs_dec_flatten_space(uba, local_data, 4);
+			fake_value = ncs_decode_32bit(&p8);
+			TRACE("pattern size: %u", fake_value);
+			/* Do so the free routine is happy */
+			pattern_ptr->pattern = m_MMGR_ALLOC_EDSV_EVENT_DATA(0);
+			ncs_dec_skip_space(uba, 4);
+			total_bytes += 4;
+		} else {
+			/* pattern */
+			pattern_ptr->pattern = m_MMGR_ALLOC_EDSV_EVENT_DATA(
+			    (uint32_t)pattern_ptr->patternSize);
+			if (!pattern_ptr->pattern) {
+				TRACE_4("malloc failed for event data");
+				return 0;
+			}
+			ncs_decode_n_octets_from_uba(
+			    uba, pattern_ptr->pattern,
+			    (uint32_t)pattern_ptr->patternSize);
+			total_bytes += (uint32_t)pattern_ptr->patternSize;
+		}
+		pattern_ptr++;
+	}
+
+	/* priority */
+	p8 = ncs_dec_flatten_space(uba, local_data, 1);
+	param->priority = ncs_decode_8bit(&p8);
+	ncs_dec_skip_space(uba, 1);
+	total_bytes += 1;
+
+	/* publisher_name length */
+	p8 = ncs_dec_flatten_space(uba, local_data, 2);
+	param->publisher_name.length = ncs_decode_16bit(&p8);
+	ncs_dec_skip_space(uba, 2);
+	total_bytes += 2;
+
+	/* publisher_name */
+	ncs_decode_n_octets_from_uba(uba, param->publisher_name.value,
+				     (uint32_t)param->publisher_name.length);
+	total_bytes += (uint32_t)param->publisher_name.length;
+
+	/* publish_time, eda_event_id */
+	p8 = ncs_dec_flatten_space(uba, local_data, 24);
+	param->publish_time = ncs_decode_64bit(&p8);
+	param->retention_time = ncs_decode_64bit(&p8);
+	param->eda_event_id = ncs_decode_32bit(&p8);
+	param->ret_evt_ch_oid = ncs_decode_32bit(&p8);
+	ncs_dec_skip_space(uba, 24);
+	total_bytes += 24;
+
+	/* data_len */
+	p8 = ncs_dec_flatten_space(uba, local_data, 8);
+	param->data_len = ncs_decode_64bit(&p8);
+	ncs_dec_skip_space(uba, 8);
+	total_bytes += 8;
+
+	/* data */
+	if ((uint32_t)param->data_len) {
+		param->data =
+		    m_MMGR_ALLOC_EDSV_EVENT_DATA((uint32_t)param->data_len);
+		if (!param->data) {
+			TRACE_4("malloc failed for event data");
+			return 0;
+		}
+		ncs_decode_n_octets_from_uba(uba, param->data,
+					     (uint32_t)param->data_len);
+	} else
+		param->data = NULL;
+
+	total_bytes += (uint32_t)param->data_len;
+
+	return total_bytes;
+}
+
+/****************************************************************************
+  Name          : edsv_enc_delv_targets
+
+  Description   : This routine encodes the subscriptions a relay EDA is to
+		  deliver an event to, or failed to forward it to.
+
+  Arguments     : NCS_UBAID *msg,
+		  EDSV_EDA_EVT_DELIVER_CBK_PARAM *param
+
+  Return Values : uint32_t
+
+  Notes         : None.
+******************************************************************************/
+uint32_t edsv_enc_delv_targets(NCS_UBAID *uba,
+			       EDSV_EDA_EVT_DELIVER_CBK_PARAM *param)
+{
+	uint8_t *p8;
+	uint32_t x;
+	uint32_t total_bytes = 0;
+	EDSV_EVT_DELIVER_TARGET *t;
+
+	if (uba == NULL) {
+		TRACE_4("uba is NULL");
+		return 0;
+	}
+
+	p8 = ncs_enc_reserve_space(uba, 4);
+	if (!p8) {
+		TRACE_4("encode reserve space failed");
+	}
+	ncs_encode_32bit(&p8, param->num_targets);
+	ncs_enc_claim_space(uba, 4);
+	total_bytes += 4;
+
+	for (x = 0; x < param->num_targets; x++) {
+		t = &param->targets[x];
+		p8 = ncs_enc_reserve_space(uba, 24);
+		if (!p8) {
+			TRACE_4("encode reserve space failed");
+		}
+		ncs_encode_64bit(&p8, t->dest);
+		ncs_encode_32bit(&p8, t->reg_id);
+		ncs_encode_32bit(&p8, t->sub_id);
+		ncs_encode_32bit(&p8, t->chan_id);
+		ncs_encode_32bit(&p8, t->chan_open_id);
+		ncs_enc_claim_space(uba, 24);
+		total_bytes += 24;
+	}
+
+	return total_bytes;
+}
+
+/****************************************************************************
+  Name          : edsv_dec_delv_targets
+
+  Description   : This routine decodes the subscriptions a relay EDA is to
+		  deliver an event to, or failed to forward it to.
+
+  Arguments     : NCS_UBAID *msg,
+		  EDSV_EDA_EVT_DELIVER_CBK_PARAM *param
+
+  Return Values : uint32_t
+
+  Notes         : If the targets cannot be allocated, they are skipped and
+		  num_targets is 0, the event after them still decodes.
+******************************************************************************/
+uint32_t edsv_dec_delv_targets(NCS_UBAID *uba,
+			       EDSV_EDA_EVT_DELIVER_CBK_PARAM *param)
+{
+	uint8_t *p8;
+	uint32_t x;
+	uint32_t num_targets;
+	uint32_t total_bytes = 0;
+	EDSV_EVT_DELIVER_TARGET *t;
+	uint8_t local_data[24];
+
+	param->num_targets = 0;
+	param->targets = NULL;
+
+	if (uba == NULL) {
+		TRACE_4("uba is NULL");
+		return 0;
+	}
+
+	p8 = ncs_dec_flatten_space(uba, local_data, 4);
+	num_targets = ncs_decode_32bit(&p8);
+	ncs_dec_skip_space(uba, 4);
+	total_bytes += 4;
+
+	param->targets = calloc(num_targets ? num_targets : 1, sizeof(*t));
+	if (param->targets == NULL) {
+		TRACE_4("malloc failed for event delivery targets");
+		for (x = 0; x < num_targets; x++)
+			ncs_dec_skip_space(uba, 24);
+		return total_bytes + num_targets * 24;
+	}
+
+	for (x = 0; x < num_targets; x++) {
+		t = &param->targets[x];
+		p8 = ncs_dec_flatten_space(uba, local_data, 24);
+		t->dest = ncs_decode_64bit(&p8);
+		t->reg_id = ncs_decode_32bit(&p8);
+		t->sub_id = ncs_decode_32bit(&p8);
+		t->chan_id = ncs_decode_32bit(&p8);
+		t->chan_open_id = ncs_decode_32bit(&p8);
+		ncs_dec_skip_space(uba, 24);
+		total_bytes += 24;
+	}
+	param->num_targets = num_targets;
+
+	return total_bytes;
+}
@@ -46,6 +46,16 @@ uint32_t eds_calc_filter_size(SaEvtEventFilterArrayT *);
 
 void eda_free_event_patterns(SaEvtEventPatternT *, SaSizeT);
 
+uint32_t edsv_enc_delv_evt_cbk_msg(NCS_UBAID *,
+                                   EDSV_EDA_EVT_DELIVER_CBK_PARAM *);
+
+uint32_t edsv_dec_delv_evt_cbk_msg(NCS_UBAID *,
+                                   EDSV_EDA_EVT_DELIVER_CBK_PARAM *);
+
+uint32_t edsv_enc_delv_targets(NCS_UBAID *, EDSV_EDA_EVT_DELIVER_CBK_PARAM *);
+
+uint32_t edsv_dec_delv_targets(NCS_UBAID *, EDSV_EDA_EVT_DELIVER_CBK_PARAM *);
+
 /* Macro to fill in the attributes of a lost event */
 #define m_EDSV_LOST_EVENT_FILL(m)                                             \
   do {                                                                        \
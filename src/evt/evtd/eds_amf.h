@@ -49,8 +49,7 @@ uint32_t eds_quiesced_state_handler(EDS_CB *cb, SaInvocationT invocation);
 struct next_HAState {
   uint8_t nextState1;
   uint8_t nextState2;
-} nextStateInfo; /* AMF HA state can transit to a maximum of the two defined
-                    states */
+}; /* AMF HA state can transit to a maximum of the two defined states */
 
 #define VALIDATE_STATE(curr, next)                  \
   ((curr > MAX_HA_STATE) || (next > MAX_HA_STATE))  \
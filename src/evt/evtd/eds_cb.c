@@ -53,6 +53,7 @@ static nfds_t nfds = 6;
 uint32_t eds_cb_init(EDS_CB *eds_cb)
 {
 	NCS_PATRICIA_PARAMS reg_param, cname_param, nodelist_param;
+	const char *fanout;
 
 	memset(&reg_param, 0, sizeof(NCS_PATRICIA_PARAMS));
 	memset(&cname_param, 0, sizeof(NCS_PATRICIA_PARAMS));
@@ -73,6 +74,10 @@ uint32_t eds_cb_init(EDS_CB *eds_cb)
 	eds_cb->imm_sel_obj = -1;
 	eds_cb->fully_initialized = false;
 
+	/* Per node fan-out of events is on unless disabled */
+	fanout = getenv("EDSV_NODE_FANOUT");
+	eds_cb->node_fanout = (fanout == NULL || atoi(fanout) != 0);
+
 	/* Assign Version. Currently, hardcoded, This will change later */
 	m_GET_MY_VERSION(eds_cb->eds_version);
 
@@ -101,6 +106,14 @@ uint32_t eds_cb_init(EDS_CB *eds_cb)
 		return NCSCC_RC_FAILURE;
 	}
 
+	/* Initialize patricia tree for node relay list */
+	if (NCSCC_RC_SUCCESS !=
+	    ncs_patricia_tree_init(&eds_cb->node_relay_list, &nodelist_param)) {
+		LOG_ER("Patricia Init for Node Relay List failed");
+		TRACE_LEAVE();
+		return NCSCC_RC_FAILURE;
+	}
+
 	TRACE_LEAVE();
 	return NCSCC_RC_SUCCESS;
 }
@@ -124,6 +137,8 @@ void eds_cb_destroy(EDS_CB *eds_cb)
 	/* Check if other lists are deleted as well */
 	ncs_patricia_tree_destroy(&eds_cb->eds_cname_list);
 	ncs_patricia_tree_destroy(&eds_cb->eds_cluster_nodes_list);
+	eds_node_relay_destroy(eds_cb);
+	ncs_patricia_tree_destroy(&eds_cb->node_relay_list);
 
 	return;
 }
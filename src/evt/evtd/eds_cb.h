@@ -40,7 +40,7 @@
 #include "base/ncssysf_tmr.h"
 
 /* global variables */
-uint32_t gl_eds_hdl;
+extern uint32_t gl_eds_hdl;
 
 struct eda_reg_list_tag;
 
@@ -142,8 +142,38 @@ typedef struct subsc_rec_tag {
       *par_chan_open_inst; /* Backpointer to the channel open instance */
   struct subsc_rec_tag *prev;
   struct subsc_rec_tag *next;
+  /* Subscription index of the channel, see eds_subidx.c */
+  struct eds_subsc_idx_tag *idx;
+  struct subsc_rec_tag *idx_next;   /* Hash chain or pass all list */
+  struct subsc_rec_tag **idx_pprev; /* The pointer to this record */
+  int32_t idx_filter;               /* Indexed filter, -1 if pass all */
+  uint32_t idx_hash;
+  uint32_t idx_seq; /* Subscription order within the channel */
 } SUBSC_REC;
 
+/* The probes a publish makes in the subscription index of a channel, one
+   per filter type, position and (prefix and suffix) size in use */
+typedef struct eds_subsc_idx_key_tag {
+  SaEvtEventFilterTypeT type;
+  uint32_t pos;
+  SaSizeT len;
+  uint32_t refs; /* Subscriptions indexed on this key */
+} EDS_SUBSC_IDX_KEY;
+
+/* Subscriptions of a channel, hashed on their most selective filter */
+typedef struct eds_subsc_idx_tag {
+  SUBSC_REC **buckets;
+  uint32_t num_buckets; /* Power of two, 0 until the first subscription */
+  uint32_t num_indexed;
+  SUBSC_REC *pass_all; /* Subscriptions without a selective filter */
+  EDS_SUBSC_IDX_KEY *keys;
+  uint32_t num_keys;
+  uint32_t max_keys;
+  uint32_t next_seq;
+  SUBSC_REC **matches; /* Result of eds_subsc_idx_match() */
+  uint32_t max_matches;
+} EDS_SUBSC_IDX;
+
 typedef struct subsc_list_tag {
   SUBSC_REC *subsc_rec;
   struct subsc_list_tag *next;
@@ -204,6 +234,7 @@ typedef struct eds_worklist_tag {
 
   NCS_PATRICIA_TREE chan_open_rec; /* Channel Open record - mix of all opens *
                                     * on this channel for all reg_ids        */
+  EDS_SUBSC_IDX subsc_idx; /* All subscriptions of the channel */
   EDS_RETAINED_EVT_REC
       *ret_evt_list_head[SA_EVT_LOWEST_PRIORITY + 1]; /* priority queues head */
   EDS_RETAINED_EVT_REC
@@ -226,6 +257,15 @@ typedef struct eda_down_list_tag {
 } EDA_DOWN_LIST;
 
 /* List of current nodes in the cluster */
+/* The agents on a node that can relay events to the other agents of the
+   node, in the order they came up. The first one is the designated relay. */
+typedef struct eds_node_relay_tag {
+  NCS_PATRICIA_NODE pat_node;
+  NODE_ID node_id;
+  MDS_DEST *dests;
+  uint32_t num_dests;
+} EDS_NODE_RELAY;
+
 typedef struct node_info_tag {
   NCS_PATRICIA_NODE pat_node;
   NODE_ID node_id;
@@ -278,6 +318,8 @@ typedef struct eds_cb_tag {
   SaSelectionObjectT imm_sel_obj; /* Selection object to wait for IMM events */
   bool is_impl_set;
   bool fully_initialized;
+  bool node_fanout; /* Deliver events once per node, through a relay EDA */
+  NCS_PATRICIA_TREE node_relay_list; /* EDS_NODE_RELAY by node id */
 } EDS_CB;
 
 #define EDS_INIT_CHAN_RTINFO(wp, chan_create_time) \
@@ -326,6 +368,27 @@ uint32_t eds_remove_worklist_entry(EDS_CB *cb, uint32_t chan_id);
 
 bool eds_pattern_match(SaEvtEventPatternArrayT *, SaEvtEventFilterArrayT *);
 
+void eds_subsc_idx_add(EDS_SUBSC_IDX *, SUBSC_REC *);
+
+void eds_subsc_idx_del(SUBSC_REC *);
+
+uint32_t eds_subsc_idx_match(EDS_SUBSC_IDX *, SaEvtEventPatternArrayT *,
+                             SUBSC_REC ***);
+
+void eds_subsc_idx_destroy(EDS_SUBSC_IDX *);
+
+void eds_node_relay_add(EDS_CB *, MDS_DEST);
+
+void eds_node_relay_del(EDS_CB *, MDS_DEST);
+
+void eds_node_relay_destroy(EDS_CB *);
+
+void eds_node_fanout(EDS_CB *, EDSV_MSG *, SUBSC_REC **, uint32_t,
+                     MDS_SEND_PRIORITY_TYPE);
+
+void eds_relay_failed_deliver(EDS_CB *, MDS_DEST,
+                              EDSV_EDA_EVT_DELIVER_CBK_PARAM *);
+
 uint32_t eds_store_retained_event(EDS_CB *, EDS_WORKLIST *, CHAN_OPEN_REC *,
                                   EDSV_EDA_PUBLISH_PARAM *, SaTimeT);
 
@@ -27,6 +27,7 @@ This include file contains evt processing subroutines
 ******************************************************************************
 */
 #include <limits.h> /* for MAX_INT definition */
+#include <stdlib.h>
 #include "eds.h"
 #include "eds_ckpt.h"
 #include "base/logtrace.h"
@@ -46,6 +47,7 @@ static uint32_t eds_proc_subscribe_msg(EDS_CB *, EDSV_EDS_EVT *);
 static uint32_t eds_proc_unsubscribe_msg(EDS_CB *, EDSV_EDS_EVT *);
 static uint32_t eds_proc_retention_time_clr_msg(EDS_CB *, EDSV_EDS_EVT *);
 static uint32_t eds_proc_limit_get_msg(EDS_CB *, EDSV_EDS_EVT *);
+static uint32_t eds_proc_relay_failed_msg(EDS_CB *, EDSV_EDS_EVT *);
 
 static uint32_t eds_proc_eda_updn_mds_msg(EDSV_EDS_EVT *evt);
 static uint32_t eds_process_api_evt(EDSV_EDS_EVT *evt);
@@ -92,7 +94,8 @@ static const EDSV_EDS_EDA_API_MSG_HANDLER
 	eds_proc_subscribe_msg,
 	eds_proc_unsubscribe_msg,
 	eds_proc_retention_time_clr_msg,
-	eds_proc_limit_get_msg};
+	eds_proc_limit_get_msg,
+	eds_proc_relay_failed_msg};
 
 /* Pattern for 'LOST EVENT' event */
 SaEvtEventPatternT gl_lost_evt_pattern[1] = {
@@ -526,6 +529,8 @@ static uint32_t eds_proc_publish_msg(EDS_CB *cb, EDSV_EDS_EVT *evt)
 	EDS_WORKLIST *wp;
 	CHAN_OPEN_REC *co;
 	SUBSC_REC *subrec;
+	SUBSC_REC **matches;
+	uint32_t num_matches, i;
 	EDSV_MSG msg;
 	time_t time_of_day;
 	EDSV_EDA_PUBLISH_PARAM *publish_param;
@@ -577,56 +582,55 @@ static uint32_t eds_proc_publish_msg(EDS_CB *cb, EDSV_EDS_EVT *evt)
 	 ** this event now
 	 **/
 
-	/* Go through all chan_open_rec's under this channel */
-	co = (CHAN_OPEN_REC *)ncs_patricia_tree_getnext(&wp->chan_open_rec,
-							(uint8_t *)0);
-	while (co) {
-		subrec = co->subsc_rec_head;
-		while (subrec) { /* while subscriptions... */
-			/* Does the patterns/filters match? */
-			if (eds_pattern_match(publish_param->pattern_array,
-					      subrec->filters)) {
-
-				/* Fill in the event record to send */
-				m_EDS_EDSV_DELIVER_EVENT_CB_MSG_FILL(
-				    msg, co->reg_id, subrec->subscript_id,
-				    subrec->chan_id, subrec->chan_open_id,
-				    publish_param->pattern_array,
-				    publish_param->priority,
-				    publish_param->publisher_name, publish_time,
-				    publish_param->retention_time,
-				    publish_param->event_id,
-				    retd_evt_chan_open_id,
-				    publish_param->data_len,
-				    publish_param->data)
-
-				    /* Determine evt to MDS priority mapping */
-				    prio = edsv_map_ais_prio_to_mds_snd_prio(
-					publish_param->priority);
-
-				/* Send the event. Only once per match/per
-				 * open_id */
-				if (NCSCC_RC_SUCCESS !=
-				    (rc = eds_mds_msg_send(
-					 cb, &msg, &co->chan_opener_dest, NULL,
-					 prio))) {
-					LOG_ER(
-					    "Event Publish(MDS send) failed. From publisher dest: %" PRIx64
-					    ", To subscriber dest: %" PRIx64
-					    ",on Node_id: %u",
-					    evt->fr_dest, co->chan_opener_dest,
-					    m_NCS_NODE_ID_FROM_MDS_DEST(
-						co->chan_opener_dest));
-				}
-
-				break;
-			}
-			subrec = subrec->next;
+	/* Deliver once per channel open, to its first matching subscription */
+	num_matches = eds_subsc_idx_match(
+	    &wp->subsc_idx, publish_param->pattern_array, &matches);
+	if (num_matches == 0)
+		goto retain;
+
+	/* Determine evt to MDS priority mapping */
+	prio = edsv_map_ais_prio_to_mds_snd_prio(publish_param->priority);
+
+	/* One copy per node where an agent can relay it */
+	subrec = matches[0];
+	m_EDS_EDSV_DELIVER_EVENT_CB_MSG_FILL(
+	    msg, subrec->par_chan_open_inst->reg_id, subrec->subscript_id,
+	    subrec->chan_id, subrec->chan_open_id, publish_param->pattern_array,
+	    publish_param->priority, publish_param->publisher_name,
+	    publish_time, publish_param->retention_time,
+	    publish_param->event_id, retd_evt_chan_open_id,
+	    publish_param->data_len, publish_param->data)
+
+	eds_node_fanout(cb, &msg, matches, num_matches, prio);
+
+	for (i = 0; i < num_matches; i++) {
+		subrec = matches[i];
+		if (subrec == NULL)
+			continue; /* Sent to the relay of its node */
+		co = subrec->par_chan_open_inst;
+
+		/* Fill in the event record to send */
+		m_EDS_EDSV_DELIVER_EVENT_CB_MSG_FILL(
+		    msg, co->reg_id, subrec->subscript_id, subrec->chan_id,
+		    subrec->chan_open_id, publish_param->pattern_array,
+		    publish_param->priority, publish_param->publisher_name,
+		    publish_time, publish_param->retention_time,
+		    publish_param->event_id, retd_evt_chan_open_id,
+		    publish_param->data_len, publish_param->data)
+
+		/* Send the event */
+		if (NCSCC_RC_SUCCESS !=
+		    (rc = eds_mds_msg_send(cb, &msg, &co->chan_opener_dest,
+					   NULL, prio))) {
+			LOG_ER(
+			    "Event Publish(MDS send) failed. From publisher dest: %" PRIx64
+			    ", To subscriber dest: %" PRIx64 ",on Node_id: %u",
+			    evt->fr_dest, co->chan_opener_dest,
+			    m_NCS_NODE_ID_FROM_MDS_DEST(co->chan_opener_dest));
 		}
-		co = (CHAN_OPEN_REC *)ncs_patricia_tree_getnext(
-		    &wp->chan_open_rec, (uint8_t *)&co->copen_id_Net);
 	}
 
+retain:
 	/** If this event has been retained, send an async update &
 	 ** transfer memory ownership here.
 	 **/
@@ -920,6 +924,30 @@ static uint32_t eds_proc_limit_get_msg(EDS_CB *cb, EDSV_EDS_EVT *evt)
 	return (rc);
 }
 
+/****************************************************************************
+ * Name          : eds_proc_relay_failed_msg
+ *
+ * Description   : This is the function which is called when eds receives a
+ *                 EDSV_EDA_RELAY_FAILED message, an event the relay EDA of
+ *                 a node failed to forward to other agents of the node.
+ *
+ * Arguments     : msg  - Message that was posted to the EDS Mail box.
+ *
+ * Return Values : NCSCC_RC_SUCCESS/NCSCC_RC_FAILURE
+ *
+ * Notes         : None.
+ *****************************************************************************/
+static uint32_t eds_proc_relay_failed_msg(EDS_CB *cb, EDSV_EDS_EVT *evt)
+{
+	TRACE_ENTER2("agent dest: %" PRIx64, evt->fr_dest);
+
+	eds_relay_failed_deliver(
+	    cb, evt->fr_dest, &evt->info.msg.info.api_info.param.relay_failed);
+
+	TRACE_LEAVE();
+	return NCSCC_RC_SUCCESS;
+}
+
 /****************************************************************************
  * Name          : eds_proc_unexpected_msg
  *
@@ -1078,9 +1106,11 @@ static uint32_t eds_proc_eda_updn_mds_msg(EDSV_EDS_EVT *evt)
 	switch (evt->evt_type) {
 	case EDSV_EDS_EVT_EDA_UP:
 		TRACE("Agent UP");
+		eds_node_relay_add(cb, evt->fr_dest);
 		break;
 	case EDSV_EDS_EVT_EDA_DOWN:
 		TRACE("Agent DOWN");
+		eds_node_relay_del(cb, evt->fr_dest);
 		if ((cb->ha_state == SA_AMF_HA_ACTIVE) ||
 		    (cb->ha_state == SA_AMF_HA_QUIESCED)) {
 			/* Remove this EDA entry from our processing lists */
@@ -1296,6 +1326,7 @@ uint32_t eds_process_evt(EDSV_EDS_EVT *evt)
 			TRACE("Event processing failed");
 	} else {
 		if ((evt->evt_type == EDSV_EDS_RET_TIMER_EXP) ||
+		    (evt->evt_type == EDSV_EDS_EVT_EDA_UP) ||
 		    (evt->evt_type == EDSV_EDS_EVT_EDA_DOWN))
 			/** Invoke the evt dispatcher **/
 			eds_edsv_top_level_evt_dispatch_tbl[evt->evt_type](evt);
@@ -1351,6 +1382,19 @@ void eds_evt_destroy(EDSV_EDS_EVT *evt)
 					edsv_free_evt_filter_array(
 					    evt->info.msg.info.api_info.param
 						.subscribe.filter_array);
+			} else if (EDSV_EDA_RELAY_FAILED ==
+				   evt->info.msg.info.api_info.type) {
+				EDSV_EDA_EVT_DELIVER_CBK_PARAM *param =
+				    &evt->info.msg.info.api_info.param
+					 .relay_failed;
+
+				if (NULL != param->pattern_array)
+					edsv_free_evt_pattern_array(
+					    param->pattern_array);
+				if (NULL != param->data)
+					m_MMGR_FREE_EDSV_EVENT_DATA(
+					    param->data);
+				free(param->targets);
 			}
 		}
 	}
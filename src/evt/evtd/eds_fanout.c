@@ -0,0 +1,304 @@
+/*      -*- OpenSAF  -*-
+ *
+ * (C) Copyright 2017 The OpenSAF Foundation
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. This file and program are licensed
+ * under the GNU Lesser General Public License Version 2.1, February 1999.
+ * The complete license can be accessed from the following location:
+ * http://opensource.org/licenses/lgpl-license.php
+ * See the Copying file included with the OpenSAF distribution for full
+ * licensing terms.
+ *
+ */
+
+/*****************************************************************************
+ *                                                                            *
+ *  MODULE NAME:  eds_fanout.c                                                *
+ *                                                                            *
+ *                                                                            *
+ *  DESCRIPTION:                                                              *
+ *  Per node fan-out of published events. Instead of one copy of the event   *
+ *  per subscriber, the EDS sends one EDSV_EDS_DELIVER_EVENT_NODE message per *
+ *  node to a designated relay EDA, listing the subscriptions on that node.   *
+ *  The relay delivers to its own subscriptions and forwards a plain deliver  *
+ *  event message to the other agents of the node.                            *
+ *                                                                            *
+ *  Every agent of EDA_RELAY_SVC_PVT_VERSION or later can relay. The first   *
+ *  one up on a node is designated and stays so until it goes down, so that  *
+ *  events to a subscriber keep taking the same path and stay in order.       *
+ *  Nodes without a relay capable agent get one copy per subscriber.          *
+ *  The relay sends the event back with the subscriptions it failed to       *
+ *  forward it to, the EDS then sends it to those directly.                   *
+ *                                                                            *
+ *****************************************************************************/
+#include <stdlib.h>
+#include "eds.h"
+
+/***************************************************************************
+ *
+ * eds_node_relay_add() - Record an agent that can relay events.
+ *
+ ***************************************************************************/
+void eds_node_relay_add(EDS_CB *cb, MDS_DEST dest)
+{
+	NODE_ID node_id = m_NCS_NODE_ID_FROM_MDS_DEST(dest);
+	EDS_NODE_RELAY *nr;
+	MDS_DEST *dests;
+	uint32_t i;
+
+	nr = (EDS_NODE_RELAY *)ncs_patricia_tree_get(&cb->node_relay_list,
+						     (uint8_t *)&node_id);
+	if (nr == NULL) {
+		nr = calloc(1, sizeof(*nr));
+		if (nr == NULL) {
+			LOG_ER("calloc failed for node relay record");
+			return;
+		}
+		nr->node_id = node_id;
+		nr->pat_node.key_info = (uint8_t *)&nr->node_id;
+		if (ncs_patricia_tree_add(&cb->node_relay_list,
+					  &nr->pat_node) != NCSCC_RC_SUCCESS) {
+			LOG_ER("patricia add failed for node relay record");
+			free(nr);
+			return;
+		}
+	}
+
+	for (i = 0; i < nr->num_dests; i++) {
+		if (nr->dests[i] == dest)
+			return;
+	}
+
+	dests = realloc(nr->dests, (nr->num_dests + 1) * sizeof(*dests));
+	if (dests == NULL) {
+		LOG_ER("realloc failed for node relay record");
+		return;
+	}
+	dests[nr->num_dests++] = dest;
+	nr->dests = dests;
+
+	TRACE("Relay agent %" PRIx64 " up on node_id: %u, %u on the node",
+	      dest, node_id, nr->num_dests);
+}
+
+static void eds_node_relay_free(EDS_CB *cb, EDS_NODE_RELAY *nr)
+{
+	ncs_patricia_tree_del(&cb->node_relay_list, &nr->pat_node);
+	free(nr->dests);
+	free(nr);
+}
+
+/***************************************************************************
+ *
+ * eds_node_relay_del() - Forget an agent, the next relay capable agent on
+ *                        the node is designated if it was the relay.
+ *
+ ***************************************************************************/
+void eds_node_relay_del(EDS_CB *cb, MDS_DEST dest)
+{
+	NODE_ID node_id = m_NCS_NODE_ID_FROM_MDS_DEST(dest);
+	EDS_NODE_RELAY *nr;
+	uint32_t i;
+
+	nr = (EDS_NODE_RELAY *)ncs_patricia_tree_get(&cb->node_relay_list,
+						     (uint8_t *)&node_id);
+	if (nr == NULL)
+		return;
+
+	for (i = 0; i < nr->num_dests; i++) {
+		if (nr->dests[i] != dest)
+			continue;
+		memmove(&nr->dests[i], &nr->dests[i + 1],
+			(nr->num_dests - i - 1) * sizeof(*nr->dests));
+		nr->num_dests--;
+		TRACE("Relay agent %" PRIx64 " down on node_id: %u", dest,
+		      node_id);
+		break;
+	}
+
+	if (nr->num_dests == 0)
+		eds_node_relay_free(cb, nr);
+}
+
+/***************************************************************************
+ *
+ * eds_node_relay_destroy() - Free all node relay records.
+ *
+ ***************************************************************************/
+void eds_node_relay_destroy(EDS_CB *cb)
+{
+	EDS_NODE_RELAY *nr;
+
+	while (NULL != (nr = (EDS_NODE_RELAY *)ncs_patricia_tree_getnext(
+			    &cb->node_relay_list, (uint8_t *)0)))
+		eds_node_relay_free(cb, nr);
+}
+
+static MDS_DEST eds_subrec_dest(const SUBSC_REC *subrec)
+{
+	return subrec->par_chan_open_inst->chan_opener_dest;
+}
+
+/* Order on node, keeping the delivery order within a node */
+static int eds_fanout_cmp(const void *a, const void *b)
+{
+	SUBSC_REC *const *s1 = *(SUBSC_REC **const *)a;
+	SUBSC_REC *const *s2 = *(SUBSC_REC **const *)b;
+	NODE_ID n1 = m_NCS_NODE_ID_FROM_MDS_DEST(eds_subrec_dest(*s1));
+	NODE_ID n2 = m_NCS_NODE_ID_FROM_MDS_DEST(eds_subrec_dest(*s2));
+
+	if (n1 != n2)
+		return n1 < n2 ? -1 : 1;
+	if (s1 != s2)
+		return s1 < s2 ? -1 : 1;
+	return 0;
+}
+
+/* Send one message for the subscriptions in group[0..num-1] to the relay */
+static uint32_t eds_fanout_send(EDS_CB *cb, EDSV_MSG *msg, MDS_DEST relay,
+				SUBSC_REC ***group, uint32_t num,
+				MDS_SEND_PRIORITY_TYPE prio)
+{
+	EDSV_EDA_EVT_DELIVER_CBK_PARAM *param;
+	EDSV_EVT_DELIVER_TARGET *targets;
+	EDSV_MSG node_msg;
+	uint32_t rc;
+	uint32_t i;
+
+	targets = malloc(num * sizeof(*targets));
+	if (targets == NULL) {
+		LOG_ER("malloc failed for event delivery targets");
+		return NCSCC_RC_FAILURE;
+	}
+
+	for (i = 0; i < num; i++) {
+		SUBSC_REC *subrec = *group[i];
+
+		targets[i].dest = eds_subrec_dest(subrec);
+		targets[i].reg_id = subrec->par_chan_open_inst->reg_id;
+		targets[i].sub_id = subrec->subscript_id;
+		targets[i].chan_id = subrec->chan_id;
+		targets[i].chan_open_id = subrec->chan_open_id;
+	}
+
+	node_msg = *msg;
+	node_msg.info.cbk_info.type = EDSV_EDS_DELIVER_EVENT_NODE;
+	node_msg.info.cbk_info.eds_reg_id = targets[0].reg_id;
+	param = &node_msg.info.cbk_info.param.evt_deliver_cbk;
+	param->sub_id = targets[0].sub_id;
+	param->chan_id = targets[0].chan_id;
+	param->chan_open_id = targets[0].chan_open_id;
+	param->num_targets = num;
+	param->targets = targets;
+
+	rc = eds_mds_msg_send(cb, &node_msg, &relay, NULL, prio);
+	free(targets);
+	return rc;
+}
+
+/***************************************************************************
+ *
+ * eds_node_fanout() - Deliver an event through the relay of each node.
+ *
+ * msg holds the event to deliver, as filled in for a plain deliver event
+ * message. The matches delivered this way are set to NULL, the caller
+ * sends the rest one by one. That includes the matches of a node without
+ * a relay, and those of a node where the relay send failed.
+ *
+ ***************************************************************************/
+void eds_node_fanout(EDS_CB *cb, EDSV_MSG *msg, SUBSC_REC **matches,
+		     uint32_t num_matches, MDS_SEND_PRIORITY_TYPE prio)
+{
+	SUBSC_REC ***order;
+	uint32_t i, j, k;
+
+	if (!cb->node_fanout || num_matches == 0 ||
+	    ncs_patricia_tree_size(&cb->node_relay_list) == 0)
+		return;
+
+	order = malloc(num_matches * sizeof(*order));
+	if (order == NULL) {
+		LOG_ER("malloc failed for node fan-out");
+		return;
+	}
+	for (i = 0; i < num_matches; i++)
+		order[i] = &matches[i];
+	qsort(order, num_matches, sizeof(*order), eds_fanout_cmp);
+
+	for (i = 0; i < num_matches; i = j) {
+		NODE_ID node_id =
+		    m_NCS_NODE_ID_FROM_MDS_DEST(eds_subrec_dest(*order[i]));
+		EDS_NODE_RELAY *nr;
+
+		for (j = i + 1; j < num_matches; j++) {
+			if (m_NCS_NODE_ID_FROM_MDS_DEST(eds_subrec_dest(
+				*order[j])) != node_id)
+				break;
+		}
+
+		nr = (EDS_NODE_RELAY *)ncs_patricia_tree_get(
+		    &cb->node_relay_list, (uint8_t *)&node_id);
+		if (nr == NULL)
+			continue;
+
+		/* The relay itself is the only subscriber, send it as is */
+		if (j - i == 1 && eds_subrec_dest(*order[i]) == nr->dests[0])
+			continue;
+
+		if (eds_fanout_send(cb, msg, nr->dests[0], &order[i], j - i,
+				    prio) != NCSCC_RC_SUCCESS)
+			continue;
+
+		for (k = i; k < j; k++)
+			*order[k] = NULL;
+	}
+
+	free(order);
+}
+
+/***************************************************************************
+ *
+ * eds_relay_failed_deliver() - Deliver an event directly to the targets the
+ *                              relay EDA of a node failed to forward it to.
+ *
+ * Only the targets on the node of the relay are delivered to.
+ *
+ ***************************************************************************/
+void eds_relay_failed_deliver(EDS_CB *cb, MDS_DEST relay,
+			      EDSV_EDA_EVT_DELIVER_CBK_PARAM *param)
+{
+	NODE_ID node_id = m_NCS_NODE_ID_FROM_MDS_DEST(relay);
+	MDS_SEND_PRIORITY_TYPE prio;
+	EDSV_EVT_DELIVER_TARGET *t;
+	EDSV_MSG msg;
+	uint32_t i;
+
+	if (param->pattern_array == NULL)
+		return;
+
+	prio = edsv_map_ais_prio_to_mds_snd_prio(param->priority);
+	for (i = 0; i < param->num_targets; i++) {
+		t = &param->targets[i];
+		if (m_NCS_NODE_ID_FROM_MDS_DEST(t->dest) != node_id) {
+			LOG_WA("Relay %" PRIx64 " returned an event for "
+			       "another node, dest: %" PRIx64,
+			       relay, t->dest);
+			continue;
+		}
+
+		m_EDS_EDSV_DELIVER_EVENT_CB_MSG_FILL(
+		    msg, t->reg_id, t->sub_id, t->chan_id, t->chan_open_id,
+		    param->pattern_array, param->priority,
+		    param->publisher_name, param->publish_time,
+		    param->retention_time, param->eda_event_id,
+		    param->ret_evt_ch_oid, param->data_len, param->data)
+
+		if (eds_mds_msg_send(cb, &msg, &t->dest, NULL, prio) !=
+		    NCSCC_RC_SUCCESS)
+			LOG_ER("Event deliver (MDS send) failed. To "
+			       "subscriber dest: %" PRIx64,
+			       t->dest);
+	}
+}
@@ -228,6 +228,8 @@ static void eds_remove_subrec_entry(EDS_CB *cb, SUBSC_REC **subrec)
 	TRACE("chan_id: %u, chan_open_id: %u, subscription id: %u", p->chan_id,
 	      p->chan_open_id, p->subscript_id);
 
+	eds_subsc_idx_del(p);
+
 	if (p->prev == NULL) {		      /* Top entry */
 		if (p->next != NULL) {	/* It's not the only element */
 			p->next->prev = NULL; /* Clear prev pointer */
@@ -319,6 +321,8 @@ static uint32_t eds_add_subscription_to_worklist(EDS_CB *cb, SUBSC_REC *subrec)
 
 			/* Add it! */
 			rs = eds_add_subrec_entry(co, subrec);
+			if (rs == NCSCC_RC_SUCCESS)
+				eds_subsc_idx_add(&wp->subsc_idx, subrec);
 			TRACE_LEAVE();
 			return (rs);
 		}
@@ -483,6 +487,7 @@ uint32_t eds_remove_worklist_entry(EDS_CB *cb, uint32_t chan_id)
 				/* Destroy the patricia tree for channel open
 				 * recs */
 				ncs_patricia_tree_destroy(&wp->chan_open_rec);
+				eds_subsc_idx_destroy(&wp->subsc_idx);
 				m_NCS_UNLOCK(&cb->cb_lock, NCS_LOCK_WRITE);
 				m_MMGR_FREE_EDS_CHAN_NAME(
 				    wp->cname); /* free channelName */
@@ -506,6 +511,7 @@ uint32_t eds_remove_worklist_entry(EDS_CB *cb, uint32_t chan_id)
 				/* Destroy the patricia tree for channel open
 				 * recs */
 				ncs_patricia_tree_destroy(&wp->chan_open_rec);
+				eds_subsc_idx_destroy(&wp->subsc_idx);
 				m_NCS_UNLOCK(&cb->cb_lock, NCS_LOCK_WRITE);
 				m_MMGR_FREE_EDS_CHAN_NAME(wp->cname);
 				m_MMGR_FREE_EDS_WORKLIST(
@@ -530,6 +536,7 @@ uint32_t eds_remove_worklist_entry(EDS_CB *cb, uint32_t chan_id)
 				/* Destroy the patricia tree for channel open
 				 * recs */
 				ncs_patricia_tree_destroy(&wp->chan_open_rec);
+				eds_subsc_idx_destroy(&wp->subsc_idx);
 				m_NCS_UNLOCK(&cb->cb_lock, NCS_LOCK_WRITE);
 				m_MMGR_FREE_EDS_CHAN_NAME(wp->cname);
 				m_MMGR_FREE_EDS_WORKLIST(
@@ -945,6 +952,7 @@ static void eds_del_work_list(EDS_CB *cb, EDS_WORKLIST **p_work_list)
 		** erased
 		**/
 		ncs_patricia_tree_destroy(&work_list->chan_open_rec);
+		eds_subsc_idx_destroy(&work_list->subsc_idx);
 
 		/* free channelName */
 		m_MMGR_FREE_EDS_CHAN_NAME(work_list->cname);
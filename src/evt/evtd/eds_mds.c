@@ -810,138 +810,6 @@ static uint32_t eds_enc_chan_open_cbk_msg(NCS_UBAID *uba, EDSV_MSG *msg)
 	return total_bytes;
 }
 
-/****************************************************************************
-  Name          : eds_enc_delv_evt_cbk_msg
-
-  Description   : This routine encodes an event callback msg
-
-  Arguments     : NCS_UBAID *msg,
-		  EDSV_MSG *msg
-
-  Return Values : uns32
-
-  Notes         : None.
-******************************************************************************/
-static uint32_t eds_enc_delv_evt_cbk_msg(NCS_UBAID *uba, EDSV_MSG *msg)
-{
-	uint8_t *p8;
-	uint32_t x;
-	uint32_t total_bytes = 0;
-	SaEvtEventPatternT *pattern_ptr;
-	EDSV_EDA_EVT_DELIVER_CBK_PARAM *param =
-	    &msg->info.cbk_info.param.evt_deliver_cbk;
-
-	if (uba == NULL) {
-		TRACE_4("uba is NULL");
-		return 0;
-	}
-
-	/* type, reg_id, sub_id, chan_id, chan_open_id */
-	p8 = ncs_enc_reserve_space(uba, 12);
-	if (!p8) {
-		LOG_WA("encode reserve space failed");
-	}
-	ncs_encode_32bit(&p8, param->sub_id);
-	ncs_encode_32bit(&p8, param->chan_id);
-	ncs_encode_32bit(&p8, param->chan_open_id);
-	ncs_enc_claim_space(uba, 12);
-	total_bytes += 12;
-
-	/* Encode the patterns */
-
-	/* patternsNumber */
-	p8 = ncs_enc_reserve_space(uba, 8);
-	if (!p8) {
-		LOG_WA("encode reserve space failed");
-	}
-	ncs_encode_64bit(&p8, param->pattern_array->patternsNumber);
-	ncs_enc_claim_space(uba, 8);
-	total_bytes += 8;
-
-	/* patterns */
-	pattern_ptr = param->pattern_array->patterns;
-	for (x = 0; x < param->pattern_array->patternsNumber; x++) {
-		/* Save room for the patternSize field (8 bytes) */
-		p8 = ncs_enc_reserve_space(uba, 8);
-		if (!p8) {
-			LOG_WA("encode reserve space failed");
-		}
-		ncs_encode_64bit(&p8, pattern_ptr->patternSize);
-		ncs_enc_claim_space(uba, 8);
-		total_bytes += 8;
-
-		/* For zero length patterns, fake encode zero */
-		if (pattern_ptr->patternSize == 0) {
-			p8 = ncs_enc_reserve_space(uba, 4);
-			if (!p8) {
-				LOG_WA("encode reserve space failed");
-			}
-			ncs_encode_32bit(&p8, 0);
-			ncs_enc_claim_space(uba, 4);
-			total_bytes += 4;
-		} else {
-			ncs_encode_n_octets_in_uba(
-			    uba, pattern_ptr->pattern,
-			    (uint32_t)pattern_ptr->patternSize);
-			total_bytes += (uint32_t)pattern_ptr->patternSize;
-		}
-		pattern_ptr++;
-	}
-
-	/* priority */
-	p8 = ncs_enc_reserve_space(uba, 1);
-	if (!p8) {
-		LOG_WA("encode reserve space failed");
-	}
-	ncs_encode_8bit(&p8, param->priority);
-	ncs_enc_claim_space(uba, 1);
-	total_bytes += 1;
-
-	/* publisher name length */
-	p8 = ncs_enc_reserve_space(uba, 2);
-	if (!p8) {
-		LOG_WA("encode reserve space failed");
-	}
-	ncs_encode_16bit(&p8, param->publisher_name.length);
-	ncs_enc_claim_space(uba, 2);
-	total_bytes += 2;
-
-	/* publisher name */
-	ncs_encode_n_octets_in_uba(uba, param->publisher_name.value,
-				   (uint32_t)param->publisher_name.length);
-	total_bytes += (uint32_t)param->publisher_name.length;
-
-	/* publish_time,  eda_event_id */
-	p8 = ncs_enc_reserve_space(uba, 24);
-	if (!p8) {
-		LOG_WA("encode reserve space failed");
-	}
-	ncs_encode_64bit(&p8, param->publish_time);
-	ncs_encode_64bit(&p8, param->retention_time);
-	ncs_encode_32bit(&p8, (uint32_t)param->eda_event_id);
-	/* event_hdl is skipped purposely */
-	ncs_encode_32bit(&p8, (uint32_t)param->ret_evt_ch_oid);
-	ncs_enc_claim_space(uba, 24);
-	total_bytes += 24;
-
-	/* Encode the data */
-
-	/* data_len */
-	p8 = ncs_enc_reserve_space(uba, 8);
-	if (!p8) {
-		LOG_WA("encode reserve space failed");
-	}
-	ncs_encode_64bit(&p8, param->data_len);
-	ncs_enc_claim_space(uba, 8);
-	total_bytes += 8;
-
-	/* data */
-	ncs_encode_n_octets_in_uba(uba, param->data, (uint32_t)param->data_len);
-	total_bytes += (uint32_t)param->data_len;
-
-	return total_bytes;
-}
-
 static uint32_t eds_enc_clm_status_cbk_msg(NCS_UBAID *uba, EDSV_MSG *msg)
 {
 	uint8_t *p8;
@@ -1090,7 +958,14 @@ static uint32_t eds_mds_enc(struct ncsmds_callback_info *info)
 			total_bytes += eds_enc_chan_open_cbk_msg(uba, msg);
 			break;
 		case EDSV_EDS_DELIVER_EVENT:
-			total_bytes += eds_enc_delv_evt_cbk_msg(uba, msg);
+			total_bytes += edsv_enc_delv_evt_cbk_msg(
+			    uba, &msg->info.cbk_info.param.evt_deliver_cbk);
+			break;
+		case EDSV_EDS_DELIVER_EVENT_NODE:
+			total_bytes += edsv_enc_delv_targets(
+			    uba, &msg->info.cbk_info.param.evt_deliver_cbk);
+			total_bytes += edsv_enc_delv_evt_cbk_msg(
+			    uba, &msg->info.cbk_info.param.evt_deliver_cbk);
 			break;
 		case EDSV_EDS_CLMNODE_STATUS:
 			total_bytes += eds_enc_clm_status_cbk_msg(uba, msg);
@@ -1214,6 +1089,13 @@ static uint32_t eds_mds_dec(struct ncsmds_callback_info *info)
 		case EDSV_EDA_LIMIT_GET:
 			/* Nothing to be decoded here */
 			break;
+		case EDSV_EDA_RELAY_FAILED:
+			msg = &evt->info.msg;
+			total_bytes += edsv_dec_delv_targets(
+			    uba, &msg->info.api_info.param.relay_failed);
+			total_bytes += edsv_dec_delv_evt_cbk_msg(
+			    uba, &msg->info.api_info.param.relay_failed);
+			break;
 		default:
 			LOG_ER("MDS Decode: Invalid API message type: %u",
 			       evt->info.msg.info.api_info.type);
@@ -1375,7 +1257,12 @@ static uint32_t eds_mds_svc_event(struct ncsmds_callback_info *info)
 
 	/* If this evt was sent from EDA act on this */
 	if (info->info.svc_evt.i_svc_id == NCSMDS_SVC_ID_EDA) {
-		if (info->info.svc_evt.i_change == NCSMDS_DOWN) {
+		/* An EDA coming up is only of interest if it can relay events
+		 * on its node */
+		if (info->info.svc_evt.i_change == NCSMDS_DOWN ||
+		    (info->info.svc_evt.i_change == NCSMDS_UP &&
+		     info->info.svc_evt.i_rem_svc_pvt_ver >=
+			 EDA_RELAY_SVC_PVT_VERSION)) {
 			/* As of now we are only interested in EDA events */
 			if (NULL == (evt = m_MMGR_ALLOC_EDSV_EDS_EVT)) {
 				LOG_CR("malloc failed for EDS event");
@@ -1383,7 +1270,10 @@ static uint32_t eds_mds_svc_event(struct ncsmds_callback_info *info)
 			}
 
 			memset(evt, '\0', sizeof(EDSV_EDS_EVT));
-			evt->evt_type = EDSV_EDS_EVT_EDA_DOWN;
+			evt->evt_type =
+			    (info->info.svc_evt.i_change == NCSMDS_DOWN)
+				? EDSV_EDS_EVT_EDA_DOWN
+				: EDSV_EDS_EVT_EDA_UP;
 
 			/** Initialize the Event Header **/
 			evt->cb_hdl = eds_cb_hdl;
@@ -1401,7 +1291,7 @@ static uint32_t eds_mds_svc_event(struct ncsmds_callback_info *info)
 					   NCS_IPC_PRIORITY_NORMAL) ==
 			    NCSCC_RC_FAILURE) {
 				LOG_WA(
-				    "Mailbox IPC send failed for eda_down event, from node_id: %u",
+				    "Mailbox IPC send failed for eda up/down event, from node_id: %u",
 				    evt->info.mds_info.node_id);
 				eds_evt_destroy(evt);
 				goto give_hdl;
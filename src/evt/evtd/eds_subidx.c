@@ -0,0 +1,389 @@
+/*      -*- OpenSAF  -*-
+ *
+ * (C) Copyright 2017 The OpenSAF Foundation
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. This file and program are licensed
+ * under the GNU Lesser General Public License Version 2.1, February 1999.
+ * The complete license can be accessed from the following location:
+ * http://opensource.org/licenses/lgpl-license.php
+ * See the Copying file included with the OpenSAF distribution for full
+ * licensing terms.
+ *
+ */
+
+/*****************************************************************************
+ *                                                                            *
+ *  MODULE NAME:  eds_subidx.c                                                *
+ *                                                                            *
+ *                                                                            *
+ *  DESCRIPTION:                                                              *
+ *  Subscription index of a channel. Every subscription is hashed on one of   *
+ *  its filters: the first exact filter, else the longest non empty prefix    *
+ *  or suffix filter. Subscriptions with neither are kept on a pass all list. *
+ *  A publish hashes the matching slice of its patterns once per filter type, *
+ *  position and size in use on the channel, and only the subscriptions       *
+ *  found that way are run through eds_pattern_match().                       *
+ *                                                                            *
+ *****************************************************************************/
+#include <stdlib.h>
+#include "eds.h"
+
+#define EDS_SUBSC_IDX_MIN_BUCKETS 64
+
+/* Same pattern as eds_pattern_match() compares with filter number pos */
+static const SaEvtEventPatternT *idx_pattern_at(SaEvtEventPatternArrayT *pa,
+						uint32_t pos)
+{
+	static const SaEvtEventPatternT empty = {0, 0, NULL};
+
+	if (pa->patterns == NULL)
+		return &empty;
+	if (pos == 0 || pos < pa->patternsNumber)
+		return &pa->patterns[pos];
+	return &empty;
+}
+
+static uint32_t idx_hash(SaEvtEventFilterTypeT type, uint32_t pos,
+			 const SaUint8T *p, SaSizeT len)
+{
+	uint32_t h = 2166136261u;
+	SaSizeT i;
+
+	h = (h ^ (uint32_t)type) * 16777619u;
+	h = (h ^ pos) * 16777619u;
+	for (i = 0; i < len; i++)
+		h = (h ^ p[i]) * 16777619u;
+	return h;
+}
+
+/* The bytes a filter is hashed on, and the key length stored for them */
+static const SaUint8T *idx_filter_key(SaEvtEventFilterT *f, SaSizeT *len,
+				      SaSizeT *key_len)
+{
+	*len = f->filter.patternSize;
+	if (f->filterType == SA_EVT_EXACT_FILTER) {
+		*key_len = 0;
+		return f->filter.pattern;
+	}
+	*key_len = f->filter.patternSize;
+	return f->filter.pattern;
+}
+
+/* The filter to index a subscription on, -1 for the pass all list */
+static int32_t idx_pick_filter(SaEvtEventFilterArrayT *fa)
+{
+	int32_t best = -1;
+	SaSizeT best_len = 0;
+	uint32_t i;
+
+	if (fa == NULL)
+		return -1;
+
+	for (i = 0; i < fa->filtersNumber; i++) {
+		SaEvtEventFilterT *f = &fa->filters[i];
+
+		if (f->filterType == SA_EVT_EXACT_FILTER)
+			return (int32_t)i;
+		if ((f->filterType == SA_EVT_PREFIX_FILTER ||
+		     f->filterType == SA_EVT_SUFFIX_FILTER) &&
+		    f->filter.patternSize > best_len) {
+			best = (int32_t)i;
+			best_len = f->filter.patternSize;
+		}
+	}
+	return best;
+}
+
+static bool idx_key_ref(EDS_SUBSC_IDX *idx, SaEvtEventFilterTypeT type,
+			uint32_t pos, SaSizeT len)
+{
+	EDS_SUBSC_IDX_KEY *k;
+	uint32_t i;
+
+	for (i = 0; i < idx->num_keys; i++) {
+		k = &idx->keys[i];
+		if (k->type == type && k->pos == pos && k->len == len) {
+			k->refs++;
+			return true;
+		}
+	}
+
+	if (idx->num_keys == idx->max_keys) {
+		uint32_t max = idx->max_keys ? idx->max_keys * 2 : 4;
+
+		k = realloc(idx->keys, max * sizeof(*k));
+		if (k == NULL)
+			return false;
+		idx->keys = k;
+		idx->max_keys = max;
+	}
+
+	k = &idx->keys[idx->num_keys++];
+	k->type = type;
+	k->pos = pos;
+	k->len = len;
+	k->refs = 1;
+	return true;
+}
+
+static void idx_key_unref(EDS_SUBSC_IDX *idx, SaEvtEventFilterTypeT type,
+			  uint32_t pos, SaSizeT len)
+{
+	uint32_t i;
+
+	for (i = 0; i < idx->num_keys; i++) {
+		EDS_SUBSC_IDX_KEY *k = &idx->keys[i];
+
+		if (k->type == type && k->pos == pos && k->len == len) {
+			if (--k->refs == 0)
+				*k = idx->keys[--idx->num_keys];
+			return;
+		}
+	}
+}
+
+static void idx_link(SUBSC_REC **head, SUBSC_REC *subrec)
+{
+	subrec->idx_next = *head;
+	if (*head != NULL)
+		(*head)->idx_pprev = &subrec->idx_next;
+	subrec->idx_pprev = head;
+	*head = subrec;
+}
+
+static void idx_unlink(SUBSC_REC *subrec)
+{
+	*subrec->idx_pprev = subrec->idx_next;
+	if (subrec->idx_next != NULL)
+		subrec->idx_next->idx_pprev = subrec->idx_pprev;
+	subrec->idx_next = NULL;
+	subrec->idx_pprev = NULL;
+}
+
+/* Double the bucket array once it holds more subscriptions than buckets */
+static void idx_grow(EDS_SUBSC_IDX *idx)
+{
+	uint32_t num = idx->num_buckets ? idx->num_buckets * 2
+					: EDS_SUBSC_IDX_MIN_BUCKETS;
+	SUBSC_REC **buckets;
+	uint32_t i;
+
+	buckets = calloc(num, sizeof(*buckets));
+	if (buckets == NULL)
+		return; /* Keep the old array, only the chains get longer */
+
+	for (i = 0; i < idx->num_buckets; i++) {
+		while (idx->buckets[i] != NULL) {
+			SUBSC_REC *s = idx->buckets[i];
+
+			idx_unlink(s);
+			idx_link(&buckets[s->idx_hash & (num - 1)], s);
+		}
+	}
+	free(idx->buckets);
+	idx->buckets = buckets;
+	idx->num_buckets = num;
+}
+
+/***************************************************************************
+ *
+ * eds_subsc_idx_add() - Add a subscription to the index of its channel.
+ *
+ * A subscription that cannot be hashed, or when memory is short, goes to
+ * the pass all list and is still matched on every publish.
+ *
+ ***************************************************************************/
+void eds_subsc_idx_add(EDS_SUBSC_IDX *idx, SUBSC_REC *subrec)
+{
+	SaEvtEventFilterT *f;
+	const SaUint8T *p;
+	SaSizeT len, key_len;
+	int32_t fx;
+
+	subrec->idx = idx;
+	subrec->idx_seq = idx->next_seq++;
+	subrec->idx_filter = -1;
+
+	fx = idx_pick_filter(subrec->filters);
+	if (fx >= 0 && idx->num_indexed >= idx->num_buckets)
+		idx_grow(idx);
+
+	if (fx < 0 || idx->num_buckets == 0) {
+		idx_link(&idx->pass_all, subrec);
+		return;
+	}
+
+	f = &subrec->filters->filters[fx];
+	p = idx_filter_key(f, &len, &key_len);
+	if (!idx_key_ref(idx, f->filterType, (uint32_t)fx, key_len)) {
+		idx_link(&idx->pass_all, subrec);
+		return;
+	}
+
+	subrec->idx_filter = fx;
+	subrec->idx_hash = idx_hash(f->filterType, (uint32_t)fx, p, len);
+	idx_link(&idx->buckets[subrec->idx_hash & (idx->num_buckets - 1)],
+		 subrec);
+	idx->num_indexed++;
+}
+
+/***************************************************************************
+ *
+ * eds_subsc_idx_del() - Remove a subscription from the index, if in one.
+ *
+ ***************************************************************************/
+void eds_subsc_idx_del(SUBSC_REC *subrec)
+{
+	EDS_SUBSC_IDX *idx = subrec->idx;
+	SaEvtEventFilterT *f;
+	SaSizeT len, key_len;
+
+	if (idx == NULL)
+		return;
+
+	idx_unlink(subrec);
+	if (subrec->idx_filter >= 0) {
+		f = &subrec->filters->filters[subrec->idx_filter];
+		idx_filter_key(f, &len, &key_len);
+		idx_key_unref(idx, f->filterType, (uint32_t)subrec->idx_filter,
+			      key_len);
+		idx->num_indexed--;
+	}
+	subrec->idx = NULL;
+}
+
+static bool idx_add_match(EDS_SUBSC_IDX *idx, uint32_t *num,
+			  SUBSC_REC *subrec)
+{
+	if (*num == idx->max_matches) {
+		uint32_t max = idx->max_matches ? idx->max_matches * 2 : 16;
+		SUBSC_REC **m = realloc(idx->matches, max * sizeof(*m));
+
+		if (m == NULL)
+			return false;
+		idx->matches = m;
+		idx->max_matches = max;
+	}
+	idx->matches[(*num)++] = subrec;
+	return true;
+}
+
+static int idx_match_cmp(const void *a, const void *b)
+{
+	const SUBSC_REC *s1 = *(SUBSC_REC *const *)a;
+	const SUBSC_REC *s2 = *(SUBSC_REC *const *)b;
+	uint32_t c1 = s1->par_chan_open_inst->chan_open_id;
+	uint32_t c2 = s2->par_chan_open_inst->chan_open_id;
+
+	if (c1 != c2)
+		return c1 < c2 ? -1 : 1;
+	if (s1->idx_seq != s2->idx_seq)
+		return s1->idx_seq < s2->idx_seq ? -1 : 1;
+	return 0;
+}
+
+/* Candidates from one probe of the hash table */
+static bool idx_probe(EDS_SUBSC_IDX *idx, EDS_SUBSC_IDX_KEY *k,
+		      SaEvtEventPatternArrayT *pa, uint32_t *num)
+{
+	const SaEvtEventPatternT *pat = idx_pattern_at(pa, k->pos);
+	const SaUint8T *p = pat->pattern;
+	SaSizeT len = k->len;
+	SUBSC_REC *s;
+	uint32_t h;
+
+	if (k->type == SA_EVT_EXACT_FILTER) {
+		len = pat->patternSize;
+	} else {
+		if (pat->patternSize < len)
+			return true;
+		if (k->type == SA_EVT_SUFFIX_FILTER)
+			p += pat->patternSize - len;
+	}
+	if (len != 0 && p == NULL)
+		return true;
+
+	h = idx_hash(k->type, k->pos, p, len);
+	for (s = idx->buckets[h & (idx->num_buckets - 1)]; s != NULL;
+	     s = s->idx_next) {
+		SaEvtEventFilterT *f;
+
+		if (s->idx_hash != h || (uint32_t)s->idx_filter != k->pos)
+			continue;
+		f = &s->filters->filters[s->idx_filter];
+		if (f->filterType != k->type || f->filter.patternSize != len)
+			continue;
+		if (len != 0 && memcmp(f->filter.pattern, p, len) != 0)
+			continue;
+		if (eds_pattern_match(pa, s->filters) &&
+		    !idx_add_match(idx, num, s))
+			return false;
+	}
+	return true;
+}
+
+/***************************************************************************
+ *
+ * eds_subsc_idx_match() - Find the subscriptions an event is delivered to.
+ *
+ * Returns the number of subscriptions in *o_matches, at most one per
+ * channel open and the first matching one in subscription order, sorted on
+ * channel open id. That is the set and order the linear scan of all
+ * channel opens used to produce. The array is owned by the index and is
+ * valid until the next call.
+ *
+ ***************************************************************************/
+uint32_t eds_subsc_idx_match(EDS_SUBSC_IDX *idx, SaEvtEventPatternArrayT *pa,
+			     SUBSC_REC ***o_matches)
+{
+	uint32_t num = 0;
+	uint32_t i, n;
+	SUBSC_REC *s;
+
+	*o_matches = idx->matches;
+	if (pa == NULL)
+		return 0;
+
+	for (s = idx->pass_all; s != NULL; s = s->idx_next) {
+		if (eds_pattern_match(pa, s->filters) &&
+		    !idx_add_match(idx, &num, s))
+			goto done;
+	}
+
+	for (i = 0; i < idx->num_keys; i++) {
+		if (!idx_probe(idx, &idx->keys[i], pa, &num)) {
+			LOG_ER("Out of memory matching subscriptions");
+			break;
+		}
+	}
+
+done:
+	if (num > 1)
+		qsort(idx->matches, num, sizeof(*idx->matches), idx_match_cmp);
+
+	/* Keep the first subscription of each channel open */
+	for (i = 0, n = 0; i < num; i++) {
+		if (n > 0 && idx->matches[n - 1]->par_chan_open_inst ==
+				 idx->matches[i]->par_chan_open_inst)
+			continue;
+		idx->matches[n++] = idx->matches[i];
+	}
+
+	*o_matches = idx->matches;
+	return n;
+}
+
+/***************************************************************************
+ *
+ * eds_subsc_idx_destroy() - Free the index of a channel being deleted.
+ *
+ ***************************************************************************/
+void eds_subsc_idx_destroy(EDS_SUBSC_IDX *idx)
+{
+	free(idx->buckets);
+	free(idx->keys);
+	free(idx->matches);
+	memset(idx, 0, sizeof(*idx));
+}
@@ -61,6 +61,12 @@ bool eds_pattern_match(SaEvtEventPatternArrayT *patternArray,
 			if ((pattern->patternSize == 0) &&
 			    (filter->filter.patternSize != 0))
 				return (false);
+
+			/* Pattern must be at least as long as filter for a
+			 * match */
+			if (pattern->patternSize < filter->filter.patternSize)
+				return (false);
+
 			if (memcmp(filter->filter.pattern, pattern->pattern,
 				   (size_t)filter->filter.patternSize) != 0)
 				return (false); /* No match */
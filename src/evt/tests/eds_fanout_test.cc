@@ -0,0 +1,239 @@
+/*      -*- OpenSAF  -*-
+ *
+ * (C) Copyright 2017 The OpenSAF Foundation
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. This file and program are licensed
+ * under the GNU Lesser General Public License Version 2.1, February 1999.
+ * The complete license can be accessed from the following location:
+ * http://opensource.org/licenses/lgpl-license.php
+ * See the Copying file included with the OpenSAF distribution for full
+ * licensing terms.
+ *
+ */
+
+#include <cstring>
+#include <memory>
+#include <vector>
+#include "base/ncs_mda_pvt.h"
+#include "evt/tests/mock_eds_mds.h"
+#include "gtest/gtest.h"
+
+namespace {
+
+MDS_DEST Dest(uint32_t node_id, uint32_t n) {
+  return (static_cast<MDS_DEST>(node_id) << 32) | n;
+}
+
+// The per node fan-out of events through a relay agent, and the direct
+// sends the EDS falls back to
+class EdsFanoutTest : public ::testing::Test {
+ protected:
+  virtual void SetUp() {
+    NCS_PATRICIA_PARAMS params;
+    memset(&params, 0, sizeof(params));
+    params.key_size = sizeof(NODE_ID);
+    memset(&cb_, 0, sizeof(cb_));
+    ASSERT_EQ(ncs_patricia_tree_init(&cb_.node_relay_list, &params),
+              NCSCC_RC_SUCCESS);
+    cb_.node_fanout = true;
+    mock_eds_sends.clear();
+    mock_eds_send_rc = NCSCC_RC_SUCCESS;
+    memset(&msg_, 0, sizeof(msg_));
+    msg_.type = EDSV_EDS_CBK_MSG;
+    msg_.info.cbk_info.type = EDSV_EDS_DELIVER_EVENT;
+  }
+
+  virtual void TearDown() {
+    eds_node_relay_destroy(&cb_);
+    ncs_patricia_tree_destroy(&cb_.node_relay_list);
+  }
+
+  // A subscription of the agent at dest
+  SUBSC_REC *Subscription(MDS_DEST dest, uint32_t sub_id) {
+    CHAN_OPEN_REC *co = new CHAN_OPEN_REC();
+    co->chan_opener_dest = dest;
+    co->reg_id = sub_id * 10;
+    co->chan_id = 1;
+    co->chan_open_id = sub_id;
+    opens_.emplace_back(co);
+    SUBSC_REC *sub = new SUBSC_REC();
+    sub->subscript_id = sub_id;
+    sub->chan_id = 1;
+    sub->chan_open_id = sub_id;
+    sub->par_chan_open_inst = co;
+    subs_.emplace_back(sub);
+    return sub;
+  }
+
+  void Fanout(std::vector<SUBSC_REC *> *matches) {
+    eds_node_fanout(&cb_, &msg_, matches->data(), matches->size(),
+                    MDS_SEND_PRIORITY_MEDIUM);
+  }
+
+  EDS_CB cb_;
+  EDSV_MSG msg_;
+  std::vector<std::unique_ptr<CHAN_OPEN_REC>> opens_;
+  std::vector<std::unique_ptr<SUBSC_REC>> subs_;
+};
+
+TEST_F(EdsFanoutTest, OneMessagePerNodeWithARelay) {
+  eds_node_relay_add(&cb_, Dest(1, 1));
+  eds_node_relay_add(&cb_, Dest(1, 2));
+  SUBSC_REC *a = Subscription(Dest(1, 1), 1);
+  SUBSC_REC *b = Subscription(Dest(1, 2), 2);
+  SUBSC_REC *c = Subscription(Dest(2, 1), 3);
+  SUBSC_REC *d = Subscription(Dest(1, 3), 4);
+  std::vector<SUBSC_REC *> matches = {a, b, c, d};
+  Fanout(&matches);
+
+  // The first agent up on node 1 relays to all subscriptions of the node,
+  // in the order matched. Node 2 has no relay, it gets direct sends.
+  ASSERT_EQ(mock_eds_sends.size(), 1u);
+  EXPECT_EQ(mock_eds_sends[0].dest, Dest(1, 1));
+  EXPECT_EQ(mock_eds_sends[0].type, EDSV_EDS_DELIVER_EVENT_NODE);
+  ASSERT_EQ(mock_eds_sends[0].targets.size(), 3u);
+  EXPECT_EQ(mock_eds_sends[0].targets[0].dest, Dest(1, 1));
+  EXPECT_EQ(mock_eds_sends[0].targets[0].sub_id, 1u);
+  EXPECT_EQ(mock_eds_sends[0].targets[1].dest, Dest(1, 2));
+  EXPECT_EQ(mock_eds_sends[0].targets[1].reg_id, 20u);
+  EXPECT_EQ(mock_eds_sends[0].targets[2].dest, Dest(1, 3));
+  EXPECT_EQ(mock_eds_sends[0].targets[2].chan_open_id, 4u);
+  EXPECT_EQ(matches, std::vector<SUBSC_REC *>({nullptr, nullptr, c, nullptr}));
+}
+
+TEST_F(EdsFanoutTest, RelayAloneIsSentDirectly) {
+  eds_node_relay_add(&cb_, Dest(1, 1));
+  SUBSC_REC *a = Subscription(Dest(1, 1), 1);
+  std::vector<SUBSC_REC *> matches = {a};
+  Fanout(&matches);
+  EXPECT_TRUE(mock_eds_sends.empty());
+  EXPECT_EQ(matches[0], a);
+}
+
+TEST_F(EdsFanoutTest, NextAgentRelaysWhenTheRelayIsDown) {
+  eds_node_relay_add(&cb_, Dest(1, 1));
+  eds_node_relay_add(&cb_, Dest(1, 2));
+  eds_node_relay_add(&cb_, Dest(1, 3));
+  eds_node_relay_del(&cb_, Dest(1, 1));
+  std::vector<SUBSC_REC *> matches = {Subscription(Dest(1, 2), 1),
+                                      Subscription(Dest(1, 3), 2)};
+  Fanout(&matches);
+  ASSERT_EQ(mock_eds_sends.size(), 1u);
+  EXPECT_EQ(mock_eds_sends[0].dest, Dest(1, 2));
+
+  // No relay left on the node
+  eds_node_relay_del(&cb_, Dest(1, 2));
+  eds_node_relay_del(&cb_, Dest(1, 3));
+  mock_eds_sends.clear();
+  matches = {Subscription(Dest(1, 4), 3), Subscription(Dest(1, 5), 4)};
+  Fanout(&matches);
+  EXPECT_TRUE(mock_eds_sends.empty());
+  EXPECT_NE(matches[0], nullptr);
+  EXPECT_NE(matches[1], nullptr);
+}
+
+TEST_F(EdsFanoutTest, DirectSendsWhenTheRelaySendFails) {
+  eds_node_relay_add(&cb_, Dest(1, 1));
+  SUBSC_REC *a = Subscription(Dest(1, 1), 1);
+  SUBSC_REC *b = Subscription(Dest(1, 2), 2);
+  std::vector<SUBSC_REC *> matches = {a, b};
+  mock_eds_send_rc = NCSCC_RC_FAILURE;
+  Fanout(&matches);
+  EXPECT_EQ(mock_eds_sends.size(), 1u);
+  EXPECT_EQ(matches, std::vector<SUBSC_REC *>({a, b}));
+}
+
+TEST_F(EdsFanoutTest, DisabledFanout) {
+  cb_.node_fanout = false;
+  eds_node_relay_add(&cb_, Dest(1, 1));
+  SUBSC_REC *a = Subscription(Dest(1, 1), 1);
+  SUBSC_REC *b = Subscription(Dest(1, 2), 2);
+  std::vector<SUBSC_REC *> matches = {a, b};
+  Fanout(&matches);
+  EXPECT_TRUE(mock_eds_sends.empty());
+  EXPECT_EQ(matches, std::vector<SUBSC_REC *>({a, b}));
+}
+
+TEST_F(EdsFanoutTest, RelayFailedTargetsAreSentDirectly) {
+  SaEvtEventPatternArrayT patterns = {0, 0, nullptr};
+  EDSV_EVT_DELIVER_TARGET targets[3] = {
+      {Dest(1, 2), 20, 2, 1, 2},
+      {Dest(2, 1), 30, 3, 1, 3},
+      {Dest(1, 3), 40, 4, 1, 4},
+  };
+  EDSV_EDA_EVT_DELIVER_CBK_PARAM param;
+  memset(&param, 0, sizeof(param));
+  param.pattern_array = &patterns;
+  param.num_targets = 3;
+  param.targets = targets;
+  eds_relay_failed_deliver(&cb_, Dest(1, 1), &param);
+
+  // The target on another node than the relay is not trusted
+  ASSERT_EQ(mock_eds_sends.size(), 2u);
+  EXPECT_EQ(mock_eds_sends[0].dest, Dest(1, 2));
+  EXPECT_EQ(mock_eds_sends[0].type, EDSV_EDS_DELIVER_EVENT);
+  EXPECT_EQ(mock_eds_sends[0].reg_id, 20u);
+  EXPECT_EQ(mock_eds_sends[0].sub_id, 2u);
+  EXPECT_EQ(mock_eds_sends[1].dest, Dest(1, 3));
+  EXPECT_EQ(mock_eds_sends[1].sub_id, 4u);
+}
+
+// The message a relay sends back, encoded as the EDA does and decoded as
+// the EDS does
+TEST(EdsvCodecTest, RelayFailedRoundTrip) {
+  SaUint8T pattern[] = "pattern";
+  SaEvtEventPatternT p = {sizeof(pattern), sizeof(pattern), pattern};
+  SaEvtEventPatternArrayT patterns = {1, 1, &p};
+  SaUint8T data[] = "data";
+  EDSV_EVT_DELIVER_TARGET targets[2] = {{Dest(1, 2), 20, 2, 1, 2},
+                                        {Dest(1, 3), 30, 3, 4, 5}};
+  EDSV_EDA_EVT_DELIVER_CBK_PARAM in;
+  memset(&in, 0, sizeof(in));
+  in.sub_id = 2;
+  in.chan_id = 1;
+  in.chan_open_id = 2;
+  in.pattern_array = &patterns;
+  in.priority = SA_EVT_LOWEST_PRIORITY;
+  in.publish_time = 1234;
+  in.eda_event_id = 7;
+  in.data_len = sizeof(data);
+  in.data = data;
+  in.num_targets = 2;
+  in.targets = targets;
+
+  NCS_UBAID uba;
+  memset(&uba, 0, sizeof(uba));
+  ASSERT_EQ(ncs_enc_init_space(&uba), NCSCC_RC_SUCCESS);
+  uint32_t enc = edsv_enc_delv_targets(&uba, &in);
+  enc += edsv_enc_delv_evt_cbk_msg(&uba, &in);
+
+  ncs_dec_init_space(&uba, uba.start);
+  EDSV_EDA_EVT_DELIVER_CBK_PARAM out;
+  memset(&out, 0, sizeof(out));
+  uint32_t dec = edsv_dec_delv_targets(&uba, &out);
+  dec += edsv_dec_delv_evt_cbk_msg(&uba, &out);
+  m_MMGR_FREE_BUFR_LIST(uba.ub);
+  EXPECT_EQ(dec, enc);
+
+  ASSERT_EQ(out.num_targets, 2u);
+  EXPECT_EQ(memcmp(out.targets, targets, sizeof(targets)), 0);
+  EXPECT_EQ(out.sub_id, 2u);
+  ASSERT_EQ(out.pattern_array->patternsNumber, 1u);
+  EXPECT_EQ(out.pattern_array->patterns[0].patternSize, sizeof(pattern));
+  EXPECT_EQ(memcmp(out.pattern_array->patterns[0].pattern, pattern,
+                   sizeof(pattern)),
+            0);
+  EXPECT_EQ(out.priority, SA_EVT_LOWEST_PRIORITY);
+  EXPECT_EQ(out.publish_time, 1234);
+  EXPECT_EQ(out.eda_event_id, 7u);
+  ASSERT_EQ(out.data_len, sizeof(data));
+  EXPECT_EQ(memcmp(out.data, data, sizeof(data)), 0);
+
+  edsv_free_evt_pattern_array(out.pattern_array);
+  m_MMGR_FREE_EDSV_EVENT_DATA(out.data);
+  free(out.targets);
+}
+
+}  // namespace
@@ -0,0 +1,310 @@
+/*      -*- OpenSAF  -*-
+ *
+ * (C) Copyright 2017 The OpenSAF Foundation
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. This file and program are licensed
+ * under the GNU Lesser General Public License Version 2.1, February 1999.
+ * The complete license can be accessed from the following location:
+ * http://opensource.org/licenses/lgpl-license.php
+ * See the Copying file included with the OpenSAF distribution for full
+ * licensing terms.
+ *
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+#include "evt/tests/mock_eds_mds.h"
+#include "gtest/gtest.h"
+
+namespace {
+
+typedef std::pair<SaEvtEventFilterTypeT, std::string> Filter;
+
+// The patterns of a published event. A pattern may be given a size
+// smaller than its buffer, to catch reads past the end of the pattern.
+class Patterns {
+ public:
+  explicit Patterns(const std::vector<std::string> &patterns)
+      : bytes_(patterns) {
+    for (std::string &b : bytes_)
+      patterns_.push_back({b.size(), b.size(),
+                           reinterpret_cast<SaUint8T *>(&b[0])});
+    array_.allocatedNumber = array_.patternsNumber = patterns_.size();
+    array_.patterns = patterns_.empty() ? nullptr : patterns_.data();
+  }
+
+  void SetSize(size_t pos, SaSizeT size) { patterns_[pos].patternSize = size; }
+
+  SaEvtEventPatternArrayT *get() { return &array_; }
+
+ private:
+  std::vector<std::string> bytes_;
+  std::vector<SaEvtEventPatternT> patterns_;
+  SaEvtEventPatternArrayT array_;
+};
+
+// A subscription with the filters it owns
+struct Subscription {
+  SUBSC_REC rec;
+  std::vector<std::string> bytes;
+  std::vector<SaEvtEventFilterT> filters;
+  SaEvtEventFilterArrayT array;
+};
+
+// The subscription index of a channel, checked against the scan of all
+// subscriptions of all channel opens that publish used to do
+class EdsSubscIdxTest : public ::testing::Test {
+ protected:
+  virtual void SetUp() { memset(&idx_, 0, sizeof(idx_)); }
+
+  virtual void TearDown() { eds_subsc_idx_destroy(&idx_); }
+
+  CHAN_OPEN_REC *Open(uint32_t chan_open_id) {
+    CHAN_OPEN_REC *co = new CHAN_OPEN_REC();
+    co->chan_id = 1;
+    co->chan_open_id = chan_open_id;
+    opens_.emplace_back(co);
+    subs_[chan_open_id];
+    return co;
+  }
+
+  SUBSC_REC *Subscribe(CHAN_OPEN_REC *co, const std::vector<Filter> &filters) {
+    Subscription *sub = new Subscription();
+    owned_.emplace_back(sub);
+    for (const Filter &f : filters) sub->bytes.push_back(f.second);
+    for (size_t i = 0; i < filters.size(); i++) {
+      std::string &b = sub->bytes[i];
+      SaEvtEventFilterT f;
+      f.filterType = filters[i].first;
+      f.filter.allocatedSize = f.filter.patternSize = b.size();
+      f.filter.pattern = reinterpret_cast<SaUint8T *>(&b[0]);
+      sub->filters.push_back(f);
+    }
+    sub->array.filtersNumber = sub->filters.size();
+    sub->array.filters = sub->filters.data();
+    SUBSC_REC *rec = &sub->rec;
+    memset(rec, 0, sizeof(*rec));
+    rec->subscript_id = ++last_sub_id_;
+    rec->chan_id = 1;
+    rec->chan_open_id = co->chan_open_id;
+    rec->par_chan_open_inst = co;
+    rec->filters = &sub->array;
+    subs_[co->chan_open_id].push_back(rec);
+    eds_subsc_idx_add(&idx_, rec);
+    return rec;
+  }
+
+  void Unsubscribe(SUBSC_REC *rec) {
+    eds_subsc_idx_del(rec);
+    std::vector<SUBSC_REC *> &subs = subs_[rec->chan_open_id];
+    for (auto it = subs.begin(); it != subs.end(); ++it) {
+      if (*it == rec) {
+        subs.erase(it);
+        break;
+      }
+    }
+  }
+
+  std::vector<SUBSC_REC *> Match(Patterns *patterns) {
+    SUBSC_REC **matches;
+    uint32_t num = eds_subsc_idx_match(&idx_, patterns->get(), &matches);
+    return std::vector<SUBSC_REC *>(matches, matches + num);
+  }
+
+  // The first matching subscription of each channel open, in channel open
+  // id order
+  std::vector<SUBSC_REC *> LinearMatch(Patterns *patterns) {
+    std::vector<SUBSC_REC *> matches;
+    for (const auto &open : subs_) {
+      for (SUBSC_REC *rec : open.second) {
+        if (eds_pattern_match(patterns->get(), rec->filters)) {
+          matches.push_back(rec);
+          break;
+        }
+      }
+    }
+    return matches;
+  }
+
+  EDS_SUBSC_IDX idx_;
+  uint32_t last_sub_id_{0};
+  std::map<uint32_t, std::vector<SUBSC_REC *>> subs_;
+  std::vector<std::unique_ptr<CHAN_OPEN_REC>> opens_;
+  std::vector<std::unique_ptr<Subscription>> owned_;
+};
+
+TEST_F(EdsSubscIdxTest, FilterTypes) {
+  SUBSC_REC *exact = Subscribe(Open(1), {{SA_EVT_EXACT_FILTER, "abc"}});
+  SUBSC_REC *prefix = Subscribe(Open(2), {{SA_EVT_PREFIX_FILTER, "ab"}});
+  SUBSC_REC *suffix = Subscribe(Open(3), {{SA_EVT_SUFFIX_FILTER, "bc"}});
+  SUBSC_REC *pass_all = Subscribe(Open(4), {{SA_EVT_PASS_ALL_FILTER, ""}});
+  SUBSC_REC *second = Subscribe(
+      Open(5), {{SA_EVT_PASS_ALL_FILTER, ""}, {SA_EVT_EXACT_FILTER, "x"}});
+
+  Patterns abc({"abc"});
+  EXPECT_EQ(Match(&abc),
+            std::vector<SUBSC_REC *>({exact, prefix, suffix, pass_all}));
+  Patterns abd({"abd", "x"});
+  EXPECT_EQ(Match(&abd), std::vector<SUBSC_REC *>({prefix, pass_all, second}));
+  Patterns none(std::vector<std::string>{});
+  EXPECT_EQ(Match(&none), std::vector<SUBSC_REC *>({pass_all}));
+}
+
+TEST_F(EdsSubscIdxTest, FirstMatchingSubscriptionOfEachOpen) {
+  // Opened out of id order, the matches are in channel open id order
+  CHAN_OPEN_REC *co2 = Open(2);
+  CHAN_OPEN_REC *co1 = Open(1);
+  Subscribe(co2, {{SA_EVT_EXACT_FILTER, "b"}});
+  SUBSC_REC *a2 = Subscribe(co2, {{SA_EVT_PREFIX_FILTER, "a"}});
+  SUBSC_REC *a2_exact = Subscribe(co2, {{SA_EVT_EXACT_FILTER, "a"}});
+  SUBSC_REC *a1 = Subscribe(co1, {{SA_EVT_PASS_ALL_FILTER, ""}});
+  Subscribe(co1, {{SA_EVT_EXACT_FILTER, "a"}});
+
+  Patterns a({"a"});
+  EXPECT_EQ(Match(&a), std::vector<SUBSC_REC *>({a1, a2}));
+  EXPECT_EQ(Match(&a), LinearMatch(&a));
+
+  Unsubscribe(a2);
+  EXPECT_EQ(Match(&a), std::vector<SUBSC_REC *>({a1, a2_exact}));
+}
+
+TEST_F(EdsSubscIdxTest, ShortPatternDoesNotMatchALongerPrefix) {
+  // The pattern buffers hold "abcdef" but the patterns are "ab"
+  Patterns patterns({"abcdef", "abcdef"});
+  patterns.SetSize(0, 2);
+  patterns.SetSize(1, 2);
+
+  // Indexed on the prefix filter, and on the exact filter with the prefix
+  // filter checked by eds_pattern_match() only
+  SUBSC_REC *indexed = Subscribe(Open(1), {{SA_EVT_PREFIX_FILTER, "abcd"}});
+  SUBSC_REC *checked = Subscribe(
+      Open(2), {{SA_EVT_EXACT_FILTER, "ab"}, {SA_EVT_PREFIX_FILTER, "abcd"}});
+  EXPECT_FALSE(eds_pattern_match(patterns.get(), indexed->filters));
+  EXPECT_FALSE(eds_pattern_match(patterns.get(), checked->filters));
+  EXPECT_TRUE(Match(&patterns).empty());
+
+  SUBSC_REC *ab = Subscribe(
+      Open(3), {{SA_EVT_EXACT_FILTER, "ab"}, {SA_EVT_PREFIX_FILTER, "ab"}});
+  EXPECT_EQ(Match(&patterns), std::vector<SUBSC_REC *>({ab}));
+}
+
+TEST_F(EdsSubscIdxTest, SameMatchesAsTheLinearScan) {
+  // Short patterns of a small alphabet, for many partial matches
+  std::mt19937 rnd(4711);
+  auto pattern = [&rnd]() {
+    std::string s(rnd() % 4, 'a');
+    for (char &c : s) c = "ab"[rnd() % 2];
+    return s;
+  };
+  const SaEvtEventFilterTypeT types[] = {
+      SA_EVT_PREFIX_FILTER, SA_EVT_SUFFIX_FILTER, SA_EVT_EXACT_FILTER,
+      SA_EVT_PASS_ALL_FILTER};
+
+  std::vector<CHAN_OPEN_REC *> opens;
+  for (uint32_t id = 1; id <= 20; id++) opens.push_back(Open(id * 3 % 20 + 1));
+
+  std::vector<SUBSC_REC *> subscribed;
+  for (int i = 0; i < 300; i++) {
+    std::vector<Filter> filters;
+    for (unsigned int n = rnd() % 3 + 1; n > 0; n--)
+      filters.push_back({types[rnd() % 4], pattern()});
+    subscribed.push_back(Subscribe(opens[rnd() % opens.size()], filters));
+  }
+  for (int i = 0; i < 100; i++) {
+    size_t n = rnd() % subscribed.size();
+    Unsubscribe(subscribed[n]);
+    subscribed.erase(subscribed.begin() + n);
+  }
+
+  size_t matched = 0;
+  for (int i = 0; i < 1000; i++) {
+    std::vector<std::string> p;
+    for (unsigned int n = rnd() % 4; n > 0; n--) p.push_back(pattern());
+    Patterns patterns(p);
+    std::vector<SUBSC_REC *> matches = Match(&patterns);
+    ASSERT_EQ(matches, LinearMatch(&patterns)) << "publish " << i;
+    matched += matches.size();
+  }
+  EXPECT_GT(matched, 0u);
+}
+
+// Publish latency against the number of subscriptions, with the linear
+// scan and with the index. Run with
+//   bin/testevtd --gtest_also_run_disabled_tests --gtest_filter='*Bench*'
+class EdsSubscIdxBench : public EdsSubscIdxTest {
+ protected:
+  // Each subscription has a filter on one of 100 services, exact or on the
+  // suffix of the service name, and a prefix filter on one of 4 regions
+  void Run(uint32_t opens, uint32_t per_open,
+           SaEvtEventFilterTypeT service_filter = SA_EVT_EXACT_FILTER) {
+    char name[32];
+    for (uint32_t id = 1; id <= opens; id++) {
+      CHAN_OPEN_REC *co = Open(id);
+      for (uint32_t n = 0; n < per_open; n++) {
+        uint32_t k = id * per_open + n;
+        snprintf(name, sizeof(name), "svc%u", k % 100);
+        std::string region = "region" + std::to_string(k % 4);
+        if (service_filter == SA_EVT_SUFFIX_FILTER)
+          snprintf(name, sizeof(name), "%02u", k % 100);
+        Subscribe(co, {{service_filter, name},
+                       {SA_EVT_PREFIX_FILTER, region}});
+      }
+    }
+
+    const int kEvents = 1000;
+    std::vector<std::unique_ptr<Patterns>> events;
+    for (int i = 0; i < kEvents; i++) {
+      if (service_filter == SA_EVT_SUFFIX_FILTER)
+        snprintf(name, sizeof(name), "svc%02d", i % 100);
+      else
+        snprintf(name, sizeof(name), "svc%d", i % 100);
+      events.emplace_back(new Patterns(
+          {name, "region" + std::to_string(i % 4) + "/node" +
+                     std::to_string(i % 10)}));
+    }
+
+    size_t scanned = 0, indexed = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (auto &event : events) scanned += LinearMatch(event.get()).size();
+    auto scan = std::chrono::steady_clock::now() - start;
+
+    start = std::chrono::steady_clock::now();
+    SUBSC_REC **matches;
+    for (auto &event : events)
+      indexed += eds_subsc_idx_match(&idx_, event->get(), &matches);
+    auto index = std::chrono::steady_clock::now() - start;
+    EXPECT_EQ(indexed, scanned);
+
+    typedef std::chrono::duration<double, std::micro> Us;
+    printf("%u subscriptions, %s filters, %zu matches: scan %.2f us, "
+           "index %.2f us per publish\n",
+           opens * per_open,
+           service_filter == SA_EVT_SUFFIX_FILTER ? "suffix" : "exact",
+           scanned / kEvents, Us(scan).count() / kEvents,
+           Us(index).count() / kEvents);
+  }
+};
+
+TEST_F(EdsSubscIdxBench, DISABLED_HundredSubscriptions) { Run(10, 10); }
+
+TEST_F(EdsSubscIdxBench, DISABLED_ThousandSubscriptions) { Run(100, 10); }
+
+TEST_F(EdsSubscIdxBench, DISABLED_TenThousandSubscriptions) { Run(100, 100); }
+
+TEST_F(EdsSubscIdxBench, DISABLED_HundredThousandSubscriptions) {
+  Run(1000, 100);
+}
+
+TEST_F(EdsSubscIdxBench, DISABLED_TenThousandSuffixSubscriptions) {
+  Run(100, 100, SA_EVT_SUFFIX_FILTER);
+}
+
+}  // namespace
@@ -0,0 +1,39 @@
+/*      -*- OpenSAF  -*-
+ *
+ * (C) Copyright 2017 The OpenSAF Foundation
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. This file and program are licensed
+ * under the GNU Lesser General Public License Version 2.1, February 1999.
+ * The complete license can be accessed from the following location:
+ * http://opensource.org/licenses/lgpl-license.php
+ * See the Copying file included with the OpenSAF distribution for full
+ * licensing terms.
+ *
+ */
+
+#include "evt/tests/mock_eds_mds.h"
+
+std::vector<MockEdsSend> mock_eds_sends;
+uint32_t mock_eds_send_rc = NCSCC_RC_SUCCESS;
+
+// Records the callback messages the EDS sends instead of sending them
+uint32_t eds_mds_msg_send(EDS_CB *cb, EDSV_MSG *msg, MDS_DEST *dest,
+                          MDS_SYNC_SND_CTXT *mds_ctxt,
+                          MDS_SEND_PRIORITY_TYPE prio) {
+  (void)cb;
+  (void)mds_ctxt;
+  (void)prio;
+  const EDSV_EDA_EVT_DELIVER_CBK_PARAM *param =
+      &msg->info.cbk_info.param.evt_deliver_cbk;
+  MockEdsSend send;
+  send.dest = *dest;
+  send.type = msg->info.cbk_info.type;
+  send.reg_id = msg->info.cbk_info.eds_reg_id;
+  send.sub_id = param->sub_id;
+  if (send.type == EDSV_EDS_DELIVER_EVENT_NODE)
+    send.targets.assign(param->targets, param->targets + param->num_targets);
+  mock_eds_sends.push_back(send);
+  return mock_eds_send_rc;
+}
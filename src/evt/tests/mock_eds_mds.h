@@ -0,0 +1,39 @@
+/*      -*- OpenSAF  -*-
+ *
+ * (C) Copyright 2017 The OpenSAF Foundation
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. This file and program are licensed
+ * under the GNU Lesser General Public License Version 2.1, February 1999.
+ * The complete license can be accessed from the following location:
+ * http://opensource.org/licenses/lgpl-license.php
+ * See the Copying file included with the OpenSAF distribution for full
+ * licensing terms.
+ *
+ */
+
+#ifndef EVT_TESTS_MOCK_EDS_MDS_H_
+#define EVT_TESTS_MOCK_EDS_MDS_H_
+
+#include <vector>
+extern "C" {
+#include "evt/evtd/eds.h"
+}
+
+// A message eds_mds_msg_send() was called with
+struct MockEdsSend {
+  MDS_DEST dest;
+  EDSV_CBK_TYPE type;
+  uint32_t reg_id;
+  uint32_t sub_id;
+  std::vector<EDSV_EVT_DELIVER_TARGET> targets;
+};
+
+// The messages sent, in order
+extern std::vector<MockEdsSend> mock_eds_sends;
+
+// What eds_mds_msg_send() returns
+extern uint32_t mock_eds_send_rc;
+
+#endif  // EVT_TESTS_MOCK_EDS_MDS_H_
@@ -0,0 +1,347 @@
+/*      -*- OpenSAF  -*-
+ *
+ * (C) Copyright 2017 The OpenSAF Foundation
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. This file and program are licensed
+ * under the GNU Lesser General Public License Version 2.1, February 1999.
+ * The complete license can be accessed from the following location:
+ * http://opensource.org/licenses/lgpl-license.php
+ * See the Copying file included with the OpenSAF distribution for full
+ * licensing terms.
+ *
+ */
+
+#include "imma_cache.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <iterator>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "imma.h"
+#include "base/logtrace.h"
+#include "base/osaf_extended_name.h"
+
+namespace {
+
+struct CachedAttr {
+  std::string name;
+  SaImmValueTypeT valueType;
+  std::vector<SaImmAttrValueT> values; /* Owned, freed by freeAttrValue3 */
+};
+
+struct CacheEntry {
+  std::string objectName;
+  std::vector<CachedAttr> attrs;
+  size_t bytes;
+};
+
+typedef std::list<CacheEntry> EntryList; /* Front is most recently used */
+
+size_t valueSize(SaImmValueTypeT valueType) {
+  switch (valueType) {
+    case SA_IMM_ATTR_SAINT32T:
+      return sizeof(SaInt32T);
+    case SA_IMM_ATTR_SAUINT32T:
+      return sizeof(SaUint32T);
+    case SA_IMM_ATTR_SAINT64T:
+      return sizeof(SaInt64T);
+    case SA_IMM_ATTR_SAUINT64T:
+      return sizeof(SaUint64T);
+    case SA_IMM_ATTR_SATIMET:
+      return sizeof(SaTimeT);
+    case SA_IMM_ATTR_SAFLOATT:
+      return sizeof(SaFloatT);
+    case SA_IMM_ATTR_SADOUBLET:
+      return sizeof(SaDoubleT);
+    case SA_IMM_ATTR_SANAMET:
+      return sizeof(SaNameT);
+    case SA_IMM_ATTR_SASTRINGT:
+      return sizeof(SaStringT);
+    case SA_IMM_ATTR_SAANYT:
+      return sizeof(SaAnyT);
+    default:
+      TRACE_4("Illegal value type: %u", valueType);
+      abort();
+  }
+}
+
+/* Deep copy of ONE attribute value. Adds the heap size of the copy to
+   *bytes when bytes is not NULL. */
+SaImmAttrValueT copyValue(SaImmValueTypeT valueType, SaImmAttrValueT src,
+                          size_t *bytes) {
+  size_t size = valueSize(valueType);
+  size_t extra = 0;
+  SaImmAttrValueT dst = calloc(1, size);
+
+  switch (valueType) {
+    case SA_IMM_ATTR_SANAMET: {
+      SaConstStringT str = osaf_extended_name_borrow((const SaNameT *)src);
+      osaf_extended_name_alloc(str, (SaNameT *)dst);
+      extra = strlen(str) + 1;
+      break;
+    }
+    case SA_IMM_ATTR_SASTRINGT: {
+      SaStringT str = *((SaStringT *)src);
+      *((SaStringT *)dst) = str ? strdup(str) : NULL;
+      extra = str ? strlen(str) + 1 : 0;
+      break;
+    }
+    case SA_IMM_ATTR_SAANYT: {
+      const SaAnyT *any = (const SaAnyT *)src;
+      SaAnyT *anyCopy = (SaAnyT *)dst;
+      anyCopy->bufferSize = any->bufferSize;
+      if (any->bufferSize) {
+        anyCopy->bufferAddr = (SaUint8T *)malloc(any->bufferSize);
+        memcpy(anyCopy->bufferAddr, any->bufferAddr, any->bufferSize);
+      }
+      extra = any->bufferSize;
+      break;
+    }
+    default:
+      memcpy(dst, src, size);
+      break;
+  }
+
+  if (bytes) {
+    *bytes += size + extra;
+  }
+  return dst;
+}
+
+void freeEntry(CacheEntry *entry) {
+  for (auto &attr : entry->attrs) {
+    for (auto value : attr.values) {
+      imma_freeAttrValue3(value, attr.valueType);
+    }
+    attr.values.clear();
+  }
+  entry->attrs.clear();
+}
+
+/* Attributes that the IMMND may change without a CCB. */
+bool isVolatileConfigAttr(const char *attrName) {
+  return (strcmp(attrName, SA_IMM_ATTR_ADMIN_OWNER_NAME) == 0) ||
+         (strcmp(attrName, SA_IMM_ATTR_IMPLEMENTER_NAME) == 0);
+}
+
+}  // namespace
+
+struct imma_accessor_cache {
+  EntryList lru;
+  std::unordered_map<std::string, EntryList::iterator> index;
+  size_t maxBytes;
+  size_t bytes;
+  SaUint64T epoch;
+  std::vector<std::string> rewatch; /* Cached when the IMMND went down */
+  SaUint64T hits;
+  SaUint64T misses;
+  SaUint64T invalidations;
+  SaUint64T evictions;
+};
+
+static void imma_accessor_cache_erase(IMMA_ACCESSOR_CACHE *cache,
+                                      EntryList::iterator it) {
+  cache->bytes -= it->bytes;
+  cache->index.erase(it->objectName);
+  freeEntry(&(*it));
+  cache->lru.erase(it);
+}
+
+IMMA_ACCESSOR_CACHE *imma_accessor_cache_create(size_t maxBytes) {
+  IMMA_ACCESSOR_CACHE *cache = new IMMA_ACCESSOR_CACHE;
+  cache->maxBytes = maxBytes;
+  cache->bytes = 0;
+  cache->epoch = 0;
+  cache->hits = 0;
+  cache->misses = 0;
+  cache->invalidations = 0;
+  cache->evictions = 0;
+  return cache;
+}
+
+void imma_accessor_cache_destroy(IMMA_ACCESSOR_CACHE *cache) {
+  if (!cache) {
+    return;
+  }
+  for (auto &entry : cache->lru) {
+    freeEntry(&entry);
+  }
+  delete cache;
+}
+
+bool imma_accessor_cache_usable(const SaImmAttrNameT *attributeNames) {
+  /* Fetching all attributes includes runtime attributes, which may change
+     at any time. Only an explicit list of names can be served. */
+  if (!attributeNames || !attributeNames[0]) {
+    return false;
+  }
+  /* The config tunnel itself is never served from the cache. */
+  return strcmp(attributeNames[0], "SA_IMM_SEARCH_GET_CONFIG_ATTR") != 0;
+}
+
+IMMA_CACHE_RESULT imma_accessor_cache_get(IMMA_ACCESSOR_CACHE *cache,
+                                          const char *objectName,
+                                          const SaImmAttrNameT *attributeNames,
+                                          SaImmAttrValuesT_2 ***attributes,
+                                          bool countAccess) {
+  auto found = cache->index.find(objectName);
+  if (found == cache->index.end()) {
+    if (countAccess) ++cache->misses;
+    return IMMA_CACHE_ABSENT;
+  }
+
+  CacheEntry &entry = *found->second;
+  std::vector<const CachedAttr *> selected;
+  for (int ix = 0; attributeNames[ix]; ++ix) {
+    const CachedAttr *match = NULL;
+    for (const auto &attr : entry.attrs) {
+      if (attr.name == attributeNames[ix]) {
+        match = &attr;
+        break;
+      }
+    }
+    if (!match) {
+      /* Runtime, volatile or unknown attribute. Leave it to the IMMND. */
+      if (countAccess) ++cache->misses;
+      return IMMA_CACHE_PARTIAL;
+    }
+    selected.push_back(match);
+  }
+
+  SaImmAttrValuesT_2 **attr = (SaImmAttrValuesT_2 **)calloc(
+      selected.size() + 1, sizeof(SaImmAttrValuesT_2 *)); /*alloc-1 */
+  for (size_t ix = 0; ix < selected.size(); ++ix) {
+    const CachedAttr *cached = selected[ix];
+    SaImmAttrValuesT_2 *att = (SaImmAttrValuesT_2 *)calloc(
+        1, sizeof(SaImmAttrValuesT_2)); /*alloc-2 */
+    att->attrName = strdup(cached->name.c_str()); /*alloc-3 */
+    att->attrValueType = cached->valueType;
+    att->attrValuesNumber = cached->values.size();
+    if (att->attrValuesNumber) {
+      att->attrValues = (SaImmAttrValueT *)calloc(
+          att->attrValuesNumber, sizeof(SaImmAttrValueT)); /*alloc-4 */
+      for (SaUint32T ix2 = 0; ix2 < att->attrValuesNumber; ++ix2) {
+        att->attrValues[ix2] = copyValue(
+            cached->valueType, cached->values[ix2], NULL); /*alloc-5 */
+      }
+    }
+    attr[ix] = att;
+  }
+
+  cache->lru.splice(cache->lru.begin(), cache->lru, found->second);
+  if (countAccess) ++cache->hits;
+  *attributes = attr;
+  return IMMA_CACHE_HIT;
+}
+
+SaUint64T imma_accessor_cache_epoch(const IMMA_ACCESSOR_CACHE *cache) {
+  return cache->epoch;
+}
+
+void imma_accessor_cache_put(IMMA_ACCESSOR_CACHE *cache, const char *objectName,
+                             SaImmAttrValuesT_2 **attributes,
+                             SaUint64T epoch) {
+  if (epoch != cache->epoch) {
+    /* Something was invalidated while the fill was in flight. The reply
+       may or may not reflect that change, so it can not be trusted. */
+    TRACE("Accessor cache fill for %s discarded, epoch moved", objectName);
+    return;
+  }
+
+  auto found = cache->index.find(objectName);
+  if (found != cache->index.end()) {
+    imma_accessor_cache_erase(cache, found->second);
+  }
+
+  CacheEntry entry;
+  entry.objectName = objectName;
+  entry.bytes = sizeof(CacheEntry) + entry.objectName.size();
+  for (int ix = 0; attributes[ix]; ++ix) {
+    const SaImmAttrValuesT_2 *att = attributes[ix];
+    if (isVolatileConfigAttr(att->attrName)) {
+      continue;
+    }
+    CachedAttr cached;
+    cached.name = att->attrName;
+    cached.valueType = att->attrValueType;
+    entry.bytes += sizeof(CachedAttr) + cached.name.size();
+    for (SaUint32T ix2 = 0; ix2 < att->attrValuesNumber; ++ix2) {
+      cached.values.push_back(
+          copyValue(att->attrValueType, att->attrValues[ix2], &entry.bytes));
+      entry.bytes += sizeof(SaImmAttrValueT);
+    }
+    entry.attrs.push_back(std::move(cached));
+  }
+
+  if (entry.bytes > cache->maxBytes) {
+    TRACE("Object %s too large for accessor cache (%zu bytes)", objectName,
+          entry.bytes);
+    freeEntry(&entry);
+    return;
+  }
+
+  while (cache->bytes + entry.bytes > cache->maxBytes) {
+    imma_accessor_cache_erase(cache, std::prev(cache->lru.end()));
+    ++cache->evictions;
+  }
+
+  cache->bytes += entry.bytes;
+  cache->lru.push_front(std::move(entry));
+  cache->index[objectName] = cache->lru.begin();
+}
+
+void imma_accessor_cache_invalidate(IMMA_ACCESSOR_CACHE *cache,
+                                    const char *objectName) {
+  ++cache->epoch;
+  auto found = cache->index.find(objectName);
+  if (found != cache->index.end()) {
+    TRACE("Accessor cache entry for %s invalidated", objectName);
+    imma_accessor_cache_erase(cache, found->second);
+    ++cache->invalidations;
+  }
+}
+
+void imma_accessor_cache_clear(IMMA_ACCESSOR_CACHE *cache) {
+  ++cache->epoch;
+  cache->invalidations += cache->lru.size();
+  for (auto &entry : cache->lru) {
+    cache->rewatch.push_back(entry.objectName);
+    freeEntry(&entry);
+  }
+  cache->lru.clear();
+  cache->index.clear();
+  cache->bytes = 0;
+}
+
+size_t imma_accessor_cache_take_rewatch(IMMA_ACCESSOR_CACHE *cache,
+                                        char ***names) {
+  size_t num = cache->rewatch.size();
+
+  *names = NULL;
+  if (num == 0) {
+    return 0;
+  }
+  *names = (char **)malloc(num * sizeof(char *));
+  for (size_t ix = 0; ix < num; ++ix) {
+    (*names)[ix] = strdup(cache->rewatch[ix].c_str());
+  }
+  cache->rewatch.clear();
+  return num;
+}
+
+void imma_accessor_cache_stats(const IMMA_ACCESSOR_CACHE *cache,
+                               ImmsvAccessorCacheStatsT *stats) {
+  stats->hits = cache->hits;
+  stats->misses = cache->misses;
+  stats->invalidations = cache->invalidations;
+  stats->evictions = cache->evictions;
+  stats->entries = cache->lru.size();
+  stats->bytes = cache->bytes;
+  stats->maxBytes = cache->maxBytes;
+}
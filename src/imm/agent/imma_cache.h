@@ -0,0 +1,86 @@
+/*      -*- OpenSAF  -*-
+ *
+ * (C) Copyright 2017 The OpenSAF Foundation
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. This file and program are licensed
+ * under the GNU Lesser General Public License Version 2.1, February 1999.
+ * The complete license can be accessed from the following location:
+ * http://opensource.org/licenses/lgpl-license.php
+ * See the Copying file included with the OpenSAF distribution for full
+ * licensing terms.
+ *
+ */
+
+/*****************************************************************************
+  DESCRIPTION:
+
+  Per OM handle cache of config attributes, used by saImmOmAccessorGet.
+
+  Each entry holds the complete set of config attributes of one object as
+  fetched by the SA_IMM_SEARCH_GET_CONFIG_ATTR tunnel. Entries are dropped
+  when the IMMND reports that a CCB touching the object has been applied,
+  when the object is deleted or when contact with the IMMND is lost. After
+  contact is lost, the objects are fetched again by the first accessorGet
+  on the handle, which registers their watches with the new IMMND. The
+  cache is bounded by a byte budget and evicts least recently used entries.
+
+  All functions must be called with the IMMA CB lock held.
+*****************************************************************************/
+
+#ifndef IMM_AGENT_IMMA_CACHE_H_
+#define IMM_AGENT_IMMA_CACHE_H_
+
+#include <stddef.h>
+#include "imm/saf/saImmOm.h"
+#include "imm/common/immsv_api.h"
+
+typedef struct imma_accessor_cache IMMA_ACCESSOR_CACHE;
+
+typedef enum {
+  IMMA_CACHE_ABSENT = 0,  /* No entry for the object. */
+  IMMA_CACHE_PARTIAL = 1, /* Entry present, some attribute not cacheable. */
+  IMMA_CACHE_HIT = 2
+} IMMA_CACHE_RESULT;
+
+IMMA_ACCESSOR_CACHE *imma_accessor_cache_create(size_t maxBytes);
+void imma_accessor_cache_destroy(IMMA_ACCESSOR_CACHE *cache);
+
+/* True if an accessorGet with these attribute names may use the cache. */
+bool imma_accessor_cache_usable(const SaImmAttrNameT *attributeNames);
+
+/* On IMMA_CACHE_HIT a copy of the requested attributes is returned in
+   *attributes, allocated as for a reply from the IMMND. The hit/miss
+   counters are only updated when countAccess is true. */
+IMMA_CACHE_RESULT imma_accessor_cache_get(IMMA_ACCESSOR_CACHE *cache,
+                                          const char *objectName,
+                                          const SaImmAttrNameT *attributeNames,
+                                          SaImmAttrValuesT_2 ***attributes,
+                                          bool countAccess);
+
+/* Epoch is bumped by every invalidation. A fill started at one epoch is
+   discarded by imma_accessor_cache_put if the epoch has moved since. */
+SaUint64T imma_accessor_cache_epoch(const IMMA_ACCESSOR_CACHE *cache);
+void imma_accessor_cache_put(IMMA_ACCESSOR_CACHE *cache, const char *objectName,
+                             SaImmAttrValuesT_2 **attributes, SaUint64T epoch);
+
+void imma_accessor_cache_invalidate(IMMA_ACCESSOR_CACHE *cache,
+                                    const char *objectName);
+
+/* Drops all entries when contact with the IMMND is lost, and with it the
+   watches on the objects. The names of the objects are kept for
+   imma_accessor_cache_take_rewatch. */
+void imma_accessor_cache_clear(IMMA_ACCESSOR_CACHE *cache);
+
+/* The objects cached before the last imma_accessor_cache_clear, most
+   recently used first, to be fetched again with new watches once the
+   IMMND is back. Returns the number of names and a malloc'ed array of
+   malloc'ed names in *names, which the caller frees. */
+size_t imma_accessor_cache_take_rewatch(IMMA_ACCESSOR_CACHE *cache,
+                                        char ***names);
+
+void imma_accessor_cache_stats(const IMMA_ACCESSOR_CACHE *cache,
+                               ImmsvAccessorCacheStatsT *stats);
+
+#endif  // IMM_AGENT_IMMA_CACHE_H_
@@ -95,6 +95,15 @@ typedef struct imma_client_node {
   SaTimeT
       oiTimeout; /* Timeout for OI callback. If the value is 0, the default
                     timeout (6s) will be used */
+
+  /* Config attribute cache for accessorGet, managed by environment variable
+   * IMMA_ACCESSOR_CACHE_MAX_BYTES. NULL => caching disabled (default). */
+  struct imma_accessor_cache *accessorCache;
+
+  /* Runtime attribute updates held back for coalescing, managed by
+   * environment variable IMMA_OI_RT_UPDATE_COALESCE_MSEC. NULL => every
+   * update is sent immediately (default). */
+  struct imma_rt_coalesce *rtCoalesce;
 } IMMA_CLIENT_NODE;
 
 /* Node to store adminOwner info */
@@ -25,6 +25,8 @@
 *****************************************************************************/
 
 #include "imma.h"
+#include "imma_cache.h"
+#include "imma_rt_coalesce.h"
 #include "base/osaf_extended_name.h"
 
 /****************************************************************************
@@ -113,6 +115,12 @@ uint32_t imma_client_node_delete(IMMA_CB *cb, IMMA_CLIENT_NODE *cl_node) {
     imma_oi_ccb_record_delete(cl_node, cl_node->activeOiCcbs->ccbId);
   }
 
+  imma_accessor_cache_destroy(cl_node->accessorCache);
+  cl_node->accessorCache = NULL;
+
+  imma_rt_coalesce_destroy(cl_node->rtCoalesce);
+  cl_node->rtCoalesce = NULL;
+
   free(cl_node);
 
   return rc;
@@ -690,6 +698,11 @@ void imma_mark_clients_stale(IMMA_CB *cb, bool mark_exposed) {
       exit(1);
     }
 
+    /* Invalidations from the IMMND may have been lost. */
+    if (clnode->accessorCache) {
+      imma_accessor_cache_clear(clnode->accessorCache);
+    }
+
     /* Process OM side CCBs */
     while ((ccb_node = (IMMA_CCB_NODE *)ncs_patricia_tree_getnext(
                 &cb->ccb_tree, (uint8_t *)ccb_temp_ptr))) {
@@ -40,6 +40,7 @@ TRACE GUIDE:
 #include "imma.h"
 #include "imm/common/immsv_api.h"
 #include "base/osaf_extended_name.h"
+#include "imma_rt_coalesce.h"
 
 static const char *sysaClName = SA_IMM_ATTR_CLASS_NAME;
 static const char *sysaAdmName = SA_IMM_ATTR_ADMIN_OWNER_NAME;
@@ -47,6 +48,7 @@ static const char *sysaImplName = SA_IMM_ATTR_IMPLEMENTER_NAME;
 
 static int imma_oi_resurrect(IMMA_CB *cb, IMMA_CLIENT_NODE *cl_node,
                              bool *locked, SaAisErrorT *err_cli_res);
+static void rt_update_timer_expiry(void *arg);
 
 /****************************************************************************
   Name          :  SaImmOiInitialize_2/_o3
@@ -337,6 +339,20 @@ SaAisErrorT initialize_common(SaImmOiHandleT *immOiHandle,
         goto node_add_fail;
       }
     }
+
+    if ((timeout_env_value = getenv("IMMA_OI_RT_UPDATE_COALESCE_MSEC"))) {
+      char *endp = NULL;
+      unsigned long msec = strtoul(timeout_env_value, &endp, 10);
+      if (!*timeout_env_value || *endp) {
+        TRACE_2(
+            "Failed to parse IMMA_OI_RT_UPDATE_COALESCE_MSEC. "
+            "Runtime attribute updates will not be coalesced");
+      } else if (msec) {
+        cl_node->rtCoalesce = imma_rt_coalesce_create(
+            msec, rt_update_timer_expiry, (void *)(uintptr_t)cl_node->handle);
+        TRACE_1("Runtime attribute updates coalesced within %lu msec", msec);
+      }
+    }
   } else {
     TRACE_4("ERR_LIBRARY: Empty reply received");
     rc = SA_AIS_ERR_LIBRARY;
@@ -544,6 +560,10 @@ SaAisErrorT saImmOiDispatch(SaImmOiHandleT immOiHandle,
     goto fail;
   }
 
+  /* Held back rt updates whose window has passed are sent from here when
+     the implementer makes no further updates. */
+  imma_oi_rt_update_flush(immOiHandle, true);
+
   if (m_NCS_LOCK(&cb->cb_lock, NCS_LOCK_WRITE) != NCSCC_RC_SUCCESS) {
     TRACE_4("ERR_LIBRARY: LOCK failed");
     rc = SA_AIS_ERR_LIBRARY;
@@ -707,6 +727,9 @@ SaAisErrorT saImmOiFinalize(SaImmOiHandleT immOiHandle) {
 
   /* No check for immnd_up here because this is finalize, see below. */
 
+  /* Held back rt updates would otherwise be lost. */
+  imma_oi_rt_update_flush(immOiHandle, false);
+
   if (m_NCS_LOCK(&cb->cb_lock, NCS_LOCK_WRITE) != NCSCC_RC_SUCCESS) {
     TRACE_4("ERR_LIBRARY: LOCK failed");
     rc = SA_AIS_ERR_LIBRARY;
@@ -1535,6 +1558,9 @@ SaAisErrorT saImmOiImplementerClear(SaImmOiHandleT immOiHandle) {
     return SA_AIS_ERR_TRY_AGAIN;
   }
 
+  /* Held back rt updates need the implementer. */
+  imma_oi_rt_update_flush(immOiHandle, false);
+
   /* get the CB Lock */
   if (m_NCS_LOCK(&cb->cb_lock, NCS_LOCK_WRITE) != NCSCC_RC_SUCCESS) {
     rc = SA_AIS_ERR_LIBRARY;
@@ -2526,88 +2552,40 @@ SaAisErrorT saImmOiRtObjectUpdate_o3(
   return rt_object_update_common(immOiHandle, objectName, attrMods, true);
 }
 
-static SaAisErrorT rt_object_update_common(
-    SaImmOiHandleT immOiHandle, SaConstStringT objectName,
-    const SaImmAttrModificationT_2 **attrMods, bool isObjectDnUsed) {
+/* Validates immOiHandle for runtime object updates, resurrecting the handle
+   if it is stale. Called with the CB lock held. On return *locked is false
+   only if the lock could not be retaken after a resurrect. */
+static SaAisErrorT rt_update_client_get(IMMA_CB *cb, SaImmOiHandleT immOiHandle,
+                                        IMMA_CLIENT_NODE **client_node,
+                                        bool *locked) {
   SaAisErrorT rc = SA_AIS_OK;
-  uint32_t proc_rc = NCSCC_RC_SUCCESS;
-  IMMA_CB *cb = &imma_cb;
-  IMMSV_EVT evt;
-  IMMSV_EVT *out_evt = NULL;
   IMMA_CLIENT_NODE *cl_node = NULL;
-  bool locked = true;
-  SaTimeT timeout = 0;
-
-  if (cb->sv_id == 0) {
-    TRACE_2("ERR_BAD_HANDLE: No initialized handle exists!");
-    return SA_AIS_ERR_BAD_HANDLE;
-  }
-
-  TRACE_ENTER();
-
-  if ((objectName == NULL) ||
-      !(osaf_is_extended_names_enabled() ||
-        strlen(objectName) < SA_MAX_UNEXTENDED_NAME_LENGTH) ||
-      !objectName[0]) {
-    TRACE_2(
-        "ERR_INVALID_PARAM: objectName is NULL, "
-        "invalid or length is 0");
-    TRACE_LEAVE();
-    return SA_AIS_ERR_INVALID_PARAM;
-  }
-
-  if (attrMods == NULL) {
-    TRACE_2("ERR_INVALID_PARAM: attrMods is NULL");
-    TRACE_LEAVE();
-    return SA_AIS_ERR_INVALID_PARAM;
-  }
-
-  if (false == cb->is_immnd_up) {
-    TRACE_2("ERR_TRY_AGAIN: IMMND is DOWN");
-    return SA_AIS_ERR_TRY_AGAIN;
-  }
-
-  /* get the CB Lock */
-  if (m_NCS_LOCK(&cb->cb_lock, NCS_LOCK_WRITE) != NCSCC_RC_SUCCESS) {
-    rc = SA_AIS_ERR_LIBRARY;
-    TRACE_4("ERR_LIBRARY: Lock failed");
-    goto lock_fail;
-  }
-  /*locked == true already */
 
   imma_client_node_get(&cb->client_tree, &immOiHandle, &cl_node);
   if (!cl_node || cl_node->isOm) {
-    rc = SA_AIS_ERR_BAD_HANDLE;
     TRACE_2("ERR_BAD_HANDLE: Non valid SaImmOiHandleT");
-    goto bad_handle;
+    return SA_AIS_ERR_BAD_HANDLE;
   }
 
-  if (isObjectDnUsed && !cl_node->isImmA2f) {
-    rc = SA_AIS_ERR_VERSION;
-    TRACE_2("ERR_VERSION: saImmOiRtObjectUpdate_o3 is supported from A.2.15");
-    goto bad_handle;
-  }
   if (cl_node->isImmA2x12 && cl_node->clmExposed) {
     TRACE_2("SA_AIS_ERR_UNAVAILABLE: imma CLM node left the cluster");
-    rc = SA_AIS_ERR_UNAVAILABLE;
-    goto clm_left;
+    return SA_AIS_ERR_UNAVAILABLE;
   }
 
   if (cl_node->stale) {
     TRACE_1("Handle %llx is stale", immOiHandle);
-    bool resurrected = imma_oi_resurrect(cb, cl_node, &locked, &rc);
+    bool resurrected = imma_oi_resurrect(cb, cl_node, locked, &rc);
     if (rc == SA_AIS_ERR_TRY_AGAIN) {
       osafassert(!resurrected);
-      goto bad_handle; /* Handle is actually not bad yet. */
+      return rc; /* Handle is actually not bad yet. */
     }
 
-    if (!locked &&
+    if (!*locked &&
         m_NCS_LOCK(&cb->cb_lock, NCS_LOCK_WRITE) != NCSCC_RC_SUCCESS) {
       TRACE_4("ERR_LIBRARY: LOCK failed");
-      rc = SA_AIS_ERR_LIBRARY;
-      goto lock_fail;
+      return SA_AIS_ERR_LIBRARY;
     }
-    locked = true;
+    *locked = true;
 
     imma_client_node_get(&cb->client_tree, &immOiHandle, &cl_node);
 
@@ -2617,44 +2595,33 @@ static SaAisErrorT rt_object_update_common(
       if (cl_node && cl_node->stale) {
         cl_node->exposed = true;
       }
-      rc = SA_AIS_ERR_BAD_HANDLE;
-      goto bad_handle;
+      return SA_AIS_ERR_BAD_HANDLE;
     }
 
     TRACE_1("Reactive resurrect of handle %llx succeeded", immOiHandle);
   }
 
   if (cl_node->mImplementerId == 0) {
-    rc = SA_AIS_ERR_BAD_OPERATION;
     LOG_ER(
         "ERR_BAD_OPERATION: The SaImmOiHandleT is not associated with any implementer name");
-    goto bad_handle;
+    return SA_AIS_ERR_BAD_OPERATION;
   }
 
   if (cl_node->isApplier) {
-    rc = SA_AIS_ERR_BAD_OPERATION;
     LOG_ER(
         "ERR_BAD_OPERATION: The SaImmOiHandleT is associated with an >>applier<< name");
-    goto bad_handle;
+    return SA_AIS_ERR_BAD_OPERATION;
   }
 
-  timeout = cl_node->syncr_timeout;
-
-  /* Populate the Object-Update event */
-  memset(&evt, 0, sizeof(IMMSV_EVT));
-  evt.type = IMMSV_EVT_TYPE_IMMND;
-  evt.info.immnd.type = IMMND_EVT_A2ND_OI_OBJ_MODIFY;
-
-  evt.info.immnd.info.objModify.immHandle = immOiHandle;
-
-  /*NOTE: should rename member adminOwnerId !!! */
-  evt.info.immnd.info.objModify.adminOwnerId = cl_node->mImplementerId;
-
-  evt.info.immnd.info.objModify.objectName.size = strlen(objectName) + 1;
-  evt.info.immnd.info.objModify.objectName.buf = (char *)objectName;
-
-  osafassert(evt.info.immnd.info.objModify.attrMods == NULL);
+  *client_node = cl_node;
+  return SA_AIS_OK;
+}
 
+/* Converts attrMods to the IMMSv representation in *modsList, which the
+   caller frees with immsv_free_attrmods(). */
+static SaAisErrorT rt_update_attr_mods(
+    const SaImmAttrModificationT_2 **attrMods,
+    IMMSV_ATTR_MODS_LIST **modsList) {
   const SaImmAttrModificationT_2 *attrMod;
   int i;
   for (i = 0; attrMods[i]; ++i) {
@@ -2663,15 +2630,14 @@ static SaAisErrorT rt_object_update_common(
     /* TODO Check that the user does not set values for System attributes. */
 
     /* Prevent duplicate attribute assignments */
-    IMMSV_ATTR_MODS_LIST *p = evt.info.immnd.info.objModify.attrMods;
+    IMMSV_ATTR_MODS_LIST *p = *modsList;
     while (p != NULL) {
       if (strcmp(attrMod->modAttr.attrName, p->attrValue.attrName.buf) == 0) {
-        rc = SA_AIS_ERR_INVALID_PARAM;
         TRACE_2(
             "ERR_INVALID_PARAM: Attribute %s occurs multiple times "
             "in attrMods parameter",
             attrMod->modAttr.attrName);
-        goto skip_over_send;
+        return SA_AIS_ERR_INVALID_PARAM;
       }
 
       p = p->next;
@@ -2715,8 +2681,40 @@ static SaAisErrorT rt_object_update_common(
       TRACE_3("Strange update of attribute %s, without any modifications",
               attrMod->modAttr.attrName);
     }
-    p->next = evt.info.immnd.info.objModify.attrMods; /*NULL initially. */
-    evt.info.immnd.info.objModify.attrMods = p;
+    p->next = *modsList; /*NULL initially. */
+    *modsList = p;
+  }
+
+  return SA_AIS_OK;
+}
+
+/* Sends one runtime update event to the IMMND and waits for the reply.
+   Called with the CB lock held and a validated handle. The lock is released
+   during the send. On return *locked tells if the lock is held; the caller
+   must fetch the client node again. If errObject is not NULL and the IMMND
+   names the object that failed, *errObject is set to that name, to be freed
+   by the caller. */
+static SaAisErrorT rt_update_send(IMMA_CB *cb, SaImmOiHandleT immOiHandle,
+                                  IMMSV_EVT *evt, SaTimeT timeout,
+                                  bool *locked, char **errObject) {
+  SaAisErrorT rc = SA_AIS_OK;
+  uint32_t proc_rc = NCSCC_RC_SUCCESS;
+  IMMSV_EVT *out_evt = NULL;
+  IMMA_CLIENT_NODE *cl_node = NULL;
+
+  if (errObject) {
+    *errObject = NULL;
+  }
+
+  if (!*locked) {
+    TRACE_4("ERR_LIBRARY: rt update sent without the CB lock");
+    return SA_AIS_ERR_LIBRARY;
+  }
+
+  imma_client_node_get(&cb->client_tree, &immOiHandle, &cl_node);
+  if (!cl_node || cl_node->isOm) {
+    TRACE_2("ERR_BAD_HANDLE: client_node_get failed");
+    return SA_AIS_ERR_BAD_HANDLE;
   }
 
   /* We do not send the rt update over fevs, because the update may
@@ -2728,12 +2726,12 @@ static SaAisErrorT rt_object_update_common(
   if ((rc = imma_proc_increment_pending_reply(cl_node, true)) != SA_AIS_OK) {
     TRACE_4(
         "ERR_LIBRARY: Overlapping use of IMM OI handle by multiple threads");
-    goto bad_sync;
+    return rc;
   }
 
   /* Release the CB lock Before MDS Send */
   m_NCS_UNLOCK(&cb->cb_lock, NCS_LOCK_WRITE);
-  locked = false;
+  *locked = false;
   cl_node = NULL;
 
   if (false == cb->is_immnd_up) {
@@ -2743,7 +2741,7 @@ static SaAisErrorT rt_object_update_common(
   }
 
   /* send the request to the IMMND */
-  proc_rc = imma_mds_msg_sync_send(cb->imma_mds_hdl, &cb->immnd_mds_dest, &evt,
+  proc_rc = imma_mds_msg_sync_send(cb->imma_mds_hdl, &cb->immnd_mds_dest, evt,
                                    &out_evt, timeout);
 
   /* Error Handling */
@@ -2757,7 +2755,7 @@ static SaAisErrorT rt_object_update_common(
       TRACE_4("ERR_LIBRARY: MDS returned unexpected error code %u", proc_rc);
       rc = SA_AIS_ERR_LIBRARY;
       /* Losing track of the pending reply count, but ERR_LIBRARY dominates*/
-      goto bad_handle;
+      goto done;
   }
 
 mds_send_fail:
@@ -2766,15 +2764,15 @@ mds_send_fail:
     rc = SA_AIS_ERR_LIBRARY;
     /* Losing track of the pending reply count, but ERR_LIBRARY dominates*/
     TRACE_4("ERR_LIBRARY: Lock failed");
-    goto free_obj; /* locked will be false */
+    goto done;
   }
-  locked = true;
+  *locked = true;
 
   imma_client_node_get(&cb->client_tree, &immOiHandle, &cl_node);
   if (!cl_node || cl_node->isOm) {
     rc = SA_AIS_ERR_BAD_HANDLE;
     TRACE_2("ERR_BAD_HANDLE: client_node_get failed");
-    goto bad_handle1;
+    goto done;
   }
 
   imma_proc_decrement_pending_reply(cl_node, true);
@@ -2783,59 +2781,513 @@ mds_send_fail:
     TRACE_1("Handle %llx is stale", immOiHandle);
     rc = SA_AIS_ERR_BAD_HANDLE;
     cl_node->exposed = true;
-    goto bad_handle1;
+    goto done;
   }
 
   if (out_evt) {
     /* Process the outcome, note this is after a blocking call. */
-    osafassert(out_evt->type == IMMSV_EVT_TYPE_IMMA);
-    osafassert(out_evt->info.imma.type == IMMA_EVT_ND2A_IMM_ERROR);
+    IMMSV_SAERR_INFO *errRsp = &out_evt->info.imma.info.errRsp;
+    if ((out_evt->type != IMMSV_EVT_TYPE_IMMA) ||
+        ((out_evt->info.imma.type != IMMA_EVT_ND2A_IMM_ERROR) &&
+         (out_evt->info.imma.type != IMMA_EVT_ND2A_IMM_ERROR_2))) {
+      TRACE_4("ERR_LIBRARY: Unexpected reply to rt update, type %u",
+              out_evt->info.imma.type);
+      rc = SA_AIS_ERR_LIBRARY;
+      goto done;
+    }
     if (rc == SA_AIS_OK) {
-      rc = out_evt->info.imma.info.errRsp.error;
+      rc = errRsp->error;
+    }
+    if (out_evt->info.imma.type == IMMA_EVT_ND2A_IMM_ERROR_2) {
+      /* The batch reply names the object that failed */
+      if (errObject && (rc != SA_AIS_OK) && errRsp->errStrings) {
+        *errObject = errRsp->errStrings->name.buf;
+        errRsp->errStrings->name.buf = NULL;
+        errRsp->errStrings->name.size = 0;
+      }
+      immsv_evt_free_attrNames(errRsp->errStrings);
+      errRsp->errStrings = NULL;
     }
   }
 
-clm_left:
-skip_over_send:
-bad_sync:
-bad_handle1:
-free_obj:
+done:
+  if (out_evt) free(out_evt);
 
-  while (evt.info.immnd.info.objModify.attrMods) {
-    IMMSV_ATTR_MODS_LIST *p = evt.info.immnd.info.objModify.attrMods;
-    evt.info.immnd.info.objModify.attrMods = p->next;
-    p->next = NULL;
+  return rc;
+}
 
-    if (p->attrValue.attrName.buf) {
-      free(p->attrValue.attrName.buf); /*free-3 */
-      p->attrValue.attrName.buf = NULL;
+/* Sends the runtime updates in list, at most
+   IMMSV_MAX_OBJS_IN_RT_UPDATE_BATCH objects per message. An IMMND that
+   has not been upgraded to protocol 5.2 replies SA_AIS_ERR_NOT_SUPPORTED,
+   then the objects are sent one by one instead. Stops at the first error,
+   *failed is set to the element of list that failed, or NULL if the error
+   is not for one object. Same locking as rt_update_send(). */
+static SaAisErrorT rt_update_send_batch(IMMA_CB *cb, SaImmOiHandleT immOiHandle,
+                                        SaUint32T implementerId,
+                                        SaTimeT timeout,
+                                        IMMSV_OI_RT_MODIFY_LIST *list,
+                                        bool *locked,
+                                        IMMSV_OI_RT_MODIFY_LIST **failed) {
+  SaAisErrorT rc = SA_AIS_OK;
+  IMMSV_EVT evt;
+  bool batchSupported = true;
+
+  *failed = NULL;
+
+  while (list && rc == SA_AIS_OK) {
+    IMMSV_OI_RT_MODIFY_LIST *last = list;
+    IMMSV_OI_RT_MODIFY_LIST *p;
+    int count = 1;
+
+    for (p = list; p; p = p->next) {
+      p->objModify.immHandle = immOiHandle;
+      /*NOTE: should rename member adminOwnerId !!! */
+      p->objModify.adminOwnerId = implementerId;
     }
 
-    if (p->attrValue.attrValuesNumber) {
-      immsv_evt_free_att_val(&(p->attrValue.attrValue), /*free-4 */
-                             (SaImmValueTypeT)p->attrValue.attrValueType);
-
-      while (p->attrValue.attrMoreValues) {
-        IMMSV_EDU_ATTR_VAL_LIST *al = p->attrValue.attrMoreValues;
-        p->attrValue.attrMoreValues = al->next;
-        al->next = NULL;
-        immsv_evt_free_att_val(
-            &(al->n), (SaImmValueTypeT)p->attrValue.attrValueType); /*free-6 */
-        free(al);                                                   /*free-5 */
+    while (last->next && count < IMMSV_MAX_OBJS_IN_RT_UPDATE_BATCH) {
+      last = last->next;
+      ++count;
+    }
+    IMMSV_OI_RT_MODIFY_LIST *rest = last->next;
+    last->next = NULL;
+
+    if (batchSupported) {
+      TRACE("Sending batch of %d rt updates", count);
+      memset(&evt, 0, sizeof(IMMSV_EVT));
+      evt.type = IMMSV_EVT_TYPE_IMMND;
+      evt.info.immnd.type = IMMND_EVT_A2ND_OI_OBJ_MODIFY_BATCH;
+      evt.info.immnd.info.rtModifyBatch = *list;
+      char *errObject = NULL;
+      rc = rt_update_send(cb, immOiHandle, &evt, timeout, locked, &errObject);
+      if (rc == SA_AIS_ERR_NOT_SUPPORTED) {
+        TRACE_2("Batched rt update not supported by IMMND, sending 1 by 1");
+        batchSupported = false;
+        rc = SA_AIS_OK;
+      } else if (errObject) {
+        for (p = list; p && !*failed; p = p->next) {
+          if (strcmp(p->objModify.objectName.buf, errObject) == 0) {
+            *failed = p;
+          }
+        }
+        free(errObject);
+      }
+    }
+
+    if (!batchSupported) {
+      for (p = list; p && rc == SA_AIS_OK; p = p->next) {
+        memset(&evt, 0, sizeof(IMMSV_EVT));
+        evt.type = IMMSV_EVT_TYPE_IMMND;
+        evt.info.immnd.type = IMMND_EVT_A2ND_OI_OBJ_MODIFY;
+        evt.info.immnd.info.objModify = p->objModify;
+        rc = rt_update_send(cb, immOiHandle, &evt, timeout, locked, NULL);
+        if (rc != SA_AIS_OK) {
+          *failed = p;
+        }
       }
     }
 
-    free(p); /*free-2 */
+    last->next = rest;
+    list = rest;
+  }
+
+  return rc;
+}
+
+/* Sends the runtime updates held back for coalescing, if any. The error of
+   a held back update is kept for immsv_oi_rt_object_update_flush(), the
+   call that sent it did not make the update. Same locking as
+   rt_update_send(). */
+static SaAisErrorT rt_update_flush(IMMA_CB *cb, IMMA_CLIENT_NODE *cl_node,
+                                   bool *locked) {
+  SaAisErrorT rc = SA_AIS_OK;
+  SaImmOiHandleT immOiHandle = cl_node->handle;
+  IMMSV_OI_RT_MODIFY_LIST *held = imma_rt_coalesce_take(cl_node->rtCoalesce);
+
+  if (held) {
+    IMMSV_OI_RT_MODIFY_LIST *failed = NULL;
+    rc = rt_update_send_batch(cb, immOiHandle, cl_node->mImplementerId,
+                              cl_node->syncr_timeout, held, locked, &failed);
+    if (rc != SA_AIS_OK) {
+      const char *objectName =
+          failed ? failed->objModify.objectName.buf : NULL;
+      TRACE_2("Sending held back rt updates failed: %u, object: %s", rc,
+              objectName ? objectName : "-");
+      /* The client node may be gone after the send */
+      cl_node = NULL;
+      if (*locked) {
+        imma_client_node_get(&cb->client_tree, &immOiHandle, &cl_node);
+      }
+      if (cl_node && cl_node->rtCoalesce) {
+        imma_rt_coalesce_failed(cl_node->rtCoalesce, rc, objectName);
+      }
+    }
+    immsv_free_rt_modify_batch(held);
+    free(held);
+  }
+
+  return rc;
+}
+
+SaAisErrorT imma_oi_rt_update_flush(SaImmOiHandleT immOiHandle,
+                                    bool onlyExpired) {
+  SaAisErrorT rc = SA_AIS_OK;
+  IMMA_CB *cb = &imma_cb;
+  IMMA_CLIENT_NODE *cl_node = NULL;
+  bool locked = true;
+
+  if (cb->sv_id == 0) {
+    TRACE_2("ERR_BAD_HANDLE: No initialized handle exists!");
+    return SA_AIS_ERR_BAD_HANDLE;
+  }
+
+  if (m_NCS_LOCK(&cb->cb_lock, NCS_LOCK_WRITE) != NCSCC_RC_SUCCESS) {
+    TRACE_4("ERR_LIBRARY: Lock failed");
+    return SA_AIS_ERR_LIBRARY;
+  }
+
+  imma_client_node_get(&cb->client_tree, &immOiHandle, &cl_node);
+  if (!cl_node || cl_node->isOm) {
+    rc = SA_AIS_ERR_BAD_HANDLE;
+    TRACE_2("ERR_BAD_HANDLE: Non valid SaImmOiHandleT");
+    goto done;
+  }
+
+  if (!cl_node->rtCoalesce ||
+      !imma_rt_coalesce_pending(cl_node->rtCoalesce) ||
+      (onlyExpired && !imma_rt_coalesce_expired(cl_node->rtCoalesce))) {
+    goto done;
+  }
+
+  if (false == cb->is_immnd_up) {
+    rc = SA_AIS_ERR_TRY_AGAIN;
+    TRACE_2("ERR_TRY_AGAIN: IMMND is DOWN");
+    goto done;
+  }
+
+  rc = rt_update_client_get(cb, immOiHandle, &cl_node, &locked);
+  if (rc == SA_AIS_OK) {
+    rc = rt_update_flush(cb, cl_node, &locked);
+  }
+
+done:
+  if (locked) {
+    m_NCS_UNLOCK(&cb->cb_lock, NCS_LOCK_WRITE);
+  }
+
+  return rc;
+}
+
+/* Called from the timer thread when the window of the first held back
+   update has passed. The sending is left to saImmOiDispatch of the
+   implementer, woken up by a callback message, since the OI handle may be
+   in use by another thread. */
+static void rt_update_timer_expiry(void *arg) {
+  IMMA_CB *cb = &imma_cb;
+  IMMA_CLIENT_NODE *cl_node = NULL;
+  SaImmOiHandleT immOiHandle = (SaImmOiHandleT)(uintptr_t)arg;
+
+  if (m_NCS_LOCK(&cb->cb_lock, NCS_LOCK_WRITE) != NCSCC_RC_SUCCESS) {
+    TRACE_4("ERR_LIBRARY: Lock failed");
+    return;
+  }
+
+  imma_client_node_get(&cb->client_tree, &immOiHandle, &cl_node);
+  if (cl_node && !cl_node->isOm && cl_node->rtCoalesce &&
+      imma_rt_coalesce_timer_expired(cl_node->rtCoalesce) &&
+      cl_node->selObjUsable) {
+    IMMA_CALLBACK_INFO *callback =
+        (IMMA_CALLBACK_INFO *)calloc(1, sizeof(IMMA_CALLBACK_INFO));
+    osafassert(callback);
+    callback->type = IMMA_CALLBACK_OI_RT_UPDATE_FLUSH;
+    callback->lcl_imm_hdl = immOiHandle;
+    if (m_NCS_IPC_SEND(&cl_node->callbk_mbx, callback,
+                       NCS_IPC_PRIORITY_NORMAL) != NCSCC_RC_SUCCESS) {
+      TRACE_3("Failed to post rt update flush ipc-message");
+      free(callback);
+    }
+  }
+
+  m_NCS_UNLOCK(&cb->cb_lock, NCS_LOCK_WRITE);
+}
+
+SaAisErrorT immsv_oi_rt_object_update_flush(SaImmOiHandleT immOiHandle,
+                                            SaStringT *failedObject) {
+  IMMA_CB *cb = &imma_cb;
+  IMMA_CLIENT_NODE *cl_node = NULL;
+  TRACE_ENTER();
+
+  if (failedObject) {
+    *failedObject = NULL;
+  }
+
+  SaAisErrorT rc = imma_oi_rt_update_flush(immOiHandle, false);
+  if ((rc == SA_AIS_ERR_BAD_HANDLE) || (rc == SA_AIS_ERR_LIBRARY)) {
+    TRACE_LEAVE();
+    return rc;
+  }
+
+  /* The error of the first held back update that failed, in this or an
+     earlier sending of held back updates */
+  if (m_NCS_LOCK(&cb->cb_lock, NCS_LOCK_WRITE) != NCSCC_RC_SUCCESS) {
+    TRACE_4("ERR_LIBRARY: Lock failed");
+    TRACE_LEAVE();
+    return SA_AIS_ERR_LIBRARY;
+  }
+  imma_client_node_get(&cb->client_tree, &immOiHandle, &cl_node);
+  if (cl_node && !cl_node->isOm && cl_node->rtCoalesce) {
+    SaAisErrorT heldRc =
+        imma_rt_coalesce_take_error(cl_node->rtCoalesce, failedObject);
+    if (heldRc != SA_AIS_OK) {
+      rc = heldRc;
+    }
+  }
+  m_NCS_UNLOCK(&cb->cb_lock, NCS_LOCK_WRITE);
+
+  TRACE_LEAVE();
+  return rc;
+}
+
+SaAisErrorT immsv_oi_rt_object_update_batch(
+    SaImmOiHandleT immOiHandle, const ImmsvRtObjectUpdateT **updates,
+    SaUint32T *failedUpdate) {
+  SaAisErrorT rc = SA_AIS_OK;
+  IMMA_CB *cb = &imma_cb;
+  IMMA_CLIENT_NODE *cl_node = NULL;
+  IMMSV_OI_RT_MODIFY_LIST *list = NULL;
+  IMMSV_OI_RT_MODIFY_LIST **tail = &list;
+  IMMSV_OI_RT_MODIFY_LIST *failed = NULL;
+  bool locked = true;
+  int i;
+
+  if (cb->sv_id == 0) {
+    TRACE_2("ERR_BAD_HANDLE: No initialized handle exists!");
+    return SA_AIS_ERR_BAD_HANDLE;
+  }
+
+  TRACE_ENTER();
+
+  if (updates == NULL || updates[0] == NULL) {
+    TRACE_2("ERR_INVALID_PARAM: updates is NULL or empty");
+    TRACE_LEAVE();
+    return SA_AIS_ERR_INVALID_PARAM;
+  }
+
+  for (i = 0; updates[i]; ++i) {
+    SaConstStringT objectName = updates[i]->objectName;
+    if ((objectName == NULL) ||
+        !(osaf_is_extended_names_enabled() ||
+          strlen(objectName) < SA_MAX_UNEXTENDED_NAME_LENGTH) ||
+        !objectName[0]) {
+      TRACE_2(
+          "ERR_INVALID_PARAM: objectName of update %d is NULL, "
+          "invalid or length is 0",
+          i);
+      TRACE_LEAVE();
+      return SA_AIS_ERR_INVALID_PARAM;
+    }
+
+    if (updates[i]->attrMods == NULL) {
+      TRACE_2("ERR_INVALID_PARAM: attrMods of update %d is NULL", i);
+      TRACE_LEAVE();
+      return SA_AIS_ERR_INVALID_PARAM;
+    }
+  }
+
+  if (false == cb->is_immnd_up) {
+    TRACE_2("ERR_TRY_AGAIN: IMMND is DOWN");
+    TRACE_LEAVE();
+    return SA_AIS_ERR_TRY_AGAIN;
+  }
+
+  /* get the CB Lock */
+  if (m_NCS_LOCK(&cb->cb_lock, NCS_LOCK_WRITE) != NCSCC_RC_SUCCESS) {
+    rc = SA_AIS_ERR_LIBRARY;
+    TRACE_4("ERR_LIBRARY: Lock failed");
+    goto lock_fail;
+  }
+  /*locked == true already */
+
+  rc = rt_update_client_get(cb, immOiHandle, &cl_node, &locked);
+  if (rc != SA_AIS_OK) {
+    goto done;
+  }
+
+  for (i = 0; updates[i]; ++i) {
+    IMMSV_OI_RT_MODIFY_LIST *rtMod = (IMMSV_OI_RT_MODIFY_LIST *)calloc(
+        1, sizeof(IMMSV_OI_RT_MODIFY_LIST));
+    rtMod->objModify.objectName.size = strlen(updates[i]->objectName) + 1;
+    rtMod->objModify.objectName.buf = strdup(updates[i]->objectName);
+    *tail = rtMod;
+    tail = &rtMod->next;
+
+    rc = rt_update_attr_mods(updates[i]->attrMods, &rtMod->objModify.attrMods);
+    if (rc != SA_AIS_OK) {
+      goto done;
+    }
+  }
+
+  /* Updates held back for coalescing are older, they go first. Their
+     errors are kept for immsv_oi_rt_object_update_flush(). */
+  if (cl_node->rtCoalesce && imma_rt_coalesce_pending(cl_node->rtCoalesce)) {
+    rt_update_flush(cb, cl_node, &locked);
+    if (!locked) {
+      rc = SA_AIS_ERR_LIBRARY;
+      goto done;
+    }
+    rc = rt_update_client_get(cb, immOiHandle, &cl_node, &locked);
+    if (rc != SA_AIS_OK) {
+      goto done;
+    }
+  }
+
+  rc = rt_update_send_batch(cb, immOiHandle, cl_node->mImplementerId,
+                            cl_node->syncr_timeout, list, &locked, &failed);
+
+  if (failed && failedUpdate) {
+    IMMSV_OI_RT_MODIFY_LIST *p = list;
+    for (*failedUpdate = 0; p != failed; p = p->next) {
+      ++*failedUpdate;
+    }
+  }
+
+done:
+  if (list) {
+    immsv_free_rt_modify_batch(list);
+    free(list);
   }
 
-bad_handle:
   if (locked) {
     m_NCS_UNLOCK(&cb->cb_lock, NCS_LOCK_WRITE);
   }
 
 lock_fail:
-  if (out_evt) free(out_evt);
+  TRACE_LEAVE();
+  return rc;
+}
+
+static SaAisErrorT rt_object_update_common(
+    SaImmOiHandleT immOiHandle, SaConstStringT objectName,
+    const SaImmAttrModificationT_2 **attrMods, bool isObjectDnUsed) {
+  SaAisErrorT rc = SA_AIS_OK;
+  IMMA_CB *cb = &imma_cb;
+  IMMSV_EVT evt;
+  IMMA_CLIENT_NODE *cl_node = NULL;
+  bool locked = true;
+  SaTimeT timeout = 0;
+
+  if (cb->sv_id == 0) {
+    TRACE_2("ERR_BAD_HANDLE: No initialized handle exists!");
+    return SA_AIS_ERR_BAD_HANDLE;
+  }
+
+  TRACE_ENTER();
+
+  if ((objectName == NULL) ||
+      !(osaf_is_extended_names_enabled() ||
+        strlen(objectName) < SA_MAX_UNEXTENDED_NAME_LENGTH) ||
+      !objectName[0]) {
+    TRACE_2(
+        "ERR_INVALID_PARAM: objectName is NULL, "
+        "invalid or length is 0");
+    TRACE_LEAVE();
+    return SA_AIS_ERR_INVALID_PARAM;
+  }
+
+  if (attrMods == NULL) {
+    TRACE_2("ERR_INVALID_PARAM: attrMods is NULL");
+    TRACE_LEAVE();
+    return SA_AIS_ERR_INVALID_PARAM;
+  }
+
+  if (false == cb->is_immnd_up) {
+    TRACE_2("ERR_TRY_AGAIN: IMMND is DOWN");
+    return SA_AIS_ERR_TRY_AGAIN;
+  }
+
+  memset(&evt, 0, sizeof(IMMSV_EVT));
+
+  /* get the CB Lock */
+  if (m_NCS_LOCK(&cb->cb_lock, NCS_LOCK_WRITE) != NCSCC_RC_SUCCESS) {
+    rc = SA_AIS_ERR_LIBRARY;
+    TRACE_4("ERR_LIBRARY: Lock failed");
+    goto lock_fail;
+  }
+  /*locked == true already */
+
+  imma_client_node_get(&cb->client_tree, &immOiHandle, &cl_node);
+  if (cl_node && !cl_node->isOm && isObjectDnUsed && !cl_node->isImmA2f) {
+    rc = SA_AIS_ERR_VERSION;
+    TRACE_2("ERR_VERSION: saImmOiRtObjectUpdate_o3 is supported from A.2.15");
+    goto bad_handle;
+  }
+
+  rc = rt_update_client_get(cb, immOiHandle, &cl_node, &locked);
+  if (rc != SA_AIS_OK) {
+    goto bad_handle;
+  }
 
+  timeout = cl_node->syncr_timeout;
+
+  /* Populate the Object-Update event */
+  evt.type = IMMSV_EVT_TYPE_IMMND;
+  evt.info.immnd.type = IMMND_EVT_A2ND_OI_OBJ_MODIFY;
+
+  evt.info.immnd.info.objModify.immHandle = immOiHandle;
+
+  /*NOTE: should rename member adminOwnerId !!! */
+  evt.info.immnd.info.objModify.adminOwnerId = cl_node->mImplementerId;
+
+  evt.info.immnd.info.objModify.objectName.size = strlen(objectName) + 1;
+  evt.info.immnd.info.objModify.objectName.buf = (char *)objectName;
+
+  osafassert(evt.info.immnd.info.objModify.attrMods == NULL);
+
+  rc = rt_update_attr_mods(attrMods, &evt.info.immnd.info.objModify.attrMods);
+  if (rc != SA_AIS_OK) {
+    goto skip_over_send;
+  }
+
+  /* Errors of held back updates are not errors of this update, they are
+     kept for immsv_oi_rt_object_update_flush(). */
+  if (cl_node->rtCoalesce) {
+    if (imma_rt_coalesce_eligible(evt.info.immnd.info.objModify.attrMods)) {
+      imma_rt_coalesce_add(cl_node->rtCoalesce, objectName,
+                           evt.info.immnd.info.objModify.attrMods);
+      evt.info.immnd.info.objModify.attrMods = NULL;
+      if (imma_rt_coalesce_expired(cl_node->rtCoalesce) ||
+          imma_rt_coalesce_full(cl_node->rtCoalesce)) {
+        rt_update_flush(cb, cl_node, &locked);
+      }
+      goto skip_over_send;
+    }
+
+    /* Not coalescable. Held back updates must reach the IMMND first
+       to preserve the order of updates. */
+    if (imma_rt_coalesce_pending(cl_node->rtCoalesce)) {
+      rt_update_flush(cb, cl_node, &locked);
+      if (!locked) {
+        rc = SA_AIS_ERR_LIBRARY;
+        goto skip_over_send;
+      }
+      rc = rt_update_client_get(cb, immOiHandle, &cl_node, &locked);
+      if (rc != SA_AIS_OK) {
+        goto skip_over_send;
+      }
+    }
+  }
+
+  rc = rt_update_send(cb, immOiHandle, &evt, timeout, &locked, NULL);
+
+skip_over_send:
+  immsv_free_attrmods(evt.info.immnd.info.objModify.attrMods);
+
+bad_handle:
+  if (locked) {
+    m_NCS_UNLOCK(&cb->cb_lock, NCS_LOCK_WRITE);
+  }
+
+lock_fail:
   TRACE_LEAVE();
   return rc;
 }
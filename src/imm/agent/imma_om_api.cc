@@ -42,6 +42,7 @@
 #include <stdlib.h>
 
 #include "imma.h"
+#include "imma_cache.h"
 #include "imm/common/immsv_api.h"
 #include "osaf/saf/saAis.h"
 #include "base/osaf_extended_name.h"
@@ -375,6 +376,20 @@ static SaAisErrorT initialize_common(SaImmHandleT *immHandle,
     }
     cl_node->searchHandleSize = 0;
 
+    if ((value = getenv("IMMA_ACCESSOR_CACHE_MAX_BYTES"))) {
+      char *endptr;
+      unsigned long long n = strtoull(value, &endptr, 10);
+      if (!*value || *endptr) {
+        LOG_WA(
+            "IMMA_ACCESSOR_CACHE_MAX_BYTES contains non-valid number value. Accessor cache disabled");
+      } else if (n && !cl_node->isImmA2b) {
+        TRACE_2("Accessor cache requires IMM version A.02.11, not enabled");
+      } else if (n) {
+        cl_node->accessorCache = imma_accessor_cache_create(n);
+        TRACE_1("Accessor cache enabled, max %llu bytes", n);
+      }
+    }
+
     TRACE_1("Trying to add OM client id:%u node:%x",
             m_IMMSV_UNPACK_HANDLE_HIGH(cl_node->handle),
             m_IMMSV_UNPACK_HANDLE_LOW(cl_node->handle));
@@ -467,6 +482,7 @@ end:
       rc = SA_AIS_ERR_LIBRARY;
     }
 
+    imma_accessor_cache_destroy(cl_node->accessorCache);
     free(cl_node);
   }
 
@@ -6001,11 +6017,18 @@ release_cb:
   return rc;
 }
 
-static SaAisErrorT accessor_get_common(SaImmAccessorHandleT accessorHandle,
-                                       SaConstStringT objectName,
-                                       const SaImmAttrNameT *attributeNames,
-                                       SaImmAttrValuesT_2 ***attributes,
-                                       bool bUseString, SaUint32T ccbId);
+/* How accessor_get_common may use the accessor cache of the handle. */
+typedef enum {
+  ACCESSOR_CACHE_LOOKUP = 0, /* Serve from cache, fill it on absent entry */
+  ACCESSOR_CACHE_NO_FILL,    /* Serve from cache, never fill */
+  ACCESSOR_CACHE_FILL        /* Fetch all config attrs into the cache */
+} ACCESSOR_CACHE_MODE;
+
+static SaAisErrorT accessor_get_common(
+    SaImmAccessorHandleT accessorHandle, SaConstStringT objectName,
+    const SaImmAttrNameT *attributeNames, SaImmAttrValuesT_2 ***attributes,
+    bool bUseString, SaUint32T ccbId,
+    ACCESSOR_CACHE_MODE cacheMode = ACCESSOR_CACHE_LOOKUP);
 
 SaAisErrorT saImmOmAccessorGet_2(SaImmAccessorHandleT accessorHandle,
                                  const SaNameT *objectName,
@@ -6054,7 +6077,8 @@ static SaAisErrorT accessor_get_common(SaImmAccessorHandleT accessorHandle,
                                        SaConstStringT objectName,
                                        const SaImmAttrNameT *attributeNames,
                                        SaImmAttrValuesT_2 ***attributes,
-                                       bool bUseString, SaUint32T ccbId) {
+                                       bool bUseString, SaUint32T ccbId,
+                                       ACCESSOR_CACHE_MODE cacheMode) {
   SaAisErrorT rc = SA_AIS_OK;
   uint32_t proc_rc;
   bool locked = true;
@@ -6066,6 +6090,7 @@ static SaAisErrorT accessor_get_common(SaImmAccessorHandleT accessorHandle,
   SaTimeT timeout;
   IMMSV_OM_SEARCH_INIT *req = NULL;
   SaImmHandleT immHandle;
+  SaUint64T cacheEpoch = 0;
 
   TRACE_ENTER();
 
@@ -6181,11 +6206,82 @@ static SaAisErrorT accessor_get_common(SaImmAccessorHandleT accessorHandle,
     TRACE_1("Reactive resurrect of handle %llx succeeded", immHandle);
   }
 
+  if (cl_node->accessorCache && (cacheMode != ACCESSOR_CACHE_FILL) &&
+      !ccbId && attributes && imma_accessor_cache_usable(attributeNames)) {
+    SaImmAttrNameT configTunnel[] = {
+        (SaImmAttrNameT) "SA_IMM_SEARCH_GET_CONFIG_ATTR", NULL};
+    SaImmAttrValuesT_2 **configAttrs = NULL;
+    char **rewatch = NULL;
+    size_t numRewatch = 0;
+
+    if (cacheMode == ACCESSOR_CACHE_LOOKUP) {
+      numRewatch =
+          imma_accessor_cache_take_rewatch(cl_node->accessorCache, &rewatch);
+    }
+    if (numRewatch) {
+      /* The IMMND has been down since these objects were cached, and
+         their watches are gone. Fetch them again, which registers the
+         watches with the IMMND now up, then serve the request. */
+      TRACE("Accessor cache refetching %zu objects", numRewatch);
+      m_NCS_UNLOCK(&cb->cb_lock, NCS_LOCK_WRITE);
+      for (size_t ix = 0; ix < numRewatch; ++ix) {
+        (void)accessor_get_common(accessorHandle, rewatch[ix], configTunnel,
+                                  &configAttrs, false, 0, ACCESSOR_CACHE_FILL);
+        free(rewatch[ix]);
+      }
+      free(rewatch);
+      rc = accessor_get_common(accessorHandle, objectName, attributeNames,
+                               attributes, bUseString, 0,
+                               ACCESSOR_CACHE_LOOKUP);
+      TRACE_LEAVE();
+      return rc;
+    }
+
+    SaImmAttrValuesT_2 **attr = NULL;
+    IMMA_CACHE_RESULT cacheRes = imma_accessor_cache_get(
+        cl_node->accessorCache, objectName, attributeNames, &attr,
+        cacheMode == ACCESSOR_CACHE_LOOKUP);
+    if (cacheRes == IMMA_CACHE_HIT) {
+      TRACE("Accessor cache hit for %s", objectName);
+      if (search_node->mLastAttributes) {
+        imma_freeSearchAttrs(
+            (SaImmAttrValuesT_2 **)search_node->mLastAttributes);
+      }
+      free(search_node->mLastObjectName);
+      search_node->mLastObjectName = NULL;
+      *attributes = attr;
+      search_node->mLastAttributes = attr;
+      goto release_lock;
+    }
+
+    if ((cacheRes == IMMA_CACHE_ABSENT) &&
+        (cacheMode == ACCESSOR_CACHE_LOOKUP)) {
+      /* Fetch all config attributes of the object into the cache, then
+         serve the request from the cache. Errors on the fill are the
+         errors the request itself would have got, except INVALID_PARAM
+         which an older IMMND returns for the watch option. */
+      m_NCS_UNLOCK(&cb->cb_lock, NCS_LOCK_WRITE);
+      rc = accessor_get_common(accessorHandle, objectName, configTunnel,
+                               &configAttrs, false, 0, ACCESSOR_CACHE_FILL);
+      if ((rc == SA_AIS_OK) || (rc == SA_AIS_ERR_INVALID_PARAM)) {
+        rc = accessor_get_common(accessorHandle, objectName, attributeNames,
+                                 attributes, bUseString, 0,
+                                 ACCESSOR_CACHE_NO_FILL);
+      }
+      TRACE_LEAVE();
+      return rc;
+    }
+  }
+
   if ((rc = imma_proc_increment_pending_reply(cl_node, true)) != SA_AIS_OK) {
     TRACE_4("ERR_LIBRARY: Overlapping use of IMM handle by multiple threads");
     goto release_lock;
   }
 
+  if (cacheMode == ACCESSOR_CACHE_FILL) {
+    cacheEpoch = imma_accessor_cache_epoch(cl_node->accessorCache);
+  }
+
   memset(&evt, 0, sizeof(IMMSV_EVT));
   evt.type = IMMSV_EVT_TYPE_IMMND;
   evt.info.immnd.type =
@@ -6236,6 +6332,10 @@ static SaAisErrorT accessor_get_common(SaImmAccessorHandleT accessorHandle,
 
       req->searchOptions =
           SA_IMM_SEARCH_ONE_ATTR | SA_IMM_SEARCH_GET_CONFIG_ATTR;
+      if (cacheMode == ACCESSOR_CACHE_FILL) {
+        /* Ask the IMMND to tell us when the cached values go stale. */
+        req->searchOptions |= SA_IMM_SEARCH_ACCESSOR_CACHE_WATCH;
+      }
       ++namev; /* will be NULL and not enter loop directly below */
     } else {
       req->searchOptions = SA_IMM_SEARCH_ONE_ATTR | SA_IMM_SEARCH_GET_SOME_ATTR;
@@ -6412,6 +6512,10 @@ mds_send_fail:
       /* Can override BAD_HANDLE/TIMEOUT set in check_stale */
       rc = SA_AIS_ERR_TRY_AGAIN;
     }
+  } else if ((rc == SA_AIS_OK) && (cacheMode == ACCESSOR_CACHE_FILL) &&
+             cl_node->accessorCache) {
+    imma_accessor_cache_put(cl_node->accessorCache, objectName, *attributes,
+                            cacheEpoch);
   }
 
 /*error cases only */
@@ -7312,6 +7416,49 @@ lock_fail:
   return rc;
 }
 
+SaAisErrorT immsv_om_accessor_cache_stats(SaImmHandleT immHandle,
+                                          ImmsvAccessorCacheStatsT *stats) {
+  SaAisErrorT rc = SA_AIS_OK;
+  IMMA_CB *cb = &imma_cb;
+  IMMA_CLIENT_NODE *cl_node = NULL;
+  TRACE_ENTER();
+
+  if (cb->sv_id == 0) {
+    TRACE_2("ERR_BAD_HANDLE: No initialized handle exists!");
+    TRACE_LEAVE();
+    return SA_AIS_ERR_BAD_HANDLE;
+  }
+
+  if (stats == NULL) {
+    TRACE_2("ERR_INVALID_PARAM: stats is NULL");
+    TRACE_LEAVE();
+    return SA_AIS_ERR_INVALID_PARAM;
+  }
+
+  if (m_NCS_LOCK(&cb->cb_lock, NCS_LOCK_WRITE) != NCSCC_RC_SUCCESS) {
+    TRACE_4("ERR_LIBRARY: Lock failed");
+    TRACE_LEAVE();
+    return SA_AIS_ERR_LIBRARY;
+  }
+
+  imma_client_node_get(&cb->client_tree, &immHandle, &cl_node);
+
+  if (!(cl_node && cl_node->isOm)) {
+    TRACE_2("ERR_BAD_HANDLE: Client node is missing");
+    rc = SA_AIS_ERR_BAD_HANDLE;
+  } else if (!cl_node->accessorCache) {
+    TRACE_2("ERR_NOT_EXIST: Accessor cache not enabled for handle %llx",
+            immHandle);
+    rc = SA_AIS_ERR_NOT_EXIST;
+  } else {
+    imma_accessor_cache_stats(cl_node->accessorCache, stats);
+  }
+
+  m_NCS_UNLOCK(&cb->cb_lock, NCS_LOCK_WRITE);
+  TRACE_LEAVE();
+  return rc;
+}
+
 static SaAisErrorT search_init_common(
     SaImmHandleT immHandle, SaConstStringT rootName, SaImmScopeT scope,
     SaImmSearchOptionsT searchOptions,
@@ -24,6 +24,7 @@
 *****************************************************************************/
 
 #include "imma.h"
+#include "imma_cache.h"
 #include "imm/common/immsv_api.h"
 #include "base/ncssysf_mem.h"
 #include "base/osaf_extended_name.h"
@@ -1381,6 +1382,7 @@ void imma_proc_free_pointers(IMMA_CB *cb, IMMA_EVT *evt) {
 
     case IMMA_EVT_ND2A_OI_OBJ_DELETE_UC:
     case IMMA_EVT_ND2A_OI_OBJ_DELETE_LONG_UC:
+    case IMMA_EVT_ND2A_ACCESSOR_CACHE_INVALIDATE:
       free(evt->info.objDelete.objectName.buf);
       evt->info.objDelete.objectName.buf = NULL;
       evt->info.objDelete.objectName.size = 0;
@@ -1432,6 +1434,35 @@ static void imma_proc_clm_status_changed(IMMA_CB *cb, IMMA_EVT *evt) {
   m_NCS_UNLOCK(&cb->cb_lock, NCS_LOCK_WRITE);
 }
 
+/****************************************************************************
+  Name          : imma_proc_accessor_cache_invalidate
+  Description   : Drops the cached config attributes of one object from the
+                  accessor cache of an OM handle.
+  Arguments     : cb - IMMA CB.
+                  evt - IMMA_EVT.
+  Return Values : None
+******************************************************************************/
+static void imma_proc_accessor_cache_invalidate(IMMA_CB *cb, IMMA_EVT *evt) {
+  IMMA_CLIENT_NODE *cl_node = NULL;
+  SaImmHandleT immHandle = evt->info.objDelete.immHandle;
+
+  if (m_NCS_LOCK(&cb->cb_lock, NCS_LOCK_WRITE) != NCSCC_RC_SUCCESS) {
+    TRACE_3("Lock failure");
+    return;
+  }
+
+  imma_client_node_get(&cb->client_tree, &immHandle, &cl_node);
+  if (cl_node && cl_node->isOm && cl_node->accessorCache &&
+      evt->info.objDelete.objectName.buf) {
+    imma_accessor_cache_invalidate(cl_node->accessorCache,
+                                   evt->info.objDelete.objectName.buf);
+  } else {
+    TRACE_3("Accessor cache invalidation for handle %llx ignored", immHandle);
+  }
+
+  m_NCS_UNLOCK(&cb->cb_lock, NCS_LOCK_WRITE);
+}
+
 /****************************************************************************
   Name          : imma_process_evt
   Description   : This routine will process the callback event received from
@@ -1504,6 +1535,10 @@ void imma_process_evt(IMMA_CB *cb, IMMSV_EVT *evt) {
       imma_proc_clm_status_changed(cb, &evt->info.imma);
       break;
 
+    case IMMA_EVT_ND2A_ACCESSOR_CACHE_INVALIDATE:
+      imma_proc_accessor_cache_invalidate(cb, &evt->info.imma);
+      break;
+
     default:
       TRACE_4("Unknown event type %u", evt->info.imma.type);
       break;
@@ -3290,6 +3325,18 @@ static bool imma_process_callback_info(IMMA_CB *cb, IMMA_CLIENT_NODE *cl_node,
             localEr = SA_AIS_ERR_FAILED_OPERATION;
           }
 
+          /* The reply signals that the fetched values are in place, so
+             updates held back for coalescing must reach the IMMND first. */
+          if (localEr == SA_AIS_OK) {
+            SaAisErrorT flushEr =
+                imma_oi_rt_update_flush(callback->lcl_imm_hdl, false);
+            if (flushEr != SA_AIS_OK) {
+              TRACE_2("ERR_FAILED_OPERATION: Held back rt updates failed: %u",
+                      flushEr);
+              localEr = SA_AIS_ERR_FAILED_OPERATION;
+            }
+          }
+
           free(attributeNames); /*We do not leak the attr names here because
                                   they are still attached to, and deallocated
                                   by, the callback structure. */
@@ -3353,6 +3400,11 @@ static bool imma_process_callback_info(IMMA_CB *cb, IMMA_CLIENT_NODE *cl_node,
       imma_proc_terminate_oi_ccbs(cb, cl_node);
       break;
 
+    case IMMA_CALLBACK_OI_RT_UPDATE_FLUSH:
+      TRACE("Held back rt updates due");
+      imma_oi_rt_update_flush(callback->lcl_imm_hdl, true);
+      break;
+
     default:
       TRACE_3("Unrecognized OI callback type: %u", callback->type);
       break;
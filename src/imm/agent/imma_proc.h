@@ -35,6 +35,7 @@ typedef enum imma_callback_type {
   IMMA_CALLBACK_OI_CCB_ABORT,
   IMMA_CALLBACK_OI_RT_ATTR_UPDATE,
   IMMA_CALLBACK_STALE_HANDLE,
+  IMMA_CALLBACK_OI_RT_UPDATE_FLUSH, /* Held back rt updates are due */
   IMMA_CALLBACK_TYPE_SYNC, /* NOTE this should be removed */
   IMMA_CALLBACK_TYPE_MAX = IMMA_CALLBACK_TYPE_SYNC
 } IMMA_CALLBACK_TYPE;
@@ -82,6 +83,11 @@ uint32_t imma_finalize_client(IMMA_CB *cb, IMMA_CLIENT_NODE *cl_node);
 
 void imma_proc_stale_dispatch(IMMA_CB *cb, IMMA_CLIENT_NODE *clnd);
 
+/* Sends the rt updates held back on the OI handle, see
+   imma_rt_coalesce.h. Called without the CB lock. */
+SaAisErrorT imma_oi_rt_update_flush(SaImmOiHandleT immOiHandle,
+                                    bool onlyExpired);
+
 void imma_determine_clients_to_resurrect(IMMA_CB *cb, bool *locked);
 uint32_t imma_proc_resurrect_client(IMMA_CB *cb, SaImmHandleT immHandle,
                                     bool isOm, SaAisErrorT *err_resurrect);
@@ -0,0 +1,237 @@
+/*      -*- OpenSAF  -*-
+ *
+ * (C) Copyright 2017 The OpenSAF Foundation
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. This file and program are licensed
+ * under the GNU Lesser General Public License Version 2.1, February 1999.
+ * The complete license can be accessed from the following location:
+ * http://opensource.org/licenses/lgpl-license.php
+ * See the Copying file included with the OpenSAF distribution for full
+ * licensing terms.
+ *
+ */
+
+#include "imma_rt_coalesce.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "imma.h"
+#include "base/logtrace.h"
+#include "base/osaf_time.h"
+#include "imm/common/immsv_api.h"
+
+namespace {
+
+struct HeldObject {
+  std::string objectName;
+  IMMSV_ATTR_MODS_LIST *attrMods; /* One element per attribute */
+};
+
+/* Unlinks and frees the element of list *head for attrName, if any. */
+void eraseAttrMod(IMMSV_ATTR_MODS_LIST **head, const char *attrName) {
+  for (IMMSV_ATTR_MODS_LIST **pp = head; *pp; pp = &((*pp)->next)) {
+    if (strcmp((*pp)->attrValue.attrName.buf, attrName) == 0) {
+      IMMSV_ATTR_MODS_LIST *old = *pp;
+      *pp = old->next;
+      old->next = NULL;
+      immsv_free_attrmods(old);
+      return;
+    }
+  }
+}
+
+}  // namespace
+
+struct imma_rt_coalesce {
+  SaUint32T windowMsec;
+  struct timespec oldest; /* Time of first update held back */
+  std::vector<HeldObject> objects;
+  std::unordered_map<std::string, size_t> index; /* Into objects */
+  SaUint64T merged; /* Updates overwritten before being sent */
+  tmr_t tmr;
+  bool tmrActive;
+  TMR_CALLBACK expiry;
+  void *arg;
+  SaAisErrorT error; /* First held back update that failed */
+  std::string failedObject;
+};
+
+namespace {
+
+/* Milliseconds since the oldest held back update */
+int64_t heldMsec(const IMMA_RT_COALESCE *rtc) {
+  struct timespec now;
+  struct timespec age;
+  osaf_clock_gettime(CLOCK_MONOTONIC, &now);
+  osaf_timespec_subtract(&now, &rtc->oldest, &age);
+  return osaf_timespec_to_millis(&age);
+}
+
+void startTimer(IMMA_RT_COALESCE *rtc, SaUint32T msec) {
+  if (rtc->tmr == TMR_T_NULL) {
+    rtc->tmr = ncs_tmr_alloc(const_cast<char *>(__FILE__), __LINE__);
+  }
+  /* In units of 10 ms, rounded up so the window has passed on expiry */
+  rtc->tmr = ncs_tmr_start(rtc->tmr, (msec + 9) / 10, rtc->expiry, rtc->arg,
+                           const_cast<char *>(__FILE__), __LINE__);
+  rtc->tmrActive = (rtc->tmr != TMR_T_NULL);
+  if (!rtc->tmrActive) {
+    TRACE_3("Failed to start the rt update flush timer");
+  }
+}
+
+}  // namespace
+
+IMMA_RT_COALESCE *imma_rt_coalesce_create(SaUint32T windowMsec,
+                                          TMR_CALLBACK expiry, void *arg) {
+  IMMA_RT_COALESCE *rtc = new IMMA_RT_COALESCE;
+  rtc->windowMsec = windowMsec;
+  rtc->oldest.tv_sec = 0;
+  rtc->oldest.tv_nsec = 0;
+  rtc->merged = 0;
+  rtc->tmr = TMR_T_NULL;
+  rtc->tmrActive = false;
+  rtc->expiry = expiry;
+  rtc->arg = arg;
+  rtc->error = SA_AIS_OK;
+  return rtc;
+}
+
+void imma_rt_coalesce_destroy(IMMA_RT_COALESCE *rtc) {
+  if (!rtc) {
+    return;
+  }
+  if (!rtc->objects.empty()) {
+    TRACE_3("%zu held back runtime attribute updates discarded",
+            rtc->objects.size());
+  }
+  for (auto &held : rtc->objects) {
+    immsv_free_attrmods(held.attrMods);
+  }
+  if (rtc->tmr != TMR_T_NULL) {
+    if (rtc->tmrActive) {
+      m_NCS_TMR_STOP(rtc->tmr);
+    }
+    m_NCS_TMR_DESTROY(rtc->tmr);
+  }
+  delete rtc;
+}
+
+bool imma_rt_coalesce_eligible(const IMMSV_ATTR_MODS_LIST *attrMods) {
+  if (!attrMods) {
+    return false;
+  }
+  for (const IMMSV_ATTR_MODS_LIST *p = attrMods; p; p = p->next) {
+    if (p->attrModType != SA_IMM_ATTR_VALUES_REPLACE) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void imma_rt_coalesce_add(IMMA_RT_COALESCE *rtc, const char *objectName,
+                          IMMSV_ATTR_MODS_LIST *attrMods) {
+  if (rtc->objects.empty()) {
+    osaf_clock_gettime(CLOCK_MONOTONIC, &rtc->oldest);
+    if (!rtc->tmrActive) {
+      startTimer(rtc, rtc->windowMsec);
+    }
+  }
+
+  auto found = rtc->index.find(objectName);
+  if (found == rtc->index.end()) {
+    rtc->index[objectName] = rtc->objects.size();
+    rtc->objects.push_back(HeldObject{objectName, attrMods});
+    return;
+  }
+
+  HeldObject &held = rtc->objects[found->second];
+  while (attrMods) {
+    IMMSV_ATTR_MODS_LIST *p = attrMods;
+    attrMods = p->next;
+    eraseAttrMod(&held.attrMods, p->attrValue.attrName.buf);
+    p->next = held.attrMods;
+    held.attrMods = p;
+  }
+  ++rtc->merged;
+}
+
+bool imma_rt_coalesce_pending(const IMMA_RT_COALESCE *rtc) {
+  return !rtc->objects.empty();
+}
+
+bool imma_rt_coalesce_expired(const IMMA_RT_COALESCE *rtc) {
+  if (rtc->objects.empty()) {
+    return false;
+  }
+  return heldMsec(rtc) >= rtc->windowMsec;
+}
+
+bool imma_rt_coalesce_full(const IMMA_RT_COALESCE *rtc) {
+  return rtc->objects.size() >= IMMSV_MAX_OBJS_IN_RT_UPDATE_BATCH;
+}
+
+bool imma_rt_coalesce_timer_expired(IMMA_RT_COALESCE *rtc) {
+  rtc->tmrActive = false;
+  if (rtc->objects.empty()) {
+    return false;
+  }
+  /* Sent and held back again since the timer was started */
+  int64_t held = heldMsec(rtc);
+  if (held < rtc->windowMsec) {
+    startTimer(rtc, rtc->windowMsec - held);
+    return false;
+  }
+  return true;
+}
+
+void imma_rt_coalesce_failed(IMMA_RT_COALESCE *rtc, SaAisErrorT error,
+                             const char *objectName) {
+  if (rtc->error != SA_AIS_OK) {
+    return;
+  }
+  rtc->error = error;
+  rtc->failedObject = objectName ? objectName : "";
+}
+
+SaAisErrorT imma_rt_coalesce_take_error(IMMA_RT_COALESCE *rtc,
+                                        char **objectName) {
+  SaAisErrorT error = rtc->error;
+  if (objectName) {
+    *objectName = (error != SA_AIS_OK && !rtc->failedObject.empty())
+                      ? strdup(rtc->failedObject.c_str())
+                      : NULL;
+  }
+  rtc->error = SA_AIS_OK;
+  rtc->failedObject.clear();
+  return error;
+}
+
+IMMSV_OI_RT_MODIFY_LIST *imma_rt_coalesce_take(IMMA_RT_COALESCE *rtc) {
+  IMMSV_OI_RT_MODIFY_LIST *head = NULL;
+  IMMSV_OI_RT_MODIFY_LIST **tail = &head;
+
+  for (auto &held : rtc->objects) {
+    IMMSV_OI_RT_MODIFY_LIST *rtMod = (IMMSV_OI_RT_MODIFY_LIST *)calloc(
+        1, sizeof(IMMSV_OI_RT_MODIFY_LIST));
+    rtMod->objModify.objectName.size = held.objectName.size() + 1;
+    rtMod->objModify.objectName.buf = strdup(held.objectName.c_str());
+    rtMod->objModify.attrMods = held.attrMods;
+    *tail = rtMod;
+    tail = &rtMod->next;
+  }
+
+  TRACE("Taking %zu held back rt updates, %llu merged", rtc->objects.size(),
+        (unsigned long long)rtc->merged);
+  rtc->objects.clear();
+  rtc->index.clear();
+  rtc->merged = 0;
+  return head;
+}
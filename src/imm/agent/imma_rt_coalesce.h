@@ -0,0 +1,88 @@
+/*      -*- OpenSAF  -*-
+ *
+ * (C) Copyright 2017 The OpenSAF Foundation
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. This file and program are licensed
+ * under the GNU Lesser General Public License Version 2.1, February 1999.
+ * The complete license can be accessed from the following location:
+ * http://opensource.org/licenses/lgpl-license.php
+ * See the Copying file included with the OpenSAF distribution for full
+ * licensing terms.
+ *
+ */
+
+/*****************************************************************************
+  DESCRIPTION:
+
+  Per OI handle buffer of runtime attribute updates held back for
+  coalescing. Enabled by the environment variable
+  IMMA_OI_RT_UPDATE_COALESCE_MSEC.
+
+  Only updates where all modifications are SA_IMM_ATTR_VALUES_REPLACE are
+  held back. A later REPLACE of the same attribute of the same object
+  overwrites the held back one. The buffer is sent as one batch when the
+  oldest held back update is older than the window or when it holds
+  IMMSV_MAX_OBJS_IN_RT_UPDATE_BATCH objects, see imma_oi_api.cc. A timer
+  started with the first held back update makes sure the window is
+  noticed also when the OI makes no further calls.
+
+  Errors for held back updates are kept, with the object that failed,
+  until taken by immsv_oi_rt_object_update_flush().
+
+  All functions must be called with the IMMA CB lock held, except the
+  timer callback which is called from the timer thread.
+*****************************************************************************/
+
+#ifndef IMM_AGENT_IMMA_RT_COALESCE_H_
+#define IMM_AGENT_IMMA_RT_COALESCE_H_
+
+#include "base/ncssysf_tmr.h"
+#include "imm/common/immsv_evt_model.h"
+
+typedef struct imma_rt_coalesce IMMA_RT_COALESCE;
+
+/* The timer calls expiry(arg) when the window of the first held back
+   update has passed. */
+IMMA_RT_COALESCE *imma_rt_coalesce_create(SaUint32T windowMsec,
+                                          TMR_CALLBACK expiry, void *arg);
+void imma_rt_coalesce_destroy(IMMA_RT_COALESCE *rtc);
+
+/* True if an update with these modifications may be held back. */
+bool imma_rt_coalesce_eligible(const IMMSV_ATTR_MODS_LIST *attrMods);
+
+/* Takes ownership of attrMods. */
+void imma_rt_coalesce_add(IMMA_RT_COALESCE *rtc, const char *objectName,
+                          IMMSV_ATTR_MODS_LIST *attrMods);
+
+bool imma_rt_coalesce_pending(const IMMA_RT_COALESCE *rtc);
+
+/* True if the oldest held back update is older than the window. */
+bool imma_rt_coalesce_expired(const IMMA_RT_COALESCE *rtc);
+
+/* True if the buffer holds as many objects as one batch message takes. */
+bool imma_rt_coalesce_full(const IMMA_RT_COALESCE *rtc);
+
+/* To be called by the timer callback. Returns true if the held back
+   updates are due to be sent, otherwise the timer is restarted when
+   needed. */
+bool imma_rt_coalesce_timer_expired(IMMA_RT_COALESCE *rtc);
+
+/* Keeps the error of a held back update that failed to be sent, unless an
+   earlier one is kept. objectName may be NULL if not known. */
+void imma_rt_coalesce_failed(IMMA_RT_COALESCE *rtc, SaAisErrorT error,
+                             const char *objectName);
+
+/* Returns and forgets the kept error, SA_AIS_OK if none. If objectName is
+   not NULL it is set to a malloc'ed copy of the name of the object that
+   failed, or NULL. */
+SaAisErrorT imma_rt_coalesce_take_error(IMMA_RT_COALESCE *rtc,
+                                        char **objectName);
+
+/* Empties the buffer. Returns the held back updates, one element per object
+   in the order the objects were first updated, or NULL. The list is heap
+   allocated, including the head. */
+IMMSV_OI_RT_MODIFY_LIST *imma_rt_coalesce_take(IMMA_RT_COALESCE *rtc);
+
+#endif  // IMM_AGENT_IMMA_RT_COALESCE_H_
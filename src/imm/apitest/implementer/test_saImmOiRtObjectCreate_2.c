@@ -267,6 +267,10 @@ extern void saImmOiRtObjectUpdate_2_06(void);
 extern void saImmOiRtObjectUpdate_2_07(void);
 extern void saImmOiRtObjectUpdate_2_08(void);
 extern void saImmOiRtObjectUpdate_2_09(void);
+extern void saImmOiRtObjectUpdate_2_10(void);
+extern void saImmOiRtObjectUpdate_2_11(void);
+extern void saImmOiRtObjectUpdate_2_12(void);
+extern void saImmOiRtObjectUpdate_2_13(void);
 extern void SaImmOiRtAttrUpdateCallbackT_01(void);
 
 __attribute__((constructor)) static void
@@ -338,6 +342,17 @@ saImmOiRtObjectCreate_2_constructor(void)
 	test_case_add(
 	    3, saImmOiRtObjectUpdate_2_09,
 	    "saImmOiRtObjectUpdate_2 - STRONG_DEFAULT, Delete all values of multi-valued runtime attribute");
+	test_case_add(3, saImmOiRtObjectUpdate_2_10,
+		      "immsv_oi_rt_object_update_batch - SA_AIS_OK");
+	test_case_add(
+	    3, saImmOiRtObjectUpdate_2_11,
+	    "immsv_oi_rt_object_update_batch - SA_AIS_ERR_NOT_EXIST - one object in batch non existing");
+	test_case_add(
+	    3, saImmOiRtObjectUpdate_2_12,
+	    "immsv_oi_rt_object_update_flush - SA_AIS_ERR_NOT_EXIST - held back update of non existing object");
+	test_case_add(
+	    3, saImmOiRtObjectUpdate_2_13,
+	    "saImmOiRtObjectUpdate_2 - SA_AIS_OK - held back update sent at dispatch after the window");
 
 	test_case_add(3, SaImmOiRtAttrUpdateCallbackT_01,
 		      "SaImmOiRtAttrUpdateCallbackT - SA_AIS_OK");
@@ -15,7 +15,11 @@
  *
  */
 
+#include <poll.h>
+#include <stdlib.h>
+#include <string.h>
 #include "imm/apitest/immtest.h"
+#include "imm/common/immsv_api.h"
 
 static SaNameT dn = {.value = "Test,rdn=root",
 		     .length = sizeof("Test,rdn=root")};
@@ -504,3 +508,152 @@ void saImmOiRtObjectUpdate_2_09(void)
 	safassert(saImmOmClassDelete(immOmHandle, className), SA_AIS_OK);
 	safassert(saImmOmFinalize(immOmHandle), SA_AIS_OK);
 }
+
+void saImmOiRtObjectUpdate_2_10(void)
+{
+	const SaImmOiImplementerNameT implementerName =
+	    (SaImmOiImplementerNameT) __FUNCTION__;
+	ImmsvRtObjectUpdateT update = {
+	    .objectName = (SaConstStringT)dn.value,
+	    .attrMods = (const SaImmAttrModificationT_2 **)attrMods};
+	const ImmsvRtObjectUpdateT *updates[] = {&update, NULL};
+
+	safassert(
+	    saImmOiInitialize_2(&immOiHandle, &immOiCallbacks, &immVersion),
+	    SA_AIS_OK);
+	safassert(saImmOiImplementerSet(immOiHandle, implementerName),
+		  SA_AIS_OK);
+	safassert(saImmOiRtObjectCreate_2(immOiHandle, className, &rootObj,
+					  attrValues),
+		  SA_AIS_OK);
+
+	int1Value = 0xbadbabe;
+	rc = immsv_oi_rt_object_update_batch(immOiHandle, updates, NULL);
+	test_validate(rc, SA_AIS_OK);
+
+	safassert(saImmOiRtObjectDelete(immOiHandle, &dn), SA_AIS_OK);
+	safassert(saImmOiFinalize(immOiHandle), SA_AIS_OK);
+}
+
+void saImmOiRtObjectUpdate_2_11(void)
+{
+	const SaImmOiImplementerNameT implementerName =
+	    (SaImmOiImplementerNameT) __FUNCTION__;
+	ImmsvRtObjectUpdateT update = {
+	    .objectName = (SaConstStringT)dn.value,
+	    .attrMods = (const SaImmAttrModificationT_2 **)attrMods};
+	ImmsvRtObjectUpdateT missing = {
+	    .objectName = "Missing,rdn=root",
+	    .attrMods = (const SaImmAttrModificationT_2 **)attrMods};
+	const ImmsvRtObjectUpdateT *updates[] = {&update, &missing, NULL};
+
+	safassert(
+	    saImmOiInitialize_2(&immOiHandle, &immOiCallbacks, &immVersion),
+	    SA_AIS_OK);
+	safassert(saImmOiImplementerSet(immOiHandle, implementerName),
+		  SA_AIS_OK);
+	safassert(saImmOiRtObjectCreate_2(immOiHandle, className, &rootObj,
+					  attrValues),
+		  SA_AIS_OK);
+	SaUint32T failedUpdate = 0xffff;
+	safassert(immsv_oi_rt_object_update_batch(immOiHandle, NULL, NULL),
+		  SA_AIS_ERR_INVALID_PARAM);
+
+	rc = immsv_oi_rt_object_update_batch(immOiHandle, updates,
+					     &failedUpdate);
+	assert(rc != SA_AIS_ERR_NOT_EXIST || failedUpdate == 1);
+	test_validate(rc, SA_AIS_ERR_NOT_EXIST);
+
+	safassert(saImmOiRtObjectDelete(immOiHandle, &dn), SA_AIS_OK);
+	safassert(saImmOiFinalize(immOiHandle), SA_AIS_OK);
+}
+
+void saImmOiRtObjectUpdate_2_12(void)
+{
+	const SaImmOiImplementerNameT implementerName =
+	    (SaImmOiImplementerNameT) __FUNCTION__;
+	SaNameT missing = {.value = "Missing,rdn=root",
+			   .length = sizeof("Missing,rdn=root")};
+	SaStringT failedObject = NULL;
+
+	/* Hold back updates long enough for them to be flushed by hand */
+	setenv("IMMA_OI_RT_UPDATE_COALESCE_MSEC", "60000", 1);
+	safassert(
+	    saImmOiInitialize_2(&immOiHandle, &immOiCallbacks, &immVersion),
+	    SA_AIS_OK);
+	unsetenv("IMMA_OI_RT_UPDATE_COALESCE_MSEC");
+	safassert(saImmOiImplementerSet(immOiHandle, implementerName),
+		  SA_AIS_OK);
+	safassert(saImmOiRtObjectCreate_2(immOiHandle, className, &rootObj,
+					  attrValues),
+		  SA_AIS_OK);
+
+	/* The error of a held back update is returned by the flush, named */
+	safassert(saImmOiRtObjectUpdate_2(immOiHandle, &dn,
+					  (const SaImmAttrModificationT_2 **)
+					      attrMods),
+		  SA_AIS_OK);
+	safassert(saImmOiRtObjectUpdate_2(immOiHandle, &missing,
+					  (const SaImmAttrModificationT_2 **)
+					      attrMods),
+		  SA_AIS_OK);
+	rc = immsv_oi_rt_object_update_flush(immOiHandle, &failedObject);
+	assert(rc != SA_AIS_ERR_NOT_EXIST ||
+	       (failedObject && !strcmp(failedObject, (char *)missing.value)));
+	free(failedObject);
+	safassert(immsv_oi_rt_object_update_flush(immOiHandle, NULL),
+		  SA_AIS_OK);
+	test_validate(rc, SA_AIS_ERR_NOT_EXIST);
+
+	safassert(saImmOiRtObjectDelete(immOiHandle, &dn), SA_AIS_OK);
+	safassert(saImmOiFinalize(immOiHandle), SA_AIS_OK);
+}
+
+void saImmOiRtObjectUpdate_2_13(void)
+{
+	const SaImmOiImplementerNameT implementerName =
+	    (SaImmOiImplementerNameT) __FUNCTION__;
+	SaSelectionObjectT selObj;
+	struct pollfd fds[1];
+	SaImmAccessorHandleT accessorHandle;
+	const SaImmAttrNameT attName = "saLogStreamFixedLogRecordSize";
+	SaImmAttrNameT attNames[] = {attName, NULL};
+	SaImmAttrValuesT_2 **resultAttrs;
+
+	setenv("IMMA_OI_RT_UPDATE_COALESCE_MSEC", "100", 1);
+	safassert(
+	    saImmOiInitialize_2(&immOiHandle, &immOiCallbacks, &immVersion),
+	    SA_AIS_OK);
+	unsetenv("IMMA_OI_RT_UPDATE_COALESCE_MSEC");
+	safassert(saImmOiSelectionObjectGet(immOiHandle, &selObj), SA_AIS_OK);
+	safassert(saImmOiImplementerSet(immOiHandle, implementerName),
+		  SA_AIS_OK);
+	safassert(saImmOiRtObjectCreate_2(immOiHandle, className, &rootObj,
+					  attrValues),
+		  SA_AIS_OK);
+
+	/* The window timer wakes up the selection object, dispatch sends */
+	int1Value = 0xfeed;
+	safassert(saImmOiRtObjectUpdate_2(immOiHandle, &dn,
+					  (const SaImmAttrModificationT_2 **)
+					      attrMods),
+		  SA_AIS_OK);
+	fds[0].fd = (int)selObj;
+	fds[0].events = POLLIN;
+	assert(poll(fds, 1, 5000) == 1);
+	safassert(saImmOiDispatch(immOiHandle, SA_DISPATCH_ALL), SA_AIS_OK);
+
+	safassert(saImmOmInitialize(&immOmHandle, NULL, &immVersion),
+		  SA_AIS_OK);
+	safassert(saImmOmAccessorInitialize(immOmHandle, &accessorHandle),
+		  SA_AIS_OK);
+	safassert(
+	    saImmOmAccessorGet_2(accessorHandle, &dn, attNames, &resultAttrs),
+	    SA_AIS_OK);
+	assert(resultAttrs[0] && resultAttrs[0]->attrValuesNumber == 1);
+	test_validate(*((SaUint32T *)resultAttrs[0]->attrValues[0]), 0xfeed);
+	safassert(saImmOmFinalize(immOmHandle), SA_AIS_OK);
+
+	safassert(saImmOiRtObjectDelete(immOiHandle, &dn), SA_AIS_OK);
+	safassert(saImmOiFinalize(immOiHandle), SA_AIS_OK);
+}
@@ -49,6 +49,7 @@ name="TestClass"> <category>SA_CONFIG</category> <rdn> <name>rdn</name>
 #include "imm/saf/saImmOm.h"
 #include "osaf/immutil/immutil.h"
 #include "base/saf_error.h"
+#include "osaf/configmake.h"
 
 int verbose = 0;
 int ccb_safe = 0;
@@ -77,6 +78,8 @@ static void usage(const char *progname)
 	printf(
 	    "\t-c, --class                   output a suitable class definition to stdout\n");
 	printf("\t-h, --help                    this help\n");
+	printf(
+	    "\t-m, --memory                  report the growth of the resident memory of the local IMMND\n");
 	printf("\t-v, --verbose                 enable debug printouts\n");
 	printf(
 	    "\t-p, --populate <cardinality>  create <cardinality> number of objects of class <class name>\n");
@@ -85,6 +88,42 @@ static void usage(const char *progname)
 	printf("\t%s -c > testclass.xml\n", progname);
 	printf("\t%s -p 1000 TestClass\n", progname);
 	printf("\t\tcreate 1000 instances of TestClass\n");
+	printf("\t%s -m -p 1000000 TestClass\n", progname);
+	printf(
+	    "\t\tcreate 1000000 instances of TestClass and report the IMMND memory used per object\n");
+}
+
+/* Resident memory of the local IMMND in kB, -1 if not available. */
+static long immnd_rss_kb(void)
+{
+	FILE *f;
+	char path[64];
+	char line[256];
+	int pid = 0;
+	long rss = -1;
+
+	if ((f = fopen(PKGPIDDIR "/osafimmnd.pid", "r")) == NULL) {
+		return -1;
+	}
+	if (fscanf(f, "%d", &pid) != 1) {
+		pid = 0;
+	}
+	fclose(f);
+	if (pid <= 0) {
+		return -1;
+	}
+
+	snprintf(path, sizeof(path), "/proc/%d/status", pid);
+	if ((f = fopen(path, "r")) == NULL) {
+		return -1;
+	}
+	while (fgets(line, sizeof(line), f)) {
+		if (sscanf(line, "VmRSS: %ld", &rss) == 1) {
+			break;
+		}
+	}
+	fclose(f);
+	return rss;
 }
 
 static char *create_adminOwnerName(char *base)
@@ -389,6 +428,7 @@ int main(int argc, char *argv[])
 	struct option long_options[] = {
 	    {"class", no_argument, NULL, 'c'},
 	    {"help", no_argument, NULL, 'h'},
+	    {"memory", no_argument, NULL, 'm'},
 	    {"populate", required_argument, NULL, 'p'},
 	    {"verbose", no_argument, NULL, 'v'},
 	    {0, 0, 0, 0}};
@@ -400,10 +440,12 @@ int main(int argc, char *argv[])
 	SaImmClassNameT className = NULL;
 	static SaVersionT immVersion = {'A', 2, 11};
 	int population = 0;
+	int memory = 0;
+	long rss_before = -1;
 
 	while (1) {
 		int option_index = 0;
-		c = getopt_long(argc, argv, "chp:v", long_options,
+		c = getopt_long(argc, argv, "chmp:v", long_options,
 				&option_index);
 
 		if (c ==
@@ -419,6 +461,9 @@ int main(int argc, char *argv[])
 			usage(basename(argv[0]));
 			exit(EXIT_SUCCESS);
 			break;
+		case 'm':
+			memory = 1;
+			break;
 		case 'p':
 			population = atol(optarg);
 			break;
@@ -454,8 +499,24 @@ int main(int argc, char *argv[])
 		goto done_om_finalize;
 	}
 
+	if (memory && (rss_before = immnd_rss_kb()) < 0) {
+		fprintf(stderr,
+			"error - can not read the memory use of the local IMMND\n");
+		memory = 0;
+	}
+
 	rc = populate_imm(className, population, ownerHandle, immHandle);
 
+	if (memory && rc == EXIT_SUCCESS && population > 0) {
+		long rss_after = immnd_rss_kb();
+		if (rss_after >= 0) {
+			printf("IMMND resident memory %ld kB -> %ld kB, "
+			       "%ld bytes per object\n",
+			       rss_before, rss_after,
+			       ((rss_after - rss_before) * 1024) / population);
+		}
+	}
+
 	error = saImmOmAdminOwnerFinalize(ownerHandle);
 	if (SA_AIS_OK != error) {
 		fprintf(stderr,
@@ -16,6 +16,9 @@
  */
 
 #include "imm/apitest/immtest.h"
+#include <time.h>
+#include <unistd.h>
+#include "imm/common/immsv_api.h"
 
 static SaImmAccessorHandleT accessorHandle;
 static SaImmAttrValuesT_2 **attributes;
@@ -285,3 +288,160 @@ void saImmOmAccessorGet_2_11(void)
 	test_validate(rc, SA_AIS_ERR_NO_RESOURCES);
 	safassert(saImmOmFinalize(immOmHandle), SA_AIS_OK);
 }
+
+static SaImmHandleT accessor_cache_om_initialize(const char *maxBytes)
+{
+	SaImmHandleT immHandle;
+	char *value = getenv("IMMA_ACCESSOR_CACHE_MAX_BYTES");
+	char *saved = value ? strdup(value) : NULL;
+
+	if (maxBytes)
+		setenv("IMMA_ACCESSOR_CACHE_MAX_BYTES", maxBytes, 1);
+	else
+		unsetenv("IMMA_ACCESSOR_CACHE_MAX_BYTES");
+	safassert(saImmOmInitialize(&immHandle, &immOmCallbacks, &immVersion),
+		  SA_AIS_OK);
+	if (saved) {
+		setenv("IMMA_ACCESSOR_CACHE_MAX_BYTES", saved, 1);
+		free(saved);
+	} else {
+		unsetenv("IMMA_ACCESSOR_CACHE_MAX_BYTES");
+	}
+	return immHandle;
+}
+
+static SaUint64T accessor_get_loop(SaImmAccessorHandleT accHandle,
+				   const SaImmAttrNameT *attributeNames,
+				   int loops)
+{
+	struct timespec start, end;
+	int i;
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	for (i = 0; i < loops; ++i) {
+		safassert(saImmOmAccessorGet_2(accHandle, &objectName,
+					       attributeNames, &attributes),
+			  SA_AIS_OK);
+	}
+	clock_gettime(CLOCK_MONOTONIC, &end);
+
+	return (SaUint64T)(end.tv_sec - start.tv_sec) * 1000000000ULL +
+	       end.tv_nsec - start.tv_nsec;
+}
+
+void saImmOmAccessorGet_2_12(void)
+{
+	const int loops = 1000;
+	SaImmHandleT cachedHandle;
+	SaImmAccessorHandleT cachedAccessorHandle;
+	SaImmAttrNameT attributeNames[] = {
+	    (SaImmAttrNameT)OPENSAF_IMM_SYNC_BATCH_SIZE, NULL};
+	ImmsvAccessorCacheStatsT stats;
+	SaUint32T uncachedValue;
+	SaUint64T uncachedNs;
+	SaUint64T cachedNs;
+
+	immOmHandle = accessor_cache_om_initialize(NULL);
+	cachedHandle = accessor_cache_om_initialize("65536");
+	safassert(saImmOmAccessorInitialize(immOmHandle, &accessorHandle),
+		  SA_AIS_OK);
+	safassert(saImmOmAccessorInitialize(cachedHandle,
+					    &cachedAccessorHandle),
+		  SA_AIS_OK);
+
+	uncachedNs = accessor_get_loop(accessorHandle, attributeNames, loops);
+	uncachedValue = *((SaUint32T *)attributes[0]->attrValues[0]);
+	cachedNs =
+	    accessor_get_loop(cachedAccessorHandle, attributeNames, loops);
+	printf("\naccessorGet x %d: uncached %llu us, cached %llu us\n", loops,
+	       uncachedNs / 1000, cachedNs / 1000);
+
+	safassert(immsv_om_accessor_cache_stats(immOmHandle, &stats),
+		  SA_AIS_ERR_NOT_EXIST);
+	safassert(immsv_om_accessor_cache_stats(cachedHandle, &stats),
+		  SA_AIS_OK);
+	printf("hits:%llu misses:%llu entries:%llu bytes:%llu\n", stats.hits,
+	       stats.misses, stats.entries, stats.bytes);
+
+	if (stats.hits == (SaUint64T)(loops - 1) && stats.misses == 1 &&
+	    stats.entries == 1 && stats.bytes <= stats.maxBytes &&
+	    uncachedValue == *((SaUint32T *)attributes[0]->attrValues[0])) {
+		rc = SA_AIS_OK;
+	} else {
+		rc = SA_AIS_ERR_FAILED_OPERATION;
+	}
+	test_validate(rc, SA_AIS_OK);
+
+	safassert(saImmOmFinalize(cachedHandle), SA_AIS_OK);
+	safassert(saImmOmFinalize(immOmHandle), SA_AIS_OK);
+}
+
+void saImmOmAccessorGet_2_13(void)
+{
+	const SaImmAdminOwnerNameT adminOwnerName =
+	    (SaImmAdminOwnerNameT) __FUNCTION__;
+	SaImmAdminOwnerHandleT ownerHandle;
+	SaImmCcbHandleT ccbHandle;
+	SaImmHandleT cachedHandle;
+	const SaNameT rdnObj = {sizeof("Obj1"), "Obj1"};
+	SaNameT dnObj;
+	const SaNameT *objectNames[] = {&rootObj, NULL};
+	const SaNameT *dnObjs[] = {&dnObj, NULL};
+	SaImmAttrNameT attributeNames[] = {"attr1", NULL};
+	SaUint32T newValue = __LINE__;
+	SaUint32T *newValues[] = {&newValue};
+	SaImmAttrValuesT_2 v1 = {"attr1", SA_IMM_ATTR_SAUINT32T, 1,
+				 (void **)newValues};
+	SaImmAttrModificationT_2 attrMod = {SA_IMM_ATTR_VALUES_REPLACE, v1};
+	const SaImmAttrModificationT_2 *attrMods[] = {&attrMod, NULL};
+	int retries;
+
+	dnObj.length = (SaUint16T)sprintf((char *)dnObj.value, "%s,%s",
+					  rdnObj.value, rootObj.value);
+
+	immOmHandle = accessor_cache_om_initialize(NULL);
+	cachedHandle = accessor_cache_om_initialize("65536");
+	safassert(saImmOmAdminOwnerInitialize(immOmHandle, adminOwnerName,
+					      SA_TRUE, &ownerHandle),
+		  SA_AIS_OK);
+	safassert(saImmOmAdminOwnerSet(ownerHandle, objectNames, SA_IMM_ONE),
+		  SA_AIS_OK);
+	safassert(object_create(immOmHandle, ownerHandle, configClassName,
+				&rdnObj, &rootObj, NULL),
+		  SA_AIS_OK);
+	safassert(saImmOmAdminOwnerSet(ownerHandle, dnObjs, SA_IMM_ONE),
+		  SA_AIS_OK);
+
+	/* Fill the cache */
+	safassert(saImmOmAccessorInitialize(cachedHandle, &accessorHandle),
+		  SA_AIS_OK);
+	safassert(saImmOmAccessorGet_2(accessorHandle, &dnObj, attributeNames,
+				       &attributes),
+		  SA_AIS_OK);
+
+	safassert(saImmOmCcbInitialize(ownerHandle, 0, &ccbHandle), SA_AIS_OK);
+	safassert(saImmOmCcbObjectModify_2(ccbHandle, &dnObj, attrMods),
+		  SA_AIS_OK);
+	safassert(saImmOmCcbApply(ccbHandle), SA_AIS_OK);
+	safassert(saImmOmCcbFinalize(ccbHandle), SA_AIS_OK);
+
+	/* The invalidation is pushed asynchronously by the IMMND */
+	rc = SA_AIS_ERR_FAILED_OPERATION;
+	for (retries = 0; retries < 100; ++retries) {
+		safassert(saImmOmAccessorGet_2(accessorHandle, &dnObj,
+					       attributeNames, &attributes),
+			  SA_AIS_OK);
+		if (attributes[0]->attrValuesNumber == 1 &&
+		    *((SaUint32T *)attributes[0]->attrValues[0]) == newValue) {
+			rc = SA_AIS_OK;
+			break;
+		}
+		usleep(10000);
+	}
+	test_validate(rc, SA_AIS_OK);
+
+	safassert(object_delete(ownerHandle, &dnObj, 1), SA_AIS_OK);
+	safassert(saImmOmAdminOwnerFinalize(ownerHandle), SA_AIS_OK);
+	safassert(saImmOmFinalize(cachedHandle), SA_AIS_OK);
+	safassert(saImmOmFinalize(immOmHandle), SA_AIS_OK);
+}
@@ -73,6 +73,8 @@ extern void saImmOmAccessorGet_2_08(void);
 extern void saImmOmAccessorGet_2_09(void);
 extern void saImmOmAccessorGet_2_10(void);
 extern void saImmOmAccessorGet_2_11(void);
+extern void saImmOmAccessorGet_2_12(void);
+extern void saImmOmAccessorGet_2_13(void);
 extern void saImmOmAccessorFinalize_01(void);
 extern void saImmOmAccessorFinalize_02(void);
 extern void saImmOmAccessorFinalize_03(void);
@@ -123,6 +125,12 @@ saImmOmAccessorInitialize_constructor(void)
 	test_case_add(
 	    4, saImmOmAccessorGet_2_11,
 	    "saImmOmAccessorGet_2 - SA_AIS_ERR_NO_RESOURCES - search handles limitation");
+	test_case_add(
+	    4, saImmOmAccessorGet_2_12,
+	    "saImmOmAccessorGet_2 - SA_AIS_OK - accessor cache, 1000 reads cached vs uncached");
+	test_case_add(
+	    4, saImmOmAccessorGet_2_13,
+	    "saImmOmAccessorGet_2 - SA_AIS_OK - accessor cache invalidated by CCB apply");
 
 	test_case_add(4, saImmOmAccessorFinalize_01,
 		      "saImmOmAccessorFinalize - SA_AIS_OK");
@@ -60,6 +60,7 @@ extern "C" {
 /* Adjust to 90% of MDS_DIRECT_BUF_MAXSIZE  */
 #define IMMSV_DEFAULT_MAX_SYNC_BATCH_SIZE ((MDS_DIRECT_BUF_MAXSIZE / 100) * 90)
 #define IMMSV_MAX_OBJS_IN_SYNCBATCH (IMMSV_DEFAULT_MAX_SYNC_BATCH_SIZE / 10)
+#define IMMSV_MAX_OBJS_IN_RT_UPDATE_BATCH 256
 
 #define OPENSAF_IMM_LONG_DNS_ALLOWED "longDnsAllowed"
 #define OPENSAF_IMM_ACCESS_CONTROL_MODE "accessControlMode"
@@ -149,6 +150,7 @@ typedef enum {
 #define OPENSAF_IMM_FLAG_PRT47_ALLOW 0x00000040
 #define OPENSAF_IMM_FLAG_PRT50_ALLOW 0x00000080
 #define OPENSAF_IMM_FLAG_PRT51_ALLOW 0x00000100
+#define OPENSAF_IMM_FLAG_PRT52_ALLOW 0x00000200
 
 #define OPENSAF_IMM_SERVICE_NAME "safImmService"
 
@@ -177,6 +179,10 @@ typedef enum {
  * the search result. SA_IMM_SEARCH_NO_RDN flag is used only in a combination
  * with SA_IMM_SEARCH_GET_ALL_ATTR flag.
  *
+ * The fourth is set by an OM agent that caches the result of an accessorGet
+ * on the SA_IMM_SEARCH_GET_CONFIG_ATTR tunnel. The IMMND then notifies that
+ * agent when a CCB modifying or deleting the object has been applied.
+ *
  * The use of these flags in search options is NON STANDARD.
  * It is only allowed for imm internal use.
  * We are messing with the a part of the value space for search options.
@@ -190,6 +196,7 @@ typedef enum {
 #define SA_IMM_SEARCH_PERSISTENT_ATTRS 0x0010
 #define SA_IMM_SEARCH_SYNC_CACHED_ATTRS 0x0020
 #define SA_IMM_SEARCH_NO_RDN 0x0001000000000000ull
+#define SA_IMM_SEARCH_ACCESSOR_CACHE_WATCH 0x0002000000000000ull
 
 /* These functions are private and nonstandard parts of the IMM client
    (agent) API. They are used by the process that drives the immnd sync.
@@ -203,6 +210,52 @@ SaAisErrorT immsv_sync(SaImmHandleT immHandle, const SaImmClassNameT className,
 
 SaAisErrorT immsv_finalize_sync(SaImmHandleT immHandle);
 
+/* Counters of the accessorGet config attribute cache of an OM handle.
+   The cache is enabled per handle by the environment variable
+   IMMA_ACCESSOR_CACHE_MAX_BYTES. */
+typedef struct {
+  SaUint64T hits;
+  SaUint64T misses;
+  SaUint64T invalidations;
+  SaUint64T evictions;
+  SaUint64T entries;
+  SaUint64T bytes;
+  SaUint64T maxBytes;
+} ImmsvAccessorCacheStatsT;
+
+SaAisErrorT immsv_om_accessor_cache_stats(SaImmHandleT immHandle,
+                                          ImmsvAccessorCacheStatsT* stats);
+
+/* Batched runtime attribute update for an OI handle (SaImmOiHandleT).
+   'updates' is a NULL terminated array. All objects are sent to the IMMND
+   in one message and the cached attributes of all objects are propagated
+   in one fevs message. Each object is updated atomically, as with
+   saImmOiRtObjectUpdate_2, but the batch as a whole is not: when an
+   error is returned some of the objects may have been updated. The error
+   of the first failing object is returned, and if failedUpdate is not NULL
+   it is set to the index in 'updates' of that object. It is left unchanged
+   if the error is not for one object, e.g. ERR_TRY_AGAIN before any object
+   is updated. Persistent runtime attributes are not accepted in a batch
+   when PBE is enabled (ERR_INVALID_PARAM). */
+typedef struct {
+  SaConstStringT objectName;
+  const SaImmAttrModificationT_2** attrMods;
+} ImmsvRtObjectUpdateT;
+
+SaAisErrorT immsv_oi_rt_object_update_batch(
+    SaUint64T immOiHandle, const ImmsvRtObjectUpdateT** updates,
+    SaUint32T* failedUpdate);
+
+/* Sends the runtime attribute updates held back on an OI handle when
+   coalescing is enabled with IMMA_OI_RT_UPDATE_COALESCE_MSEC. Held back
+   updates have returned SA_AIS_OK, so errors for them are kept until this
+   call: it returns the error of the first held back update that failed
+   since the previous call, whether sent now or earlier, and SA_AIS_OK
+   otherwise. If failedObject is not NULL it is set to the name of that
+   object, or NULL. The name is to be freed with free(). */
+SaAisErrorT immsv_oi_rt_object_update_flush(SaUint64T immOiHandle,
+                                            SaStringT* failedObject);
+
 #ifdef __cplusplus
 }
 #endif
@@ -185,9 +185,11 @@ static const char *immnd_evt_names[] = {
     "IMMND_EVT_A2ND_OBJ_CREATE_2",    /* saImmOmCcbObjectCreate_o3 */
     "IMMND_EVT_A2ND_OI_OBJ_CREATE_2", /* saImmOiRtObjectCreate_o3 */
     "IMMND_EVT_A2ND_OBJ_SAFE_READ",   /* saImmOmCcbObjectRead */
+    "IMMND_EVT_A2ND_OI_OBJ_MODIFY_BATCH", /* immsv_oi_rt_object_update_batch
+					   */
     "undefined (high)"};
 
-static const char *immsv_get_immnd_evt_name(unsigned int id)
+const char *immsv_get_immnd_evt_name(unsigned int id)
 {
 	if (id < IMMND_EVT_MAX)
 		return immnd_evt_names[id];
@@ -591,6 +593,26 @@ void immsv_free_attrmods(IMMSV_ATTR_MODS_LIST *p)
 	}
 }
 
+/* Frees the contents of the inline first object and all chained objects
+   of a runtime update batch. The head itself is not freed. */
+void immsv_free_rt_modify_batch(IMMSV_OI_RT_MODIFY_LIST *p)
+{
+	IMMSV_OI_RT_MODIFY_LIST *head = p;
+	while (p) {
+		IMMSV_OI_RT_MODIFY_LIST *tmp = p;
+		p = p->next;
+		tmp->next = NULL;
+		free(tmp->objModify.objectName.buf);
+		tmp->objModify.objectName.buf = NULL;
+		tmp->objModify.objectName.size = 0;
+		immsv_free_attrmods(tmp->objModify.attrMods);
+		tmp->objModify.attrMods = NULL;
+		if (tmp != head) {
+			free(tmp);
+		}
+	}
+}
+
 void immsv_free_attrvalues_list(IMMSV_ATTR_VALUES_LIST *avl)
 {
 	/*TRACE_ENTER(); */
@@ -1505,7 +1527,9 @@ static uint32_t immsv_evt_enc_sublevels(IMMSV_EVT *i_evt, NCS_UBAID *o_ub)
 		} else if ((i_evt->info.imma.type ==
 			    IMMA_EVT_ND2A_OI_OBJ_DELETE_UC) ||
 			   (i_evt->info.imma.type ==
-			    IMMA_EVT_ND2A_OI_OBJ_DELETE_LONG_UC)) {
+			    IMMA_EVT_ND2A_OI_OBJ_DELETE_LONG_UC) ||
+			   (i_evt->info.imma.type ==
+			    IMMA_EVT_ND2A_ACCESSOR_CACHE_INVALIDATE)) {
 			/*Encode the objectName */
 			IMMSV_OCTET_STRING *os =
 			    &(i_evt->info.imma.info.objDelete.objectName);
@@ -1822,6 +1846,92 @@ static uint32_t immsv_evt_enc_sublevels(IMMSV_EVT *i_evt, NCS_UBAID *o_ub)
 				    __LINE__);
 				return NCSCC_RC_OUT_OF_MEM;
 			}
+		} else if (i_evt->info.immnd.type ==
+			   IMMND_EVT_A2ND_OI_OBJ_MODIFY_BATCH) {
+			int batchDepth = 0;
+			IMMSV_OI_RT_MODIFY_LIST *rtMod =
+			    &(i_evt->info.immnd.info.rtModifyBatch);
+			while (rtMod) {
+				uint8_t *p8;
+				int depth = 0;
+
+				++batchDepth;
+				if (batchDepth >
+				    IMMSV_MAX_OBJS_IN_RT_UPDATE_BATCH) {
+					LOG_ER(
+					    "TOO MANY objects %u > %u in rt update batch line:%u",
+					    batchDepth,
+					    IMMSV_MAX_OBJS_IN_RT_UPDATE_BATCH,
+					    __LINE__);
+					return NCSCC_RC_OUT_OF_MEM;
+				}
+
+				/*Encode the objectName */
+				IMMSV_OCTET_STRING *os =
+				    &(rtMod->objModify.objectName);
+				if (!immsv_evt_enc_inline_text(__LINE__, o_ub,
+							       os)) {
+					return NCSCC_RC_OUT_OF_MEM;
+				}
+
+				/*Encode the list of attribute modifications */
+				IMMSV_ATTR_MODS_LIST *p =
+				    rtMod->objModify.attrMods;
+
+				while (p && (depth < IMMSV_MAX_ATTRIBUTES)) {
+					immsv_evt_enc_attr_mod(o_ub, p);
+					p = p->next;
+					++depth;
+				}
+				if (depth >= IMMSV_MAX_ATTRIBUTES) {
+					LOG_ER(
+					    "TOO MANY attribute modifications line:%u",
+					    __LINE__);
+					return NCSCC_RC_OUT_OF_MEM;
+				}
+
+				rtMod = rtMod->next;
+				if (rtMod) { /* Another object in the batch. */
+					/* next marker == 1 */
+					IMMSV_RSRV_SPACE_ASSERT(p8, o_ub, 1);
+					ncs_encode_8bit(&p8, 1);
+					ncs_enc_claim_space(o_ub, 1);
+
+					IMMSV_RSRV_SPACE_ASSERT(p8, o_ub, 8);
+					ncs_encode_64bit(
+					    &p8, rtMod->objModify.immHandle);
+					ncs_enc_claim_space(o_ub, 8);
+
+					IMMSV_RSRV_SPACE_ASSERT(p8, o_ub, 4);
+					ncs_encode_32bit(
+					    &p8, rtMod->objModify.ccbId);
+					ncs_enc_claim_space(o_ub, 4);
+
+					IMMSV_RSRV_SPACE_ASSERT(p8, o_ub, 4);
+					ncs_encode_32bit(
+					    &p8,
+					    rtMod->objModify.adminOwnerId);
+					ncs_enc_claim_space(o_ub, 4);
+
+					IMMSV_RSRV_SPACE_ASSERT(p8, o_ub, 4);
+					ncs_encode_32bit(
+					    &p8,
+					    rtMod->objModify.objectName.size);
+					ncs_enc_claim_space(o_ub, 4);
+
+					IMMSV_RSRV_SPACE_ASSERT(p8, o_ub, 1);
+					ncs_encode_8bit(
+					    &p8, (rtMod->objModify.attrMods)
+						     ? 0x1
+						     : 0x0);
+					ncs_enc_claim_space(o_ub, 1);
+				} else { /* End of the batch */
+					/* next marker == 0 */
+					IMMSV_RSRV_SPACE_ASSERT(p8, o_ub, 1);
+					ncs_encode_8bit(&p8, 0x0);
+					ncs_enc_claim_space(o_ub, 1);
+				}
+			}
 		} else if ((i_evt->info.immnd.type ==
 			    IMMND_EVT_A2ND_OBJ_DELETE) ||
 			   (i_evt->info.immnd.type ==
@@ -2310,7 +2420,9 @@ static uint32_t immsv_evt_dec_sublevels(NCS_UBAID *i_ub, IMMSV_EVT *o_evt)
 		} else if ((o_evt->info.imma.type ==
 			    IMMA_EVT_ND2A_OI_OBJ_DELETE_UC) ||
 			   (o_evt->info.imma.type ==
-			    IMMA_EVT_ND2A_OI_OBJ_DELETE_LONG_UC)) {
+			    IMMA_EVT_ND2A_OI_OBJ_DELETE_LONG_UC) ||
+			   (o_evt->info.imma.type ==
+			    IMMA_EVT_ND2A_ACCESSOR_CACHE_INVALIDATE)) {
 			/*Decode the objectName */
 			IMMSV_OCTET_STRING *os =
 			    &(o_evt->info.imma.info.objDelete.objectName);
@@ -2526,6 +2638,80 @@ static uint32_t immsv_evt_dec_sublevels(NCS_UBAID *i_ub, IMMSV_EVT *o_evt)
 				immsv_evt_dec_attrmods(i_ub, &p);
 				o_evt->info.immnd.info.objModify.attrMods = p;
 			}
+		} else if (o_evt->info.immnd.type ==
+			   IMMND_EVT_A2ND_OI_OBJ_MODIFY_BATCH) {
+			uint8_t *p8;
+			uint8_t local_data[8];
+			int batchDepth = 0;
+			IMMSV_OI_RT_MODIFY_LIST *rtMod =
+			    &(o_evt->info.immnd.info.rtModifyBatch);
+			while (rtMod) {
+				++batchDepth;
+				if (batchDepth >
+				    IMMSV_MAX_OBJS_IN_RT_UPDATE_BATCH) {
+					LOG_ER(
+					    "TOO MANY objects %u > %u in rt update batch line:%u",
+					    batchDepth,
+					    IMMSV_MAX_OBJS_IN_RT_UPDATE_BATCH,
+					    __LINE__);
+					return NCSCC_RC_OUT_OF_MEM;
+				}
+
+				/*Decode the objectName */
+				IMMSV_OCTET_STRING *os =
+				    &(rtMod->objModify.objectName);
+				immsv_evt_dec_inline_string(i_ub, os);
+
+				/*Decode the list of attribute modifications */
+				IMMSV_ATTR_MODS_LIST *p =
+				    rtMod->objModify.attrMods;
+				if (p) {
+					immsv_evt_dec_attrmods(i_ub, &p);
+					rtMod->objModify.attrMods = p;
+				}
+
+				IMMSV_FLTN_SPACE_ASSERT(p8, local_data, i_ub,
+							1);
+				if (ncs_decode_8bit(&p8)) {
+					rtMod->next = calloc(
+					    1, sizeof(IMMSV_OI_RT_MODIFY_LIST));
+				}
+				ncs_dec_skip_space(i_ub, 1);
+
+				if (rtMod->next) {
+					IMMSV_OM_CCB_OBJECT_MODIFY *next =
+					    &(rtMod->next->objModify);
+					IMMSV_FLTN_SPACE_ASSERT(p8, local_data,
+								i_ub, 8);
+					next->immHandle = ncs_decode_64bit(&p8);
+					ncs_dec_skip_space(i_ub, 8);
+
+					IMMSV_FLTN_SPACE_ASSERT(p8, local_data,
+								i_ub, 4);
+					next->ccbId = ncs_decode_32bit(&p8);
+					ncs_dec_skip_space(i_ub, 4);
+
+					IMMSV_FLTN_SPACE_ASSERT(p8, local_data,
+								i_ub, 4);
+					next->adminOwnerId =
+					    ncs_decode_32bit(&p8);
+					ncs_dec_skip_space(i_ub, 4);
+
+					IMMSV_FLTN_SPACE_ASSERT(p8, local_data,
+								i_ub, 4);
+					next->objectName.size =
+					    ncs_decode_32bit(&p8);
+					ncs_dec_skip_space(i_ub, 4);
+
+					IMMSV_FLTN_SPACE_ASSERT(p8, local_data,
+								i_ub, 1);
+					if (ncs_decode_8bit(&p8)) {
+						next->attrMods = (void *)0x1;
+					}
+					ncs_dec_skip_space(i_ub, 1);
+				}
+				rtMod = rtMod->next;
+			}
 		} else if ((o_evt->info.immnd.type ==
 			    IMMND_EVT_A2ND_OBJ_DELETE) ||
 			   (o_evt->info.immnd.type ==
@@ -3145,6 +3331,7 @@ static uint32_t immsv_evt_enc_toplevel(IMMSV_EVT *i_evt, NCS_UBAID *o_ub)
 
 		case IMMA_EVT_ND2A_OI_OBJ_DELETE_UC: // OBJ DELETE UP-CALL.
 		case IMMA_EVT_ND2A_OI_OBJ_DELETE_LONG_UC:
+		case IMMA_EVT_ND2A_ACCESSOR_CACHE_INVALIDATE:
 			IMMSV_RSRV_SPACE_ASSERT(p8, o_ub, 4);
 			ncs_encode_32bit(&p8, immaevt->info.objDelete.ccbId);
 			ncs_enc_claim_space(o_ub, 4);
@@ -3948,6 +4135,40 @@ static uint32_t immsv_evt_enc_toplevel(IMMSV_EVT *i_evt, NCS_UBAID *o_ub)
 			ncs_enc_claim_space(o_ub, 1);
 			break;
 
+		case IMMND_EVT_A2ND_OI_OBJ_MODIFY_BATCH:
+			/* First object of the batch inline, any further
+			   objects are encoded by sublevel. */
+			IMMSV_RSRV_SPACE_ASSERT(p8, o_ub, 8);
+			ncs_encode_64bit(
+			    &p8,
+			    immndevt->info.rtModifyBatch.objModify.immHandle);
+			ncs_enc_claim_space(o_ub, 8);
+
+			IMMSV_RSRV_SPACE_ASSERT(p8, o_ub, 4);
+			ncs_encode_32bit(
+			    &p8, immndevt->info.rtModifyBatch.objModify.ccbId);
+			ncs_enc_claim_space(o_ub, 4);
+
+			IMMSV_RSRV_SPACE_ASSERT(p8, o_ub, 4);
+			ncs_encode_32bit(
+			    &p8,
+			    immndevt->info.rtModifyBatch.objModify.adminOwnerId);
+			ncs_enc_claim_space(o_ub, 4);
+
+			IMMSV_RSRV_SPACE_ASSERT(p8, o_ub, 4);
+			ncs_encode_32bit(&p8, immndevt->info.rtModifyBatch
+						  .objModify.objectName.size);
+			ncs_enc_claim_space(o_ub, 4);
+
+			IMMSV_RSRV_SPACE_ASSERT(p8, o_ub, 1);
+			ncs_encode_8bit(
+			    &p8,
+			    (immndevt->info.rtModifyBatch.objModify.attrMods)
+				? 1
+				: 0);
+			ncs_enc_claim_space(o_ub, 1);
+			break;
+
 		case IMMND_EVT_A2ND_OBJ_DELETE:    /* saImmOmCcbObjectDelete */
 		case IMMND_EVT_A2ND_OI_OBJ_DELETE: /* saImmOiRtObjectDelete */
 		case IMMND_EVT_A2ND_AUG_ADMO:      /* Inform IMMNDs of admo for
@@ -4857,6 +5078,7 @@ static uint32_t immsv_evt_dec_toplevel(NCS_UBAID *i_ub, IMMSV_EVT *o_evt)
 
 		case IMMA_EVT_ND2A_OI_OBJ_DELETE_UC: // OBJ DELETE UP-CALL.
 		case IMMA_EVT_ND2A_OI_OBJ_DELETE_LONG_UC:
+		case IMMA_EVT_ND2A_ACCESSOR_CACHE_INVALIDATE:
 			IMMSV_FLTN_SPACE_ASSERT(p8, local_data, i_ub, 4);
 			immaevt->info.objDelete.ccbId = ncs_decode_32bit(&p8);
 			ncs_dec_skip_space(i_ub, 4);
@@ -5704,6 +5926,39 @@ static uint32_t immsv_evt_dec_toplevel(NCS_UBAID *i_ub, IMMSV_EVT *o_evt)
 			ncs_dec_skip_space(i_ub, 1);
 			break;
 
+		case IMMND_EVT_A2ND_OI_OBJ_MODIFY_BATCH:
+			/* First object of the batch inline, any further
+			   objects are decoded by sublevel. */
+			IMMSV_FLTN_SPACE_ASSERT(p8, local_data, i_ub, 8);
+			immndevt->info.rtModifyBatch.objModify.immHandle =
+			    ncs_decode_64bit(&p8);
+			ncs_dec_skip_space(i_ub, 8);
+
+			IMMSV_FLTN_SPACE_ASSERT(p8, local_data, i_ub, 4);
+			immndevt->info.rtModifyBatch.objModify.ccbId =
+			    ncs_decode_32bit(&p8);
+			ncs_dec_skip_space(i_ub, 4);
+
+			IMMSV_FLTN_SPACE_ASSERT(p8, local_data, i_ub, 4);
+			immndevt->info.rtModifyBatch.objModify.adminOwnerId =
+			    ncs_decode_32bit(&p8);
+			ncs_dec_skip_space(i_ub, 4);
+
+			IMMSV_FLTN_SPACE_ASSERT(p8, local_data, i_ub, 4);
+			immndevt->info.rtModifyBatch.objModify.objectName.size =
+			    ncs_decode_32bit(&p8);
+			ncs_dec_skip_space(i_ub, 4);
+
+			IMMSV_FLTN_SPACE_ASSERT(p8, local_data, i_ub, 1);
+			if (ncs_decode_8bit(&p8)) {
+				/*Bogus pointer-val forces decode_sublevel to
+				 * decode attrMods. */
+				immndevt->info.rtModifyBatch.objModify.attrMods =
+				    (void *)0x1;
+			}
+			ncs_dec_skip_space(i_ub, 1);
+			break;
+
 		case IMMND_EVT_A2ND_OBJ_DELETE:    /* saImmOmCcbObjectDelete */
 		case IMMND_EVT_A2ND_OI_OBJ_DELETE: /* saImmOiRtObjectDelete */
 		case IMMND_EVT_A2ND_AUG_ADMO:      /* Inform IMMNDs of admo for
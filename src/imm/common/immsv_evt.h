@@ -104,6 +104,8 @@ typedef enum imma_evt_type {
       34, /* when clm-lock/clm-node left the cluster */
   IMMA_EVT_ND2A_IMM_CLM_NODE_JOINED =
       35, /* when clm-lock/clm-node join the cluster */
+  IMMA_EVT_ND2A_ACCESSOR_CACHE_INVALIDATE =
+      36, /* Cached config attrs of an object are stale */
 
   IMMA_EVT_MAX
 } IMMA_EVT_TYPE;
@@ -246,6 +248,8 @@ typedef enum immnd_evt_type {
 
   IMMND_EVT_A2ND_OBJ_SAFE_READ = 100, /* saImmOmCcbObjectRead */
 
+  IMMND_EVT_A2ND_OI_OBJ_MODIFY_BATCH = 101, /* immsv_oi_rt_object_update_batch */
+
   IMMND_EVT_MAX
 } IMMND_EVT_TYPE;
 /* Make sure the string array in immsv_evt.c matches the IMMND_EVT_TYPE enum. */
@@ -571,6 +575,7 @@ typedef struct immnd_evt {
     IMMSV_OM_CCB_OBJECT_MODIFY objModify;
     IMMSV_OM_CCB_OBJECT_DELETE objDelete;
     IMMSV_OM_OBJECT_SYNC obj_sync;
+    IMMSV_OI_RT_MODIFY_LIST rtModifyBatch; /* First object inline */
     IMMSV_OM_FINALIZE_SYNC finSync;
 
     SaUint32T ccbId;                // CcbApply, CcbFinalize, CCbAbort
@@ -664,8 +669,10 @@ void immsv_free_attr_list_raw(IMMSV_EDU_ATTR_VAL_LIST *al, const long avt);
 
 void immsv_msg_trace_send(MDS_DEST to, IMMSV_EVT *evt);
 void immsv_msg_trace_rec(MDS_DEST from, IMMSV_EVT *evt);
+const char *immsv_get_immnd_evt_name(unsigned int id);
 
 void immsv_free_attrmods(IMMSV_ATTR_MODS_LIST *p);
+void immsv_free_rt_modify_batch(IMMSV_OI_RT_MODIFY_LIST *p);
 void immsv_evt_free_admo(IMMSV_ADMO_LIST *p);
 void immsv_evt_free_impl(IMMSV_IMPL_LIST *p);
 void immsv_evt_free_classList(IMMSV_CLASS_LIST *p);
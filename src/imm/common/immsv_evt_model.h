@@ -163,6 +163,11 @@ typedef struct ImmsvOmCcbObjectModify {
   /* Used for first hop A->ND in OiRtUpdate. */
 } IMMSV_OM_CCB_OBJECT_MODIFY;
 
+typedef struct ImmsvOiRtModifyList {
+  IMMSV_OM_CCB_OBJECT_MODIFY objModify;
+  struct ImmsvOiRtModifyList *next;
+} IMMSV_OI_RT_MODIFY_LIST;
+
 typedef struct ImmsvOmCcbObjectDelete {
   SaUint32T ccbId;
   SaUint32T adminOwnerId;  // Rename? used for both adminOwnerId &
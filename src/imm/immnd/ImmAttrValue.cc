@@ -21,20 +21,43 @@
 
 ImmAttrValue::ImmAttrValue() : mValue(0), mValueSize(0) {}
 
-ImmAttrValue::ImmAttrValue(const ImmAttrValue& b)
-    : mValue(NULL), mValueSize(b.mValueSize) {
-  if (mValueSize) {
-    mValue = new char[b.mValueSize];
-    (void)::memcpy(mValue, b.mValue, b.mValueSize);
+ImmAttrValue::ImmAttrValue(const ImmAttrValue& b) : mValue(0), mValueSize(0) {
+  if (b.mValueSize) {
+    (void)::memcpy(allocValue(b.mValueSize), b.valueBuf(), b.mValueSize);
+  }
+}
+
+ImmAttrValue::~ImmAttrValue() { freeValue(); }
+
+char* ImmAttrValue::allocValue(unsigned int size) {
+  osafassert(!mValueSize);
+  mValueSize = size;
+  if (size > kInlineSize) {
+    mValue = new char[size];
+    return mValue;
   }
+  mValue = 0;
+  return mInlineValue;
 }
 
-ImmAttrValue::~ImmAttrValue() {
-  delete[] mValue;
+void ImmAttrValue::freeValue() {
+  if (mValueSize > kInlineSize) {
+    delete[] mValue;
+  }
   mValue = 0;
   mValueSize = 0;
 }
 
+// Takes over the value of b, leaving b empty. Inline or not, the value is
+// fully contained in the union, so no copy of the heap part is needed.
+void ImmAttrValue::moveValueFrom(ImmAttrValue* b) {
+  freeValue();
+  ::memcpy(mInlineValue, b->mInlineValue, kInlineSize);
+  mValueSize = b->mValueSize;
+  b->mValue = 0;
+  b->mValueSize = 0;
+}
+
 void ImmAttrValue::printSimpleValue() const {
   // printf("ImmAttrValue::printSimpleValue size: %u %p\n", mValueSize, mValue);
 }
@@ -43,12 +66,10 @@ void ImmAttrValue::print() const { this->printSimpleValue(); }
 
 ImmAttrValue& ImmAttrValue::operator=(const ImmAttrValue& b) {
   if (this != &b) {
-    delete[] mValue;
+    freeValue();
 
-    mValueSize = b.mValueSize;
-    if (mValueSize) {
-      mValue = new char[b.mValueSize];
-      (void)::memcpy(mValue, b.mValue, b.mValueSize);
+    if (b.mValueSize) {
+      (void)::memcpy(allocValue(b.mValueSize), b.valueBuf(), b.mValueSize);
     }
   }
 
@@ -56,42 +77,28 @@ ImmAttrValue& ImmAttrValue::operator=(const ImmAttrValue& b) {
 }
 
 void ImmAttrValue::setValue(const IMMSV_OCTET_STRING& in) {
-  if (mValue) {
-    if ((in.size == mValueSize) && (memcmp(mValue, in.buf, mValueSize) == 0)) {
+  if (mValueSize) {
+    if ((in.size == mValueSize) &&
+        (memcmp(valueBuf(), in.buf, mValueSize) == 0)) {
       return;
     }  // Already equal
-    delete[] mValue;
-    mValue = 0;
+    freeValue();
   }
 
-  mValueSize = (size_t)in.size;
-  if (mValueSize) {
-    mValue = new char[mValueSize];
-    (void)::memcpy(mValue, in.buf, mValueSize);
+  if (in.size) {
+    (void)::memcpy(allocValue(in.size), in.buf, in.size);
   }
 }
 
-void ImmAttrValue::discardValues() {
-  if (mValue) {
-    delete[] mValue;
-    mValue = 0;
-    mValueSize = 0;
-  }
-}
+void ImmAttrValue::discardValues() { freeValue(); }
 
 void ImmAttrValue::setValue_int(int i) {
-  if (mValue && mValueSize != sizeof(int)) {
-    delete[] mValue;
-    mValue = 0;
-    mValueSize = 0;
-  }
-
-  if (!mValue) {
-    mValueSize = sizeof(int);
-    mValue = new char[mValueSize];
+  if (mValueSize != sizeof(int)) {
+    freeValue();
+    allocValue(sizeof(int));
   }
 
-  *((int*)mValue) = i;
+  (void)::memcpy((char*)valueBuf(), &i, sizeof(int));
 }
 
 int ImmAttrValue::getValue_int() const {
@@ -99,29 +106,28 @@ int ImmAttrValue::getValue_int() const {
     return 0;
   }
 
-  return *((int*)mValue);
+  int i;
+  (void)::memcpy(&i, valueBuf(), sizeof(int));
+  return i;
 }
 
 void ImmAttrValue::setValueC_str(const char* str) {
-  if (mValue) {
+  if (mValueSize) {
     if (str) {
-      if (strncmp(mValue, str, mValueSize) == 0) {
+      if (strncmp(valueBuf(), str, mValueSize) == 0) {
         return;
       }  // Already equal
     }
-    delete[] mValue;
-    mValue = 0;
-    mValueSize = 0;
+    freeValue();
   }
 
   if (str) {
-    mValueSize = (unsigned int)strlen(str) + 1;
-    mValue = new char[mValueSize];
-    strncpy(mValue, str, mValueSize);
+    unsigned int size = (unsigned int)strlen(str) + 1;
+    strncpy(allocValue(size), str, size);
   }
 }
 
-const char* ImmAttrValue::getValueC_str() const { return mValue; }
+const char* ImmAttrValue::getValueC_str() const { return valueBuf(); }
 
 void ImmAttrValue::copyValueToEdu(IMMSV_EDU_ATTR_VAL* out,
                                   SaImmValueTypeT t) const {
@@ -130,29 +136,29 @@ void ImmAttrValue::copyValueToEdu(IMMSV_EDU_ATTR_VAL* out,
     return;
   }
 
-  osafassert(mValue);
+  const char* value = valueBuf();
 
   switch (t) {
     case SA_IMM_ATTR_SAINT32T:
-      out->val.saint32 = *((SaInt32T*)mValue);
+      out->val.saint32 = *((const SaInt32T*)value);
       return;
     case SA_IMM_ATTR_SAUINT32T:
-      out->val.sauint32 = *((SaUint32T*)mValue);
+      out->val.sauint32 = *((const SaUint32T*)value);
       return;
     case SA_IMM_ATTR_SAINT64T:
-      out->val.saint64 = *((SaInt64T*)mValue);
+      out->val.saint64 = *((const SaInt64T*)value);
       return;
     case SA_IMM_ATTR_SAUINT64T:
-      out->val.sauint64 = *((SaUint64T*)mValue);
+      out->val.sauint64 = *((const SaUint64T*)value);
       return;
     case SA_IMM_ATTR_SATIMET:
-      out->val.satime = *((SaTimeT*)mValue);
+      out->val.satime = *((const SaTimeT*)value);
       return;
     case SA_IMM_ATTR_SAFLOATT:
-      out->val.safloat = *((SaFloatT*)mValue);
+      out->val.safloat = *((const SaFloatT*)value);
       return;
     case SA_IMM_ATTR_SADOUBLET:
-      out->val.sadouble = *((SaDoubleT*)mValue);
+      out->val.sadouble = *((const SaDoubleT*)value);
       return;
 
     case SA_IMM_ATTR_SASTRINGT:
@@ -160,7 +166,7 @@ void ImmAttrValue::copyValueToEdu(IMMSV_EDU_ATTR_VAL* out,
     case SA_IMM_ATTR_SANAMET:
       out->val.x.size = mValueSize;
       out->val.x.buf = (char*)malloc(mValueSize);
-      memcpy(out->val.x.buf, mValue, mValueSize);
+      memcpy(out->val.x.buf, value, mValueSize);
 
       break;
 
@@ -179,10 +185,16 @@ bool ImmAttrValue::isMultiValued() const  // virtual
   return false;
 }
 
+size_t ImmAttrValue::memSize() const  // virtual
+{
+  return sizeof(*this) + ((mValueSize > kInlineSize) ? mValueSize : 0);
+}
+
 void ImmAttrValue::removeValue(const IMMSV_OCTET_STRING& match)  // virtual
 {
   if ((mValueSize == match.size) &&
-      (bcmp((const void*)mValue, (const void*)match.buf, mValueSize) == 0)) {
+      (bcmp((const void*)valueBuf(), (const void*)match.buf, mValueSize) ==
+       0)) {
     this->discardValues();
   }
 }
@@ -192,7 +204,8 @@ bool ImmAttrValue::hasMatchingValue(
 {
   if (mValueSize != match.size) return false;
 
-  return bcmp((const void*)mValue, (const void*)match.buf, mValueSize) == 0;
+  return bcmp((const void*)valueBuf(), (const void*)match.buf, mValueSize) ==
+         0;
 }
 
 bool ImmAttrValue::hasDuplicates() const  // virtual
@@ -216,11 +229,7 @@ ImmAttrMultiValue::ImmAttrMultiValue(const ImmAttrValue& b) : ImmAttrValue(b) {
 }
 
 ImmAttrMultiValue::~ImmAttrMultiValue() {
-  if (mValue) {
-    delete[] mValue;
-    mValue = 0;
-    mValueSize = 0;
-  }
+  freeValue();
   if (mNext) {
     delete mNext;
     mNext = 0;
@@ -229,12 +238,9 @@ ImmAttrMultiValue::~ImmAttrMultiValue() {
 
 ImmAttrMultiValue& ImmAttrMultiValue::operator=(const ImmAttrMultiValue& b) {
   if (this != &b) {
-    delete[] mValue;
-    mValue = 0;
-    mValueSize = b.mValueSize;
-    if (mValueSize) {
-      mValue = new char[b.mValueSize];
-      (void)::memcpy(mValue, b.mValue, b.mValueSize);
+    freeValue();
+    if (b.mValueSize) {
+      (void)::memcpy(allocValue(b.mValueSize), b.valueBuf(), b.mValueSize);
     }
   }
 
@@ -251,11 +257,7 @@ ImmAttrMultiValue& ImmAttrMultiValue::operator=(const ImmAttrMultiValue& b) {
 
 void ImmAttrMultiValue::discardValues()  // virtual
 {
-  if (mValue) {
-    delete[] mValue;
-    mValue = 0;
-    mValueSize = 0;
-  }
+  freeValue();
 
   if (mNext) {
     delete mNext;
@@ -271,11 +273,7 @@ void ImmAttrMultiValue::removeValue(const IMMSV_OCTET_STRING& match)  // virtual
     while (!mValueSize && mNext) {  // Empty head => shift up an extra.
       ImmAttrMultiValue* tmp = mNext;
 
-      mValue = tmp->mValue;
-      tmp->mValue = NULL;
-
-      mValueSize = tmp->mValueSize;
-      tmp->mValueSize = 0;
+      moveValueFrom(tmp);
 
       mNext = tmp->mNext;
       tmp->mNext = NULL;
@@ -283,11 +281,10 @@ void ImmAttrMultiValue::removeValue(const IMMSV_OCTET_STRING& match)  // virtual
     }
 
     if (mValueSize && (mValueSize == match.size) &&
-        (bcmp((const void*)mValue, (const void*)match.buf, mValueSize) == 0)) {
+        (bcmp((const void*)valueBuf(), (const void*)match.buf, mValueSize) ==
+         0)) {
       // match!
-      delete[] mValue;
-      mValue = 0;
-      mValueSize = 0;
+      freeValue();
       // Head is now empty because it matched.
     } else {
       tryRemoveHead = false;
@@ -315,7 +312,7 @@ bool ImmAttrMultiValue::hasMatchingValue(
     const IMMSV_OCTET_STRING& match) const  // virtual
 {
   if ((mValueSize == match.size) &&
-      bcmp((const void*)mValue, (const void*)match.buf, mValueSize) == 0) {
+      bcmp((const void*)valueBuf(), (const void*)match.buf, mValueSize) == 0) {
     return true;
   }
 
@@ -325,7 +322,7 @@ bool ImmAttrMultiValue::hasMatchingValue(
 
 bool ImmAttrMultiValue::hasDuplicates() const  // virtual
 {
-  IMMSV_OCTET_STRING match = {mValueSize, mValue};
+  IMMSV_OCTET_STRING match = {mValueSize, (char*)valueBuf()};
 
   return mNext ? (mNext->hasMatchingValue(match) || mNext->hasDuplicates())
                : false;
@@ -355,7 +352,7 @@ void ImmAttrMultiValue::setExtraValueC_str(const char* str) {
 bool ImmAttrMultiValue::hasExtraValueC_str(const char* str) const {
   const ImmAttrMultiValue* mval = this;
   while (mval) {
-    if (strncmp(str, mval->mValue, mval->mValueSize) == 0) {
+    if (strncmp(str, mval->valueBuf(), mval->mValueSize) == 0) {
       return true;
     }
     mval = mval->mNext;
@@ -366,7 +363,7 @@ bool ImmAttrMultiValue::hasExtraValueC_str(const char* str) const {
 bool ImmAttrMultiValue::removeExtraValueC_str(const char* str) {
   ImmAttrMultiValue* mval = this;
   while (mval->mNext) {
-    if (strncmp(str, mval->mNext->mValue, mval->mNext->mValueSize) == 0) {
+    if (strncmp(str, mval->mNext->valueBuf(), mval->mNext->mValueSize) == 0) {
       ImmAttrMultiValue* tmp = mval->mNext;
       mval->mNext = mval->mNext->mNext;
       tmp->mNext = NULL;
@@ -409,6 +406,20 @@ bool ImmAttrMultiValue::isMultiValued() const  // virtual
   return true;
 }
 
+size_t ImmAttrMultiValue::memSize() const  // virtual
+{
+  size_t size = 0;
+  const ImmAttrMultiValue* mval = this;
+  while (mval) {
+    size += sizeof(*mval);
+    if (mval->mValueSize > kInlineSize) {
+      size += mval->mValueSize;
+    }
+    mval = mval->mNext;
+  }
+  return size;
+}
+
 void ImmAttrMultiValue::printMultiValue() const {
   this->printSimpleValue();
   // printf("ImmAttrMultiValue::printMultiValue() mNext: %p\n", mNext);
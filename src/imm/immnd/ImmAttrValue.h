@@ -23,6 +23,7 @@
 #ifndef IMM_IMMND_IMMATTRVALUE_H_
 #define IMM_IMMND_IMMATTRVALUE_H_ 1
 
+#include <stddef.h>
 #include "imm/common/immsv_evt_model.h"
 
 /**
@@ -40,6 +41,7 @@ class ImmAttrValue {
   virtual void removeValue(const IMMSV_OCTET_STRING& match);
   virtual bool hasMatchingValue(const IMMSV_OCTET_STRING& match) const;
   virtual bool hasDuplicates() const;
+  virtual size_t memSize() const;  // Heap bytes, including the object itself
 
   void printSimpleValue() const;
 
@@ -54,7 +56,23 @@ class ImmAttrValue {
   bool empty() const { return !mValueSize; }
 
  protected:
-  char* mValue;
+  // Values of at most sizeof(char*) bytes, i.e. all numeric types and
+  // short strings, are stored inline. This saves one heap allocation per
+  // value, which dominates the memory use of large models.
+  static const unsigned int kInlineSize = sizeof(char*);
+
+  const char* valueBuf() const {
+    return !mValueSize ? 0
+                       : (mValueSize > kInlineSize ? mValue : mInlineValue);
+  }
+  char* allocValue(unsigned int size);
+  void freeValue();
+  void moveValueFrom(ImmAttrValue* b);
+
+  union {
+    char* mValue;  // Heap copy when mValueSize > kInlineSize
+    char mInlineValue[kInlineSize];
+  };
   unsigned int mValueSize;
 };
 
@@ -71,6 +89,7 @@ class ImmAttrMultiValue : public ImmAttrValue {
   virtual void removeValue(const IMMSV_OCTET_STRING& match);
   virtual bool hasMatchingValue(const IMMSV_OCTET_STRING& match) const;
   virtual bool hasDuplicates() const;
+  virtual size_t memSize() const;
 
   void printMultiValue() const;
 
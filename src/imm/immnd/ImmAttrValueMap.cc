@@ -0,0 +1,97 @@
+/*      -*- OpenSAF  -*-
+ *
+ * (C) Copyright 2017 The OpenSAF Foundation
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. This file and program are licensed
+ * under the GNU Lesser General Public License Version 2.1, February 1999.
+ * The complete license can be accessed from the following location:
+ * http://opensource.org/licenses/lgpl-license.php
+ * See the Copying file included with the OpenSAF distribution for full
+ * licensing terms.
+ *
+ */
+
+#include "imm/immnd/ImmAttrValueMap.h"
+#include <string.h>
+#include "immnd.h"
+
+int ImmAttrLayout::indexOf(const std::string& name) const {
+  std::map<std::string, unsigned int>::const_iterator it = mIndex.find(name);
+  return (it == mIndex.end()) ? -1 : (int)it->second;
+}
+
+unsigned int ImmAttrLayout::add(const std::string& name) {
+  std::pair<std::map<std::string, unsigned int>::iterator, bool> res =
+      mIndex.insert(std::make_pair(name, (unsigned int)mNames.size()));
+  if (res.second) {
+    mNames.push_back(&(res.first->first));
+  }
+  return res.first->second;
+}
+
+ImmAttrValueMap::~ImmAttrValueMap() {
+  clear();
+  if (mLayout) {
+    mLayout->unref();
+    mLayout = NULL;
+  }
+}
+
+void ImmAttrValueMap::bind(ImmAttrLayout* layout) {
+  if (layout == mLayout) {
+    return;
+  }
+  osafassert(!mSize);
+  if (mLayout) {
+    mLayout->unref();
+  }
+  mLayout = layout;
+  mLayout->ref();
+}
+
+unsigned int ImmAttrValueMap::slotOf(const std::string& name) const {
+  if (!mLayout) {
+    return mSize;
+  }
+  int ix = mLayout->indexOf(name);
+  if (ix < 0 || (unsigned int)ix >= mSize || !mSlots[ix]) {
+    return mSize;
+  }
+  return (unsigned int)ix;
+}
+
+ImmAttrValueMap::iterator ImmAttrValueMap::find(const std::string& name) {
+  return iterator(this, slotOf(name));
+}
+
+ImmAttrValueMap::const_iterator ImmAttrValueMap::find(
+    const std::string& name) const {
+  return const_iterator(this, slotOf(name));
+}
+
+ImmAttrValue*& ImmAttrValueMap::operator[](const std::string& name) {
+  osafassert(mLayout);
+  unsigned int ix = mLayout->add(name);
+  if (ix >= mSize) {
+    /* Size for the whole layout, so that objects created after the
+       first object of a class need only one allocation. */
+    unsigned int size = mLayout->size();
+    ImmAttrValue** slots = new ImmAttrValue*[size];
+    if (mSize) {
+      memcpy(slots, mSlots, mSize * sizeof(ImmAttrValue*));
+    }
+    memset(slots + mSize, 0, (size - mSize) * sizeof(ImmAttrValue*));
+    delete[] mSlots;
+    mSlots = slots;
+    mSize = size;
+  }
+  return mSlots[ix];
+}
+
+void ImmAttrValueMap::clear() {
+  delete[] mSlots;
+  mSlots = NULL;
+  mSize = 0;
+}
@@ -0,0 +1,156 @@
+/*      -*- OpenSAF  -*-
+ *
+ * (C) Copyright 2017 The OpenSAF Foundation
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. This file and program are licensed
+ * under the GNU Lesser General Public License Version 2.1, February 1999.
+ * The complete license can be accessed from the following location:
+ * http://opensource.org/licenses/lgpl-license.php
+ * See the Copying file included with the OpenSAF distribution for full
+ * licensing terms.
+ *
+ */
+
+/*
+  Compact per object attribute value storage for the IMMND.
+  Only included by the IMMND.
+
+  An object used to hold a std::map from attribute name to value, i.e. one
+  tree node and one copy of the attribute name per attribute and object.
+  ImmAttrValueMap instead holds one value pointer per attribute, in a slot
+  array indexed by the position of the attribute in the ImmAttrLayout of
+  the class. The attribute names are stored once, in the layout.
+
+  ImmAttrValueMap keeps the subset of the std::map interface used by
+  ImmModel: find, operator[], clear and iteration with ->first/->second.
+  A NULL slot means the attribute is not present in the object.
+*/
+
+#ifndef IMM_IMMND_IMMATTRVALUEMAP_H_
+#define IMM_IMMND_IMMATTRVALUEMAP_H_ 1
+
+#include <map>
+#include <string>
+#include <vector>
+
+class ImmAttrValue;
+
+/**
+ * The attribute names of a class, in the order they were added. Schema
+ * upgrade only adds attributes, so the layout only grows and slot indexes
+ * stay valid. Reference counted: the class and every bound
+ * ImmAttrValueMap hold one reference each, so a before-image that outlives
+ * the class never dangles.
+ */
+class ImmAttrLayout {
+ public:
+  ImmAttrLayout() : mRefCount(1) {}
+
+  int indexOf(const std::string& name) const;  // -1 if not in the layout
+  unsigned int add(const std::string& name);   // Index of new/existing name
+  const std::string& nameAt(unsigned int ix) const { return *mNames[ix]; }
+  unsigned int size() const { return (unsigned int)mNames.size(); }
+
+  void ref() { ++mRefCount; }
+  void unref() {
+    if (--mRefCount == 0) delete this;
+  }
+
+ private:
+  ~ImmAttrLayout() {}
+  ImmAttrLayout(const ImmAttrLayout&) = delete;
+  ImmAttrLayout& operator=(const ImmAttrLayout&) = delete;
+
+  std::map<std::string, unsigned int> mIndex;
+  std::vector<const std::string*> mNames;  // Points to keys of mIndex
+  unsigned int mRefCount;
+};
+
+class ImmAttrValueMap {
+  template <typename Slot>
+  struct Entry {
+    const std::string& first;
+    Slot& second;
+  };
+
+  template <typename Slot>
+  struct EntryPtr {
+    Entry<Slot> entry;
+    Entry<Slot>* operator->() { return &entry; }
+  };
+
+  template <typename Map, typename Slot>
+  class Iter {
+   public:
+    Iter() : mMap(NULL), mIx(0) {}
+    Iter(Map* map, unsigned int ix) : mMap(map), mIx(ix) { skipEmpty(); }
+    template <typename M, typename S>
+    Iter(const Iter<M, S>& b) : mMap(b.mMap), mIx(b.mIx) {}
+
+    Entry<Slot> operator*() const {
+      return Entry<Slot>{mMap->mLayout->nameAt(mIx), mMap->mSlots[mIx]};
+    }
+    EntryPtr<Slot> operator->() const { return EntryPtr<Slot>{**this}; }
+    Iter& operator++() {
+      ++mIx;
+      skipEmpty();
+      return *this;
+    }
+    bool operator==(const Iter& b) const { return mIx == b.mIx; }
+    bool operator!=(const Iter& b) const { return mIx != b.mIx; }
+
+   private:
+    template <typename M, typename S>
+    friend class Iter;
+
+    void skipEmpty() {
+      while (mIx < mMap->mSize && !mMap->mSlots[mIx]) ++mIx;
+    }
+
+    Map* mMap;
+    unsigned int mIx;  // mMap->mSize => end
+  };
+
+ public:
+  typedef Iter<ImmAttrValueMap, ImmAttrValue*> iterator;
+  typedef Iter<const ImmAttrValueMap, ImmAttrValue* const> const_iterator;
+
+  ImmAttrValueMap() : mLayout(NULL), mSlots(NULL), mSize(0) {}
+  ~ImmAttrValueMap();
+
+  // Must be called before the first operator[], normally with the layout
+  // of the class of the object.
+  void bind(ImmAttrLayout* layout);
+
+  iterator begin() { return iterator(this, 0); }
+  iterator end() { return iterator(this, mSize); }
+  const_iterator begin() const { return const_iterator(this, 0); }
+  const_iterator end() const { return const_iterator(this, mSize); }
+
+  iterator find(const std::string& name);
+  const_iterator find(const std::string& name) const;
+
+  // As for std::map, an attribute that is not present is added with a
+  // NULL value. An attribute not in the layout is added to the layout.
+  ImmAttrValue*& operator[](const std::string& name);
+
+  // Forgets all values, does not delete them.
+  void clear();
+
+  // Heap bytes of the slot array, excluding the values.
+  size_t memSize() const { return mSize * sizeof(ImmAttrValue*); }
+
+ private:
+  ImmAttrValueMap(const ImmAttrValueMap&) = delete;
+  ImmAttrValueMap& operator=(const ImmAttrValueMap&) = delete;
+
+  unsigned int slotOf(const std::string& name) const;  // mSize if absent
+
+  ImmAttrLayout* mLayout;
+  ImmAttrValue** mSlots;
+  unsigned int mSize;
+};
+
+#endif  // IMM_IMMND_IMMATTRVALUEMAP_H_
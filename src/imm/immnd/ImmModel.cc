@@ -23,6 +23,7 @@
 
 #include "imm/immnd/ImmModel.h"
 #include "imm/immnd/ImmAttrValue.h"
+#include "imm/immnd/ImmAttrValueMap.h"
 #include "imm/immnd/ImmSearchOp.h"
 
 #include "immnd.h"
@@ -115,22 +116,25 @@ typedef std::set<ObjectInfo*> ObjectSet;
 
 struct ClassInfo {
   explicit ClassInfo(SaUint32T category)
-      : mCategory(category), mImplementer(NULL) {}
+      : mCategory(category),
+        mAttrLayout(new ImmAttrLayout()),
+        mImplementer(NULL) {}
   ~ClassInfo() {
     mCategory = 0;
+    mAttrLayout->unref();
+    mAttrLayout = NULL;
     mImplementer = NULL;
   }
 
   SaUint32T mCategory;
   AttrMap mAttrMap;               //<-Each AttrInfo requires explicit delete
+  ImmAttrLayout* mAttrLayout;     //<-Slot order of mAttrValueMap in objects
   ImplementerInfo* mImplementer;  //<- Main OI points INTO sImplementerVector
   ObjectSet mExtent;
   ImplementerSet mAppliers;  // OIs did classImplementerSet on this class
 };
 typedef std::map<std::string, ClassInfo*> ClassMap;
 
-typedef std::map<std::string, ImmAttrValue*> ImmAttrValueMap;
-
 typedef SaUint32T ImmObjectFlags;
 #define IMM_CREATE_LOCK 0x00000001
 // If create lock is on, it signifies that a ccb has reserved space in
@@ -238,6 +242,7 @@ struct ObjectInfo {
   SaUint32T mCcbId;  // Zero => may be read-locked see:IMM_SHARED_READ_LOCK
                      // Nonzero => may be exclusive lock if id is active ccb
   ImmAttrValueMap mAttrValueMap;  //<-Each ImmAttrValue needs explicit delete
+                                  // Bound to mClassInfo->mAttrLayout
   ClassInfo* mClassInfo;          //<-Points INTO ClassMap. Not own copy!
   ImplementerInfo* mImplementer;  //<-Points INTO ImplementerVector
   ImmObjectFlags mObjFlags;
@@ -372,7 +377,9 @@ struct CcbInfo {
         mPbeRestartId(0),
         mErrorStrings(NULL),
         mAugCcbParent(NULL),
-        mPurged(false) {}
+        mPurged(false) {
+    osaf_clock_gettime(CLOCK_MONOTONIC, &mCreateTime);
+  }
   bool isOk() { return mVeto == SA_AIS_OK; }
   bool isActive() { return (mState < IMM_CCB_COMMITTED); }
   void addObjReadLock(ObjectInfo* obj, std::string& objName);
@@ -392,6 +399,7 @@ struct CcbInfo {
   ObjectMutationMap mMutations;
   SaAisErrorT mVeto;  // SA_AIS_OK as long as no "participan" voted error.
   timespec mWaitStartTime;
+  timespec mCreateTime; /* For the ccb lifetime shown by resourceDisplay */
   SaUint32T mOpCount;
   SaUint32T mPbeRestartId; /* ImplId for new PBE to resolve CCBs in critical */
   ImplementerSet mLocalAppliers;
@@ -566,6 +574,16 @@ static DeferredObjUpdatesMap sDeferredObjUpdatesMap;
 
 static ImplementerSetMap sObjAppliersMap;
 
+// OM clients with accessor cache entries per object, see
+// SA_IMM_SEARCH_ACCESSOR_CACHE_WATCH. A watch is one-shot: it is dropped
+// when the invalidation is queued and re-established by the next fill.
+typedef std::set<SaImmHandleT> ImmHandleSet;
+typedef std::map<std::string, ImmHandleSet> AccessorCacheWatchMap;
+typedef std::list<std::pair<SaImmHandleT, std::string>>
+    AccessorCacheInvalidationList;
+static AccessorCacheWatchMap sAccessorCacheWatchMap;
+static AccessorCacheInvalidationList sAccessorCacheInvalidations;
+
 static SaUint32T sLastContinuationId = 0;
 
 static ImmNodeState sImmNodeState = IMM_NODE_UNKNOWN;
@@ -1117,6 +1135,10 @@ bool immModel_protocol51Allowed(IMMND_CB* cb) {
   return ImmModel::instance(&cb->immModel)->protocol51Allowed();
 }
 
+bool immModel_protocol52Allowed(IMMND_CB* cb) {
+  return ImmModel::instance(&cb->immModel)->protocol52Allowed();
+}
+
 OsafImmAccessControlModeT immModel_accessControlMode(IMMND_CB* cb) {
   return ImmModel::instance(&cb->immModel)->accessControlMode();
 }
@@ -2031,6 +2053,30 @@ void immModel_discardContinuations(IMMND_CB* cb, SaUint32T deadConn) {
   ImmModel::instance(&cb->immModel)->discardContinuations(deadConn);
 }
 
+void immModel_accessorCacheWatch(IMMND_CB* cb, const IMMSV_OCTET_STRING* dn,
+                                 SaImmHandleT client) {
+  size_t sz = strnlen((char*)dn->buf, (size_t)dn->size);
+  std::string objectName((const char*)dn->buf, sz);
+  ImmModel::instance(&cb->immModel)->accessorCacheWatch(objectName, client);
+}
+
+void immModel_accessorCacheUnwatch(IMMND_CB* cb, SaUint32T deadConn) {
+  ImmModel::instance(&cb->immModel)->accessorCacheUnwatch(deadConn);
+}
+
+bool immModel_popAccessorCacheInvalidation(IMMND_CB* cb, SaImmHandleT* client,
+                                           IMMSV_OCTET_STRING* dn) {
+  std::string objectName;
+  if (!ImmModel::instance(&cb->immModel)
+           ->popAccessorCacheInvalidation(client, objectName)) {
+    return false;
+  }
+  dn->size = (SaUint32T)objectName.size() + 1;
+  dn->buf = (char*)malloc(dn->size);
+  strncpy(dn->buf, objectName.c_str(), dn->size);
+  return true;
+}
+
 SaAisErrorT immModel_objectSync(IMMND_CB* cb,
                                 const struct ImmsvOmObjectSync* req) {
   return ImmModel::instance(&cb->immModel)->objectSync(req);
@@ -2177,6 +2223,11 @@ void immModel_deferRtUpdate(IMMND_CB* cb, struct ImmsvOmCcbObjectModify* req,
   ImmModel::instance(&cb->immModel)->deferRtUpdate(req, msgNo);
 }
 
+bool immModel_rtObjectUpdateIsPersistent(
+    IMMND_CB* cb, const struct ImmsvOmCcbObjectModify* req) {
+  return ImmModel::instance(&cb->immModel)->rtObjectUpdateIsPersistent(req);
+}
+
 bool immModel_fetchRtUpdate(IMMND_CB* cb, struct ImmsvOmObjectSync* syncReq,
                             struct ImmsvOmCcbObjectModify* rtModReq,
                             SaUint64T syncFevsBase) {
@@ -2189,6 +2240,7 @@ SaAisErrorT immModel_resourceDisplay(
     struct ImmsvAdminOperationParam** rparams) {
   const struct ImmsvAdminOperationParam* params = reqparams;
   SaStringT opName = NULL;
+  ImmndDisplayInfo info;
   SaUint64T searchcount = 0;
 
   while (params) {
@@ -2215,8 +2267,15 @@ SaAisErrorT immModel_resourceDisplay(
     }
   }
 
+  info.searchCount = searchcount;
+  info.fevsRepliesPending = cb->fevs_replies_pending;
+  info.fevsOutCount = cb->fevs_out_count;
+  info.highestReceived = cb->highestReceived;
+  info.highestProcessed = cb->highestProcessed;
+  info.latency = cb->latency;
+
   return ImmModel::instance(&cb->immModel)
-      ->resourceDisplay(reqparams, rparams, searchcount);
+      ->resourceDisplay(reqparams, rparams, info);
 }
 
 void immModel_setCcbErrorString(IMMND_CB* cb, SaUint32T ccbId,
@@ -3897,6 +3956,30 @@ bool ImmModel::protocol51Allowed() {
   return noStdFlags & OPENSAF_IMM_FLAG_PRT51_ALLOW;
 }
 
+bool ImmModel::protocol52Allowed() {
+  // TRACE_ENTER();
+  /* Assume that all nodes are running the same version when loading */
+  if (sImmNodeState == IMM_NODE_LOADING) {
+    return true;
+  }
+  ObjectMap::iterator oi = sObjectMap.find(immObjectDn);
+  if (oi == sObjectMap.end()) {
+    // TRACE_LEAVE();
+    return false;
+  }
+
+  ObjectInfo* immObject = oi->second;
+  ImmAttrValueMap::iterator avi =
+      immObject->mAttrValueMap.find(immAttrNostFlags);
+  osafassert(avi != immObject->mAttrValueMap.end());
+  osafassert(!(avi->second->isMultiValued()));
+  ImmAttrValue* valuep = avi->second;
+  unsigned int noStdFlags = valuep->getValue_int();
+
+  // TRACE_LEAVE();
+  return noStdFlags & OPENSAF_IMM_FLAG_PRT52_ALLOW;
+}
+
 bool ImmModel::protocol41Allowed() {
   // TRACE_ENTER();
   ObjectMap::iterator oi = sObjectMap.find(immObjectDn);
@@ -4998,6 +5081,7 @@ SaAisErrorT ImmModel::adminOwnerDelete(SaUint32T ownerId, bool hard,
                 "The new OpenSAF 5.1 attributes are not added to OpensafImm class");
           } else {
             noStdFlags |= OPENSAF_IMM_FLAG_PRT51_ALLOW;
+            noStdFlags |= OPENSAF_IMM_FLAG_PRT52_ALLOW;
           }
           valuep->setValue_int(noStdFlags);
           LOG_NO("%s changed to: 0x%x", immAttrNostFlags.c_str(), noStdFlags);
@@ -5910,6 +5994,7 @@ void ImmModel::commitCreate(ObjectInfo* obj) {
 bool ImmModel::commitModify(const std::string& dn, ObjectInfo* afterImage) {
   TRACE_ENTER();
   TRACE_5("COMMITING MODIFY of %s", dn.c_str());
+  accessorCacheInvalidate(dn);
   ObjectMap::iterator oi = sObjectMap.find(dn);
   osafassert(oi != sObjectMap.end());
   ObjectInfo* beforeImage = oi->second;
@@ -6008,6 +6093,7 @@ bool ImmModel::commitModify(const std::string& dn, ObjectInfo* afterImage) {
 void ImmModel::commitDelete(const std::string& dn) {
   TRACE_ENTER();
   TRACE_5("COMMITING DELETE of %s", dn.c_str());
+  accessorCacheInvalidate(dn);
   ObjectMap::iterator oi = sObjectMap.find(dn);
   osafassert(oi != sObjectMap.end());
 
@@ -6069,6 +6155,66 @@ void ImmModel::commitDelete(const std::string& dn) {
   TRACE_LEAVE();
 }
 
+void ImmModel::accessorCacheWatch(const std::string& objectName,
+                                  SaImmHandleT client) {
+  TRACE_5("Accessor cache watch on %s by client %llx", objectName.c_str(),
+          client);
+  sAccessorCacheWatchMap[objectName].insert(client);
+}
+
+void ImmModel::accessorCacheUnwatch(SaUint32T dead) {
+  AccessorCacheWatchMap::iterator wi = sAccessorCacheWatchMap.begin();
+  while (wi != sAccessorCacheWatchMap.end()) {
+    ImmHandleSet::iterator hi = wi->second.begin();
+    while (hi != wi->second.end()) {
+      if (m_IMMSV_UNPACK_HANDLE_HIGH(*hi) == dead) {
+        hi = wi->second.erase(hi);
+      } else {
+        ++hi;
+      }
+    }
+    if (wi->second.empty()) {
+      wi = sAccessorCacheWatchMap.erase(wi);
+    } else {
+      ++wi;
+    }
+  }
+
+  AccessorCacheInvalidationList::iterator ii =
+      sAccessorCacheInvalidations.begin();
+  while (ii != sAccessorCacheInvalidations.end()) {
+    if (m_IMMSV_UNPACK_HANDLE_HIGH(ii->first) == dead) {
+      ii = sAccessorCacheInvalidations.erase(ii);
+    } else {
+      ++ii;
+    }
+  }
+}
+
+void ImmModel::accessorCacheInvalidate(const std::string& dn) {
+  AccessorCacheWatchMap::iterator wi = sAccessorCacheWatchMap.find(dn);
+  if (wi == sAccessorCacheWatchMap.end()) {
+    return;
+  }
+
+  for (ImmHandleSet::iterator hi = wi->second.begin(); hi != wi->second.end();
+       ++hi) {
+    sAccessorCacheInvalidations.push_back(std::make_pair(*hi, dn));
+  }
+  sAccessorCacheWatchMap.erase(wi);
+}
+
+bool ImmModel::popAccessorCacheInvalidation(SaImmHandleT* client,
+                                            std::string& objectName) {
+  if (sAccessorCacheInvalidations.empty()) {
+    return false;
+  }
+  *client = sAccessorCacheInvalidations.front().first;
+  objectName = sAccessorCacheInvalidations.front().second;
+  sAccessorCacheInvalidations.pop_front();
+  return true;
+}
+
 bool ImmModel::ccbCommit(SaUint32T ccbId, ConnVector& connVector) {
   TRACE_ENTER();
   CcbVector::iterator i;
@@ -8114,6 +8260,7 @@ SaAisErrorT ImmModel::ccbObjectCreate(
     ObjectInfo* object = new ObjectInfo();
     object->mCcbId = req->ccbId;
     object->mClassInfo = classInfo;
+    object->mAttrValueMap.bind(classInfo->mAttrLayout);
     object->mImplementer = classInfo->mImplementer;
     // Note: mObjFlags is both initialized and assigned below
     if (nameCorrected) {
@@ -9151,6 +9298,7 @@ SaAisErrorT ImmModel::ccbObjectModify(
     afim = new ObjectInfo();
     afim->mCcbId = ccbId;
     afim->mClassInfo = classInfo;
+    afim->mAttrValueMap.bind(classInfo->mAttrLayout);
     afim->mImplementer = object->mImplementer;
     afim->mObjFlags = object->mObjFlags;
     afim->mParent = object->mParent;
@@ -12302,7 +12450,7 @@ SaAisErrorT ImmModel::searchInitialize(ImmsvOmSearchInit* req,
         SA_IMM_SEARCH_GET_NO_ATTR | SA_IMM_SEARCH_GET_SOME_ATTR |
         SA_IMM_SEARCH_GET_CONFIG_ATTR | SA_IMM_SEARCH_PERSISTENT_ATTRS |
         SA_IMM_SEARCH_SYNC_CACHED_ATTRS | SA_IMM_SEARCH_NO_DANGLING_DEPENDENTS |
-        SA_IMM_SEARCH_NO_RDN);
+        SA_IMM_SEARCH_NO_RDN | SA_IMM_SEARCH_ACCESSOR_CACHE_WATCH);
 
   if (unknownOptions) {
     LOG_NO("ERR_INVALID_PARAM: invalid search option 0x%llx", unknownOptions);
@@ -13456,9 +13604,69 @@ done:
   return err;
 }
 
+static struct ImmsvAdminOperationParam* displayParam(
+    const char* name, SaImmValueTypeT type,
+    struct ImmsvAdminOperationParam** last,
+    struct ImmsvAdminOperationParam** first) {
+  struct ImmsvAdminOperationParam* res =
+      (struct ImmsvAdminOperationParam*)calloc(
+          1, sizeof(struct ImmsvAdminOperationParam));
+  res->paramType = type;
+  res->next = NULL;
+  res->paramName.size = strlen(name) + 1;
+  res->paramName.buf = (char*)malloc(res->paramName.size);
+  strcpy(res->paramName.buf, name);
+  if (*last) {
+    (*last)->next = res;
+  } else {
+    *first = res;
+  }
+  *last = res;
+  return res;
+}
+
+static void displayParamInt64(const char* name, SaInt64T value,
+                              struct ImmsvAdminOperationParam** last,
+                              struct ImmsvAdminOperationParam** first) {
+  displayParam(name, SA_IMM_ATTR_SAINT64T, last, first)
+      ->paramBuffer.val.saint64 = value;
+}
+
+static void displayParamString(const char* name, const std::string& value,
+                               struct ImmsvAdminOperationParam** last,
+                               struct ImmsvAdminOperationParam** first) {
+  struct ImmsvAdminOperationParam* res =
+      displayParam(name, SA_IMM_ATTR_SASTRINGT, last, first);
+  res->paramBuffer.val.x.size = value.length() + 1;
+  res->paramBuffer.val.x.buf = strdup(value.c_str());
+}
+
+/* Estimated heap bytes of one object, including its entry in sObjectMap. */
+static size_t objectMemSize(const std::string& dn, const ObjectInfo* obj) {
+  size_t bytes = sizeof(ObjectInfo) + sizeof(ObjectMap::value_type) +
+                 dn.capacity() + obj->mAttrValueMap.memSize();
+  ImmAttrValueMap::const_iterator avi;
+  for (avi = obj->mAttrValueMap.begin(); avi != obj->mAttrValueMap.end();
+       ++avi) {
+    bytes += avi->second->memSize();
+  }
+  return bytes;
+}
+
+static const char* ccbStateName(ImmCcbState state) {
+  if (state < IMM_CCB_CRITICAL) {
+    return "active";
+  } else if (state == IMM_CCB_CRITICAL) {
+    return "critical";
+  } else if (state == IMM_CCB_COMMITTED) {
+    return "committed";
+  }
+  return "aborted";
+}
+
 SaAisErrorT ImmModel::resourceDisplay(
     const struct ImmsvAdminOperationParam* reqparams,
-    struct ImmsvAdminOperationParam** rparams, SaUint64T searchcount) {
+    struct ImmsvAdminOperationParam** rparams, const ImmndDisplayInfo& info) {
   SaAisErrorT err = SA_AIS_OK;
   const struct ImmsvAdminOperationParam* params = reqparams;
   SaStringT opName = NULL, resourceName = NULL, errStr = NULL;
@@ -13521,13 +13729,25 @@ SaAisErrorT ImmModel::resourceDisplay(
     } else if ((strcmp(resourceName, "ccbs") == 0)) {
       resparams->paramBuffer.val.saint64 = sCcbVector.size();
     } else if ((strcmp(resourceName, "searches") == 0)) {
-      resparams->paramBuffer.val.saint64 = searchcount;
+      resparams->paramBuffer.val.saint64 = info.searchCount;
+    } else if ((strcmp(resourceName, "classes") == 0)) {
+      resparams->paramBuffer.val.saint64 = sClassMap.size();
+    } else if ((strcmp(resourceName, "objects") == 0)) {
+      resparams->paramBuffer.val.saint64 = sObjectMap.size();
+    } else if ((strcmp(resourceName, "fevs") == 0)) {
+      resparams->paramBuffer.val.saint64 = info.fevsRepliesPending;
+    } else if ((strcmp(resourceName, "latency") == 0)) {
+      SaInt64T count = 0;
+      for (int ix = 0; ix < IMMND_EVT_MAX; ++ix) {
+        count += info.latency[ix].count;
+      }
+      resparams->paramBuffer.val.saint64 = count;
     } else {
       LOG_WA("Display of IMM reources for resourceName %s is unsupported",
              resourceName);
       err = SA_AIS_ERR_INVALID_PARAM;
       errStr =
-          strdup("Display of IMM reources for resourceName is unsupported") + 1;
+          strdup("Display of IMM reources for resourceName is unsupported");
       free(resparams);
       resparams = NULL;
       goto done;
@@ -13575,26 +13795,31 @@ SaAisErrorT ImmModel::resourceDisplay(
       }
     } else if ((strcmp(resourceName, "adminowners") == 0)) {
       if (!sOwnerVector.empty()) {
+        /* Objects and bytes per admin owner name. An owner only keeps its
+           objects in mTouchedObjects with release on finalize, so every
+           object is walked, only when asked for. */
+        std::map<std::string, std::pair<size_t, size_t>> usage;
+        ObjectMap::iterator oi;
+        for (oi = sObjectMap.begin(); oi != sObjectMap.end(); ++oi) {
+          std::string ownerName;
+          oi->second->getAdminOwnerName(&ownerName);
+          if (!ownerName.empty()) {
+            std::pair<size_t, size_t>& owned = usage[ownerName];
+            owned.first++;
+            owned.second += objectMemSize(oi->first, oi->second);
+          }
+        }
         if (sOwnerVector.size() < 128) {
           AdminOwnerVector::iterator i;
           for (i = sOwnerVector.begin(); i != sOwnerVector.end(); ++i) {
             AdminOwnerInfo* adminOwner = (*i);
-            struct ImmsvAdminOperationParam* res =
-                (struct ImmsvAdminOperationParam*)calloc(
-                    1, sizeof(struct ImmsvAdminOperationParam));
-            res->paramType = SA_IMM_ATTR_SAINT64T;
-            res->next = NULL;
-            res->paramName.size = adminOwner->mAdminOwnerName.length() + 1;
-            res->paramName.buf = (char*)malloc(res->paramName.size);
-            strcpy(res->paramName.buf, adminOwner->mAdminOwnerName.c_str());
-            res->paramBuffer.val.saint64 = adminOwner->mNodeId;
-            if (result) {
-              result->next = res;
-              result = res;
-            } else {
-              result = res;
-              resparams = res;
-            }
+            const std::pair<size_t, size_t>& owned =
+                usage[adminOwner->mAdminOwnerName];
+            char buf[96];
+            snprintf(buf, sizeof(buf), "node:%x objects:%zu bytes:%zu",
+                     adminOwner->mNodeId, owned.first, owned.second);
+            displayParamString(adminOwner->mAdminOwnerName.c_str(), buf,
+                               &result, &resparams);
           }
         } else {
           LOG_NO(
@@ -13603,11 +13828,119 @@ SaAisErrorT ImmModel::resourceDisplay(
           AdminOwnerVector::iterator i;
           for (i = sOwnerVector.begin(); i != sOwnerVector.end(); ++i) {
             AdminOwnerInfo* adminOwner = (*i);
-            LOG_IN("Implementer name %s and location of the implementer is %u",
-                   adminOwner->mAdminOwnerName.c_str(), adminOwner->mNodeId);
+            const std::pair<size_t, size_t>& owned =
+                usage[adminOwner->mAdminOwnerName];
+            LOG_IN("Admin owner %s at node %x owns %zu objects using %zu bytes",
+                   adminOwner->mAdminOwnerName.c_str(), adminOwner->mNodeId,
+                   owned.first, owned.second);
           }
         }
       }
+    } else if ((strcmp(resourceName, "classes") == 0)) {
+      /* Walks every object, so the cost is only paid when asked for. */
+      auto classMemSize = [this](ClassInfo* classInfo) {
+        size_t bytes = 0;
+        ObjectSet::iterator os;
+        for (os = classInfo->mExtent.begin(); os != classInfo->mExtent.end();
+             ++os) {
+          std::string dn;
+          getObjectName(*os, dn);
+          bytes += objectMemSize(dn, *os);
+        }
+        return bytes;
+      };
+      if (sClassMap.size() < 128) {
+        ClassMap::iterator ci;
+        for (ci = sClassMap.begin(); ci != sClassMap.end(); ++ci) {
+          ClassInfo* classInfo = ci->second;
+          size_t bytes = classMemSize(classInfo);
+          char buf[64];
+          snprintf(buf, sizeof(buf), "objects:%zu bytes:%zu",
+                   classInfo->mExtent.size(), bytes);
+          displayParamString(ci->first.c_str(), buf, &result, &resparams);
+        }
+      } else {
+        LOG_NO(
+            "The Number of classes are greater than 128, displaying the class"
+            "information to syslog");
+        ClassMap::iterator ci;
+        for (ci = sClassMap.begin(); ci != sClassMap.end(); ++ci) {
+          ClassInfo* classInfo = ci->second;
+          size_t bytes = classMemSize(classInfo);
+          LOG_IN("Class %s has %zu objects using %zu bytes", ci->first.c_str(),
+                 classInfo->mExtent.size(), bytes);
+        }
+      }
+    } else if ((strcmp(resourceName, "ccbs") == 0)) {
+      /* Lifetime is until termination for terminated ccbs, which are kept
+         for a while after commit/abort, else the age of the ccb. */
+      if (sCcbVector.size() < 128) {
+        struct timespec now;
+        osaf_clock_gettime(CLOCK_MONOTONIC, &now);
+        CcbVector::iterator i;
+        for (i = sCcbVector.begin(); i != sCcbVector.end(); ++i) {
+          CcbInfo* ccb = (*i);
+          struct timespec end = now;
+          struct timespec lifetime;
+          if ((ccb->mState > IMM_CCB_CRITICAL) &&
+              osaf_timespec_compare(&ccb->mWaitStartTime, &kZeroSeconds) &&
+              (osaf_timespec_compare(&ccb->mWaitStartTime,
+                                     &ccb->mCreateTime) >= 0)) {
+            end = ccb->mWaitStartTime;
+          }
+          osaf_timespec_subtract(&end, &ccb->mCreateTime, &lifetime);
+          char name[16];
+          char buf[96];
+          snprintf(name, sizeof(name), "%u", ccb->mId);
+          snprintf(buf, sizeof(buf), "state:%s ops:%u msec:%llu node:%x",
+                   ccbStateName(ccb->mState), ccb->mOpCount,
+                   (unsigned long long)osaf_timespec_to_millis(&lifetime),
+                   ccb->mOriginatingNode);
+          displayParamString(name, buf, &result, &resparams);
+        }
+      } else {
+        LOG_NO(
+            "The Number of ccbs are greater than 128, displaying the ccb"
+            "information to syslog");
+        CcbVector::iterator i;
+        for (i = sCcbVector.begin(); i != sCcbVector.end(); ++i) {
+          LOG_IN("Ccb %u state %s ops %u", (*i)->mId,
+                 ccbStateName((*i)->mState), (*i)->mOpCount);
+        }
+      }
+    } else if ((strcmp(resourceName, "fevs") == 0)) {
+      displayParamInt64("repliesPending", info.fevsRepliesPending, &result,
+                        &resparams);
+      displayParamInt64("maxRepliesPending", IMMSV_DEFAULT_FEVS_MAX_PENDING,
+                        &result, &resparams);
+      displayParamInt64("outQueue", info.fevsOutCount, &result, &resparams);
+      displayParamInt64("highestReceived", info.highestReceived, &result,
+                        &resparams);
+      displayParamInt64("highestProcessed", info.highestProcessed, &result,
+                        &resparams);
+    } else if ((strcmp(resourceName, "latency") == 0)) {
+      /* Bucket limits as documented for IMMND_LATENCY_HIST. */
+      const char* limits[IMMND_LATENCY_BUCKETS] = {
+          "<10us", "<100us", "<1ms", "<10ms", "<100ms", "<1s", ">=1s"};
+      for (int ix = 0; ix < IMMND_EVT_MAX; ++ix) {
+        const IMMND_LATENCY_HIST* hist = &info.latency[ix];
+        if (!hist->count) {
+          continue;
+        }
+        char buf[64];
+        snprintf(buf, sizeof(buf), "count:%llu avg:%lluus max:%lluus",
+                 (unsigned long long)hist->count,
+                 (unsigned long long)(hist->totalUsec / hist->count),
+                 (unsigned long long)hist->maxUsec);
+        std::string value(buf);
+        for (int bx = 0; bx < IMMND_LATENCY_BUCKETS; ++bx) {
+          snprintf(buf, sizeof(buf), " %s:%llu", limits[bx],
+                   (unsigned long long)hist->buckets[bx]);
+          value.append(buf);
+        }
+        displayParamString(immsv_get_immnd_evt_name(ix), value, &result,
+                           &resparams);
+      }
     } else {
       LOG_WA("Verbose display of reourcename %s is unsupported", resourceName);
       err = SA_AIS_ERR_INVALID_PARAM;
@@ -13617,7 +13950,8 @@ SaAisErrorT ImmModel::resourceDisplay(
     }
   } else if ((strcmp(opName, "display-help") == 0)) {
     const char* resources[] = {"implementers", "adminowners", "ccbs",
-                               "searches", NULL};
+                               "searches",     "classes",     "objects",
+                               "fevs",         "latency",     NULL};
     int i = 0;
 
     struct ImmsvAdminOperationParam* result = NULL;
@@ -16323,6 +16657,7 @@ SaAisErrorT ImmModel::rtObjectCreate(
     void* pbe2B = NULL;
     object = new ObjectInfo();
     object->mClassInfo = classInfo;
+    object->mAttrValueMap.bind(classInfo->mAttrLayout);
     object->mImplementer = info;
     if (parent) {
       object->mParent = parent;
@@ -17366,6 +17701,35 @@ void ImmModel::deferRtUpdate(ImmsvOmCcbObjectModify* req, SaUint64T msgNo) {
   attrUpdList->push_back(dRtAU);
 }
 
+/**
+ * Check if an rt update includes any PERSISTENT runtime attribute.
+ * Used to keep PRTA updates, which need a PBE continuation each, out of
+ * batched rt updates.
+ */
+bool ImmModel::rtObjectUpdateIsPersistent(const ImmsvOmCcbObjectModify* req) {
+  size_t sz = strnlen((char*)req->objectName.buf, (size_t)req->objectName.size);
+  std::string objectName((const char*)req->objectName.buf, sz);
+
+  ObjectMap::iterator oi = sObjectMap.find(objectName);
+  if (oi == sObjectMap.end()) {
+    return false;
+  }
+
+  ClassInfo* classInfo = oi->second->mClassInfo;
+  for (immsv_attr_mods_list* p = req->attrMods; p; p = p->next) {
+    sz = strnlen((char*)p->attrValue.attrName.buf,
+                 (size_t)p->attrValue.attrName.size);
+    std::string attrName((const char*)p->attrValue.attrName.buf, sz);
+    AttrMap::iterator i4 = classInfo->mAttrMap.find(attrName);
+    if ((i4 != classInfo->mAttrMap.end()) &&
+        (i4->second->mFlags & SA_IMM_ATTR_PERSISTENT)) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
 /**
  * Update a runtime attributes in an object (runtime or config)
  */
@@ -17568,6 +17932,7 @@ SaAisErrorT ImmModel::rtObjectUpdate(
       */
       afim = new ObjectInfo();
       afim->mClassInfo = object->mClassInfo;
+      afim->mAttrValueMap.bind(afim->mClassInfo->mAttrLayout);
       afim->mImplementer = object->mImplementer;
       afim->mObjFlags = object->mObjFlags;
       afim->mParent = object->mParent;
@@ -18477,6 +18842,7 @@ SaAisErrorT ImmModel::deleteRtObject(ObjectMap::iterator& oi, bool doIt,
       // Here we are erasing based on value, not iterator position.
     }
 
+    accessorCacheInvalidate(oi->first);
     delete object;
     sObjectMap.erase(oi);
   }
@@ -18625,6 +18991,7 @@ SaAisErrorT ImmModel::objectSync(const ImmsvOmObjectSync* req) {
     MissingParentsMap::iterator mpm;
     ObjectInfo* object = new ObjectInfo();
     object->mClassInfo = classInfo;
+    object->mAttrValueMap.bind(classInfo->mAttrLayout);
     if (nameCorrected) {
       object->mObjFlags = IMM_DN_INTERNAL_REP;
     }
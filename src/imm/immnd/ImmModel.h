@@ -91,6 +91,18 @@ typedef std::set<std::string> ObjectNameSet;
 
 struct ImmOiImplementerClear;
 
+struct immnd_latency_hist;
+
+/* IMMND state kept outside of the model, shown by resourceDisplay. */
+struct ImmndDisplayInfo {
+  SaUint64T searchCount;
+  SaUint32T fevsRepliesPending;
+  SaUint32T fevsOutCount;
+  SaUint64T highestReceived;
+  SaUint64T highestProcessed;
+  const struct immnd_latency_hist* latency;  // IMMND_EVT_MAX entries
+};
+
 class ImmModel {
  public:
   ImmModel();
@@ -112,6 +124,7 @@ class ImmModel {
   bool protocol47Allowed();
   bool protocol50Allowed();
   bool protocol51Allowed();
+  bool protocol52Allowed();
   bool oneSafe2PBEAllowed();
   bool purgeSyncRequest(SaUint32T clientId);
   bool verifySchemaChange(const std::string& className, ClassInfo* oldClass,
@@ -332,6 +345,8 @@ class ImmModel {
 
   void deferRtUpdate(ImmsvOmCcbObjectModify* req, SaUint64T msgNo);
 
+  bool rtObjectUpdateIsPersistent(const ImmsvOmCcbObjectModify* req);
+
   SaAisErrorT rtObjectDelete(
       const ImmsvOmCcbObjectDelete* req,  // re-used struct
       SaUint32T conn, unsigned int nodeId, SaUint32T* continuationId,
@@ -345,7 +360,7 @@ class ImmModel {
 
   SaAisErrorT resourceDisplay(const struct ImmsvAdminOperationParam* reqparams,
                               struct ImmsvAdminOperationParam** rparams,
-                              SaUint64T searchcount);
+                              const ImmndDisplayInfo& info);
 
   void setScAbsenceAllowed(SaUint32T scAbsenceAllowed);
 
@@ -403,6 +418,10 @@ class ImmModel {
   void discardImplementer(unsigned int implHandle, bool reallyDiscard,
                           IdVector& gv, bool isAtCoord);
   void discardContinuations(SaUint32T dead);
+  void accessorCacheWatch(const std::string& objectName, SaImmHandleT client);
+  void accessorCacheUnwatch(SaUint32T dead);
+  bool popAccessorCacheInvalidation(SaImmHandleT* client,
+                                    std::string& objectName);
   void discardNode(unsigned int nodeId, IdVector& cv, IdVector& gv,
                    bool isAtCoord, bool scAbsence);
   void getCcbIdsForOrigCon(SaUint32T dead, IdVector& cv);
@@ -495,6 +514,7 @@ class ImmModel {
   void commitCreate(ObjectInfo* afim);
   bool commitModify(const std::string& dn, ObjectInfo* afim);
   void commitDelete(const std::string& dn);
+  void accessorCacheInvalidate(const std::string& dn);
 
   int loaderPid;  //(-1) => loading not started or loading partiticpant.
                   // >0  => loading in progress here at coordinator.
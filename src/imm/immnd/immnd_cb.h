@@ -73,6 +73,9 @@ typedef struct immnd_immom_client_node {
                               The tmp client is then removed, anticipating
                               a resurrect request by the IMMA.
                            */
+  SaAisErrorT mRtBatchErr;     /* Error at the first hop for a rt update
+                                  batch, replied with the fevs outcome. */
+  char *mRtBatchErrObject;     /* Object of mRtBatchErr, if any. */
   struct timespec mLastSearch; /* Time of the latest used search handle
                                                                   It is used to
                                   reduce number of iterations of inactive search
@@ -92,6 +95,21 @@ typedef struct immnd_fevs_msg_node {
   struct immnd_fevs_msg_node *next;
 } IMMND_FEVS_MSG_NODE;
 
+/******************************************************************************
+ Latency of the processing of one IMMND message type, see immnd_process_evt.
+ Bucket ix counts messages processed in less than 10^(ix+1) usec, the last
+ bucket counts the rest. Only counters are updated per message, the
+ histograms are rendered by the 'latency' resource display admin-op.
+*****************************************************************************/
+#define IMMND_LATENCY_BUCKETS 7
+
+typedef struct immnd_latency_hist {
+  SaUint64T count;
+  SaUint64T totalUsec;
+  SaUint64T maxUsec;
+  SaUint64T buckets[IMMND_LATENCY_BUCKETS];
+} IMMND_LATENCY_HIST;
+
 /*****************************************************************************
  * Data Structure used to hold IMMND control block
  *****************************************************************************/
@@ -201,6 +219,7 @@ typedef struct immnd_cb_tag {
       clm_init_sel_obj; /* Selection object wait for  clms intialization*/
   bool isClmNodeJoined; /* True => If clm joined the cluster*/
   NCS_PATRICIA_TREE immnd_clm_list; /* IMMND_IMM_CLIENT_NODE - node */
+  IMMND_LATENCY_HIST latency[IMMND_EVT_MAX]; /* Indexed by IMMND_EVT_TYPE */
 } IMMND_CB;
 
 /* CB prototypes */
@@ -112,6 +112,8 @@ uint32_t immnd_client_node_del(IMMND_CB *cb,
 	uint32_t rc = ncs_patricia_tree_del(
 	    &cb->client_info_db,
 	    (NCS_PATRICIA_NODE *)&imm_client_node->patnode);
+	free(imm_client_node->mRtBatchErrObject);
+	imm_client_node->mRtBatchErrObject = NULL;
 	return rc;
 }
 
@@ -67,6 +67,9 @@ static uint32_t immnd_evt_proc_ccb_init(IMMND_CB *cb, IMMND_EVT *evt,
 static uint32_t immnd_evt_proc_rt_update(IMMND_CB *cb, IMMND_EVT *evt,
 					 IMMSV_SEND_INFO *sinfo);
 
+static uint32_t immnd_evt_proc_rt_update_batch(IMMND_CB *cb, IMMND_EVT *evt,
+					       IMMSV_SEND_INFO *sinfo);
+
 static void immnd_evt_proc_discard_impl(IMMND_CB *cb, IMMND_EVT *evt,
 					bool originatedAtThisNd,
 					SaImmHandleT clnt_hdl,
@@ -188,7 +191,15 @@ static void immnd_evt_proc_rt_object_modify(IMMND_CB *cb, IMMND_EVT *evt,
 					    bool originatedAtThisNd,
 					    SaImmHandleT clnt_hdl,
 					    MDS_DEST reply_dest,
-					    SaUint64T msgNo);
+					    SaUint64T msgNo,
+					    SaAisErrorT *batchErr);
+
+static void immnd_evt_proc_rt_object_modify_batch(IMMND_CB *cb,
+						  IMMND_EVT *evt,
+						  bool originatedAtThisNd,
+						  SaImmHandleT clnt_hdl,
+						  MDS_DEST reply_dest,
+						  SaUint64T msgNo);
 
 static void immnd_evt_proc_object_delete(IMMND_CB *cb, IMMND_EVT *evt,
 					 bool originatedAtThisNd,
@@ -484,6 +495,10 @@ uint32_t immnd_evt_destroy(IMMSV_EVT *evt, bool onheap, uint32_t line)
 
 		immsv_free_attrmods(evt->info.immnd.info.objModify.attrMods);
 		evt->info.immnd.info.objModify.attrMods = NULL;
+	} else if (evt->info.immnd.type ==
+		   IMMND_EVT_A2ND_OI_OBJ_MODIFY_BATCH) {
+		immsv_free_rt_modify_batch(
+		    &(evt->info.immnd.info.rtModifyBatch));
 	} else if ((evt->info.immnd.type == IMMND_EVT_A2ND_OBJ_DELETE) ||
 		   (evt->info.immnd.type == IMMND_EVT_A2ND_OI_OBJ_DELETE)) {
 		free(evt->info.immnd.info.objDelete.objectName.buf);
@@ -570,10 +585,71 @@ uint32_t immnd_evt_destroy(IMMSV_EVT *evt, bool onheap, uint32_t line)
 	return rc;
 }
 
+/****************************************************************************
+ * Name          : immnd_latency_add
+ *
+ * Description   : Adds one message processed in 'usec' microseconds to a
+ *                 latency histogram.
+ *
+ * Arguments     : hist - histogram of the IMMND message type
+ *                 usec - processing time of the message
+ *
+ * Notes         : Bucket ix takes the times below 10^(ix+1) usec, the last
+ *                 bucket takes the rest.
+ *****************************************************************************/
+void immnd_latency_add(IMMND_LATENCY_HIST *hist, SaUint64T usec)
+{
+	SaUint64T limit = 10;
+	int ix = 0;
+
+	while ((ix < (IMMND_LATENCY_BUCKETS - 1)) && (usec >= limit)) {
+		limit *= 10;
+		++ix;
+	}
+
+	hist->buckets[ix]++;
+	hist->count++;
+	hist->totalUsec += usec;
+	if (usec > hist->maxUsec) {
+		hist->maxUsec = usec;
+	}
+}
+
+/****************************************************************************
+ * Name          : immnd_latency_record
+ *
+ * Description   : Adds the time elapsed since 'start' to the latency
+ *                 histogram of the IMMND message type 'type'.
+ *
+ * Arguments     : cb    - IMMND CB pointer
+ *                 type  - IMMND_EVT_TYPE of the processed message
+ *                 start - CLOCK_MONOTONIC time when processing started
+ *
+ * Notes         : For fevs messages, IMMND_EVT_D2ND_GLOB_FEVS_REQ(_2)
+ *                 includes the time of the dispatched message, which is
+ *                 also recorded under its own type.
+ *****************************************************************************/
+void immnd_latency_record(IMMND_CB *cb, unsigned int type,
+			  const struct timespec *start)
+{
+	struct timespec now;
+	struct timespec elapsed;
+
+	if (type >= IMMND_EVT_MAX) {
+		return;
+	}
+
+	osaf_clock_gettime(CLOCK_MONOTONIC, &now);
+	osaf_timespec_subtract(&now, start, &elapsed);
+	immnd_latency_add(&cb->latency[type],
+			  osaf_timespec_to_micros(&elapsed));
+}
+
 void immnd_process_evt(void)
 {
 	IMMND_CB *cb = immnd_cb;
 	uint32_t rc = NCSCC_RC_SUCCESS;
+	struct timespec start;
 
 	IMMSV_EVT *evt;
 
@@ -595,6 +671,8 @@ void immnd_process_evt(void)
 	    (evt->info.immnd.type != IMMND_EVT_D2ND_GLOB_FEVS_REQ_2))
 		immsv_msg_trace_rec(evt->sinfo.dest, evt);
 
+	osaf_clock_gettime(CLOCK_MONOTONIC, &start);
+
 	switch (evt->info.immnd.type) {
 	case IMMND_EVT_MDS_INFO:
 		rc = immnd_evt_proc_mds_evt(cb, &evt->info.immnd);
@@ -683,6 +761,11 @@ void immnd_process_evt(void)
 		    immnd_evt_proc_rt_update(cb, &evt->info.immnd, &evt->sinfo);
 		break;
 
+	case IMMND_EVT_A2ND_OI_OBJ_MODIFY_BATCH:
+		rc = immnd_evt_proc_rt_update_batch(cb, &evt->info.immnd,
+						    &evt->sinfo);
+		break;
+
 	case IMMND_EVT_A2ND_IMM_FEVS:
 	case IMMND_EVT_A2ND_IMM_FEVS_2:
 		rc = immnd_evt_proc_fevs_forward(cb, &evt->info.immnd,
@@ -814,6 +897,8 @@ void immnd_process_evt(void)
 		       rc, evt->info.immnd.type);
 	}
 
+	immnd_latency_record(cb, evt->info.immnd.type, &start);
+
 	/* Free the Event */
 	immnd_evt_destroy(evt, true, __LINE__);
 
@@ -2234,6 +2319,12 @@ static uint32_t immnd_evt_proc_accessor_get(IMMND_CB *cb, IMMND_EVT *evt,
 		goto search_init_err;
 	}
 
+	if (evt->info.searchInit.searchOptions &
+	    SA_IMM_SEARCH_ACCESSOR_CACHE_WATCH) {
+		immModel_accessorCacheWatch(cb, &(evt->info.searchInit.rootName),
+					    evt->info.searchInit.client_hdl);
+	}
+
 	/*Generate search-id */
 	sn = calloc(1, sizeof(IMMND_OM_SEARCH_NODE));
 	if (sn == NULL) {
@@ -3239,6 +3330,248 @@ done:
 	return rc;
 }
 
+/****************************************************************************
+ * Name          : immnd_evt_proc_rt_update_batch
+ *
+ * Description   : Function to process a batch of saImmOiRtObjectUpdate
+ *                 requests from an OI in one message. First hop, as for
+ *                 immnd_evt_proc_rt_update. Pure local attributes are
+ *                 updated here. All objects with cached attributes are
+ *                 then sent in ONE fevs message and the reply to the agent
+ *                 is sent when that message arrives back at this node.
+ *
+ * Arguments     : IMMND_CB *cb - IMMND CB pointer
+ *                 IMMND_EVT *evt - Received Event structure
+ *                 IMMSV_SEND_INFO *sinfo - sender info
+ *
+ * Return Values : NCSCC_RC_SUCCESS/Error.
+ *
+ * Notes         : Processing stops at the first object failing here. The
+ *                 error and the object are kept in the client node and
+ *                 returned with the reply for the objects already sent over
+ *                 fevs. A reply with an error for one object names it in
+ *                 errStrings (IMMA_EVT_ND2A_IMM_ERROR_2).
+ *****************************************************************************/
+static uint32_t immnd_evt_proc_rt_update_batch(IMMND_CB *cb, IMMND_EVT *evt,
+					       IMMSV_SEND_INFO *sinfo)
+{
+	IMMSV_EVT send_evt;
+	IMMSV_EVT fevs_evt;
+	uint32_t rc = NCSCC_RC_SUCCESS;
+	SaAisErrorT err = SA_AIS_OK;
+	IMMND_IMM_CLIENT_NODE *cl_node = NULL;
+	SaImmHandleT client_hdl;
+	SaUint32T clientId;
+	SaUint32T clientNode;
+	SaUint32T dummyPbeConn = 0;
+	SaUint32T dummyPbe2BConn = 0;
+	NCS_NODE_ID *dummyPbeNodeIdPtr = NULL;
+	SaUint32T dummyContinuationId = 0;
+	SaUint32T spApplConn = 0;
+	IMMSV_OI_RT_MODIFY_LIST *rtMod = &(evt->info.rtModifyBatch);
+	IMMSV_OI_RT_MODIFY_LIST *fwdList = NULL;
+	IMMSV_OI_RT_MODIFY_LIST **fwdTail = &fwdList;
+	IMMSV_OCTET_STRING *errObject = NULL; /* Object that failed */
+	IMMSV_ATTR_NAME_LIST errStr;
+	bool pbeExpected =
+	    cb->mPbeFile && (cb->mRim == SA_IMM_KEEP_REPOSITORY);
+	unsigned int objects = 0;
+	NCS_UBAID uba;
+	char *tmpData = NULL;
+	char *data = NULL;
+	int32_t size = 0;
+	uba.start = NULL;
+	TRACE_ENTER();
+
+	client_hdl = rtMod->objModify.immHandle;
+	immnd_client_node_get(cb, client_hdl, &cl_node);
+	if (cl_node == NULL || cl_node->mIsStale) {
+		LOG_WA("ERR_BAD_HANDLE: Client %llu not found in server",
+		       client_hdl);
+		err = SA_AIS_ERR_BAD_HANDLE;
+		goto agent_rsp;
+	}
+
+	if (!immModel_protocol52Allowed(cb)) {
+		/* Other IMMNDs may not understand the batch over fevs.
+		   The agent falls back to one update per object. */
+		TRACE_2("ERR_NOT_SUPPORTED: rt update batch not allowed yet");
+		err = SA_AIS_ERR_NOT_SUPPORTED;
+		goto agent_rsp;
+	}
+
+	if (!immnd_is_immd_up(cb)) {
+		err = SA_AIS_ERR_TRY_AGAIN;
+		goto agent_rsp;
+	}
+
+	err = immnd_mds_client_not_busy(&(cl_node->tmpSinfo));
+	if (err != SA_AIS_OK) {
+		if (err == SA_AIS_ERR_BAD_HANDLE) {
+			/* See immnd_evt_proc_rt_update */
+			immnd_proc_imma_discard_connection(cb, cl_node, false);
+			rc = immnd_client_node_del(cb, cl_node);
+			osafassert(rc == NCSCC_RC_SUCCESS);
+			free(cl_node);
+		}
+		goto agent_rsp;
+	}
+
+	/* Flow control is checked BEFORE any object is updated, so that a
+	   batch is never rejected after some pure local attributes have
+	   been assigned. */
+	if (cb->fevs_replies_pending >= IMMSV_DEFAULT_FEVS_MAX_PENDING) {
+		TRACE_2(
+		    "ERR_TRY_AGAIN: Too many pending incoming fevs messages (> %u) rejecting rt_update batch",
+		    IMMSV_DEFAULT_FEVS_MAX_PENDING);
+		err = SA_AIS_ERR_TRY_AGAIN;
+		goto agent_rsp;
+	}
+
+	clientId = m_IMMSV_UNPACK_HANDLE_HIGH(client_hdl);
+	clientNode = m_IMMSV_UNPACK_HANDLE_LOW(client_hdl);
+
+	for (; rtMod; rtMod = rtMod->next) {
+		unsigned int isPureLocal = 1;
+		++objects;
+
+		if (rtMod->objModify.immHandle != client_hdl) {
+			LOG_WA(
+			    "ERR_LIBRARY: Mixed handles in rt update batch");
+			err = SA_AIS_ERR_LIBRARY;
+			break;
+		}
+
+		if (pbeExpected && immModel_rtObjectUpdateIsPersistent(
+				       cb, &(rtMod->objModify))) {
+			/* Each PRTA update needs its own PBE continuation. */
+			LOG_NO(
+			    "ERR_INVALID_PARAM: Persistent runtime attributes can "
+			    "not be updated in a batch when PBE is enabled");
+			err = SA_AIS_ERR_INVALID_PARAM;
+			errObject = &(rtMod->objModify.objectName);
+			break;
+		}
+
+		err = immModel_rtObjectUpdate(
+		    cb, &(rtMod->objModify), clientId, clientNode, &isPureLocal,
+		    &dummyContinuationId, &dummyPbeConn, dummyPbeNodeIdPtr,
+		    &spApplConn, &dummyPbe2BConn);
+
+		osafassert(!dummyContinuationId && !dummyPbeConn &&
+			   !spApplConn && !dummyPbe2BConn);
+
+		if (err != SA_AIS_OK) {
+			TRACE_2("Rt update batch stopped at object %u err:%u",
+				objects, err);
+			errObject = &(rtMod->objModify.objectName);
+			break;
+		}
+
+		if (!isPureLocal) {
+			/* Borrow the object, the batch keeps ownership. */
+			*fwdTail = calloc(1, sizeof(IMMSV_OI_RT_MODIFY_LIST));
+			(*fwdTail)->objModify = rtMod->objModify;
+			fwdTail = &((*fwdTail)->next);
+		}
+	}
+
+	if (!fwdList) {
+		TRACE_2("Rt update batch was pure local");
+		goto agent_rsp;
+	}
+
+	/* Pack the batch of cached updates as ONE fevs message. */
+	memset(&fevs_evt, 0, sizeof(IMMSV_EVT));
+	fevs_evt.type = IMMSV_EVT_TYPE_IMMND;
+	fevs_evt.info.immnd.type = IMMND_EVT_A2ND_OI_OBJ_MODIFY_BATCH;
+	fevs_evt.info.immnd.info.rtModifyBatch = *fwdList;
+
+	if (ncs_enc_init_space(&uba) != NCSCC_RC_SUCCESS) {
+		LOG_WA("Failed init ubaid");
+		err = SA_AIS_ERR_TRY_AGAIN;
+		errObject = NULL;
+		goto agent_rsp;
+	}
+
+	if (immsv_evt_enc(&fevs_evt, &uba) != NCSCC_RC_SUCCESS) {
+		LOG_WA("Failed encode of rt update batch");
+		err = SA_AIS_ERR_LIBRARY;
+		errObject = NULL;
+		goto agent_rsp;
+	}
+
+	size = uba.ttl;
+	tmpData = malloc(size);
+	osafassert(tmpData);
+	data = m_MMGR_DATA_AT_START(uba.start, size, tmpData);
+
+	memset(&send_evt, '\0', sizeof(IMMSV_EVT));
+	send_evt.type = IMMSV_EVT_TYPE_IMMD;
+	send_evt.info.immd.type = IMMD_EVT_ND2D_FEVS_REQ;
+	send_evt.info.immd.info.fevsReq.reply_dest = cb->immnd_mdest_id;
+	send_evt.info.immd.info.fevsReq.client_hdl = client_hdl;
+	send_evt.info.immd.info.fevsReq.msg.size = size;
+	send_evt.info.immd.info.fevsReq.msg.buf = data;
+
+	cb->fevs_replies_pending++; /*flow control */
+	if (cb->fevs_replies_pending > 1) {
+		TRACE("Messages pending:%u", cb->fevs_replies_pending);
+	}
+
+	if (immnd_mds_msg_send(cb, NCSMDS_SVC_ID_IMMD, cb->immd_mdest_id,
+			       &send_evt) != NCSCC_RC_SUCCESS) {
+		LOG_ER("Problem in sending to IMMD over MDS");
+		cb->fevs_replies_pending--;
+		/* Pure local attributes of the objects in the batch may
+		   already have been updated. Same as for a failed send in
+		   immnd_evt_proc_rt_update. */
+		err = SA_AIS_ERR_TRY_AGAIN;
+		errObject = NULL;
+		goto agent_rsp;
+	}
+
+	TRACE_2("Rt update batch: %u objects, %u bytes sent over fevs",
+		objects, size);
+
+	/* Reply comes back over fevs, see
+	   immnd_evt_proc_rt_object_modify_batch. */
+	cl_node->tmpSinfo = *sinfo;
+	cl_node->mRtBatchErr = err;
+	free(cl_node->mRtBatchErrObject);
+	cl_node->mRtBatchErrObject = errObject ? strdup(errObject->buf) : NULL;
+	goto done;
+
+agent_rsp:
+	memset(&send_evt, '\0', sizeof(IMMSV_EVT));
+	TRACE_2("send immediate reply to client/agent");
+	send_evt.type = IMMSV_EVT_TYPE_IMMA;
+	send_evt.info.imma.info.errRsp.error = err;
+	send_evt.info.imma.type = IMMA_EVT_ND2A_IMM_ERROR;
+	if (errObject) {
+		memset(&errStr, '\0', sizeof(errStr));
+		errStr.name = *errObject; /*borrow*/
+		send_evt.info.imma.info.errRsp.errStrings = &errStr;
+		send_evt.info.imma.type = IMMA_EVT_ND2A_IMM_ERROR_2;
+	}
+	TRACE_2("SENDRSP RESULT %u ", err);
+	rc = immnd_mds_send_rsp(cb, sinfo, &send_evt);
+
+done:
+	while (fwdList) {
+		IMMSV_OI_RT_MODIFY_LIST *tmp = fwdList;
+		fwdList = fwdList->next;
+		free(tmp); /* Only the borrowing shells. */
+	}
+	free(tmpData);
+	if (uba.start) {
+		m_MMGR_FREE_BUFR_LIST(uba.start);
+	}
+	immsv_free_rt_modify_batch(&(evt->info.rtModifyBatch));
+	TRACE_LEAVE();
+	return rc;
+}
+
 #if 0 /*Only for debug */
 static void dump_usrbuf(USRBUF *ub)
 {
@@ -4038,6 +4371,13 @@ static SaAisErrorT immnd_fevs_local_checks(IMMND_CB *cb, IMMSV_FEVS *fevsReq,
 		error = SA_AIS_ERR_LIBRARY;
 		break;
 
+	case IMMND_EVT_A2ND_OI_OBJ_MODIFY_BATCH:
+		/* Packed for fevs by the IMMND, never by the imma client. */
+		LOG_WA(
+		    "ERR_LIBRARY: IMMND_EVT_A2ND_OI_OBJ_MODIFY_BATCH can not arrive from client as fevs");
+		error = SA_AIS_ERR_LIBRARY;
+		break;
+
 	case IMMND_EVT_A2ND_OI_OBJ_DELETE:
 		if (fevsReq->sender_count != 0x1) {
 			LOG_WA(
@@ -7716,6 +8056,10 @@ done:
  *                 IMM_DEST reply_dest - The dest of the ND to where reply
  *                                         is to be sent (only relevant if
  *                                       originatedAtThisNode is false).
+ *                 SaAisErrorT *batchErr - NULL for a single update. For an
+ *                                         object in a batch, no reply is
+ *                                         sent and the first error is
+ *                                         stored here instead.
  * Return Values : None
  *
  *****************************************************************************/
@@ -7723,7 +8067,8 @@ static void immnd_evt_proc_rt_object_modify(IMMND_CB *cb, IMMND_EVT *evt,
 					    bool originatedAtThisNd,
 					    SaImmHandleT clnt_hdl,
 					    MDS_DEST reply_dest,
-					    SaUint64T msgNo)
+					    SaUint64T msgNo,
+					    SaAisErrorT *batchErr)
 {
 	SaAisErrorT err = SA_AIS_OK;
 	IMMSV_EVT send_evt;
@@ -7768,7 +8113,15 @@ static void immnd_evt_proc_rt_object_modify(IMMND_CB *cb, IMMND_EVT *evt,
 
 	unsigned int isLocal = 0;
 
-	if (originatedAtThisNd) {
+	if (batchErr && pbeNodeIdPtr &&
+	    immModel_rtObjectUpdateIsPersistent(cb, &(evt->info.objModify))) {
+		/* Rejected at the first hop. Only reached if the class was
+		   changed while the batch was in transit. */
+		LOG_NO(
+		    "ERR_INVALID_PARAM: Persistent runtime attributes can not "
+		    "be updated in a batch when PBE is enabled");
+		err = SA_AIS_ERR_INVALID_PARAM;
+	} else if (originatedAtThisNd) {
 		err = immModel_rtObjectUpdate(
 		    cb, &(evt->info.objModify), reqConn, nodeId, &isLocal,
 		    &continuationId, &pbeConn, pbeNodeIdPtr, &spApplConn,
@@ -8026,7 +8379,12 @@ static void immnd_evt_proc_rt_object_modify(IMMND_CB *cb, IMMND_EVT *evt,
 		}
 	}
 
-	if (originatedAtThisNd && !delayedReply) {
+	if (batchErr) {
+		osafassert(!delayedReply);
+		if (*batchErr == SA_AIS_OK) {
+			*batchErr = err;
+		}
+	} else if (originatedAtThisNd && !delayedReply) {
 		immnd_client_node_get(cb, clnt_hdl, &cl_node);
 		if (cl_node == NULL || cl_node->mIsStale) {
 			LOG_WA("IMMND - Client went down so no response");
@@ -8055,6 +8413,101 @@ done:
 	TRACE_LEAVE();
 }
 
+/****************************************************************************
+ * Name          : immnd_evt_proc_rt_object_modify_batch
+ *
+ * Description   : Function to process a batch of rt object updates with
+ *                 cached attributes. Arrives over FEVS, packed by the
+ *                 IMMND where the batch originated. Each object is
+ *                 processed as by immnd_evt_proc_rt_object_modify. One
+ *                 reply is sent to the client, with the first error.
+ *
+ * Arguments     : See immnd_evt_proc_rt_object_modify.
+ * Return Values : None
+ *
+ *****************************************************************************/
+static void immnd_evt_proc_rt_object_modify_batch(IMMND_CB *cb,
+						  IMMND_EVT *evt,
+						  bool originatedAtThisNd,
+						  SaImmHandleT clnt_hdl,
+						  MDS_DEST reply_dest,
+						  SaUint64T msgNo)
+{
+	SaAisErrorT err = SA_AIS_OK;
+	IMMSV_EVT send_evt;
+	IMMND_EVT objEvt;
+	IMMND_IMM_CLIENT_NODE *cl_node = NULL;
+	IMMSV_OI_RT_MODIFY_LIST *rtMod = &(evt->info.rtModifyBatch);
+	char *errObject = NULL; /* First object that failed */
+	IMMSV_ATTR_NAME_LIST errStr;
+	TRACE_ENTER();
+
+	for (; rtMod; rtMod = rtMod->next) {
+		char *objectName = NULL;
+		memset(&objEvt, '\0', sizeof(IMMND_EVT));
+		objEvt.type = IMMND_EVT_A2ND_OI_OBJ_MODIFY;
+		objEvt.info.objModify = rtMod->objModify;
+		/* The reply names the first object that fails */
+		if (originatedAtThisNd && err == SA_AIS_OK) {
+			objectName = strdup(rtMod->objModify.objectName.buf);
+		}
+		/* Steal the object, freed by immnd_evt_proc_rt_object_modify */
+		rtMod->objModify.objectName.buf = NULL;
+		rtMod->objModify.objectName.size = 0;
+		rtMod->objModify.attrMods = NULL;
+
+		immnd_evt_proc_rt_object_modify(cb, &objEvt, originatedAtThisNd,
+						clnt_hdl, reply_dest, msgNo,
+						&err);
+		if (objectName && err != SA_AIS_OK) {
+			errObject = objectName;
+		} else {
+			free(objectName);
+		}
+	}
+
+	if (originatedAtThisNd) {
+		immnd_client_node_get(cb, clnt_hdl, &cl_node);
+		if (cl_node == NULL || cl_node->mIsStale) {
+			LOG_WA("IMMND - Client went down so no response");
+			goto done;
+		}
+
+		if (err == SA_AIS_OK) {
+			/* Error for an object that never left the first hop. */
+			err = cl_node->mRtBatchErr;
+			errObject = cl_node->mRtBatchErrObject;
+			cl_node->mRtBatchErrObject = NULL;
+		}
+		cl_node->mRtBatchErr = SA_AIS_OK;
+		free(cl_node->mRtBatchErrObject);
+		cl_node->mRtBatchErrObject = NULL;
+
+		TRACE_2("send reply to client/agent");
+		memset(&send_evt, '\0', sizeof(IMMSV_EVT));
+		send_evt.type = IMMSV_EVT_TYPE_IMMA;
+		send_evt.info.imma.info.errRsp.error = err;
+		send_evt.info.imma.type = IMMA_EVT_ND2A_IMM_ERROR;
+		if (err != SA_AIS_OK && errObject) {
+			memset(&errStr, '\0', sizeof(errStr));
+			errStr.name.buf = errObject; /*borrow*/
+			errStr.name.size = strlen(errObject) + 1;
+			send_evt.info.imma.info.errRsp.errStrings = &errStr;
+			send_evt.info.imma.type = IMMA_EVT_ND2A_IMM_ERROR_2;
+		}
+
+		if (immnd_mds_send_rsp(cb, &(cl_node->tmpSinfo), &send_evt) !=
+		    NCSCC_RC_SUCCESS) {
+			LOG_WA("Failed to send result to OI client over MDS");
+		}
+	}
+
+done:
+	free(errObject);
+	immsv_free_rt_modify_batch(&(evt->info.rtModifyBatch));
+	TRACE_LEAVE();
+}
+
 static void immnd_evt_ccb_abort(IMMND_CB *cb, SaUint32T ccbId,
 				SaUint32T **clientArr, SaUint32T *clArrsize,
 				SaUint32T *nodeId)
@@ -9611,6 +10064,7 @@ static uint32_t immnd_restricted_ok(IMMND_CB *cb, uint32_t id)
 		    id == IMMND_EVT_A2ND_OI_IMPL_CLR ||
 		    id == IMMND_EVT_D2ND_SYNC_FEVS_BASE ||
 		    id == IMMND_EVT_A2ND_OI_OBJ_MODIFY ||
+		    id == IMMND_EVT_A2ND_OI_OBJ_MODIFY_BATCH ||
 		    id == IMMND_EVT_D2ND_IMPLSET_RSP ||
 		    id == IMMND_EVT_D2ND_IMPLSET_RSP_2 ||
 		    id == IMMND_EVT_D2ND_ADMO_HARD_FINALIZE) {
@@ -9652,6 +10106,7 @@ immnd_evt_proc_fevs_dispatch(IMMND_CB *cb, IMMSV_OCTET_STRING *msg,
 	SaAisErrorT error = SA_AIS_OK;
 	IMMSV_EVT frwrd_evt;
 	NCS_UBAID uba;
+	struct timespec start;
 	uba.start = NULL;
 
 	memset(&frwrd_evt, '\0', sizeof(IMMSV_EVT));
@@ -9711,6 +10166,7 @@ immnd_evt_proc_fevs_dispatch(IMMND_CB *cb, IMMSV_OCTET_STRING *msg,
 
 	/*Dispatch the unpacked FEVS message */
 	immsv_msg_trace_rec(frwrd_evt.sinfo.dest, &frwrd_evt);
+	osaf_clock_gettime(CLOCK_MONOTONIC, &start);
 
 	switch (frwrd_evt.info.immnd.type) {
 	case IMMND_EVT_A2ND_OBJ_CREATE:
@@ -9736,7 +10192,13 @@ immnd_evt_proc_fevs_dispatch(IMMND_CB *cb, IMMSV_OCTET_STRING *msg,
 	case IMMND_EVT_A2ND_OI_OBJ_MODIFY:
 		immnd_evt_proc_rt_object_modify(cb, &frwrd_evt.info.immnd,
 						originatedAtThisNd, clnt_hdl,
-						reply_dest, msgNo);
+						reply_dest, msgNo, NULL);
+		break;
+
+	case IMMND_EVT_A2ND_OI_OBJ_MODIFY_BATCH:
+		immnd_evt_proc_rt_object_modify_batch(
+		    cb, &frwrd_evt.info.immnd, originatedAtThisNd, clnt_hdl,
+		    reply_dest, msgNo);
 		break;
 
 	case IMMND_EVT_A2ND_OBJ_DELETE:
@@ -9986,6 +10448,7 @@ immnd_evt_proc_fevs_dispatch(IMMND_CB *cb, IMMSV_OCTET_STRING *msg,
 		    frwrd_evt.info.immnd.type);
 		break;
 	}
+	immnd_latency_record(cb, frwrd_evt.info.immnd.type, &start);
 
 discard_message:
 unpack_failure:
@@ -10748,6 +11211,51 @@ void dequeue_outgoing(IMMND_CB *cb)
 	TRACE_LEAVE();
 }
 
+/****************************************************************************
+ * Name          : immnd_evt_send_accessor_cache_invalidations
+ *
+ * Description   : Tells local OM clients that config attributes cached by
+ *                 their accessor cache have been changed or deleted by the
+ *                 fevs message just processed.
+ *
+ * Arguments     : IMMND_CB *cb - IMMND CB pointer
+ *
+ *****************************************************************************/
+static void immnd_evt_send_accessor_cache_invalidations(IMMND_CB *cb)
+{
+	SaImmHandleT client = 0LL;
+	IMMSV_OCTET_STRING dn = {0, NULL};
+	IMMND_IMM_CLIENT_NODE *cl_node = NULL;
+	IMMSV_EVT send_evt;
+
+	while (immModel_popAccessorCacheInvalidation(cb, &client, &dn)) {
+		immnd_client_node_get(cb, client, &cl_node);
+		if (cl_node == NULL || cl_node->mIsStale) {
+			TRACE_5("Client %llx with accessor cache is gone",
+				client);
+		} else {
+			TRACE_5("Invalidate accessor cache entry %s for %llx",
+				dn.buf, client);
+			memset(&send_evt, 0, sizeof(IMMSV_EVT));
+			send_evt.type = IMMSV_EVT_TYPE_IMMA;
+			send_evt.info.imma.type =
+			    IMMA_EVT_ND2A_ACCESSOR_CACHE_INVALIDATE;
+			send_evt.info.imma.info.objDelete.objectName = dn;
+			send_evt.info.imma.info.objDelete.immHandle = client;
+			if (immnd_mds_msg_send(cb, NCSMDS_SVC_ID_IMMA_OM,
+					       cl_node->agent_mds_dest,
+					       &send_evt) != NCSCC_RC_SUCCESS) {
+				LOG_WA(
+				    "Failed to send accessor cache invalidation to client %llx",
+				    client);
+			}
+		}
+		free(dn.buf);
+		dn.buf = NULL;
+		dn.size = 0;
+	}
+}
+
 /****************************************************************************
  * Name          : immnd_evt_proc_fevs_rcv
  *
@@ -10843,6 +11351,7 @@ static uint32_t immnd_evt_proc_fevs_rcv(IMMND_CB *cb, IMMND_EVT *evt,
 		err = immnd_evt_proc_fevs_dispatch(cb, msg, originatedAtThisNd,
 						   clnt_hdl, reply_dest, msgNo);
 	}
+	immnd_evt_send_accessor_cache_invalidations(cb);
 
 	if (err != SA_AIS_OK) {
 		if (err == SA_AIS_ERR_ACCESS) {
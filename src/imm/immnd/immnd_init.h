@@ -341,6 +341,7 @@ bool immModel_protocol45Allowed(IMMND_CB *cb);
 bool immModel_protocol46Allowed(IMMND_CB *cb);
 bool immModel_protocol47Allowed(IMMND_CB *cb);
 bool immModel_protocol50Allowed(IMMND_CB *cb);
+bool immModel_protocol52Allowed(IMMND_CB *cb);
 bool immModel_oneSafe2PBEAllowed(IMMND_CB *cb);
 OsafImmAccessControlModeT immModel_accessControlMode(IMMND_CB *cb);
 const char *immModel_authorizedGroup(IMMND_CB *cb);
@@ -409,6 +410,14 @@ void immModel_ccbObjModifyContinuation(IMMND_CB *cb, SaUint32T ccbId,
 
 void immModel_discardContinuations(IMMND_CB *cb, SaUint32T deadConn);
 
+void immModel_accessorCacheWatch(IMMND_CB *cb, const IMMSV_OCTET_STRING *dn,
+                                 SaImmHandleT client);
+
+void immModel_accessorCacheUnwatch(IMMND_CB *cb, SaUint32T deadConn);
+
+bool immModel_popAccessorCacheInvalidation(IMMND_CB *cb, SaImmHandleT *client,
+                                           IMMSV_OCTET_STRING *dn);
+
 bool immModel_immNotWritable(IMMND_CB *cb);
 
 bool immModel_pbeIsInSync(IMMND_CB *cb, bool checkCriticalCcbs);
@@ -446,6 +455,9 @@ IMMSV_ATTR_NAME_LIST *immModel_ccbGrabErrStrings(IMMND_CB *cb, SaUint32T ccbId);
 void immModel_deferRtUpdate(IMMND_CB *cb, struct ImmsvOmCcbObjectModify *req,
                             SaUint64T msgNo);
 
+bool immModel_rtObjectUpdateIsPersistent(
+    IMMND_CB *cb, const struct ImmsvOmCcbObjectModify *req);
+
 bool immModel_fetchRtUpdate(IMMND_CB *cb, struct ImmsvOmObjectSync *syncReq,
                             struct ImmsvOmCcbObjectModify *rtModReq,
                             SaUint64T syncFevsBase);
@@ -529,6 +541,9 @@ void immnd_evt_proc_admo_hard_finalize(IMMND_CB *cb, IMMND_EVT *evt,
                                        SaImmHandleT clnt_hdl,
                                        MDS_DEST reply_dest);
 void freeSearchNext(IMMSV_OM_RSP_SEARCH_NEXT *rsp, bool freeTop);
+void immnd_latency_add(IMMND_LATENCY_HIST *hist, SaUint64T usec);
+void immnd_latency_record(IMMND_CB *cb, unsigned int type,
+                          const struct timespec *start);
 
 /* End : ----  immnd_evt.c  */
 
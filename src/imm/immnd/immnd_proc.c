@@ -119,6 +119,9 @@ uint32_t immnd_proc_imma_discard_connection(IMMND_CB *cb,
 
 	immModel_discardContinuations(cb, client_id);
 
+	/* Likewise any accessor cache watches held by the connection. */
+	immModel_accessorCacheUnwatch(cb, client_id);
+
 	/* No need to broadcast the discarding of the connection (as compared
 	   with the EVS based implementation. In the new implementation we
 	   always look up the connection in the client_tree. Any late arrivals
@@ -0,0 +1,73 @@
+/*      -*- OpenSAF  -*-
+ *
+ * (C) Copyright 2017 The OpenSAF Foundation
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. This file and program are licensed
+ * under the GNU Lesser General Public License Version 2.1, February 1999.
+ * The complete license can be accessed from the following location:
+ * http://opensource.org/licenses/lgpl-license.php
+ * See the Copying file included with the OpenSAF distribution for full
+ * licensing terms.
+ *
+ */
+
+#include <cstring>
+#include <memory>
+#include "base/osaf_time.h"
+#include "gtest/gtest.h"
+extern "C" {
+#include "imm/immnd/immnd.h"
+}
+
+namespace {
+
+TEST(ImmndLatencyTest, BucketsAreDecadesOfMicroseconds) {
+  IMMND_LATENCY_HIST hist;
+  memset(&hist, 0, sizeof(hist));
+  // two times at each end of every bucket, the last one is open ended
+  const SaUint64T usec[] = {0,      9,       10,       99,     100,
+                            999,    1000,    9999,     10000,  99999,
+                            100000, 999999,  1000000,  3600000000ULL};
+  SaUint64T total = 0;
+  for (SaUint64T u : usec) {
+    immnd_latency_add(&hist, u);
+    total += u;
+  }
+
+  for (int ix = 0; ix < IMMND_LATENCY_BUCKETS; ++ix) {
+    EXPECT_EQ(2u, hist.buckets[ix]) << "bucket " << ix;
+  }
+  EXPECT_EQ(14u, hist.count);
+  EXPECT_EQ(total, hist.totalUsec);
+  EXPECT_EQ(3600000000ULL, hist.maxUsec);
+}
+
+TEST(ImmndLatencyTest, RecordsTheElapsedTimeOfAMessageType) {
+  std::unique_ptr<IMMND_CB> cb(new IMMND_CB());
+  struct timespec start;
+  osaf_clock_gettime(CLOCK_MONOTONIC, &start);
+  start.tv_sec -= 2;
+
+  immnd_latency_record(cb.get(), IMMND_EVT_A2ND_SEARCHINIT, &start);
+  const IMMND_LATENCY_HIST &hist = cb->latency[IMMND_EVT_A2ND_SEARCHINIT];
+  EXPECT_EQ(1u, hist.count);
+  EXPECT_EQ(1u, hist.buckets[IMMND_LATENCY_BUCKETS - 1]);
+  EXPECT_GE(hist.maxUsec, 2000000u);
+  EXPECT_EQ(hist.maxUsec, hist.totalUsec);
+  EXPECT_EQ(0u, cb->latency[IMMND_EVT_A2ND_IMM_INIT].count);
+}
+
+TEST(ImmndLatencyTest, IgnoresAnUnknownMessageType) {
+  std::unique_ptr<IMMND_CB> cb(new IMMND_CB());
+  struct timespec start;
+  osaf_clock_gettime(CLOCK_MONOTONIC, &start);
+
+  immnd_latency_record(cb.get(), IMMND_EVT_MAX, &start);
+  for (int type = 0; type < IMMND_EVT_MAX; ++type) {
+    EXPECT_EQ(0u, cb->latency[type].count);
+  }
+}
+
+}  // namespace
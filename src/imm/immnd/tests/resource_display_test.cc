@@ -0,0 +1,306 @@
+/*      -*- OpenSAF  -*-
+ *
+ * (C) Copyright 2017 The OpenSAF Foundation
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. This file and program are licensed
+ * under the GNU Lesser General Public License Version 2.1, February 1999.
+ * The complete license can be accessed from the following location:
+ * http://opensource.org/licenses/lgpl-license.php
+ * See the Copying file included with the OpenSAF distribution for full
+ * licensing terms.
+ *
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <string>
+#include "base/osaf_extended_name.h"
+#include "gtest/gtest.h"
+#include "imm/immnd/ImmModel.h"
+extern "C" {
+#include "imm/immnd/immnd.h"
+}
+
+// immnd_main.c is not linked
+static IMMND_CB _immnd_cb;
+IMMND_CB *immnd_cb = &_immnd_cb;
+
+namespace {
+
+const SaUint32T kNodeId = 0x2010f;
+const SaUint32T kConn = 1;
+const SaUint32T kOwnerId = 1;
+const SaUint32T kIdleOwnerId = 2;
+const SaUint32T kCcbId = 1;
+const int kObjects = 20;
+const size_t kDataSize = 1000;
+
+IMMSV_OCTET_STRING OctetString(const char *str) {
+  IMMSV_OCTET_STRING os;
+  os.size = strlen(str) + 1;
+  os.buf = const_cast<char *>(str);
+  return os;
+}
+
+// The display results by parameter name, int64 values are formatted
+typedef std::map<std::string, std::string> Display;
+
+// Loads a model of one config class with kObjects objects of kDataSize
+// bytes, created by one CCB of the admin owner "TestOwner"
+class ResourceDisplayTest : public ::testing::Test {
+ protected:
+  static void SetUpTestCase() {
+    ASSERT_EQ(NCSCC_RC_SUCCESS, immnd_client_node_tree_init(immnd_cb));
+    model_ = ImmModel::instance(&immnd_cb->immModel);
+    model_->prepareForLoading();
+
+    // no PBE, as when the IMM is loaded from file
+    SaUint32T continuationId = 0, pbeConn = 0;
+    // the OM agent adds the admin owner attribute to every class
+    IMMSV_ATTR_DEF_LIST admin_owner_def = {};
+    admin_owner_def.d.attrName = OctetString(SA_IMM_ATTR_ADMIN_OWNER_NAME);
+    admin_owner_def.d.attrValueType = SA_IMM_ATTR_SASTRINGT;
+    admin_owner_def.d.attrFlags = SA_IMM_ATTR_CONFIG;
+    IMMSV_ATTR_DEF_LIST data_def = {};
+    data_def.d.attrName = OctetString("data");
+    data_def.d.attrValueType = SA_IMM_ATTR_SASTRINGT;
+    data_def.d.attrFlags = SA_IMM_ATTR_CONFIG | SA_IMM_ATTR_WRITABLE;
+    data_def.next = &admin_owner_def;
+    IMMSV_ATTR_DEF_LIST rdn_def = {};
+    rdn_def.d.attrName = OctetString("testRdn");
+    rdn_def.d.attrValueType = SA_IMM_ATTR_SASTRINGT;
+    rdn_def.d.attrFlags = SA_IMM_ATTR_RDN | SA_IMM_ATTR_CONFIG;
+    rdn_def.next = &data_def;
+    IMMSV_OM_CLASS_DESCR class_descr = {};
+    class_descr.className = OctetString("TestClass");
+    class_descr.classCategory = SA_IMM_CLASS_CONFIG;
+    class_descr.attrDefinitions = &rdn_def;
+    ASSERT_EQ(SA_AIS_OK,
+              model_->classCreate(&class_descr, kConn, kNodeId,
+                                  &continuationId, &pbeConn, nullptr));
+
+    CreateAdminOwner(kOwnerId, "TestOwner");
+    CreateAdminOwner(kIdleOwnerId, "IdleOwner");
+    ASSERT_EQ(SA_AIS_OK,
+              model_->ccbCreate(kOwnerId, 0, kCcbId, kNodeId, kConn));
+
+    std::string data(kDataSize - 1, 'x');
+    for (int i = 0; i < kObjects; i++) {
+      char rdn[32];
+      snprintf(rdn, sizeof(rdn), "testRdn=obj%d", i);
+      IMMSV_ATTR_VALUES_LIST data_val = {};
+      data_val.n.attrName = OctetString("data");
+      data_val.n.attrValueType = SA_IMM_ATTR_SASTRINGT;
+      data_val.n.attrValuesNumber = 1;
+      data_val.n.attrValue.val.x = OctetString(data.c_str());
+      IMMSV_ATTR_VALUES_LIST rdn_val = {};
+      rdn_val.n.attrName = OctetString("testRdn");
+      rdn_val.n.attrValueType = SA_IMM_ATTR_SASTRINGT;
+      rdn_val.n.attrValuesNumber = 1;
+      rdn_val.n.attrValue.val.x = OctetString(rdn);
+      rdn_val.next = &data_val;
+      IMMSV_OM_CCB_OBJECT_CREATE req = {};
+      req.ccbId = kCcbId;
+      req.adminOwnerId = kOwnerId;
+      req.className = OctetString("TestClass");
+      req.attrValues = &rdn_val;
+
+      SaUint32T implConn = 0;
+      unsigned int implNodeId = 0;
+      std::string objectName;
+      bool dnOrRdnIsLong = false;
+      ASSERT_EQ(SA_AIS_OK,
+                model_->ccbObjectCreate(&req, &implConn, &implNodeId,
+                                        &continuationId, &pbeConn, nullptr,
+                                        objectName, &dnOrRdnIsLong, false));
+    }
+
+    ConnVector connVector;
+    IdVector implIds, continuations;
+    ASSERT_EQ(SA_AIS_OK, model_->ccbApply(kCcbId, kConn, connVector, implIds,
+                                          continuations, false));
+    model_->ccbCommit(kCcbId, connVector);
+  }
+
+  void TearDown() override {
+    memset(immnd_cb->latency, 0, sizeof(immnd_cb->latency));
+  }
+
+  static void CreateAdminOwner(SaUint32T ownerId, const char *name) {
+    IMMSV_OM_ADMIN_OWNER_INITIALIZE req = {};
+    osaf_extended_name_lend(name, &req.adminOwnerName);
+    ASSERT_EQ(SA_AIS_OK,
+              model_->adminOwnerCreate(&req, ownerId, kConn, kNodeId));
+  }
+
+  // Invokes the admin operation opName, for resource if given
+  static SaAisErrorT Invoke(const char *opName, const char *resource,
+                            Display *display) {
+    IMMSV_ADMIN_OPERATION_PARAM resource_param = {};
+    resource_param.paramName = OctetString("resource");
+    resource_param.paramType = SA_IMM_ATTR_SASTRINGT;
+    resource_param.paramBuffer.val.x = OctetString(resource ? resource : "");
+    IMMSV_ADMIN_OPERATION_PARAM op_param = {};
+    op_param.paramName = OctetString(SA_IMM_PARAM_ADMOP_NAME);
+    op_param.paramType = SA_IMM_ATTR_SASTRINGT;
+    op_param.paramBuffer.val.x = OctetString(opName);
+    if (resource) op_param.next = &resource_param;
+
+    IMMSV_ADMIN_OPERATION_PARAM *rparams = nullptr;
+    SaAisErrorT err =
+        immModel_resourceDisplay(immnd_cb, &op_param, &rparams);
+    display->clear();
+    while (rparams) {
+      IMMSV_ADMIN_OPERATION_PARAM *p = rparams;
+      rparams = p->next;
+      std::string &value = (*display)[p->paramName.buf];
+      if (!value.empty()) value += ',';
+      if (p->paramType == SA_IMM_ATTR_SAINT64T) {
+        value += std::to_string(p->paramBuffer.val.saint64);
+      } else {
+        value += p->paramBuffer.val.x.buf;
+      }
+      free(p->paramName.buf);
+      immsv_evt_free_att_val(&p->paramBuffer,
+                             static_cast<SaImmValueTypeT>(p->paramType));
+      free(p);
+    }
+    return err;
+  }
+
+  static std::string Count(const char *resource) {
+    Display display;
+    EXPECT_EQ(SA_AIS_OK, Invoke("display", resource, &display));
+    EXPECT_EQ(1u, display.size());
+    return display["count"];
+  }
+
+  // The number after "key:" in value
+  static unsigned long long Field(const std::string &value, const char *key,
+                                  int base = 10) {
+    std::string prefix = std::string(key) + ":";
+    size_t pos = value.find(prefix);
+    if (pos == std::string::npos) {
+      ADD_FAILURE() << "no " << key << " in " << value;
+      return 0;
+    }
+    return strtoull(value.c_str() + pos + prefix.size(), nullptr, base);
+  }
+
+  static ImmModel *model_;
+};
+
+ImmModel *ResourceDisplayTest::model_ = nullptr;
+
+TEST_F(ResourceDisplayTest, CountsClassesAndObjects) {
+  EXPECT_EQ("1", Count("classes"));
+  EXPECT_EQ(std::to_string(kObjects), Count("objects"));
+}
+
+TEST_F(ResourceDisplayTest, ClassesShowObjectsAndBytes) {
+  Display display;
+  ASSERT_EQ(SA_AIS_OK, Invoke("displayverbose", "classes", &display));
+  ASSERT_EQ(1u, display.size());
+  const std::string &value = display["TestClass"];
+  EXPECT_EQ(static_cast<unsigned>(kObjects), Field(value, "objects"));
+  // the data and the other attributes of every object
+  EXPECT_GT(Field(value, "bytes"), kObjects * kDataSize);
+  EXPECT_LT(Field(value, "bytes"), kObjects * (kDataSize + 4096));
+}
+
+TEST_F(ResourceDisplayTest, AdminOwnersShowOwnedObjectsAndBytes) {
+  EXPECT_EQ("2", Count("adminowners"));
+
+  Display display;
+  ASSERT_EQ(SA_AIS_OK, Invoke("displayverbose", "adminowners", &display));
+  ASSERT_EQ(2u, display.size());
+  const std::string &owner = display["TestOwner"];
+  EXPECT_EQ(kNodeId, Field(owner, "node", 16));
+  EXPECT_EQ(static_cast<unsigned>(kObjects), Field(owner, "objects"));
+
+  // an owner of all the objects uses the bytes of their class
+  Display classes;
+  ASSERT_EQ(SA_AIS_OK, Invoke("displayverbose", "classes", &classes));
+  EXPECT_EQ(Field(classes["TestClass"], "bytes"), Field(owner, "bytes"));
+
+  const std::string &idle = display["IdleOwner"];
+  EXPECT_EQ(0u, Field(idle, "objects"));
+  EXPECT_EQ(0u, Field(idle, "bytes"));
+}
+
+TEST_F(ResourceDisplayTest, CcbsShowStateAndOperations) {
+  EXPECT_EQ("1", Count("ccbs"));
+
+  Display display;
+  ASSERT_EQ(SA_AIS_OK, Invoke("displayverbose", "ccbs", &display));
+  ASSERT_EQ(1u, display.size());
+  const std::string &ccb = display[std::to_string(kCcbId)];
+  EXPECT_EQ(0u, ccb.find("state:committed ")) << ccb;
+  EXPECT_EQ(static_cast<unsigned>(kObjects), Field(ccb, "ops"));
+  EXPECT_EQ(kNodeId, Field(ccb, "node", 16));
+}
+
+TEST_F(ResourceDisplayTest, FevsShowsFlowControl) {
+  immnd_cb->fevs_replies_pending = 3;
+  immnd_cb->fevs_out_count = 2;
+  immnd_cb->highestReceived = 120;
+  immnd_cb->highestProcessed = 118;
+
+  EXPECT_EQ("3", Count("fevs"));
+
+  Display display;
+  ASSERT_EQ(SA_AIS_OK, Invoke("displayverbose", "fevs", &display));
+  EXPECT_EQ("3", display["repliesPending"]);
+  EXPECT_EQ(std::to_string(IMMSV_DEFAULT_FEVS_MAX_PENDING),
+            display["maxRepliesPending"]);
+  EXPECT_EQ("2", display["outQueue"]);
+  EXPECT_EQ("120", display["highestReceived"]);
+  EXPECT_EQ("118", display["highestProcessed"]);
+
+  immnd_cb->fevs_replies_pending = 0;
+  immnd_cb->fevs_out_count = 0;
+}
+
+TEST_F(ResourceDisplayTest, LatencyShowsTheHistogramOfEachMessageType) {
+  immnd_latency_add(&immnd_cb->latency[IMMND_EVT_A2ND_SEARCHINIT], 5);
+  immnd_latency_add(&immnd_cb->latency[IMMND_EVT_A2ND_SEARCHINIT], 150);
+  immnd_latency_add(&immnd_cb->latency[IMMND_EVT_A2ND_SEARCHINIT], 2000000);
+  immnd_latency_add(&immnd_cb->latency[IMMND_EVT_A2ND_IMM_INIT], 40);
+
+  EXPECT_EQ("4", Count("latency"));
+
+  Display display;
+  ASSERT_EQ(SA_AIS_OK, Invoke("displayverbose", "latency", &display));
+  ASSERT_EQ(2u, display.size());
+  EXPECT_EQ(
+      "count:3 avg:666718us max:2000000us <10us:1 <100us:0 <1ms:1 <10ms:0 "
+      "<100ms:0 <1s:0 >=1s:1",
+      display[immsv_get_immnd_evt_name(IMMND_EVT_A2ND_SEARCHINIT)]);
+  EXPECT_EQ(
+      "count:1 avg:40us max:40us <10us:0 <100us:1 <1ms:0 <10ms:0 <100ms:0 "
+      "<1s:0 >=1s:0",
+      display[immsv_get_immnd_evt_name(IMMND_EVT_A2ND_IMM_INIT)]);
+}
+
+TEST_F(ResourceDisplayTest, HelpListsTheResources) {
+  Display display;
+  ASSERT_EQ(SA_AIS_OK, Invoke("display-help", nullptr, &display));
+  EXPECT_EQ(
+      "implementers,adminowners,ccbs,searches,classes,objects,fevs,latency",
+      display["supportedResources"]);
+}
+
+TEST_F(ResourceDisplayTest, UnknownResourceIsInvalid) {
+  Display display;
+  EXPECT_EQ(SA_AIS_ERR_INVALID_PARAM,
+            Invoke("display", "nosuchresource", &display));
+  EXPECT_EQ(SA_AIS_ERR_INVALID_PARAM,
+            Invoke("displayverbose", "objects", &display));
+  EXPECT_EQ(1u, display.count(SA_IMM_PARAM_ADMOP_ERROR));
+}
+
+}  // namespace
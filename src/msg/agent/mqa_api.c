@@ -52,6 +52,8 @@ static uint32_t mqa_send_to_group(MQA_CB *mqa_cb, ASAPi_OPR_INFO *asapi_or,
 				  SaMsgAckFlagsT ackFlags,
 				  MQA_SEND_MESSAGE_PARAM *param,
 				  uint32_t length);
+static bool mqa_send_direct(MQA_CB *mqa_cb, const ASAPi_QUEUE_PARAM *qparam,
+			    const SaMsgMessageT *message, SaAisErrorT *o_rc);
 static SaAisErrorT
 mqa_send_message(SaMsgHandleT msgHandle, const SaNameT *destination,
 		 const SaMsgMessageT *message, SaMsgAckFlagsT ackFlags,
@@ -886,12 +888,32 @@ saMsgQueueOpen(SaMsgHandleT msgHandle, const SaNameT *queueName,
 			goto done;
 		}
 
+		/* Hand the listener queue to the queue reader threads, see
+		 * mqa_reader.c */
+		if ((queue_info->openFlags & SA_MSG_QUEUE_RECEIVE_CALLBACK) &&
+		    mqa_cb->reader_pool) {
+			queue_info->listenerHandle =
+			    out_evt->msg.mqp_rsp.info.openRsp.listenerHandle;
+
+			if (mqa_reader_pool_add(
+				mqa_cb->reader_pool, *queueHandle,
+				queue_info->listenerHandle,
+				out_evt->msg.mqp_rsp.info.openRsp
+				    .existing_msg_count) != NCSCC_RC_SUCCESS) {
+				TRACE_4("ERR_RESOURCES: Queue Reader Add Failed");
+				rc = SA_AIS_ERR_NO_RESOURCES;
+				mqa_queue_tree_delete_node(mqa_cb,
+							   *queueHandle);
+			} else
+				rc = SA_AIS_OK;
+		}
 		/* Start a thread to notify when there is a message in the
 		 * queue. The thread does it by using  1 byte message buffer to
 		 * read from the queue. When it fails, it assumes that there is
 		 * a message in the queue.
 		 */
-		if (queue_info->openFlags & SA_MSG_QUEUE_RECEIVE_CALLBACK) {
+		else if (queue_info->openFlags &
+			 SA_MSG_QUEUE_RECEIVE_CALLBACK) {
 			MQP_OPEN_RSP *openRsp;
 
 			/* update queue_info data structure with listenerHandle
@@ -1924,10 +1946,14 @@ uint32_t mqa_send_to_group(MQA_CB *mqa_cb, ASAPi_OPR_INFO *asapi_or,
 	SaAisErrorT rc = SA_AIS_ERR_NO_RESOURCES;
 	MQSV_DSEND_EVT *qsend_evt_copy = NULL, *qsend_evt_buffer = NULL;
 	bool is_send_success = false;
+	SaUint8T priority;
 
 	TRACE_ENTER();
 
 	num_queues = asapi_or->info.dest.o_cache->info.ginfo.qlist.count;
+	priority = param->async_flag
+		       ? qsend_evt->info.sndMsgAsync.SendMsg.message.priority
+		       : qsend_evt->info.snd_msg.message.priority;
 
 	if (num_queues == 0) {
 		mds_free_direct_buff((MDS_DIRECT_BUFF)qsend_evt);
@@ -1940,12 +1966,15 @@ uint32_t mqa_send_to_group(MQA_CB *mqa_cb, ASAPi_OPR_INFO *asapi_or,
 	if ((asapi_or->info.dest.o_cache->info.ginfo.policy ==
 	     SA_MSG_QUEUE_GROUP_ROUND_ROBIN) ||
 	    (asapi_or->info.dest.o_cache->info.ginfo.policy ==
-	     SA_MSG_QUEUE_GROUP_LOCAL_ROUND_ROBIN))
+	     SA_MSG_QUEUE_GROUP_LOCAL_ROUND_ROBIN) ||
+	    (asapi_or->info.dest.o_cache->info.ginfo.policy ==
+	     SA_MSG_QUEUE_GROUP_LOCAL_BEST_QUEUE))
 		unicast = 1;
 
 	if (unicast) {
 		asapi_or->info.dest.o_cache->info.ginfo.pQueue = 0;
-		asapi_queue_select(&(asapi_or->info.dest.o_cache->info.ginfo));
+		asapi_queue_select(&(asapi_or->info.dest.o_cache->info.ginfo),
+				   priority);
 		destination_mqnd =
 		    asapi_or->info.dest.o_cache->info.ginfo.pQueue->param.addr;
 
@@ -2012,7 +2041,8 @@ uint32_t mqa_send_to_group(MQA_CB *mqa_cb, ASAPi_OPR_INFO *asapi_or,
 		rc = SA_AIS_OK;
 		do {
 			asapi_queue_select(
-			    &(asapi_or->info.dest.o_cache->info.ginfo));
+			    &(asapi_or->info.dest.o_cache->info.ginfo),
+			    priority);
 
 			if (asapi_or->info.dest.o_cache->info.ginfo.pQueue) {
 				if (!param->async_flag) {
@@ -2142,6 +2172,81 @@ uint32_t mqa_send_to_group(MQA_CB *mqa_cb, ASAPi_OPR_INFO *asapi_or,
 	return rc;
 }
 
+/****************************************************************************
+  Name          : mqa_send_direct
+
+  Description   : This routine puts a message straight into a shared memory
+		  queue on this node, the way the MQND would. It is the
+		  path of a plain send, the MQND keeps serving the others.
+
+  Arguments     : MQA_CB *mqa_cb - MQA control block
+		  ASAPi_QUEUE_PARAM *qparam - the destination queue
+		  SaMsgMessageT *message - The message to be sent.
+		  SaAisErrorT *o_rc - result of the send
+
+  Return Values : true if the send was done here, false to send through the
+		  MQND
+
+  Notes         : Called with the cb_lock held.
+******************************************************************************/
+static bool mqa_send_direct(MQA_CB *mqa_cb, const ASAPi_QUEUE_PARAM *qparam,
+			    const SaMsgMessageT *message, SaAisErrorT *o_rc)
+{
+	union {
+		MQSV_MESSAGE msg;
+		uint8_t raw[sizeof(MQSV_MESSAGE) + MQSV_MAX_SND_SIZE];
+	} buf;
+	MQSV_MESSAGE *mqsv_msg = &buf.msg;
+	NCS_OS_POSIX_MQD listener = 0;
+
+	if (!m_MQSV_IS_SHMQ(qparam->hdl) || qparam->is_mqnd_down ||
+	    m_NCS_NODE_ID_FROM_MDS_DEST(qparam->addr) !=
+		m_NCS_NODE_ID_FROM_MDS_DEST(mqa_cb->mqa_mds_dest) ||
+	    sizeof(MQSV_MESSAGE) + message->size > NCS_OS_MQ_MAX_PAYLOAD)
+		return false;
+
+	memset(mqsv_msg, 0, sizeof(MQSV_MESSAGE));
+	mqsv_msg->type = MQP_EVT_GET_REQ;
+	mqsv_msg->mqsv_version = MQSV_MSG_VERSION;
+	m_GET_TIME_STAMP(mqsv_msg->info.msg.message_info.sendTime);
+	mqsv_msg->info.msg.message_info.sendReceive = SA_FALSE;
+	mqsv_msg->info.msg.message.type = message->type;
+	mqsv_msg->info.msg.message.version = message->version;
+	mqsv_msg->info.msg.message.size = message->size;
+	mqsv_msg->info.msg.message.priority = message->priority;
+	if (message->senderName)
+		mqsv_msg->info.msg.message.senderName = *message->senderName;
+
+	if (mqsv_shmq_direct_send(qparam->hdl, mqsv_msg, message->data,
+				  &listener) != NCSCC_RC_SUCCESS) {
+		switch (errno) {
+		case EAGAIN:
+			TRACE_2("ERR_QUEUE_FULL: The queue is full");
+			*o_rc = SA_AIS_ERR_QUEUE_FULL;
+			return true;
+		case ENOSPC:
+			TRACE_4("ERR_RESOURCES: The queue can not grow");
+			*o_rc = SA_AIS_ERR_NO_RESOURCES;
+			return true;
+		default:
+			/* Not allowed or not reachable, let the MQND decide */
+			TRACE_2("Direct send failed: %s", strerror(errno));
+			return false;
+		}
+	}
+
+	/* Send a 1-byte message to the listener queue, as the MQND does */
+	if (mqsv_listenerq_msg_send(listener) != NCSCC_RC_SUCCESS) {
+		TRACE_4(
+		    "ERR_RESOURCES: Unable to send the message to the listener Queue");
+		*o_rc = SA_AIS_ERR_NO_RESOURCES;
+		return true;
+	}
+
+	*o_rc = SA_AIS_OK;
+	return true;
+}
+
 /****************************************************************************
   Name          : mqa_send_message
 
@@ -2308,6 +2413,14 @@ SaAisErrorT mqa_send_message(SaMsgHandleT msgHandle, const SaNameT *destination,
 			rc = SA_AIS_ERR_LIBRARY;
 			goto done;
 		}
+
+		/* A delivered callback needs the MQND */
+		if (!(param->async_flag &&
+		      (ackFlags & SA_MSG_MESSAGE_DELIVERED_ACK)) &&
+		    mqa_send_direct(mqa_cb,
+				    &asapi_or.info.dest.o_cache->info.qinfo.param,
+				    message, &rc))
+			goto done;
 	}
 
 	/* Allocate memory for the MQSV_DSEND_EVENT structure + data */
@@ -2779,7 +2892,7 @@ SaAisErrorT mqa_receive_message(SaMsgQueueHandleT queueHandle,
 again:
 	posix_mq_get_failure = false;
 
-	if (ncs_os_posix_mq(&mq_req) != NCSCC_RC_SUCCESS) {
+	if (m_MQSV_POSIX_MQ(&mq_req) != NCSCC_RC_SUCCESS) {
 		if (timeout == 0) {
 			TRACE_2("ERR_TIMEOUT: Message get failed ");
 			rc = SA_AIS_ERR_TIMEOUT;
@@ -2849,7 +2962,7 @@ again:
 				mq_req_snd.info.send.i_msg = &mq_msg;
 				mq_req_snd.info.send.i_mtype = 2;
 
-				if (ncs_os_posix_mq(&mq_req_snd) !=
+				if (m_MQSV_POSIX_MQ(&mq_req_snd) !=
 				    NCSCC_RC_SUCCESS) {
 					TRACE_4(
 					    "ERR_RESOURCES: Unable to put back the genuine message in msgget call");
@@ -2903,7 +3016,7 @@ again:
 			mq_req_snd.info.send.i_msg = &mq_msg;
 			mq_req_snd.info.send.i_mtype = 1;
 
-			if (ncs_os_posix_mq(&mq_req_snd) != NCSCC_RC_SUCCESS) {
+			if (m_MQSV_POSIX_MQ(&mq_req_snd) != NCSCC_RC_SUCCESS) {
 				TRACE_4(
 				    "ERR_RESOURCES: Unable to put back the stop Tmr message"
 				    " which is meant for a different msgget");
@@ -3008,7 +3121,7 @@ again:
 			mq_req.info.send.i_msg = &mq_msg;
 			mq_req.info.send.i_mtype = 2;
 
-			if (ncs_os_posix_mq(&mq_req) != NCSCC_RC_SUCCESS) {
+			if (m_MQSV_POSIX_MQ(&mq_req) != NCSCC_RC_SUCCESS) {
 				TRACE_4(
 				    "Unable to put back the genuine message in msgget call");
 				/* TBD: Don't know what to do */
@@ -3035,6 +3148,10 @@ again:
 		*message->senderName =
 		    mqsv_message->info.msg.message.senderName;
 
+	/* A shared memory queue took the message off its usage itself */
+	if (m_MQSV_IS_SHMQ(queueHandle))
+		goto check;
+
 	to_dest_ver =
 	    mqa_cb->ver_mqnd[mqsv_get_phy_slot_id(mqa_cb->mqnd_mds_dest)];
 
@@ -3139,7 +3256,7 @@ check:
 		mq_req.info.send.i_msg = &mq_msg;
 		mq_req.info.send.i_mtype = 2;
 
-		if (ncs_os_posix_mq(&mq_req) != NCSCC_RC_SUCCESS) {
+		if (m_MQSV_POSIX_MQ(&mq_req) != NCSCC_RC_SUCCESS) {
 			TRACE_4(
 			    "Unable to put back the genuine message in msgget call");
 			/* TBD: Don't know what to do */
@@ -3382,7 +3499,7 @@ SaAisErrorT saMsgMessageCancel(SaMsgQueueHandleT queueHandle)
 	/* Send the message from the Queue using the OS call ->ncs_os_mq() */
 
 	for (i = 0; i < cancel_message_count; i++) {
-		if (m_NCS_OS_POSIX_MQ(&mq_req) != NCSCC_RC_SUCCESS) {
+		if (m_MQSV_POSIX_MQ(&mq_req) != NCSCC_RC_SUCCESS) {
 			TRACE_2(
 			    "ERR_TRY_AGAIN: Unable to put the cancel message in the queue");
 			rc = SA_AIS_ERR_TRY_AGAIN;
@@ -3705,7 +3822,8 @@ SaAisErrorT saMsgMessageSendReceive(SaMsgHandleT msgHandle,
 		if (unicast) {
 			asapi_or.info.dest.o_cache->info.ginfo.pQueue = 0;
 			asapi_queue_select(
-			    &(asapi_or.info.dest.o_cache->info.ginfo));
+			    &(asapi_or.info.dest.o_cache->info.ginfo),
+			    sendMessage->priority);
 			qsend_evt->info.snd_msg.queueHandle =
 			    asapi_or.info.dest.o_cache->info.ginfo.pQueue->param
 				.hdl;
@@ -4512,14 +4630,6 @@ SaAisErrorT saMsgQueueGroupCreate(SaMsgHandleT msgHandle,
 		return SA_AIS_ERR_INVALID_PARAM;
 	}
 
-	if ((queueGroupPolicy != SA_MSG_QUEUE_GROUP_ROUND_ROBIN) &&
-	    (queueGroupPolicy != SA_MSG_QUEUE_GROUP_BROADCAST) &&
-	    (queueGroupPolicy != SA_MSG_QUEUE_GROUP_LOCAL_ROUND_ROBIN)) {
-		TRACE_2(
-		    "ERR_NOT_SUPPORTED: supported queueGroupPolicy (ROUND_ROBIN,BROADCAST,LOCAL_ROUND_ROBIN)");
-		return SA_AIS_ERR_NOT_SUPPORTED;
-	}
-
 	/* retrieve MQA CB */
 	mqa_cb = (MQA_CB *)m_MQSV_MQA_RETRIEVE_MQA_CB;
 	if (!mqa_cb) {
@@ -5662,7 +5772,7 @@ static void msgget_timer_expired(void *arg)
 	mq_req.info.send.mqd = (*cancel_req)->queueHandle;
 	mq_req.info.send.i_mtype = 1;
 
-	if ((rc = m_NCS_OS_POSIX_MQ(&mq_req)) != NCSCC_RC_SUCCESS) {
+	if ((rc = m_MQSV_POSIX_MQ(&mq_req)) != NCSCC_RC_SUCCESS) {
 		TRACE_4("Unable to put the cancel message in the queue");
 	}
 
@@ -194,13 +194,35 @@ static void mqa_process_callback(MQA_CB *cb, SaMsgHandleT msgHandle,
 			    cb, param->queueHandle, true, client_info,
 			    param->openFlags);
 
+			/* Hand the listener queue to the queue reader
+			 * threads, see mqa_reader.c */
+			if (queue_info &&
+			    (queue_info->openFlags &
+			     SA_MSG_QUEUE_RECEIVE_CALLBACK) &&
+			    cb->reader_pool) {
+				queue_info->listenerHandle =
+				    param->listenerHandle;
+
+				if (mqa_reader_pool_add(
+					cb->reader_pool, param->queueHandle,
+					param->listenerHandle,
+					param->existing_msg_count) !=
+				    NCSCC_RC_SUCCESS) {
+					TRACE_4(
+					    "ERR_RESOURCES: Queue Reader Add Failed");
+					param->error = SA_AIS_ERR_NO_RESOURCES;
+					mqa_queue_tree_delete_node(
+					    cb, param->queueHandle);
+				}
+			}
 			/* Start a thread to notify when there is a message in
 			 * the queue. The thread does it by using  1 byte
 			 * message buffer to read from the queue. When it fails,
 			 * it assumes that there is a message in the queue.
 			 */
-			if (queue_info && (queue_info->openFlags &
-					   SA_MSG_QUEUE_RECEIVE_CALLBACK)) {
+			else if (queue_info &&
+				 (queue_info->openFlags &
+				  SA_MSG_QUEUE_RECEIVE_CALLBACK)) {
 				MQP_OPEN_RSP *openRsp;
 
 				/* update queue_info data structure with
@@ -1171,6 +1193,62 @@ mqsv_mqa_callback_queue_read(MQA_CLIENT_INFO *client_info)
 	return return_callback;
 }
 
+/****************************************************************************
+  Name          : mqa_reader_post
+
+  Description   : Posts receive callbacks for a queue, the same way as
+		  mqa_queue_reader does for each indicator. The post function
+		  of the listener queue reader pool, see mqa_reader.c.
+
+  Arguments     : queueHandle - the queue
+		  count - number of callbacks to post
+
+  Return Values : false if the queue is closed or no longer known
+******************************************************************************/
+bool mqa_reader_post(SaMsgQueueHandleT queueHandle, uint32_t count)
+{
+	MQA_CB *mqa_cb;
+	MQA_QUEUE_INFO *queue_node;
+	MQP_ASYNC_RSP_MSG *mqa_callbk_info;
+	bool open = true;
+
+	mqa_cb = (MQA_CB *)m_MQSV_MQA_RETRIEVE_MQA_CB;
+	if (!mqa_cb)
+		return true;
+
+	if (m_NCS_LOCK(&mqa_cb->cb_lock, NCS_LOCK_WRITE) != NCSCC_RC_SUCCESS)
+		goto give_cb;
+
+	queue_node =
+	    mqa_queue_tree_find_and_add(mqa_cb, queueHandle, false, NULL, 0);
+	if (queue_node == NULL || queue_node->is_closed == true) {
+		open = false;
+		goto done;
+	}
+
+	for (; count; --count) {
+		mqa_callbk_info = m_MMGR_ALLOC_MQP_ASYNC_RSP_MSG;
+		if (!mqa_callbk_info) {
+			TRACE_4(
+			    "FAILURE: MQP Async Rsp Message Allocation Failed");
+			break;
+		}
+		memset(mqa_callbk_info, 0, sizeof(MQP_ASYNC_RSP_MSG));
+		mqa_callbk_info->callbackType = MQP_ASYNC_RSP_MSGRECEIVED;
+		mqa_callbk_info->params.msgReceived.queueHandle = queueHandle;
+		if (mqsv_mqa_callback_queue_write(
+			mqa_cb, queue_node->client_info->msgHandle,
+			mqa_callbk_info) != NCSCC_RC_SUCCESS)
+			TRACE_2("FAILURE: Call back Queue Write Failed");
+	}
+
+done:
+	m_NCS_UNLOCK(&mqa_cb->cb_lock, NCS_LOCK_WRITE);
+give_cb:
+	m_MQSV_MQA_GIVEUP_MQA_CB;
+	return open;
+}
+
 /****************************************************************************
   Name          : mqa_queue_reader
 
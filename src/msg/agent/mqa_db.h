@@ -31,6 +31,7 @@
 #define MSG_AGENT_MQA_DB_H_
 
 #include "base/ncsgl_defs.h"
+#include "msg/agent/mqa_reader.h"
 
 extern uint32_t gl_mqa_hdl;
 
@@ -172,6 +173,9 @@ typedef struct mqa_cb {
   /*To store versions of MQND across cluster */
   SVC_SUBPART_VER ver_mqnd[MQA_MAX_NODES];
   uint32_t clm_node_joined;
+
+  /* Listener queue readers, NULL for a reader thread per queue */
+  MQA_READER_POOL *reader_pool;
 } MQA_CB;
 
 bool mqa_track_tree_find_and_del(MQA_CLIENT_INFO *client_info, SaNameT *group);
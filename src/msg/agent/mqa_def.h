@@ -62,6 +62,7 @@ MQA_CLIENT_INFO *mqa_client_tree_find_and_add(MQA_CB *mqa_cb,
 uint32_t mqa_client_tree_delete_node(MQA_CB *mqa_cb,
                                      MQA_CLIENT_INFO *client_info);
 void mqa_queue_reader(NCSCONTEXT context);
+bool mqa_reader_post(SaMsgQueueHandleT queueHandle, uint32_t count);
 
 MQA_QUEUE_INFO *mqa_queue_tree_find_and_add(MQA_CB *mqa_cb,
                                             SaMsgQueueHandleT hdl_id, bool flag,
@@ -53,6 +53,7 @@ static uint32_t mqa_destroy(NCS_LIB_DESTROY *destroy_info);
 static uint32_t mqa_asapi_register(MQA_CB *cb);
 static uint32_t mqa_client_tree_init(MQA_CB *cb);
 static uint32_t mqa_queue_tree_init(MQA_CB *cb);
+static uint32_t mqa_reader_pool_init(MQA_CB *cb);
 
 /****************************************************************************
   Name          : mqa_lib_req
@@ -235,17 +236,23 @@ static uint32_t mqa_create(NCS_LIB_CREATE *create_info)
 	}
 	TRACE_1("Queue Database Initialization Success");
 
+	/* initialize the listener queue readers */
+	if ((rc = mqa_reader_pool_init(cb)) != NCSCC_RC_SUCCESS) {
+		TRACE_2("FAILURE: Queue reader pool Initialization Failed");
+		goto error4;
+	}
+
 	/* EDU initialisation */
 	if ((rc = m_NCS_EDU_HDL_INIT(&cb->edu_hdl)) != NCSCC_RC_SUCCESS) {
 		TRACE_2("Edu Handle Initialization Failed");
-		goto error4;
+		goto error5;
 	}
 
 	TRACE_1("EDU Handle Initialization Success");
 	/* register with MDS */
 	if ((rc = mqa_mds_register(cb)) != NCSCC_RC_SUCCESS) {
 		TRACE_2("FAILURE: MDS registration Failed");
-		goto error5;
+		goto error6;
 	} else
 		TRACE_1("MDS Registration Success");
 
@@ -260,27 +267,31 @@ static uint32_t mqa_create(NCS_LIB_CREATE *create_info)
 	/* initialize the timeout linked list */
 	if ((rc = mqa_timer_table_init(cb)) != NCSCC_RC_SUCCESS) {
 		TRACE_2("FAILURE: Tmr Initialization Failed");
-		goto error6;
+		goto error7;
 	}
 
 	if ((rc = mqa_asapi_register(cb)) != NCSCC_RC_SUCCESS) {
 		TRACE_2("FAILURE: Registration with ASAPi Failed");
-		goto error7;
+		goto error8;
 	}
 
 	TRACE_LEAVE();
 	return NCSCC_RC_SUCCESS;
 
-error7:
+error8:
 	mqa_timer_table_destroy(cb);
 
-error6:
+error7:
 	/* MDS unregister. */
 	mqa_mds_unregister(cb);
 
-error5:
+error6:
 	m_NCS_EDU_HDL_FLUSH(&cb->edu_hdl);
 
+error5:
+	mqa_reader_pool_delete(cb->reader_pool);
+	cb->reader_pool = NULL;
+
 error4:
 	/* delete the tree */
 	mqa_queue_tree_destroy(cb);
@@ -323,6 +334,10 @@ static uint32_t mqa_destroy(NCS_LIB_DESTROY *destroy_info)
 	/* return MQA CB */
 	ncshm_give_hdl(gl_mqa_hdl);
 
+	/* stop the listener queue readers before the handle goes */
+	mqa_reader_pool_delete(cb->reader_pool);
+	cb->reader_pool = NULL;
+
 	/* remove the association with hdl-mngr */
 	ncshm_destroy_hdl(NCS_SERVICE_ID_MQA, cb->agent_handle_id);
 
@@ -812,6 +827,42 @@ static uint32_t mqa_queue_tree_init(MQA_CB *cb)
 	return NCSCC_RC_SUCCESS;
 }
 
+/****************************************************************************
+  Name          : mqa_reader_pool_init
+
+  Description   : This routine sets up the listener queue reader threads if
+		  OSAF_MQA_READER_THREADS is set, see mqa_reader.c
+
+  Arguments     : cb - pointer to the MQA Control Block
+
+  Return Values : NCSCC_RC_SUCCESS/NCSCC_RC_FAILURE
+
+  Notes         : None
+******************************************************************************/
+static uint32_t mqa_reader_pool_init(MQA_CB *cb)
+{
+	uint32_t n_readers = 0;
+	uint32_t poll_ms = MQA_READER_POLL_MS_DEFAULT;
+	char *ptr;
+
+	if ((ptr = getenv("OSAF_MQA_READER_THREADS")) != NULL)
+		n_readers = strtoul(ptr, NULL, 0);
+	if ((ptr = getenv("OSAF_MQA_READER_POLL_MS")) != NULL)
+		poll_ms = strtoul(ptr, NULL, 0);
+
+	cb->reader_pool = NULL;
+	if (n_readers == 0) {
+		TRACE_1("Queue reader thread per queue");
+		return NCSCC_RC_SUCCESS;
+	}
+
+	cb->reader_pool =
+	    mqa_reader_pool_new(n_readers, poll_ms, mqa_reader_post);
+	if (cb->reader_pool == NULL)
+		return NCSCC_RC_FAILURE;
+	return NCSCC_RC_SUCCESS;
+}
+
 /****************************************************************************
   Name          : mqa_client_queue_destroy
 
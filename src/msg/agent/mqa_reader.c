@@ -0,0 +1,405 @@
+/*      -*- OpenSAF  -*-
+ *
+ * (C) Copyright 2017 The OpenSAF Foundation
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. This file and program are licensed
+ * under the GNU Lesser General Public License Version 2.1, February 1999.
+ * The complete license can be accessed from the following location:
+ * http://opensource.org/licenses/lgpl-license.php
+ * See the Copying file included with the OpenSAF distribution for full
+ * licensing terms.
+ *
+ */
+
+/*****************************************************************************
+..............................................................................
+
+..............................................................................
+
+	DESCRIPTION:
+
+	Multiplexed listener queue readers. A queue opened with
+	SA_MSG_QUEUE_RECEIVE_CALLBACK has a listener queue, to which the MQND
+	writes a 1-byte indicator for every message put into the queue. By
+	default one blocking mqa_queue_reader thread is started per opened
+	queue. With OSAF_MQA_READER_THREADS set, a small pool of reader threads
+	owns all listener queues of the process instead. The listener queues are
+	SysV message queues, which can not be waited on together, so each reader
+	sweeps its queues with non-blocking receives and backs off from 1 ms up to
+	a maximum interval while all of them are idle. The pool trades the
+	threads for these wakeups and for a delay of the first receive callback
+	after an idle period, so it is only for processes with many queues.
+
+	Environment:
+    OSAF_MQA_READER_THREADS  Number of reader threads, default 0, which
+                             gives a thread per queue.
+    OSAF_MQA_READER_POLL_MS  Maximum sweep interval of an idle reader,
+                             default 10 ms. This bounds the extra delay of
+                             the first receive callback after an idle
+                             period.
+..............................................................................
+
+	FUNCTIONS INCLUDED in this module:
+
+	mqa_reader_pool_new
+	mqa_reader_pool_delete
+	mqa_reader_pool_add
+
+******************************************************************************
+*/
+
+#include "msg/agent/mqa_reader.h"
+
+#include <errno.h>
+#include <inttypes.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "base/logtrace.h"
+#include "base/ncs_osprm.h"
+#include "base/osaf_time.h"
+#include "base/osaf_utility.h"
+
+/* Indicators read from one listener queue per sweep, for fairness */
+#define MQA_READER_SWEEP_BURST 64
+
+typedef struct mqa_reader_queue {
+	SaMsgQueueHandleT queueHandle;
+	SaMsgQueueHandleT listenerHandle;
+	uint32_t pending; /* Callbacks to post, from indicators or existing msgs */
+	bool gone;        /* Listener queue removed or queue closed */
+	struct mqa_reader_queue *next;
+} MQA_READER_QUEUE;
+
+typedef struct mqa_reader {
+	pthread_mutex_t lock; /* Protects queues, taken after cb_lock */
+	pthread_cond_t cond;
+	pthread_t thread;
+	bool started;
+	bool kick; /* Sweep again without waiting */
+	MQA_READER_QUEUE *queues;
+	uint32_t n_queues;
+	uint64_t sweeps;
+	uint64_t callbacks;
+	struct mqa_reader_pool *pool;
+} MQA_READER;
+
+struct mqa_reader_pool {
+	uint32_t n_readers;
+	uint32_t poll_ms;
+	MQA_READER_POST post;
+	bool stop;
+	MQA_READER readers[MQA_READER_THREADS_MAX];
+};
+
+/****************************************************************************
+	Name          : mqa_reader_sweep
+
+	Description   : Reads the pending indicators of all listener queues of
+		  the reader. Called with the reader lock held.
+
+	Arguments     : reader - the reader
+
+	Return Values : true if any queue has callbacks to post
+******************************************************************************/
+static bool mqa_reader_sweep(MQA_READER *reader)
+{
+	NCS_OS_POSIX_MQ_REQ_INFO mq_req;
+	NCS_OS_MQ_MSG mq_msg;
+	MQA_READER_QUEUE *q;
+	bool found = false;
+	int burst;
+
+	++reader->sweeps;
+	for (q = reader->queues; q != NULL; q = q->next) {
+		for (burst = 0; !q->gone && burst < MQA_READER_SWEEP_BURST;
+		     ++burst) {
+			memset(&mq_req, 0, sizeof(NCS_OS_POSIX_MQ_REQ_INFO));
+			mq_req.req = NCS_OS_POSIX_MQ_REQ_MSG_RECV_ASYNC;
+			mq_req.info.recv.mqd = q->listenerHandle;
+			mq_req.info.recv.i_msg = &mq_msg;
+			mq_req.info.recv.datalen = 1;
+
+			if (m_NCS_OS_POSIX_MQ(&mq_req) == NCSCC_RC_SUCCESS) {
+				++q->pending;
+				continue;
+			}
+			/* Anything but an empty queue means that the MQND
+			 * removed the listener queue */
+			if (errno != ENOMSG)
+				q->gone = true;
+			break;
+		}
+		if (q->pending || q->gone)
+			found = true;
+	}
+	return found;
+}
+
+/****************************************************************************
+	Name          : mqa_reader_thread
+
+	Description   : Reader thread main loop.
+
+	Arguments     : arg - the reader
+******************************************************************************/
+static void *mqa_reader_thread(void *arg)
+{
+	MQA_READER *reader = (MQA_READER *)arg;
+	struct mqa_reader_pool *pool = reader->pool;
+	SaMsgQueueHandleT *handles = NULL;
+	uint32_t *counts = NULL;
+	uint32_t n_alloc = 0, n, i;
+	uint32_t idle_ms = 0;
+	MQA_READER_QUEUE **pq, *q;
+	struct timespec deadline;
+	struct timespec interval;
+
+	osaf_mutex_lock_ordie(&reader->lock);
+	while (!pool->stop) {
+		if (!mqa_reader_sweep(reader)) {
+			if (reader->kick) {
+				reader->kick = false;
+				continue;
+			}
+			if (reader->queues == NULL) {
+				idle_ms = 0;
+				pthread_cond_wait(&reader->cond, &reader->lock);
+				continue;
+			}
+			idle_ms = idle_ms ? idle_ms * 2 : 1;
+			if (idle_ms > pool->poll_ms)
+				idle_ms = pool->poll_ms;
+			osaf_millis_to_timespec(idle_ms, &interval);
+			osaf_clock_gettime(CLOCK_MONOTONIC, &deadline);
+			osaf_timespec_add(&deadline, &interval, &deadline);
+			if (!reader->kick)
+				pthread_cond_timedwait(&reader->cond,
+						       &reader->lock, &deadline);
+			reader->kick = false;
+			continue;
+		}
+		idle_ms = 0;
+
+		/* Post outside the reader lock, cb_lock is taken first */
+		if (reader->n_queues > n_alloc) {
+			n_alloc = reader->n_queues;
+			free(handles);
+			free(counts);
+			handles = malloc(n_alloc * sizeof(*handles));
+			counts = malloc(n_alloc * sizeof(*counts));
+			if (handles == NULL || counts == NULL)
+				osaf_abort(n_alloc);
+		}
+		n = 0;
+		for (q = reader->queues; q != NULL; q = q->next) {
+			if (q->pending && !q->gone) {
+				handles[n] = q->queueHandle;
+				counts[n++] = q->pending;
+			}
+			q->pending = 0;
+		}
+		osaf_mutex_unlock_ordie(&reader->lock);
+
+		for (i = 0; i < n; ++i) {
+			if (pool->post(handles[i], counts[i]))
+				reader->callbacks += counts[i];
+			else
+				counts[i] = 0; /* Closed, drop it below */
+		}
+
+		osaf_mutex_lock_ordie(&reader->lock);
+		for (i = 0; i < n; ++i) {
+			if (counts[i])
+				continue;
+			for (q = reader->queues; q != NULL; q = q->next)
+				if (q->queueHandle == handles[i])
+					q->gone = true;
+		}
+		for (pq = &reader->queues; (q = *pq) != NULL;) {
+			if (q->gone) {
+				TRACE("Listener of queue %llu dropped",
+				      q->queueHandle);
+				*pq = q->next;
+				--reader->n_queues;
+				free(q);
+			} else
+				pq = &q->next;
+		}
+	}
+	osaf_mutex_unlock_ordie(&reader->lock);
+
+	free(handles);
+	free(counts);
+	return NULL;
+}
+
+/****************************************************************************
+	Name          : mqa_reader_pool_new
+
+	Description   : Sets up a reader pool. The threads are started when they
+		  get their first queue.
+
+	Arguments     : n_readers - number of reader threads
+		  poll_ms - maximum sweep interval of an idle reader
+		  post - posts the receive callbacks of a queue
+
+	Return Values : The pool, or NULL
+******************************************************************************/
+MQA_READER_POOL *mqa_reader_pool_new(uint32_t n_readers, uint32_t poll_ms,
+				     MQA_READER_POST post)
+{
+	struct mqa_reader_pool *pool;
+	pthread_condattr_t attr;
+	uint32_t i;
+
+	if (n_readers == 0)
+		return NULL;
+	if (n_readers > MQA_READER_THREADS_MAX)
+		n_readers = MQA_READER_THREADS_MAX;
+	if (poll_ms == 0)
+		poll_ms = 1;
+
+	pool = calloc(1, sizeof(*pool));
+	if (pool == NULL)
+		return NULL;
+	pool->n_readers = n_readers;
+	pool->poll_ms = poll_ms;
+	pool->post = post;
+
+	pthread_condattr_init(&attr);
+	pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+	for (i = 0; i < n_readers; ++i) {
+		pthread_mutex_init(&pool->readers[i].lock, NULL);
+		pthread_cond_init(&pool->readers[i].cond, &attr);
+		pool->readers[i].pool = pool;
+	}
+	pthread_condattr_destroy(&attr);
+
+	TRACE("%u queue reader threads, max poll interval %u ms", n_readers,
+	      poll_ms);
+	return pool;
+}
+
+/****************************************************************************
+	Name          : mqa_reader_pool_delete
+
+	Description   : Stops the reader threads and frees the pool. Must be
+		  called without the locks taken by the post function.
+
+	Arguments     : pool - the pool, may be NULL
+******************************************************************************/
+void mqa_reader_pool_delete(MQA_READER_POOL *pool)
+{
+	MQA_READER *reader;
+	MQA_READER_QUEUE *q;
+	uint32_t i;
+
+	if (pool == NULL)
+		return;
+
+	for (i = 0; i < pool->n_readers; ++i) {
+		reader = &pool->readers[i];
+		osaf_mutex_lock_ordie(&reader->lock);
+		pool->stop = true;
+		pthread_cond_signal(&reader->cond);
+		osaf_mutex_unlock_ordie(&reader->lock);
+	}
+
+	for (i = 0; i < pool->n_readers; ++i) {
+		reader = &pool->readers[i];
+		if (reader->started)
+			pthread_join(reader->thread, NULL);
+		TRACE("Queue reader %u: %u queues, %" PRIu64
+		      " sweeps, %" PRIu64 " callbacks",
+		      i, reader->n_queues, reader->sweeps, reader->callbacks);
+		while ((q = reader->queues) != NULL) {
+			reader->queues = q->next;
+			free(q);
+		}
+		pthread_cond_destroy(&reader->cond);
+		pthread_mutex_destroy(&reader->lock);
+	}
+
+	free(pool);
+}
+
+/****************************************************************************
+	Name          : mqa_reader_pool_add
+
+	Description   : Hands the listener queue of an opened queue to the reader
+		  with the fewest queues.
+
+	Arguments     : pool - the pool
+		  queueHandle - the opened queue
+		  listenerHandle - its listener queue
+		  existing_msg_count - messages already in the queue
+
+	Return Values : NCSCC_RC_SUCCESS/NCSCC_RC_FAILURE
+******************************************************************************/
+uint32_t mqa_reader_pool_add(MQA_READER_POOL *pool,
+			     SaMsgQueueHandleT queueHandle,
+			     SaMsgQueueHandleT listenerHandle,
+			     uint32_t existing_msg_count)
+{
+	MQA_READER *reader = NULL;
+	MQA_READER_QUEUE *q;
+	uint32_t i;
+
+	/* A handle reused after a close may still be owned by a reader
+	 * that has not noticed the close yet */
+	for (i = 0; i < pool->n_readers; ++i) {
+		osaf_mutex_lock_ordie(&pool->readers[i].lock);
+		for (q = pool->readers[i].queues; q != NULL; q = q->next) {
+			if (q->queueHandle == queueHandle) {
+				q->listenerHandle = listenerHandle;
+				q->pending = existing_msg_count;
+				q->gone = false;
+				reader = &pool->readers[i];
+				break;
+			}
+		}
+		if (reader != NULL) {
+			reader->kick = true;
+			pthread_cond_signal(&reader->cond);
+		}
+		osaf_mutex_unlock_ordie(&pool->readers[i].lock);
+		if (reader != NULL)
+			return NCSCC_RC_SUCCESS;
+	}
+
+	reader = &pool->readers[0];
+	for (i = 1; i < pool->n_readers; ++i)
+		if (pool->readers[i].n_queues < reader->n_queues)
+			reader = &pool->readers[i];
+
+	q = calloc(1, sizeof(*q));
+	if (q == NULL)
+		return NCSCC_RC_FAILURE;
+	q->queueHandle = queueHandle;
+	q->listenerHandle = listenerHandle;
+	q->pending = existing_msg_count;
+
+	osaf_mutex_lock_ordie(&reader->lock);
+	if (!reader->started) {
+		if (pthread_create(&reader->thread, NULL, mqa_reader_thread,
+				   reader) != 0) {
+			osaf_mutex_unlock_ordie(&reader->lock);
+			free(q);
+			TRACE_4("Queue reader thread create failed");
+			return NCSCC_RC_FAILURE;
+		}
+		reader->started = true;
+	}
+	q->next = reader->queues;
+	reader->queues = q;
+	++reader->n_queues;
+	reader->kick = true;
+	pthread_cond_signal(&reader->cond);
+	osaf_mutex_unlock_ordie(&reader->lock);
+
+	return NCSCC_RC_SUCCESS;
+}
@@ -0,0 +1,58 @@
+/*      -*- OpenSAF  -*-
+ *
+ * (C) Copyright 2017 The OpenSAF Foundation
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. This file and program are licensed
+ * under the GNU Lesser General Public License Version 2.1, February 1999.
+ * The complete license can be accessed from the following location:
+ * http://opensource.org/licenses/lgpl-license.php
+ * See the Copying file included with the OpenSAF distribution for full
+ * licensing terms.
+ *
+ */
+
+/*****************************************************************************
+
+  DESCRIPTION:
+
+  Multiplexed listener queue readers, see mqa_reader.c.
+
+******************************************************************************
+*/
+
+#ifndef MSG_AGENT_MQA_READER_H_
+#define MSG_AGENT_MQA_READER_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "msg/saf/saMsg.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define MQA_READER_THREADS_MAX 16
+#define MQA_READER_POLL_MS_DEFAULT 10
+
+typedef struct mqa_reader_pool MQA_READER_POOL;
+
+/* Posts 'count' receive callbacks for the queue, returns false when the
+ * queue is closed, for the reader to drop it. Called without reader locks. */
+typedef bool (*MQA_READER_POST)(SaMsgQueueHandleT queueHandle,
+                                uint32_t count);
+
+MQA_READER_POOL *mqa_reader_pool_new(uint32_t n_readers, uint32_t poll_ms,
+                                     MQA_READER_POST post);
+void mqa_reader_pool_delete(MQA_READER_POOL *pool);
+uint32_t mqa_reader_pool_add(MQA_READER_POOL *pool,
+                             SaMsgQueueHandleT queueHandle,
+                             SaMsgQueueHandleT listenerHandle,
+                             uint32_t existing_msg_count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // MSG_AGENT_MQA_READER_H_
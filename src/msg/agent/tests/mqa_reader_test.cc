@@ -0,0 +1,193 @@
+/*      -*- OpenSAF  -*-
+ *
+ * (C) Copyright 2017 The OpenSAF Foundation
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. This file and program are licensed
+ * under the GNU Lesser General Public License Version 2.1, February 1999.
+ * The complete license can be accessed from the following location:
+ * http://opensource.org/licenses/lgpl-license.php
+ * See the Copying file included with the OpenSAF distribution for full
+ * licensing terms.
+ *
+ */
+
+#include <sys/ipc.h>
+#include <sys/msg.h>
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <set>
+#include <vector>
+#include "base/ncsgl_defs.h"
+#include "gtest/gtest.h"
+#include "msg/agent/mqa_reader.h"
+
+namespace {
+
+// Records the callbacks posted by the readers, the MQA_CB of the test
+struct Posted {
+  std::mutex lock;
+  std::condition_variable cond;
+  std::map<SaMsgQueueHandleT, uint32_t> counts;
+  std::set<SaMsgQueueHandleT> closed;
+};
+
+Posted* posted;
+
+bool Post(SaMsgQueueHandleT queueHandle, uint32_t count) {
+  std::lock_guard<std::mutex> guard(posted->lock);
+  if (posted->closed.count(queueHandle) != 0) return false;
+  posted->counts[queueHandle] += count;
+  posted->cond.notify_all();
+  return true;
+}
+
+class MqaReaderTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    posted = new Posted;
+    pool_ = nullptr;
+  }
+
+  void TearDown() override {
+    mqa_reader_pool_delete(pool_);
+    for (int id : listeners_) msgctl(id, IPC_RMID, nullptr);
+    delete posted;
+  }
+
+  // A listener queue, as created by the MQND
+  SaMsgQueueHandleT Listener() {
+    int id = msgget(IPC_PRIVATE, 0600 | IPC_CREAT);
+    EXPECT_NE(id, -1);
+    listeners_.push_back(id);
+    return id;
+  }
+
+  // The 1-byte indicator the MQND writes for each message
+  static void Indicate(SaMsgQueueHandleT listener, int n) {
+    struct {
+      long mtype;
+      char data[1];
+    } msg = {1, {'A'}};
+    for (int i = 0; i < n; ++i)
+      ASSERT_EQ(msgsnd(listener, &msg, sizeof(msg.data), IPC_NOWAIT), 0);
+  }
+
+  static uint32_t Pending(SaMsgQueueHandleT listener) {
+    struct msqid_ds buf;
+    if (msgctl(listener, IPC_STAT, &buf) != 0) return 0;
+    return buf.msg_qnum;
+  }
+
+  // Waits until the callbacks posted for each queue reach the expected count
+  static bool WaitFor(
+      const std::map<SaMsgQueueHandleT, uint32_t>& expected) {
+    std::unique_lock<std::mutex> guard(posted->lock);
+    return posted->cond.wait_for(guard, std::chrono::seconds(5), [&] {
+      for (const auto& e : expected) {
+        auto it = posted->counts.find(e.first);
+        uint32_t n = it == posted->counts.end() ? 0 : it->second;
+        if (n < e.second) return false;
+      }
+      return true;
+    });
+  }
+
+  MQA_READER_POOL* pool_;
+  std::vector<int> listeners_;
+};
+
+TEST_F(MqaReaderTest, NoReadersGivesNoPool) {
+  EXPECT_EQ(mqa_reader_pool_new(0, 10, Post), nullptr);
+  mqa_reader_pool_delete(nullptr);
+}
+
+TEST_F(MqaReaderTest, PostsExistingMessagesAndIndicators) {
+  pool_ = mqa_reader_pool_new(1, 5, Post);
+  ASSERT_NE(pool_, nullptr);
+  SaMsgQueueHandleT listener = Listener();
+
+  ASSERT_EQ(mqa_reader_pool_add(pool_, 100, listener, 3), NCSCC_RC_SUCCESS);
+  EXPECT_TRUE(WaitFor({{100, 3}}));
+
+  Indicate(listener, 5);
+  EXPECT_TRUE(WaitFor({{100, 8}}));
+  EXPECT_EQ(Pending(listener), 0u);
+}
+
+TEST_F(MqaReaderTest, MultiplexesQueuesOverFewerReaders) {
+  pool_ = mqa_reader_pool_new(2, 5, Post);
+  ASSERT_NE(pool_, nullptr);
+
+  const SaMsgQueueHandleT kQueues = 9;
+  std::map<SaMsgQueueHandleT, uint32_t> expected;
+  std::vector<SaMsgQueueHandleT> listeners;
+  for (SaMsgQueueHandleT h = 1; h <= kQueues; ++h) {
+    listeners.push_back(Listener());
+    ASSERT_EQ(mqa_reader_pool_add(pool_, h, listeners.back(), 0),
+              NCSCC_RC_SUCCESS);
+  }
+  // More than a sweep burst on some queues, none on others
+  for (SaMsgQueueHandleT h = 1; h <= kQueues; ++h) {
+    uint32_t n = (h % 3) * 50;
+    Indicate(listeners[h - 1], n);
+    expected[h] = n;
+  }
+  ASSERT_TRUE(WaitFor(expected));
+
+  // Nothing is posted twice or for the wrong queue
+  std::lock_guard<std::mutex> guard(posted->lock);
+  for (const auto& e : expected) {
+    auto it = posted->counts.find(e.first);
+    uint32_t n = it == posted->counts.end() ? 0 : it->second;
+    EXPECT_EQ(n, e.second) << "queue " << e.first;
+  }
+}
+
+TEST_F(MqaReaderTest, DropsClosedQueue) {
+  pool_ = mqa_reader_pool_new(1, 5, Post);
+  ASSERT_NE(pool_, nullptr);
+  SaMsgQueueHandleT closed = Listener();
+  SaMsgQueueHandleT open = Listener();
+  ASSERT_EQ(mqa_reader_pool_add(pool_, 1, closed, 0), NCSCC_RC_SUCCESS);
+  ASSERT_EQ(mqa_reader_pool_add(pool_, 2, open, 0), NCSCC_RC_SUCCESS);
+
+  {
+    std::lock_guard<std::mutex> guard(posted->lock);
+    posted->closed.insert(1);
+  }
+  Indicate(closed, 1);
+  Indicate(open, 1);
+  ASSERT_TRUE(WaitFor({{2, 1}}));
+
+  // The closed queue is no longer read, its indicators stay put
+  Indicate(closed, 2);
+  Indicate(open, 1);
+  ASSERT_TRUE(WaitFor({{2, 2}}));
+  EXPECT_EQ(Pending(closed), 2u);
+  std::lock_guard<std::mutex> guard(posted->lock);
+  EXPECT_EQ(posted->counts.count(1), 0u);
+}
+
+TEST_F(MqaReaderTest, DropsRemovedListenerAndReusesHandle) {
+  pool_ = mqa_reader_pool_new(1, 5, Post);
+  ASSERT_NE(pool_, nullptr);
+  SaMsgQueueHandleT listener = Listener();
+  ASSERT_EQ(mqa_reader_pool_add(pool_, 7, listener, 0), NCSCC_RC_SUCCESS);
+  Indicate(listener, 1);
+  ASSERT_TRUE(WaitFor({{7, 1}}));
+
+  // The MQND removes the listener queue when the queue is closed
+  msgctl(listener, IPC_RMID, nullptr);
+
+  // The handle is reused for a reopened queue with a new listener
+  SaMsgQueueHandleT reopened = Listener();
+  ASSERT_EQ(mqa_reader_pool_add(pool_, 7, reopened, 2), NCSCC_RC_SUCCESS);
+  Indicate(reopened, 4);
+  EXPECT_TRUE(WaitFor({{7, 7}}));
+}
+
+}  // namespace
@@ -3670,7 +3670,7 @@ void mqsv_it_qgrp_create_10()
 	int result;
 
 	mqsv_print_testcase(
-	    " \n\n ***** saMsgQueueGroupCreate with a group policy not supported *****\n");
+	    " \n\n ***** saMsgQueueGroupCreate with the local best queue policy *****\n");
 
 	result = tet_test_msgInitialize(MSG_INIT_SUCCESS_T, TEST_CONFIG_MODE);
 	if (result != TET_PASS)
@@ -1606,7 +1606,7 @@ char *API_Mqsv_GroupCreate_resultstring[] = {
 	[MSG_GROUP_CREATE_LOCAL_RR_T] =
 	    "saMsgQueueGroupCreate with Policy not supported - Local Round Robin",
 	[MSG_GROUP_CREATE_LCL_BSTQ_NOT_SUPP_T] =
-	    "saMsgQueueGroupCreate with Policy not supported - Local Best Queue",
+	    "saMsgQueueGroupCreate with Policy - Local Best Queue",
 	[MSG_GROUP_CREATE_BROADCAST_T] =
 	    "saMsgQueueGroupCreate with Policy not supported - Broadcast",
 	[MSG_GROUP_CREATE_SUCCESS_T] =
@@ -1649,7 +1649,7 @@ struct SafMsgGroupCreate API_Mqsv_GroupCreate[] = {
 					 SA_AIS_OK},
 	[MSG_GROUP_CREATE_LCL_BSTQ_NOT_SUPP_T] =
 	    {&gl_mqa_env.msg_hdl1, &gl_mqa_env.qgroup1,
-	     SA_MSG_QUEUE_GROUP_LOCAL_BEST_QUEUE, SA_AIS_ERR_NOT_SUPPORTED},
+	     SA_MSG_QUEUE_GROUP_LOCAL_BEST_QUEUE, SA_AIS_OK},
 	[MSG_GROUP_CREATE_BROADCAST_T] = {&gl_mqa_env.msg_hdl1,
 					  &gl_mqa_env.qgroup1,
 					  SA_MSG_QUEUE_GROUP_BROADCAST,
@@ -1669,7 +1669,7 @@ struct SafMsgGroupCreate API_Mqsv_GroupCreate[] = {
 	[MSG_GROUP_CREATE_ERR_EXIST3_T] = {&gl_mqa_env.msg_hdl1,
 					   &gl_mqa_env.qgroup1,
 					   SA_MSG_QUEUE_GROUP_LOCAL_BEST_QUEUE,
-					   SA_AIS_ERR_NOT_SUPPORTED},
+					   SA_AIS_ERR_EXIST},
 	[MSG_GROUP_CREATE_ERR_EXIST4_T] = {&gl_mqa_env.msg_hdl1,
 					   &gl_mqa_env.qgroup1,
 					   SA_MSG_QUEUE_GROUP_BROADCAST,
@@ -73,6 +73,7 @@
 
 /* From /leap/os_svcs/leap_basic/inc */
 #include "msg/common/mqsv_common.h"
+#include "msg/common/mqsv_shmq.h"
 #include "base/ncs_util.h"
 
 #endif  // MSG_COMMON_MQSV_H_
@@ -38,6 +38,10 @@
  */
 #include "msg/common/mqsv.h"
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
 ASAPi_CB asapi; /* Global ASAPi Control Block */
 
 /******************************** LOCAL ROUTINES *****************************/
@@ -267,7 +271,8 @@ static uint32_t asapi_dest_get(ASAPi_DEST_INFO *dinfo)
 		ASAPi_QUEUE_INFO *pQelmLast = pNode->info.ginfo.plaQueue;
 
 		pNode->info.ginfo.pQueue = 0;
-		asapi_queue_select(&(pNode->info.ginfo));
+		asapi_queue_select(&(pNode->info.ginfo),
+				   SA_MSG_MESSAGE_LOWEST_PRIORITY);
 		if (pNode->info.ginfo.pQueue) {
 			if (pNode->info.ginfo.pQueue->param.is_mqnd_down ==
 			    true) {
@@ -723,6 +728,7 @@ static uint32_t asapi_grp_upd(ASAPi_GROUP_INFO *pGrp, ASAPi_OBJECT_INFO *pInfo,
 
 			/* Update the parameters */
 			pQinfo->param = pInfo->qparam[idx];
+			pQinfo->stats_ix = 0;
 
 			if (m_NCS_NODE_ID_FROM_MDS_DEST(asapi.my_dest) ==
 			    m_NCS_NODE_ID_FROM_MDS_DEST(pQinfo->param.addr)) {
@@ -842,6 +848,7 @@ static uint32_t asapi_grp_upd(ASAPi_GROUP_INFO *pGrp, ASAPi_OBJECT_INFO *pInfo,
 
 				/* Update the parameters */
 				pQinfo->param = pInfo->qparam[idx];
+				pQinfo->stats_ix = 0;
 
 				if (m_NCS_NODE_ID_FROM_MDS_DEST(
 					asapi.my_dest) ==
@@ -970,6 +977,187 @@ static uint32_t asapi_cpy_track_info(ASAPi_GROUP_INFO *pGinfo,
 	return NCSCC_RC_SUCCESS;
 } /* End of asapi_cpy_track_info() */
 
+/* Queue statistics of the local MQND, mapped on first use */
+static pthread_mutex_t asapi_qstats_lock = PTHREAD_MUTEX_INITIALIZER;
+static const uint8_t *asapi_qstats_base; /* First MQND_QUEUE_CKPT_INFO */
+static MQND_SHM_VERSION asapi_qstats_layout;
+static uint32_t asapi_qstats_count;
+static time_t asapi_qstats_retry; /* Next attempt to map, after a failure */
+
+/****************************************************************************\
+   PROCEDURE NAME :  asapi_qstats_map
+
+   DESCRIPTION    :  Maps the shared memory where the MQND keeps the queue
+		     statistics, read only. Failures are retried at most every
+		     ten seconds.
+
+   RETURNS        :  The first queue entry or NULL
+\****************************************************************************/
+static const uint8_t *asapi_qstats_map(void)
+{
+	const uint8_t *base = NULL;
+	struct stat st;
+	void *addr;
+	int fd;
+
+	pthread_mutex_lock(&asapi_qstats_lock);
+	if (asapi_qstats_base != NULL) {
+		base = asapi_qstats_base;
+		goto done;
+	}
+	if (time(NULL) < asapi_qstats_retry)
+		goto done;
+	asapi_qstats_retry = time(NULL) + 10;
+
+	fd = shm_open(MQSV_MQND_SHM_NAME, O_RDONLY, 0);
+	if (fd < 0) {
+		TRACE("shm_open %s failed: %s", MQSV_MQND_SHM_NAME,
+		      strerror(errno));
+		goto done;
+	}
+	if (fstat(fd, &st) != 0 || st.st_size <= sizeof(MQND_SHM_VERSION)) {
+		close(fd);
+		goto done;
+	}
+	addr = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+	if (addr == MAP_FAILED)
+		goto done;
+
+	memcpy(&asapi_qstats_layout, addr, sizeof(asapi_qstats_layout));
+	if (asapi_qstats_layout.ckpt_info_size == 0) {
+		/* Written by an MQND that does not describe its layout */
+		munmap(addr, st.st_size);
+		goto done;
+	}
+	asapi_qstats_count = (st.st_size - sizeof(MQND_SHM_VERSION)) /
+			     asapi_qstats_layout.ckpt_info_size;
+	base = (const uint8_t *)addr + sizeof(MQND_SHM_VERSION);
+	__atomic_store_n(&asapi_qstats_base, base, __ATOMIC_RELEASE);
+
+done:
+	pthread_mutex_unlock(&asapi_qstats_lock);
+	return base;
+}
+
+/* The statistics in entry ix, if it holds the queue hdl */
+static const MQND_QUEUE_STATS_SHM *
+asapi_qstats_entry(const uint8_t *base, uint32_t ix, uint32_t hdl)
+{
+	const uint8_t *entry =
+	    base + (size_t)ix * asapi_qstats_layout.ckpt_info_size;
+	const uint32_t *valid =
+	    (const uint32_t *)(entry + asapi_qstats_layout.valid_offset);
+
+	/* The entry starts with the queue handle */
+	if (*valid == 0 || (uint32_t)(*(const SaMsgQueueHandleT *)entry) != hdl)
+		return NULL;
+	return (const MQND_QUEUE_STATS_SHM *)(entry +
+					      asapi_qstats_layout.stats_offset);
+}
+
+/****************************************************************************\
+   PROCEDURE NAME :  asapi_qstats_get
+
+   DESCRIPTION    :  Finds the statistics of a local queue. The MQND updates
+		     them without a lock, they are only good for an estimate.
+
+   ARGUMENTS      :  pQelm - the queue
+
+   RETURNS        :  The statistics or NULL
+\****************************************************************************/
+static const MQND_QUEUE_STATS_SHM *asapi_qstats_get(ASAPi_QUEUE_INFO *pQelm)
+{
+	const uint8_t *base =
+	    __atomic_load_n(&asapi_qstats_base, __ATOMIC_ACQUIRE);
+	const MQND_QUEUE_STATS_SHM *stats;
+	uint32_t ix;
+
+	if (base == NULL && (base = asapi_qstats_map()) == NULL)
+		return NULL;
+
+	/* The entry of a queue stays the same while the queue is open */
+	if (pQelm->stats_ix != 0 && pQelm->stats_ix <= asapi_qstats_count) {
+		stats = asapi_qstats_entry(base, pQelm->stats_ix - 1,
+					   pQelm->param.hdl);
+		if (stats)
+			return stats;
+	}
+
+	for (ix = 0; ix < asapi_qstats_count; ix++) {
+		stats = asapi_qstats_entry(base, ix, pQelm->param.hdl);
+		if (stats) {
+			pQelm->stats_ix = ix + 1;
+			return stats;
+		}
+	}
+	pQelm->stats_ix = 0;
+	return NULL;
+}
+
+/****************************************************************************\
+   PROCEDURE NAME :  asapi_best_queue_select
+
+   DESCRIPTION    :  Selects the local queue with the most free space for
+		     the priority, according to the MQND statistics. Queues
+		     with the same free space are taken in turn.
+
+   ARGUMENTS      :  pGinfo - Group information
+		     priority - Priority of the message
+
+   RETURNS        :  The queue, or NULL if there is no local queue or no
+		     statistics for one
+\****************************************************************************/
+static ASAPi_QUEUE_INFO *asapi_best_queue_select(ASAPi_GROUP_INFO *pGinfo,
+						 SaUint8T priority)
+{
+	ASAPi_QUEUE_INFO *pQelm, *pBest = NULL;
+	const MQND_QUEUE_STATS_SHM *stats;
+	MQSV_SHMQ_STATS shmq_stats;
+	SaSizeT used, avail, best_avail = 0;
+	uint32_t q_cnt;
+	NCS_Q_ITR itr;
+
+	if (pGinfo->lcl_qcnt == 0 || priority > SA_MSG_MESSAGE_LOWEST_PRIORITY)
+		return NULL;
+
+	itr.state = pGinfo->plaQueue;
+	for (q_cnt = pGinfo->qlist.count; q_cnt > 0; q_cnt--) {
+		pQelm = (ASAPi_QUEUE_INFO *)ncs_queue_get_next(&pGinfo->qlist,
+							       &itr);
+		if (!pQelm) {
+			itr.state = 0;
+			pQelm = (ASAPi_QUEUE_INFO *)ncs_queue_get_next(
+			    &pGinfo->qlist, &itr);
+		}
+		if ((m_NCS_NODE_ID_FROM_MDS_DEST(asapi.my_dest) !=
+		     m_NCS_NODE_ID_FROM_MDS_DEST(pQelm->param.addr)) ||
+		    (pQelm->param.owner == MQSV_QUEUE_OWN_STATE_ORPHAN) ||
+		    pQelm->param.is_mqnd_down)
+			continue;
+
+		if (m_MQSV_IS_SHMQ(pQelm->param.hdl)) {
+			/* Agents send to it without the MQND, ask the queue */
+			if (mqsv_shmq_stats_get(pQelm->param.hdl, &shmq_stats,
+						false) != NCSCC_RC_SUCCESS)
+				return NULL;
+			used = shmq_stats.used[priority];
+		} else {
+			if ((stats = asapi_qstats_get(pQelm)) == NULL)
+				return NULL;
+			used = stats->saMsgQueueUsage[priority].queueUsed;
+		}
+		avail = (used < pQelm->param.size[priority])
+			    ? pQelm->param.size[priority] - used
+			    : 0;
+		if (!pBest || avail > best_avail) {
+			pBest = pQelm;
+			best_avail = avail;
+		}
+	}
+	return pBest;
+}
+
 /****************************************************************************\
    PROCEDURE NAME :  asapi_queue_select
 
@@ -978,14 +1166,17 @@ static uint32_t asapi_cpy_track_info(ASAPi_GROUP_INFO *pGinfo,
 		     selection policy is multicast then it selects all the
 		     queues in the list otherwise if the selection policy is
 		     unicast then it selects the queue in round robin manner.
+		     The local best queue policy selects on the free space of
+		     the local queues, and falls back to local round robin.
 
    ARGUMENTS      :  info - Group information
-		     dest - destination information
+		     priority - Priority of the message
 
    RETURNS        :  SUCCESS - All went well
 		     FAILURE - internal processing didn't like something
 \****************************************************************************/
-uint32_t asapi_queue_select(ASAPi_GROUP_INFO *pGinfo)
+uint32_t asapi_queue_select(ASAPi_GROUP_INFO *pGinfo,
+			    SaUint8T priority)
 {
 	ASAPi_QUEUE_INFO *pQelm = 0;
 	NCS_Q_ITR itr;
@@ -1034,6 +1225,12 @@ uint32_t asapi_queue_select(ASAPi_GROUP_INFO *pGinfo)
 		}
 		break;
 
+	case SA_MSG_QUEUE_GROUP_LOCAL_BEST_QUEUE:
+		pQelm = asapi_best_queue_select(pGinfo, priority);
+		if (pQelm)
+			break;
+		/* Fall through */
+
 	case SA_MSG_QUEUE_GROUP_LOCAL_ROUND_ROBIN:
 		do {
 			pQelm = (ASAPi_QUEUE_INFO *)ncs_queue_get_next(
@@ -1095,10 +1292,6 @@ uint32_t asapi_queue_select(ASAPi_GROUP_INFO *pGinfo)
 
 		break;
 
-	case SA_MSG_QUEUE_GROUP_LOCAL_BEST_QUEUE:
-		pGinfo->pQueue = 0;
-		break;
-
 	case SA_MSG_QUEUE_GROUP_BROADCAST:
 		pQelm = (ASAPi_QUEUE_INFO *)ncs_queue_get_next(&pGinfo->qlist,
 							       &itr);
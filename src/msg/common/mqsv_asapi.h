@@ -128,6 +128,8 @@ typedef struct asapi_queue_param {
 typedef struct asapi_queue_info {
   NCS_QELEM qelm;          /* Must be first in struct, Queue element */
   ASAPi_QUEUE_PARAM param; /* Queue parameters */
+  uint32_t stats_ix; /* 1 + index of the queue in the MQND shared memory,
+                        0 if not known */
 } ASAPi_QUEUE_INFO;
 
 /*****************************************************************************\
@@ -421,7 +423,7 @@ uint32_t asapi_msg_cpy(ASAPi_MSG_INFO *, ASAPi_MSG_INFO **);
         These routines are to be only used by ASAPi & MQSv internally
 \*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
 void asapi_msg_free(ASAPi_MSG_INFO **);
-uint32_t asapi_queue_select(ASAPi_GROUP_INFO *);
+uint32_t asapi_queue_select(ASAPi_GROUP_INFO *, SaUint8T);
 
 /*
  * m_ASAPi_DBG_SINK
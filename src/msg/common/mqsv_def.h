@@ -56,6 +56,27 @@ typedef enum {
   MSG_QUEUE_AVAILABLE = 2
 } SaMsgQueueSendingStateT;
 
+/* The MQND checkpoints its queues in shared memory, a MQND_SHM_VERSION
+   followed by an array of MQND_QUEUE_CKPT_INFO. The MQA reads the queue
+   statistics from it for SA_MSG_QUEUE_GROUP_LOCAL_BEST_QUEUE. */
+#define MQSV_MQND_SHM_NAME "NCS_MQND_QUEUE_CKPT_INFO"
+
+typedef struct queue_stats_shm {
+  SaMsgQueueUsageT saMsgQueueUsage[SA_MSG_MESSAGE_LOWEST_PRIORITY + 1];
+  SaSizeT totalQueueUsed;
+  SaUint32T totalNumberOfMessages;
+} MQND_QUEUE_STATS_SHM;
+
+typedef struct mqnd_shm_version {
+  uint16_t shm_version; /* Added to provide support for SAF Inservice upgrade
+                           facilty */
+  /* Layout of MQND_QUEUE_CKPT_INFO for readers outside the MQND, which
+     starts with the queue handle. Zero if written by an older MQND. */
+  uint16_t ckpt_info_size; /* Size of an entry */
+  uint16_t stats_offset;   /* Offset of QueueStatsShm */
+  uint16_t valid_offset;   /* Offset of valid */
+} MQND_SHM_VERSION;
+
 typedef struct mqsv_send_info {
   MDS_SVC_ID to_svc;      /* The service at the destination */
   MDS_SENDTYPES stype;    /* Send type */
@@ -0,0 +1,989 @@
+/*      -*- OpenSAF  -*-
+ *
+ * (C) Copyright 2017 The OpenSAF Foundation
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. This file and program are licensed
+ * under the GNU Lesser General Public License Version 2.1, February 1999.
+ * The complete license can be accessed from the following location:
+ * http://opensource.org/licenses/lgpl-license.php
+ * See the Copying file included with the OpenSAF distribution for full
+ * licensing terms.
+ *
+ */
+
+/*****************************************************************************
+..............................................................................
+
+..............................................................................
+
+  DESCRIPTION:
+
+  Message queues in POSIX shared memory, see mqsv_shmq.h.
+
+  Object layout: MQSV_SHMQ_HDR, then the rings. Each ring holds records of
+  a MQSV_SHMQ_REC header and the message data padded to 8 bytes. A record
+  never wraps; when it does not fit at the end of the ring, the end is
+  skipped, marked with a MQSV_SHMQ_REC_WRAP record if there is room for
+  one. A ring that is too small for a new record is moved to the end of
+  the object with twice the size.
+
+  A process maps the header on its own, and the whole object separately.
+  The header mapping never moves, since threads wait on its condition
+  variable. The object mapping is replaced, under the queue lock, when the
+  object has grown past it, so the rings are only reached through it with
+  the queue lock held.
+
+  The header holds a robust process shared mutex and condition variable.
+  A process that dies in a call leaves the mutex to the next caller. The
+  object has the mode of a SysV queue, 0644, so only processes of the user
+  of the MQND can map it.
+..............................................................................
+
+  FUNCTIONS INCLUDED in this module:
+
+  mqsv_shmq_create
+  mqsv_shmq_send
+  mqsv_shmq_direct_send
+  mqsv_shmq_direct_set
+  mqsv_shmq_listener_set
+  mqsv_shmq_stats_get
+  mqsv_posix_mq
+
+******************************************************************************
+*/
+
+#include "msg/common/mqsv.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+#include "base/logtrace.h"
+
+#define MQSV_SHMQ_MAGIC 0x4d515351 /* "MQSQ" */
+#define MQSV_SHMQ_VERSION 2
+#define MQSV_SHMQ_REC_WRAP 0xffffffffu
+#define MQSV_SHMQ_NAME_FMT "/opensaf_mqsv_%08x"
+#define MQSV_SHMQ_NAME_LEN 32
+#define MQSV_SHMQ_CACHE_BUCKETS 64
+#define MQSV_SHMQ_MODE (S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH)
+
+/* Message type of SAF priority 0 */
+#define MQSV_SHMQ_PRIO_TYPE 3
+
+/* Bytes of a MQSV_MESSAGE in front of the message data */
+#define MQSV_SHMQ_MSG_HDR_LEN offsetof(MQSV_MESSAGE, info.msg.message.data)
+
+#define m_MQSV_SHMQ_ALIGN(n) (((n) + 7u) & ~7u)
+
+typedef struct mqsv_shmq_rec {
+	uint32_t len;	/* Message bytes, or MQSV_SHMQ_REC_WRAP */
+	uint32_t usage; /* SAF message size counted in the priority usage */
+	uint32_t prio;  /* SAF priority of the usage */
+	uint32_t pad;
+} MQSV_SHMQ_REC;
+
+typedef struct mqsv_shmq_ring {
+	uint64_t off;   /* From the start of the object */
+	uint32_t size;  /* Bytes */
+	uint32_t head;  /* Oldest record */
+	uint32_t tail;  /* Where the next record goes */
+	uint32_t used;  /* Record bytes, including a skipped end */
+	uint32_t count; /* Records */
+	uint32_t pad;
+} MQSV_SHMQ_RING;
+
+typedef struct mqsv_shmq_hdr {
+	uint32_t magic;
+	uint32_t version;
+	pthread_mutex_t lock;
+	pthread_cond_t cond; /* Broadcast on every send and on removal */
+	uint32_t removed;    /* The MQND destroyed the queue */
+	uint32_t qbytes;     /* Limit of cbytes, as msg_qbytes */
+	uint32_t cbytes;     /* Message bytes in the queue */
+	uint32_t qnum;       /* Messages in the queue */
+	uint32_t stime;      /* Time of the last send */
+	uint32_t direct;     /* Agents may send without the MQND */
+	uint32_t listener;   /* Listener queue to notify, 0 if none */
+	uint32_t pad;
+	uint32_t quota[MQSV_SHMQ_NUM_PRIOS]; /* Size of each priority */
+	MQSV_SHMQ_STATS stats;
+	uint64_t obj_size; /* Current size of the object */
+	MQSV_SHMQ_RING ring[MQSV_SHMQ_NUM_TYPES];
+} MQSV_SHMQ_HDR;
+
+/* A queue mapped in this process */
+typedef struct mqsv_shmq_map {
+	NCS_OS_POSIX_MQD hdl;
+	int fd;
+	MQSV_SHMQ_HDR *hdr; /* Header mapping, never moves */
+	uint8_t *base;	    /* Object mapping, under the queue lock */
+	uint64_t mapped;    /* Bytes of the object mapping */
+	uint32_t users;     /* Calls in progress */
+	bool removed;	    /* Unmap when the last call returns */
+	struct mqsv_shmq_map *next;
+} MQSV_SHMQ_MAP;
+
+static pthread_mutex_t mqsv_shmq_cache_lock = PTHREAD_MUTEX_INITIALIZER;
+static MQSV_SHMQ_MAP *mqsv_shmq_cache[MQSV_SHMQ_CACHE_BUCKETS];
+
+static void mqsv_shmq_name(NCS_OS_POSIX_MQD hdl, char *name)
+{
+	snprintf(name, MQSV_SHMQ_NAME_LEN, MQSV_SHMQ_NAME_FMT,
+		 hdl & ~MQSV_SHMQ_HDL_FLAG);
+}
+
+static int mqsv_shmq_lock(MQSV_SHMQ_HDR *hdr)
+{
+	int rc = pthread_mutex_lock(&hdr->lock);
+
+	if (rc == EOWNERDEAD) {
+		LOG_NO("Recovered queue lock of a dead process");
+		pthread_mutex_consistent(&hdr->lock);
+		rc = 0;
+	}
+	return rc;
+}
+
+static void mqsv_shmq_unlock(MQSV_SHMQ_HDR *hdr)
+{
+	pthread_mutex_unlock(&hdr->lock);
+}
+
+static int mqsv_shmq_wait(MQSV_SHMQ_HDR *hdr)
+{
+	int rc = pthread_cond_wait(&hdr->cond, &hdr->lock);
+
+	if (rc == EOWNERDEAD) {
+		pthread_mutex_consistent(&hdr->lock);
+		rc = 0;
+	}
+	return rc;
+}
+
+/****************************************************************************
+ * Name          : mqsv_shmq_remap
+ *
+ * Description   : Maps the object again if it has grown past the object
+ *                 mapping of this process. Called with the queue lock held.
+ *
+ * Arguments     : map - the queue
+ *
+ * Return Values : NCSCC_RC_SUCCESS/NCSCC_RC_FAILURE
+ *****************************************************************************/
+static uint32_t mqsv_shmq_remap(MQSV_SHMQ_MAP *map)
+{
+	uint64_t size = map->hdr->obj_size;
+	void *addr;
+
+	if (size <= map->mapped)
+		return NCSCC_RC_SUCCESS;
+
+	addr = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, map->fd, 0);
+	if (addr == MAP_FAILED) {
+		LOG_ER("mmap of queue %x failed: %s", map->hdl,
+		       strerror(errno));
+		errno = ENOSPC;
+		return NCSCC_RC_FAILURE;
+	}
+	munmap(map->base, map->mapped);
+	map->base = addr;
+	map->mapped = size;
+	return NCSCC_RC_SUCCESS;
+}
+
+static void mqsv_shmq_unmap(MQSV_SHMQ_MAP *map)
+{
+	munmap(map->base, map->mapped);
+	munmap(map->hdr, sizeof(MQSV_SHMQ_HDR));
+	close(map->fd);
+	free(map);
+}
+
+/****************************************************************************
+ * Name          : mqsv_shmq_map_get
+ *
+ * Description   : Finds or maps the queue, and counts the caller as a user
+ *                 of the mapping. Every successful call is paired with a
+ *                 call to mqsv_shmq_map_put().
+ *
+ * Arguments     : hdl - shared memory queue handle
+ *
+ * Return Values : the mapping or NULL, with errno set
+ *****************************************************************************/
+static MQSV_SHMQ_MAP *mqsv_shmq_map_get(NCS_OS_POSIX_MQD hdl)
+{
+	MQSV_SHMQ_MAP **bucket =
+	    &mqsv_shmq_cache[hdl % MQSV_SHMQ_CACHE_BUCKETS];
+	MQSV_SHMQ_MAP *map;
+	char name[MQSV_SHMQ_NAME_LEN];
+	MQSV_SHMQ_HDR *hdr;
+	struct stat st;
+	void *addr;
+	int fd;
+
+	pthread_mutex_lock(&mqsv_shmq_cache_lock);
+	for (map = *bucket; map != NULL; map = map->next) {
+		if (map->hdl == hdl && !map->removed) {
+			++map->users;
+			goto done;
+		}
+	}
+
+	mqsv_shmq_name(hdl, name);
+	fd = shm_open(name, O_RDWR, 0);
+	if (fd < 0) {
+		/* A queue that is not there is gone, as for SysV */
+		if (errno != EACCES)
+			errno = EIDRM;
+		goto done;
+	}
+	if (fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(*hdr)) {
+		close(fd);
+		errno = EINVAL;
+		goto done;
+	}
+	hdr = mmap(NULL, sizeof(*hdr), PROT_READ | PROT_WRITE, MAP_SHARED, fd,
+		   0);
+	if (hdr == MAP_FAILED) {
+		close(fd);
+		goto done;
+	}
+	if (__atomic_load_n(&hdr->magic, __ATOMIC_ACQUIRE) !=
+		MQSV_SHMQ_MAGIC ||
+	    hdr->version != MQSV_SHMQ_VERSION) {
+		LOG_ER("Queue %s has an unknown format", name);
+		munmap(hdr, sizeof(*hdr));
+		close(fd);
+		errno = EINVAL;
+		goto done;
+	}
+	addr = mmap(NULL, st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd,
+		    0);
+	if (addr == MAP_FAILED) {
+		munmap(hdr, sizeof(*hdr));
+		close(fd);
+		goto done;
+	}
+
+	map = calloc(1, sizeof(*map));
+	if (map == NULL) {
+		munmap(addr, st.st_size);
+		munmap(hdr, sizeof(*hdr));
+		close(fd);
+		errno = ENOMEM;
+		goto done;
+	}
+	map->hdl = hdl;
+	map->fd = fd;
+	map->hdr = hdr;
+	map->base = addr;
+	map->mapped = st.st_size;
+	map->users = 1;
+	map->next = *bucket;
+	*bucket = map;
+
+done:
+	pthread_mutex_unlock(&mqsv_shmq_cache_lock);
+	return map;
+}
+
+static void mqsv_shmq_map_put(MQSV_SHMQ_MAP *map)
+{
+	MQSV_SHMQ_MAP **pmap =
+	    &mqsv_shmq_cache[map->hdl % MQSV_SHMQ_CACHE_BUCKETS];
+
+	pthread_mutex_lock(&mqsv_shmq_cache_lock);
+	if (--map->users == 0 && map->removed) {
+		while (*pmap != map)
+			pmap = &(*pmap)->next;
+		*pmap = map->next;
+		mqsv_shmq_unmap(map);
+	}
+	pthread_mutex_unlock(&mqsv_shmq_cache_lock);
+}
+
+/* Called with the queue lock held, when the queue is seen removed */
+static void mqsv_shmq_forget(MQSV_SHMQ_MAP *map)
+{
+	pthread_mutex_lock(&mqsv_shmq_cache_lock);
+	map->removed = true;
+	pthread_mutex_unlock(&mqsv_shmq_cache_lock);
+}
+
+/* Maps and locks the queue, fails with EIDRM if it was destroyed */
+static MQSV_SHMQ_MAP *mqsv_shmq_enter(NCS_OS_POSIX_MQD hdl)
+{
+	MQSV_SHMQ_MAP *map;
+
+	if ((map = mqsv_shmq_map_get(hdl)) == NULL)
+		return NULL;
+
+	mqsv_shmq_lock(map->hdr);
+	if (map->hdr->removed) {
+		mqsv_shmq_forget(map);
+		errno = EIDRM;
+	} else if (mqsv_shmq_remap(map) == NCSCC_RC_SUCCESS) {
+		return map;
+	}
+	mqsv_shmq_unlock(map->hdr);
+	mqsv_shmq_map_put(map);
+	return NULL;
+}
+
+static void mqsv_shmq_leave(MQSV_SHMQ_MAP *map)
+{
+	mqsv_shmq_unlock(map->hdr);
+	mqsv_shmq_map_put(map);
+}
+
+static inline MQSV_SHMQ_REC *mqsv_shmq_rec(MQSV_SHMQ_MAP *map,
+					   MQSV_SHMQ_RING *ring, uint32_t pos)
+{
+	return (MQSV_SHMQ_REC *)(map->base + ring->off + pos);
+}
+
+/****************************************************************************
+ * Name          : mqsv_shmq_ring_first
+ *
+ * Description   : Skips a wrapped end, returns the oldest record.
+ *
+ * Return Values : the record or NULL if the ring is empty
+ *****************************************************************************/
+static MQSV_SHMQ_REC *mqsv_shmq_ring_first(MQSV_SHMQ_MAP *map,
+					   MQSV_SHMQ_RING *ring)
+{
+	if (ring->count == 0)
+		return NULL;
+	if (ring->size - ring->head < sizeof(MQSV_SHMQ_REC) ||
+	    mqsv_shmq_rec(map, ring, ring->head)->len == MQSV_SHMQ_REC_WRAP) {
+		ring->used -= ring->size - ring->head;
+		ring->head = 0;
+	}
+	return mqsv_shmq_rec(map, ring, ring->head);
+}
+
+static void mqsv_shmq_ring_pop(MQSV_SHMQ_HDR *hdr, MQSV_SHMQ_RING *ring,
+			       MQSV_SHMQ_REC *rec)
+{
+	uint32_t need = sizeof(MQSV_SHMQ_REC) + m_MQSV_SHMQ_ALIGN(rec->len);
+
+	if (rec->usage != 0 || rec->prio != 0) {
+		hdr->stats.used[rec->prio] -= rec->usage;
+		hdr->stats.num[rec->prio]--;
+	}
+	hdr->cbytes -= rec->len;
+	hdr->qnum--;
+
+	ring->head += need;
+	ring->used -= need;
+	if (--ring->count == 0)
+		ring->head = ring->tail = ring->used = 0;
+}
+
+/****************************************************************************
+ * Name          : mqsv_shmq_ring_reserve
+ *
+ * Description   : Finds room for a record of need bytes.
+ *
+ * Return Values : the position or -1 if the ring is too small
+ *****************************************************************************/
+static int64_t mqsv_shmq_ring_reserve(MQSV_SHMQ_MAP *map,
+				      MQSV_SHMQ_RING *ring, uint32_t need)
+{
+	uint32_t skip;
+
+	if (ring->used == 0)
+		ring->head = ring->tail = 0;
+	if (ring->used + need > ring->size)
+		return -1;
+
+	if (ring->tail > ring->head || ring->used == 0) {
+		if (ring->size - ring->tail >= need)
+			return ring->tail;
+		/* Skip the end of the ring, start over at 0 */
+		if (ring->head < need)
+			return -1;
+		skip = ring->size - ring->tail;
+		if (skip >= sizeof(MQSV_SHMQ_REC))
+			mqsv_shmq_rec(map, ring, ring->tail)->len =
+			    MQSV_SHMQ_REC_WRAP;
+		ring->used += skip;
+		ring->tail = 0;
+		return 0;
+	}
+
+	/* Wrapped, free space is between tail and head */
+	if (ring->head - ring->tail >= need)
+		return ring->tail;
+	return -1;
+}
+
+/****************************************************************************
+ * Name          : mqsv_shmq_ring_grow
+ *
+ * Description   : Moves a ring to the end of the object with room for at
+ *                 least need more bytes. The old space is not reused.
+ *
+ * Return Values : NCSCC_RC_SUCCESS/NCSCC_RC_FAILURE
+ *****************************************************************************/
+static uint32_t mqsv_shmq_ring_grow(MQSV_SHMQ_MAP *map, MQSV_SHMQ_RING *ring,
+				    uint32_t need)
+{
+	MQSV_SHMQ_HDR *hdr = map->hdr;
+	uint64_t size = 2 * (uint64_t)ring->size;
+	uint64_t off = hdr->obj_size;
+	uint32_t pos = 0, len;
+	MQSV_SHMQ_REC *rec;
+	uint8_t *dst;
+
+	while (size < (uint64_t)ring->used + need)
+		size *= 2;
+	if (off + size > MQSV_SHMQ_MAX_SIZE) {
+		TRACE("Queue %x can not grow to %" PRIu64 " bytes", map->hdl,
+		      off + size);
+		return NCSCC_RC_FAILURE;
+	}
+
+	if (ftruncate(map->fd, off + size) != 0)
+		return NCSCC_RC_FAILURE;
+	hdr->obj_size = off + size;
+	if (mqsv_shmq_remap(map) != NCSCC_RC_SUCCESS) {
+		hdr->obj_size = off;
+		return NCSCC_RC_FAILURE;
+	}
+
+	/* Copy the records in order to the start of the new ring */
+	dst = map->base + off;
+	for (uint32_t i = ring->count; i != 0; --i) {
+		rec = mqsv_shmq_ring_first(map, ring);
+		len = sizeof(MQSV_SHMQ_REC) + m_MQSV_SHMQ_ALIGN(rec->len);
+		memcpy(dst + pos, rec, len);
+		pos += len;
+		ring->head += len;
+	}
+
+	ring->off = off;
+	ring->size = size;
+	ring->head = 0;
+	ring->tail = pos;
+	ring->used = pos;
+	return NCSCC_RC_SUCCESS;
+}
+
+/****************************************************************************
+ * Name          : mqsv_shmq_create
+ *
+ * Description   : Creates a shared memory queue. Direct sends are off
+ *                 until the MQND turns them on.
+ *
+ * Arguments     : ring_size - initial bytes of each message type ring
+ *                 qbytes - limit of message bytes in the queue
+ *                 quota - size of each SAF priority
+ *                 o_hdl - the handle of the new queue
+ *
+ * Return Values : NCSCC_RC_SUCCESS/NCSCC_RC_FAILURE
+ *****************************************************************************/
+uint32_t mqsv_shmq_create(const uint32_t ring_size[MQSV_SHMQ_NUM_TYPES],
+			  uint32_t qbytes,
+			  const uint32_t quota[MQSV_SHMQ_NUM_PRIOS],
+			  NCS_OS_POSIX_MQD *o_hdl)
+{
+	static uint32_t next_id;
+	const uint32_t min_size = m_MQSV_SHMQ_ALIGN(
+	    sizeof(MQSV_SHMQ_REC) + NCS_OS_MQ_MAX_PAYLOAD);
+	char name[MQSV_SHMQ_NAME_LEN];
+	pthread_mutexattr_t mattr;
+	pthread_condattr_t cattr;
+	MQSV_SHMQ_HDR *hdr;
+	NCS_OS_POSIX_MQD hdl;
+	uint64_t obj_size;
+	uint32_t i, size;
+	mode_t umask_save;
+	void *addr;
+	int fd = -1, tries;
+
+	if (next_id == 0)
+		next_id = (uint32_t)getpid() << 12 ^ (uint32_t)time(NULL);
+
+	/* Any free id will do, the handle only has to name the object */
+	umask_save = umask(0);
+	for (tries = 0; tries < 1000 && fd < 0; ++tries) {
+		hdl = MQSV_SHMQ_HDL_FLAG | (next_id++ & ~MQSV_SHMQ_HDL_FLAG);
+		if (hdl == MQSV_SHMQ_HDL_FLAG)
+			continue;
+		mqsv_shmq_name(hdl, name);
+		fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, MQSV_SHMQ_MODE);
+		if (fd < 0 && errno != EEXIST) {
+			LOG_ER("shm_open %s failed: %s", name, strerror(errno));
+			umask(umask_save);
+			return NCSCC_RC_FAILURE;
+		}
+	}
+	umask(umask_save);
+	if (fd < 0) {
+		LOG_ER("No free shared memory queue name");
+		return NCSCC_RC_FAILURE;
+	}
+
+	obj_size = m_MQSV_SHMQ_ALIGN(sizeof(MQSV_SHMQ_HDR));
+	for (i = 0; i < MQSV_SHMQ_NUM_TYPES; i++) {
+		size = m_MQSV_SHMQ_ALIGN(ring_size[i]);
+		obj_size += (size < min_size) ? min_size : size;
+	}
+	if (obj_size > MQSV_SHMQ_MAX_SIZE || ftruncate(fd, obj_size) != 0) {
+		LOG_ER("Queue %s of %" PRIu64 " bytes can not be created",
+		       name, obj_size);
+		goto error;
+	}
+
+	addr = mmap(NULL, obj_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	if (addr == MAP_FAILED) {
+		LOG_ER("mmap %s failed: %s", name, strerror(errno));
+		goto error;
+	}
+	close(fd);
+
+	hdr = addr;
+	pthread_mutexattr_init(&mattr);
+	pthread_mutexattr_setpshared(&mattr, PTHREAD_PROCESS_SHARED);
+	pthread_mutexattr_setrobust(&mattr, PTHREAD_MUTEX_ROBUST);
+	pthread_mutex_init(&hdr->lock, &mattr);
+	pthread_mutexattr_destroy(&mattr);
+	pthread_condattr_init(&cattr);
+	pthread_condattr_setpshared(&cattr, PTHREAD_PROCESS_SHARED);
+	pthread_cond_init(&hdr->cond, &cattr);
+	pthread_condattr_destroy(&cattr);
+
+	hdr->qbytes = qbytes;
+	memcpy(hdr->quota, quota, sizeof(hdr->quota));
+	hdr->obj_size = m_MQSV_SHMQ_ALIGN(sizeof(MQSV_SHMQ_HDR));
+	for (i = 0; i < MQSV_SHMQ_NUM_TYPES; i++) {
+		size = m_MQSV_SHMQ_ALIGN(ring_size[i]);
+		hdr->ring[i].off = hdr->obj_size;
+		hdr->ring[i].size = (size < min_size) ? min_size : size;
+		hdr->obj_size += hdr->ring[i].size;
+	}
+	hdr->version = MQSV_SHMQ_VERSION;
+	__atomic_store_n(&hdr->magic, MQSV_SHMQ_MAGIC, __ATOMIC_RELEASE);
+	munmap(addr, obj_size);
+
+	TRACE("Created queue %s, %" PRIu64 " bytes", name, obj_size);
+	*o_hdl = hdl;
+	return NCSCC_RC_SUCCESS;
+
+error:
+	close(fd);
+	shm_unlink(name);
+	return NCSCC_RC_FAILURE;
+}
+
+/****************************************************************************
+ * Name          : mqsv_shmq_destroy
+ *
+ * Description   : Marks the queue removed, wakes up the receivers and
+ *                 unlinks the object. The memory goes with the last
+ *                 mapping.
+ *****************************************************************************/
+static uint32_t mqsv_shmq_destroy(NCS_OS_POSIX_MQD hdl)
+{
+	char name[MQSV_SHMQ_NAME_LEN];
+	MQSV_SHMQ_MAP *map;
+
+	if ((map = mqsv_shmq_map_get(hdl)) == NULL)
+		return NCSCC_RC_FAILURE;
+
+	mqsv_shmq_lock(map->hdr);
+	map->hdr->removed = 1;
+	pthread_cond_broadcast(&map->hdr->cond);
+	mqsv_shmq_unlock(map->hdr);
+	mqsv_shmq_forget(map);
+	mqsv_shmq_map_put(map);
+
+	mqsv_shmq_name(hdl, name);
+	if (shm_unlink(name) != 0) {
+		LOG_ER("shm_unlink %s failed: %s", name, strerror(errno));
+		return NCSCC_RC_FAILURE;
+	}
+	return NCSCC_RC_SUCCESS;
+}
+
+/****************************************************************************
+ * Name          : mqsv_shmq_write
+ *
+ * Description   : Puts a record of len bytes in the ring of its type, from
+ *                 a message header and the message data. A SAF message of
+ *                 a priority type is counted against the quota of its
+ *                 priority, a put back message is counted without a check.
+ *                 Called with the queue lock held.
+ *
+ * Arguments     : map - the queue
+ *                 mtype - message type, 1 to MQSV_SHMQ_NUM_TYPES
+ *                 msg, msg_len - the start of the message
+ *                 data, data_len - the rest of it, or NULL
+ *                 len - record length, at least msg_len + data_len
+ *
+ * Return Values : NCSCC_RC_SUCCESS/NCSCC_RC_FAILURE, errno EAGAIN when the
+ *                 queue is full
+ *****************************************************************************/
+static uint32_t mqsv_shmq_write(MQSV_SHMQ_MAP *map, uint32_t mtype,
+				const void *msg, uint32_t msg_len,
+				const void *data, uint32_t data_len,
+				uint32_t len)
+{
+	uint32_t need = sizeof(MQSV_SHMQ_REC) + m_MQSV_SHMQ_ALIGN(len);
+	const MQSV_MESSAGE *mqsv_msg = msg;
+	MQSV_SHMQ_HDR *hdr = map->hdr;
+	MQSV_SHMQ_RING *ring = &hdr->ring[mtype - 1];
+	uint32_t usage = 0, prio = 0;
+	MQSV_SHMQ_REC *rec;
+	int64_t pos;
+
+	if (mtype >= 2 && msg_len >= MQSV_SHMQ_MSG_HDR_LEN &&
+	    mqsv_msg->type == MQP_EVT_GET_REQ &&
+	    mqsv_msg->info.msg.message.priority < MQSV_SHMQ_NUM_PRIOS) {
+		usage = (uint32_t)mqsv_msg->info.msg.message.size;
+		prio = mqsv_msg->info.msg.message.priority;
+		if (mtype >= MQSV_SHMQ_PRIO_TYPE &&
+		    usage > hdr->quota[prio] - hdr->stats.used[prio]) {
+			hdr->stats.full[prio]++;
+			errno = EAGAIN;
+			return NCSCC_RC_FAILURE;
+		}
+	}
+	if (hdr->cbytes + len > hdr->qbytes) {
+		errno = EAGAIN;
+		return NCSCC_RC_FAILURE;
+	}
+	if ((pos = mqsv_shmq_ring_reserve(map, ring, need)) < 0) {
+		if (mqsv_shmq_ring_grow(map, ring, need) != NCSCC_RC_SUCCESS) {
+			errno = ENOSPC;
+			return NCSCC_RC_FAILURE;
+		}
+		pos = mqsv_shmq_ring_reserve(map, ring, need);
+		osafassert(pos >= 0);
+	}
+
+	rec = mqsv_shmq_rec(map, ring, pos);
+	rec->len = len;
+	rec->usage = usage;
+	rec->prio = prio;
+	memcpy(rec + 1, msg, msg_len);
+	if (data_len)
+		memcpy((uint8_t *)(rec + 1) + msg_len, data, data_len);
+	ring->tail = pos + need;
+	ring->used += need;
+	ring->count++;
+	if (usage != 0 || prio != 0) {
+		hdr->stats.used[prio] += usage;
+		hdr->stats.num[prio]++;
+	}
+	hdr->cbytes += len;
+	hdr->qnum++;
+	hdr->stime = time(NULL);
+	pthread_cond_broadcast(&hdr->cond);
+	return NCSCC_RC_SUCCESS;
+}
+
+/****************************************************************************
+ * Name          : mqsv_shmq_send
+ *
+ * Description   : Puts a message in the ring of its type, straight from
+ *                 the caller's buffer. Fails like a non blocking msgsnd
+ *                 when the queue is full.
+ *
+ * Arguments     : hdl - shared memory queue handle
+ *                 mtype - message type, 1 to MQSV_SHMQ_NUM_TYPES
+ *                 data, len - the message
+ *
+ * Return Values : NCSCC_RC_SUCCESS/NCSCC_RC_FAILURE
+ *****************************************************************************/
+uint32_t mqsv_shmq_send(NCS_OS_POSIX_MQD hdl, uint32_t mtype,
+			const void *data, uint32_t len)
+{
+	MQSV_SHMQ_MAP *map;
+	uint32_t rc;
+
+	if (mtype == 0 || mtype > MQSV_SHMQ_NUM_TYPES) {
+		errno = EINVAL;
+		return NCSCC_RC_FAILURE;
+	}
+	if ((map = mqsv_shmq_enter(hdl)) == NULL)
+		return NCSCC_RC_FAILURE;
+	rc = mqsv_shmq_write(map, mtype, data, len, NULL, 0, len);
+	mqsv_shmq_leave(map);
+	return rc;
+}
+
+/****************************************************************************
+ * Name          : mqsv_shmq_direct_send
+ *
+ * Description   : Puts a SAF message in a queue on behalf of the MQND. The
+ *                 message data is copied once, from the caller's buffer
+ *                 into the ring. The caller notifies the listener queue.
+ *
+ * Arguments     : hdl - shared memory queue handle
+ *                 msg - the message header, as the MQND would fill it in
+ *                 data - msg->info.msg.message.size bytes of message data
+ *                 o_listener - the listener queue, 0 if none
+ *
+ * Return Values : NCSCC_RC_SUCCESS/NCSCC_RC_FAILURE, errno EAGAIN when the
+ *                 priority is full, EPERM when the MQND does not allow
+ *                 direct sends to the queue
+ *****************************************************************************/
+uint32_t mqsv_shmq_direct_send(NCS_OS_POSIX_MQD hdl,
+			       const MQSV_MESSAGE *msg, const void *data,
+			       NCS_OS_POSIX_MQD *o_listener)
+{
+	uint32_t size = (uint32_t)msg->info.msg.message.size;
+	MQSV_SHMQ_MAP *map;
+	uint32_t rc = NCSCC_RC_FAILURE;
+
+	if (!m_MQSV_IS_SHMQ(hdl) ||
+	    msg->info.msg.message.priority >= MQSV_SHMQ_NUM_PRIOS) {
+		errno = EINVAL;
+		return NCSCC_RC_FAILURE;
+	}
+	if ((map = mqsv_shmq_enter(hdl)) == NULL)
+		return NCSCC_RC_FAILURE;
+
+	if (!map->hdr->direct) {
+		errno = EPERM;
+	} else {
+		/* Laid out as the MQND does, sizeof(MQSV_MESSAGE) + size */
+		rc = mqsv_shmq_write(
+		    map, msg->info.msg.message.priority + MQSV_SHMQ_PRIO_TYPE,
+		    msg, MQSV_SHMQ_MSG_HDR_LEN, data, size,
+		    sizeof(MQSV_MESSAGE) + size);
+		*o_listener = map->hdr->listener;
+	}
+
+	mqsv_shmq_leave(map);
+	return rc;
+}
+
+/****************************************************************************
+ * Name          : mqsv_shmq_direct_set
+ *
+ * Description   : Allows or stops direct sends to the queue. The MQND stops
+ *                 them while the queue is transferred to another node.
+ *
+ * Arguments     : hdl - shared memory queue handle
+ *                 direct - true to allow them
+ *
+ * Return Values : NCSCC_RC_SUCCESS/NCSCC_RC_FAILURE
+ *****************************************************************************/
+uint32_t mqsv_shmq_direct_set(NCS_OS_POSIX_MQD hdl, bool direct)
+{
+	MQSV_SHMQ_MAP *map;
+
+	if ((map = mqsv_shmq_enter(hdl)) == NULL)
+		return NCSCC_RC_FAILURE;
+	map->hdr->direct = direct;
+	mqsv_shmq_leave(map);
+	return NCSCC_RC_SUCCESS;
+}
+
+/****************************************************************************
+ * Name          : mqsv_shmq_listener_set
+ *
+ * Description   : Sets the listener queue that direct senders notify.
+ *
+ * Arguments     : hdl - shared memory queue handle
+ *                 listener - listener queue handle, 0 if none
+ *
+ * Return Values : NCSCC_RC_SUCCESS/NCSCC_RC_FAILURE
+ *****************************************************************************/
+uint32_t mqsv_shmq_listener_set(NCS_OS_POSIX_MQD hdl,
+				NCS_OS_POSIX_MQD listener)
+{
+	MQSV_SHMQ_MAP *map;
+
+	if ((map = mqsv_shmq_enter(hdl)) == NULL)
+		return NCSCC_RC_FAILURE;
+	map->hdr->listener = listener;
+	mqsv_shmq_leave(map);
+	return NCSCC_RC_SUCCESS;
+}
+
+/****************************************************************************
+ * Name          : mqsv_shmq_stats_get
+ *
+ * Description   : Reads the usage of each priority and the count of sends
+ *                 refused over the quota.
+ *
+ * Arguments     : hdl - shared memory queue handle
+ *                 o_stats - the statistics
+ *                 take_full - restart the count of refused sends, for the
+ *                             MQND that adds them up
+ *
+ * Return Values : NCSCC_RC_SUCCESS/NCSCC_RC_FAILURE
+ *****************************************************************************/
+uint32_t mqsv_shmq_stats_get(NCS_OS_POSIX_MQD hdl, MQSV_SHMQ_STATS *o_stats,
+			     bool take_full)
+{
+	MQSV_SHMQ_MAP *map;
+
+	if ((map = mqsv_shmq_enter(hdl)) == NULL)
+		return NCSCC_RC_FAILURE;
+	*o_stats = map->hdr->stats;
+	if (take_full)
+		memset(map->hdr->stats.full, 0, sizeof(map->hdr->stats.full));
+	mqsv_shmq_leave(map);
+	return NCSCC_RC_SUCCESS;
+}
+
+/****************************************************************************
+ * Name          : mqsv_shmq_recv
+ *
+ * Description   : Takes a message the way msgrcv() selects it: mtype 0 is
+ *                 any type, a positive mtype that type, and a negative
+ *                 mtype the lowest type up to its absolute value. Lower
+ *                 types are taken first also for mtype 0.
+ *
+ * Arguments     : req - NCS_OS_POSIX_MQ_REQ_MSG_RECV(_ASYNC) request
+ *
+ * Return Values : NCSCC_RC_SUCCESS/NCSCC_RC_FAILURE
+ *****************************************************************************/
+static uint32_t mqsv_shmq_recv(NCS_OS_POSIX_MQ_REQ_INFO *req)
+{
+	NCS_OS_POSIX_MQ_REQ_MSG_RECV_INFO *recv = &req->info.recv;
+	uint32_t first, last, type;
+	uint32_t rc = NCSCC_RC_FAILURE;
+	MQSV_SHMQ_REC *rec = NULL;
+	MQSV_SHMQ_RING *ring = NULL;
+	MQSV_SHMQ_MAP *map;
+	MQSV_SHMQ_HDR *hdr;
+
+	if (recv->i_mtype > 0) {
+		first = last = recv->i_mtype;
+	} else {
+		first = 1;
+		last = (recv->i_mtype < 0) ? -recv->i_mtype
+					   : MQSV_SHMQ_NUM_TYPES;
+	}
+	if (last > MQSV_SHMQ_NUM_TYPES)
+		last = MQSV_SHMQ_NUM_TYPES;
+	if (first > last) {
+		errno = EINVAL;
+		return NCSCC_RC_FAILURE;
+	}
+
+	if ((map = mqsv_shmq_enter(recv->mqd)) == NULL)
+		return NCSCC_RC_FAILURE;
+	hdr = map->hdr;
+
+	for (;;) {
+		for (type = first; type <= last; type++) {
+			ring = &hdr->ring[type - 1];
+			if ((rec = mqsv_shmq_ring_first(map, ring)) != NULL)
+				break;
+		}
+		if (rec != NULL)
+			break;
+		if (req->req == NCS_OS_POSIX_MQ_REQ_MSG_RECV_ASYNC) {
+			errno = ENOMSG;
+			goto done;
+		}
+		mqsv_shmq_wait(hdr);
+		/* The object may have grown or gone while waiting */
+		if (hdr->removed) {
+			mqsv_shmq_forget(map);
+			errno = EIDRM;
+			goto done;
+		}
+		if (mqsv_shmq_remap(map) != NCSCC_RC_SUCCESS)
+			goto done;
+	}
+
+	if (rec->len > recv->datalen) {
+		errno = E2BIG;
+		goto done;
+	}
+	memcpy(recv->i_msg->data, rec + 1, rec->len);
+	recv->i_msg->ll_hdr = type;
+	mqsv_shmq_ring_pop(hdr, ring, rec);
+	rc = NCSCC_RC_SUCCESS;
+
+done:
+	mqsv_shmq_leave(map);
+	return rc;
+}
+
+static uint32_t mqsv_shmq_attr(NCS_OS_POSIX_MQ_REQ_INFO *req)
+{
+	MQSV_SHMQ_MAP *map;
+	MQSV_SHMQ_HDR *hdr;
+
+	if ((map = mqsv_shmq_enter(req->info.attr.i_mqd)) == NULL)
+		return NCSCC_RC_FAILURE;
+	hdr = map->hdr;
+	req->info.attr.o_attr.mq_curmsgs = hdr->qnum;
+	req->info.attr.o_attr.mq_msgsize = hdr->cbytes;
+	req->info.attr.o_attr.mq_stime = hdr->stime;
+	req->info.attr.o_attr.mq_maxmsg = hdr->qbytes;
+	mqsv_shmq_leave(map);
+	return NCSCC_RC_SUCCESS;
+}
+
+static uint32_t mqsv_shmq_resize(NCS_OS_POSIX_MQ_REQ_INFO *req)
+{
+	MQSV_SHMQ_MAP *map;
+
+	if ((map = mqsv_shmq_enter(req->info.resize.mqd)) == NULL)
+		return NCSCC_RC_FAILURE;
+	/* The rings grow on demand, only the limit changes */
+	map->hdr->qbytes = req->info.resize.i_newqsize;
+	mqsv_shmq_leave(map);
+	return NCSCC_RC_SUCCESS;
+}
+
+/****************************************************************************
+ * Name          : mqsv_posix_mq
+ *
+ * Description   : ncs_os_posix_mq() for both kinds of queue.
+ *
+ * Arguments     : req - the request
+ *
+ * Return Values : NCSCC_RC_SUCCESS/NCSCC_RC_FAILURE
+ *****************************************************************************/
+uint32_t mqsv_posix_mq(NCS_OS_POSIX_MQ_REQ_INFO *req)
+{
+	switch (req->req) {
+	case NCS_OS_POSIX_MQ_REQ_CLOSE:
+		if (m_MQSV_IS_SHMQ(req->info.close.mqd))
+			return mqsv_shmq_destroy(req->info.close.mqd);
+		break;
+	case NCS_OS_POSIX_MQ_REQ_MSG_SEND:
+	case NCS_OS_POSIX_MQ_REQ_MSG_SEND_ASYNC:
+		if (m_MQSV_IS_SHMQ(req->info.send.mqd))
+			return mqsv_shmq_send(
+			    req->info.send.mqd, req->info.send.i_mtype,
+			    req->info.send.i_msg->data, req->info.send.datalen);
+		break;
+	case NCS_OS_POSIX_MQ_REQ_MSG_RECV:
+	case NCS_OS_POSIX_MQ_REQ_MSG_RECV_ASYNC:
+		if (m_MQSV_IS_SHMQ(req->info.recv.mqd))
+			return mqsv_shmq_recv(req);
+		break;
+	case NCS_OS_POSIX_MQ_REQ_GET_ATTR:
+		if (m_MQSV_IS_SHMQ(req->info.attr.i_mqd))
+			return mqsv_shmq_attr(req);
+		break;
+	case NCS_OS_POSIX_MQ_REQ_RESIZE:
+		if (m_MQSV_IS_SHMQ(req->info.resize.mqd))
+			return mqsv_shmq_resize(req);
+		break;
+	default:
+		break;
+	}
+	return m_NCS_OS_POSIX_MQ(req);
+}
@@ -0,0 +1,100 @@
+/*      -*- OpenSAF  -*-
+ *
+ * (C) Copyright 2017 The OpenSAF Foundation
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. This file and program are licensed
+ * under the GNU Lesser General Public License Version 2.1, February 1999.
+ * The complete license can be accessed from the following location:
+ * http://opensource.org/licenses/lgpl-license.php
+ * See the Copying file included with the OpenSAF distribution for full
+ * licensing terms.
+ *
+ */
+
+/*****************************************************************************
+..............................................................................
+
+..............................................................................
+
+  DESCRIPTION:
+
+  Message queues in POSIX shared memory, an alternative to the SysV message
+  queues behind ncs_os_posix_mq(). A queue is one shared memory object
+  holding one ring of variable size records per message type (1 control,
+  2 put back, 3 to 6 SAF priorities 0 to 3). The object outlives the MQND
+  the same way a SysV queue does, and the queue handle names the object, so
+  a restarted MQND or an agent can map it from the checkpointed handle.
+
+  The object also keeps the usage of each SAF priority, counted from the
+  MQSV_MESSAGE of the records, and the quota set at creation. With that an
+  agent on the same node can put a message straight into the queue with
+  mqsv_shmq_direct_send(), without going through the MQND, when the MQND
+  allows it for the queue. The MQND reads the usage back with
+  mqsv_shmq_stats_get() instead of counting the messages itself.
+
+  m_MQSV_POSIX_MQ() takes the same requests as m_NCS_OS_POSIX_MQ() and
+  serves shared memory queue handles itself. Everything else, including the
+  creation of SysV queues, is passed on to ncs_os_posix_mq().
+
+******************************************************************************
+*/
+
+#ifndef MSG_COMMON_MQSV_SHMQ_H_
+#define MSG_COMMON_MQSV_SHMQ_H_
+
+#include <stdbool.h>
+#include "base/ncs_osprm.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct mqsv_message;
+
+/* SysV queue ids are never negative, so the top bit tells the two apart */
+#define MQSV_SHMQ_HDL_FLAG 0x80000000u
+#define m_MQSV_IS_SHMQ(hdl) (((uint32_t)(hdl)&MQSV_SHMQ_HDL_FLAG) != 0)
+
+/* Message types, as the SysV mtype of the queue messages */
+#define MQSV_SHMQ_NUM_TYPES 6
+
+/* SAF priorities, message types 3 to 6 */
+#define MQSV_SHMQ_NUM_PRIOS 4
+
+/* Largest object a queue may grow to. Each process maps only the current
+   size of the object, and maps it again when the object has grown. */
+#define MQSV_SHMQ_MAX_SIZE (64 * 1024 * 1024)
+
+typedef struct mqsv_shmq_stats {
+  uint32_t used[MQSV_SHMQ_NUM_PRIOS]; /* Message bytes, as queueUsed */
+  uint32_t num[MQSV_SHMQ_NUM_PRIOS];  /* Messages */
+  uint32_t full[MQSV_SHMQ_NUM_PRIOS]; /* Sends over the quota since they
+                                         were last taken */
+} MQSV_SHMQ_STATS;
+
+uint32_t mqsv_shmq_create(const uint32_t ring_size[MQSV_SHMQ_NUM_TYPES],
+                          uint32_t qbytes,
+                          const uint32_t quota[MQSV_SHMQ_NUM_PRIOS],
+                          NCS_OS_POSIX_MQD *o_hdl);
+uint32_t mqsv_shmq_send(NCS_OS_POSIX_MQD hdl, uint32_t mtype,
+                        const void *data, uint32_t len);
+uint32_t mqsv_shmq_direct_send(NCS_OS_POSIX_MQD hdl,
+                               const struct mqsv_message *msg,
+                               const void *data,
+                               NCS_OS_POSIX_MQD *o_listener);
+uint32_t mqsv_shmq_direct_set(NCS_OS_POSIX_MQD hdl, bool direct);
+uint32_t mqsv_shmq_listener_set(NCS_OS_POSIX_MQD hdl,
+                                NCS_OS_POSIX_MQD listener);
+uint32_t mqsv_shmq_stats_get(NCS_OS_POSIX_MQD hdl, MQSV_SHMQ_STATS *o_stats,
+                             bool take_full);
+uint32_t mqsv_posix_mq(NCS_OS_POSIX_MQ_REQ_INFO *req);
+
+#define m_MQSV_POSIX_MQ mqsv_posix_mq
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // MSG_COMMON_MQSV_SHMQ_H_
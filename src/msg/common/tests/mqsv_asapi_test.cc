@@ -0,0 +1,274 @@
+/*      -*- OpenSAF  -*-
+ *
+ * (C) Copyright 2017 The OpenSAF Foundation
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. This file and program are licensed
+ * under the GNU Lesser General Public License Version 2.1, February 1999.
+ * The complete license can be accessed from the following location:
+ * http://opensource.org/licenses/lgpl-license.php
+ * See the Copying file included with the OpenSAF distribution for full
+ * licensing terms.
+ *
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <vector>
+#include "gtest/gtest.h"
+extern "C" {
+#include "msg/common/mqsv.h"
+}
+
+namespace {
+
+MDS_DEST Dest(uint32_t node_id, uint32_t n) {
+  return (static_cast<MDS_DEST>(node_id) << 32) | n;
+}
+
+const uint32_t kLocalNode = 1;
+const uint32_t kRemoteNode = 2;
+
+// Member selection of queue groups, with local members that are shared
+// memory queues, so that the agent reads their usage from the queues
+class MqsvAsapiSelectTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    asapi.my_dest = Dest(kLocalNode, 100);
+    memset(&group_, 0, sizeof(group_));
+    ncs_create_queue(&group_.qlist);
+    group_.policy = SA_MSG_QUEUE_GROUP_LOCAL_BEST_QUEUE;
+  }
+
+  void TearDown() override {
+    while (ncs_dequeue(&group_.qlist) != nullptr) {
+    }
+    ncs_destroy_queue(&group_.qlist);
+    for (NCS_OS_POSIX_MQD hdl : shmqs_) Close(hdl);
+  }
+
+  static void Close(NCS_OS_POSIX_MQD hdl) {
+    NCS_OS_POSIX_MQ_REQ_INFO req;
+    memset(&req, 0, sizeof(req));
+    req.req = NCS_OS_POSIX_MQ_REQ_CLOSE;
+    req.info.close.mqd = hdl;
+    mqsv_posix_mq(&req);
+  }
+
+  // A member of the group, a shared memory queue with room for quota bytes
+  // of each priority when it is local
+  ASAPi_QUEUE_INFO *Member(uint32_t node_id, uint32_t n,
+                           uint32_t quota = kSize) {
+    ASAPi_QUEUE_INFO *q = new ASAPi_QUEUE_INFO();
+    members_.emplace_back(q);
+    q->param.addr = Dest(node_id, n);
+    q->param.owner = MQSV_QUEUE_OWN_STATE_OWNED;
+    for (SaSizeT &size : q->param.size) size = kSize;
+    if (node_id == kLocalNode) {
+      uint32_t ring_size[MQSV_SHMQ_NUM_TYPES] = {0};
+      uint32_t quotas[MQSV_SHMQ_NUM_PRIOS] = {quota, quota, quota, quota};
+      NCS_OS_POSIX_MQD hdl = 0;
+      EXPECT_EQ(mqsv_shmq_create(ring_size, 1 << 20, quotas, &hdl),
+                NCSCC_RC_SUCCESS);
+      EXPECT_EQ(mqsv_shmq_direct_set(hdl, true), NCSCC_RC_SUCCESS);
+      shmqs_.push_back(hdl);
+      q->param.hdl = hdl;
+      group_.lcl_qcnt++;
+    } else {
+      q->param.hdl = n;
+    }
+    ncs_enqueue(&group_.qlist, q);
+    return q;
+  }
+
+  // Puts a message of size bytes in the queue, as another agent would
+  static uint32_t Send(ASAPi_QUEUE_INFO *q, uint8_t priority,
+                       const std::vector<char> &data) {
+    MQSV_MESSAGE msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.type = MQP_EVT_GET_REQ;
+    msg.mqsv_version = MQSV_MSG_VERSION;
+    msg.info.msg.message.priority = priority;
+    msg.info.msg.message.size = data.size();
+    NCS_OS_POSIX_MQD listener = 0;
+    return mqsv_shmq_direct_send(q->param.hdl, &msg, data.data(), &listener);
+  }
+
+  static void Fill(ASAPi_QUEUE_INFO *q, uint8_t priority, uint32_t size) {
+    ASSERT_EQ(Send(q, priority, std::vector<char>(size, 'x')),
+              NCSCC_RC_SUCCESS);
+  }
+
+  ASAPi_QUEUE_INFO *Select(SaUint8T priority) {
+    EXPECT_EQ(asapi_queue_select(&group_, priority), NCSCC_RC_SUCCESS);
+    return group_.pQueue;
+  }
+
+  static constexpr uint32_t kSize = 1000;
+  ASAPi_GROUP_INFO group_;
+  std::vector<std::unique_ptr<ASAPi_QUEUE_INFO>> members_;
+  std::vector<NCS_OS_POSIX_MQD> shmqs_;
+};
+
+TEST_F(MqsvAsapiSelectTest, MostFreeSpaceForThePriority) {
+  ASAPi_QUEUE_INFO *a = Member(kLocalNode, 1);
+  ASAPi_QUEUE_INFO *b = Member(kLocalNode, 2);
+  ASAPi_QUEUE_INFO *c = Member(kLocalNode, 3);
+  Fill(a, SA_MSG_MESSAGE_HIGHEST_PRIORITY, 600);
+  Fill(b, SA_MSG_MESSAGE_HIGHEST_PRIORITY, 100);
+  Fill(c, SA_MSG_MESSAGE_HIGHEST_PRIORITY, 300);
+  Fill(b, SA_MSG_MESSAGE_LOWEST_PRIORITY, 500);
+  Fill(c, SA_MSG_MESSAGE_LOWEST_PRIORITY, 200);
+
+  EXPECT_EQ(Select(SA_MSG_MESSAGE_HIGHEST_PRIORITY), b);
+  EXPECT_EQ(Select(SA_MSG_MESSAGE_HIGHEST_PRIORITY), b);
+  EXPECT_EQ(Select(SA_MSG_MESSAGE_LOWEST_PRIORITY), a);
+
+  Fill(b, SA_MSG_MESSAGE_HIGHEST_PRIORITY, 400);
+  EXPECT_EQ(Select(SA_MSG_MESSAGE_HIGHEST_PRIORITY), c);
+}
+
+TEST_F(MqsvAsapiSelectTest, SameFreeSpaceTakesTurns) {
+  ASAPi_QUEUE_INFO *a = Member(kLocalNode, 1);
+  ASAPi_QUEUE_INFO *b = Member(kLocalNode, 2);
+  ASAPi_QUEUE_INFO *c = Member(kLocalNode, 3);
+  Fill(c, 1, 10);
+
+  EXPECT_EQ(Select(1), a);
+  EXPECT_EQ(Select(1), b);
+  EXPECT_EQ(Select(1), a);
+  EXPECT_EQ(Select(2), b);
+  EXPECT_EQ(Select(2), c);
+}
+
+TEST_F(MqsvAsapiSelectTest, OnlyLocalOwnedQueues) {
+  Member(kRemoteNode, 1);
+  ASAPi_QUEUE_INFO *orphan = Member(kLocalNode, 2);
+  ASAPi_QUEUE_INFO *full = Member(kLocalNode, 3);
+  ASAPi_QUEUE_INFO *down = Member(kLocalNode, 4);
+  orphan->param.owner = MQSV_QUEUE_OWN_STATE_ORPHAN;
+  down->param.is_mqnd_down = true;
+  Fill(full, 0, kSize);
+
+  // A full local queue is still better than a remote one
+  for (int i = 0; i < 4; i++) EXPECT_EQ(Select(0), full) << i;
+}
+
+TEST_F(MqsvAsapiSelectTest, LocalRoundRobinWithoutStatistics) {
+  // The usage of a queue the MQND serves is in its shared memory, which
+  // there is none of here
+  ASAPi_QUEUE_INFO *a = Member(kLocalNode, 1);
+  ASAPi_QUEUE_INFO *b = Member(kLocalNode, 2);
+  Member(kRemoteNode, 3);
+  ASAPi_QUEUE_INFO *mqnd = Member(kRemoteNode, 4);
+  mqnd->param.addr = Dest(kLocalNode, 4);
+  group_.lcl_qcnt++;
+  Fill(a, 0, 500);
+
+  EXPECT_EQ(Select(0), a);
+  EXPECT_EQ(Select(0), b);
+  EXPECT_EQ(Select(0), mqnd);
+  EXPECT_EQ(Select(0), a);
+}
+
+TEST_F(MqsvAsapiSelectTest, LocalRoundRobinForAnInvalidPriority) {
+  ASAPi_QUEUE_INFO *a = Member(kLocalNode, 1);
+  ASAPi_QUEUE_INFO *b = Member(kLocalNode, 2);
+  Fill(a, 0, 500);
+
+  EXPECT_EQ(Select(SA_MSG_MESSAGE_LOWEST_PRIORITY + 1), a);
+  EXPECT_EQ(Select(SA_MSG_MESSAGE_LOWEST_PRIORITY + 1), b);
+}
+
+TEST_F(MqsvAsapiSelectTest, RoundRobinWithoutLocalQueues) {
+  ASAPi_QUEUE_INFO *a = Member(kRemoteNode, 1);
+  ASAPi_QUEUE_INFO *b = Member(kRemoteNode, 2);
+
+  EXPECT_EQ(Select(0), a);
+  EXPECT_EQ(Select(0), b);
+  EXPECT_EQ(Select(0), a);
+}
+
+// Tail latency of the messages sent to a group of local queues whose
+// consumers take messages at uneven rates. Time is counted in ticks: each
+// tick the sender sends kLoad messages to the selected queues, then each
+// consumer takes up to its rate of messages. A send to a full queue is
+// lost. Run with
+//   bin/testmsg --gtest_also_run_disabled_tests --gtest_filter='*Bench*'
+class MqsvAsapiSelectBench : public MqsvAsapiSelectTest {
+ protected:
+  static constexpr uint32_t kTicks = 20000;
+  static constexpr uint32_t kLoad = 10;
+  static constexpr uint32_t kMessageSize = 64;
+
+  void Run(SaMsgQueueGroupPolicyT policy) {
+    const uint32_t rates[] = {8, 4, 2, 1};
+    std::vector<ASAPi_QUEUE_INFO *> queues;
+    for (uint32_t n = 0; n < 4; n++) {
+      queues.push_back(Member(kLocalNode, n + 1, 64 * kMessageSize));
+    }
+    group_.policy = policy;
+
+    std::unique_ptr<NCS_OS_MQ_MSG> msg(new NCS_OS_MQ_MSG());
+    std::vector<char> data(kMessageSize);
+    std::vector<uint32_t> latency;
+    uint32_t lost = 0;
+    std::chrono::steady_clock::duration select_time{0};
+    for (uint32_t tick = 0; tick < kTicks; tick++) {
+      memcpy(data.data(), &tick, sizeof(tick));
+      for (uint32_t i = 0; i < kLoad; i++) {
+        auto start = std::chrono::steady_clock::now();
+        ASAPi_QUEUE_INFO *q = Select(SA_MSG_MESSAGE_HIGHEST_PRIORITY);
+        select_time += std::chrono::steady_clock::now() - start;
+        if (Send(q, SA_MSG_MESSAGE_HIGHEST_PRIORITY, data) !=
+            NCSCC_RC_SUCCESS)
+          lost++;
+      }
+      for (uint32_t n = 0; n < queues.size(); n++) {
+        for (uint32_t i = 0; i < rates[n]; i++) {
+          NCS_OS_POSIX_MQ_REQ_INFO req;
+          memset(&req, 0, sizeof(req));
+          req.req = NCS_OS_POSIX_MQ_REQ_MSG_RECV_ASYNC;
+          req.info.recv.mqd = queues[n]->param.hdl;
+          req.info.recv.i_msg = msg.get();
+          req.info.recv.datalen = NCS_OS_MQ_MAX_PAYLOAD;
+          req.info.recv.i_mtype = -7;
+          if (mqsv_posix_mq(&req) != NCSCC_RC_SUCCESS) break;
+          // The data follows the MQSV_MESSAGE up to its data pointer
+          uint32_t sent;
+          memcpy(&sent,
+                 msg->data + offsetof(MQSV_MESSAGE, info.msg.message.data),
+                 sizeof(sent));
+          latency.push_back(tick - sent);
+        }
+      }
+    }
+
+    std::sort(latency.begin(), latency.end());
+    auto at = [&](double p) {
+      return latency.empty() ? 0 : latency[(latency.size() - 1) * p];
+    };
+    typedef std::chrono::duration<double, std::nano> Ns;
+    printf("%s: %zu received, %u lost, latency in ticks p50 %u p99 %u "
+           "p99.9 %u max %u, select %.0f ns\n",
+           policy == SA_MSG_QUEUE_GROUP_LOCAL_BEST_QUEUE ? "local best"
+                                                         : "local round robin",
+           latency.size(), lost, at(0.5), at(0.99), at(0.999), at(1),
+           Ns(select_time).count() / (kTicks * kLoad));
+  }
+};
+
+TEST_F(MqsvAsapiSelectBench, DISABLED_LocalBestQueue) {
+  Run(SA_MSG_QUEUE_GROUP_LOCAL_BEST_QUEUE);
+}
+
+TEST_F(MqsvAsapiSelectBench, DISABLED_LocalRoundRobin) {
+  Run(SA_MSG_QUEUE_GROUP_LOCAL_ROUND_ROBIN);
+}
+
+}  // namespace
@@ -0,0 +1,217 @@
+/*      -*- OpenSAF  -*-
+ *
+ * (C) Copyright 2017 The OpenSAF Foundation
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. This file and program are licensed
+ * under the GNU Lesser General Public License Version 2.1, February 1999.
+ * The complete license can be accessed from the following location:
+ * http://opensource.org/licenses/lgpl-license.php
+ * See the Copying file included with the OpenSAF distribution for full
+ * licensing terms.
+ *
+ */
+
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#include <thread>
+#include <vector>
+#include "gtest/gtest.h"
+#include "msg/common/mqsv.h"
+
+namespace {
+
+class MqsvShmqTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    uint32_t ring_size[MQSV_SHMQ_NUM_TYPES] = {0};
+    uint32_t quota[MQSV_SHMQ_NUM_PRIOS] = {kQuota, kQuota, kQuota, kQuota};
+    ASSERT_EQ(mqsv_shmq_create(ring_size, 1 << 20, quota, &hdl_),
+              NCSCC_RC_SUCCESS);
+    EXPECT_TRUE(m_MQSV_IS_SHMQ(hdl_));
+  }
+
+  void TearDown() override {
+    if (hdl_ != 0) Close(hdl_);
+  }
+
+  static uint32_t Close(NCS_OS_POSIX_MQD hdl) {
+    NCS_OS_POSIX_MQ_REQ_INFO req;
+    memset(&req, 0, sizeof(req));
+    req.req = NCS_OS_POSIX_MQ_REQ_CLOSE;
+    req.info.close.mqd = hdl;
+    return mqsv_posix_mq(&req);
+  }
+
+  // A control message of the given type, tagged with a byte pattern
+  uint32_t Send(uint32_t mtype, uint8_t tag, uint32_t len) {
+    std::vector<uint8_t> data(len, tag);
+    return mqsv_shmq_send(hdl_, mtype, data.data(), len);
+  }
+
+  // Returns the type of the message taken, 0 and errno on failure
+  uint32_t Receive(int32_t mtype, bool wait, NCS_OS_MQ_MSG* msg) {
+    NCS_OS_POSIX_MQ_REQ_INFO req;
+    memset(&req, 0, sizeof(req));
+    req.req = wait ? NCS_OS_POSIX_MQ_REQ_MSG_RECV
+                   : NCS_OS_POSIX_MQ_REQ_MSG_RECV_ASYNC;
+    req.info.recv.mqd = hdl_;
+    req.info.recv.i_msg = msg;
+    req.info.recv.datalen = NCS_OS_MQ_MAX_PAYLOAD;
+    req.info.recv.i_mtype = mtype;
+    if (mqsv_posix_mq(&req) != NCSCC_RC_SUCCESS) return 0;
+    return msg->ll_hdr;
+  }
+
+  // A SAF message as the MQND lays it out
+  static void Message(MQSV_MESSAGE* msg, uint8_t priority, uint32_t size) {
+    memset(msg, 0, sizeof(*msg));
+    msg->type = MQP_EVT_GET_REQ;
+    msg->mqsv_version = MQSV_MSG_VERSION;
+    msg->info.msg.message.priority = priority;
+    msg->info.msg.message.size = size;
+  }
+
+  uint32_t DirectSend(uint8_t priority, const std::vector<char>& data,
+                      NCS_OS_POSIX_MQD* listener) {
+    MQSV_MESSAGE msg;
+    Message(&msg, priority, data.size());
+    return mqsv_shmq_direct_send(hdl_, &msg, data.data(), listener);
+  }
+
+  static constexpr uint32_t kQuota = 1000;
+  NCS_OS_POSIX_MQD hdl_ = 0;
+  NCS_OS_MQ_MSG msg_;
+};
+
+TEST_F(MqsvShmqTest, TakesLowerTypesFirst) {
+  ASSERT_EQ(Send(5, 'c', 10), NCSCC_RC_SUCCESS);
+  ASSERT_EQ(Send(3, 'b', 10), NCSCC_RC_SUCCESS);
+  ASSERT_EQ(Send(1, 'a', 10), NCSCC_RC_SUCCESS);
+  ASSERT_EQ(Send(3, 'B', 10), NCSCC_RC_SUCCESS);
+
+  EXPECT_EQ(Receive(-7, false, &msg_), 1u);
+  EXPECT_EQ(msg_.data[0], 'a');
+  EXPECT_EQ(Receive(0, false, &msg_), 3u);
+  EXPECT_EQ(msg_.data[0], 'b');
+  EXPECT_EQ(Receive(5, false, &msg_), 5u);
+  EXPECT_EQ(Receive(-7, false, &msg_), 3u);
+  EXPECT_EQ(msg_.data[0], 'B');
+  EXPECT_EQ(Receive(-7, false, &msg_), 0u);
+  EXPECT_EQ(errno, ENOMSG);
+}
+
+TEST_F(MqsvShmqTest, WrapsAndGrowsRingsInOrder) {
+  // Interleaved sends and receives wrap the ring, a backlog grows it
+  uint8_t next_send = 0, next_recv = 0;
+  for (int round = 0; round < 20; ++round) {
+    for (int i = 0; i < round; ++i)
+      ASSERT_EQ(Send(4, next_send++, 700 + round), NCSCC_RC_SUCCESS);
+    for (int i = 0; i < round / 2; ++i) {
+      ASSERT_EQ(Receive(4, false, &msg_), 4u);
+      EXPECT_EQ(msg_.data[0], next_recv++);
+    }
+  }
+  while (next_recv != next_send) {
+    ASSERT_EQ(Receive(-7, false, &msg_), 4u);
+    EXPECT_EQ(msg_.data[0], next_recv++);
+  }
+  EXPECT_EQ(Receive(-7, false, &msg_), 0u);
+}
+
+TEST_F(MqsvShmqTest, CountsUsageAgainstQuota) {
+  NCS_OS_POSIX_MQD listener = 1;
+  ASSERT_EQ(mqsv_shmq_direct_set(hdl_, true), NCSCC_RC_SUCCESS);
+
+  ASSERT_EQ(DirectSend(0, std::vector<char>(600, 'x'), &listener),
+            NCSCC_RC_SUCCESS);
+  EXPECT_EQ(listener, 0u);
+  EXPECT_EQ(DirectSend(0, std::vector<char>(600, 'y'), &listener),
+            NCSCC_RC_FAILURE);
+  EXPECT_EQ(errno, EAGAIN);
+  // The other priorities have their own quota
+  ASSERT_EQ(DirectSend(2, std::vector<char>(600, 'z'), &listener),
+            NCSCC_RC_SUCCESS);
+
+  MQSV_SHMQ_STATS stats;
+  ASSERT_EQ(mqsv_shmq_stats_get(hdl_, &stats, false), NCSCC_RC_SUCCESS);
+  EXPECT_EQ(stats.used[0], 600u);
+  EXPECT_EQ(stats.num[0], 1u);
+  EXPECT_EQ(stats.full[0], 1u);
+  EXPECT_EQ(stats.used[2], 600u);
+  ASSERT_EQ(mqsv_shmq_stats_get(hdl_, &stats, true), NCSCC_RC_SUCCESS);
+  EXPECT_EQ(stats.full[0], 1u);
+  ASSERT_EQ(mqsv_shmq_stats_get(hdl_, &stats, false), NCSCC_RC_SUCCESS);
+  EXPECT_EQ(stats.full[0], 0u);
+
+  // A receive frees the usage, a put back counts it without the quota
+  ASSERT_EQ(Receive(3, false, &msg_), 3u);
+  ASSERT_EQ(mqsv_shmq_stats_get(hdl_, &stats, false), NCSCC_RC_SUCCESS);
+  EXPECT_EQ(stats.used[0], 0u);
+  EXPECT_EQ(stats.num[0], 0u);
+  ASSERT_EQ(DirectSend(0, std::vector<char>(600, 'y'), &listener),
+            NCSCC_RC_SUCCESS);
+  ASSERT_EQ(mqsv_shmq_send(hdl_, 2, msg_.data, sizeof(MQSV_MESSAGE) + 600),
+            NCSCC_RC_SUCCESS);
+  ASSERT_EQ(mqsv_shmq_stats_get(hdl_, &stats, false), NCSCC_RC_SUCCESS);
+  EXPECT_EQ(stats.used[0], 1200u);
+  EXPECT_EQ(stats.num[0], 2u);
+  EXPECT_EQ(Receive(-7, false, &msg_), 2u);
+}
+
+TEST_F(MqsvShmqTest, DirectSendNeedsTheMqnd) {
+  NCS_OS_POSIX_MQD listener = 0;
+  std::vector<char> data(100);
+  for (size_t i = 0; i < data.size(); ++i) data[i] = i;
+
+  EXPECT_EQ(DirectSend(1, data, &listener), NCSCC_RC_FAILURE);
+  EXPECT_EQ(errno, EPERM);
+
+  ASSERT_EQ(mqsv_shmq_direct_set(hdl_, true), NCSCC_RC_SUCCESS);
+  ASSERT_EQ(mqsv_shmq_listener_set(hdl_, 1234), NCSCC_RC_SUCCESS);
+  ASSERT_EQ(DirectSend(1, data, &listener), NCSCC_RC_SUCCESS);
+  EXPECT_EQ(listener, 1234u);
+
+  // The receiver sees what the MQND would have put in the queue
+  ASSERT_EQ(Receive(-7, false, &msg_), 4u);
+  const MQSV_MESSAGE* msg = reinterpret_cast<MQSV_MESSAGE*>(msg_.data);
+  EXPECT_EQ(msg->type, MQP_EVT_GET_REQ);
+  EXPECT_EQ(msg->info.msg.message.priority, 1);
+  ASSERT_EQ(msg->info.msg.message.size, data.size());
+  EXPECT_EQ(memcmp(msg->info.msg.message.data, data.data(), data.size()), 0);
+
+  ASSERT_EQ(mqsv_shmq_direct_set(hdl_, false), NCSCC_RC_SUCCESS);
+  EXPECT_EQ(DirectSend(1, data, &listener), NCSCC_RC_FAILURE);
+  EXPECT_EQ(errno, EPERM);
+}
+
+TEST_F(MqsvShmqTest, WakesUpWaitingReceiver) {
+  NCS_OS_MQ_MSG msg;
+  uint32_t type = 0;
+  std::thread receiver([&] { type = Receive(-7, true, &msg); });
+  usleep(50000);
+  EXPECT_EQ(Send(6, 'w', 3000), NCSCC_RC_SUCCESS);
+  receiver.join();
+  EXPECT_EQ(type, 6u);
+  EXPECT_EQ(msg.data[2999], 'w');
+}
+
+TEST_F(MqsvShmqTest, DestroyedQueueIsGone) {
+  std::thread receiver([&] {
+    NCS_OS_MQ_MSG msg;
+    EXPECT_EQ(Receive(-7, true, &msg), 0u);
+    EXPECT_EQ(errno, EIDRM);
+  });
+  usleep(50000);
+  EXPECT_EQ(Close(hdl_), NCSCC_RC_SUCCESS);
+  receiver.join();
+
+  EXPECT_EQ(Send(1, 'a', 1), NCSCC_RC_FAILURE);
+  EXPECT_EQ(errno, EIDRM);
+  EXPECT_EQ(mqsv_shmq_direct_set(hdl_, true), NCSCC_RC_FAILURE);
+  hdl_ = 0;
+}
+
+}  // namespace
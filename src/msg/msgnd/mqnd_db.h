@@ -115,12 +115,6 @@ typedef struct qtransfer_evt_node {
   MDS_DEST addr;
 } MQND_QTRANSFER_EVT_NODE;
 
-typedef struct queue_stats_shm {
-  SaMsgQueueUsageT saMsgQueueUsage[SA_MSG_MESSAGE_LOWEST_PRIORITY + 1];
-  SaSizeT totalQueueUsed;
-  SaUint32T totalNumberOfMessages;
-} MQND_QUEUE_STATS_SHM;
-
 /* Q information stored in MQND  for Checkpointing*/
 typedef struct mqnd_queue_ckpt_info {
   SaMsgQueueHandleT queueHandle;    /* Assigned by MQND */
@@ -153,14 +147,6 @@ typedef struct mqnd_shm_info {
   uint32_t max_open_queues;
 } MQND_SHM_INFO;
 
-typedef struct mqnd_shm_version {
-  uint16_t shm_version;   /* Added to provide support for SAF Inservice upgrade
-                             facilty */
-  uint16_t dummy_verson1; /* Not in use */
-  uint16_t dummy_verson2; /* Not in use */
-  uint16_t dummy_verson3; /* Not in use */
-} MQND_SHM_VERSION;
-
 typedef struct mqa_rsp_cntxt {
   MQSV_EVT evt;
   MQSV_SEND_INFO sinfo;
@@ -212,6 +198,7 @@ typedef struct mqnd_cb {
   uint32_t gl_msg_max_msg_size;
   uint32_t gl_msg_max_no_of_q;
   uint32_t gl_msg_max_prio_q_size;
+  bool shm_queues; /* New queues in shared memory, see mqsv_shmq.h */
   SaImmOiHandleT immOiHandle;
   SaSelectionObjectT imm_sel_obj;
 } MQND_CB;
@@ -245,12 +232,13 @@ uint32_t mqnd_proc_mqa_down(MQND_CB *cb, MDS_DEST *mqa);
 uint32_t mqnd_proc_mqa_down(MQND_CB *cb, MDS_DEST *mqa);
 
 /* Functions from mqnd_mq.c */
-uint32_t mqnd_mq_create(MQND_QUEUE_INFO *q_info);
+uint32_t mqnd_mq_create(MQND_CB *cb, MQND_QUEUE_INFO *q_info);
 uint32_t mqnd_mq_open(MQND_QUEUE_INFO *q_info);
 uint32_t mqnd_mq_destroy(MQND_QUEUE_INFO *q_info);
 uint32_t mqnd_mq_msg_send(uint32_t qhdl, MQSV_MESSAGE *i_msg, uint32_t i_len);
 uint32_t mqnd_mq_empty(SaMsgQueueHandleT handle);
 uint32_t mqnd_mq_rcv(SaMsgQueueHandleT handle);
+void mqnd_mq_direct_set(MQND_QUEUE_INFO *q_info, bool direct);
 
 uint32_t mqnd_listenerq_create(MQND_QUEUE_INFO *q_info);
 uint32_t mqnd_listenerq_destroy(MQND_QUEUE_INFO *q_info);
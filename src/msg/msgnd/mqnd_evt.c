@@ -897,6 +897,7 @@ send_rsp:
 	rsp_evt.msg.mqp_rsp.info.statusRsp.queueHandle = sts_req->queueHandle;
 
 	if (err == SA_AIS_OK) {
+		mqnd_shmq_stats_sync(cb, qnode);
 		shm_base_addr = cb->mqnd_shm.shm_base_addr;
 		offset = qnode->qinfo.shm_queue_index;
 		for (i = SA_MSG_MESSAGE_HIGHEST_PRIORITY;
@@ -1006,7 +1007,10 @@ static uint32_t mqnd_evt_proc_update_stats_shm(MQND_CB *cb, MQSV_DSEND_EVT *evt)
 	shm_base_addr = cb->mqnd_shm.shm_base_addr;
 	offset = qnode->qinfo.shm_queue_index;
 
-	if (shm_base_addr[offset].valid == SHM_QUEUE_INFO_VALID) {
+	if (m_MQSV_IS_SHMQ(qnode->qinfo.queueHandle)) {
+		/* The receive already took it off the queue's usage */
+		mqnd_shmq_stats_sync(cb, qnode);
+	} else if (shm_base_addr[offset].valid == SHM_QUEUE_INFO_VALID) {
 		shm_base_addr[offset]
 		    .QueueStatsShm.saMsgQueueUsage[statsReq->priority]
 		    .queueUsed -= statsReq->size;
@@ -1139,6 +1143,7 @@ static uint32_t mqnd_evt_proc_send_msg(MQND_CB *cb, MQSV_DSEND_EVT *evt)
 
 	offset = qnode->qinfo.shm_queue_index;
 	shm_base_addr = cb->mqnd_shm.shm_base_addr;
+	mqnd_shmq_stats_sync(cb, qnode);
 
 	/* Get user defined queue size and usage stats */
 	qsize = qnode->qinfo.size[snd_msg->message.priority];
@@ -1172,7 +1177,7 @@ static uint32_t mqnd_evt_proc_send_msg(MQND_CB *cb, MQSV_DSEND_EVT *evt)
 	info.req = NCS_OS_POSIX_MQ_REQ_GET_ATTR;
 	info.info.attr.i_mqd = qnode->qinfo.queueHandle;
 
-	if (m_NCS_OS_POSIX_MQ(&info) != NCSCC_RC_SUCCESS) {
+	if (m_MQSV_POSIX_MQ(&info) != NCSCC_RC_SUCCESS) {
 		err = SA_AIS_ERR_BAD_HANDLE;
 		LOG_ER("Unable to get the queue attributes from the queue");
 		rc = NCSCC_RC_FAILURE;
@@ -1199,7 +1204,7 @@ static uint32_t mqnd_evt_proc_send_msg(MQND_CB *cb, MQSV_DSEND_EVT *evt)
 		    (5 * (snd_msg->message.size + sizeof(MQSV_MESSAGE) +
 			  sizeof(NCS_OS_MQ_MSG_LL_HDR)));
 
-		if (m_NCS_OS_POSIX_MQ(&info) != NCSCC_RC_SUCCESS) {
+		if (m_MQSV_POSIX_MQ(&info) != NCSCC_RC_SUCCESS) {
 			LOG_ER("Unable to resize the queue to the given size");
 			err = SA_AIS_ERR_NO_RESOURCES;
 			rc = NCSCC_RC_FAILURE;
@@ -1255,7 +1260,11 @@ static uint32_t mqnd_evt_proc_send_msg(MQND_CB *cb, MQSV_DSEND_EVT *evt)
 	if (rc != NCSCC_RC_SUCCESS) {
 		LOG_ER(
 		    "ERR_RESOURCES: Unable to send the message to the Queue");
-		err = SA_AIS_ERR_NO_RESOURCES;
+		/* A shared memory queue filled up by a direct sender */
+		if (m_MQSV_IS_SHMQ(qnode->qinfo.queueHandle) && errno == EAGAIN)
+			err = SA_AIS_ERR_QUEUE_FULL;
+		else
+			err = SA_AIS_ERR_NO_RESOURCES;
 		goto send_resp;
 	}
 
@@ -1816,6 +1825,7 @@ static uint32_t mqnd_evt_proc_cb_dump(void)
 			TRACE(" QTRANSFER TIMER INACTIVE");
 
 		offset = qnode->qinfo.shm_queue_index;
+		mqnd_shmq_stats_sync(cb, qnode);
 		mqnd_dump_queue_status(cb, &qnode->qinfo.queueStatus, offset);
 		TRACE("\n Queue Total Size          : %llu",
 		      qnode->qinfo.totalQueueSize);
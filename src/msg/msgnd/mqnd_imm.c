@@ -120,6 +120,7 @@ mqnd_saImmOiRtAttrUpdateCallback(SaImmOiHandleT immOiHandle,
 		ncshm_give_hdl(cb_hdl);
 		return SA_AIS_ERR_FAILED_OPERATION;
 	}
+	mqnd_shmq_stats_sync(mqnd_cb, qNode);
 	shmBaseAddr = mqnd_cb->mqnd_shm.shm_base_addr;
 	offset = qNode->qinfo.shm_queue_index;
 
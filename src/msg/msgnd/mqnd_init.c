@@ -176,6 +176,7 @@ static uint32_t mqnd_lib_init(MQSV_CREATE_INFO *info)
 	uint32_t rc = NCSCC_RC_SUCCESS;
 	SaAmfHealthcheckKeyT healthy;
 	char *health_key = NULL;
+	char *env;
 	SaAisErrorT amf_error;
 	SaClmCallbacksT clm_cbk;
 	SaClmClusterNodeT cluster_node;
@@ -253,6 +254,15 @@ static uint32_t mqnd_lib_init(MQSV_CREATE_INFO *info)
 	 * is kept as max msg size */
 	cb->gl_msg_max_prio_q_size = cb->gl_msg_max_q_size;
 
+	/* Shared memory queues are not bound by msgmnb, leave room for the
+	   rings to grow */
+	if ((env = getenv("MQND_SHM_QUEUES")) != NULL && atoi(env) != 0) {
+		cb->shm_queues = true;
+		cb->gl_msg_max_q_size = MQSV_SHMQ_MAX_SIZE / 4;
+		cb->gl_msg_max_prio_q_size = cb->gl_msg_max_q_size;
+		LOG_NO("Message queues are created in shared memory");
+	}
+
 	/* END: Set attributes of queue in global variable */
 
 	/* Init the EDU Handle */
@@ -29,6 +29,7 @@
     mqnd_mq_destroy
     mqnd_mq_msg_send
     mqnd_mq_msg_rcv
+    mqnd_mq_direct_set
 
 ******************************************************************************/
 #if (NCS_MQND == 1)
@@ -44,9 +45,12 @@ NCS_OS_MQ_MSG transfer_mq_msg; /* used in queue owner ship */
  * Purpose: Used to create the new physical message queue
  * Return Value:  NCSCC_RC_SUCCESS
  ****************************************************************************/
-uint32_t mqnd_mq_create(MQND_QUEUE_INFO *q_info)
+uint32_t mqnd_mq_create(MQND_CB *cb, MQND_QUEUE_INFO *q_info)
 {
 	NCS_OS_POSIX_MQ_REQ_INFO info;
+	uint32_t ring_size[MQSV_SHMQ_NUM_TYPES] = {0};
+	uint32_t quota[MQSV_SHMQ_NUM_PRIOS];
+	NCS_OS_POSIX_MQD hdl;
 	char queue_name[SA_MAX_NAME_LENGTH];
 	uint8_t i;
 	uint32_t size = 0;
@@ -69,6 +73,30 @@ uint32_t mqnd_mq_create(MQND_QUEUE_INFO *q_info)
 
 	info.info.open.attr.mq_msgsize = size + MQSV_MSG_OVERHEAD;
 
+	if (cb->shm_queues) {
+		/* One ring per priority, the control and put back rings
+		   start at the minimum size and grow on demand */
+		for (i = SA_MSG_MESSAGE_HIGHEST_PRIORITY;
+		     i <= SA_MSG_MESSAGE_LOWEST_PRIORITY; i++) {
+			ring_size[i + 2] = q_info->size[i] + MQSV_MSG_OVERHEAD;
+			quota[i] = q_info->size[i];
+		}
+
+		rc = mqsv_shmq_create(ring_size, size + MQSV_MSG_OVERHEAD,
+				      quota, &hdl);
+		if (rc != NCSCC_RC_SUCCESS) {
+			LOG_ER("Creation of shared memory queue failed");
+			TRACE_LEAVE();
+			return rc;
+		}
+
+		/* Agents on this node may send to it without the MQND */
+		mqsv_shmq_direct_set(hdl, true);
+		q_info->queueHandle = hdl;
+		TRACE_LEAVE();
+		return rc;
+	}
+
 	/* Create a New message queue */
 	if (m_NCS_OS_POSIX_MQ(&info) != NCSCC_RC_SUCCESS) {
 		LOG_ER("%s:%u: Creation of New message queue failed", __FILE__,
@@ -143,12 +171,16 @@ uint32_t mqnd_mq_destroy(MQND_QUEUE_INFO *q_info)
 	info.req = NCS_OS_POSIX_MQ_REQ_CLOSE;
 	info.info.close.mqd = q_info->queueHandle;
 
-	if (m_NCS_OS_POSIX_MQ(&info) != NCSCC_RC_SUCCESS) {
+	if (m_MQSV_POSIX_MQ(&info) != NCSCC_RC_SUCCESS) {
 		LOG_ER("%s:%u: Closing the existing message queue failed",
 		       __FILE__, __LINE__);
 		return (NCSCC_RC_FAILURE);
 	}
 
+	/* A shared memory queue has no key file */
+	if (m_MQSV_IS_SHMQ(q_info->queueHandle))
+		return NCSCC_RC_SUCCESS;
+
 	/* Unlink the file created by leap */
 	memset(&info, 0, sizeof(NCS_OS_POSIX_MQ_REQ_INFO));
 	info.req = NCS_OS_POSIX_MQ_REQ_UNLINK;
@@ -175,6 +207,21 @@ uint32_t mqnd_mq_msg_send(uint32_t qhdl, MQSV_MESSAGE *mqsv_msg, uint32_t size)
 	NCS_OS_POSIX_MQ_REQ_INFO info;
 	NCS_OS_MQ_MSG mq_msg;
 
+	/* Priority 1 will be used for control messages like MQP_EVT_CANCEL_REQ
+	   Priority 2 will be used for re-sending the messages that failed to
+	   deliver to applications in saMsgMessageGet. Priority 3 to 6 will be
+	   used for SAF priorities 0 to 3 respectivelyp */
+	if (m_MQSV_IS_SHMQ(qhdl)) {
+		/* Copied once, straight into the ring */
+		if (mqsv_shmq_send(qhdl,
+				   mqsv_msg->info.msg.message.priority + 3,
+				   mqsv_msg, size) != NCSCC_RC_SUCCESS) {
+			LOG_ER("Sending the message to message queue failed");
+			return NCSCC_RC_FAILURE;
+		}
+		return NCSCC_RC_SUCCESS;
+	}
+
 	memset(&mq_msg, 0, sizeof(NCS_OS_MQ_MSG));
 	memcpy(mq_msg.data, mqsv_msg, size);
 
@@ -183,11 +230,6 @@ uint32_t mqnd_mq_msg_send(uint32_t qhdl, MQSV_MESSAGE *mqsv_msg, uint32_t size)
 	info.info.send.mqd = qhdl;
 	info.info.send.datalen = size;
 	info.info.send.i_msg = &mq_msg;
-	/* Priority 1 will be used for control messages like MQP_EVT_CANCEL_REQ
-	   Priority 2 will be used for re-sending the messages that failed to
-	   deliver to applications in saMsgMessageGet. Priority 3 to 6 will be
-	   used for SAF priorities 0 to 3 respectivelyp */
-
 	info.info.send.i_mtype = mqsv_msg->info.msg.message.priority + 3;
 
 	if (m_NCS_OS_POSIX_MQ(&info) != NCSCC_RC_SUCCESS) {
@@ -215,7 +257,7 @@ uint32_t mqnd_mq_empty(SaMsgQueueHandleT handle)
 
 	mq_req.req = NCS_OS_POSIX_MQ_REQ_GET_ATTR;
 	mq_req.info.attr.i_mqd = handle;
-	if (m_NCS_OS_POSIX_MQ(&mq_req) != NCSCC_RC_SUCCESS) {
+	if (m_MQSV_POSIX_MQ(&mq_req) != NCSCC_RC_SUCCESS) {
 		LOG_ER("Empty the message in message queue failed");
 		return NCSCC_RC_FAILURE;
 	}
@@ -239,7 +281,7 @@ uint32_t mqnd_mq_empty(SaMsgQueueHandleT handle)
 	mq_req.info.recv.i_mtype = -7;
 
 	for (count = 0; count < num_messages; count++)
-		m_NCS_OS_POSIX_MQ(&mq_req);
+		m_MQSV_POSIX_MQ(&mq_req);
 
 	return NCSCC_RC_SUCCESS;
 }
@@ -275,7 +317,7 @@ uint32_t mqnd_mq_rcv(SaMsgQueueHandleT handle)
 	    -7; /* Read only the priorities brtween 1 and 6,
 		   with 1 as highest priority */
 
-	if (m_NCS_OS_POSIX_MQ(&mq_req) != NCSCC_RC_SUCCESS) {
+	if (m_MQSV_POSIX_MQ(&mq_req) != NCSCC_RC_SUCCESS) {
 		LOG_ER("Receiving the message from message queue failed");
 		return NCSCC_RC_FAILURE;
 	}
@@ -283,6 +325,23 @@ uint32_t mqnd_mq_rcv(SaMsgQueueHandleT handle)
 	return NCSCC_RC_SUCCESS;
 }
 
+/****************************************************************************
+ * Function Name: mqnd_mq_direct_set
+ * Purpose: Used to allow or stop direct sends by the agents to a shared
+ *          memory queue, does nothing for other queues
+ * Return Value:  None
+ ****************************************************************************/
+void mqnd_mq_direct_set(MQND_QUEUE_INFO *q_info, bool direct)
+{
+	if (!m_MQSV_IS_SHMQ(q_info->queueHandle))
+		return;
+
+	if (mqsv_shmq_direct_set(q_info->queueHandle, direct) !=
+	    NCSCC_RC_SUCCESS)
+		LOG_ER("Setting direct sends of queue %llx failed",
+		       q_info->queueHandle);
+}
+
 /****************************************************************************
  * Function Name: mqnd_listenerq_create
  * Purpose: Used to create the new listener queue
@@ -323,8 +382,13 @@ uint32_t mqnd_listenerq_create(MQND_QUEUE_INFO *q_info)
 		mqnd_listenerq_destroy(&zero_q);
 	}
 
-	if (rc == NCSCC_RC_SUCCESS)
+	if (rc == NCSCC_RC_SUCCESS) {
 		q_info->listenerHandle = info.info.open.o_mqd;
+		/* Tell direct senders which listener to notify */
+		if (m_MQSV_IS_SHMQ(q_info->queueHandle))
+			mqsv_shmq_listener_set(q_info->queueHandle,
+					       q_info->listenerHandle);
+	}
 
 	return rc;
 }
@@ -343,6 +407,9 @@ uint32_t mqnd_listenerq_destroy(MQND_QUEUE_INFO *q_info)
 	if (!q_info->listenerHandle)
 		return NCSCC_RC_SUCCESS;
 
+	if (m_MQSV_IS_SHMQ(q_info->queueHandle))
+		mqsv_shmq_listener_set(q_info->queueHandle, 0);
+
 	memset(&info, 0, sizeof(NCS_OS_POSIX_MQ_REQ_INFO));
 	info.req = NCS_OS_POSIX_MQ_REQ_CLOSE;
 	info.info.close.mqd = q_info->listenerHandle;
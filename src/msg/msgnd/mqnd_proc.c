@@ -76,7 +76,10 @@ uint32_t mqnd_evt_proc_mqp_qtransfer_complete(MQND_CB *cb, MQSV_EVT *req)
 		info.req = NCS_OS_MQ_REQ_DESTROY;
 		info.info.destroy.i_hdl = qhdl;
 
-		if (m_NCS_OS_MQ(&info) != NCSCC_RC_SUCCESS) {
+		if (m_MQSV_IS_SHMQ(qhdl)) {
+			if (mqnd_mq_destroy(&qnode->qinfo) != NCSCC_RC_SUCCESS)
+				return NCSCC_RC_FAILURE;
+		} else if (m_NCS_OS_MQ(&info) != NCSCC_RC_SUCCESS) {
 			LOG_ER("MSGQ Destroy routine Failed");
 			return (NCSCC_RC_FAILURE);
 		}
@@ -186,6 +189,7 @@ uint32_t mqnd_evt_proc_mqp_qtransfer_complete(MQND_CB *cb, MQSV_EVT *req)
 
 		if (rc == SA_AIS_OK) {
 			qnode->qinfo.owner_flag = MQSV_QUEUE_OWN_STATE_ORPHAN;
+			mqnd_mq_direct_set(&qnode->qinfo, true);
 			memset(&queue_ckpt_node, 0,
 			       sizeof(MQND_QUEUE_CKPT_INFO));
 			mqnd_cpy_qnodeinfo_to_ckptinfo(cb, qnode,
@@ -268,10 +272,13 @@ uint32_t mqnd_evt_proc_mqp_qtransfer(MQND_CB *cb, MQSV_EVT *req)
 		goto send_rsp;
 	}
 
+	/* No direct sends while the queue moves, they would be lost */
+	mqnd_mq_direct_set(&qnode->qinfo, false);
+
 	/* Read all the messages from the queue and pack it into buffer */
 	qreq.req = NCS_OS_POSIX_MQ_REQ_GET_ATTR;
 	qreq.info.attr.i_mqd = qhdl;
-	if (m_NCS_OS_POSIX_MQ(&qreq) != NCSCC_RC_SUCCESS) {
+	if (m_MQSV_POSIX_MQ(&qreq) != NCSCC_RC_SUCCESS) {
 		LOG_ER(
 		    "ERR_RESOURCES: Unable to get the queue attributes from the queue");
 		err = SA_AIS_ERR_NO_RESOURCES;
@@ -468,6 +475,10 @@ reg_req:
 		asapi_msg_free(&opr.info.msg.resp);
 
 send_rsp:
+	/* The queue stays here, let the agents send to it again */
+	if (qnode && qnode->qinfo.owner_flag != MQSV_QUEUE_OWN_STATE_PROGRESS)
+		mqnd_mq_direct_set(&qnode->qinfo, true);
+
 	/* Send the response */
 	transfer_rsp.type = MQSV_EVT_MQP_RSP;
 	transfer_rsp.msg.mqp_rsp.type = MQP_EVT_TRANSFER_QUEUE_RSP;
@@ -728,7 +739,7 @@ uint32_t mqnd_fill_queue_from_transfered_buffer(MQND_CB *cb,
 	    (transfer_rsp->msg_count *
 	     (sizeof(MQSV_MESSAGE) + sizeof(NCS_OS_MQ_MSG_LL_HDR)));
 
-	if (m_NCS_OS_POSIX_MQ(&info) != NCSCC_RC_SUCCESS) {
+	if (m_MQSV_POSIX_MQ(&info) != NCSCC_RC_SUCCESS) {
 		LOG_ER("Unable to resize the queue to the given size");
 		rc = NCSCC_RC_FAILURE;
 		return rc;
@@ -30,6 +30,7 @@
     mqnd_reset_queue_stats
     mqnd_find_shm_ckpt_empty_section
     mqnd_send_msg_update_stats_shm
+    mqnd_shmq_stats_sync
     mqnd_shm_queue_ckpt_section_invalidate
 
 ******************************************************************************/
@@ -53,7 +54,7 @@ uint32_t mqnd_shm_create(MQND_CB *cb)
 	NCS_OS_POSIX_SHM_REQ_INFO mqnd_open_req;
 	uint32_t rc = NCSCC_RC_SUCCESS;
 	char shm_name[] = SHM_NAME;
-	MQND_SHM_VERSION mqnd_shm_version;
+	MQND_SHM_VERSION mqnd_shm_version, *shm_version;
 	TRACE_ENTER();
 
 	cb->mqnd_shm.max_open_queues = cb->gl_msg_max_no_of_q;
@@ -100,6 +101,13 @@ uint32_t mqnd_shm_create(MQND_CB *cb)
 	} else
 		cb->is_create_ckpt = false;
 
+	/* Also when restarting, the shared memory may be from an older MQND */
+	shm_version = mqnd_open_req.info.open.o_addr;
+	shm_version->ckpt_info_size = sizeof(MQND_QUEUE_CKPT_INFO);
+	shm_version->stats_offset =
+	    offsetof(MQND_QUEUE_CKPT_INFO, QueueStatsShm);
+	shm_version->valid_offset = offsetof(MQND_QUEUE_CKPT_INFO, valid);
+
 	/* Store Shared memory start address which contains MQSV Sharedmemory
 	 * version */
 	cb->mqnd_shm.shm_start_addr = mqnd_open_req.info.open.o_addr;
@@ -229,6 +237,10 @@ uint32_t mqnd_send_msg_update_stats_shm(MQND_CB *cb, MQND_QUEUE_NODE *qnode,
 
 	shm_base_addr = cb->mqnd_shm.shm_base_addr;
 
+	/* A shared memory queue counts its messages itself */
+	if (m_MQSV_IS_SHMQ(qnode->qinfo.queueHandle))
+		return mqnd_shmq_stats_sync(cb, qnode);
+
 	offset = qnode->qinfo.shm_queue_index;
 	if (shm_base_addr[offset].valid == SHM_QUEUE_INFO_VALID) {
 		shm_base_addr[offset]
@@ -246,6 +258,64 @@ uint32_t mqnd_send_msg_update_stats_shm(MQND_CB *cb, MQND_QUEUE_NODE *qnode,
 	return NCSCC_RC_SUCCESS;
 }
 
+/****************************************************************************
+ * Name          : mqnd_shmq_stats_sync
+ *
+ * Description   : Function to copy the usage of a shared memory queue into
+ *                 the stats in shm. Agents on this node send to the queue
+ *                 without the MQND, so the queue holds the usage and the
+ *                 count of sends refused over the quota.
+ *
+ * Arguments     : MQND_QUEUE_NODE *qnode
+ *
+ * Return Values : NCSCC_RC_SUCCESS/Error.
+ *
+ * Notes         : Does nothing for a SysV queue.
+ *****************************************************************************/
+uint32_t mqnd_shmq_stats_sync(MQND_CB *cb, MQND_QUEUE_NODE *qnode)
+{
+	MQND_QUEUE_CKPT_INFO *shm_base_addr = cb->mqnd_shm.shm_base_addr;
+	MQND_QUEUE_CKPT_INFO queue_ckpt_node;
+	MQSV_SHMQ_STATS stats;
+	uint32_t offset, i, full = 0;
+
+	if (!m_MQSV_IS_SHMQ(qnode->qinfo.queueHandle))
+		return NCSCC_RC_SUCCESS;
+
+	offset = qnode->qinfo.shm_queue_index;
+	if (shm_base_addr[offset].valid != SHM_QUEUE_INFO_VALID)
+		return NCSCC_RC_FAILURE;
+
+	if (mqsv_shmq_stats_get(qnode->qinfo.queueHandle, &stats, true) !=
+	    NCSCC_RC_SUCCESS)
+		return NCSCC_RC_FAILURE;
+
+	shm_base_addr[offset].QueueStatsShm.totalQueueUsed = 0;
+	shm_base_addr[offset].QueueStatsShm.totalNumberOfMessages = 0;
+	for (i = SA_MSG_MESSAGE_HIGHEST_PRIORITY;
+	     i <= SA_MSG_MESSAGE_LOWEST_PRIORITY; i++) {
+		shm_base_addr[offset]
+		    .QueueStatsShm.saMsgQueueUsage[i]
+		    .queueUsed = stats.used[i];
+		shm_base_addr[offset]
+		    .QueueStatsShm.saMsgQueueUsage[i]
+		    .numberOfMessages = stats.num[i];
+		shm_base_addr[offset].QueueStatsShm.totalQueueUsed +=
+		    stats.used[i];
+		shm_base_addr[offset].QueueStatsShm.totalNumberOfMessages +=
+		    stats.num[i];
+		qnode->qinfo.numberOfFullErrors[i] += stats.full[i];
+		full += stats.full[i];
+	}
+
+	if (full != 0) {
+		memset(&queue_ckpt_node, 0, sizeof(MQND_QUEUE_CKPT_INFO));
+		mqnd_cpy_qnodeinfo_to_ckptinfo(cb, qnode, &queue_ckpt_node);
+		mqnd_ckpt_queue_info_write(cb, &queue_ckpt_node, offset);
+	}
+	return NCSCC_RC_SUCCESS;
+}
+
 /****************************************************************************
  * Name          : mqnd_shm_queue_ckpt_section_invalidate
  *
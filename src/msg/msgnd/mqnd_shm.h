@@ -36,13 +36,14 @@
 /*defines*/
 #define SHM_QUEUE_INFO_VALID 1
 #define SHM_QUEUE_INFO_INVALID 0
-#define SHM_NAME "NCS_MQND_QUEUE_CKPT_INFO"
+#define SHM_NAME MQSV_MQND_SHM_NAME
 
 uint32_t mqnd_shm_create(MQND_CB *cb);
 uint32_t mqnd_shm_destroy(MQND_CB *cb);
 uint32_t mqnd_find_shm_ckpt_empty_section(MQND_CB *cb, uint32_t *index);
 uint32_t mqnd_send_msg_update_stats_shm(MQND_CB *cb, MQND_QUEUE_NODE *qnode,
                                         SaSizeT size, SaUint8T priority);
+uint32_t mqnd_shmq_stats_sync(MQND_CB *cb, MQND_QUEUE_NODE *qnode);
 uint32_t mqnd_shm_queue_ckpt_section_invalidate(MQND_CB *cb,
                                                 MQND_QUEUE_NODE *qnode);
 void mqnd_reset_queue_stats(MQND_CB *cb, uint32_t index);
@@ -89,7 +89,7 @@ uint32_t mqnd_queue_create(MQND_CB *cb, MQP_OPEN_REQ *open, MDS_DEST *rcvr_mqa,
 	qnode->qinfo.owner_flag = MQSV_QUEUE_OWN_STATE_OWNED;
 
 	/* Open the Message Queue */
-	rc = mqnd_mq_create(&qnode->qinfo);
+	rc = mqnd_mq_create(cb, &qnode->qinfo);
 	if (rc != NCSCC_RC_SUCCESS) {
 		TRACE_2("Queue Creation Failed");
 		goto free_mem;
@@ -34,7 +34,7 @@
 #include "ntf/common/ntfsv_msg.h"
 #include "ntf/common/ntfsv_defs.h"
 
-#define NTFA_SVC_PVT_SUBPART_VERSION 1
+#define NTFA_SVC_PVT_SUBPART_VERSION NTFA_FANOUT_SVC_PVT_VERSION
 #define NTFA_WRT_NTFS_SUBPART_VER_AT_MIN_MSG_FMT 1
 #define NTFA_WRT_NTFS_SUBPART_VER_AT_MAX_MSG_FMT 1
 #define NTFA_WRT_NTFS_SUBPART_VER_RANGE       \
@@ -18,6 +18,8 @@
 #include <stdlib.h>
 #include "ntfa.h"
 #include "ntf/common/ntfsv_enc_dec.h"
+#include "ntf/common/ntfsv_filter.h"
+#include "ntf/common/ntfsv_mem.h"
 
 static MDS_CLIENT_MSG_FORMAT_VER
     NTFA_WRT_NTFS_MSG_FMT_ARRAY[NTFA_WRT_NTFS_SUBPART_VER_RANGE] = {
@@ -254,6 +256,186 @@ static uint32_t ntfa_enc_read_next_msg(NCS_UBAID *uba, ntfsv_msg_t *msg)
 	return NCSCC_RC_SUCCESS;
 }
 
+/****************************************************************************
+  Name          : ntfa_node_notification_post
+
+  Description   : This routine queues a notification callback for one
+		  subscription of a notification sent to all agents.
+
+  Arguments     : hdl_rec - client the subscription belongs to
+		  target - the subscription
+		  notification - decoded notification, taken over
+		  prio - MDS priority the notification was received with
+
+  Return Values : NCSCC_RC_SUCCESS/NCSCC_RC_FAILURE
+
+  Notes         : notification is freed on failure.
+******************************************************************************/
+static uint32_t ntfa_node_notification_post(
+    ntfa_client_hdl_rec_t *hdl_rec, const ntfsv_fanout_target_t *target,
+    ntfsv_send_not_req_t *notification, MDS_SEND_PRIORITY_TYPE prio)
+{
+	ntfsv_msg_t *msg;
+
+	msg = calloc(1, sizeof(ntfsv_msg_t));
+	if (msg == NULL) {
+		TRACE_1("could not allocate memory");
+		ntfsv_dealloc_notification(notification);
+		free(notification);
+		return NCSCC_RC_FAILURE;
+	}
+	notification->subscriptionId = target->subscriptionId;
+	msg->type = NTFSV_NTFS_CBK_MSG;
+	msg->info.cbk_info.type = NTFSV_NOTIFICATION_CALLBACK;
+	msg->info.cbk_info.ntfs_client_id = target->client_id;
+	msg->info.cbk_info.subscriptionId = target->subscriptionId;
+	msg->info.cbk_info.mds_send_priority = prio;
+	msg->info.cbk_info.param.notification_cbk = notification;
+	if (NCSCC_RC_SUCCESS != m_NCS_IPC_SEND(&hdl_rec->mbx, msg, prio)) {
+		TRACE("IPC SEND FAILED");
+		ntfa_msg_destroy(msg);
+		return NCSCC_RC_FAILURE;
+	}
+	return NCSCC_RC_SUCCESS;
+}
+
+/****************************************************************************
+  Name          : ntfa_node_subscriber_get
+
+  Description   : This routine finds the subscription of a notification
+		  sent to all agents among the subscriptions of a client.
+
+  Arguments     : hdl_rec - client the subscription belongs to
+		  subscriptionId - the subscription
+
+  Return Values : The subscription or NULL if the client does not have it
+
+  Notes         : Called with cb_lock held.
+******************************************************************************/
+static ntfa_subscriber_list_t *
+ntfa_node_subscriber_get(const ntfa_client_hdl_rec_t *hdl_rec,
+			 SaNtfSubscriptionIdT subscriptionId)
+{
+	ntfa_subscriber_list_t *listPtr;
+
+	for (listPtr = subscriberNoList; listPtr != NULL;
+	     listPtr = listPtr->next) {
+		if (listPtr->subscriberListSubscriptionId == subscriptionId &&
+		    listPtr->subscriberListNtfHandle == hdl_rec->local_hdl)
+			break;
+	}
+	return listPtr;
+}
+
+/****************************************************************************
+  Name          : ntfa_node_notification_proc
+
+  Description   : This routine delivers a notification sent to all agents
+		  to the target subscriptions of this process whose filters
+		  match it, as if each had been sent a
+		  NTFSV_NOTIFICATION_CALLBACK. The NTFS has not checked the
+		  filters, so every own target is then confirmed back to it
+		  in one NTFSV_FANOUT_CONFIRM_REQ: as discarded if the
+		  callback could not be queued, else as sent.
+
+  Arguments     : cb - ptr to the NTFA control block
+		  ntfsv_msg - the NTFSV_NOTIFICATION_NODE_CALLBACK msg
+		  prio - MDS priority the msg was received with
+
+  Return Values : None
+
+  Notes         : ntfsv_msg is freed. Each matching target gets a copy of
+		  the decoded notification.
+******************************************************************************/
+static void ntfa_node_notification_proc(ntfa_cb_t *cb, ntfsv_msg_t *ntfsv_msg,
+					MDS_SEND_PRIORITY_TYPE prio)
+{
+	ntfsv_node_notification_cbk_t *param =
+	    &ntfsv_msg->info.cbk_info.param.node_notification_cbk;
+	SaNtfNotificationHeaderT *header;
+	ntfsv_fanout_confirm_req_t *confirm;
+	ntfsv_msg_t msg;
+	uint32_t i;
+
+	TRACE_ENTER2("targets: %u", param->num_targets);
+	if (param->notification == NULL)
+		goto done;
+
+	memset(&msg, 0, sizeof(ntfsv_msg_t));
+	msg.type = NTFSV_NTFA_API_MSG;
+	msg.info.api_info.type = NTFSV_FANOUT_CONFIRM_REQ;
+	confirm = &msg.info.api_info.param.fanout_confirm;
+	ntfsv_get_ntf_header(param->notification, &header);
+	confirm->notificationId = *header->notificationId;
+	confirm->confirmed =
+	    calloc(param->num_targets, sizeof(ntfsv_fanout_target_t));
+	confirm->discarded =
+	    calloc(param->num_targets, sizeof(ntfsv_fanout_target_t));
+	if (confirm->confirmed == NULL || confirm->discarded == NULL) {
+		/* Without a confirmation the NTFS keeps the notification
+		   until the subscriptions are removed, deliver anyway. */
+		LOG_ER("Out of memory for notification %llu confirmation",
+		       confirm->notificationId);
+	}
+
+	for (i = 0; i < param->num_targets; i++) {
+		const ntfsv_fanout_target_t *target = &param->targets[i];
+		ntfa_client_hdl_rec_t *hdl_rec;
+		ntfa_subscriber_list_t *subscriber;
+		ntfsv_send_not_req_t *copy;
+		bool sent = true;
+
+		hdl_rec =
+		    ntfa_find_hdl_rec_by_client_id(cb, target->client_id);
+		if (hdl_rec == NULL)
+			continue;
+		subscriber =
+		    ntfa_node_subscriber_get(hdl_rec, target->subscriptionId);
+		if (subscriber != NULL &&
+		    ntfsv_filter_match(&subscriber->filters,
+				       param->notification)) {
+			TRACE_2("subscriptionId = %u, client_id = %u",
+				target->subscriptionId, target->client_id);
+			copy = calloc(1, sizeof(ntfsv_send_not_req_t));
+			if (copy == NULL) {
+				TRACE_1("could not allocate memory");
+				sent = false;
+			} else {
+				copy->notificationType =
+				    param->notification->notificationType;
+				if (ntfsv_alloc_and_copy_not(
+					copy, param->notification) !=
+				    SA_AIS_OK) {
+					TRACE_1("could not copy notification");
+					ntfsv_dealloc_notification(copy);
+					free(copy);
+					sent = false;
+				} else if (ntfa_node_notification_post(
+					       hdl_rec, target, copy, prio) !=
+					   NCSCC_RC_SUCCESS) {
+					sent = false;
+				}
+			}
+		}
+		if (confirm->confirmed == NULL || confirm->discarded == NULL)
+			continue;
+		if (sent)
+			confirm->confirmed[confirm->num_confirmed++] = *target;
+		else
+			confirm->discarded[confirm->num_discarded++] = *target;
+	}
+
+	if (confirm->num_confirmed + confirm->num_discarded > 0 &&
+	    ntfa_mds_msg_async_send(cb, &msg, prio) != NCSCC_RC_SUCCESS)
+		LOG_NO("Could not confirm notification %llu",
+		       confirm->notificationId);
+	free(confirm->confirmed);
+	free(confirm->discarded);
+done:
+	ntfa_msg_destroy(ntfsv_msg);
+	TRACE_LEAVE();
+}
+
 /****************************************************************************
   Name          : ntfa_ntfs_msg_proc
 
@@ -331,6 +513,9 @@ uint32_t ntfa_ntfs_msg_proc(ntfa_cb_t *cb, ntfsv_msg_t *ntfsv_msg,
 				return NCSCC_RC_FAILURE;
 			}
 		} break;
+		case NTFSV_NOTIFICATION_NODE_CALLBACK:
+			ntfa_node_notification_proc(cb, ntfsv_msg, prio);
+			break;
 		case NTFSV_DISCARDED_CALLBACK: {
 			ntfa_client_hdl_rec_t *ntfa_hdl_rec;
 
@@ -587,6 +772,11 @@ static uint32_t ntfa_mds_enc(struct ncsmds_callback_info *info)
 			rc = ntfa_enc_read_next_msg(uba, msg);
 			break;
 
+		case NTFSV_FANOUT_CONFIRM_REQ:
+			rc = ntfsv_enc_fanout_confirm(
+			    uba, &msg->info.api_info.param.fanout_confirm);
+			break;
+
 		default:
 			TRACE("Unknown API type = %d", msg->info.api_info.type);
 			rc = NCSCC_RC_FAILURE;
@@ -646,6 +836,54 @@ static uint32_t ntfa_dec_not_send_cbk_msg(NCS_UBAID *uba, ntfsv_msg_t *msg)
 	return ntfsv_dec_not_msg(uba, param);
 }
 
+/****************************************************************************
+  Name          : ntfa_dec_not_node_cbk_msg
+
+  Description   : This routine decodes a notification callback msg sent to
+		  all agents. The notification is only decoded if one of
+		  the target subscriptions is in this process.
+
+  Arguments     : NCS_UBAID *msg,
+		  NTFSV_MSG *msg
+
+  Return Values : uint32_t
+
+  Notes         : None.
+******************************************************************************/
+static uint32_t ntfa_dec_not_node_cbk_msg(NCS_UBAID *uba, ntfsv_msg_t *msg)
+{
+	ntfsv_node_notification_cbk_t *param =
+	    &msg->info.cbk_info.param.node_notification_cbk;
+	bool local = false;
+	uint32_t rc;
+	uint32_t i;
+
+	osafassert(uba != NULL);
+	rc = ntfsv_dec_fanout_targets(uba, &param->num_targets,
+				      &param->targets);
+	if (rc != NCSCC_RC_SUCCESS)
+		return rc;
+
+	osafassert(pthread_mutex_lock(&ntfa_cb.cb_lock) == 0);
+	for (i = 0; i < param->num_targets && !local; i++) {
+		if (ntfa_find_hdl_rec_by_client_id(
+			&ntfa_cb, param->targets[i].client_id) != NULL)
+			local = true;
+	}
+	osafassert(pthread_mutex_unlock(&ntfa_cb.cb_lock) == 0);
+	if (!local) {
+		TRACE_2("no subscription in this process");
+		return NCSCC_RC_SUCCESS;
+	}
+
+	param->notification = calloc(1, sizeof(ntfsv_send_not_req_t));
+	if (param->notification == NULL) {
+		TRACE_1("could not allocate memory");
+		return NCSCC_RC_OUT_OF_MEM;
+	}
+	return ntfsv_dec_not_msg(uba, param->notification);
+}
+
 /****************************************************************************
   Name          : ntfa_dec_not_discard_cbk_msg
 
@@ -944,6 +1182,10 @@ static uint32_t ntfa_mds_dec(struct ncsmds_callback_info *info)
 			TRACE_2("decode clm node status cbk message");
 			rc = ntfa_dec_clm_node_status_cbk_msg(uba, msg);
 			break;
+		case NTFSV_NOTIFICATION_NODE_CALLBACK:
+			TRACE_2("decode notification node cbk message");
+			rc = ntfa_dec_not_node_cbk_msg(uba, msg);
+			break;
 		default:
 			TRACE_2("Unknown callback type = %d!",
 				msg->info.cbk_info.type);
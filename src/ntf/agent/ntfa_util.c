@@ -748,6 +748,15 @@ void ntfa_msg_destroy(ntfsv_msg_t *msg)
 			ntfsv_dealloc_notification(
 			    msg->info.cbk_info.param.notification_cbk);
 			free(msg->info.cbk_info.param.notification_cbk);
+		} else if (msg->info.cbk_info.type ==
+			   NTFSV_NOTIFICATION_NODE_CALLBACK) {
+			ntfsv_node_notification_cbk_t *param =
+			    &msg->info.cbk_info.param.node_notification_cbk;
+			if (param->notification != NULL) {
+				ntfsv_dealloc_notification(param->notification);
+				free(param->notification);
+			}
+			free(param->targets);
 		}
 	} else {
 		if (msg->info.api_resp_info.rc == SA_AIS_OK) {
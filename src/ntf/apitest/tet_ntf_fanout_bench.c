@@ -0,0 +1,190 @@
+/*      -*- OpenSAF  -*-
+ *
+ * (C) Copyright 2017 The OpenSAF Foundation
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. This file and program are licensed
+ * under the GNU Lesser General Public License Version 2.1, February 1999.
+ * The complete license can be accessed from the following location:
+ * http://opensource.org/licenses/lgpl-license.php
+ * See the Copying file included with the OpenSAF distribution for full
+ * licensing terms.
+ *
+ */
+/**
+ * Measures the notifications per second delivered to a growing number of
+ * subscribers in this process. Every second subscriber filters on another
+ * event type and must not get the notifications. Run it with and without
+ * NTFSV_ENV_NODE_FANOUT=1 in ntfd.conf to compare the broadcast to the
+ * per subscription sends:
+ *
+ *	$ ntftest 41
+ */
+#include <poll.h>
+#include <time.h>
+#include "osaf/apitest/utest.h"
+#include "osaf/apitest/util.h"
+#include "tet_ntf.h"
+#include "tet_ntf_common.h"
+
+#define BENCH_MAX_SUBSCRIBERS 128
+#define BENCH_NOTIFICATIONS 1000
+#define BENCH_SUBSCRIPTION_ID 4100
+#define BENCH_TIMEOUT_MS 30000
+
+static SaNtfHandleT bench_handles[BENCH_MAX_SUBSCRIBERS];
+static SaNtfAlarmNotificationFilterT bench_filters[BENCH_MAX_SUBSCRIBERS];
+static unsigned int bench_received;
+static unsigned int bench_unexpected;
+
+static void bench_notification_cb(SaNtfSubscriptionIdT subscriptionId,
+				  const SaNtfNotificationsT *notification)
+{
+	/* The odd subscribers filter the notifications out */
+	if ((subscriptionId - BENCH_SUBSCRIPTION_ID) % 2)
+		bench_unexpected++;
+	else
+		bench_received++;
+	saNtfNotificationFree(
+	    notification->notification.alarmNotification.notificationHandle);
+}
+
+static const SaNtfCallbacksT bench_callbacks = {bench_notification_cb, NULL};
+
+static double bench_elapsed(const struct timespec *start)
+{
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (now.tv_sec - start->tv_sec) +
+	       (now.tv_nsec - start->tv_nsec) / 1e9;
+}
+
+/**
+ * Subscribes with num handles, sends BENCH_NOTIFICATIONS alarms and
+ * dispatches until the matching subscribers got all of them.
+ */
+static SaAisErrorT bench_run(unsigned int num)
+{
+	SaNtfNotificationTypeFilterHandlesT filterHandles;
+	SaNtfAlarmNotificationT alarm;
+	struct pollfd fds[BENCH_MAX_SUBSCRIBERS];
+	unsigned int expected = BENCH_NOTIFICATIONS * ((num + 1) / 2);
+	struct timespec start;
+	SaAisErrorT result = SA_AIS_OK;
+	double elapsed;
+	unsigned int i;
+
+	bench_received = 0;
+	bench_unexpected = 0;
+	for (i = 0; i < num; i++) {
+		SaSelectionObjectT selObj;
+
+		safassert(saNtfInitialize(&bench_handles[i], &bench_callbacks,
+					  &ntfVersion),
+			  SA_AIS_OK);
+		safassert(saNtfSelectionObjectGet(bench_handles[i], &selObj),
+			  SA_AIS_OK);
+		fds[i].fd = (int)selObj;
+		fds[i].events = POLLIN;
+		safassert(saNtfAlarmNotificationFilterAllocate(
+			      bench_handles[i], &bench_filters[i], 1, 0, 0, 0,
+			      0, 0, 0),
+			  SA_AIS_OK);
+		bench_filters[i].notificationFilterHeader.eventTypes[0] =
+		    (i % 2) ? SA_NTF_ALARM_EQUIPMENT
+			    : SA_NTF_ALARM_COMMUNICATION;
+		memset(&filterHandles, 0, sizeof(filterHandles));
+		filterHandles.alarmFilterHandle =
+		    bench_filters[i].notificationFilterHandle;
+		safassert(saNtfNotificationSubscribe(
+			      &filterHandles, BENCH_SUBSCRIPTION_ID + i),
+			  SA_AIS_OK);
+	}
+
+	safassert(saNtfAlarmNotificationAllocate(
+		      bench_handles[0], &alarm, 0,
+		      (SaUint16T)(strlen(DEFAULT_ADDITIONAL_TEXT) + 1), 0, 0, 0,
+		      0, SA_NTF_ALLOC_SYSTEM_LIMIT),
+		  SA_AIS_OK);
+	fillHeader(&alarm.notificationHeader);
+	*alarm.perceivedSeverity = SA_NTF_SEVERITY_WARNING;
+	*alarm.probableCause = SA_NTF_BANDWIDTH_REDUCED;
+	*alarm.trend = SA_NTF_TREND_MORE_SEVERE;
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	for (i = 0; i < BENCH_NOTIFICATIONS; i++) {
+		safassert(saNtfNotificationSend(alarm.notificationHandle),
+			  SA_AIS_OK);
+		/* Keep the callback queues short while sending */
+		if ((i % 100) == 99) {
+			unsigned int j;
+
+			for (j = 0; j < num; j++)
+				saNtfDispatch(bench_handles[j],
+					      SA_DISPATCH_ALL);
+		}
+	}
+	while (bench_received < expected) {
+		int n = poll(fds, num, 1000);
+
+		if (n > 0) {
+			for (i = 0; i < num; i++) {
+				if (fds[i].revents & POLLIN)
+					saNtfDispatch(bench_handles[i],
+						      SA_DISPATCH_ALL);
+			}
+		}
+		if (bench_elapsed(&start) * 1000 > BENCH_TIMEOUT_MS) {
+			result = SA_AIS_ERR_TIMEOUT;
+			break;
+		}
+	}
+	elapsed = bench_elapsed(&start);
+
+	printf("%3u subscribers: %u notifications, %u callbacks in %.3f s, "
+	       "%.0f notifications/s, %.0f callbacks/s\n",
+	       num, BENCH_NOTIFICATIONS, bench_received, elapsed,
+	       BENCH_NOTIFICATIONS / elapsed, bench_received / elapsed);
+	if (bench_unexpected != 0) {
+		printf("%u callbacks for subscriptions filtering them out\n",
+		       bench_unexpected);
+		result = SA_AIS_ERR_FAILED_OPERATION;
+	}
+
+	safassert(saNtfNotificationFree(alarm.notificationHandle), SA_AIS_OK);
+	for (i = 0; i < num; i++) {
+		safassert(saNtfNotificationUnsubscribe(BENCH_SUBSCRIPTION_ID +
+						       i),
+			  SA_AIS_OK);
+		safassert(saNtfNotificationFilterFree(
+			      bench_filters[i].notificationFilterHandle),
+			  SA_AIS_OK);
+		safassert(saNtfFinalize(bench_handles[i]), SA_AIS_OK);
+	}
+	return result;
+}
+
+static void ntfFanoutBench_01(void) { test_validate(bench_run(1), SA_AIS_OK); }
+
+static void ntfFanoutBench_02(void) { test_validate(bench_run(8), SA_AIS_OK); }
+
+static void ntfFanoutBench_03(void)
+{
+	test_validate(bench_run(32), SA_AIS_OK);
+}
+
+static void ntfFanoutBench_04(void)
+{
+	test_validate(bench_run(BENCH_MAX_SUBSCRIBERS), SA_AIS_OK);
+}
+
+__attribute__((constructor)) static void ntfFanoutBench_constructor(void)
+{
+	test_suite_add(41, "Notifications per second vs number of subscribers");
+	test_case_add(41, ntfFanoutBench_01, "1 subscriber");
+	test_case_add(41, ntfFanoutBench_02, "8 subscribers, 4 matching");
+	test_case_add(41, ntfFanoutBench_03, "32 subscribers, 16 matching");
+	test_case_add(41, ntfFanoutBench_04, "128 subscribers, 64 matching");
+}
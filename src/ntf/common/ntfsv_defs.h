@@ -26,4 +26,8 @@
 #define NTF_MAJOR_VERSION_0 1
 #define NTF_MINOR_VERSION_0 1
 
+/* First NTFA MDS private version that takes notifications broadcast by the
+   NTFS with NTFSV_NOTIFICATION_NODE_CALLBACK */
+#define NTFA_FANOUT_SVC_PVT_VERSION 2
+
 #endif  // NTF_COMMON_NTFSV_DEFS_H_
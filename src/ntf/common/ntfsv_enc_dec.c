@@ -895,6 +895,58 @@ uint32_t ntfsv_enc_discard_msg(NCS_UBAID *uba, ntfsv_discarded_info_t *param)
 	return rv;
 }
 
+uint32_t ntfsv_enc_fanout_targets(NCS_UBAID *uba, uint32_t num_targets,
+				  const ntfsv_fanout_target_t *targets)
+{
+	uint8_t *p8;
+	uint32_t i;
+
+	TRACE_ENTER2("num_targets: %u", num_targets);
+	osafassert(uba != NULL);
+	p8 = ncs_enc_reserve_space(uba, 4);
+	if (!p8) {
+		TRACE("ncs_enc_reserve_space failed");
+		return NCSCC_RC_OUT_OF_MEM;
+	}
+	ncs_encode_32bit(&p8, num_targets);
+	ncs_enc_claim_space(uba, 4);
+	for (i = 0; i < num_targets; i++) {
+		p8 = ncs_enc_reserve_space(uba, 8);
+		if (!p8) {
+			TRACE_1("encoding error");
+			TRACE_LEAVE();
+			return NCSCC_RC_OUT_OF_MEM;
+		}
+		ncs_encode_32bit(&p8, targets[i].client_id);
+		ncs_encode_32bit(&p8, targets[i].subscriptionId);
+		ncs_enc_claim_space(uba, 8);
+	}
+	TRACE_LEAVE();
+	return NCSCC_RC_SUCCESS;
+}
+
+uint32_t ntfsv_enc_fanout_confirm(NCS_UBAID *uba,
+				  const ntfsv_fanout_confirm_req_t *param)
+{
+	uint8_t *p8;
+	uint32_t rc;
+
+	osafassert(uba != NULL);
+	p8 = ncs_enc_reserve_space(uba, 8);
+	if (!p8) {
+		TRACE("ncs_enc_reserve_space failed");
+		return NCSCC_RC_OUT_OF_MEM;
+	}
+	ncs_encode_64bit(&p8, param->notificationId);
+	ncs_enc_claim_space(uba, 8);
+	rc = ntfsv_enc_fanout_targets(uba, param->num_confirmed,
+				      param->confirmed);
+	if (rc != NCSCC_RC_SUCCESS)
+		return rc;
+	return ntfsv_enc_fanout_targets(uba, param->num_discarded,
+					param->discarded);
+}
+
 static uint32_t ntfsv_dec_not_header(NCS_UBAID *uba,
 				     SaNtfNotificationHeaderT *param)
 {
@@ -1272,6 +1324,65 @@ uint32_t ntfsv_dec_discard_msg(NCS_UBAID *uba, ntfsv_discarded_info_t *param)
 	return NCSCC_RC_SUCCESS;
 }
 
+uint32_t ntfsv_dec_fanout_targets(NCS_UBAID *uba, uint32_t *num_targets,
+				  ntfsv_fanout_target_t **targets)
+{
+	uint8_t *p8;
+	uint8_t local_data[8];
+	uint32_t i;
+
+	TRACE_ENTER();
+	p8 = ncs_dec_flatten_space(uba, local_data, 4);
+	*num_targets = ncs_decode_32bit(&p8);
+	ncs_dec_skip_space(uba, 4);
+	TRACE_3("num_targets: %u", *num_targets);
+	*targets = NULL;
+	if (*num_targets == 0) {
+		TRACE_LEAVE();
+		return NCSCC_RC_SUCCESS;
+	}
+	*targets = calloc(*num_targets, sizeof(ntfsv_fanout_target_t));
+	if (!*targets) {
+		/* Skip the targets so the rest can still be decoded */
+		ncs_dec_skip_space(uba, *num_targets * 8);
+		*num_targets = 0;
+		TRACE_LEAVE();
+		return NCSCC_RC_OUT_OF_MEM;
+	}
+	for (i = 0; i < *num_targets; i++) {
+		p8 = ncs_dec_flatten_space(uba, local_data, 8);
+		(*targets)[i].client_id = ncs_decode_32bit(&p8);
+		(*targets)[i].subscriptionId = ncs_decode_32bit(&p8);
+		ncs_dec_skip_space(uba, 8);
+	}
+	TRACE_LEAVE();
+	return NCSCC_RC_SUCCESS;
+}
+
+uint32_t ntfsv_dec_fanout_confirm(NCS_UBAID *uba,
+				  ntfsv_fanout_confirm_req_t *param)
+{
+	uint8_t *p8;
+	uint8_t local_data[8];
+	uint32_t rc;
+
+	p8 = ncs_dec_flatten_space(uba, local_data, 8);
+	param->notificationId = ncs_decode_64bit(&p8);
+	ncs_dec_skip_space(uba, 8);
+	rc = ntfsv_dec_fanout_targets(uba, &param->num_confirmed,
+				      &param->confirmed);
+	if (rc != NCSCC_RC_SUCCESS)
+		return rc;
+	rc = ntfsv_dec_fanout_targets(uba, &param->num_discarded,
+				      &param->discarded);
+	if (rc != NCSCC_RC_SUCCESS) {
+		free(param->confirmed);
+		param->confirmed = NULL;
+		param->num_confirmed = 0;
+	}
+	return rc;
+}
+
 uint32_t ntfsv_enc_filter_header(NCS_UBAID *uba,
 				 SaNtfNotificationFilterHeaderT *h)
 {
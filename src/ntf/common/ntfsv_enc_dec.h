@@ -36,6 +36,14 @@ uint32_t ntfsv_enc_not_msg(NCS_UBAID *uba, ntfsv_send_not_req_t *param);
 uint32_t ntfsv_enc_discard_msg(NCS_UBAID *uba, ntfsv_discarded_info_t *param);
 uint32_t ntfsv_dec_not_msg(NCS_UBAID *uba, ntfsv_send_not_req_t *param);
 uint32_t ntfsv_dec_discard_msg(NCS_UBAID *uba, ntfsv_discarded_info_t *param);
+uint32_t ntfsv_enc_fanout_targets(NCS_UBAID *uba, uint32_t num_targets,
+                                  const ntfsv_fanout_target_t *targets);
+uint32_t ntfsv_dec_fanout_targets(NCS_UBAID *uba, uint32_t *num_targets,
+                                  ntfsv_fanout_target_t **targets);
+uint32_t ntfsv_enc_fanout_confirm(NCS_UBAID *uba,
+                                  const ntfsv_fanout_confirm_req_t *param);
+uint32_t ntfsv_dec_fanout_confirm(NCS_UBAID *uba,
+                                  ntfsv_fanout_confirm_req_t *param);
 uint32_t ntfsv_enc_subscribe_msg(NCS_UBAID *uba, ntfsv_subscribe_req_t *param);
 uint32_t ntfsv_dec_subscribe_msg(NCS_UBAID *uba, ntfsv_subscribe_req_t *param);
 uint32_t ntfsv_enc_unsubscribe_msg(NCS_UBAID *uba,
@@ -0,0 +1,269 @@
+/*      -*- OpenSAF  -*-
+ *
+ * (C) Copyright 2017 The OpenSAF Foundation
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. This file and program are licensed
+ * under the GNU Lesser General Public License Version 2.1, February 1999.
+ * The complete license can be accessed from the following location:
+ * http://opensource.org/licenses/lgpl-license.php
+ * See the Copying file included with the OpenSAF distribution for full
+ * licensing terms.
+ *
+ */
+
+/*
+ * Checks a notification against the filters of a subscription, the agent
+ * side counterpart of NtfFilter::checkFilter in the NTFS.
+ */
+
+#include "ntf/common/ntfsv_filter.h"
+#include <string.h>
+#include "base/osaf_extended_name.h"
+#include "base/ncsgl_defs.h"
+
+static bool match_values(const SaUint32T *values, SaUint16T num,
+			 SaUint32T value)
+{
+	SaUint16T i;
+
+	if (num == 0)
+		return true;
+	for (i = 0; i < num; i++) {
+		if (values[i] == value)
+			return true;
+	}
+	return false;
+}
+
+#define MATCH_ENUMS(array, num, value)                                         \
+	match_enums((const void *)(array), sizeof(*(array)), (num),           \
+		    (SaUint32T)(value))
+
+/* The filter enums have the size of an int, compare them as such */
+static bool match_enums(const void *array, size_t size, SaUint16T num,
+			SaUint32T value)
+{
+	osafassert(size == sizeof(SaUint32T));
+	return match_values((const SaUint32T *)array, num, value);
+}
+
+static bool match_names(const SaNameT *names, SaUint16T num,
+			const SaNameT *name)
+{
+	SaConstStringT str = osaf_extended_name_borrow(name);
+	size_t length = strlen(str);
+	SaUint16T i;
+
+	if (num == 0)
+		return true;
+	for (i = 0; i < num; i++) {
+		SaConstStringT f = osaf_extended_name_borrow(&names[i]);
+		size_t f_length = strlen(f);
+
+		if (f_length == length) {
+			if (memcmp(f, str, length) == 0)
+				return true;
+		} else if (f_length < length && strstr(str, f) != NULL) {
+			return true;
+		}
+	}
+	return false;
+}
+
+static bool match_class_ids(const SaNtfClassIdT *ids, SaUint16T num,
+			    const SaNtfClassIdT *id)
+{
+	SaUint16T i;
+
+	if (num == 0)
+		return true;
+	for (i = 0; i < num; i++) {
+		if (ids[i].vendorId == id->vendorId &&
+		    ids[i].majorId == id->majorId &&
+		    ids[i].minorId == id->minorId)
+			return true;
+	}
+	return false;
+}
+
+/* As NtfFilter::cmpSaNtfValueT, only numeric values are compared */
+static bool match_value(SaNtfValueTypeT f_type, const SaNtfValueT *f,
+			SaNtfValueTypeT type, const SaNtfValueT *v)
+{
+	if (f_type != type)
+		return false;
+	switch (type) {
+	case SA_NTF_VALUE_UINT8:
+		return f->uint8Val == v->uint8Val;
+	case SA_NTF_VALUE_INT8:
+		return f->int8Val == v->int8Val;
+	case SA_NTF_VALUE_UINT16:
+		return f->uint16Val == v->uint16Val;
+	case SA_NTF_VALUE_INT16:
+		return f->int16Val == v->int16Val;
+	case SA_NTF_VALUE_UINT32:
+		return f->uint32Val == v->uint32Val;
+	case SA_NTF_VALUE_INT32:
+		return f->int32Val == v->int32Val;
+	case SA_NTF_VALUE_FLOAT:
+		return f->floatVal == v->floatVal;
+	case SA_NTF_VALUE_UINT64:
+		return f->uint64Val == v->uint64Val;
+	case SA_NTF_VALUE_INT64:
+		return f->int64Val == v->int64Val;
+	case SA_NTF_VALUE_DOUBLE:
+		return f->doubleVal == v->doubleVal;
+	case SA_NTF_VALUE_LDAP_NAME:
+	case SA_NTF_VALUE_STRING:
+	case SA_NTF_VALUE_IPADDRESS:
+	case SA_NTF_VALUE_BINARY:
+	case SA_NTF_VALUE_ARRAY:
+		return true;
+	default:
+		return false;
+	}
+}
+
+static bool match_detectors(const SaNtfSecurityAlarmDetectorT *values,
+			    SaUint16T num,
+			    const SaNtfSecurityAlarmDetectorT *value)
+{
+	SaUint16T i;
+
+	if (num == 0)
+		return true;
+	for (i = 0; i < num; i++) {
+		if (match_value(values[i].valueType, &values[i].value,
+				value->valueType, &value->value))
+			return true;
+	}
+	return false;
+}
+
+static bool match_service_users(const SaNtfServiceUserT *values,
+				SaUint16T num, const SaNtfServiceUserT *value)
+{
+	SaUint16T i;
+
+	if (num == 0)
+		return true;
+	for (i = 0; i < num; i++) {
+		if (match_value(values[i].valueType, &values[i].value,
+				value->valueType, &value->value))
+			return true;
+	}
+	return false;
+}
+
+static bool match_header(const SaNtfNotificationFilterHeaderT *f,
+			 const SaNtfNotificationHeaderT *h)
+{
+	return match_class_ids(f->notificationClassIds,
+			       f->numNotificationClassIds,
+			       h->notificationClassId) &&
+	       MATCH_ENUMS(f->eventTypes, f->numEventTypes, *h->eventType) &&
+	       match_names(f->notificationObjects, f->numNotificationObjects,
+			   h->notificationObject) &&
+	       match_names(f->notifyingObjects, f->numNotifyingObjects,
+			   h->notifyingObject);
+}
+
+static bool match_alarm(const SaNtfAlarmNotificationFilterT *f,
+			const SaNtfAlarmNotificationT *a)
+{
+	return match_header(&f->notificationFilterHeader,
+			    &a->notificationHeader) &&
+	       MATCH_ENUMS(f->trends, f->numTrends, *a->trend) &&
+	       MATCH_ENUMS(f->perceivedSeverities, f->numPerceivedSeverities,
+			   *a->perceivedSeverity) &&
+	       MATCH_ENUMS(f->probableCauses, f->numProbableCauses,
+			   *a->probableCause);
+}
+
+static bool match_sec_alarm(const SaNtfSecurityAlarmNotificationFilterT *f,
+			    const SaNtfSecurityAlarmNotificationT *s)
+{
+	return match_header(&f->notificationFilterHeader,
+			    &s->notificationHeader) &&
+	       MATCH_ENUMS(f->probableCauses, f->numProbableCauses,
+			   *s->probableCause) &&
+	       MATCH_ENUMS(f->severities, f->numSeverities, *s->severity) &&
+	       match_detectors(f->securityAlarmDetectors,
+			       f->numSecurityAlarmDetectors,
+			       s->securityAlarmDetector) &&
+	       match_service_users(f->serviceUsers, f->numServiceUsers,
+				   s->serviceUser) &&
+	       match_service_users(f->serviceProviders,
+				   f->numServiceProviders, s->serviceProvider);
+}
+
+static bool match_state_change(const SaNtfStateChangeNotificationFilterT *f,
+			       const SaNtfStateChangeNotificationT *s)
+{
+	SaUint16T i;
+
+	if (!match_header(&f->notificationFilterHeader,
+			  &s->notificationHeader) ||
+	    !MATCH_ENUMS(f->sourceIndicators, f->numSourceIndicators,
+			 *s->sourceIndicator))
+		return false;
+	if (f->numStateChanges == 0)
+		return true;
+	for (i = 0; i < s->numStateChanges; i++) {
+		SaUint16T j;
+
+		for (j = 0; j < f->numStateChanges; j++) {
+			if (f->changedStates[j].stateId ==
+			    s->changedStates[i].stateId)
+				return true;
+		}
+	}
+	return false;
+}
+
+bool ntfsv_filter_match(const ntfsv_filter_ptrs_t *filters,
+			const ntfsv_send_not_req_t *notification)
+{
+	const SaNtfObjectCreateDeleteNotificationT *o;
+	const SaNtfAttributeChangeNotificationT *a;
+
+	switch (notification->notificationType) {
+	case SA_NTF_TYPE_ALARM:
+		return filters->alarm_filter != NULL &&
+		       match_alarm(filters->alarm_filter,
+				   &notification->notification.alarm);
+	case SA_NTF_TYPE_SECURITY_ALARM:
+		return filters->sec_al_filter != NULL &&
+		       match_sec_alarm(
+			   filters->sec_al_filter,
+			   &notification->notification.securityAlarm);
+	case SA_NTF_TYPE_STATE_CHANGE:
+		return filters->sta_ch_filter != NULL &&
+		       match_state_change(
+			   filters->sta_ch_filter,
+			   &notification->notification.stateChange);
+	case SA_NTF_TYPE_OBJECT_CREATE_DELETE:
+		o = &notification->notification.objectCreateDelete;
+		return filters->obj_cr_del_filter != NULL &&
+		       match_header(&filters->obj_cr_del_filter
+					 ->notificationFilterHeader,
+				    &o->notificationHeader) &&
+		       MATCH_ENUMS(
+			   filters->obj_cr_del_filter->sourceIndicators,
+			   filters->obj_cr_del_filter->numSourceIndicators,
+			   *o->sourceIndicator);
+	case SA_NTF_TYPE_ATTRIBUTE_CHANGE:
+		a = &notification->notification.attributeChange;
+		return filters->att_ch_filter != NULL &&
+		       match_header(
+			   &filters->att_ch_filter->notificationFilterHeader,
+			   &a->notificationHeader) &&
+		       MATCH_ENUMS(filters->att_ch_filter->sourceIndicators,
+				   filters->att_ch_filter->numSourceIndicators,
+				   *a->sourceIndicator);
+	default:
+		return false;
+	}
+}
@@ -0,0 +1,39 @@
+/*      -*- OpenSAF  -*-
+ *
+ * (C) Copyright 2017 The OpenSAF Foundation
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. This file and program are licensed
+ * under the GNU Lesser General Public License Version 2.1, February 1999.
+ * The complete license can be accessed from the following location:
+ * http://opensource.org/licenses/lgpl-license.php
+ * See the Copying file included with the OpenSAF distribution for full
+ * licensing terms.
+ *
+ */
+
+#ifndef NTF_COMMON_NTFSV_FILTER_H_
+#define NTF_COMMON_NTFSV_FILTER_H_
+
+#include <stdbool.h>
+#include "ntf/saf/saNtf.h"
+#include "ntf/common/ntfsv_msg.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Returns true if the notification matches the filter of its type among
+   filters, with the same rules as the NtfFilter classes of the NTFS: an
+   empty filter array matches any value, and a name matches a filter name
+   it is equal to or contains. Used by the agent for notifications that the
+   NTFS broadcasts without checking the filters of the subscriptions. */
+bool ntfsv_filter_match(const ntfsv_filter_ptrs_t *filters,
+                        const ntfsv_send_not_req_t *notification);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // NTF_COMMON_NTFSV_FILTER_H_
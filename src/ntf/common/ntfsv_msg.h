@@ -54,6 +54,7 @@ typedef enum {
   NTFSV_READER_FINALIZE_REQ = 7,
   NTFSV_READ_NEXT_REQ = 8,
   NTFSV_READER_INITIALIZE_REQ_2 = 9,
+  NTFSV_FANOUT_CONFIRM_REQ = 10,
   NTFSV_API_MAX
 } ntfsv_api_msg_type_t;
 
@@ -63,7 +64,8 @@ typedef enum {
   NTFSV_NOTIFICATION_CALLBACK = 1,
   NTFSV_DISCARDED_CALLBACK = 2,
   NTFSV_CLM_NODE_STATUS_CALLBACK = 3,
-  NTFSV_NTFS_CBK_MAX = 3
+  NTFSV_NOTIFICATION_NODE_CALLBACK = 4,
+  NTFSV_NTFS_CBK_MAX = 4
 } ntfsv_cbk_msg_type_t;
 
 typedef enum {
@@ -168,6 +170,24 @@ typedef struct {
   SaNtfSubscriptionIdT subscriptionId;
 } ntfsv_unsubscribe_req_t;
 
+/* A subscription that a notification broadcast to all agents is for */
+typedef struct {
+  uint32_t client_id;
+  SaNtfSubscriptionIdT subscriptionId;
+} ntfsv_fanout_target_t;
+
+/* The outcome of a broadcast notification for the targets of one agent,
+   sent back to the NTFS. Confirmed targets got the notification or did not
+   match the filter of the subscription, discarded targets matched but the
+   notification could not be delivered. */
+typedef struct {
+  SaNtfIdentifierT notificationId;
+  uint32_t num_confirmed;
+  ntfsv_fanout_target_t *confirmed;
+  uint32_t num_discarded;
+  ntfsv_fanout_target_t *discarded;
+} ntfsv_fanout_confirm_req_t;
+
 /* API param definition */
 typedef struct {
   ntfsv_api_msg_type_t type; /* api type */
@@ -181,6 +201,7 @@ typedef struct {
     ntfsv_reader_finalize_req_t reader_finalize;
     ntfsv_read_next_req_t read_next;
     ntfsv_reader_init_req_2_t reader_init_2;
+    ntfsv_fanout_confirm_req_t fanout_confirm;
   } param;
 } ntfsv_api_info_t;
 
@@ -189,6 +210,14 @@ typedef struct ntfsv_ntfa_clm_status_param_tag {
   uint32_t clm_node_status;
 } ntfsv_ntfa_clm_status_cbk_t;
 
+/* Notification sent once to all agents. Each checks the filters of its own
+   targets, delivers to those matching and confirms all of them. */
+typedef struct {
+  ntfsv_send_not_req_t *notification;
+  uint32_t num_targets;
+  ntfsv_fanout_target_t *targets;
+} ntfsv_node_notification_cbk_t;
+
 /* wrapper structure for all the callbacks */
 typedef struct {
   ntfsv_cbk_msg_type_t type; /* callback type */
@@ -199,6 +228,7 @@ typedef struct {
     ntfsv_send_not_req_t *notification_cbk;
     ntfsv_discarded_info_t discarded_cbk;
     ntfsv_ntfa_clm_status_cbk_t clm_node_status_cbk;
+    ntfsv_node_notification_cbk_t node_notification_cbk;
   } param;
 } ntfsv_cbk_info_t;
 
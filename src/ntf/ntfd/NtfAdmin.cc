@@ -33,6 +33,9 @@
 
 NtfAdmin *NtfAdmin::theNtfAdmin = NULL;
 
+// Fewest subscriptions for which a notification is broadcast
+static const size_t kFanoutMinTargets = 2;
+
 /**
  * This is the constructor. The cluster-wide unique counter for
  * notifications and the local counter for the clients are
@@ -42,6 +45,10 @@ NtfAdmin::NtfAdmin() {
   // initilalize variables
   notificationIdCounter = 0;
   clientIdCounter = 0;
+  fanoutBcasts = 0;
+  fanoutTargets = 0;
+  fanoutFailed = 0;
+  fanoutDiscarded = 0;
 }
 
 NtfAdmin::~NtfAdmin() {}
@@ -192,12 +199,50 @@ void NtfAdmin::processNotification(unsigned int clientId,
   /* send notification to standby */
   sendNotificationUpdate(clientId, notification->getNotInfo());
 
-  ClientMap::iterator pos;
-  for (pos = clientMap.begin(); pos != clientMap.end(); pos++) {
-    NtfClient *client = pos->second;
-    client->notificationReceived(clientId, notification, mdsCtxt);
+  // if all agents can take a broadcast, the subscriptions without discarded
+  // notifications are collected without checking their filters, the agents
+  // check those
+  FanoutList fanout;
+  bool fanoutOk =
+      activeController() && ntfs_cb->node_fanout && nonFanoutAgents.empty();
+
+  // send acknowledgement to the client who sent the notification
+  ClientMap::iterator pos = clientMap.find(clientId);
+  if (pos != clientMap.end()) {
+    pos->second->notificationSent(notification, mdsCtxt);
   }
 
+  // check the subscriptions with a filter for the notification and event
+  // type, the notification is sent to those matching if the client's node
+  // is a CLM member node
+  std::vector<NtfSubscription *> candidates;
+  subscriptionIndex.findCandidates(notification, &candidates);
+  NtfClient *client = NULL;
+  bool stale = false;
+  for (size_t i = 0; i < candidates.size(); i++) {
+    NtfSubscription *subscription = candidates[i];
+    if (client == NULL ||
+        client->getClientId() != subscription->getClientId()) {
+      pos = clientMap.find(subscription->getClientId());
+      osafassert(pos != clientMap.end());
+      client = pos->second;
+      stale = is_stale_client(client->getClientId());
+      if (stale)
+        TRACE_2(
+            "NtfAdmin::processNotification, non clm member client:'%u'"
+            " cannot receive notification %llu",
+            client->getClientId(), notificationId);
+    }
+    if (stale) continue;
+    if (fanoutOk && subscription->discardedListSize() == 0)
+      fanout.push_back(std::make_pair(client, subscription));
+    else if (subscription->checkSubscription(notification))
+      client->notificationMatched(subscription, notification);
+  }
+  TRACE_2("notification %llu checked against %zu of %zu subscriptions",
+          notificationId, candidates.size(), subscriptionIndex.size());
+  if (!fanout.empty()) fanoutNotification(notification, fanout);
+
   /* remove notification if sent to all subscribers and logged */
   if (notification->isSubscriptionListEmpty() && notification->loggedOk()) {
     NotificationMap::iterator posNot;
@@ -217,6 +262,93 @@ void NtfAdmin::processNotification(unsigned int clientId,
   TRACE_LEAVE();
 }
 
+/**
+ * Send a notification to the subscriptions in fanout, whose filters are not
+ * checked yet. A broadcast reaches each agent once, so it is made if there
+ * are at least as many subscriptions as agents taking it. Each agent then
+ * checks the filters of its own subscriptions, delivers to those matching
+ * and confirms all of them, see fanoutConfirmed(). Otherwise, or if the
+ * broadcast fails, the filters are checked here and the notification is
+ * sent to each matching subscription as usual.
+ *
+ * @param notification
+ * @param fanout subscriptions without discarded notifications
+ */
+void NtfAdmin::fanoutNotification(NtfSmartPtr &notification,
+                                  FanoutList &fanout) {
+  TRACE_ENTER2("notification %llu, %zu subscriptions, %zu agents",
+               notification->getNotificationId(), fanout.size(),
+               fanoutAgents.size());
+  if (fanout.size() >= kFanoutMinTargets &&
+      fanout.size() >= fanoutAgents.size()) {
+    std::vector<ntfsv_fanout_target_t> targets(fanout.size());
+    for (size_t i = 0; i < fanout.size(); i++) {
+      targets[i].client_id = fanout[i].first->getClientId();
+      targets[i].subscriptionId = fanout[i].second->getSubscriptionId();
+    }
+    if (send_notification_node_lib(notification->getNotInfo(), &targets[0],
+                                   targets.size()) == NCSCC_RC_SUCCESS) {
+      fanoutBcasts++;
+      fanoutTargets += targets.size();
+      // kept until the agents confirm each subscription
+      for (size_t i = 0; i < targets.size(); i++) {
+        notification->storeMatchingSubscription(targets[i].client_id,
+                                                targets[i].subscriptionId);
+      }
+      TRACE_LEAVE();
+      return;
+    }
+    fanoutFailed++;
+  }
+  for (size_t i = 0; i < fanout.size(); i++) {
+    if (fanout[i].second->checkSubscription(notification))
+      fanout[i].first->notificationMatched(fanout[i].second, notification);
+  }
+  TRACE_LEAVE();
+}
+
+/**
+ * An agent confirmed the subscriptions of its process that a broadcast
+ * notification was for. Those the notification could not be delivered to
+ * get it in their discarded list. The notification is deleted once
+ * confirmed for all subscriptions and logged.
+ *
+ * @param confirm the confirmed and discarded subscriptions
+ */
+void NtfAdmin::fanoutConfirmed(const ntfsv_fanout_confirm_req_t *confirm) {
+  TRACE_ENTER2("notification %llu", confirm->notificationId);
+  NotificationMap::iterator pos = notificationMap.find(confirm->notificationId);
+  if (pos == notificationMap.end()) {
+    // the subscriptions were removed meanwhile
+    TRACE_2("notification %llu not found", confirm->notificationId);
+    TRACE_LEAVE();
+    return;
+  }
+  NtfSmartPtr notification = pos->second;
+  for (uint32_t i = 0; i < confirm->num_confirmed; i++) {
+    const ntfsv_fanout_target_t &target = confirm->confirmed[i];
+    notification->notificationSentConfirmed(target.client_id,
+                                            target.subscriptionId);
+    sendNotConfirmUpdate(target.client_id, target.subscriptionId,
+                         confirm->notificationId, 0);
+  }
+  for (uint32_t i = 0; i < confirm->num_discarded; i++) {
+    const ntfsv_fanout_target_t &target = confirm->discarded[i];
+    ClientMap::iterator client = clientMap.find(target.client_id);
+    if (client == clientMap.end()) continue;
+    client->second->discardedAdd(target.subscriptionId,
+                                 confirm->notificationId);
+    notification->notificationSentConfirmed(target.client_id,
+                                            target.subscriptionId);
+    sendNotConfirmUpdate(target.client_id, target.subscriptionId,
+                         confirm->notificationId,
+                         NTFS_NOTIFICATION_DISCARDED);
+    fanoutDiscarded++;
+  }
+  deleteConfirmedNotification(notification, pos);
+  TRACE_LEAVE();
+}
+
 /**
  * Call methods to update notificationIdCounter and process
  * the notification.
@@ -466,6 +598,28 @@ void NtfAdmin::clientRemoveMDS(MDS_DEST mds_dest) {
   TRACE_LEAVE();
 }
 
+/**
+ * An agent came up. Notifications are only broadcast while all agents that
+ * are up can take them, and if that reaches fewer agents than subscriptions.
+ *
+ * @param mds_dest
+ * @param pvt_ver MDS private version of the agent
+ */
+void NtfAdmin::agentUp(MDS_DEST mds_dest, MDS_SVC_PVT_SUB_PART_VER pvt_ver) {
+  if (pvt_ver < NTFA_FANOUT_SVC_PVT_VERSION) {
+    TRACE_2("agent %" PRIx64 " of version %u does not take broadcasts",
+            mds_dest, pvt_ver);
+    nonFanoutAgents.insert(mds_dest);
+  } else {
+    fanoutAgents.insert(mds_dest);
+  }
+}
+
+void NtfAdmin::agentDown(MDS_DEST mds_dest) {
+  nonFanoutAgents.erase(mds_dest);
+  fanoutAgents.erase(mds_dest);
+}
+
 /**
  * The node object where the client who had the subscription is notified
  * so it can delete the appropriate subscription and filter object.
@@ -778,6 +932,12 @@ void NtfAdmin::printInfo() {
   TRACE("Admin information");
   TRACE("  notificationIdCounter:    %llu", notificationIdCounter);
   TRACE("  clientIdCounter:    %u", clientIdCounter);
+  TRACE("  fanoutBcasts:    %" PRIu64, fanoutBcasts);
+  TRACE("  fanoutTargets:    %" PRIu64, fanoutTargets);
+  TRACE("  fanoutFailed:    %" PRIu64, fanoutFailed);
+  TRACE("  fanoutDiscarded:    %" PRIu64, fanoutDiscarded);
+  TRACE("  fanoutAgents:    %zu", fanoutAgents.size());
+  TRACE("  nonFanoutAgents:    %zu", nonFanoutAgents.size());
   logger.printInfo();
 
   ClientMap::iterator pos;
@@ -992,6 +1152,21 @@ void clientRemoveMDS(MDS_DEST mds_dest) {
   NtfAdmin::theNtfAdmin->clientRemoveMDS(mds_dest);
 }
 
+void agentUp(MDS_DEST mds_dest, MDS_SVC_PVT_SUB_PART_VER pvt_ver) {
+  osafassert(NtfAdmin::theNtfAdmin != NULL);
+  NtfAdmin::theNtfAdmin->agentUp(mds_dest, pvt_ver);
+}
+
+void agentDown(MDS_DEST mds_dest) {
+  osafassert(NtfAdmin::theNtfAdmin != NULL);
+  NtfAdmin::theNtfAdmin->agentDown(mds_dest);
+}
+
+void fanoutConfirmed(const ntfsv_fanout_confirm_req_t *confirm) {
+  osafassert(NtfAdmin::theNtfAdmin != NULL);
+  NtfAdmin::theNtfAdmin->fanoutConfirmed(confirm);
+}
+
 void subscriptionRemoved(unsigned int clientId,
                          SaNtfSubscriptionIdT subscriptionId,
                          MDS_SYNC_SND_CTXT *mdsCtxt) {
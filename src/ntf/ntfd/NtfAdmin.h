@@ -23,11 +23,13 @@
  * ========================================================================
  */
 
+#include <set>
 #include "ntf/ntfd/NtfNotification.h"
 #include "ntfs_com.h"
 #include "ntf/ntfd/NtfClient.h"
 #include "ntf/ntfd/NtfFilter.h"
 #include "ntf/ntfd/NtfSubscription.h"
+#include "ntf/ntfd/NtfSubscriptionIndex.h"
 #include "assert.h"
 #include "ntf/ntfd/NtfLogger.h"
 
@@ -62,6 +64,9 @@ class NtfAdmin {
   void notificationLoggedConfirmed(SaNtfIdentifierT notificationId);
   void clientRemoved(unsigned int clientId);
   void clientRemoveMDS(MDS_DEST mds_dest);
+  void agentUp(MDS_DEST mds_dest, MDS_SVC_PVT_SUB_PART_VER pvt_ver);
+  void agentDown(MDS_DEST mds_dest);
+  void fanoutConfirmed(const ntfsv_fanout_confirm_req_t *confirm);
   void subscriptionRemoved(unsigned int clientId,
                            SaNtfSubscriptionIdT subscriptionId,
                            MDS_SYNC_SND_CTXT *mdsCtxt);
@@ -92,6 +97,7 @@ class NtfAdmin {
                       SaNtfSubscriptionIdT subscriptionId);
   static NtfAdmin *theNtfAdmin;
   NtfLogger logger;
+  NtfSubscriptionIndex subscriptionIndex;
 
   void AddMemberNode(NODE_ID node_id);
   NODE_ID *FindMemberNode(NODE_ID node_id);
@@ -110,6 +116,7 @@ class NtfAdmin {
                            SaNtfIdentifierT notificationId);
 
   void updateNotIdCounter(SaNtfIdentifierT notification);
+  void fanoutNotification(NtfSmartPtr &notification, FanoutList &fanout);
 
   typedef std::map<unsigned int, NtfClient *> ClientMap;
   ClientMap clientMap;
@@ -118,6 +125,17 @@ class NtfAdmin {
   unsigned int clientIdCounter;
   std::list<NODE_ID *>
       member_node_list; /*To maintain NCS node_ids of CLM memeber nodes.*/
+  // Agents that do not take broadcast notifications, none must be up to
+  // broadcast, and those that do
+  std::set<MDS_DEST> nonFanoutAgents;
+  std::set<MDS_DEST> fanoutAgents;
+  // Broadcast notifications, the subscriptions they were for, the
+  // broadcasts that failed and were sent one by one instead and the
+  // subscriptions agents could not deliver a broadcast notification to
+  uint64_t fanoutBcasts;
+  uint64_t fanoutTargets;
+  uint64_t fanoutFailed;
+  uint64_t fanoutDiscarded;
 };
 
 #endif  // NTF_NTFD_NTFADMIN_H_
@@ -58,6 +58,7 @@ NtfClient::~NtfClient() {
     NtfSubscription* subscription = pos->second;
     TRACE("For subscription:'%u', num of discarded Notifications: '%u'",
           subscription->getSubscriptionId(), subscription->discardedListSize());
+    NtfAdmin::theNtfAdmin->subscriptionIndex.subscriptionRemoved(subscription);
     delete subscription;
   }
   // delete all readers
@@ -109,6 +110,7 @@ void NtfClient::subscriptionAdded(NtfSubscription* subscription,
   } else {
     // store new subscription in subscriptionMap
     subscriptionMap[subscription->getSubscriptionId()] = subscription;
+    NtfAdmin::theNtfAdmin->subscriptionIndex.subscriptionAdded(subscription);
     TRACE_3(
         "NtfClient::subscriptionAdded subscription %u added,"
         " client %u, subscriptionMap size is %u",
@@ -123,76 +125,53 @@ void NtfClient::subscriptionAdded(NtfSubscription* subscription,
 }
 
 /**
- * This method is called when the client received a notification.
+ * This method is called when the client sent a notification.
  *
- * If the notification is send from this client, a confirmation
- * for the notification is sent.
+ * If active, a confirmation for the notification is sent.
  *
- * The client scans through its subscriptions and if it finds a
- * matching one, it stores the id of the matching subscription in
- * the notification object.
- *
- * @param clientId Node-wide unique id of the client who sent the notification.
  * @param notification
  *                 Pointer to the notification object.
  */
-void NtfClient::notificationReceived(unsigned int clientId,
-                                     NtfSmartPtr& notification,
-                                     MDS_SYNC_SND_CTXT* mdsCtxt) {
-  TRACE_ENTER2("%u %u", clientId_, clientId);
-  // send acknowledgement
-  if (clientId_ == clientId) {
-    // this is the client who sent the notification
-    if (activeController()) {
-      confirmNtfNotification(notification->getNotificationId(), mdsCtxt,
-                             mdsDest_);
-      if (notification->loggedOk()) {
-        sendLoggedConfirmUpdate(notification->getNotificationId());
-      } else {
-        notification->loggFromCallback_ = true;
-      }
+void NtfClient::notificationSent(NtfSmartPtr& notification,
+                                 MDS_SYNC_SND_CTXT* mdsCtxt) {
+  if (activeController()) {
+    confirmNtfNotification(notification->getNotificationId(), mdsCtxt,
+                           mdsDest_);
+    if (notification->loggedOk()) {
+      sendLoggedConfirmUpdate(notification->getNotificationId());
+    } else {
+      notification->loggFromCallback_ = true;
     }
   }
+}
 
-  // Send notification to this client if its node is CLM member node.
-  if (is_stale_client(clientId_) == true) {
-    TRACE_2(
-        "NtfClient::notificationReceived, non clm member client:'%u' cannot"
-        " receive notification %llu",
-        clientId_, notification->getNotificationId());
-    return;
-  }
-
-  // scan through all subscriptions
-  SubscriptionMap::iterator pos;
-
-  for (pos = subscriptionMap.begin(); pos != subscriptionMap.end(); pos++) {
-    NtfSubscription* subscription = pos->second;
-
-    if (subscription->checkSubscription(notification)) {
-      // notification matches the subscription
-      TRACE_2(
-          "NtfClient::notificationReceived notification %llu matches"
-          " subscription %d, client %u",
-          notification->getNotificationId(), subscription->getSubscriptionId(),
-          clientId_);
-      // first store subscription data in notifiaction object for
-      //  tracking purposes
-      notification->storeMatchingSubscription(
-          clientId_, subscription->getSubscriptionId());
-      // if active, send out the notification
-      if (activeController()) {
-        subscription->sendNotification(notification, this);
-      }
-    } else {
-      TRACE_2(
-          "NtfClient::notificationReceived notification %llu does not"
-          " match subscription %u, client %u",
-          notification->getNotificationId(), subscription->getSubscriptionId(),
-          clientId_);
-    }
+/**
+ * This method is called when a notification matches one of the
+ * subscriptions of the client.
+ *
+ * The id of the matching subscription is stored in the notification
+ * object. If active, the notification is sent to the subscription.
+ *
+ * @param subscription
+ *                 Pointer to the matching subscription object.
+ * @param notification
+ *                 Pointer to the notification object.
+ */
+void NtfClient::notificationMatched(NtfSubscription* subscription,
+                                    NtfSmartPtr& notification) {
+  TRACE_2(
+      "NtfClient::notificationMatched notification %llu matches"
+      " subscription %d, client %u",
+      notification->getNotificationId(), subscription->getSubscriptionId(),
+      clientId_);
+  // first store subscription data in notifiaction object for
+  //  tracking purposes
+  notification->storeMatchingSubscription(clientId_,
+                                          subscription->getSubscriptionId());
+  // if active, send out the notification
+  if (activeController()) {
+    subscription->sendNotification(notification, this);
   }
-  TRACE_LEAVE();
 }
 
 /**
@@ -212,6 +191,7 @@ void NtfClient::subscriptionRemoved(SaNtfSubscriptionIdT subscriptionId,
   if (pos != subscriptionMap.end()) {
     // subscription found
     NtfSubscription* subscription = pos->second;
+    NtfAdmin::theNtfAdmin->subscriptionIndex.subscriptionRemoved(subscription);
     delete subscription;
     // remove subscription from subscription map
     subscriptionMap.erase(pos);
@@ -22,18 +22,26 @@
 #ifndef NTF_NTFD_NTFCLIENT_H_
 #define NTF_NTFD_NTFCLIENT_H_
 
+#include <utility>
+#include <vector>
 #include "ntf/ntfd/NtfSubscription.h"
 #include "ntf/ntfd/NtfNotification.h"
 #include "ntf/ntfd/NtfReader.h"
 
+class NtfClient;
+
+// Subscriptions a notification is to be broadcast to, see NtfAdmin
+typedef std::vector<std::pair<NtfClient *, NtfSubscription *> > FanoutList;
+
 class NtfClient {
  public:
   NtfClient(unsigned int clientId, MDS_DEST mds_dest);
   virtual ~NtfClient();
   void subscriptionAdded(NtfSubscription *subscription,
                          MDS_SYNC_SND_CTXT *mdsCtxt);
-  void notificationReceived(unsigned int clientId, NtfSmartPtr &notification,
-                            MDS_SYNC_SND_CTXT *mdsCtxt);
+  void notificationSent(NtfSmartPtr &notification, MDS_SYNC_SND_CTXT *mdsCtxt);
+  void notificationMatched(NtfSubscription *subscription,
+                           NtfSmartPtr &notification);
   void confirmNtfSend();
   unsigned int getClientId() const;
   MDS_DEST getMdsDest() const;
@@ -24,10 +24,47 @@
  */
 
 #include "ntf/ntfd/NtfFilter.h"
+#include <algorithm>
+#include <cstring>
 #include <string>
 #include "base/logtrace.h"
 #include "ntf/common/ntfsv_mem.h"
 #include "base/osaf_extended_name.h"
+
+static bool shorterName(const std::string &a, const std::string &b) {
+  return a.size() < b.size();
+}
+
+void NtfFilterNames::assign(const SaNameT *names, SaUint16T num) {
+  for (SaUint16T i = 0; i < num; i++) {
+    std::string name(osaf_extended_name_borrow(&names[i]));
+    if (names_.insert(name).second) byLength_.push_back(name);
+  }
+  std::stable_sort(byLength_.begin(), byLength_.end(), shorterName);
+}
+
+bool NtfFilterNames::matches(const SaNameT *name) const {
+  return matches(osaf_extended_name_borrow(name));
+}
+
+bool NtfFilterNames::matches(const char *str) const {
+  if (names_.empty()) return true;
+  size_t length = strlen(str);
+  bool hashed = byLength_.size() > kHashedNames;
+  if (hashed && names_.count(std::string(str, length)) != 0) return true;
+  for (size_t i = 0; i < byLength_.size(); i++) {
+    const std::string &name = byLength_[i];
+    if (name.size() > length) break;
+    if (name.size() == length) {
+      if (hashed) break;
+      if (memcmp(name.data(), str, length) == 0) return true;
+    } else if (strstr(str, name.c_str()) != NULL) {
+      return true;
+    }
+  }
+  return false;
+}
+
 /**
  * Constructor.
  *
@@ -47,57 +84,37 @@ NtfFilter::~NtfFilter() { TRACE_2("Filter %#x destroyed", filterType_); }
 
 SaNtfNotificationTypeT NtfFilter::type() { return filterType_; }
 
-bool NtfFilter::checkEventType(SaNtfNotificationFilterHeaderT *fh,
-                               const SaNtfNotificationHeaderT *h) {
-  TRACE_8("num EventTypes: %hd", fh->numEventTypes);
-  if (fh->numEventTypes) {
-    for (int i = 0; i < fh->numEventTypes; i++) {
-      if (*h->eventType == fh->eventTypes[i]) {
-        TRACE_2("EventTypes matches");
-        return true;
-      }
-    }
-  } else {
-    return true;
-  }
-  return false;
+uint64_t NtfFilter::classIdKey(const SaNtfClassIdT *id) {
+  return (static_cast<uint64_t>(id->vendorId) << 32) |
+         (static_cast<uint64_t>(id->majorId) << 16) | id->minorId;
 }
 
-bool NtfFilter::checkNtfClassId(SaNtfNotificationFilterHeaderT *fh,
-                                const SaNtfNotificationHeaderT *h) {
-  TRACE_8("numNotificationClassIds: %hd", fh->numNotificationClassIds);
-  if (fh->numNotificationClassIds) {
-    for (int i = 0; i < fh->numNotificationClassIds; i++)
-      if (h->notificationClassId->vendorId ==
-              fh->notificationClassIds[i].vendorId &&
-          h->notificationClassId->minorId ==
-              fh->notificationClassIds[i].minorId &&
-          h->notificationClassId->majorId ==
-              fh->notificationClassIds[i].majorId) {
-        TRACE_2("notificationClassId matches");
-        return true;
-      }
-  } else {
-    return true;
-  }
-  return false;
+/**
+ * Compile the filter header into hash sets, called by the constructor of
+ * each derived class.
+ *
+ * @param fh
+ *      the filter header
+ */
+void NtfFilter::compileHeader(const SaNtfNotificationFilterHeaderT *fh) {
+  eventTypes_.assign(fh->eventTypes, fh->numEventTypes);
+  for (SaUint16T i = 0; i < fh->numNotificationClassIds; i++)
+    classIds_.insert(classIdKey(&fh->notificationClassIds[i]));
+  notificationObjects_.assign(fh->notificationObjects,
+                              fh->numNotificationObjects);
+  notifyingObjects_.assign(fh->notifyingObjects, fh->numNotifyingObjects);
+}
+
+bool NtfFilter::checkEventType(const SaNtfNotificationHeaderT *h) {
+  bool rv = eventTypes_.matches(*h->eventType);
+  if (rv) TRACE_2("EventTypes matches");
+  return rv;
 }
 
-bool NtfFilter::checkSourceIndicator(SaUint16T numSi,
-                                     SaNtfSourceIndicatorT *sis,
-                                     SaNtfSourceIndicatorT *s) {
-  TRACE_8("numSi: %hd", numSi);
-  if (numSi) {
-    for (int i = 0; i < numSi; i++) {
-      if (*s == sis[i]) {
-        TRACE_2("Sourceind matches");
-        return true;
-      }
-    }
-  } else {
-    return true;
-  }
-  return false;
+bool NtfFilter::checkNtfClassId(const SaNtfNotificationHeaderT *h) {
+  bool rv = classIds_.matches(classIdKey(h->notificationClassId));
+  if (rv) TRACE_2("notificationClassId matches");
+  return rv;
 }
 
 /**
@@ -184,44 +201,23 @@ bool NtfFilter::cmpSaNtfValueT(SaNtfValueTypeT t, SaNtfValueT *v,
   }
 }
 
-bool NtfFilter::checkNotificationObject(SaNtfNotificationFilterHeaderT *fh,
-                                        const SaNtfNotificationHeaderT *h) {
-  TRACE_8("num notificationObjects: %hd", fh->numNotificationObjects);
-  if (fh->numNotificationObjects) {
-    for (int i = 0; i < fh->numNotificationObjects; i++) {
-      if (cmpSaNameT(&fh->notificationObjects[i], h->notificationObject)) {
-        TRACE_2("notificationObject matches");
-        return true;
-      }
-    }
-  } else {
-    return true;
-  }
-  return false;
+bool NtfFilter::checkNotificationObject(const SaNtfNotificationHeaderT *h) {
+  bool rv = notificationObjects_.matches(h->notificationObject);
+  if (rv) TRACE_2("notificationObject matches");
+  return rv;
 }
 
-bool NtfFilter::checkNotifyingObject(SaNtfNotificationFilterHeaderT *fh,
-                                     const SaNtfNotificationHeaderT *h) {
-  TRACE_8("num NotifyingObjects: %hd", fh->numNotifyingObjects);
-  if (fh->numNotifyingObjects) {
-    for (int i = 0; i < fh->numNotifyingObjects; i++) {
-      if (cmpSaNameT(&fh->notifyingObjects[i], h->notifyingObject)) {
-        TRACE_2("NotifyingObject matches");
-        return true;
-      }
-    }
-  } else {
-    return true;
-  }
-  return false;
+bool NtfFilter::checkNotifyingObject(const SaNtfNotificationHeaderT *h) {
+  bool rv = notifyingObjects_.matches(h->notifyingObject);
+  if (rv) TRACE_2("NotifyingObject matches");
+  return rv;
 }
 
-bool NtfFilter::checkHeader(SaNtfNotificationFilterHeaderT *fh,
-                            NtfSmartPtr &notif) {
+bool NtfFilter::checkHeader(NtfSmartPtr &notif) {
   const SaNtfNotificationHeaderT *h = notif->header();
   if (notif->getNotificationType() != this->type()) return false;
-  bool rv = checkNtfClassId(fh, h) && checkEventType(fh, h) &&
-            checkNotificationObject(fh, h) && checkNotifyingObject(fh, h);
+  bool rv = checkNtfClassId(h) && checkEventType(h) &&
+            checkNotificationObject(h) && checkNotifyingObject(h);
   if (rv)
     TRACE_2("hdfilter matches");
   else
@@ -231,6 +227,11 @@ bool NtfFilter::checkHeader(SaNtfNotificationFilterHeaderT *fh,
 
 NtfAlarmFilter::NtfAlarmFilter(SaNtfAlarmNotificationFilterT *f)
     : NtfFilter(SA_NTF_TYPE_ALARM), filter_(f) {
+  compileHeader(&f->notificationFilterHeader);
+  trends_.assign(f->trends, f->numTrends);
+  perceivedSeverities_.assign(f->perceivedSeverities,
+                              f->numPerceivedSeverities);
+  probableCauses_.assign(f->probableCauses, f->numProbableCauses);
   TRACE_8("Alarm filter created");
 }
 
@@ -241,48 +242,21 @@ NtfAlarmFilter::~NtfAlarmFilter() {
 }
 
 bool NtfAlarmFilter::checkTrend(SaNtfAlarmNotificationT *a) {
-  TRACE_8("num Trends: %hd", filter_->numTrends);
-  if (filter_->numTrends) {
-    for (int i = 0; i < filter_->numTrends; i++) {
-      if (*a->trend == filter_->trends[i]) {
-        TRACE_2("trends matches");
-        return true;
-      }
-    }
-  } else {
-    return true;
-  }
-  return false;
+  bool rv = trends_.matches(*a->trend);
+  if (rv) TRACE_2("trends matches");
+  return rv;
 }
 
 bool NtfAlarmFilter::checkPerceivedSeverity(SaNtfAlarmNotificationT *a) {
-  TRACE_8("num Perceivedseverities: %hd", filter_->numPerceivedSeverities);
-  if (filter_->numPerceivedSeverities) {
-    for (int i = 0; i < filter_->numPerceivedSeverities; i++) {
-      if (*a->perceivedSeverity == filter_->perceivedSeverities[i]) {
-        TRACE_2("perceivedseverities matches");
-        return true;
-      }
-    }
-  } else {
-    return true;
-  }
-  return false;
+  bool rv = perceivedSeverities_.matches(*a->perceivedSeverity);
+  if (rv) TRACE_2("perceivedseverities matches");
+  return rv;
 }
 
 bool NtfAlarmFilter::checkprobableCause(SaNtfAlarmNotificationT *a) {
-  TRACE_8("num ProbableCauses: %hd", filter_->numProbableCauses);
-  if (filter_->numProbableCauses) {
-    for (int i = 0; i < filter_->numProbableCauses; i++) {
-      if (*a->probableCause == filter_->probableCauses[i]) {
-        TRACE_2("probableCauses matches");
-        return true;
-      }
-    }
-  } else {
-    return true;
-  }
-  return false;
+  bool rv = probableCauses_.matches(*a->probableCause);
+  if (rv) TRACE_2("probableCauses matches");
+  return rv;
 }
 
 /**
@@ -296,7 +270,7 @@ bool NtfAlarmFilter::checkprobableCause(SaNtfAlarmNotificationT *a) {
 bool NtfAlarmFilter::checkFilter(NtfSmartPtr &notif) {
   bool rv = false;
   TRACE_ENTER();
-  rv = this->checkHeader(&filter_->notificationFilterHeader, notif);
+  rv = this->checkHeader(notif);
   if (rv) {
     SaNtfAlarmNotificationT *a = &(notif->getNotInfo()->notification.alarm);
     rv = checkTrend(a) && checkPerceivedSeverity(a) && checkprobableCause(a);
@@ -308,6 +282,9 @@ bool NtfAlarmFilter::checkFilter(NtfSmartPtr &notif) {
 NtfSecurityAlarmFilter::NtfSecurityAlarmFilter(
     SaNtfSecurityAlarmNotificationFilterT *f)
     : NtfFilter(SA_NTF_TYPE_SECURITY_ALARM), filter_(f) {
+  compileHeader(&f->notificationFilterHeader);
+  probableCauses_.assign(f->probableCauses, f->numProbableCauses);
+  severities_.assign(f->severities, f->numSeverities);
   TRACE_8("NtfSecurityAlarmFilter created");
 }
 
@@ -328,7 +305,7 @@ NtfSecurityAlarmFilter::~NtfSecurityAlarmFilter() {
 bool NtfSecurityAlarmFilter::checkFilter(NtfSmartPtr &notif) {
   bool rv = false;
   TRACE_ENTER();
-  rv = this->checkHeader(&filter_->notificationFilterHeader, notif);
+  rv = this->checkHeader(notif);
   if (rv) {
     SaNtfSecurityAlarmNotificationT *s =
         &(notif->getNotInfo()->notification.securityAlarm);
@@ -342,33 +319,15 @@ bool NtfSecurityAlarmFilter::checkFilter(NtfSmartPtr &notif) {
 
 bool NtfSecurityAlarmFilter::checkProbableCause(
     SaNtfSecurityAlarmNotificationT *s) {
-  TRACE_8("num ProbableCauses: %hd", filter_->numProbableCauses);
-  if (filter_->numProbableCauses) {
-    for (int i = 0; i < filter_->numProbableCauses; i++) {
-      if (*s->probableCause == filter_->probableCauses[i]) {
-        TRACE_2("probableCauses matches");
-        return true;
-      }
-    }
-  } else {
-    return true;
-  }
-  return false;
+  bool rv = probableCauses_.matches(*s->probableCause);
+  if (rv) TRACE_2("probableCauses matches");
+  return rv;
 }
 
 bool NtfSecurityAlarmFilter::checkSeverity(SaNtfSecurityAlarmNotificationT *s) {
-  TRACE_8("severities: %hd", filter_->numSeverities);
-  if (filter_->numSeverities) {
-    for (int i = 0; i < filter_->numSeverities; i++) {
-      if (*s->severity == filter_->severities[i]) {
-        TRACE_2("Severity matches");
-        return true;
-      }
-    }
-  } else {
-    return true;
-  }
-  return false;
+  bool rv = severities_.matches(*s->severity);
+  if (rv) TRACE_2("Severity matches");
+  return rv;
 }
 
 bool NtfSecurityAlarmFilter::checkServiceUser(
@@ -430,6 +389,8 @@ bool NtfSecurityAlarmFilter::checkSecurityAlarmDetector(
 NtfObjectCreateDeleteFilter::NtfObjectCreateDeleteFilter(
     SaNtfObjectCreateDeleteNotificationFilterT *f)
     : NtfFilter(SA_NTF_TYPE_OBJECT_CREATE_DELETE), filter_(f) {
+  compileHeader(&f->notificationFilterHeader);
+  sourceIndicators_.assign(f->sourceIndicators, f->numSourceIndicators);
   TRACE_8("NtfObjectCreateDeleteFilter created");
 }
 
@@ -450,12 +411,11 @@ NtfObjectCreateDeleteFilter::~NtfObjectCreateDeleteFilter() {
 bool NtfObjectCreateDeleteFilter::checkFilter(NtfSmartPtr &notif) {
   bool rv = false;
   TRACE_ENTER();
-  rv = this->checkHeader(&filter_->notificationFilterHeader, notif);
+  rv = this->checkHeader(notif);
   if (rv) {
     SaNtfObjectCreateDeleteNotificationT *o =
         &(notif->getNotInfo()->notification.objectCreateDelete);
-    rv = checkSourceIndicator(filter_->numSourceIndicators,
-                              filter_->sourceIndicators, o->sourceIndicator);
+    rv = sourceIndicators_.matches(*o->sourceIndicator);
   }
   TRACE_LEAVE();
   return rv;
@@ -464,6 +424,10 @@ bool NtfObjectCreateDeleteFilter::checkFilter(NtfSmartPtr &notif) {
 NtfStateChangeFilter::NtfStateChangeFilter(
     SaNtfStateChangeNotificationFilterT *f)
     : NtfFilter(SA_NTF_TYPE_STATE_CHANGE), filter_(f) {
+  compileHeader(&f->notificationFilterHeader);
+  sourceIndicators_.assign(f->sourceIndicators, f->numSourceIndicators);
+  for (SaUint16T i = 0; i < f->numStateChanges; i++)
+    stateIds_.insert(f->changedStates[i].stateId);
   TRACE_8("NtfStateChangeFilter created");
 }
 
@@ -484,12 +448,11 @@ NtfStateChangeFilter::~NtfStateChangeFilter() {
 bool NtfStateChangeFilter::checkFilter(NtfSmartPtr &notif) {
   bool rv = false;
   TRACE_ENTER();
-  rv = this->checkHeader(&filter_->notificationFilterHeader, notif);
+  rv = this->checkHeader(notif);
   if (rv) {
     SaNtfStateChangeNotificationT *s =
         &(notif->getNotInfo()->notification.stateChange);
-    rv = checkSourceIndicator(filter_->numSourceIndicators,
-                              filter_->sourceIndicators, s->sourceIndicator) &&
+    rv = sourceIndicators_.matches(*s->sourceIndicator) &&
          checkStateId(s->numStateChanges, s->changedStates);
   }
   TRACE_LEAVE();
@@ -497,15 +460,9 @@ bool NtfStateChangeFilter::checkFilter(NtfSmartPtr &notif) {
 }
 
 bool NtfStateChangeFilter::checkStateId(SaUint16T ns, SaNtfStateChangeT *sc) {
-  int i, j;
-  if (filter_->numStateChanges) {
-    for (i = 0; i < filter_->numStateChanges; i++) {
-      for (j = 0; j < ns; j++) {
-        if (filter_->changedStates[i].stateId == sc[j].stateId) return true;
-      }
-    }
-  } else {
-    return true;
+  if (stateIds_.empty()) return true;
+  for (SaUint16T i = 0; i < ns; i++) {
+    if (stateIds_.matches(sc[i].stateId)) return true;
   }
   return false;
 }
@@ -513,6 +470,8 @@ bool NtfStateChangeFilter::checkStateId(SaUint16T ns, SaNtfStateChangeT *sc) {
 NtfAttributeChangeFilter::NtfAttributeChangeFilter(
     SaNtfAttributeChangeNotificationFilterT *f)
     : NtfFilter(SA_NTF_TYPE_ATTRIBUTE_CHANGE), filter_(f) {
+  compileHeader(&f->notificationFilterHeader);
+  sourceIndicators_.assign(f->sourceIndicators, f->numSourceIndicators);
   TRACE_8("NtfAttributeChangeFilter created");
 }
 
@@ -527,12 +486,11 @@ NtfAttributeChangeFilter::NtfAttributeChangeFilter(
 bool NtfAttributeChangeFilter::checkFilter(NtfSmartPtr &notif) {
   bool rv = false;
   TRACE_ENTER();
-  rv = this->checkHeader(&filter_->notificationFilterHeader, notif);
+  rv = this->checkHeader(notif);
   if (rv) {
     SaNtfAttributeChangeNotificationT *a =
         &(notif->getNotInfo()->notification.attributeChange);
-    rv = checkSourceIndicator(filter_->numSourceIndicators,
-                              filter_->sourceIndicators, a->sourceIndicator);
+    rv = sourceIndicators_.matches(*a->sourceIndicator);
   }
   TRACE_LEAVE();
   return rv;
@@ -25,32 +25,94 @@
 #ifndef NTF_NTFD_NTFFILTER_H_
 #define NTF_NTFD_NTFFILTER_H_
 
+#include <string>
+#include <unordered_set>
+#include <vector>
 #include "ntf/saf/saNtf.h"
 #include "ntf/ntfd/NtfNotification.h"
 
+/**
+ * The values of one filter array, compiled into a set when the filter is
+ * created. An empty set matches any value, as an empty filter array does.
+ * A few values are compared in turn, which is cheaper than hashing them.
+ */
+class NtfFilterValues {
+ public:
+  template <typename T>
+  void assign(const T *values, SaUint16T num) {
+    for (SaUint16T i = 0; i < num; i++) insert(values[i]);
+  }
+  void insert(uint64_t value) {
+    if (values_.insert(value).second) list_.push_back(value);
+  }
+  bool matches(uint64_t value) const {
+    if (list_.empty()) return true;
+    if (list_.size() > kHashedValues) return values_.count(value) != 0;
+    for (size_t i = 0; i < list_.size(); i++) {
+      if (list_[i] == value) return true;
+    }
+    return false;
+  }
+  bool empty() const { return list_.empty(); }
+  const std::unordered_set<uint64_t> &values() const { return values_; }
+
+ private:
+  // Above this many values a value is looked up by hash
+  static const size_t kHashedValues = 8;
+  std::unordered_set<uint64_t> values_;
+  std::vector<uint64_t> list_;
+};
+
+/**
+ * The names of a filter array, see NtfFilter::cmpSaNameT. A name matches
+ * if it is one of the filter names or contains one of them. The filter
+ * names are checked in order of length, the shorter ones searched for in
+ * the name and those of the same length compared. Exact matches of a long
+ * array are found by hash instead.
+ */
+class NtfFilterNames {
+ public:
+  void assign(const SaNameT *names, SaUint16T num);
+  bool matches(const SaNameT *name) const;
+  bool matches(const char *name) const;
+  bool empty() const { return names_.empty(); }
+
+ private:
+  // Above this many names the exact match is looked up by hash
+  static const size_t kHashedNames = 8;
+  std::unordered_set<std::string> names_;
+  std::vector<std::string> byLength_;
+};
+
 class NtfFilter {
  public:
   NtfFilter(SaNtfNotificationTypeT filterType);
   virtual ~NtfFilter();
   virtual bool checkFilter(NtfSmartPtr &notif) = 0;
   SaNtfNotificationTypeT type();
-  bool checkHeader(SaNtfNotificationFilterHeaderT *h, NtfSmartPtr &notif);
-  bool checkEventType(SaNtfNotificationFilterHeaderT *fh,
-                      const SaNtfNotificationHeaderT *h);
-  bool checkNtfClassId(SaNtfNotificationFilterHeaderT *fh,
-                       const SaNtfNotificationHeaderT *h);
-  bool checkNotificationObject(SaNtfNotificationFilterHeaderT *fh,
-                               const SaNtfNotificationHeaderT *h);
-  bool checkNotifyingObject(SaNtfNotificationFilterHeaderT *fh,
-                            const SaNtfNotificationHeaderT *h);
-  bool checkSourceIndicator(SaUint16T numSi, SaNtfSourceIndicatorT *sis,
-                            SaNtfSourceIndicatorT *s);
+  const NtfFilterValues &eventTypes() const { return eventTypes_; }
+  const NtfFilterNames &notificationObjects() const {
+    return notificationObjects_;
+  }
+  bool checkHeader(NtfSmartPtr &notif);
+  bool checkEventType(const SaNtfNotificationHeaderT *h);
+  bool checkNtfClassId(const SaNtfNotificationHeaderT *h);
+  bool checkNotificationObject(const SaNtfNotificationHeaderT *h);
+  bool checkNotifyingObject(const SaNtfNotificationHeaderT *h);
   bool cmpSaNameT(SaNameT *n, SaNameT *n2);
   bool cmpSaNtfValueT(SaNtfValueTypeT t, SaNtfValueT *v, SaNtfValueTypeT t2,
                       SaNtfValueT *v2);
+  static uint64_t classIdKey(const SaNtfClassIdT *id);
+
+ protected:
+  void compileHeader(const SaNtfNotificationFilterHeaderT *fh);
 
  private:
   SaNtfNotificationTypeT filterType_;
+  NtfFilterValues eventTypes_;
+  NtfFilterValues classIds_;
+  NtfFilterNames notificationObjects_;
+  NtfFilterNames notifyingObjects_;
 };
 
 class NtfAlarmFilter : public NtfFilter {
@@ -64,6 +126,9 @@ class NtfAlarmFilter : public NtfFilter {
 
  private:
   SaNtfAlarmNotificationFilterT *filter_;
+  NtfFilterValues trends_;
+  NtfFilterValues perceivedSeverities_;
+  NtfFilterValues probableCauses_;
 };
 
 class NtfSecurityAlarmFilter : public NtfFilter {
@@ -79,6 +144,8 @@ class NtfSecurityAlarmFilter : public NtfFilter {
 
  private:
   SaNtfSecurityAlarmNotificationFilterT *filter_;
+  NtfFilterValues probableCauses_;
+  NtfFilterValues severities_;
 };
 
 class NtfObjectCreateDeleteFilter : public NtfFilter {
@@ -89,6 +156,7 @@ class NtfObjectCreateDeleteFilter : public NtfFilter {
 
  private:
   SaNtfObjectCreateDeleteNotificationFilterT *filter_;
+  NtfFilterValues sourceIndicators_;
 };
 
 class NtfStateChangeFilter : public NtfFilter {
@@ -100,6 +168,8 @@ class NtfStateChangeFilter : public NtfFilter {
 
  private:
   SaNtfStateChangeNotificationFilterT *filter_;
+  NtfFilterValues sourceIndicators_;
+  NtfFilterValues stateIds_;
 };
 
 class NtfAttributeChangeFilter : public NtfFilter {
@@ -110,6 +180,7 @@ class NtfAttributeChangeFilter : public NtfFilter {
 
  private:
   SaNtfAttributeChangeNotificationFilterT *filter_;
+  NtfFilterValues sourceIndicators_;
 };
 
 typedef std::map<SaNtfNotificationTypeT, NtfFilter *> FilterMap;
@@ -20,8 +20,14 @@
  *   INCLUDE FILES
  * ========================================================================
  */
+#include <limits.h>
 #include <sys/poll.h>
+#include <sys/stat.h>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
 
+#include "base/ncs_main_papi.h"
 #include "base/osaf_utility.h"
 #include "osaf/saf/saAis.h"
 #include "log/saf/saLog.h"
@@ -75,6 +81,20 @@ NtfLogger::NtfLogger() : readCounter(0) {
     LOG_ER("initialize saflog failed exiting...");
     exit(EXIT_FAILURE);
   }
+  if (ntfs_cb->store_dir != NULL) {
+    // Both controllers keep a store, the active one of the notifications
+    // it receives and the standby one of those checkpointed to it. Each
+    // uses a directory of its own, the store directory may be shared.
+    char dir[PATH_MAX];
+    snprintf(dir, sizeof(dir), "%s/%x", ntfs_cb->store_dir,
+             m_NCS_GET_NODE_ID);
+    if (mkdir(ntfs_cb->store_dir, 0750) != 0 && errno != EEXIST) {
+      LOG_ER("Notification store %s not created: %s", ntfs_cb->store_dir,
+             strerror(errno));
+    } else {
+      store_.open(dir, ntfs_cb->store_max_size, ntfs_cb->store_max_age);
+    }
+  }
 }
 
 /* Callbacks */
@@ -140,6 +160,7 @@ void NtfLogger::log(NtfSmartPtr& notif, bool isLocal) {
       TRACE_2("push_back");
       coll_.push_back(notif);
     }
+    store_.append(notif);
   }
   TRACE_LEAVE();
 }
@@ -337,4 +358,5 @@ void NtfLogger::printInfo() {
   TRACE("Logger Information:");
   TRACE(" logQueueList size:  %u", (unsigned int)queuedNotificationList.size());
   TRACE(" reader cache size:  %u", (unsigned int)coll_.size());
+  store_.printInfo();
 }
@@ -31,6 +31,7 @@
 
 #include "ntf/ntfd/NtfNotification.h"
 #include "ntf/ntfd/NtfReader.h"
+#include "ntf/ntfd/NtfStore.h"
 
 /* ========================================================================
  *   DEFINITIONS
@@ -65,6 +66,7 @@ class NtfLogger {
   SaAisErrorT initLog();
 
   readerNotificationListT coll_;
+  NtfStore store_;
   unsigned int readCounter;
   typedef std::list<NtfSmartPtr> QueuedNotificationsList;
   QueuedNotificationsList queuedNotificationList;
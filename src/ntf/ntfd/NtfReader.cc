@@ -21,6 +21,7 @@
  */
 #include "ntf/ntfd/NtfReader.h"
 #include "ntf/ntfd/NtfLogger.h"
+#include <algorithm>
 #include <iostream>
 #include "base/logtrace.h"
 #include "ntf/ntfd/NtfNotification.h"
@@ -95,7 +96,10 @@ NtfReader::NtfReader(NtfLogger& ntfLogger, unsigned int readerId,
     NtfFilter* filter = new NtfSecurityAlarmFilter(f_rec->sec_al_filter);
     filterMap[filter->type()] = filter;
   }
-  filterCacheList(ntfLogger);
+  if (ntfLogger.store_.isOpen())
+    filterStore(ntfLogger.store_);
+  else
+    filterCacheList(ntfLogger);
 }
 
 NtfReader::~NtfReader() {
@@ -126,20 +130,121 @@ void NtfReader::filterCacheList(NtfLogger& ntfLogger) {
   readerNotificationListT::iterator rpos;
   for (rpos = ntfLogger.coll_.begin(); rpos != ntfLogger.coll_.end(); rpos++) {
     NtfSmartPtr n(*rpos);
-    bool rv = false;
-    FilterMap::iterator pos = filterMap.find(n->getNotificationType());
-    if (pos != filterMap.end()) {
-      NtfFilter* filter = pos->second;
-      osafassert(filter);
-      rv = filter->checkFilter(n);
+    if (checkFilter(n)) {
+      if (!c_filter_->filter(n)) break;
     }
-    if (rv) {
+  }
+  c_filter_->finalize();
+}
+
+/**
+ * Keep the positions in a that are also in b, both in store order.
+ */
+static void intersect(NtfStore::PositionList* a,
+                      const NtfStore::PositionList& b) {
+  NtfStore::PositionList both;
+  std::set_intersection(a->begin(), a->end(), b.begin(), b.end(),
+                        std::back_inserter(both));
+  a->swap(both);
+}
+
+/**
+ * This method is called instead of filterCacheList when the notification
+ * store is used.
+ *
+ * The notifications of the filtered types and notification objects are
+ * found with the indexes of the store, as are those with the id or event
+ * time of the search criteria. Only those are read from the store and
+ * checked against the filter, in the order they were received, so the
+ * saNtfSearchCriteria work as for the cache.
+ *
+ *   @param store
+ */
+void NtfReader::filterStore(NtfStore& store) {
+  NtfStore::PositionList candidates;
+  FilterMap::iterator pos;
+  for (pos = filterMap.begin(); pos != filterMap.end(); pos++) {
+    store.findByType(pos->first, pos->second->notificationObjects(),
+                     &candidates);
+  }
+  std::sort(candidates.begin(), candidates.end());
+
+  NtfStore::PositionList found;
+  size_t first = 0;
+  size_t last = candidates.size();
+  switch (searchCriteria_.searchMode) {
+    case SA_NTF_SEARCH_NOTIFICATION_ID:
+      store.findById(searchCriteria_.notificationId, &found);
+      intersect(&candidates, found);
+      last = candidates.size();
+      break;
+    case SA_NTF_SEARCH_AT_TIME:
+      store.findByTime(searchCriteria_.eventTime, &found);
+      intersect(&candidates, found);
+      last = candidates.size();
+      break;
+    case SA_NTF_SEARCH_AT_OR_AFTER_TIME:
+      // the earlier notifications are left out from the first match at or
+      // after the time
+      store.findAtOrAfterTime(searchCriteria_.eventTime, &found);
+      intersect(&found, candidates);
+      for (size_t i = 0; i < found.size(); i++) {
+        NtfSmartPtr n(store.read(found[i]));
+        if (n.get() != NULL && checkFilter(n)) {
+          first = std::lower_bound(candidates.begin(), candidates.end(),
+                                   found[i]) -
+                  candidates.begin();
+          break;
+        }
+      }
+      break;
+    case SA_NTF_SEARCH_AFTER_TIME:
+    case SA_NTF_SEARCH_BEFORE_OR_AT_TIME:
+      // the notifications before respectively after the last match at the
+      // time are left out
+      store.findByTime(searchCriteria_.eventTime, &found);
+      intersect(&found, candidates);
+      for (size_t i = found.size(); i > 0; i--) {
+        NtfSmartPtr n(store.read(found[i - 1]));
+        if (n.get() != NULL && checkFilter(n)) {
+          size_t idx = std::lower_bound(candidates.begin(), candidates.end(),
+                                        found[i - 1]) -
+                       candidates.begin();
+          if (searchCriteria_.searchMode == SA_NTF_SEARCH_AFTER_TIME)
+            first = idx;
+          else
+            last = idx + 1;
+          break;
+        }
+      }
+      break;
+    default:
+      break;
+  }
+  TRACE_3("Reader %u checks %zu of %zu stored notifications", readerId_,
+          last - first, candidates.size());
+
+  for (size_t i = first; i < last; i++) {
+    NtfSmartPtr n(store.read(candidates[i]));
+    if (n.get() == NULL) continue;
+    if (checkFilter(n)) {
       if (!c_filter_->filter(n)) break;
     }
   }
   c_filter_->finalize();
 }
 
+bool NtfReader::checkFilter(NtfSmartPtr& n) {
+  bool rv = false;
+  FilterMap::iterator pos = filterMap.find(n->getNotificationType());
+  if (pos != filterMap.end()) {
+    NtfFilter* filter = pos->second;
+    osafassert(filter);
+    rv = filter->checkFilter(n);
+  }
+  return rv;
+}
+
 /**
  *   This method returns the notification at the current
  *   position of the iterator ffIter if search direction is
@@ -42,6 +42,7 @@ typedef std::deque<NtfSmartPtr>::reverse_iterator readerNotReverseIterT;
  * ========================================================================
  */
 class NtfLogger;
+class NtfStore;
 class NtfCriteriaFilter;
 
 class NtfReader {
@@ -53,10 +54,13 @@ class NtfReader {
             SaNtfSearchCriteriaT searchCriteria, ntfsv_filter_ptrs_t* f_rec);
   ~NtfReader();
   void filterCacheList(NtfLogger& ntfLogger);
+  void filterStore(NtfStore& store);
   NtfSmartPtr next(SaNtfSearchDirectionT direction, SaAisErrorT* error);
   unsigned int getId();
 
  private:
+  bool checkFilter(NtfSmartPtr& n);
+
   readerNotificationListT coll_;
   readerNotificationListTIter ffIter;
   FilterMap filterMap;
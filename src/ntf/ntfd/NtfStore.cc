@@ -0,0 +1,697 @@
+/*      -*- OpenSAF  -*-
+ *
+ * (C) Copyright 2017 The OpenSAF Foundation
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. This file and program are licensed
+ * under the GNU Lesser General Public License Version 2.1, February 1999.
+ * The complete license can be accessed from the following location:
+ * http://opensource.org/licenses/lgpl-license.php
+ * See the Copying file included with the OpenSAF distribution for full
+ * licensing terms.
+ *
+ */
+
+/**
+ *   This file contains the implementation of class NtfStore, see
+ *   NtfStore.h.
+ */
+
+#include "ntf/ntfd/NtfStore.h"
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include "base/logtrace.h"
+#include "base/ncssysf_mem.h"
+#include "base/osaf_extended_name.h"
+#include "base/osaf_time.h"
+#include "ntf/common/ntfsv_enc_dec.h"
+#include "ntf/common/ntfsv_mem.h"
+
+// Header of a record, followed by the notification object name and the
+// notification as encoded by ntfsv_enc_not_msg()
+struct NtfStoreRecord {
+  uint32_t magic;
+  uint32_t length;  // bytes following the header
+  uint64_t notificationId;
+  uint64_t eventTime;
+  uint32_t notificationType;
+  uint16_t objectLength;
+  uint16_t reserved;
+};
+
+static const uint32_t kRecordMagic = 0x4e545352;  // "NTSR"
+static const char kSegmentPrefix[] = "ntfstore.";
+// Largest segment, a smaller one is used for a small store
+static const uint64_t kMaxSegmentSize = 16 * 1024 * 1024;
+static const uint64_t kMinSegmentSize = 64 * 1024;
+// Segments the store is divided into at least
+static const uint64_t kMinSegments = 8;
+// Bytes of records waiting for the writer, more are not stored
+static const uint64_t kMaxQueuedSize = 16 * 1024 * 1024;
+
+NtfStore::NtfStore()
+    : maxSize_(0),
+      segmentSize_(kMaxSegmentSize),
+      maxAge_(0),
+      totalSize_(0),
+      firstPosition_(0),
+      appended_(0),
+      writeFailed_(0),
+      queuedSize_(0),
+      stop_(false),
+      failed_(false),
+      failedPosition_(0) {}
+
+NtfStore::~NtfStore() {
+  if (thread_.joinable()) {
+    // The writer writes what is queued before it stops
+    {
+      std::lock_guard<std::mutex> guard(lock_);
+      stop_ = true;
+    }
+    cond_.notify_all();
+    thread_.join();
+  }
+  for (size_t i = 0; i < segments_.size(); i++) close(segments_[i].fd);
+}
+
+std::string NtfStore::segmentPath(uint64_t number) const {
+  char name[64];
+  snprintf(name, sizeof(name), "%s%010" PRIu64, kSegmentPrefix, number);
+  return dir_ + "/" + name;
+}
+
+/**
+ * Open the store in a directory, created if it does not exist, and build
+ * the indexes from the segments found there.
+ *
+ * @param dir
+ *      directory of the segment files
+ * @param maxSize
+ *      bytes of notifications to keep
+ * @param maxAge
+ *      seconds to keep a notification after its event time, 0 for no limit
+ * @return bool
+ *    true if the store was opened
+ */
+bool NtfStore::open(const char *dir, uint64_t maxSize, uint32_t maxAge) {
+  TRACE_ENTER2("%s", dir);
+  dir_ = dir;
+  maxSize_ = maxSize;
+  maxAge_ = static_cast<SaTimeT>(maxAge) * SA_TIME_ONE_SECOND;
+  segmentSize_ = std::min(kMaxSegmentSize,
+                          std::max(kMinSegmentSize, maxSize / kMinSegments));
+
+  if (mkdir(dir, 0750) != 0 && errno != EEXIST) {
+    LOG_ER("Notification store %s not created: %s", dir, strerror(errno));
+    TRACE_LEAVE();
+    return false;
+  }
+
+  DIR *d = opendir(dir);
+  if (d == NULL) {
+    LOG_ER("Notification store %s not opened: %s", dir, strerror(errno));
+    TRACE_LEAVE();
+    return false;
+  }
+  std::vector<uint64_t> numbers;
+  struct dirent *de;
+  while ((de = readdir(d)) != NULL) {
+    if (strncmp(de->d_name, kSegmentPrefix, sizeof(kSegmentPrefix) - 1) != 0)
+      continue;
+    char *end;
+    uint64_t number =
+        strtoull(de->d_name + sizeof(kSegmentPrefix) - 1, &end, 10);
+    if (*end == '\0') numbers.push_back(number);
+  }
+  closedir(d);
+  std::sort(numbers.begin(), numbers.end());
+
+  for (size_t i = 0; i < numbers.size(); i++) {
+    if (!loadSegment(numbers[i], i + 1 == numbers.size())) {
+      LOG_WA("Notification store segment %s skipped",
+             segmentPath(numbers[i]).c_str());
+    }
+  }
+  if ((segments_.empty() || segments_.back().size >= segmentSize_) &&
+      !newSegment()) {
+    TRACE_LEAVE();
+    return false;
+  }
+  thread_ = std::thread(&NtfStore::writer, this);
+  applyRetention();
+
+  LOG_NO("Notification store %s opened, %zu notifications in %zu segments",
+         dir, entries_.size(), segments_.size());
+  TRACE_LEAVE();
+  return true;
+}
+
+/**
+ * Read the record headers of a segment into the indexes. A record that is
+ * cut short at the end of the last segment, by a crash while it was
+ * written, is removed.
+ */
+bool NtfStore::loadSegment(uint64_t number, bool last) {
+  std::string path = segmentPath(number);
+  int fd = ::open(path.c_str(), (last ? O_RDWR : O_RDONLY));
+  if (fd < 0) {
+    LOG_WA("open %s failed: %s", path.c_str(), strerror(errno));
+    return false;
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0) {
+    LOG_WA("fstat %s failed: %s", path.c_str(), strerror(errno));
+    close(fd);
+    return false;
+  }
+  std::vector<char> data(st.st_size);
+  uint64_t done = 0;
+  while (done < data.size()) {
+    ssize_t n = pread(fd, &data[done], data.size() - done, done);
+    if (n < 0 && errno == EINTR) continue;
+    if (n <= 0) break;
+    done += n;
+  }
+  if (done != data.size()) {
+    LOG_WA("read %s failed: %s", path.c_str(), strerror(errno));
+    close(fd);
+    return false;
+  }
+
+  Segment segment = {number, fd, 0, 0};
+  segments_.push_back(segment);
+  uint64_t offset = 0;
+  while (offset + sizeof(NtfStoreRecord) <= data.size()) {
+    NtfStoreRecord rec;
+    memcpy(&rec, &data[offset], sizeof(rec));
+    if (rec.magic != kRecordMagic || rec.objectLength > rec.length ||
+        offset + sizeof(rec) + rec.length > data.size())
+      break;
+    Entry entry;
+    entry.segment = number;
+    entry.offset = offset;
+    entry.length = sizeof(rec) + rec.length;
+    entry.type = static_cast<SaNtfNotificationTypeT>(rec.notificationType);
+    entry.id = rec.notificationId;
+    entry.eventTime = rec.eventTime;
+    entry.object.assign(&data[offset + sizeof(rec)], rec.objectLength);
+    addEntry(entry);
+    offset += entry.length;
+  }
+
+  if (offset != data.size()) {
+    LOG_WA("Notification store segment %s damaged at offset %" PRIu64,
+           path.c_str(), offset);
+    if (last && ftruncate(fd, offset) != 0)
+      LOG_WA("ftruncate %s failed: %s", path.c_str(), strerror(errno));
+  }
+  segments_.back().size = offset;
+  totalSize_ += offset;
+  return true;
+}
+
+bool NtfStore::newSegment() {
+  uint64_t number = segments_.empty() ? 1 : segments_.back().number + 1;
+  std::string path = segmentPath(number);
+  int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0640);
+  if (fd < 0) {
+    LOG_ER("open %s failed: %s", path.c_str(), strerror(errno));
+    return false;
+  }
+  Segment segment = {number, fd, 0, 0};
+  segments_.push_back(segment);
+  TRACE_2("Notification store segment %s created", path.c_str());
+  return true;
+}
+
+void NtfStore::addEntry(const Entry &entry) {
+  Position pos = firstPosition_ + entries_.size();
+  entries_.push_back(entry);
+  byId_.insert(std::make_pair(entry.id, pos));
+  byTime_.insert(std::make_pair(entry.eventTime, pos));
+  byType_[entry.type].push_back(pos);
+  byObject_[entry.object].push_back(pos);
+  Segment &segment = segments_.back();
+  if (entry.eventTime > segment.lastEventTime)
+    segment.lastEventTime = entry.eventTime;
+}
+
+// Erase the index entry for pos from a multimap index
+template <typename K>
+static void eraseIndex(std::multimap<K, NtfStore::Position> *index, K key,
+                       NtfStore::Position pos) {
+  typename std::multimap<K, NtfStore::Position>::iterator it;
+  std::pair<typename std::multimap<K, NtfStore::Position>::iterator,
+            typename std::multimap<K, NtfStore::Position>::iterator>
+      range = index->equal_range(key);
+  for (it = range.first; it != range.second; it++) {
+    if (it->second == pos) {
+      index->erase(it);
+      return;
+    }
+  }
+}
+
+void NtfStore::removeOldestSegment() {
+  Segment segment = segments_.front();
+  while (!entries_.empty() && entries_.front().segment == segment.number) {
+    const Entry &entry = entries_.front();
+    eraseIndex(&byId_, entry.id, firstPosition_);
+    eraseIndex(&byTime_, entry.eventTime, firstPosition_);
+    std::deque<Position> &types = byType_[entry.type];
+    types.pop_front();
+    if (types.empty()) byType_.erase(entry.type);
+    std::deque<Position> &objects = byObject_[entry.object];
+    objects.pop_front();
+    if (objects.empty()) byObject_.erase(entry.object);
+    entries_.pop_front();
+    firstPosition_++;
+  }
+  // Removed by the writer, after the records queued for it are written
+  Write remove = {firstPosition_, segment.fd, 0, std::vector<char>(),
+                  segmentPath(segment.number)};
+  queueWrite(&remove);
+  totalSize_ -= segment.size;
+  segments_.pop_front();
+}
+
+// Remove the oldest segments beyond the size or age limit, never the one
+// written to
+void NtfStore::applyRetention() {
+  SaTimeT oldest = 0;
+  if (maxAge_ != 0) {
+    struct timespec now;
+    osaf_clock_gettime(CLOCK_REALTIME, &now);
+    SaTimeT nanos = osaf_timespec_to_nanos(&now);
+    if (nanos > maxAge_) oldest = nanos - maxAge_;
+  }
+  while (segments_.size() > 1 && (totalSize_ > maxSize_ ||
+                                  segments_.front().lastEventTime < oldest)) {
+    removeOldestSegment();
+  }
+}
+
+/**
+ * Append a notification to the store.
+ *
+ * A notification already in the store, with the same id and event time as
+ * the latest one with that id, is not appended again. That happens when a
+ * standby is synchronized with notifications it already got.
+ *
+ * @param notif
+ *      the notification to append
+ */
+void NtfStore::append(NtfSmartPtr &notif) {
+  if (!isOpen()) return;
+  checkWriteFailure();
+  const SaNtfNotificationHeaderT *header = notif->header();
+  SaNtfIdentifierT id = notif->getNotificationId();
+
+  std::multimap<SaNtfIdentifierT, Position>::const_iterator it =
+      byId_.upper_bound(id);
+  if (it != byId_.begin()) {
+    --it;
+    if (it->first == id &&
+        entryAt(it->second)->eventTime == *header->eventTime) {
+      TRACE_2("Notification %llu already stored", id);
+      return;
+    }
+  }
+
+  {
+    std::lock_guard<std::mutex> guard(lock_);
+    if (queuedSize_ >= kMaxQueuedSize) {
+      // Log the first failure after a success only
+      if (writeFailed_++ == 0)
+        LOG_WA("Notification store writes are behind, %llu not stored", id);
+      return;
+    }
+  }
+
+  NCS_UBAID uba;
+  if (ncs_enc_init_space(&uba) != NCSCC_RC_SUCCESS) {
+    LOG_WA("ncs_enc_init_space failed");
+    return;
+  }
+  if (ntfsv_enc_not_msg(&uba, notif->getNotInfo()) != NCSCC_RC_SUCCESS) {
+    LOG_WA("Notification %llu not encoded for the store", id);
+    m_MMGR_FREE_BUFR_LIST(uba.start);
+    return;
+  }
+
+  std::string object(osaf_extended_name_borrow(header->notificationObject));
+  if (object.size() > UINT16_MAX) object.resize(UINT16_MAX);
+  uint32_t encLength = m_MMGR_LINK_DATA_LEN(uba.start);
+  NtfStoreRecord rec;
+  rec.magic = kRecordMagic;
+  rec.length = object.size() + encLength;
+  rec.notificationId = id;
+  rec.eventTime = *header->eventTime;
+  rec.notificationType = notif->getNotificationType();
+  rec.objectLength = object.size();
+  rec.reserved = 0;
+
+  std::vector<char> buf(sizeof(rec) + rec.length);
+  memcpy(&buf[0], &rec, sizeof(rec));
+  memcpy(&buf[sizeof(rec)], object.data(), object.size());
+  sysf_copy_from_usrbuf(
+      uba.start, reinterpret_cast<uint8_t *>(&buf[sizeof(rec) + object.size()]),
+      encLength);
+  m_MMGR_FREE_BUFR_LIST(uba.start);
+
+  if (segments_.back().size >= segmentSize_ && !newSegment()) {
+    writeFailed_++;
+    return;
+  }
+  writeFailed_ = 0;
+  Segment &segment = segments_.back();
+  Entry entry;
+  entry.segment = segment.number;
+  entry.offset = segment.size;
+  entry.length = buf.size();
+  entry.type = notif->getNotificationType();
+  entry.id = id;
+  entry.eventTime = rec.eventTime;
+  entry.object = object;
+  addEntry(entry);
+  segment.size += entry.length;
+  totalSize_ += entry.length;
+  appended_++;
+
+  Write write = {firstPosition_ + entries_.size() - 1, segment.fd, entry.offset,
+                 std::vector<char>(), std::string()};
+  write.data.swap(buf);
+  queueWrite(&write);
+  applyRetention();
+}
+
+void NtfStore::queueWrite(Write *write) {
+  {
+    std::lock_guard<std::mutex> guard(lock_);
+    queuedSize_ += write->data.size();
+    writes_.push_back(Write());
+    writes_.back().pos = write->pos;
+    writes_.back().fd = write->fd;
+    writes_.back().offset = write->offset;
+    writes_.back().data.swap(write->data);
+    writes_.back().path.swap(write->path);
+  }
+  cond_.notify_all();
+}
+
+/**
+ * The writer thread. It writes the queued records in order and removes the
+ * segments queued for removal. When a write fails it truncates the segment
+ * to the start of the record and waits until the main thread has removed
+ * the notifications from that one on, see checkWriteFailure().
+ */
+void NtfStore::writer() {
+  bool failing = false;
+  std::unique_lock<std::mutex> guard(lock_);
+  for (;;) {
+    while (writes_.empty() || failed_) {
+      if (stop_) return;
+      cond_.wait(guard);
+    }
+    // The record stays queued until it is written, read() finds it there
+    Write &write = writes_.front();
+    guard.unlock();
+
+    bool written = true;
+    if (write.data.empty()) {
+      close(write.fd);
+      if (unlink(write.path.c_str()) != 0)
+        LOG_WA("unlink %s failed: %s", write.path.c_str(), strerror(errno));
+      TRACE_2("Notification store segment %s removed", write.path.c_str());
+    } else {
+      size_t done = 0;
+      ssize_t n = 0;
+      while (done < write.data.size()) {
+        n = pwrite(write.fd, &write.data[done], write.data.size() - done,
+                   write.offset + done);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) break;
+        done += n;
+      }
+      written = done == write.data.size();
+      if (!written) {
+        // Log the first failure after a success only
+        if (!failing)
+          LOG_WA("Notification store write failed: %s",
+                 n < 0 ? strerror(errno) : "no space");
+        if (ftruncate(write.fd, write.offset) != 0)
+          LOG_WA("ftruncate failed: %s", strerror(errno));
+      }
+      failing = !written;
+    }
+
+    guard.lock();
+    if (written) {
+      queuedSize_ -= writes_.front().data.size();
+      writes_.pop_front();
+    } else {
+      failed_ = true;
+      failedPosition_ = writes_.front().pos;
+    }
+    cond_.notify_all();
+  }
+}
+
+/**
+ * Remove the notifications from a failed write on, their records are not
+ * in the segments. The writer waits for this before it writes again.
+ */
+void NtfStore::checkWriteFailure() {
+  Position failed;
+  {
+    std::lock_guard<std::mutex> guard(lock_);
+    if (!failed_) return;
+    failed = failedPosition_;
+    // Drop the records not written, the segments are still removed
+    std::deque<Write> removes;
+    for (size_t i = 0; i < writes_.size(); i++) {
+      if (writes_[i].data.empty()) {
+        removes.push_back(Write());
+        removes.back().fd = writes_[i].fd;
+        removes.back().path.swap(writes_[i].path);
+      }
+    }
+    writes_.swap(removes);
+    queuedSize_ = 0;
+  }
+
+  uint64_t removed = 0;
+  while (!entries_.empty() && firstPosition_ + entries_.size() > failed) {
+    Position pos = firstPosition_ + entries_.size() - 1;
+    const Entry &entry = entries_.back();
+    eraseIndex(&byId_, entry.id, pos);
+    eraseIndex(&byTime_, entry.eventTime, pos);
+    std::deque<Position> &types = byType_[entry.type];
+    types.pop_back();
+    if (types.empty()) byType_.erase(entry.type);
+    std::deque<Position> &objects = byObject_[entry.object];
+    objects.pop_back();
+    if (objects.empty()) byObject_.erase(entry.object);
+    for (size_t i = segments_.size(); i > 0; i--) {
+      if (segments_[i - 1].number == entry.segment) {
+        segments_[i - 1].size = entry.offset;
+        break;
+      }
+    }
+    totalSize_ -= entry.length;
+    entries_.pop_back();
+    removed++;
+  }
+  writeFailed_ += removed;
+  LOG_WA("Notification store write failed, %" PRIu64
+         " notifications removed",
+         removed);
+
+  {
+    std::lock_guard<std::mutex> guard(lock_);
+    failed_ = false;
+  }
+  cond_.notify_all();
+}
+
+/**
+ * Wait until the notifications appended are written to the segments.
+ */
+void NtfStore::flush() {
+  for (;;) {
+    {
+      std::unique_lock<std::mutex> guard(lock_);
+      while (!writes_.empty() && !failed_) cond_.wait(guard);
+      if (!failed_) return;
+    }
+    checkWriteFailure();
+  }
+}
+
+const NtfStore::Entry *NtfStore::entryAt(Position pos) const {
+  if (pos < firstPosition_ || pos - firstPosition_ >= entries_.size())
+    return NULL;
+  return &entries_[pos - firstPosition_];
+}
+
+/**
+ * Read a notification from the store.
+ *
+ * @param pos
+ *      position of the notification
+ * @return NtfSmartPtr
+ *    the notification, empty if it could not be read
+ */
+NtfSmartPtr NtfStore::read(Position pos) {
+  NtfSmartPtr notif;
+  checkWriteFailure();
+  const Entry *entry = entryAt(pos);
+  if (entry == NULL) return notif;
+
+  uint32_t skip = sizeof(NtfStoreRecord) + entry->object.size();
+  std::vector<uint8_t> buf(entry->length - skip);
+  bool queued = false;
+  {
+    // A record not written yet is read from the queue
+    std::lock_guard<std::mutex> guard(lock_);
+    for (size_t i = writes_.size(); i > 0 && !queued; i--) {
+      const Write &write = writes_[i - 1];
+      if (write.pos == pos && !write.data.empty()) {
+        memcpy(&buf[0], &write.data[skip], buf.size());
+        queued = true;
+      }
+    }
+  }
+  if (!queued) {
+    std::deque<Segment>::const_iterator segment = segments_.begin();
+    while (segment != segments_.end() && segment->number != entry->segment)
+      segment++;
+    osafassert(segment != segments_.end());
+
+    ssize_t n;
+    do {
+      n = pread(segment->fd, &buf[0], buf.size(), entry->offset + skip);
+    } while (n < 0 && errno == EINTR);
+    if (n != static_cast<ssize_t>(buf.size())) {
+      LOG_WA("Notification %llu not read from the store: %s", entry->id,
+             n < 0 ? strerror(errno) : "short read");
+      return notif;
+    }
+  }
+
+  USRBUF *ub = sysf_copy_to_usrbuf(&buf[0], buf.size());
+  if (ub == NULL) {
+    LOG_WA("sysf_copy_to_usrbuf failed");
+    return notif;
+  }
+  NCS_UBAID uba;
+  ncs_dec_init_space(&uba, ub);
+  // deallocated in NtfNotification class
+  ntfsv_send_not_req_t *sendNotInfo =
+      static_cast<ntfsv_send_not_req_t *>(calloc(1, sizeof(*sendNotInfo)));
+  if (sendNotInfo == NULL) {
+    LOG_WA("calloc failed");
+  } else if (ntfsv_dec_not_msg(&uba, sendNotInfo) != NCSCC_RC_SUCCESS) {
+    LOG_WA("Notification %llu in the store not decoded", entry->id);
+    ntfsv_dealloc_notification(sendNotInfo);
+    free(sendNotInfo);
+  } else {
+    notif = NtfSmartPtr(
+        new NtfNotification(entry->id, entry->type, sendNotInfo));
+  }
+  if (uba.ub != NULL) m_MMGR_FREE_BUFR_LIST(uba.ub);
+  return notif;
+}
+
+/**
+ * Find the notifications of a type, in store order.
+ *
+ * @param type
+ *      the notification type
+ * @param objects
+ *      notification objects of a filter, only the notifications with a
+ *      matching object are found unless it is empty
+ * @param positions
+ *      positions found are added here
+ */
+void NtfStore::findByType(SaNtfNotificationTypeT type,
+                          const NtfFilterNames &objects,
+                          PositionList *positions) const {
+  if (objects.empty()) {
+    std::map<SaNtfNotificationTypeT, std::deque<Position> >::const_iterator
+        it = byType_.find(type);
+    if (it != byType_.end())
+      positions->insert(positions->end(), it->second.begin(), it->second.end());
+    return;
+  }
+
+  // Check each distinct object against the filter, not each notification
+  size_t first = positions->size();
+  std::unordered_map<std::string, std::deque<Position> >::const_iterator it;
+  for (it = byObject_.begin(); it != byObject_.end(); it++) {
+    if (!objects.matches(it->first.c_str())) continue;
+    for (size_t i = 0; i < it->second.size(); i++) {
+      if (entryAt(it->second[i])->type == type)
+        positions->push_back(it->second[i]);
+    }
+  }
+  std::sort(positions->begin() + first, positions->end());
+}
+
+/**
+ * Find the notifications with an id, in store order. The same id is found
+ * more than once if the notification ids restarted.
+ */
+void NtfStore::findById(SaNtfIdentifierT id, PositionList *positions) const {
+  std::pair<std::multimap<SaNtfIdentifierT, Position>::const_iterator,
+            std::multimap<SaNtfIdentifierT, Position>::const_iterator>
+      range = byId_.equal_range(id);
+  for (; range.first != range.second; range.first++)
+    positions->push_back(range.first->second);
+  std::sort(positions->begin(), positions->end());
+}
+
+/**
+ * Find the notifications with an event time, in store order.
+ */
+void NtfStore::findByTime(SaTimeT eventTime, PositionList *positions) const {
+  std::pair<std::multimap<SaTimeT, Position>::const_iterator,
+            std::multimap<SaTimeT, Position>::const_iterator>
+      range = byTime_.equal_range(eventTime);
+  for (; range.first != range.second; range.first++)
+    positions->push_back(range.first->second);
+  std::sort(positions->begin(), positions->end());
+}
+
+/**
+ * Find the notifications with an event time at or after a time, in store
+ * order.
+ */
+void NtfStore::findAtOrAfterTime(SaTimeT eventTime,
+                                 PositionList *positions) const {
+  std::multimap<SaTimeT, Position>::const_iterator it =
+      byTime_.lower_bound(eventTime);
+  for (; it != byTime_.end(); it++) positions->push_back(it->second);
+  std::sort(positions->begin(), positions->end());
+}
+
+void NtfStore::printInfo() {
+  if (!isOpen()) return;
+  TRACE(" store directory:  %s", dir_.c_str());
+  TRACE(" store notifications:  %zu", entries_.size());
+  TRACE(" store segments:  %zu", segments_.size());
+  TRACE(" store size:  %" PRIu64, totalSize_);
+  TRACE(" store appended:  %" PRIu64, appended_);
+  std::lock_guard<std::mutex> guard(lock_);
+  TRACE(" store queued writes:  %zu", writes_.size());
+}
@@ -0,0 +1,137 @@
+/*      -*- OpenSAF  -*-
+ *
+ * (C) Copyright 2017 The OpenSAF Foundation
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. This file and program are licensed
+ * under the GNU Lesser General Public License Version 2.1, February 1999.
+ * The complete license can be accessed from the following location:
+ * http://opensource.org/licenses/lgpl-license.php
+ * See the Copying file included with the OpenSAF distribution for full
+ * licensing terms.
+ *
+ */
+
+/**
+ *   This file contains the declaration of class NtfStore, a persistent
+ *   store of the notifications that can be read with the reader API.
+ *
+ *   The notifications are appended to segment files in a directory, in the
+ *   order they are received. A segment is closed when it grows beyond the
+ *   segment size and whole segments are removed, oldest first, to keep the
+ *   store within its size and age limits. Each record holds a small header
+ *   with the notification id, event time, type and notification object,
+ *   followed by the notification as encoded for MDS. The indexes by
+ *   notification id, event time, type and notification object are kept in
+ *   memory and are rebuilt from the record headers when the store is
+ *   opened.
+ *
+ *   A position is the sequence number of a record in the store, positions
+ *   increase in the order the notifications were received.
+ *
+ *   The records are written to the segment files by a writer thread, so the
+ *   main thread does not wait for the disk. A notification is in the indexes
+ *   and can be read as soon as it is appended, a record not yet written is
+ *   read from the write queue. If a write fails, the notifications from that
+ *   one on are removed from the store again and the segment is truncated.
+ */
+
+#ifndef NTF_NTFD_NTFSTORE_H_
+#define NTF_NTFD_NTFSTORE_H_
+
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "ntf/ntfd/NtfNotification.h"
+#include "ntf/ntfd/NtfFilter.h"
+
+class NtfStore {
+ public:
+  typedef uint64_t Position;
+  typedef std::vector<Position> PositionList;
+
+  NtfStore();
+  ~NtfStore();
+  bool open(const char *dir, uint64_t maxSize, uint32_t maxAge);
+  bool isOpen() const { return !segments_.empty(); }
+  void append(NtfSmartPtr &notif);
+  NtfSmartPtr read(Position pos);
+  void flush();
+
+  void findByType(SaNtfNotificationTypeT type, const NtfFilterNames &objects,
+                  PositionList *positions) const;
+  void findById(SaNtfIdentifierT id, PositionList *positions) const;
+  void findByTime(SaTimeT eventTime, PositionList *positions) const;
+  void findAtOrAfterTime(SaTimeT eventTime, PositionList *positions) const;
+  void printInfo();
+
+ private:
+  struct Segment {
+    uint64_t number;
+    int fd;
+    uint64_t size;
+    SaTimeT lastEventTime;
+  };
+  struct Entry {
+    uint64_t segment;
+    uint64_t offset;
+    uint32_t length;
+    SaNtfNotificationTypeT type;
+    SaNtfIdentifierT id;
+    SaTimeT eventTime;
+    std::string object;
+  };
+  // A record to write to a segment, or a segment to remove if data is empty
+  struct Write {
+    Position pos;
+    int fd;
+    uint64_t offset;
+    std::vector<char> data;
+    std::string path;
+  };
+
+  std::string segmentPath(uint64_t number) const;
+  bool loadSegment(uint64_t number, bool last);
+  bool newSegment();
+  void addEntry(const Entry &entry);
+  void removeOldestSegment();
+  void applyRetention();
+  const Entry *entryAt(Position pos) const;
+  void queueWrite(Write *write);
+  void writer();
+  void checkWriteFailure();
+
+  std::string dir_;
+  uint64_t maxSize_;
+  uint64_t segmentSize_;
+  SaTimeT maxAge_;
+  uint64_t totalSize_;
+  std::deque<Segment> segments_;
+  // Records in store order, the first one at position firstPosition_
+  std::deque<Entry> entries_;
+  Position firstPosition_;
+  std::multimap<SaNtfIdentifierT, Position> byId_;
+  std::multimap<SaTimeT, Position> byTime_;
+  std::map<SaNtfNotificationTypeT, std::deque<Position> > byType_;
+  std::unordered_map<std::string, std::deque<Position> > byObject_;
+  uint64_t appended_;
+  uint64_t writeFailed_;
+
+  // Shared with the writer thread
+  std::mutex lock_;
+  std::condition_variable cond_;
+  std::deque<Write> writes_;
+  uint64_t queuedSize_;
+  bool stop_;
+  bool failed_;
+  Position failedPosition_;
+  std::thread thread_;
+};
+
+#endif  // NTF_NTFD_NTFSTORE_H_
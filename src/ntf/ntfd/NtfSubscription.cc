@@ -115,6 +115,22 @@ NtfSubscription::~NtfSubscription() {
 SaNtfSubscriptionIdT NtfSubscription::getSubscriptionId() const {
   return (subscriptionId_);
 }
+/**
+ * This method is called to get the id of the client owning the
+ * subscription.
+ *
+ * @return Node-wide unique id of the client.
+ */
+unsigned int NtfSubscription::getClientId() const { return s_info_.client_id; }
+
+/**
+ * This method is called to get the filters of the subscription, one per
+ * notification type.
+ *
+ * @return the filter map.
+ */
+const FilterMap& NtfSubscription::getFilters() const { return filterMap; }
+
 /**
  * This method is called to get the subscriptin info struct of
  * the subscription.
@@ -35,6 +35,8 @@ class NtfSubscription {
   bool checkSubscription(NtfSmartPtr& notification);
   void confirmNtfSend();
   SaNtfSubscriptionIdT getSubscriptionId() const;
+  unsigned int getClientId() const;
+  const FilterMap& getFilters() const;
   ntfsv_subscribe_req_t* getSubscriptionInfo();
   void printInfo();
   void sendNotification(NtfSmartPtr& notification, NtfClient* client);
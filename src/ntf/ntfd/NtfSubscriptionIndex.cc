@@ -0,0 +1,134 @@
+/*      -*- OpenSAF  -*-
+ *
+ * (C) Copyright 2017 The OpenSAF Foundation
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. This file and program are licensed
+ * under the GNU Lesser General Public License Version 2.1, February 1999.
+ * The complete license can be accessed from the following location:
+ * http://opensource.org/licenses/lgpl-license.php
+ * See the Copying file included with the OpenSAF distribution for full
+ * licensing terms.
+ *
+ */
+
+/**
+ *   This file contains the implementation of class NtfSubscriptionIndex.
+ *   A subscription is indexed under each event type of each of its filters,
+ *   or under the notification type alone if the filter has no event types.
+ *   The candidates found for a notification still have their filters
+ *   checked, the index only leaves out subscriptions that cannot match.
+ */
+
+#include "ntf/ntfd/NtfSubscriptionIndex.h"
+#include <algorithm>
+#include "base/logtrace.h"
+
+// Same order as a scan of the clients and their subscriptions
+static uint64_t scanOrder(const NtfSubscription *subscription) {
+  return (static_cast<uint64_t>(subscription->getClientId()) << 32) |
+         subscription->getSubscriptionId();
+}
+
+uint64_t NtfSubscriptionIndex::key(SaNtfNotificationTypeT type,
+                                   uint64_t eventType) {
+  return (static_cast<uint64_t>(type) << 32) | eventType;
+}
+
+void NtfSubscriptionIndex::update(SubscriptionList *list,
+                                  NtfSubscription *subscription, bool add) {
+  Entry entry = {scanOrder(subscription), subscription};
+  SubscriptionList::iterator pos = std::lower_bound(
+      list->begin(), list->end(), entry,
+      [](const Entry &a, const Entry &b) { return a.order < b.order; });
+  bool found = pos != list->end() && pos->order == entry.order;
+  if (add && !found)
+    list->insert(pos, entry);
+  else if (!add && found)
+    list->erase(pos);
+}
+
+void NtfSubscriptionIndex::update(NtfSubscription *subscription, bool add) {
+  const FilterMap &filters = subscription->getFilters();
+  for (FilterMap::const_iterator pos = filters.begin(); pos != filters.end();
+       pos++) {
+    const NtfFilterValues &eventTypes = pos->second->eventTypes();
+    if (eventTypes.empty()) {
+      update(&anyEventType_[pos->first], subscription, add);
+      if (anyEventType_[pos->first].empty()) anyEventType_.erase(pos->first);
+      continue;
+    }
+    std::unordered_set<uint64_t>::const_iterator it;
+    for (it = eventTypes.values().begin(); it != eventTypes.values().end();
+         it++) {
+      uint64_t k = key(pos->first, *it);
+      update(&byEventType_[k], subscription, add);
+      if (byEventType_[k].empty()) byEventType_.erase(k);
+    }
+  }
+}
+
+/**
+ * Index a subscription stored by its client.
+ *
+ * @param subscription
+ *               Pointer to the subscription object.
+ */
+void NtfSubscriptionIndex::subscriptionAdded(NtfSubscription *subscription) {
+  update(subscription, true);
+  size_++;
+  TRACE_2("Subscription %u client %u indexed, %zu subscriptions",
+          subscription->getSubscriptionId(), subscription->getClientId(),
+          size_);
+}
+
+/**
+ * Remove a subscription from the index, before it is deleted.
+ *
+ * @param subscription
+ *               Pointer to the subscription object.
+ */
+void NtfSubscriptionIndex::subscriptionRemoved(NtfSubscription *subscription) {
+  update(subscription, false);
+  size_--;
+  TRACE_2("Subscription %u client %u removed from index, %zu subscriptions",
+          subscription->getSubscriptionId(), subscription->getClientId(),
+          size_);
+}
+
+/**
+ * Find the subscriptions that may match a notification, ordered by client
+ * id and subscription id.
+ *
+ * @param notification
+ *               Pointer to the received notification object.
+ * @param candidates
+ *               Filled in with the subscriptions to check.
+ */
+void NtfSubscriptionIndex::findCandidates(
+    NtfSmartPtr &notification,
+    std::vector<NtfSubscription *> *candidates) const {
+  static const SubscriptionList none;
+  SaNtfNotificationTypeT type = notification->getNotificationType();
+
+  std::unordered_map<uint64_t, SubscriptionList>::const_iterator pos =
+      byEventType_.find(key(type, *notification->header()->eventType));
+  const SubscriptionList &some =
+      pos != byEventType_.end() ? pos->second : none;
+  std::map<SaNtfNotificationTypeT, SubscriptionList>::const_iterator any =
+      anyEventType_.find(type);
+  const SubscriptionList &all = any != anyEventType_.end() ? any->second : none;
+
+  // Merge the two lists, both in scan order
+  candidates->reserve(candidates->size() + some.size() + all.size());
+  SubscriptionList::const_iterator a = some.begin(), b = all.begin();
+  while (a != some.end() || b != all.end()) {
+    if (b == all.end() || (a != some.end() && a->order < b->order))
+      candidates->push_back((a++)->subscription);
+    else
+      candidates->push_back((b++)->subscription);
+  }
+}
+
+size_t NtfSubscriptionIndex::size() const { return size_; }
@@ -0,0 +1,63 @@
+/*      -*- OpenSAF  -*-
+ *
+ * (C) Copyright 2017 The OpenSAF Foundation
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. This file and program are licensed
+ * under the GNU Lesser General Public License Version 2.1, February 1999.
+ * The complete license can be accessed from the following location:
+ * http://opensource.org/licenses/lgpl-license.php
+ * See the Copying file included with the OpenSAF distribution for full
+ * licensing terms.
+ *
+ */
+
+/**
+ *   This file contains the declaration of class NtfSubscriptionIndex, an
+ *   inverted index from notification type and event type to the
+ *   subscriptions with a filter for them. A received notification is only
+ *   checked against the subscriptions found in the index instead of all
+ *   subscriptions of all clients.
+ */
+
+#ifndef NTF_NTFD_NTFSUBSCRIPTIONINDEX_H_
+#define NTF_NTFD_NTFSUBSCRIPTIONINDEX_H_
+
+#include <map>
+#include <unordered_map>
+#include <vector>
+#include "ntf/ntfd/NtfNotification.h"
+#include "ntf/ntfd/NtfSubscription.h"
+
+class NtfSubscriptionIndex {
+ public:
+  void subscriptionAdded(NtfSubscription *subscription);
+  void subscriptionRemoved(NtfSubscription *subscription);
+  void findCandidates(NtfSmartPtr &notification,
+                      std::vector<NtfSubscription *> *candidates) const;
+  size_t size() const;
+
+ private:
+  // A subscription and its place in a scan of the clients and their
+  // subscriptions
+  struct Entry {
+    uint64_t order;
+    NtfSubscription *subscription;
+  };
+  // Kept in scan order, so that the candidates need no sorting
+  typedef std::vector<Entry> SubscriptionList;
+
+  static uint64_t key(SaNtfNotificationTypeT type, uint64_t eventType);
+  static void update(SubscriptionList *list, NtfSubscription *subscription,
+                     bool add);
+  void update(NtfSubscription *subscription, bool add);
+
+  // Subscriptions by notification type and one of their event types
+  std::unordered_map<uint64_t, SubscriptionList> byEventType_;
+  // Subscriptions by notification type, with no event types in the filter
+  std::map<SaNtfNotificationTypeT, SubscriptionList> anyEventType_;
+  size_t size_ = 0;
+};
+
+#endif  // NTF_NTFD_NTFSUBSCRIPTIONINDEX_H_
@@ -50,6 +50,7 @@
  * ========================================================================
  */
 #define NTFSV_READER_CACHE_DEFAULT 10000
+#define NTFSV_STORE_MAX_SIZE_DEFAULT (256ULL * 1024 * 1024)
 
 /* ========================================================================
  *   TYPE DEFINITIONS
@@ -69,6 +70,8 @@ extern uint32_t ntfs_mds_change_role();
 extern uint32_t ntfs_mds_msg_send(ntfs_cb_t *cb, ntfsv_msg_t *msg,
                                   MDS_DEST *dest, MDS_SYNC_SND_CTXT *mds_ctxt,
                                   MDS_SEND_PRIORITY_TYPE prio);
+extern uint32_t ntfs_mds_msg_bcast(ntfs_cb_t *cb, ntfsv_msg_t *msg,
+                                   MDS_SEND_PRIORITY_TYPE prio);
 extern void ntfs_evt_destroy(ntfsv_ntfs_evt_t *evt);
 
 const char *ha_state_str(SaAmfHAStateT state);
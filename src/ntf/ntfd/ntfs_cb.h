@@ -71,6 +71,10 @@ typedef struct ntfs_cb {
   NCS_SEL_OBJ usr2_sel_obj; /* Selection object for CLM initialization.*/
   uint16_t peer_mbcsv_version; /*Remeber peer NTFS MBCSV version.*/
   bool clm_initialized;        // For CLM init status;
+  bool node_fanout; /* Broadcast notifications with several subscribers */
+  char *store_dir;  /* Directory of the notification store, or NULL */
+  uint64_t store_max_size; /* Bytes of notifications kept in the store */
+  uint32_t store_max_age;  /* Seconds notifications are kept, 0 no limit */
 } ntfs_cb_t;
 
 extern uint32_t ntfs_cb_init(ntfs_cb_t *);
@@ -337,6 +337,46 @@ int send_notification_lib(ntfsv_send_not_req_t *dispatchInfo,
 	return (rc);
 };
 
+/**
+ *   Send a notification once to all libs, each of which delivers it to the
+ *   subscriptions it has among the targets.
+ *
+ *   The caller confirms the targets, on failure it falls back to
+ *   send_notification_lib() for each of them.
+ *
+ *   @param dispatchInfo contains all information about the notification.
+ *   @param targets client and subscription the notification matched
+ *   @param num_targets number of targets
+ *
+ *   @return return value == NCSCC_RC_SUCCESS if ok
+ */
+int send_notification_node_lib(ntfsv_send_not_req_t *dispatchInfo,
+			       ntfsv_fanout_target_t *targets,
+			       uint32_t num_targets)
+{
+	uint32_t rc;
+	ntfsv_msg_t msg;
+	SaNtfNotificationHeaderT *header;
+
+	TRACE_ENTER();
+	ntfsv_get_ntf_header(dispatchInfo, &header);
+	TRACE_3("not_id: %llu, targets: %u", *header->notificationId,
+		num_targets);
+
+	memset(&msg, 0, sizeof(ntfsv_msg_t));
+	msg.type = NTFSV_NTFS_CBK_MSG;
+	msg.info.cbk_info.type = NTFSV_NOTIFICATION_NODE_CALLBACK;
+	msg.info.cbk_info.param.node_notification_cbk.notification =
+	    dispatchInfo;
+	msg.info.cbk_info.param.node_notification_cbk.num_targets = num_targets;
+	msg.info.cbk_info.param.node_notification_cbk.targets = targets;
+	rc = ntfs_mds_msg_bcast(ntfs_cb, &msg, MDS_SEND_PRIORITY_HIGH);
+	if (rc != NCSCC_RC_SUCCESS)
+		TRACE_1("ntfs_mds_msg_bcast to ntfa failed rc: %d", (int)rc);
+	TRACE_LEAVE();
+	return rc;
+}
+
 void sendLoggedConfirm(SaNtfIdentifierT notificationId)
 {
 	TRACE_ENTER();
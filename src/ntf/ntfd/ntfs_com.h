@@ -74,6 +74,9 @@ void notificationSentConfirmed(unsigned int clientId,
 void notificationLoggedConfirmed(SaNtfIdentifierT notificationId);
 void clientRemoved(unsigned int clientId);
 void clientRemoveMDS(MDS_DEST mds_dest);
+void agentUp(MDS_DEST mds_dest, MDS_SVC_PVT_SUB_PART_VER pvt_ver);
+void agentDown(MDS_DEST mds_dest);
+void fanoutConfirmed(const ntfsv_fanout_confirm_req_t *confirm);
 void subscriptionRemoved(unsigned int clientId,
                          SaNtfSubscriptionIdT subscriptionId,
                          MDS_SYNC_SND_CTXT *mdsCtxt);
@@ -133,6 +136,10 @@ void delete_reader_res_lib(SaAisErrorT error, MDS_DEST mdsDest,
 int send_notification_lib(ntfsv_send_not_req_t *dispatchInfo,
                           uint32_t client_id, MDS_DEST mds_dest);
 
+int send_notification_node_lib(ntfsv_send_not_req_t *dispatchInfo,
+                               ntfsv_fanout_target_t *targets,
+                               uint32_t num_targets);
+
 void sendLoggedConfirm(SaNtfIdentifierT notificationId);
 
 int send_discard_notification_lib(ntfsv_discarded_info_t *discardedInfo,
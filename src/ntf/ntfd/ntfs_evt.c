@@ -46,6 +46,7 @@ static uint32_t proc_reader_initialize_msg_2(ntfs_cb_t *,
 					     ntfsv_ntfs_evt_t *evt);
 static uint32_t proc_reader_finalize_msg(ntfs_cb_t *, ntfsv_ntfs_evt_t *evt);
 static uint32_t proc_read_next_msg(ntfs_cb_t *, ntfsv_ntfs_evt_t *evt);
+static uint32_t proc_fanout_confirm_msg(ntfs_cb_t *, ntfsv_ntfs_evt_t *evt);
 
 static int ntf_version_is_valid(SaVersionT *ver)
 {
@@ -81,6 +82,7 @@ static const NTFSV_NTFS_NTFA_API_MSG_HANDLER
 	proc_reader_finalize_msg,
 	proc_read_next_msg,
 	proc_reader_initialize_msg_2,
+	proc_fanout_confirm_msg,
 };
 
 /****************************************************************************
@@ -102,10 +104,12 @@ static uint32_t proc_ntfa_updn_mds_msg(ntfsv_ntfs_evt_t *evt)
 
 	switch (evt->evt_type) {
 	case NTFSV_NTFS_EVT_NTFA_UP:
+		agentUp(evt->fr_dest, evt->info.mds_info.rem_svc_pvt_ver);
 		break;
 	case NTFSV_NTFS_EVT_NTFA_DOWN:
 		/* Remove this NTFA entry from our processing lists */
 		clientRemoveMDS(evt->fr_dest);
+		agentDown(evt->fr_dest);
 		break;
 	default:
 		TRACE("Unknown evt type!!!");
@@ -240,6 +244,20 @@ uint32_t ntfs_cb_init(ntfs_cb_t *ntfs_cb)
 	} else {
 		ntfs_cb->cache_size = NTFSV_READER_CACHE_DEFAULT;
 	}
+
+	tmp = (char *)getenv("NTFSV_ENV_NODE_FANOUT");
+	ntfs_cb->node_fanout = (tmp != NULL && atoi(tmp) != 0);
+	TRACE("NTFSV_ENV_NODE_FANOUT: %d", ntfs_cb->node_fanout);
+
+	ntfs_cb->store_dir = getenv("NTFSV_ENV_STORE_DIR");
+	tmp = getenv("NTFSV_ENV_STORE_MAX_SIZE");
+	ntfs_cb->store_max_size = tmp ? strtoull(tmp, NULL, 0)
+				      : NTFSV_STORE_MAX_SIZE_DEFAULT;
+	tmp = getenv("NTFSV_ENV_STORE_MAX_AGE");
+	ntfs_cb->store_max_age = tmp ? (uint32_t)atoi(tmp) : 0;
+	TRACE("NTFSV_ENV_STORE_DIR: %s, max size: %" PRIu64 ", max age: %u",
+	      ntfs_cb->store_dir ? ntfs_cb->store_dir : "none",
+	      ntfs_cb->store_max_size, ntfs_cb->store_max_age);
 	TRACE_LEAVE();
 	return NCSCC_RC_SUCCESS;
 }
@@ -476,6 +494,33 @@ static uint32_t proc_send_not_msg(ntfs_cb_t *cb, ntfsv_ntfs_evt_t *evt)
 	return rc;
 }
 
+/****************************************************************************
+ * Name          : proc_fanout_confirm_msg
+ *
+ * Description   : This is the function which is called when ntfs receives a
+ *                 NTFSV_FANOUT_CONFIRM_REQ message, an agent confirming the
+ *                 subscriptions of its process a notification sent to all
+ *                 agents was targeted at.
+ *
+ * Arguments     : msg  - Message that was posted to the Mail box.
+ *
+ * Return Values : NCSCC_RC_SUCCESS/NCSCC_RC_FAILURE
+ *
+ * Notes         : The target lists are freed with the event.
+ *****************************************************************************/
+static uint32_t proc_fanout_confirm_msg(ntfs_cb_t *cb, ntfsv_ntfs_evt_t *evt)
+{
+	ntfsv_fanout_confirm_req_t *param =
+	    &evt->info.msg.info.api_info.param.fanout_confirm;
+
+	TRACE_ENTER2("notificationId: %llu, confirmed: %u, discarded: %u",
+		     param->notificationId, param->num_confirmed,
+		     param->num_discarded);
+	fanoutConfirmed(param);
+	TRACE_LEAVE();
+	return NCSCC_RC_SUCCESS;
+}
+
 /****************************************************************************
  * Name          : proc_reader_initialize_msg
  *
@@ -712,7 +757,8 @@ void ntfs_process_mbx(SYSF_MBX *mbx)
 			} else
 				TRACE("message type invalid");
 		} else {
-			if (msg->evt_type == NTFSV_NTFS_EVT_NTFA_DOWN) {
+			if (msg->evt_type == NTFSV_NTFS_EVT_NTFA_UP ||
+			    msg->evt_type == NTFSV_NTFS_EVT_NTFA_DOWN) {
 				ntfs_ntfsv_top_level_evt_dispatch_tbl
 				    [msg->evt_type](msg);
 			}
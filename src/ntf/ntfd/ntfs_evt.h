@@ -32,6 +32,7 @@ typedef enum ntfsv_ntfs_evt_type {
 typedef struct ntfsv_ntfs_mds_info {
   uint32_t node_id;
   MDS_DEST mds_dest_id;
+  MDS_SVC_PVT_SUB_PART_VER rem_svc_pvt_ver;
 } ntfsv_ntfs_mds_info_t;
 
 typedef struct { PCS_RDA_ROLE io_role; } ntfsv_rda_info_t;
@@ -47,6 +47,14 @@ static MDS_CLIENT_MSG_FORMAT_VER
 void ntfs_evt_destroy(ntfsv_ntfs_evt_t *evt)
 {
 	osafassert(evt != NULL);
+	if (evt->evt_type == NTFSV_NTFS_NTFSV_MSG &&
+	    evt->info.msg.type == NTFSV_NTFA_API_MSG &&
+	    evt->info.msg.info.api_info.type == NTFSV_FANOUT_CONFIRM_REQ) {
+		free(evt->info.msg.info.api_info.param.fanout_confirm
+			 .confirmed);
+		free(evt->info.msg.info.api_info.param.fanout_confirm
+			 .discarded);
+	}
 	free(evt);
 }
 
@@ -377,6 +385,32 @@ static uint32_t enc_send_not_cbk_msg(NCS_UBAID *uba, ntfsv_msg_t *msg)
 	return ntfsv_enc_not_msg(uba, param);
 }
 
+/****************************************************************************
+  Name          : enc_send_not_node_cbk_msg
+
+  Description   : This routine encodes a notification callback msg for all
+		  agents, the target subscriptions before the notification.
+
+  Arguments     : NCS_UBAID *msg,
+		  NTFSV_MSG *msg
+
+  Return Values : uns32
+
+  Notes         : None.
+******************************************************************************/
+static uint32_t enc_send_not_node_cbk_msg(NCS_UBAID *uba, ntfsv_msg_t *msg)
+{
+	ntfsv_node_notification_cbk_t *param =
+	    &msg->info.cbk_info.param.node_notification_cbk;
+	uint32_t rc;
+
+	rc = ntfsv_enc_fanout_targets(uba, param->num_targets,
+				      param->targets);
+	if (rc != NCSCC_RC_SUCCESS)
+		return rc;
+	return ntfsv_enc_not_msg(uba, param->notification);
+}
+
 /****************************************************************************
   Name          : enc_send_discard_cbk_msg
 
@@ -658,6 +692,9 @@ static uint32_t mds_enc(struct ncsmds_callback_info *info)
 		} else if (msg->info.cbk_info.type ==
 			   NTFSV_CLM_NODE_STATUS_CALLBACK) {
 			rc = enc_send_clm_node_status_cbk_msg(uba, msg);
+		} else if (msg->info.cbk_info.type ==
+			   NTFSV_NOTIFICATION_NODE_CALLBACK) {
+			rc = enc_send_not_node_cbk_msg(uba, msg);
 		} else {
 			TRACE("unknown callback type %d",
 			      msg->info.cbk_info.type);
@@ -756,6 +793,11 @@ static uint32_t mds_dec(struct ncsmds_callback_info *info)
 		case NTFSV_READ_NEXT_REQ:
 			rc = dec_read_next_msg(uba, &evt->info.msg);
 			break;
+		case NTFSV_FANOUT_CONFIRM_REQ:
+			rc = ntfsv_dec_fanout_confirm(
+			    uba,
+			    &evt->info.msg.info.api_info.param.fanout_confirm);
+			break;
 		default:
 			TRACE("Unknown API type = %d",
 			      evt->info.msg.info.api_info.type);
@@ -937,12 +979,17 @@ static uint32_t mds_svc_event(struct ncsmds_callback_info *info)
 
 	/* If this evt was sent from NTFA act on this */
 	if (info->info.svc_evt.i_svc_id == NCSMDS_SVC_ID_NTFA) {
-		if (info->info.svc_evt.i_change == NCSMDS_DOWN) {
-			TRACE_8("MDS DOWN dest: %" PRIx64
-				", node ID: %x, svc_id: %d",
+		if (info->info.svc_evt.i_change == NCSMDS_DOWN ||
+		    info->info.svc_evt.i_change == NCSMDS_UP) {
+			TRACE_8("MDS %s dest: %" PRIx64
+				", node ID: %x, svc_id: %d, pvt_ver: %u",
+				info->info.svc_evt.i_change == NCSMDS_UP
+				    ? "UP"
+				    : "DOWN",
 				info->info.svc_evt.i_dest,
 				info->info.svc_evt.i_node_id,
-				info->info.svc_evt.i_svc_id);
+				info->info.svc_evt.i_svc_id,
+				info->info.svc_evt.i_rem_svc_pvt_ver);
 
 			/* As of now we are only interested in NTFA events */
 			if (NULL ==
@@ -952,7 +999,10 @@ static uint32_t mds_svc_event(struct ncsmds_callback_info *info)
 				goto done;
 			}
 
-			evt->evt_type = NTFSV_NTFS_EVT_NTFA_DOWN;
+			if (info->info.svc_evt.i_change == NCSMDS_UP)
+				evt->evt_type = NTFSV_NTFS_EVT_NTFA_UP;
+			else
+				evt->evt_type = NTFSV_NTFS_EVT_NTFA_DOWN;
 
 			/** Initialize the Event Header **/
 			evt->cb_hdl = 0;
@@ -964,6 +1014,8 @@ static uint32_t mds_svc_event(struct ncsmds_callback_info *info)
 			    info->info.svc_evt.i_node_id;
 			evt->info.mds_info.mds_dest_id =
 			    info->info.svc_evt.i_dest;
+			evt->info.mds_info.rem_svc_pvt_ver =
+			    info->info.svc_evt.i_rem_svc_pvt_ver;
 
 			/* Push the event and we are done */
 			if (m_NCS_IPC_SEND(&ntfs_cb->mbx, evt,
@@ -1327,3 +1379,44 @@ uint32_t ntfs_mds_msg_send(ntfs_cb_t *cb, ntfsv_msg_t *msg, MDS_DEST *dest,
 	}
 	return rc;
 }
+
+/****************************************************************************
+  Name          : ntfs_mds_msg_bcast
+
+  Description   : This routine broadcasts a message to all NTFAs.
+
+  Arguments     : cb  - ptr to the NTFS CB
+		  i_msg - ptr to the NTFSv message
+		  prio - MDS priority of the message
+
+  Return Values : NCSCC_RC_SUCCESS/NCSCC_RC_FAILURE
+
+  Notes         : With TIPC multicast enabled a node receives one copy,
+		  otherwise MDS sends it to each NTFA in turn.
+******************************************************************************/
+
+uint32_t ntfs_mds_msg_bcast(ntfs_cb_t *cb, ntfsv_msg_t *msg,
+			    MDS_SEND_PRIORITY_TYPE prio)
+{
+	NCSMDS_INFO mds_info;
+	MDS_SEND_INFO *send_info = &mds_info.info.svc_send;
+	uint32_t rc;
+
+	memset(&mds_info, '\0', sizeof(NCSMDS_INFO));
+
+	mds_info.i_mds_hdl = cb->mds_hdl;
+	mds_info.i_svc_id = NCSMDS_SVC_ID_NTFS;
+	mds_info.i_op = MDS_SEND;
+
+	send_info->i_msg = msg;
+	send_info->i_to_svc = NCSMDS_SVC_ID_NTFA;
+	send_info->i_priority = prio;
+	send_info->i_sendtype = MDS_SENDTYPE_BCAST;
+	send_info->info.bcast.i_bcast_scope = NCSMDS_SCOPE_NONE;
+
+	rc = ncsmds_api(&mds_info);
+	if (rc != NCSCC_RC_SUCCESS) {
+		LOG_WA("ntfs_mds_msg_bcast FAILED:%u", rc);
+	}
+	return rc;
+}
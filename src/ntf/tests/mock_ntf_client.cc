@@ -0,0 +1,23 @@
+/*      -*- OpenSAF  -*-
+ *
+ * (C) Copyright 2017 The OpenSAF Foundation
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. This file and program are licensed
+ * under the GNU Lesser General Public License Version 2.1, February 1999.
+ * The complete license can be accessed from the following location:
+ * http://opensource.org/licenses/lgpl-license.php
+ * See the Copying file included with the OpenSAF distribution for full
+ * licensing terms.
+ *
+ */
+
+#include "ntf/ntfd/NtfClient.h"
+
+// The client a subscription sends notifications to. NtfClient.cc needs all
+// of NTFS, the tests only use the accessors of NtfSubscription.
+
+unsigned int NtfClient::getClientId() const { return clientId_; }
+
+MDS_DEST NtfClient::getMdsDest() const { return mdsDest_; }
@@ -0,0 +1,83 @@
+/*      -*- OpenSAF  -*-
+ *
+ * (C) Copyright 2017 The OpenSAF Foundation
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. This file and program are licensed
+ * under the GNU Lesser General Public License Version 2.1, February 1999.
+ * The complete license can be accessed from the following location:
+ * http://opensource.org/licenses/lgpl-license.php
+ * See the Copying file included with the OpenSAF distribution for full
+ * licensing terms.
+ *
+ */
+
+#include "ntf/tests/mock_ntfs_com.h"
+
+// The checkpoint messages of NtfNotification, not sent in the tests
+
+int sendNewNotification(unsigned int connId,
+                        ntfsv_send_not_req_t *notificationInfo,
+                        NCS_UBAID *uba) {
+  (void)connId;
+  (void)notificationInfo;
+  (void)uba;
+  return NCSCC_RC_SUCCESS;
+}
+
+void sendMapNoOfSubscriptionToNotification(unsigned int noOfSubcriptions,
+                                           NCS_UBAID *uba) {
+  (void)noOfSubcriptions;
+  (void)uba;
+}
+
+void sendMapSubscriptionToNotification(unsigned int clientId,
+                                       unsigned int subscriptionId,
+                                       NCS_UBAID *uba) {
+  (void)clientId;
+  (void)subscriptionId;
+  (void)uba;
+}
+
+int syncLoggedConfirm(unsigned int logged, NCS_UBAID *uba) {
+  (void)logged;
+  (void)uba;
+  return NCSCC_RC_SUCCESS;
+}
+
+// The messages of NtfSubscription, not sent in the tests
+
+int sendNewSubscription(ntfsv_subscribe_req_t *s, NCS_UBAID *uba) {
+  (void)s;
+  (void)uba;
+  return NCSCC_RC_SUCCESS;
+}
+
+int send_notification_lib(ntfsv_send_not_req_t *dispatchInfo,
+                          uint32_t client_id, MDS_DEST mds_dest) {
+  (void)dispatchInfo;
+  (void)client_id;
+  (void)mds_dest;
+  return NCSCC_RC_SUCCESS;
+}
+
+int send_discard_notification_lib(ntfsv_discarded_info_t *discardedInfo,
+                                  uint32_t c_id, SaNtfSubscriptionIdT s_id,
+                                  MDS_DEST mds_dest) {
+  (void)discardedInfo;
+  (void)c_id;
+  (void)s_id;
+  (void)mds_dest;
+  return NCSCC_RC_SUCCESS;
+}
+
+void notificationSentConfirmed(unsigned int clientId,
+                               SaNtfSubscriptionIdT subscriptionId,
+                               SaNtfIdentifierT notificationId,
+                               int discarded) {
+  (void)clientId;
+  (void)subscriptionId;
+  (void)notificationId;
+  (void)discarded;
+}
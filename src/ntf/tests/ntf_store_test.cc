@@ -0,0 +1,434 @@
+/*      -*- OpenSAF  -*-
+ *
+ * (C) Copyright 2017 The OpenSAF Foundation
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. This file and program are licensed
+ * under the GNU Lesser General Public License Version 2.1, February 1999.
+ * The complete license can be accessed from the following location:
+ * http://opensource.org/licenses/lgpl-license.php
+ * See the Copying file included with the OpenSAF distribution for full
+ * licensing terms.
+ *
+ */
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "base/osaf_extended_name.h"
+#include "gtest/gtest.h"
+#include "ntf/common/ntfsv_mem.h"
+#include "ntf/ntfd/NtfStore.h"
+
+namespace {
+
+const SaTimeT kTime = 1500000000 * SA_TIME_ONE_SECOND;
+
+class NtfStoreTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    char dir[] = "/tmp/ntf_store_test.XXXXXX";
+    ASSERT_NE(mkdtemp(dir), nullptr);
+    dir_ = dir;
+  }
+
+  void TearDown() override {
+    std::vector<std::string> files = Segments();
+    for (const auto& file : files) unlink((dir_ + "/" + file).c_str());
+    rmdir(dir_.c_str());
+  }
+
+  // An alarm or security alarm as received from an agent
+  static NtfSmartPtr Notification(SaNtfIdentifierT id, SaTimeT eventTime,
+                                  const char* object,
+                                  SaNtfNotificationTypeT type =
+                                      SA_NTF_TYPE_ALARM,
+                                  size_t textLength = 10) {
+    ntfsv_send_not_req_t* info =
+        static_cast<ntfsv_send_not_req_t*>(calloc(1, sizeof(*info)));
+    info->notificationType = type;
+    SaNtfNotificationHeaderT* header;
+    if (type == SA_NTF_TYPE_ALARM) {
+      header = &info->notification.alarm.notificationHeader;
+      EXPECT_EQ(ntfsv_alloc_ntf_header(header, 0, textLength, 0), SA_AIS_OK);
+      EXPECT_EQ(ntfsv_alloc_ntf_alarm(&info->notification.alarm, 0, 0, 0),
+                SA_AIS_OK);
+      *info->notification.alarm.perceivedSeverity = SA_NTF_SEVERITY_MAJOR;
+      *info->notification.alarm.probableCause = SA_NTF_ADAPTER_ERROR;
+      *header->eventType = SA_NTF_ALARM_PROCESSING;
+    } else {
+      header = &info->notification.securityAlarm.notificationHeader;
+      EXPECT_EQ(ntfsv_alloc_ntf_header(header, 0, textLength, 0), SA_AIS_OK);
+      EXPECT_EQ(ntfsv_alloc_ntf_security_alarm(
+                    &info->notification.securityAlarm),
+                SA_AIS_OK);
+      *header->eventType = SA_NTF_INTEGRITY_VIOLATION;
+    }
+    osaf_extended_name_alloc(object, header->notificationObject);
+    osaf_extended_name_alloc("safApp=test", header->notifyingObject);
+    header->notificationClassId->vendorId = SA_NTF_VENDOR_ID_SAF;
+    header->notificationClassId->majorId = 1;
+    header->notificationClassId->minorId = 2;
+    *header->eventTime = eventTime;
+    memset(header->additionalText, 'x', textLength - 1);
+    return NtfSmartPtr(new NtfNotification(id, type, info));
+  }
+
+  void Append(NtfStore* store, SaNtfIdentifierT id, SaTimeT eventTime,
+              const char* object,
+              SaNtfNotificationTypeT type = SA_NTF_TYPE_ALARM,
+              size_t textLength = 10) {
+    NtfSmartPtr notif(Notification(id, eventTime, object, type, textLength));
+    store->append(notif);
+  }
+
+  // The notification ids at the positions found
+  static std::vector<SaNtfIdentifierT> Ids(NtfStore* store,
+                                           const NtfStore::PositionList& pos) {
+    std::vector<SaNtfIdentifierT> ids;
+    for (auto p : pos) {
+      NtfSmartPtr notif(store->read(p));
+      ids.push_back(notif.get() == nullptr ? 0 : notif->getNotificationId());
+    }
+    return ids;
+  }
+
+  std::vector<std::string> Segments() const {
+    std::vector<std::string> files;
+    DIR* d = opendir(dir_.c_str());
+    if (d == nullptr) return files;
+    struct dirent* de;
+    while ((de = readdir(d)) != nullptr) {
+      if (strncmp(de->d_name, "ntfstore.", 9) == 0)
+        files.push_back(de->d_name);
+    }
+    closedir(d);
+    std::sort(files.begin(), files.end());
+    return files;
+  }
+
+  std::string dir_;
+};
+
+TEST_F(NtfStoreTest, AppendsAndReadsBack) {
+  NtfStore store;
+  ASSERT_TRUE(store.open(dir_.c_str(), 1 << 20, 0));
+  Append(&store, 1, kTime, "safSu=1");
+  Append(&store, 2, kTime + 1, "safSu=2", SA_NTF_TYPE_SECURITY_ALARM);
+
+  // Readable before and after the writer has written the records
+  for (int written = 0; written < 2; written++) {
+    NtfSmartPtr notif(store.read(0));
+    ASSERT_NE(notif.get(), nullptr);
+    EXPECT_EQ(notif->getNotificationId(), 1u);
+    EXPECT_EQ(notif->getNotificationType(), SA_NTF_TYPE_ALARM);
+    EXPECT_STREQ(osaf_extended_name_borrow(notif->header()->notificationObject),
+                 "safSu=1");
+    EXPECT_EQ(*notif->header()->eventTime, kTime);
+    EXPECT_EQ(*notif->getNotInfo()->notification.alarm.perceivedSeverity,
+              SA_NTF_SEVERITY_MAJOR);
+    notif = store.read(1);
+    ASSERT_NE(notif.get(), nullptr);
+    EXPECT_EQ(notif->getNotificationType(), SA_NTF_TYPE_SECURITY_ALARM);
+    EXPECT_EQ(store.read(2).get(), nullptr);
+    store.flush();
+  }
+
+  // The same notification again, as after a cold sync, is not stored
+  Append(&store, 2, kTime + 1, "safSu=2", SA_NTF_TYPE_SECURITY_ALARM);
+  EXPECT_EQ(store.read(2).get(), nullptr);
+}
+
+TEST_F(NtfStoreTest, FindsByEachIndex) {
+  NtfStore store;
+  ASSERT_TRUE(store.open(dir_.c_str(), 1 << 20, 0));
+  Append(&store, 1, kTime, "safSu=1,safSg=1");
+  Append(&store, 2, kTime + 10, "safSu=2,safSg=1");
+  Append(&store, 3, kTime + 10, "safSu=1,safSg=2", SA_NTF_TYPE_SECURITY_ALARM);
+  Append(&store, 4, kTime + 20, "safSu=1,safSg=1");
+  // Notification ids restarted
+  Append(&store, 1, kTime + 30, "safSu=3");
+
+  NtfStore::PositionList pos;
+  NtfFilterNames any;
+  store.findByType(SA_NTF_TYPE_ALARM, any, &pos);
+  EXPECT_EQ(Ids(&store, pos), std::vector<SaNtfIdentifierT>({1, 2, 4, 1}));
+
+  // An object name in a filter matches as a substring
+  SaNameT names[2];
+  osaf_extended_name_lend("safSg=1", &names[0]);
+  osaf_extended_name_lend("safSu=3", &names[1]);
+  NtfFilterNames objects;
+  objects.assign(names, 2);
+  pos.clear();
+  store.findByType(SA_NTF_TYPE_ALARM, objects, &pos);
+  EXPECT_EQ(pos, NtfStore::PositionList({0, 1, 3, 4}));
+  pos.clear();
+  store.findByType(SA_NTF_TYPE_SECURITY_ALARM, objects, &pos);
+  EXPECT_TRUE(pos.empty());
+
+  pos.clear();
+  store.findById(1, &pos);
+  EXPECT_EQ(pos, NtfStore::PositionList({0, 4}));
+  pos.clear();
+  store.findByTime(kTime + 10, &pos);
+  EXPECT_EQ(pos, NtfStore::PositionList({1, 2}));
+  pos.clear();
+  store.findAtOrAfterTime(kTime + 15, &pos);
+  EXPECT_EQ(pos, NtfStore::PositionList({3, 4}));
+}
+
+TEST_F(NtfStoreTest, RotatesAndRemovesOldestSegments) {
+  // 64 KiB segments, each record about 1 KiB
+  const uint64_t kMaxSize = 8 * 64 * 1024;
+  NtfStore store;
+  ASSERT_TRUE(store.open(dir_.c_str(), kMaxSize, 0));
+  const SaNtfIdentifierT kCount = 2000;
+  for (SaNtfIdentifierT id = 1; id <= kCount; id++)
+    Append(&store, id, kTime + id, "safSu=1", SA_NTF_TYPE_ALARM, 1000);
+  store.flush();
+
+  std::vector<std::string> files = Segments();
+  EXPECT_GE(files.size(), 7u);
+  EXPECT_LE(files.size(), 10u);
+  EXPECT_NE(files.front(), "ntfstore.0000000001");
+  uint64_t size = 0;
+  for (const auto& file : files) {
+    struct stat st;
+    ASSERT_EQ(stat((dir_ + "/" + file).c_str(), &st), 0);
+    EXPECT_LE(static_cast<uint64_t>(st.st_size), 64 * 1024 + 2048u);
+    size += st.st_size;
+  }
+  EXPECT_LE(size, kMaxSize);
+
+  // The oldest are gone from the indexes too, the newest are kept in order
+  NtfStore::PositionList pos;
+  store.findById(1, &pos);
+  EXPECT_TRUE(pos.empty());
+  store.findAtOrAfterTime(kTime, &pos);
+  ASSERT_FALSE(pos.empty());
+  std::vector<SaNtfIdentifierT> ids = Ids(&store, pos);
+  EXPECT_EQ(ids.back(), kCount);
+  for (size_t i = 1; i < ids.size(); i++) EXPECT_EQ(ids[i], ids[i - 1] + 1);
+  EXPECT_GT(ids.size() * 1000, kMaxSize - 2 * 64 * 1024);
+}
+
+TEST_F(NtfStoreTest, RemovesSegmentsBeyondMaxAge) {
+  NtfStore store;
+  ASSERT_TRUE(store.open(dir_.c_str(), 8 * 64 * 1024, 3600));
+  // Segments with event times long ago are removed, but the one written to
+  for (SaNtfIdentifierT id = 1; id <= 200; id++)
+    Append(&store, id, kTime, "safSu=1", SA_NTF_TYPE_ALARM, 1000);
+  struct timespec now;
+  clock_gettime(CLOCK_REALTIME, &now);
+  SaTimeT recent = now.tv_sec * SA_TIME_ONE_SECOND;
+  for (SaNtfIdentifierT id = 201; id <= 300; id++)
+    Append(&store, id, recent, "safSu=1", SA_NTF_TYPE_ALARM, 1000);
+  store.flush();
+
+  EXPECT_LE(Segments().size(), 3u);
+  NtfStore::PositionList pos;
+  store.findByTime(kTime, &pos);
+  EXPECT_LT(pos.size(), 64u);
+  pos.clear();
+  store.findByTime(recent, &pos);
+  EXPECT_EQ(pos.size(), 100u);
+}
+
+TEST_F(NtfStoreTest, ReopenRebuildsIndexesAndTruncatesDamage) {
+  {
+    NtfStore store;
+    ASSERT_TRUE(store.open(dir_.c_str(), 1 << 20, 0));
+    Append(&store, 7, kTime, "safSu=1");
+    Append(&store, 8, kTime + 1, "safSu=2", SA_NTF_TYPE_SECURITY_ALARM);
+    // Written when the store is closed
+  }
+  std::vector<std::string> files = Segments();
+  ASSERT_EQ(files.size(), 1u);
+  std::string path = dir_ + "/" + files[0];
+  struct stat st;
+  ASSERT_EQ(stat(path.c_str(), &st), 0);
+  off_t written = st.st_size;
+
+  // A record cut short by a crash
+  int fd = open(path.c_str(), O_WRONLY | O_APPEND);
+  ASSERT_GE(fd, 0);
+  ASSERT_EQ(write(fd, "NTSR", 4), 4);
+  close(fd);
+
+  NtfStore store;
+  ASSERT_TRUE(store.open(dir_.c_str(), 1 << 20, 0));
+  ASSERT_EQ(stat(path.c_str(), &st), 0);
+  EXPECT_EQ(st.st_size, written);
+  NtfStore::PositionList pos;
+  store.findById(8, &pos);
+  EXPECT_EQ(Ids(&store, pos), std::vector<SaNtfIdentifierT>({8}));
+  pos.clear();
+  NtfFilterNames any;
+  store.findByType(SA_NTF_TYPE_ALARM, any, &pos);
+  EXPECT_EQ(Ids(&store, pos), std::vector<SaNtfIdentifierT>({7}));
+
+  // Appended after the records found
+  Append(&store, 9, kTime + 2, "safSu=3");
+  store.flush();
+  pos.clear();
+  store.findAtOrAfterTime(kTime, &pos);
+  EXPECT_EQ(Ids(&store, pos), std::vector<SaNtfIdentifierT>({7, 8, 9}));
+}
+
+TEST_F(NtfStoreTest, RemovesNotificationsNotWritten) {
+  NtfStore store;
+  ASSERT_TRUE(store.open(dir_.c_str(), 1 << 20, 0));
+  Append(&store, 1, kTime, "safSu=1");
+  Append(&store, 2, kTime + 1, "safSu=1");
+  store.flush();
+  std::string path = dir_ + "/" + Segments().back();
+  struct stat st;
+  ASSERT_EQ(stat(path.c_str(), &st), 0);
+
+  // The segment cannot grow, the writes fail with EFBIG
+  struct rlimit saved;
+  ASSERT_EQ(getrlimit(RLIMIT_FSIZE, &saved), 0);
+  void (*handler)(int) = signal(SIGXFSZ, SIG_IGN);
+  struct rlimit limit = saved;
+  limit.rlim_cur = st.st_size + 10;
+  ASSERT_EQ(setrlimit(RLIMIT_FSIZE, &limit), 0);
+  for (SaNtfIdentifierT id = 3; id <= 5; id++)
+    Append(&store, id, kTime + id, "safSu=1");
+  store.flush();
+  EXPECT_EQ(setrlimit(RLIMIT_FSIZE, &saved), 0);
+  signal(SIGXFSZ, handler);
+
+  NtfStore::PositionList pos;
+  store.findById(3, &pos);
+  EXPECT_TRUE(pos.empty());
+  EXPECT_EQ(store.read(2).get(), nullptr);
+  off_t written = st.st_size;
+  ASSERT_EQ(stat(path.c_str(), &st), 0);
+  EXPECT_EQ(st.st_size, written);
+
+  // Appended where the failed ones were
+  Append(&store, 6, kTime + 6, "safSu=1");
+  store.flush();
+  store.findAtOrAfterTime(kTime, &pos);
+  EXPECT_EQ(Ids(&store, pos), std::vector<SaNtfIdentifierT>({1, 2, 6}));
+
+  NtfStore reopened;
+  ASSERT_TRUE(reopened.open(dir_.c_str(), 1 << 20, 0));
+  pos.clear();
+  reopened.findAtOrAfterTime(kTime, &pos);
+  EXPECT_EQ(Ids(&reopened, pos), std::vector<SaNtfIdentifierT>({1, 2, 6}));
+}
+
+// Reads from a store of many alarms on 1000 objects, with the indexes and
+// with a scan of every record as a search without them would do. Run with
+//   bin/testntfd --gtest_also_run_disabled_tests --gtest_filter='*Bench*'
+class NtfStoreBench : public NtfStoreTest {
+ protected:
+  static const int kObjects = 1000;
+
+  static double Seconds(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                         start)
+        .count();
+  }
+
+  static std::string Object(SaNtfIdentifierT id) {
+    char object[32];
+    snprintf(object, sizeof(object), "safSu=%04d,safSg=1",
+             static_cast<int>(id % kObjects));
+    return object;
+  }
+
+  void Run(SaNtfIdentifierT count) {
+    const uint64_t kMaxSize = 4ULL << 30;
+    double append = 0;
+    {
+      NtfStore store;
+      ASSERT_TRUE(store.open(dir_.c_str(), kMaxSize, 0));
+      for (SaNtfIdentifierT id = 1; id <= count; id++) {
+        NtfSmartPtr notif(
+            Notification(id, kTime + id, Object(id).c_str()));
+        auto start = std::chrono::steady_clock::now();
+        store.append(notif);
+        // Within the bound of the write queue
+        if (id % 10000 == 0) store.flush();
+        append += Seconds(start);
+      }
+      auto start = std::chrono::steady_clock::now();
+      store.flush();
+      append += Seconds(start);
+    }
+
+    NtfStore store;
+    auto start = std::chrono::steady_clock::now();
+    ASSERT_TRUE(store.open(dir_.c_str(), kMaxSize, 0));
+    double rebuild = Seconds(start);
+
+    // One object, as a reader with a notification object filter
+    SaNameT name;
+    std::string object = Object(17);
+    osaf_extended_name_lend(object.c_str(), &name);
+    NtfFilterNames objects;
+    objects.assign(&name, 1);
+    NtfStore::PositionList pos;
+    start = std::chrono::steady_clock::now();
+    store.findByType(SA_NTF_TYPE_ALARM, objects, &pos);
+    double find = Seconds(start);
+    start = std::chrono::steady_clock::now();
+    size_t found = 0;
+    for (auto p : pos) {
+      NtfSmartPtr notif(store.read(p));
+      if (notif.get() != nullptr &&
+          objects.matches(notif->header()->notificationObject))
+        found++;
+    }
+    double read = Seconds(start);
+    EXPECT_EQ(found, count / kObjects);
+
+    // The newest 0.1 percent, as a reader searching at or after a time
+    NtfStore::PositionList recent;
+    start = std::chrono::steady_clock::now();
+    store.findAtOrAfterTime(kTime + count - count / 1000 + 1, &recent);
+    double recent_find = Seconds(start);
+    EXPECT_EQ(recent.size(), count / 1000);
+
+    // Every record read and checked
+    NtfStore::PositionList all;
+    store.findAtOrAfterTime(0, &all);
+    ASSERT_EQ(all.size(), count);
+    start = std::chrono::steady_clock::now();
+    size_t scanned = 0;
+    for (auto p : all) {
+      NtfSmartPtr notif(store.read(p));
+      if (notif.get() != nullptr &&
+          objects.matches(notif->header()->notificationObject))
+        scanned++;
+    }
+    double scan = Seconds(start);
+    EXPECT_EQ(scanned, found);
+
+    printf("%llu alarms: append %.2f us, rebuild %.2f s, by object %.3f ms "
+           "+ read %zu %.2f ms, newest %zu %.3f ms, scan %.2f s\n",
+           static_cast<unsigned long long>(count), append * 1e6 / count,
+           rebuild, find * 1e3, found, read * 1e3, recent.size(),
+           recent_find * 1e3, scan);
+  }
+};
+
+TEST_F(NtfStoreBench, DISABLED_TwoHundredThousandAlarms) { Run(200000); }
+
+TEST_F(NtfStoreBench, DISABLED_TwoMillionAlarms) { Run(2000000); }
+
+}  // namespace
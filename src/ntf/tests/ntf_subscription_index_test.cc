@@ -0,0 +1,450 @@
+/*      -*- OpenSAF  -*-
+ *
+ * (C) Copyright 2017 The OpenSAF Foundation
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. This file and program are licensed
+ * under the GNU Lesser General Public License Version 2.1, February 1999.
+ * The complete license can be accessed from the following location:
+ * http://opensource.org/licenses/lgpl-license.php
+ * See the Copying file included with the OpenSAF distribution for full
+ * licensing terms.
+ *
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <utility>
+#include <vector>
+#include "base/osaf_extended_name.h"
+#include "gtest/gtest.h"
+#include "ntf/common/ntfsv_mem.h"
+#include "ntf/ntfd/NtfFilter.h"
+#include "ntf/ntfd/NtfSubscription.h"
+#include "ntf/ntfd/NtfSubscriptionIndex.h"
+
+namespace {
+
+TEST(NtfFilterValuesTest, EmptyMatchesAnyValue) {
+  NtfFilterValues values;
+  EXPECT_TRUE(values.empty());
+  EXPECT_TRUE(values.matches(0));
+  EXPECT_TRUE(values.matches(UINT64_MAX));
+}
+
+TEST(NtfFilterValuesTest, MatchesTheAssignedValues) {
+  const SaNtfSeverityT severities[] = {SA_NTF_SEVERITY_MAJOR,
+                                       SA_NTF_SEVERITY_CRITICAL,
+                                       SA_NTF_SEVERITY_MAJOR};
+  NtfFilterValues values;
+  values.assign(severities, 3);
+  EXPECT_FALSE(values.empty());
+  EXPECT_EQ(values.values().size(), 2u);
+  EXPECT_TRUE(values.matches(SA_NTF_SEVERITY_MAJOR));
+  EXPECT_TRUE(values.matches(SA_NTF_SEVERITY_CRITICAL));
+  EXPECT_FALSE(values.matches(SA_NTF_SEVERITY_MINOR));
+
+  values.insert(SA_NTF_SEVERITY_MINOR);
+  EXPECT_TRUE(values.matches(SA_NTF_SEVERITY_MINOR));
+}
+
+// The names must match as NtfFilter::cmpSaNameT() matches each filter name
+class NtfFilterNamesTest : public ::testing::Test {
+ protected:
+  void TearDown() override {
+    for (SaNameT &name : names_) osaf_extended_name_free(&name);
+  }
+
+  NtfFilterNames Names(const std::vector<std::string> &names) {
+    size_t first = names_.size();
+    for (const std::string &name : names) {
+      names_.push_back(SaNameT());
+      osaf_extended_name_alloc(name.c_str(), &names_.back());
+    }
+    NtfFilterNames filterNames;
+    filterNames.assign(names.empty() ? nullptr : &names_[first], names.size());
+    return filterNames;
+  }
+
+  // Whether a name matches the filter names with cmpSaNameT()
+  bool CmpSaNameT(const std::vector<std::string> &names,
+                  const std::string &str) {
+    SaNameT name;
+    osaf_extended_name_alloc(str.c_str(), &name);
+    bool match = names.empty();
+    for (const std::string &filterName : names) {
+      SaNameT n;
+      osaf_extended_name_alloc(filterName.c_str(), &n);
+      match = match || filter_.cmpSaNameT(&n, &name);
+      osaf_extended_name_free(&n);
+    }
+    osaf_extended_name_free(&name);
+    return match;
+  }
+
+  std::vector<bool> Matches(const std::vector<std::string> &names,
+                            const std::vector<std::string> &strs) {
+    NtfFilterNames filterNames = Names(names);
+    std::vector<bool> matches;
+    for (const std::string &str : strs) {
+      bool match = filterNames.matches(str.c_str());
+      EXPECT_EQ(match, CmpSaNameT(names, str)) << str;
+      matches.push_back(match);
+    }
+    return matches;
+  }
+
+  // Only for cmpSaNameT(), which does not use the filter
+  NtfAlarmFilter filter_{static_cast<SaNtfAlarmNotificationFilterT *>(
+      calloc(1, sizeof(SaNtfAlarmNotificationFilterT)))};
+  std::vector<SaNameT> names_;
+  const std::vector<std::string> objects_ = {
+      "safSu=1", "safSu=2", "safComp=a,safSu=1", "safComp=a,safSu=11",
+      "safSu=1,safSg=1", "safSu", ""};
+};
+
+TEST_F(NtfFilterNamesTest, EmptyMatchesAnyName) {
+  EXPECT_TRUE(Names({}).empty());
+  EXPECT_EQ(Matches({}, objects_),
+            std::vector<bool>(objects_.size(), true));
+}
+
+TEST_F(NtfFilterNamesTest, NameOfTheSameLengthMustBeEqual) {
+  EXPECT_EQ(Matches({"safSu=2"}, objects_),
+            std::vector<bool>(
+                {false, true, false, false, false, false, false}));
+}
+
+TEST_F(NtfFilterNamesTest, LongerNameMatchesIfItContainsTheFilterName) {
+  EXPECT_EQ(Matches({"safSu=1"}, objects_),
+            std::vector<bool>({true, false, true, true, true, false, false}));
+  EXPECT_EQ(Matches({"safSu=11"}, objects_),
+            std::vector<bool>(
+                {false, false, false, true, false, false, false}));
+}
+
+TEST_F(NtfFilterNamesTest, ShorterNameNeverMatches) {
+  EXPECT_EQ(Matches({"safComp=a,safSu=1,safSg=1"}, objects_),
+            std::vector<bool>(objects_.size(), false));
+}
+
+TEST_F(NtfFilterNamesTest, AnyFilterNameMatches) {
+  // Duplicates and names of any length in any order
+  EXPECT_EQ(Matches({"safSu=1,safSg=1", "safSu=2", "safComp=a", "safSu=2"},
+                    objects_),
+            std::vector<bool>({false, true, true, true, true, false, false}));
+}
+
+// Subscriptions with alarm and state change filters on event types
+class NtfSubscriptionIndexTest : public ::testing::Test {
+ protected:
+  void TearDown() override {
+    for (NtfSubscription *subscription : subscriptions_) {
+      index_.subscriptionRemoved(subscription);
+      delete subscription;
+    }
+  }
+
+  static SaNtfAlarmNotificationFilterT *AlarmFilter(
+      const std::vector<SaNtfEventTypeT> &eventTypes) {
+    SaNtfAlarmNotificationFilterT *f =
+        static_cast<SaNtfAlarmNotificationFilterT *>(calloc(1, sizeof(*f)));
+    EXPECT_EQ(ntfsv_filter_header_alloc(&f->notificationFilterHeader,
+                                        eventTypes.size(), 0, 0, 0),
+              SA_AIS_OK);
+    EXPECT_EQ(ntfsv_filter_alarm_alloc(f, 0, 0, 0), SA_AIS_OK);
+    for (size_t i = 0; i < eventTypes.size(); i++)
+      f->notificationFilterHeader.eventTypes[i] = eventTypes[i];
+    return f;
+  }
+
+  static SaNtfStateChangeNotificationFilterT *StateChangeFilter() {
+    SaNtfStateChangeNotificationFilterT *f =
+        static_cast<SaNtfStateChangeNotificationFilterT *>(
+            calloc(1, sizeof(*f)));
+    EXPECT_EQ(
+        ntfsv_filter_header_alloc(&f->notificationFilterHeader, 0, 0, 0, 0),
+        SA_AIS_OK);
+    EXPECT_EQ(ntfsv_filter_state_ch_alloc(f, 0, 0), SA_AIS_OK);
+    return f;
+  }
+
+  NtfSubscription *Subscribe(unsigned int client, SaNtfSubscriptionIdT id,
+                             SaNtfAlarmNotificationFilterT *alarm,
+                             SaNtfStateChangeNotificationFilterT *state) {
+    ntfsv_subscribe_req_t req;
+    memset(&req, 0, sizeof(req));
+    req.client_id = client;
+    req.subscriptionId = id;
+    req.f_rec.alarm_filter = alarm;
+    req.f_rec.sta_ch_filter = state;
+    NtfSubscription *subscription = new NtfSubscription(&req);
+    subscriptions_.push_back(subscription);
+    index_.subscriptionAdded(subscription);
+    return subscription;
+  }
+
+  // An alarm or a state change notification
+  static NtfSmartPtr Notification(SaNtfNotificationTypeT type,
+                                  SaNtfEventTypeT eventType) {
+    ntfsv_send_not_req_t *info =
+        static_cast<ntfsv_send_not_req_t *>(calloc(1, sizeof(*info)));
+    info->notificationType = type;
+    SaNtfNotificationHeaderT *header;
+    if (type == SA_NTF_TYPE_ALARM) {
+      header = &info->notification.alarm.notificationHeader;
+      EXPECT_EQ(ntfsv_alloc_ntf_header(header, 0, 0, 0), SA_AIS_OK);
+      EXPECT_EQ(ntfsv_alloc_ntf_alarm(&info->notification.alarm, 0, 0, 0),
+                SA_AIS_OK);
+    } else {
+      header = &info->notification.stateChange.notificationHeader;
+      EXPECT_EQ(ntfsv_alloc_ntf_header(header, 0, 0, 0), SA_AIS_OK);
+      EXPECT_EQ(
+          ntfsv_alloc_ntf_state_change(&info->notification.stateChange, 0),
+          SA_AIS_OK);
+    }
+    *header->eventType = eventType;
+    osaf_extended_name_alloc("safSu=1", header->notificationObject);
+    osaf_extended_name_alloc("safApp=test", header->notifyingObject);
+    return NtfSmartPtr(new NtfNotification(1, type, info));
+  }
+
+  // (client id, subscription id) of the candidates
+  std::vector<std::pair<unsigned int, SaNtfSubscriptionIdT>> Candidates(
+      SaNtfNotificationTypeT type, SaNtfEventTypeT eventType) {
+    NtfSmartPtr notification = Notification(type, eventType);
+    std::vector<NtfSubscription *> candidates;
+    index_.findCandidates(notification, &candidates);
+    std::vector<std::pair<unsigned int, SaNtfSubscriptionIdT>> ids;
+    for (NtfSubscription *subscription : candidates)
+      ids.push_back({subscription->getClientId(),
+                     subscription->getSubscriptionId()});
+    return ids;
+  }
+
+  NtfSubscriptionIndex index_;
+  std::vector<NtfSubscription *> subscriptions_;
+};
+
+typedef std::vector<std::pair<unsigned int, SaNtfSubscriptionIdT>> Ids;
+
+TEST_F(NtfSubscriptionIndexTest, CandidatesHaveAFilterForTheEventType) {
+  Subscribe(1, 1, AlarmFilter({SA_NTF_ALARM_PROCESSING}), nullptr);
+  Subscribe(1, 2, AlarmFilter({SA_NTF_ALARM_EQUIPMENT,
+                               SA_NTF_ALARM_PROCESSING}),
+            nullptr);
+  Subscribe(2, 1, AlarmFilter({SA_NTF_ALARM_COMMUNICATION}), nullptr);
+  EXPECT_EQ(index_.size(), 3u);
+
+  EXPECT_EQ(Candidates(SA_NTF_TYPE_ALARM, SA_NTF_ALARM_PROCESSING),
+            Ids({{1, 1}, {1, 2}}));
+  EXPECT_EQ(Candidates(SA_NTF_TYPE_ALARM, SA_NTF_ALARM_COMMUNICATION),
+            Ids({{2, 1}}));
+  EXPECT_TRUE(Candidates(SA_NTF_TYPE_ALARM, SA_NTF_ALARM_QOS).empty());
+  // The event type of another notification type
+  EXPECT_TRUE(
+      Candidates(SA_NTF_TYPE_STATE_CHANGE, SA_NTF_ALARM_PROCESSING).empty());
+}
+
+TEST_F(NtfSubscriptionIndexTest, FilterWithoutEventTypesIsACandidate) {
+  Subscribe(1, 1, AlarmFilter({}), StateChangeFilter());
+  Subscribe(2, 1, AlarmFilter({SA_NTF_ALARM_EQUIPMENT}), nullptr);
+
+  EXPECT_EQ(Candidates(SA_NTF_TYPE_ALARM, SA_NTF_ALARM_EQUIPMENT),
+            Ids({{1, 1}, {2, 1}}));
+  EXPECT_EQ(Candidates(SA_NTF_TYPE_ALARM, SA_NTF_ALARM_QOS), Ids({{1, 1}}));
+  EXPECT_EQ(
+      Candidates(SA_NTF_TYPE_STATE_CHANGE, SA_NTF_OBJECT_STATE_CHANGE),
+      Ids({{1, 1}}));
+}
+
+TEST_F(NtfSubscriptionIndexTest, CandidatesAreInClientAndSubscriptionOrder) {
+  // Added out of order, with and without event types
+  Subscribe(3, 1, AlarmFilter({}), nullptr);
+  Subscribe(1, 7, AlarmFilter({SA_NTF_ALARM_PROCESSING}), nullptr);
+  Subscribe(2, 2, AlarmFilter({SA_NTF_ALARM_PROCESSING}), nullptr);
+  Subscribe(1, 3, AlarmFilter({}), nullptr);
+  Subscribe(2, 1, AlarmFilter({}), nullptr);
+
+  EXPECT_EQ(Candidates(SA_NTF_TYPE_ALARM, SA_NTF_ALARM_PROCESSING),
+            Ids({{1, 3}, {1, 7}, {2, 1}, {2, 2}, {3, 1}}));
+}
+
+TEST_F(NtfSubscriptionIndexTest, RemovedSubscriptionIsNoCandidate) {
+  NtfSubscription *a =
+      Subscribe(1, 1, AlarmFilter({SA_NTF_ALARM_PROCESSING}), nullptr);
+  Subscribe(1, 2, AlarmFilter({SA_NTF_ALARM_PROCESSING}), nullptr);
+  NtfSubscription *c = Subscribe(2, 1, AlarmFilter({}), StateChangeFilter());
+
+  index_.subscriptionRemoved(a);
+  index_.subscriptionRemoved(c);
+  EXPECT_EQ(index_.size(), 1u);
+  EXPECT_EQ(Candidates(SA_NTF_TYPE_ALARM, SA_NTF_ALARM_PROCESSING),
+            Ids({{1, 2}}));
+  EXPECT_TRUE(
+      Candidates(SA_NTF_TYPE_STATE_CHANGE, SA_NTF_OBJECT_STATE_CHANGE)
+          .empty());
+
+  index_.subscriptionAdded(a);
+  index_.subscriptionAdded(c);
+}
+
+// Checks of a notification against many subscriptions: by a scan of all
+// subscriptions with the filter arrays as before the filters were compiled,
+// by a scan with the compiled filters and by the candidates of the index.
+// Run with
+//   bin/testntfd --gtest_also_run_disabled_tests --gtest_filter='*Bench*'
+class NtfSubscriptionIndexBench : public NtfSubscriptionIndexTest {
+ protected:
+  static const int kObjects = 50;
+
+  // Alarms of one event type, on 4 objects and 2 severities
+  static SaNtfAlarmNotificationFilterT *BenchFilter(SaNtfEventTypeT eventType,
+                                                    unsigned int k) {
+    SaNtfAlarmNotificationFilterT *f =
+        static_cast<SaNtfAlarmNotificationFilterT *>(calloc(1, sizeof(*f)));
+    SaNtfNotificationFilterHeaderT *fh = &f->notificationFilterHeader;
+    EXPECT_EQ(ntfsv_filter_header_alloc(fh, 1, 4, 0, 0), SA_AIS_OK);
+    EXPECT_EQ(ntfsv_filter_alarm_alloc(f, 0, 2, 0), SA_AIS_OK);
+    fh->eventTypes[0] = eventType;
+    for (unsigned int i = 0; i < 4; i++) {
+      std::string object = "safSu=" + std::to_string((k + i) % kObjects);
+      osaf_extended_name_alloc(object.c_str(), &fh->notificationObjects[i]);
+    }
+    f->perceivedSeverities[0] = SA_NTF_SEVERITY_MAJOR;
+    f->perceivedSeverities[1] = SA_NTF_SEVERITY_CRITICAL;
+    return f;
+  }
+
+  static NtfSmartPtr BenchNotification(SaNtfEventTypeT eventType, int i) {
+    NtfSmartPtr notification = Notification(SA_NTF_TYPE_ALARM, eventType);
+    SaNtfAlarmNotificationT *alarm =
+        &notification->getNotInfo()->notification.alarm;
+    std::string object =
+        "safComp=c,safSu=" + std::to_string(i % kObjects) + ",safSg=1";
+    osaf_extended_name_free(alarm->notificationHeader.notificationObject);
+    osaf_extended_name_alloc(object.c_str(),
+                             alarm->notificationHeader.notificationObject);
+    *alarm->perceivedSeverity =
+        i % 2 ? SA_NTF_SEVERITY_MAJOR : SA_NTF_SEVERITY_MINOR;
+    return notification;
+  }
+
+  // The check of an alarm filter before the filters were compiled, a loop
+  // over each filter array
+  bool ArrayCheck(SaNtfAlarmNotificationFilterT *f, NtfSmartPtr &n) {
+    if (n->getNotificationType() != SA_NTF_TYPE_ALARM) return false;
+    SaNtfNotificationFilterHeaderT *fh = &f->notificationFilterHeader;
+    const SaNtfNotificationHeaderT *h = n->header();
+    SaNtfAlarmNotificationT *a = &n->getNotInfo()->notification.alarm;
+    bool match = fh->numNotificationClassIds == 0;
+    for (int i = 0; i < fh->numNotificationClassIds && !match; i++)
+      match = h->notificationClassId->vendorId ==
+                  fh->notificationClassIds[i].vendorId &&
+              h->notificationClassId->majorId ==
+                  fh->notificationClassIds[i].majorId &&
+              h->notificationClassId->minorId ==
+                  fh->notificationClassIds[i].minorId;
+    if (!match) return false;
+    match = fh->numEventTypes == 0;
+    for (int i = 0; i < fh->numEventTypes && !match; i++)
+      match = *h->eventType == fh->eventTypes[i];
+    if (!match) return false;
+    match = fh->numNotificationObjects == 0;
+    for (int i = 0; i < fh->numNotificationObjects && !match; i++)
+      match = filter_.cmpSaNameT(&fh->notificationObjects[i],
+                                 h->notificationObject);
+    if (!match) return false;
+    match = fh->numNotifyingObjects == 0;
+    for (int i = 0; i < fh->numNotifyingObjects && !match; i++)
+      match =
+          filter_.cmpSaNameT(&fh->notifyingObjects[i], h->notifyingObject);
+    if (!match) return false;
+    match = f->numTrends == 0;
+    for (int i = 0; i < f->numTrends && !match; i++)
+      match = *a->trend == f->trends[i];
+    if (!match) return false;
+    match = f->numPerceivedSeverities == 0;
+    for (int i = 0; i < f->numPerceivedSeverities && !match; i++)
+      match = *a->perceivedSeverity == f->perceivedSeverities[i];
+    if (!match) return false;
+    match = f->numProbableCauses == 0;
+    for (int i = 0; i < f->numProbableCauses && !match; i++)
+      match = *a->probableCause == f->probableCauses[i];
+    return match;
+  }
+
+  void Run(unsigned int clients, unsigned int perClient) {
+    // Each subscription has an alarm filter on one of 8 event types
+    const SaNtfEventTypeT first = SA_NTF_ALARM_NOTIFICATIONS_START;
+    std::vector<SaNtfAlarmNotificationFilterT *> filters;
+    for (unsigned int client = 1; client <= clients; client++) {
+      for (unsigned int id = 1; id <= perClient; id++) {
+        unsigned int k = client * perClient + id;
+        filters.push_back(
+            BenchFilter(static_cast<SaNtfEventTypeT>(first + k % 8), k));
+        Subscribe(client, id, filters.back(), nullptr);
+      }
+    }
+
+    const int kNotifications = 1000;
+    std::vector<NtfSmartPtr> notifications;
+    for (int i = 0; i < kNotifications; i++)
+      notifications.push_back(BenchNotification(
+          static_cast<SaNtfEventTypeT>(first + i % 8), i));
+
+    size_t arrays = 0, scanned = 0, indexed = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (NtfSmartPtr &notification : notifications)
+      for (SaNtfAlarmNotificationFilterT *f : filters)
+        arrays += ArrayCheck(f, notification);
+    auto array = std::chrono::steady_clock::now() - start;
+
+    start = std::chrono::steady_clock::now();
+    for (NtfSmartPtr &notification : notifications)
+      for (NtfSubscription *subscription : subscriptions_)
+        scanned += subscription->checkSubscription(notification);
+    auto scan = std::chrono::steady_clock::now() - start;
+
+    start = std::chrono::steady_clock::now();
+    std::vector<NtfSubscription *> candidates;
+    for (NtfSmartPtr &notification : notifications) {
+      candidates.clear();
+      index_.findCandidates(notification, &candidates);
+      for (NtfSubscription *subscription : candidates)
+        indexed += subscription->checkSubscription(notification);
+    }
+    auto index = std::chrono::steady_clock::now() - start;
+    EXPECT_EQ(scanned, arrays);
+    EXPECT_EQ(indexed, arrays);
+
+    typedef std::chrono::duration<double, std::micro> Us;
+    printf("%u subscriptions, %zu matches: array scan %.1f us, compiled "
+           "scan %.1f us, index %.1f us per notification\n",
+           clients * perClient, arrays / kNotifications,
+           Us(array).count() / kNotifications,
+           Us(scan).count() / kNotifications,
+           Us(index).count() / kNotifications);
+  }
+
+  // Only for cmpSaNameT(), which does not use the filter
+  NtfAlarmFilter filter_{static_cast<SaNtfAlarmNotificationFilterT *>(
+      calloc(1, sizeof(SaNtfAlarmNotificationFilterT)))};
+};
+
+TEST_F(NtfSubscriptionIndexBench, DISABLED_HundredSubscriptions) {
+  Run(10, 10);
+}
+
+TEST_F(NtfSubscriptionIndexBench, DISABLED_TenThousandSubscriptions) {
+  Run(100, 100);
+}
+
+TEST_F(NtfSubscriptionIndexBench, DISABLED_HundredThousandSubscriptions) {
+  Run(1000, 100);
+}
+
+}  // namespace
@@ -0,0 +1,221 @@
+/*      -*- OpenSAF  -*-
+ *
+ * (C) Copyright 2017 The OpenSAF Foundation
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. This file and program are licensed
+ * under the GNU Lesser General Public License Version 2.1, February 1999.
+ * The complete license can be accessed from the following location:
+ * http://opensource.org/licenses/lgpl-license.php
+ * See the Copying file included with the OpenSAF distribution for full
+ * licensing terms.
+ *
+ */
+
+#include <cstdlib>
+#include <vector>
+#include "base/osaf_extended_name.h"
+#include "gtest/gtest.h"
+#include "ntf/common/ntfsv_filter.h"
+#include "ntf/common/ntfsv_mem.h"
+#include "ntf/ntfd/NtfFilter.h"
+
+namespace {
+
+// The agent checks the filters of broadcast notifications with
+// ntfsv_filter_match(), it must agree with the NtfFilter classes the NTFS
+// checks the other notifications with.
+class NtfsvFilterTest : public ::testing::Test {
+ protected:
+  struct Alarm {
+    SaNtfEventTypeT eventType;
+    const char* object;
+    SaUint16T minorId;
+    SaNtfSeverityT severity;
+  };
+
+  static NtfSmartPtr AlarmNotification(SaNtfIdentifierT id,
+                                       const Alarm& alarm) {
+    ntfsv_send_not_req_t* info =
+        static_cast<ntfsv_send_not_req_t*>(calloc(1, sizeof(*info)));
+    info->notificationType = SA_NTF_TYPE_ALARM;
+    SaNtfNotificationHeaderT* header =
+        &info->notification.alarm.notificationHeader;
+    EXPECT_EQ(ntfsv_alloc_ntf_header(header, 0, 10, 0), SA_AIS_OK);
+    EXPECT_EQ(ntfsv_alloc_ntf_alarm(&info->notification.alarm, 0, 0, 0),
+              SA_AIS_OK);
+    *header->eventType = alarm.eventType;
+    osaf_extended_name_alloc(alarm.object, header->notificationObject);
+    osaf_extended_name_alloc("safApp=test", header->notifyingObject);
+    header->notificationClassId->vendorId = SA_NTF_VENDOR_ID_SAF;
+    header->notificationClassId->majorId = 1;
+    header->notificationClassId->minorId = alarm.minorId;
+    *header->eventTime = SA_TIME_UNKNOWN;
+    *info->notification.alarm.perceivedSeverity = alarm.severity;
+    *info->notification.alarm.probableCause = SA_NTF_ADAPTER_ERROR;
+    *info->notification.alarm.trend = SA_NTF_TREND_NO_CHANGE;
+    return NtfSmartPtr(new NtfNotification(id, SA_NTF_TYPE_ALARM, info));
+  }
+
+  static NtfSmartPtr StateChangeNotification(
+      SaNtfIdentifierT id, const std::vector<SaUint16T>& stateIds) {
+    ntfsv_send_not_req_t* info =
+        static_cast<ntfsv_send_not_req_t*>(calloc(1, sizeof(*info)));
+    info->notificationType = SA_NTF_TYPE_STATE_CHANGE;
+    SaNtfStateChangeNotificationT* s = &info->notification.stateChange;
+    EXPECT_EQ(ntfsv_alloc_ntf_header(&s->notificationHeader, 0, 10, 0),
+              SA_AIS_OK);
+    EXPECT_EQ(ntfsv_alloc_ntf_state_change(s, stateIds.size()), SA_AIS_OK);
+    *s->notificationHeader.eventType = SA_NTF_OBJECT_STATE_CHANGE;
+    osaf_extended_name_alloc("safSu=1",
+                             s->notificationHeader.notificationObject);
+    osaf_extended_name_alloc("safApp=test",
+                             s->notificationHeader.notifyingObject);
+    *s->notificationHeader.eventTime = SA_TIME_UNKNOWN;
+    *s->sourceIndicator = SA_NTF_OBJECT_OPERATION;
+    for (size_t i = 0; i < stateIds.size(); i++) {
+      s->changedStates[i].stateId = stateIds[i];
+      s->changedStates[i].oldStatePresent = SA_FALSE;
+      s->changedStates[i].newState = 1;
+    }
+    return NtfSmartPtr(
+        new NtfNotification(id, SA_NTF_TYPE_STATE_CHANGE, info));
+  }
+
+  // An alarm filter on the given values, each empty list matches all
+  static SaNtfAlarmNotificationFilterT* AlarmFilter(
+      const std::vector<SaNtfEventTypeT>& eventTypes,
+      const std::vector<const char*>& objects,
+      const std::vector<SaUint16T>& minorIds,
+      const std::vector<SaNtfSeverityT>& severities) {
+    SaNtfAlarmNotificationFilterT* f =
+        static_cast<SaNtfAlarmNotificationFilterT*>(calloc(1, sizeof(*f)));
+    SaNtfNotificationFilterHeaderT* h = &f->notificationFilterHeader;
+    EXPECT_EQ(ntfsv_filter_header_alloc(h, eventTypes.size(), objects.size(),
+                                        0, minorIds.size()),
+              SA_AIS_OK);
+    EXPECT_EQ(ntfsv_filter_alarm_alloc(f, 0, severities.size(), 0),
+              SA_AIS_OK);
+    for (size_t i = 0; i < eventTypes.size(); i++)
+      h->eventTypes[i] = eventTypes[i];
+    for (size_t i = 0; i < objects.size(); i++)
+      osaf_extended_name_alloc(objects[i], &h->notificationObjects[i]);
+    for (size_t i = 0; i < minorIds.size(); i++) {
+      h->notificationClassIds[i].vendorId = SA_NTF_VENDOR_ID_SAF;
+      h->notificationClassIds[i].majorId = 1;
+      h->notificationClassIds[i].minorId = minorIds[i];
+    }
+    for (size_t i = 0; i < severities.size(); i++)
+      f->perceivedSeverities[i] = severities[i];
+    return f;
+  }
+
+  static SaNtfStateChangeNotificationFilterT* StateChangeFilter(
+      const std::vector<SaUint16T>& stateIds) {
+    SaNtfStateChangeNotificationFilterT* f =
+        static_cast<SaNtfStateChangeNotificationFilterT*>(
+            calloc(1, sizeof(*f)));
+    EXPECT_EQ(ntfsv_filter_header_alloc(&f->notificationFilterHeader, 0, 0, 0,
+                                        0),
+              SA_AIS_OK);
+    EXPECT_EQ(ntfsv_filter_state_ch_alloc(f, 0, stateIds.size()), SA_AIS_OK);
+    for (size_t i = 0; i < stateIds.size(); i++)
+      f->changedStates[i].stateId = stateIds[i];
+    return f;
+  }
+
+  // Checks the alarms against the filter both ways, returns the matches
+  static std::vector<bool> Matches(SaNtfAlarmNotificationFilterT* f,
+                                   const std::vector<Alarm>& alarms) {
+    NtfAlarmFilter ntfs(f);
+    ntfsv_filter_ptrs_t ptrs = {};
+    ptrs.alarm_filter = f;
+    std::vector<bool> matches;
+    for (size_t i = 0; i < alarms.size(); i++) {
+      NtfSmartPtr notif(AlarmNotification(i + 1, alarms[i]));
+      bool match = ntfsv_filter_match(&ptrs, notif->getNotInfo());
+      EXPECT_EQ(match, ntfs.checkFilter(notif)) << "alarm " << i;
+      matches.push_back(match);
+    }
+    return matches;
+  }
+
+  const std::vector<Alarm> alarms_ = {
+      {SA_NTF_ALARM_PROCESSING, "safComp=a,safSu=1", 2, SA_NTF_SEVERITY_MAJOR},
+      {SA_NTF_ALARM_EQUIPMENT, "safComp=a,safSu=1", 2, SA_NTF_SEVERITY_MAJOR},
+      {SA_NTF_ALARM_PROCESSING, "safSu=1", 3, SA_NTF_SEVERITY_MINOR},
+      {SA_NTF_ALARM_PROCESSING, "safSu=2", 2, SA_NTF_SEVERITY_CRITICAL},
+  };
+};
+
+TEST_F(NtfsvFilterTest, EmptyFilterMatchesAll) {
+  EXPECT_EQ(Matches(AlarmFilter({}, {}, {}, {}), alarms_),
+            std::vector<bool>({true, true, true, true}));
+}
+
+TEST_F(NtfsvFilterTest, MatchesEventTypes) {
+  EXPECT_EQ(Matches(AlarmFilter({SA_NTF_ALARM_PROCESSING}, {}, {}, {}),
+                    alarms_),
+            std::vector<bool>({true, false, true, true}));
+  EXPECT_EQ(Matches(AlarmFilter({SA_NTF_ALARM_EQUIPMENT,
+                                 SA_NTF_ALARM_COMMUNICATION},
+                                {}, {}, {}),
+                    alarms_),
+            std::vector<bool>({false, true, false, false}));
+}
+
+TEST_F(NtfsvFilterTest, MatchesEqualOrContainedNames) {
+  // A shorter filter name matches the names containing it
+  EXPECT_EQ(Matches(AlarmFilter({}, {"safSu=1"}, {}, {}), alarms_),
+            std::vector<bool>({true, true, true, false}));
+  // A name of the same length must be equal, a longer one never matches
+  EXPECT_EQ(Matches(AlarmFilter({}, {"safSu=2"}, {}, {}), alarms_),
+            std::vector<bool>({false, false, false, true}));
+  EXPECT_EQ(Matches(AlarmFilter({}, {"safComp=a,safSu=1,safSg=1"}, {}, {}),
+                    alarms_),
+            std::vector<bool>({false, false, false, false}));
+}
+
+TEST_F(NtfsvFilterTest, MatchesClassIdsAndSeverities) {
+  EXPECT_EQ(Matches(AlarmFilter({}, {}, {3}, {}), alarms_),
+            std::vector<bool>({false, false, true, false}));
+  EXPECT_EQ(Matches(AlarmFilter({}, {}, {},
+                                {SA_NTF_SEVERITY_MAJOR,
+                                 SA_NTF_SEVERITY_CRITICAL}),
+                    alarms_),
+            std::vector<bool>({true, true, false, true}));
+  // All filter fields must match
+  EXPECT_EQ(Matches(AlarmFilter({SA_NTF_ALARM_PROCESSING}, {"safSu=1"}, {2},
+                                {SA_NTF_SEVERITY_MAJOR}),
+                    alarms_),
+            std::vector<bool>({true, false, false, false}));
+}
+
+TEST_F(NtfsvFilterTest, MatchesAnyChangedStateId) {
+  SaNtfStateChangeNotificationFilterT* f = StateChangeFilter({5, 7});
+  NtfStateChangeFilter ntfs(f);
+  ntfsv_filter_ptrs_t ptrs = {};
+  ptrs.sta_ch_filter = f;
+  const std::vector<std::vector<SaUint16T>> states = {
+      {1, 7}, {5}, {1, 2}, {}};
+  const bool expected[] = {true, true, false, false};
+  for (size_t i = 0; i < states.size(); i++) {
+    NtfSmartPtr notif(StateChangeNotification(i + 1, states[i]));
+    EXPECT_EQ(ntfsv_filter_match(&ptrs, notif->getNotInfo()), expected[i]);
+    EXPECT_EQ(ntfs.checkFilter(notif), expected[i]);
+  }
+}
+
+TEST_F(NtfsvFilterTest, NoFilterOfTheType) {
+  SaNtfStateChangeNotificationFilterT* f = StateChangeFilter({});
+  NtfStateChangeFilter ntfs(f);
+  ntfsv_filter_ptrs_t ptrs = {};
+  ptrs.sta_ch_filter = f;
+  NtfSmartPtr alarm(AlarmNotification(1, alarms_[0]));
+  EXPECT_FALSE(ntfsv_filter_match(&ptrs, alarm->getNotInfo()));
+  NtfSmartPtr state(StateChangeNotification(2, {1}));
+  EXPECT_TRUE(ntfsv_filter_match(&ptrs, state->getNotInfo()));
+}
+
+}  // namespace